@@ -0,0 +1,512 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     AlertPublisher.cpp
+//
+// File Overview: Represents an AlertPublisher
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Reads Platform::getSteadyNanos
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+#include "AlertPublisher.h"
+#include "Platform.h"
+#include "Tracer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const char* ALERTTYPENAMES[NUMALERTTYPES] = // Written for each type
+{
+   "ZEROUP",
+   "ZERODOWN",
+   "SLOPEUP",
+   "SLOPEDOWN"
+};
+
+static const double DEFAULTSLOPETHRESHOLD = 0.05;   // As in the screen example
+static const double NANOSPERMICRO         = 1000.0; // For reporting latencies
+static const double NANOSPERSECOND        = 1.0e9;  // For the rate limit
+
+//******************************************************************************
+// Function : constructor
+// Process  : Size the queue and each symbol's rate limit and last bars
+//             No outputs open, no rate limit, nothing published
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AlertPublisher::AlertPublisher(
+   const int numSymbols,
+   const int queueCapacity)
+   : queue(queueCapacity),
+     numSymbols(numSymbols),
+     slopeThreshold(DEFAULTSLOPETHRESHOLD),
+     alertsPerSecond(0.0),
+     burst(0.0),
+     tokens(numSymbols, 0.0),
+     refillNanos(numSymbols, 0),
+     lastBarMicros(numSymbols * NUMALERTTYPES, 0),
+     hasLastBar(numSymbols * NUMALERTTYPES, 0),
+     numDropped(0),
+     numBatches(0),
+     numDuplicates(0),
+     numRateLimited(0),
+     numReceived(0),
+     numWritten(0),
+     stopRequested(false)
+{
+} // end AlertPublisher::AlertPublisher
+
+//******************************************************************************
+// Function : destructor
+// Process  : Stop the publisher thread
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AlertPublisher::~AlertPublisher()
+{
+   this->stop();
+} // end AlertPublisher::~AlertPublisher
+
+//******************************************************************************
+// Function : admitAlert
+// Process  : Drop the alert if its bar is no newer than the last alert of
+//                its symbol and type, else it is the last
+//             With a rate limit, refill the symbol's tokens for the time
+//                since, up to burst
+//                Drop the alert if less than one token is left, else spend
+//                   one
+// Notes    : Duplicates are dropped first, so they spend no tokens
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool AlertPublisher::admitAlert(
+   const Alert& alert,
+   const long long nowNanos)
+{
+   const int SYMBOL = alert.symbolIndex;                   // Rate limited
+   const int KEY    = SYMBOL * NUMALERTTYPES + alert.type; // Symbol and type
+
+   // Drop the alert if its bar is no newer than the last
+   if (this->hasLastBar[KEY] && alert.barMicros <= this->lastBarMicros[KEY])
+   {
+      ++this->numDuplicates;
+      return false;
+   }
+
+   this->hasLastBar[KEY]    = 1;
+   this->lastBarMicros[KEY] = alert.barMicros;
+
+   // With a rate limit, refill the symbol's tokens and spend one
+   if (this->alertsPerSecond > 0.0)
+   {
+      this->tokens[SYMBOL] = min(this->burst, this->tokens[SYMBOL] +
+         (nowNanos - this->refillNanos[SYMBOL]) * this->alertsPerSecond /
+         NANOSPERSECOND);
+      this->refillNanos[SYMBOL] = nowNanos;
+
+      if (this->tokens[SYMBOL] < 1.0)
+      {
+         ++this->numRateLimited;
+         return false;
+      }
+
+      this->tokens[SYMBOL] -= 1.0;
+   }
+
+   return true;
+}
+
+//******************************************************************************
+// Function : connectSocket
+// Process  : Connect the socket to the consumer listening on socketPath
+// Notes    : Throws an exception if the connection fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::connectSocket(const string& socketPath)
+{
+   this->socket.connectTo(socketPath);
+}
+
+//******************************************************************************
+// Function : getAlertTypeName
+// Process  : Look up the name of the type
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* AlertPublisher::getAlertTypeName(const AlertType type)
+{
+   return ALERTTYPENAMES[type];
+}
+
+//******************************************************************************
+// Function : openLogFile
+// Process  : Open the log file to append
+// Notes    : Throws an exception if the file can't be opened
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::openLogFile(const string& logFileName)
+{
+   this->logFile.open(logFileName.c_str(), ios::out | ios::app | ios::binary);
+
+   if (!this->logFile.is_open())
+   {
+      throw exception("Unable to open the alert log file");
+   }
+}
+
+//******************************************************************************
+// Function : outputStatistics
+// Process  : Output the alert counts and alerts written per second
+//             Sort the latency samples
+//             Output the p50, p99, and max latency in microseconds
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::outputStatistics(const double seconds) const
+{
+   vector<double> latencyNanos = this->latencyNanos; // Sorted
+
+   cout << "   alerts received:  " << this->getNumReceived() << endl;
+   cout << "   duplicates:       " << this->getNumDuplicates() << endl;
+   cout << "   rate limited:     " << this->getNumRateLimited() << endl;
+   cout << "   dropped:          " << this->getNumDropped() << endl;
+   cout << "   alerts written:   " << this->getNumWritten() << endl;
+   cout << "   batches:          " << this->getNumBatches() << endl;
+   cout << "   alerts/sec:       " << fixed << setprecision(0)
+        << this->getNumWritten() / seconds << endl;
+
+   // Output the p50, p99, and max latency
+   if (!latencyNanos.empty())
+   {
+      sort(latencyNanos.begin(), latencyNanos.end());
+
+      cout << setprecision(2);
+      cout << "   latency p50 us:   "
+           << latencyNanos[latencyNanos.size() / 2] / NANOSPERMICRO << endl;
+      cout << "   latency p99 us:   "
+           << latencyNanos[latencyNanos.size() * 99 / 100] / NANOSPERMICRO
+           << endl;
+      cout << "   latency max us:   "
+           << latencyNanos.back() / NANOSPERMICRO << endl;
+   }
+
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : publish
+// Process  : Push the alert to the queue
+//             Count it dropped if the queue is full
+// Notes    : Throws an out_of_range exception for an invalid symbol, before
+//             it can reach the publisher thread
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool AlertPublisher::publish(const Alert& alert)
+{
+   if (alert.symbolIndex < 0 || alert.symbolIndex >= this->numSymbols)
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   if (!this->queue.tryPush(alert))
+   {
+      this->numDropped.fetch_add(1, memory_order_relaxed);
+      return false;
+   }
+
+   return true;
+}
+
+//******************************************************************************
+// Function : publishBatch
+// Process  : Pop up to MAXBATCHALERTS alerts
+//                Add a line for each admitted to the batch, with its symbol
+//                   name or index, type, bar, MACD, and slope
+//             Write the batch, if any admitted
+// Notes    : Returns the number popped
+//             The clock is read once for the rate limit of the batch
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int AlertPublisher::publishBatch()
+{
+   const long long NOWNANOS  = Platform::getSteadyNanos(); // For the rate limit
+   Alert           alert;                    // Alert popped
+   int             numPopped = 0;            // Of the batch
+
+   // Pop up to MAXBATCHALERTS alerts, adding a line for each admitted
+   while (numPopped < AlertPublisher::MAXBATCHALERTS &&
+          this->queue.tryPop(alert))
+   {
+      ++numPopped;
+      ++this->numReceived;
+
+      if (!this->admitAlert(alert, NOWNANOS))
+      {
+         continue;
+      }
+
+      if (this->symbolNames.empty())
+      {
+         this->batch << alert.symbolIndex;
+      }
+      else
+      {
+         this->batch << this->symbolNames[alert.symbolIndex];
+      }
+
+      this->batch << ' ' << ALERTTYPENAMES[alert.type] << ' '
+                  << alert.barMicros << ' ' << alert.macd << ' '
+                  << alert.slopeMACD << '\n';
+      this->batchArrivals.push_back(alert.arrivalNanos);
+   }
+
+   // Write the batch, if any admitted
+   if (!this->batchArrivals.empty())
+   {
+      this->writeBatch();
+   }
+
+   return numPopped;
+}
+
+//******************************************************************************
+// Function : run
+// Process  : Name the thread in the trace
+//             Publish batches
+//             When none was popped
+//                Once stop was requested before the pop, return
+//                Otherwise yield to the workers
+// Notes    : The workers publish their last alert before stop is
+//             requested, so an empty pop after the request means every
+//             alert was written
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::run()
+{
+   bool stopping = false; // Stop requested before the pop
+
+   Tracer::setThreadName("alerts");
+
+   while (true)
+   {
+      stopping = this->stopRequested.load(memory_order_acquire);
+
+      if (0 == this->publishBatch())
+      {
+         if (stopping)
+         {
+            return;
+         }
+
+         this_thread::yield();
+      }
+   }
+}
+
+//******************************************************************************
+// Function : setRateLimit
+// Process  : Set the rate and burst
+//             Every symbol starts with a full burst of tokens
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::setRateLimit(
+   const double alertsPerSecond,
+   const double burst)
+{
+   const long long NOWNANOS = Platform::getSteadyNanos(); // Tokens full as of
+
+   this->alertsPerSecond = alertsPerSecond;
+   this->burst           = max(1.0, burst);
+
+   fill(this->tokens.begin(), this->tokens.end(), this->burst);
+   fill(this->refillNanos.begin(), this->refillNanos.end(), NOWNANOS);
+}
+
+//******************************************************************************
+// Function : setSymbolNames
+// Process  : Copy the names
+// Notes    : Throws an exception unless there is a name per symbol
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::setSymbolNames(const vector<string>& symbolNames)
+{
+   if (int(symbolNames.size()) != this->numSymbols)
+   {
+      throw exception("Alert symbol names must match the symbols");
+   }
+
+   this->symbolNames = symbolNames;
+}
+
+//******************************************************************************
+// Function : start
+// Process  : Start the publisher thread
+// Notes    : Does nothing if already started
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::start()
+{
+   if (this->publisherThread.joinable())
+   {
+      return;
+   }
+
+   this->stopRequested = false;
+   this->publisherThread = thread(&AlertPublisher::run, this);
+}
+
+//******************************************************************************
+// Function : stop
+// Process  : Ask the publisher thread to finish once the queue is drained
+//             Join it
+//             Close the log file and the socket, so consumers see the end
+// Notes    : Does nothing to the thread if not started
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::stop()
+{
+   this->stopRequested = true;
+
+   if (this->publisherThread.joinable())
+   {
+      this->publisherThread.join();
+   }
+
+   if (this->logFile.is_open())
+   {
+      this->logFile.close();
+   }
+
+   this->socket.closeSocket();
+}
+
+//******************************************************************************
+// Function : writeBatch
+// Process  : Append the batch to the log file and flush it
+//             Send it to the socket
+//                If the send fails, close the socket and keep logging
+//             Record each alert's latency from its arrival to now
+//             Count the batch and its alerts, and empty it
+// Notes    : One write and one send per batch, not per alert
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AlertPublisher::writeBatch()
+{
+   const string LINES    = this->batch.str(); // Lines of the batch
+   long long    nowNanos = 0;                 // Written at
+
+   // Append the batch to the log file and flush it
+   if (this->logFile.is_open())
+   {
+      this->logFile.write(LINES.data(), LINES.size());
+      this->logFile.flush();
+   }
+
+   // Send it to the socket, closing the socket if the send fails
+   if (this->socket.isOpen())
+   {
+      try
+      {
+         this->socket.sendAll(LINES.data(), LINES.size());
+      }
+      catch (const exception& exception)
+      {
+         cout << "Alert socket closed: " << exception.what() << endl;
+         this->socket.closeSocket();
+      }
+   }
+
+   // Record each alert's latency from its arrival to now
+   nowNanos = Platform::getSteadyNanos();
+
+   for (size_t alertIndex = 0; alertIndex < this->batchArrivals.size();
+        ++alertIndex)
+   {
+      this->latencyNanos.push_back(
+         double(nowNanos - this->batchArrivals[alertIndex]));
+   }
+
+   // Count the batch and its alerts, and empty it
+   this->numWritten += this->batchArrivals.size();
+   ++this->numBatches;
+
+   this->batch.str("");
+   this->batchArrivals.clear();
+}
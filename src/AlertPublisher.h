@@ -0,0 +1,398 @@
+//******************************************************************************
+//
+// File Name:     AlertPublisher.h
+//
+// File Overview: Represents an AlertPublisher
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef AlertPublisher_h
+#define AlertPublisher_h
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "LocalSocket.h"
+#include "MarketData.h"
+#include "MPSCQueue.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    AlertPublisher
+//
+// Overview: Sends the alerts of analysis workers to downstream consumers
+//             Any worker calls publish, which pushes the alert to an
+//                MPSCQueue without locking, and counts it dropped if the
+//                queue is full rather than hold back the analysis
+//             One publisher thread pops up to MAXBATCHALERTS alerts at a
+//                time, drops duplicates, an alert no newer than the last of
+//                the same symbol and type, and alerts over a symbol's rate
+//                limit, a token bucket of alertsPerSecond and burst
+//             What is left is written as one batch, a line per alert:
+//                <symbol> <type> <bar micros> <MACD> <MACD slope>
+//                appended to the log file and sent to the LocalSocket, each
+//                if open, and the latency from each alert's bar completing
+//                to its write is recorded
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class AlertPublisher
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Publishes alerts of numSymbols symbols, no outputs open,
+   //                no rate limit
+   // Constraints : None
+   //***************************************************************************
+   AlertPublisher(
+      const int numSymbols,
+      const int queueCapacity = AlertPublisher::DEFAULTQUEUECAPACITY);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Stops the publisher thread
+   // Constraints : None
+   //***************************************************************************
+   virtual ~AlertPublisher();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : connectSocket
+   // Description : Sends every batch to the socket listening on path
+   //                The socket is closed if a send fails, the log file is
+   //                still written
+   // Constraints : Call before start
+   //                Throws an exception if the connection fails
+   //***************************************************************************
+   void connectSocket(const string& socketPath);
+
+   //***************************************************************************
+   // Function    : getAlertTypeName
+   // Description : Retrieve the name of the type for the alert lines
+   // Constraints : None
+   //***************************************************************************
+   static const char* getAlertTypeName(const AlertType type);
+
+   //***************************************************************************
+   // Function    : getLatencyNanos
+   // Description : Retrieve the bar completed to write latency of every
+   //                alert written
+   // Constraints : Call stop first
+   //***************************************************************************
+   inline const vector<double>& getLatencyNanos() const;
+
+   //***************************************************************************
+   // Function    : getNumBatches, getNumDropped, getNumDuplicates,
+   //                getNumRateLimited, getNumReceived, getNumWritten
+   // Description : Retrieve the batches written, the alerts dropped with the
+   //                queue full, the alerts popped, and of those, the
+   //                duplicates, the alerts over the rate limit, and the
+   //                alerts written
+   // Constraints : Call stop first
+   //***************************************************************************
+   inline long long getNumBatches() const;
+   inline long long getNumDropped() const;
+   inline long long getNumDuplicates() const;
+   inline long long getNumRateLimited() const;
+   inline long long getNumReceived() const;
+   inline long long getNumWritten() const;
+
+   //***************************************************************************
+   // Function    : getSlopeThreshold
+   // Description : Accessor for slopeThreshold
+   // Constraints : None
+   //***************************************************************************
+   inline double getSlopeThreshold() const;
+
+   //***************************************************************************
+   // Function    : openLogFile
+   // Description : Appends every batch to the log file, created if needed
+   // Constraints : Call before start
+   //                Throws an exception if the file can't be opened
+   //***************************************************************************
+   void openLogFile(const string& logFileName);
+
+   //***************************************************************************
+   // Function    : outputStatistics
+   // Description : Outputs the alert counts, alerts written per second over
+   //                seconds, and the p50, p99, and max latency
+   // Constraints : Call stop first
+   //***************************************************************************
+   void outputStatistics(const double seconds) const;
+
+   //***************************************************************************
+   // Function    : publish
+   // Description : Pushes the alert to the publisher thread
+   //                Returns false, counting it dropped, if the queue is full
+   // Constraints : Any thread
+   //                Throws an out_of_range exception for an invalid symbol
+   //***************************************************************************
+   bool publish(const Alert& alert);
+
+   //***************************************************************************
+   // Function    : setRateLimit
+   // Description : Limits each symbol to alertsPerSecond alerts, in bursts
+   //                of up to burst
+   //                alertsPerSecond 0 removes the limit
+   // Constraints : Call before start
+   //***************************************************************************
+   void setRateLimit(
+      const double alertsPerSecond,
+      const double burst);
+
+   //***************************************************************************
+   // Function    : setSlopeThreshold
+   // Description : Sets the MACD slope an ALERTSLOPEUP or ALERTSLOPEDOWN
+   //                must cross, for the workers raising alerts
+   // Constraints : Call before the workers start
+   //***************************************************************************
+   inline void setSlopeThreshold(const double slopeThreshold);
+
+   //***************************************************************************
+   // Function    : setSymbolNames
+   // Description : Writes the symbol names instead of their indices
+   // Constraints : Call before start
+   //***************************************************************************
+   void setSymbolNames(const vector<string>& symbolNames);
+
+   //***************************************************************************
+   // Function    : start
+   // Description : Starts the publisher thread
+   // Constraints : None
+   //***************************************************************************
+   void start();
+
+   //***************************************************************************
+   // Function    : stop
+   // Description : Lets the publisher thread write every alert published and
+   //                joins it, then closes the log file and socket
+   // Constraints : Call after the workers' last publish
+   //***************************************************************************
+   void stop();
+
+   static const int DEFAULTQUEUECAPACITY = 65536; // Alerts in the queue
+   static const int MAXBATCHALERTS       = 1024;  // Alerts popped per batch
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its thread, queue, and outputs
+   // Constraints : None
+   //***************************************************************************
+   AlertPublisher(const AlertPublisher&);
+   AlertPublisher& operator=(const AlertPublisher&);
+
+   //***************************************************************************
+   // Function    : admitAlert
+   // Description : Is the alert neither a duplicate nor over its symbol's
+   //                rate limit at nowNanos? Counts it if not
+   // Constraints : Publisher thread only
+   //***************************************************************************
+   bool admitAlert(
+      const Alert& alert,
+      const long long nowNanos);
+
+   //***************************************************************************
+   // Function    : publishBatch
+   // Description : Pops up to MAXBATCHALERTS alerts and writes those admitted
+   //                Returns the number popped
+   // Constraints : Publisher thread only
+   //***************************************************************************
+   int publishBatch();
+
+   //***************************************************************************
+   // Function    : run
+   // Description : Publishes batches until stop is requested and the queue
+   //                is drained
+   // Constraints : Publisher thread only
+   //***************************************************************************
+   void run();
+
+   //***************************************************************************
+   // Function    : writeBatch
+   // Description : Writes the batch to the log file and the socket, and
+   //                records the latency of its alerts
+   // Constraints : Publisher thread only
+   //***************************************************************************
+   void writeBatch();
+
+   MPSCQueue<Alert>  queue;           // Alerts from the workers
+   int               numSymbols;      // Symbols alerted
+   vector<string>    symbolNames;     // Written for each index, if set
+   double            slopeThreshold;  // Slope of a slope alert
+   double            alertsPerSecond; // Rate limit per symbol, 0 for none
+   double            burst;           // Most alerts at once per symbol
+   vector<double>    tokens;          // Alerts each symbol may still send
+   vector<long long> refillNanos;     // Each symbol's tokens last refilled
+   vector<long long> lastBarMicros;   // Last bar of each symbol and type
+   vector<char>      hasLastBar;      // Has an alert of symbol and type?
+   ofstream          logFile;         // Append only log, if open
+   LocalSocket       socket;          // Consumer connection, if open
+   ostringstream     batch;           // Lines of the batch being built
+   vector<long long> batchArrivals;   // Arrival of each alert of batch
+   vector<double>    latencyNanos;    // Latency of each alert written
+   atomic<long long> numDropped;      // Queue full
+   long long         numBatches;      // Batches written
+   long long         numDuplicates;   // Popped, not newer
+   long long         numRateLimited;  // Popped, over the rate limit
+   long long         numReceived;     // Popped
+   long long         numWritten;      // Written
+   thread            publisherThread; // Runs run
+   atomic<bool>      stopRequested;   // Asks the thread to finish
+}; // end class AlertPublisher
+
+//******************************************************************************
+// Function : getLatencyNanos
+// Process  : Accessor for latencyNanos
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const vector<double>& AlertPublisher::getLatencyNanos() const
+{
+   return this->latencyNanos;
+}
+
+//******************************************************************************
+// Function : getNumBatches
+// Process  : Accessor for numBatches
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumBatches() const
+{
+   return this->numBatches;
+}
+
+//******************************************************************************
+// Function : getNumDropped
+// Process  : Accessor for numDropped
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumDropped() const
+{
+   return this->numDropped.load();
+}
+
+//******************************************************************************
+// Function : getNumDuplicates
+// Process  : Accessor for numDuplicates
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumDuplicates() const
+{
+   return this->numDuplicates;
+}
+
+//******************************************************************************
+// Function : getNumRateLimited
+// Process  : Accessor for numRateLimited
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumRateLimited() const
+{
+   return this->numRateLimited;
+}
+
+//******************************************************************************
+// Function : getNumReceived
+// Process  : Accessor for numReceived
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumReceived() const
+{
+   return this->numReceived;
+}
+
+//******************************************************************************
+// Function : getNumWritten
+// Process  : Accessor for numWritten
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long AlertPublisher::getNumWritten() const
+{
+   return this->numWritten;
+}
+
+//******************************************************************************
+// Function : getSlopeThreshold
+// Process  : Accessor for slopeThreshold
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double AlertPublisher::getSlopeThreshold() const
+{
+   return this->slopeThreshold;
+}
+
+//******************************************************************************
+// Function : setSlopeThreshold
+// Process  : Mutator for slopeThreshold
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void AlertPublisher::setSlopeThreshold(const double slopeThreshold)
+{
+   this->slopeThreshold = slopeThreshold;
+}
+
+#endif // AlertPublisher_h
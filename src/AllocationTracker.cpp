@@ -0,0 +1,753 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     AllocationTracker.cpp
+//
+// File Overview: Represents an AllocationTracker, and replaces the global
+//                operator new and delete to feed it, unless
+//                STOCK_ALLOCATIONS_OFF is defined
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses Metrics::addRelaxed
+// 10.19.26       Donne Martin         Completed operators, opt out, summary
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+
+#include "AllocationTracker.h"
+#include "Metrics.h"
+
+//******************************************************************************
+//
+// Class:    AllocationCounts
+//
+// Overview: One thread's allocations by phase and by detail
+//             Only its thread writes them, with relaxed loads and stores, so
+//                collect can read them safely
+//             Details are found by address in an open addressed table
+//             Allocated on the thread's first counted allocation and kept
+//                until the process exits
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct AllocationCounts
+{
+   AllocationCounts();
+
+   // Each phase, then none
+   atomic<long long>   phaseAllocations[Metrics::NUMPHASES + 1];
+   atomic<long long>   phaseBytes[Metrics::NUMPHASES + 1];
+
+   // Each detail, NULL for an unused slot
+   atomic<const char*> details[AllocationTracker::NUMDETAILS];
+   atomic<long long>   detailAllocations[AllocationTracker::NUMDETAILS];
+   atomic<long long>   detailBytes[AllocationTracker::NUMDETAILS];
+}; // end struct AllocationCounts
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+atomic<bool> AllocationTracker::enabled(false);
+
+static mutex                     countsMutex; // Guards allCounts
+static vector<AllocationCounts*> allCounts;   // Of every counted thread
+
+// This thread's counts, active phase and detail, and whether it is inside
+// the tracker, whose own allocations are not counted
+static thread_local AllocationCounts* threadCounts  = NULL;
+static thread_local int               currentPhase  = -1;
+static thread_local const char*       currentDetail = NULL;
+static thread_local bool              insideTracker = false;
+
+static const char* NOPHASENAME = "none"; // Allocations outside any phase
+static const int   NAMECHARS   = 32;     // Width of the name column
+
+//******************************************************************************
+// Function : fitName
+// Process  : Keep a name shorter than NAMECHARS
+//             Otherwise keep its last characters after "...", the end of a
+//                file name tells stocks apart
+// Notes    : Leaves a space before the next column
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static string fitName(const string& name)
+{
+   const size_t MAXCHARS = NAMECHARS - 1; // Before the next column
+
+   if (name.size() <= MAXCHARS)
+   {
+      return name;
+   }
+
+   return "..." + name.substr(name.size() - (MAXCHARS - 3));
+}
+
+//******************************************************************************
+// Function : findDetailSlot
+// Process  : Hash the detail's address to a slot
+//             Probe until the detail or an unused slot, claiming it
+// Notes    : Returns -1 if the table is full
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static int findDetailSlot(
+   AllocationCounts& counts,
+   const char* detail)
+{
+   static const size_t MASK = AllocationTracker::NUMDETAILS - 1;
+
+   size_t slot = (size_t(detail) >> 4) * 2654435761U; // Hashed address
+
+   for (int probe = 0; probe < AllocationTracker::NUMDETAILS; ++probe)
+   {
+      slot &= MASK;
+
+      const char* slotDetail = // Detail of the slot, NULL if unused
+         counts.details[slot].load(memory_order_relaxed);
+
+      if (detail == slotDetail)
+      {
+         return int(slot);
+      }
+
+      if (NULL == slotDetail)
+      {
+         counts.details[slot].store(detail, memory_order_release);
+         return int(slot);
+      }
+
+      ++slot;
+   }
+
+   return -1;
+}
+
+//******************************************************************************
+// Function : getThreadCounts
+// Process  : Allocate and register this thread's counts on first use
+// Notes    : Call inside the tracker, so the allocation isn't counted
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static AllocationCounts& getThreadCounts()
+{
+   if (NULL == threadCounts)
+   {
+      threadCounts = new AllocationCounts();
+
+      lock_guard<mutex> lock(countsMutex);
+      allCounts.push_back(threadCounts);
+   }
+
+   return *threadCounts;
+}
+
+//******************************************************************************
+// Function : compareSourceBytes
+// Process  : Does the first source have more bytes?
+// Notes    : Used with stable_sort
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool compareSourceBytes(
+   const AllocationTracker::Source& first,
+   const AllocationTracker::Source& second)
+{
+   return first.numBytes > second.numBytes;
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Zero everything, no details
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AllocationCounts::AllocationCounts()
+{
+   for (int phase = 0; phase <= Metrics::NUMPHASES; ++phase)
+   {
+      this->phaseAllocations[phase].store(0);
+      this->phaseBytes[phase].store(0);
+   }
+
+   for (int slot = 0; slot < AllocationTracker::NUMDETAILS; ++slot)
+   {
+      this->details[slot].store(NULL);
+      this->detailAllocations[slot].store(0);
+      this->detailBytes[slot].store(0);
+   }
+} // end AllocationCounts::AllocationCounts
+
+//******************************************************************************
+// Function : collect
+// Process  : Add up each phase, and none, over every thread
+//             Add up each detail over every thread
+//             Sort the details, most bytes first
+// Notes    : This thread's own allocations here are not counted
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::collect(
+   vector<Source>& phaseSources,
+   vector<Source>& detailSources)
+{
+   const bool                          WASINSIDE = insideTracker;
+   unordered_map<const char*, size_t>  detailIndices; // Into detailSources
+
+   insideTracker = true;
+
+   lock_guard<mutex> lock(countsMutex);
+
+   // Add up each phase, and none, over every thread
+   phaseSources.resize(Metrics::NUMPHASES + 1);
+
+   for (int phase = 0; phase <= Metrics::NUMPHASES; ++phase)
+   {
+      phaseSources[phase].name = (Metrics::NUMPHASES == phase) ? 
+         NOPHASENAME : Metrics::getPhaseName(Metrics::Phase(phase));
+      phaseSources[phase].numAllocations = 0;
+      phaseSources[phase].numBytes       = 0;
+
+      for (size_t countsIndex = 0; countsIndex < allCounts.size(); 
+           ++countsIndex)
+      {
+         phaseSources[phase].numAllocations += allCounts[countsIndex]->
+            phaseAllocations[phase].load(memory_order_relaxed);
+         phaseSources[phase].numBytes += allCounts[countsIndex]->
+            phaseBytes[phase].load(memory_order_relaxed);
+      }
+   }
+
+   // Add up each detail over every thread
+   detailSources.clear();
+
+   for (size_t countsIndex = 0; countsIndex < allCounts.size(); ++countsIndex)
+   {
+      const AllocationCounts& counts = *allCounts[countsIndex];
+
+      for (int slot = 0; slot < AllocationTracker::NUMDETAILS; ++slot)
+      {
+         const char* detail = counts.details[slot].load(memory_order_acquire);
+
+         if (NULL == detail)
+         {
+            continue;
+         }
+
+         if (detailIndices.end() == detailIndices.find(detail))
+         {
+            Source source = { detail, 0, 0 }; // New detail
+
+            detailIndices[detail] = detailSources.size();
+            detailSources.push_back(source);
+         }
+
+         Source& source = detailSources[detailIndices[detail]];
+
+         source.numAllocations += 
+            counts.detailAllocations[slot].load(memory_order_relaxed);
+         source.numBytes += counts.detailBytes[slot].load(memory_order_relaxed);
+      }
+   }
+
+   // Sort the details, most bytes first
+   stable_sort(detailSources.begin(), detailSources.end(), compareSourceBytes);
+
+   insideTracker = WASINSIDE;
+}
+
+//******************************************************************************
+// Function : enterPhase
+// Process  : Return the active phase and detail
+//             Make the phase, and the detail unless NULL, active
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::enterPhase(
+   const int phase,
+   const char* detail,
+   int& previousPhase,
+   const char*& previousDetail)
+{
+   previousPhase  = currentPhase;
+   previousDetail = currentDetail;
+   currentPhase   = phase;
+
+   if (NULL != detail)
+   {
+      currentDetail = detail;
+   }
+}
+
+//******************************************************************************
+// Function : exitPhase
+// Process  : Restore the phase and detail
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::exitPhase(
+   const int previousPhase,
+   const char* previousDetail)
+{
+   currentPhase  = previousPhase;
+   currentDetail = previousDetail;
+}
+
+//******************************************************************************
+// Function : getNumAllocations
+// Process  : Add up the allocations of each phase, and none
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+long long AllocationTracker::getNumAllocations()
+{
+   long long numAllocations = 0; // Of every phase
+
+   lock_guard<mutex> lock(countsMutex);
+
+   for (size_t countsIndex = 0; countsIndex < allCounts.size(); ++countsIndex)
+   {
+      for (int phase = 0; phase <= Metrics::NUMPHASES; ++phase)
+      {
+         numAllocations += allCounts[countsIndex]->
+            phaseAllocations[phase].load(memory_order_relaxed);
+      }
+   }
+
+   return numAllocations;
+}
+
+//******************************************************************************
+// Function : outputSummary
+// Process  : Collect the sources
+//             Output each phase with allocations
+//             Output the numDetails details with the most bytes
+//             Names are fitted to NAMECHARS
+// Notes    : Per symbol columns only for the phases, and only when
+//                numSymbols is positive, a detail is a single symbol
+//             No details when numDetails isn't positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Per symbol columns only for phases
+//******************************************************************************
+void AllocationTracker::outputSummary(
+   ostream& out,
+   const int numDetails,
+   const int numSymbols)
+{
+   vector<Source> phaseSources;  // Each phase, then none
+   vector<Source> detailSources; // Most bytes first
+
+   AllocationTracker::collect(phaseSources, detailSources);
+
+   for (int table = 0; table < (numDetails > 0 ? 2 : 1); ++table)
+   {
+      const vector<Source>& sources = (0 == table) ? phaseSources : 
+                                                     detailSources;
+      const int             NUMROWS = (0 == table) ? int(sources.size()) :
+                                      min(numDetails, int(sources.size()));
+      const bool            PERSYMBOL = (0 == table && numSymbols > 0);
+
+      out << setw(NAMECHARS) << left << (0 == table ? "phase" : "detail")
+          << right << setw(14) << "allocations" << setw(16) << "bytes";
+
+      if (PERSYMBOL)
+      {
+         out << setw(16) << "allocs/symbol" << setw(16) << "bytes/symbol";
+      }
+
+      out << endl;
+
+      // Output each source with allocations
+      for (int row = 0; row < NUMROWS; ++row)
+      {
+         if (0 == sources[row].numAllocations)
+         {
+            continue;
+         }
+
+         out << setw(NAMECHARS) << left << fitName(sources[row].name)
+             << right << setw(14) << sources[row].numAllocations
+             << setw(16) << sources[row].numBytes;
+
+         if (PERSYMBOL)
+         {
+            out << setw(16) << fixed << setprecision(2)
+                << double(sources[row].numAllocations) / numSymbols
+                << setw(16)
+                << double(sources[row].numBytes) / numSymbols;
+            out.unsetf(ios::floatfield);
+         }
+
+         out << endl;
+      }
+
+      out << endl;
+   }
+}
+
+//******************************************************************************
+// Function : recordAllocation
+// Process  : Ignore the tracker's own allocations
+//             Count it against the active phase, or none
+//             Count it against the active detail, if any and it has a slot
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::recordAllocation(const size_t numBytes)
+{
+   if (insideTracker)
+   {
+      return;
+   }
+
+   insideTracker = true;
+
+   AllocationCounts& counts = getThreadCounts(); // This thread's
+   const int         PHASE  = (AllocationTracker::NOPHASE == currentPhase) ?
+                              int(Metrics::NUMPHASES) : currentPhase;
+
+   // Count it against the active phase, or none
+   Metrics::addRelaxed(counts.phaseAllocations[PHASE], 1);
+   Metrics::addRelaxed(counts.phaseBytes[PHASE], numBytes);
+
+   // Count it against the active detail
+   if (NULL != currentDetail)
+   {
+      const int SLOT = findDetailSlot(counts, currentDetail);
+
+      if (SLOT >= 0)
+      {
+         Metrics::addRelaxed(counts.detailAllocations[SLOT], 1);
+         Metrics::addRelaxed(counts.detailBytes[SLOT], numBytes);
+      }
+   }
+
+   insideTracker = false;
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Zero every thread's counts and forget their details
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::reset()
+{
+   lock_guard<mutex> lock(countsMutex);
+
+   for (size_t countsIndex = 0; countsIndex < allCounts.size(); ++countsIndex)
+   {
+      AllocationCounts& counts = *allCounts[countsIndex];
+
+      for (int phase = 0; phase <= Metrics::NUMPHASES; ++phase)
+      {
+         counts.phaseAllocations[phase].store(0);
+         counts.phaseBytes[phase].store(0);
+      }
+
+      for (int slot = 0; slot < AllocationTracker::NUMDETAILS; ++slot)
+      {
+         counts.details[slot].store(NULL);
+         counts.detailAllocations[slot].store(0);
+         counts.detailBytes[slot].store(0);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : setEnabled
+// Process  : Mutator for enabled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AllocationTracker::setEnabled(const bool enabled)
+{
+   AllocationTracker::enabled.store(enabled);
+}
+
+#ifndef STOCK_ALLOCATIONS_OFF
+
+//******************************************************************************
+// Function : allocateMemory
+// Process  : Count the allocation when enabled
+//             Until malloc succeeds, at least one byte and aligned to
+//                alignment beyond the default
+//                Call the new handler, or throw bad_alloc if there is none
+// Notes    : What operator new does, see [new.delete.single]
+//             The Windows aligned heap is separate, so it is freed with
+//                freeMemory
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void* allocateMemory(
+   const size_t numBytes,
+   const size_t alignment)
+{
+   const size_t NUMBYTES = (0 == numBytes) ? 1 : numBytes;
+
+   void*       memory  = NULL; // Allocated
+   new_handler handler = NULL; // Frees memory, or throws
+
+   if (AllocationTracker::isEnabled())
+   {
+      AllocationTracker::recordAllocation(numBytes);
+   }
+
+   // Until malloc succeeds
+   for (;;)
+   {
+      if (0 == alignment)
+      {
+         memory = malloc(NUMBYTES);
+      }
+      else
+      {
+#ifdef _WIN32
+         memory = _aligned_malloc(NUMBYTES, alignment);
+#else
+         if (0 != posix_memalign(&memory, alignment, NUMBYTES))
+         {
+            memory = NULL;
+         }
+#endif
+      }
+
+      if (NULL != memory)
+      {
+         return memory;
+      }
+
+      // Call the new handler, or throw bad_alloc if there is none
+      handler = get_new_handler();
+
+      if (NULL == handler)
+      {
+         throw bad_alloc();
+      }
+
+      handler();
+   }
+}
+
+//******************************************************************************
+// Function : freeMemory
+// Process  : Free memory from allocateMemory with the same alignment
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void freeMemory(
+   void* memory,
+   const size_t alignment)
+{
+#ifdef _WIN32
+   if (0 != alignment)
+   {
+      _aligned_free(memory);
+      return;
+   }
+#else
+   (void)alignment;
+#endif
+
+   free(memory);
+}
+
+//******************************************************************************
+// Function : operator new, operator new[]
+// Process  : Allocate with allocateMemory, unaligned
+// Notes    : Calls the new handler, then throws bad_alloc, when out of
+//             memory
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Calls the new handler
+//******************************************************************************
+void* operator new(size_t numBytes)
+{
+   return allocateMemory(numBytes, 0);
+}
+
+void* operator new[](size_t numBytes)
+{
+   return allocateMemory(numBytes, 0);
+}
+
+//******************************************************************************
+// Function : operator delete, operator delete[]
+// Process  : Free with freeMemory, unaligned
+// Notes    : The sized forms ignore the size, malloc knows it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the sized forms
+//******************************************************************************
+void operator delete(void* memory) noexcept
+{
+   freeMemory(memory, 0);
+}
+
+void operator delete[](void* memory) noexcept
+{
+   freeMemory(memory, 0);
+}
+
+void operator delete(
+   void* memory,
+   size_t) noexcept
+{
+   freeMemory(memory, 0);
+}
+
+void operator delete[](
+   void* memory,
+   size_t) noexcept
+{
+   freeMemory(memory, 0);
+}
+
+#ifdef __cpp_aligned_new
+
+//******************************************************************************
+// Function : operator new, operator new[], aligned
+// Process  : Allocate with allocateMemory, aligned
+// Notes    : C++17 uses them for types aligned beyond the default
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void* operator new(
+   size_t numBytes,
+   align_val_t alignment)
+{
+   return allocateMemory(numBytes, size_t(alignment));
+}
+
+void* operator new[](
+   size_t numBytes,
+   align_val_t alignment)
+{
+   return allocateMemory(numBytes, size_t(alignment));
+}
+
+//******************************************************************************
+// Function : operator delete, operator delete[], aligned
+// Process  : Free with freeMemory, aligned
+// Notes    : The sized forms ignore the size
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void operator delete(
+   void* memory,
+   align_val_t alignment) noexcept
+{
+   freeMemory(memory, size_t(alignment));
+}
+
+void operator delete[](
+   void* memory,
+   align_val_t alignment) noexcept
+{
+   freeMemory(memory, size_t(alignment));
+}
+
+void operator delete(
+   void* memory,
+   size_t,
+   align_val_t alignment) noexcept
+{
+   freeMemory(memory, size_t(alignment));
+}
+
+void operator delete[](
+   void* memory,
+   size_t,
+   align_val_t alignment) noexcept
+{
+   freeMemory(memory, size_t(alignment));
+}
+
+#endif // __cpp_aligned_new
+
+#endif // STOCK_ALLOCATIONS_OFF
\ No newline at end of file
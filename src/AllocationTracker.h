@@ -0,0 +1,182 @@
+//******************************************************************************
+//
+// File Name:     AllocationTracker.h
+//
+// File Overview: Represents an AllocationTracker, heap allocations of an
+//                analysis by phase and symbol
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added STOCK_ALLOCATIONS_OFF
+//******************************************************************************
+
+#ifndef AllocationTracker_h
+#define AllocationTracker_h
+
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    AllocationTracker
+//
+// Overview: Counts the heap allocations, and their bytes, of every thread
+//             while enabled, through the global operator new replaced in
+//             AllocationTracker.cpp
+//             Each allocation is attributed to its thread's active Metrics
+//                phase and detail, the stock data file name of the stock
+//                being analyzed, which MetricsTimer sets while enabled
+//             Allocations outside any phase are attributed to "none"
+//             Disabled by default, when disabled operator new costs one
+//                relaxed load and a branch
+//             Define STOCK_ALLOCATIONS_OFF to keep the standard operator new
+//                and delete, nothing is counted then
+//             Everything is static, there is nothing to construct
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added STOCK_ALLOCATIONS_OFF
+//
+//******************************************************************************
+class AllocationTracker
+{
+public:
+
+   //***************************************************************************
+   //
+   // Class:    Source
+   //
+   // Overview: Allocations attributed to one phase or one detail
+   //
+   //***************************************************************************
+   struct Source
+   {
+      string    name;           // Phase name or detail
+      long long numAllocations; // Allocations attributed
+      long long numBytes;       // Bytes requested by them
+   }; // end struct Source
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : collect
+   // Description : Merges every thread's counts into the allocations of
+   //                each phase, "none" last, and of each detail, most bytes
+   //                first
+   // Constraints : Details are compared by address, the same text at two
+   //                addresses is listed twice
+   //***************************************************************************
+   static void collect(
+      vector<Source>& phaseSources,
+      vector<Source>& detailSources);
+
+   //***************************************************************************
+   // Function    : enterPhase
+   // Description : Makes the phase, and the detail unless NULL, this 
+   //                thread's active ones, returning the previous ones
+   // Constraints : Pair with exitPhase, see MetricsTimer
+   //***************************************************************************
+   static void enterPhase(
+      const int phase,
+      const char* detail,
+      int& previousPhase,
+      const char*& previousDetail);
+
+   //***************************************************************************
+   // Function    : exitPhase
+   // Description : Restores the phase and detail returned by enterPhase
+   // Constraints : None
+   //***************************************************************************
+   static void exitPhase(
+      const int previousPhase,
+      const char* previousDetail);
+
+   //***************************************************************************
+   // Function    : getNumAllocations
+   // Description : Retrieve the allocations of every thread since reset
+   // Constraints : None
+   //***************************************************************************
+   static long long getNumAllocations();
+
+   //***************************************************************************
+   // Function    : isEnabled
+   // Description : Accessor for enabled
+   // Constraints : None
+   //***************************************************************************
+   static inline bool isEnabled();
+
+   //***************************************************************************
+   // Function    : outputSummary
+   // Description : Outputs the allocations of each phase, per symbol when
+   //                numSymbols is positive, and of the numDetails details
+   //                with the most bytes
+   // Constraints : No details when numDetails isn't positive
+   //***************************************************************************
+   static void outputSummary(
+      ostream& out,
+      const int numDetails,
+      const int numSymbols);
+
+   //***************************************************************************
+   // Function    : recordAllocation
+   // Description : Counts an allocation of numBytes against this thread's
+   //                active phase and detail
+   // Constraints : Only call when enabled, see operator new
+   //***************************************************************************
+   static void recordAllocation(const size_t numBytes);
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Zeroes every thread's counts
+   // Constraints : Don't call while other threads allocate
+   //***************************************************************************
+   static void reset();
+
+   //***************************************************************************
+   // Function    : setEnabled
+   // Description : Mutator for enabled
+   // Constraints : None
+   //***************************************************************************
+   static void setEnabled(const bool enabled);
+
+   static const int NOPHASE    = -1;   // Active phase outside any phase
+   static const int NUMDETAILS = 4096; // Details counted per thread, later
+                                       // ones are counted without a detail
+
+private:
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Not constructed, everything is static
+   // Constraints : None
+   //***************************************************************************
+   AllocationTracker();
+
+   static atomic<bool> enabled; // Count allocations?
+}; // end class AllocationTracker
+
+//******************************************************************************
+// Function : isEnabled
+// Process  : Accessor for enabled
+// Notes    : Relaxed, checked on every allocation
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool AllocationTracker::isEnabled()
+{
+   return AllocationTracker::enabled.load(memory_order_relaxed);
+}
+
+#endif // AllocationTracker_h
@@ -0,0 +1,507 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     AnalysisDaemon.cpp
+//
+// File Overview: Represents an AnalysisDaemon
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added SNAPSHOT
+// 10.19.26       Donne Martin         Added the shared ranking
+// 10.19.26       Donne Martin         Bounded connections and sends
+// 10.19.26       Donne Martin         SNAPSHOT saves to the snapshot file only
+//******************************************************************************
+
+#include "stdafx.h"
+#include <exception>
+#include <iomanip>
+
+#include "AnalysisDaemon.h"
+#include "AnalyzerSnapshot.h"
+#include "SharedRanking.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+const char* AnalysisDaemon::DEFAULTSOCKETPATH = "stockanalyzer.sock";
+
+static const int RESPONSEPRECISION = 10; // Significant digits in responses
+
+//******************************************************************************
+// Function : constructor
+// Process  : Not running, no ranking cached yet, no shared ranking
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the shared ranking
+//******************************************************************************
+AnalysisDaemon::AnalysisDaemon(PortfolioAnalyzer& portfolioAnalyzer)
+   : portfolioAnalyzer(portfolioAnalyzer),
+     isRankingCurrent(false),
+     sharedRanking(NULL),
+     running(false),
+     stopRequested(false)
+{
+} // end AnalysisDaemon::AnalysisDaemon
+
+//******************************************************************************
+// Function : destructor
+// Process  : Close any open connections
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AnalysisDaemon::~AnalysisDaemon()
+{
+   while (!this->connections.empty())
+   {
+      this->closeConnection(this->connections.size() - 1);
+   }
+} // end AnalysisDaemon::~AnalysisDaemon
+
+//******************************************************************************
+// Function : closeConnection
+// Process  : Delete the connection, which closes it
+//             Remove it from our list
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AnalysisDaemon::closeConnection(const int connectionIndex)
+{
+   delete this->connections[connectionIndex];
+   this->connections.erase(this->connections.begin() + connectionIndex);
+}
+
+//******************************************************************************
+// Function : handleBar
+// Process  : Read the symbol and closing price
+//             Update the stock with the new price
+//             The cached ranking is no longer current
+//             Publish the stock to the shared ranking, if any
+//             Answer with the new MACD and slope
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Publishes to the shared ranking
+//******************************************************************************
+void AnalysisDaemon::handleBar(
+   istringstream& arguments,
+   ostringstream& response)
+{
+   string symbol;              // Stock to update
+   double closingPrice  = 0.0; // New closing price
+   int    analyzerIndex = -1;  // Stock's analyzer
+
+   if (!(arguments >> symbol >> closingPrice) || closingPrice <= 0.0)
+   {
+      response << "ERR usage: BAR <symbol> <close>";
+      return;
+   }
+
+   analyzerIndex = this->portfolioAnalyzer.findStockAnalyzerIndex(symbol);
+
+   if (analyzerIndex < 0)
+   {
+      response << "ERR unknown symbol " << symbol;
+      return;
+   }
+
+   // Update the stock with the new price
+   this->portfolioAnalyzer.updateStockWithPrice(analyzerIndex, closingPrice);
+   this->isRankingCurrent = false;
+
+   const StockAnalyzer& stockAnalyzer =
+      this->portfolioAnalyzer.getStockAnalyzerRefAtIndex(analyzerIndex);
+
+   // Publish the stock to the shared ranking, if any
+   if (NULL != this->sharedRanking)
+   {
+      vector<int>            symbolIndices(1, analyzerIndex); // The stock
+      vector<RankingSummary> summaries(1);                    // Its summary
+
+      RankingPublisher::summarizeAnalyzer(
+         stockAnalyzer, this->portfolioAnalyzer.getPeriodsSlope(),
+         summaries[0]);
+      this->sharedRanking->update(symbolIndices, summaries);
+   }
+
+   response << "OK " << symbol
+            << ' ' << stockAnalyzer.getCurrentMACD()
+            << ' ' << stockAnalyzer.getSlopeMACD();
+}
+
+//******************************************************************************
+// Function : handleMACD
+// Process  : Read the symbol
+//             Answer with the stock's MACDs, slope, and current EMAs
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AnalysisDaemon::handleMACD(
+   istringstream& arguments,
+   ostringstream& response)
+{
+   string symbol;              // Stock to report
+   int    analyzerIndex = -1;  // Stock's analyzer
+
+   if (!(arguments >> symbol))
+   {
+      response << "ERR usage: MACD <symbol>";
+      return;
+   }
+
+   analyzerIndex = this->portfolioAnalyzer.findStockAnalyzerIndex(symbol);
+
+   if (analyzerIndex < 0)
+   {
+      response << "ERR unknown symbol " << symbol;
+      return;
+   }
+
+   const StockAnalyzer& stockAnalyzer =
+      this->portfolioAnalyzer.getStockAnalyzerRefAtIndex(analyzerIndex);
+
+   response << "OK " << symbol
+            << ' ' << stockAnalyzer.getCurrentMACD()
+            << ' ' << stockAnalyzer.getYesterdayMACD()
+            << ' ' << stockAnalyzer.getSlopeMACD()
+            << ' ' << stockAnalyzer.getCurrentEMAFast()
+            << ' ' << stockAnalyzer.getCurrentEMASlow();
+}
+
+//******************************************************************************
+// Function : handleRequest
+// Process  : Read the command
+//             Answer it with the matching handler
+//             Answer failures with ERR
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added SNAPSHOT
+//******************************************************************************
+void AnalysisDaemon::handleRequest(
+   const string& request,
+   string& response)
+{
+   istringstream arguments(request); // Command and its arguments
+   ostringstream answer;             // Response being built
+   string        command;            // First word of the request
+
+   answer << setprecision(RESPONSEPRECISION);
+   arguments >> command;
+
+   try
+   {
+      if ("MACD" == command)
+      {
+         this->handleMACD(arguments, answer);
+      }
+      else if ("TOP" == command)
+      {
+         this->handleTop(arguments, answer);
+      }
+      else if ("BAR" == command)
+      {
+         this->handleBar(arguments, answer);
+      }
+      else if ("SNAPSHOT" == command)
+      {
+         this->handleSnapshot(arguments, answer);
+      }
+      else if ("PING" == command)
+      {
+         answer << "OK";
+      }
+      else if ("SHUTDOWN" == command)
+      {
+         answer << "OK";
+         this->stop();
+      }
+      else
+      {
+         answer << "ERR unknown request";
+      }
+   }
+   catch (const exception& exception)
+   {
+      answer.str("");
+      answer << "ERR " << exception.what();
+   }
+
+   response = answer.str();
+}
+
+//******************************************************************************
+// Function : handleSnapshot
+// Process  : Check there are no arguments and a snapshot file is set
+//             Save the state of every stock to the snapshot file
+//             Answer with the number of stocks saved
+// Notes    : A client can't name the file, so SNAPSHOT can't write
+//                anywhere the daemon's user can
+//             A failed save is answered with ERR by handleRequest, the last
+//                snapshot is left whole
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Saves to the snapshot file only
+//******************************************************************************
+void AnalysisDaemon::handleSnapshot(
+   istringstream& arguments,
+   ostringstream& response)
+{
+   string           argument;         // Anything after SNAPSHOT
+   AnalyzerSnapshot analyzerSnapshot; // State of every stock
+
+   if (arguments >> argument)
+   {
+      response << "ERR usage: SNAPSHOT";
+      return;
+   }
+
+   if (this->snapshotFileName.empty())
+   {
+      response << "ERR no snapshot file";
+      return;
+   }
+
+   // Save the state of every stock to the snapshot file
+   analyzerSnapshot.setFromPortfolio(this->portfolioAnalyzer);
+   analyzerSnapshot.save(this->snapshotFileName.c_str());
+
+   response << "OK " << analyzerSnapshot.getNumStocks();
+}
+
+//******************************************************************************
+// Function : handleTop
+// Process  : Read the number of stocks
+//             Rank the portfolio unless the cached ranking covers the request
+//             Answer with each ranked symbol and its slope
+// Notes    : The ranking is only recalculated after a BAR or for a larger n
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AnalysisDaemon::handleTop(
+   istringstream& arguments,
+   ostringstream& response)
+{
+   int numStocks    = 0; // Stocks requested
+   int numAnalyzers = this->portfolioAnalyzer.getNumStockAnalyzers();
+
+   if (!(arguments >> numStocks) ||
+       numStocks < 1 ||
+       numStocks > AnalysisDaemon::MAXTOPSTOCKS)
+   {
+      response << "ERR usage: TOP <n>, 1 <= n <= "
+               << AnalysisDaemon::MAXTOPSTOCKS;
+      return;
+   }
+
+   numStocks = min(numStocks, numAnalyzers);
+
+   // Rank the portfolio unless the cached ranking covers the request
+   if (!this->isRankingCurrent ||
+       int(this->rankedIndices.size()) < numStocks)
+   {
+      this->portfolioAnalyzer.getTopStocksByMACDSlope(
+         numStocks,
+         this->rankedIndices);
+      this->isRankingCurrent = true;
+   }
+
+   response << "OK " << numStocks;
+
+   for (int rank = 0; rank < numStocks; ++rank)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         this->portfolioAnalyzer.getStockAnalyzerRefAtIndex(
+            this->rankedIndices[rank]);
+
+      response << ' ' << stockAnalyzer.getStockSymbol()
+               << ' ' << stockAnalyzer.getSlopeMACD();
+   }
+}
+
+//******************************************************************************
+// Function : run
+// Process  : Listen on the socket path
+//             Until stopped
+//                Wait for a connection or request, or the timeout
+//                Serve every connection with input, close finished ones
+//                Accept a new connection, closing it at once if the fd_set
+//                   can't hold it, or MAXCONNECTIONS are served
+//             Close every connection and remove the socket file
+// Notes    : Throws an exception if the socket can't be bound
+//             An fd_set holds FD_SETSIZE descriptors below FD_SETSIZE on
+//                POSIX, and FD_SETSIZE sockets of any value on Windows,
+//                one of them the listener
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Bounded connections and sends
+//******************************************************************************
+void AnalysisDaemon::run(const string& socketPath)
+{
+   const int   MAXSERVED = min(AnalysisDaemon::MAXCONNECTIONS,
+                               int(FD_SETSIZE) - 1);
+
+   LocalSocket listener;        // Accepts connections
+   fd_set      readableSockets; // Sockets select found readable
+   timeval     timeout;         // Longest wait before checking for stop
+   int         maxSocket = 0;   // Highest descriptor, for select
+
+   listener.listenOn(socketPath);
+   this->stopRequested = false;
+   this->running       = true;
+
+   while (!this->stopRequested)
+   {
+      // Wait for a connection or request, or the timeout
+      FD_ZERO(&readableSockets);
+      FD_SET(listener.getNativeSocket(), &readableSockets);
+      maxSocket = int(listener.getNativeSocket());
+
+      for (size_t index = 0; index < this->connections.size(); ++index)
+      {
+         FD_SET(this->connections[index]->getNativeSocket(), &readableSockets);
+         maxSocket = max(maxSocket,
+                         int(this->connections[index]->getNativeSocket()));
+      }
+
+      timeout.tv_sec  = 0;
+      timeout.tv_usec = AnalysisDaemon::SELECTTIMEOUTMICROS;
+
+      if (select(maxSocket + 1, &readableSockets, NULL, NULL, &timeout) <= 0)
+      {
+         continue;
+      }
+
+      // Serve every connection with input, close finished ones
+      for (int index = int(this->connections.size()) - 1; index >= 0; --index)
+      {
+         if (FD_ISSET(this->connections[index]->getNativeSocket(),
+                      &readableSockets) &&
+             !this->serveConnection(*this->connections[index]))
+         {
+            this->closeConnection(index);
+         }
+      }
+
+      // Accept a new connection
+      if (FD_ISSET(listener.getNativeSocket(), &readableSockets))
+      {
+         LocalSocket* connection = new LocalSocket(); // New client
+         bool         isServed   = false;             // Kept open?
+
+         if (listener.acceptConnection(*connection) &&
+             int(this->connections.size()) < MAXSERVED)
+         {
+#ifdef _WIN32
+            isServed = true;
+#else
+            isServed = connection->getNativeSocket() < FD_SETSIZE;
+#endif
+         }
+
+         if (isServed)
+         {
+            try
+            {
+               connection->setSendTimeout(AnalysisDaemon::SENDTIMEOUTMILLIS);
+               this->connections.push_back(connection);
+            }
+            catch (const exception&)
+            {
+               isServed = false;
+            }
+         }
+
+         // Closing it at once if the fd_set can't hold it
+         if (!isServed)
+         {
+            delete connection;
+         }
+      }
+   }
+
+   // Close every connection and remove the socket file
+   while (!this->connections.empty())
+   {
+      this->closeConnection(this->connections.size() - 1);
+   }
+
+   listener.closeSocket();
+   LocalSocket::removeSocketFile(socketPath);
+   this->running = false;
+}
+
+//******************************************************************************
+// Function : serveConnection
+// Process  : Receive the complete requests available
+//             Answer each one
+// Notes    : Returns false if the client closed or the connection failed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool AnalysisDaemon::serveConnection(LocalSocket& connection)
+{
+   vector<string> requests; // Complete requests received
+   string         response; // Answer to one request
+
+   try
+   {
+      if (!connection.receiveLines(requests))
+      {
+         return false;
+      }
+
+      for (size_t index = 0; index < requests.size(); ++index)
+      {
+         this->handleRequest(requests[index], response);
+         connection.sendLine(response);
+      }
+   }
+   catch (const exception&)
+   {
+      return false;
+   }
+
+   return true;
+}
\ No newline at end of file
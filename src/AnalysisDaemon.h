@@ -0,0 +1,272 @@
+//******************************************************************************
+//
+// File Name:     AnalysisDaemon.h
+//
+// File Overview: Represents an AnalysisDaemon
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added SNAPSHOT
+// 10.19.26       Donne Martin         Added the shared ranking
+// 10.19.26       Donne Martin         Bounded connections and sends
+// 10.19.26       Donne Martin         SNAPSHOT saves to the snapshot file only
+//******************************************************************************
+
+#ifndef AnalysisDaemon_h
+#define AnalysisDaemon_h
+
+#include <atomic>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "LocalSocket.h"
+#include "PortfolioAnalyzer.h"
+
+class SharedRankingWriter;
+
+//******************************************************************************
+//
+// Class:    AnalysisDaemon
+//
+// Overview: Keeps an analyzed portfolio in memory and answers queries over a
+//             LocalSocket, so the universe is parsed once per process
+//             One thread serves every connection with select, so the
+//             portfolio needs no locking
+//             At most MAXCONNECTIONS clients are served, more are closed as
+//             they connect, a request longer than LocalSocket::MAXLINEBYTES
+//             or a client not reading its responses within
+//             SENDTIMEOUTMILLIS closes that client
+//
+//           Line protocol, one request and one response per line:
+//             MACD <symbol>         OK <symbol> <currentMACD> <yesterdayMACD>
+//                                       <slopeMACD> <EMA fast> <EMA slow>
+//             TOP <n>               OK <count> <symbol> <slopeMACD> ...
+//                                       highest MACD slope first
+//             BAR <symbol> <close>  OK <symbol> <currentMACD> <slopeMACD>
+//                                       after adding the new closing price
+//             SNAPSHOT              OK <count> once the AnalyzerSnapshot of
+//                                       every stock is saved to the
+//                                       daemon's snapshot file, clients
+//                                       can't name a file
+//             PING                  OK
+//             SHUTDOWN              OK, then the daemon stops
+//           Failures are answered with ERR <reason>
+//           With a SharedRankingWriter, each BAR also publishes the stock's
+//             summary and the new ranking to shared memory
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added SNAPSHOT
+// 10.19.26       Donne Martin         Added the shared ranking
+// 10.19.26       Donne Martin         Bounded connections and sends
+// 10.19.26       Donne Martin         SNAPSHOT saves to the snapshot file only
+//
+//******************************************************************************
+class AnalysisDaemon
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Serves the portfolio, which must already be analyzed
+   // Constraints : portfolioAnalyzer must outlive the daemon
+   //***************************************************************************
+   explicit AnalysisDaemon(PortfolioAnalyzer& portfolioAnalyzer);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Closes any open connections
+   // Constraints : None
+   //***************************************************************************
+   virtual ~AnalysisDaemon();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : handleRequest
+   // Description : Answers one request line of the protocol
+   // Constraints : None
+   //***************************************************************************
+   void handleRequest(
+      const string& request,
+      string& response);
+
+   //***************************************************************************
+   // Function    : isRunning
+   // Description : Is the daemon accepting connections?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isRunning() const;
+
+   //***************************************************************************
+   // Function    : run
+   // Description : Listens on socketPath and serves requests until SHUTDOWN
+   //                or stop
+   // Constraints : Throws an exception if the socket can't be bound
+   //***************************************************************************
+   void run(const string& socketPath);
+
+   //***************************************************************************
+   // Function    : setSharedRanking
+   // Description : Publishes the stock of each BAR to the shared ranking,
+   //                NULL for none
+   // Constraints : The shared ranking's symbols must be the portfolio's
+   //                stock analyzers, and it must outlive the daemon
+   //***************************************************************************
+   inline void setSharedRanking(SharedRankingWriter* sharedRanking);
+
+   //***************************************************************************
+   // Function    : setSnapshotFileName
+   // Description : The file SNAPSHOT saves to, empty for none
+   // Constraints : None
+   //***************************************************************************
+   inline void setSnapshotFileName(const string& snapshotFileName);
+
+   //***************************************************************************
+   // Function    : stop
+   // Description : Asks run to return, safe to call from any thread
+   // Constraints : None
+   //***************************************************************************
+   inline void stop();
+
+   static const char* DEFAULTSOCKETPATH;         // Socket path if none given
+   static const int   SELECTTIMEOUTMICROS = 100000; // How often run checks
+                                                    // for stop
+   static const int   MAXTOPSTOCKS        = 1000;   // Largest TOP request
+   static const int   MAXCONNECTIONS      = 256;    // Clients served at once
+   static const int   SENDTIMEOUTMILLIS   = 1000;   // Longest wait for a
+                                                    // client to read
+
+private:
+   //***************************************************************************
+   // Function    : closeConnection
+   // Description : Closes and forgets the connection at the specified index
+   // Constraints : None
+   //***************************************************************************
+   void closeConnection(const int connectionIndex);
+
+   //***************************************************************************
+   // Function    : handleBar
+   // Description : Answers BAR <symbol> <close>
+   // Constraints : None
+   //***************************************************************************
+   void handleBar(
+      istringstream& arguments,
+      ostringstream& response);
+
+   //***************************************************************************
+   // Function    : handleMACD
+   // Description : Answers MACD <symbol>
+   // Constraints : None
+   //***************************************************************************
+   void handleMACD(
+      istringstream& arguments,
+      ostringstream& response);
+
+   //***************************************************************************
+   // Function    : handleSnapshot
+   // Description : Answers SNAPSHOT
+   // Constraints : None
+   //***************************************************************************
+   void handleSnapshot(
+      istringstream& arguments,
+      ostringstream& response);
+
+   //***************************************************************************
+   // Function    : handleTop
+   // Description : Answers TOP <n>
+   // Constraints : None
+   //***************************************************************************
+   void handleTop(
+      istringstream& arguments,
+      ostringstream& response);
+
+   //***************************************************************************
+   // Function    : serveConnection
+   // Description : Answers every complete request received on the connection
+   //                Returns false once the connection should be closed
+   // Constraints : None
+   //***************************************************************************
+   bool serveConnection(LocalSocket& connection);
+
+   vector<LocalSocket*> connections;       // Open client connections, owned
+   PortfolioAnalyzer&   portfolioAnalyzer; // Portfolio being served
+   vector<int>          rankedIndices;     // Cached TOP ranking
+   bool                 isRankingCurrent;  // rankedIndices still valid?
+   SharedRankingWriter* sharedRanking;     // Updated on BAR, NULL for none
+   string               snapshotFileName;  // Saved to by SNAPSHOT, empty for
+                                           // none
+   atomic<bool>         running;           // Serving requests?
+   atomic<bool>         stopRequested;     // Asked to stop?
+}; // end class AnalysisDaemon
+
+//******************************************************************************
+// Function : isRunning
+// Process  : Accessor for running
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool AnalysisDaemon::isRunning() const
+{
+   return this->running;
+}
+
+//******************************************************************************
+// Function : setSharedRanking
+// Process  : Mutator for sharedRanking
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void AnalysisDaemon::setSharedRanking(
+   SharedRankingWriter* sharedRanking)
+{
+   this->sharedRanking = sharedRanking;
+}
+
+//******************************************************************************
+// Function : setSnapshotFileName
+// Process  : Mutator for snapshotFileName
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void AnalysisDaemon::setSnapshotFileName(
+   const string& snapshotFileName)
+{
+   this->snapshotFileName = snapshotFileName;
+}
+
+//******************************************************************************
+// Function : stop
+// Process  : Flag run to return at its next select timeout
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void AnalysisDaemon::stop()
+{
+   this->stopRequested = true;
+}
+
+#endif // AnalysisDaemon_h
\ No newline at end of file
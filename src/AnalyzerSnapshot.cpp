@@ -0,0 +1,310 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     AnalyzerSnapshot.cpp
+//
+// File Overview: Represents an AnalyzerSnapshot
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses BinaryBuffer
+//******************************************************************************
+
+#include "stdafx.h"
+#include <exception>
+
+#include "AnalyzerSnapshot.h"
+#include "BinaryBuffer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const int MAXFILENAMELENGTH = 65535; // Length is stored in 2 bytes
+
+//******************************************************************************
+// Function : constructor
+// Process  : No stocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AnalyzerSnapshot::AnalyzerSnapshot()
+   : periodsSlope(0)
+{
+} // end AnalyzerSnapshot::AnalyzerSnapshot
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+AnalyzerSnapshot::~AnalyzerSnapshot()
+{
+} // end AnalyzerSnapshot::~AnalyzerSnapshot
+
+//******************************************************************************
+// Function : load
+// Process  : Read the whole file
+//             Check the magic number, version, and price policy
+//                Older versions lack the signal, so they aren't read
+//             Read the state of each stock
+//             Check the trailing magic number, so a file cut short at a
+//                stock boundary is caught
+// Notes    : See save for the layout
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Reads with BinaryBuffer
+// 10.19.26       Donne Martin         Rejects other versions by name
+//******************************************************************************
+void AnalyzerSnapshot::load(const char* snapshotFileName)
+{
+   BinaryBuffer   buffer("Analyzer snapshot is truncated"); // The whole file
+   unsigned int   magic        = 0;       // Identifies the file
+   unsigned int   version      = 0;       // Of the file layout
+   int            storageBytes = 0;       // Of the price policy's storage
+   int            accumBytes   = 0;       // Of the price policy's accum
+   int            numStocks    = 0;       // Stocks to read
+   unsigned short length       = 0;       // Of a stock data file name
+
+   // Read the whole file
+   if (!buffer.load(snapshotFileName))
+   {
+      throw exception("Could not read the analyzer snapshot");
+   }
+
+   // Check the magic number, version, and price policy
+   buffer.readValue(magic);
+   buffer.readValue(version);
+
+   if (AnalyzerSnapshot::MAGIC != magic)
+   {
+      throw exception("Not an analyzer snapshot");
+   }
+
+   if (AnalyzerSnapshot::VERSION != version)
+   {
+      throw exception("Analyzer snapshot is of another version");
+   }
+
+   buffer.readValue(storageBytes);
+   buffer.readValue(accumBytes);
+
+   if (sizeof(AnalyzerPricePolicy::StorageType) != size_t(storageBytes) ||
+       sizeof(AnalyzerPricePolicy::AccumType) != size_t(accumBytes))
+   {
+      throw exception("Analyzer snapshot is of another price policy");
+   }
+
+   buffer.readValue(this->periodsSlope);
+   buffer.readValue(numStocks);
+
+   if (numStocks < 0 || size_t(numStocks) > buffer.getNumUnreadBytes())
+   {
+      throw exception("Not an analyzer snapshot");
+   }
+
+   this->stockDataFileNames.resize(numStocks);
+   this->manifestIndices.resize(numStocks);
+   this->states.resize(numStocks);
+
+   // Read the state of each stock
+   for (int stockIndex = 0; stockIndex < numStocks; ++stockIndex)
+   {
+      StockAnalyzerState& state = this->states[stockIndex];
+
+      buffer.readValue(this->manifestIndices[stockIndex]);
+      buffer.readValue(length);
+      buffer.readBytes(length, this->stockDataFileNames[stockIndex]);
+
+      buffer.readValue(state.periodsFast);
+      buffer.readValue(state.periodsSlow);
+      buffer.readValue(state.periodsSlope);
+      buffer.readValue(state.numPrices);
+      buffer.readValues(state.recentPrices);
+      buffer.readValues(state.recentEMAFast);
+      buffer.readValues(state.recentEMASlow);
+      buffer.readValue(state.firstPeriodSMAFast);
+      buffer.readValue(state.firstPeriodSMASlow);
+      buffer.readValue(state.multEMAFast);
+      buffer.readValue(state.multEMASlow);
+      buffer.readValues(state.regressionMACD.values);
+      buffer.readValue(state.regressionMACD.sumXY);
+      buffer.readValue(state.regressionMACD.sumY);
+      buffer.readValue(state.regressionMACD.numSinceSums);
+      buffer.readValue(state.signalMACD.average);
+      buffer.readValue(state.signalMACD.numValues);
+      buffer.readValue(state.lastBar.startMicros);
+      buffer.readValue(state.lastBar.open);
+      buffer.readValue(state.lastBar.high);
+      buffer.readValue(state.lastBar.low);
+      buffer.readValue(state.lastBar.close);
+      buffer.readValue(state.lastBar.volume);
+      buffer.readValue(state.lastBar.numTicks);
+      buffer.readValue(state.lastDate);
+   }
+
+   // Check the trailing magic number
+   buffer.readValue(magic);
+
+   if (AnalyzerSnapshot::MAGIC != magic || buffer.getNumUnreadBytes() != 0)
+   {
+      throw exception("Not an analyzer snapshot");
+   }
+}
+
+//******************************************************************************
+// Function : save
+// Process  : Lay the snapshot out in a buffer
+//                The header, the state of each stock, and the trailing
+//                magic number
+//             Replace the file with the buffer at once
+// Notes    : Layout, all native byte order:
+//                unsigned MAGIC, unsigned VERSION, int storage bytes,
+//                int accum bytes, int periodsSlope, int numStocks
+//                numStocks x (int manifestIndex, unsigned short length,
+//                   file name chars, int periodsFast, int periodsSlow,
+//                   int periodsSlope, long long numPrices, recentPrices,
+//                   recentEMAFast, recentEMASlow, double firstPeriodSMAFast,
+//                   double firstPeriodSMASlow, double multEMAFast,
+//                   double multEMASlow, regression values, double sumXY,
+//                   double sumY, int numSinceSums, double signal average,
+//                   int signal numValues, the last bar's fields,
+//                   int lastDate)
+//                unsigned MAGIC
+//                each list of values an int count and that many doubles
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Lays out with BinaryBuffer
+// 10.19.26       Donne Martin         Version 2 adds the signal and last date
+//******************************************************************************
+void AnalyzerSnapshot::save(const char* snapshotFileName) const
+{
+   BinaryBuffer buffer("Analyzer snapshot is truncated"); // The whole file
+   const int    NUMSTOCKS = this->getNumStocks();  // Stocks to write
+
+   // Lay the snapshot out in a buffer
+   buffer.appendValue((unsigned int)AnalyzerSnapshot::MAGIC);
+   buffer.appendValue((unsigned int)AnalyzerSnapshot::VERSION);
+   buffer.appendValue(int(sizeof(AnalyzerPricePolicy::StorageType)));
+   buffer.appendValue(int(sizeof(AnalyzerPricePolicy::AccumType)));
+   buffer.appendValue(this->periodsSlope);
+   buffer.appendValue(NUMSTOCKS);
+
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      const StockAnalyzerState& state    = this->states[stockIndex];
+      const string&             fileName = this->stockDataFileNames[stockIndex];
+
+      buffer.appendValue(this->manifestIndices[stockIndex]);
+      buffer.appendValue((unsigned short)fileName.size());
+      buffer.appendBytes(fileName.data(), fileName.size());
+
+      buffer.appendValue(state.periodsFast);
+      buffer.appendValue(state.periodsSlow);
+      buffer.appendValue(state.periodsSlope);
+      buffer.appendValue(state.numPrices);
+      buffer.appendValues(state.recentPrices);
+      buffer.appendValues(state.recentEMAFast);
+      buffer.appendValues(state.recentEMASlow);
+      buffer.appendValue(state.firstPeriodSMAFast);
+      buffer.appendValue(state.firstPeriodSMASlow);
+      buffer.appendValue(state.multEMAFast);
+      buffer.appendValue(state.multEMASlow);
+      buffer.appendValues(state.regressionMACD.values);
+      buffer.appendValue(state.regressionMACD.sumXY);
+      buffer.appendValue(state.regressionMACD.sumY);
+      buffer.appendValue(state.regressionMACD.numSinceSums);
+      buffer.appendValue(state.signalMACD.average);
+      buffer.appendValue(state.signalMACD.numValues);
+      buffer.appendValue(state.lastBar.startMicros);
+      buffer.appendValue(state.lastBar.open);
+      buffer.appendValue(state.lastBar.high);
+      buffer.appendValue(state.lastBar.low);
+      buffer.appendValue(state.lastBar.close);
+      buffer.appendValue(state.lastBar.volume);
+      buffer.appendValue(state.lastBar.numTicks);
+      buffer.appendValue(state.lastDate);
+   }
+
+   buffer.appendValue((unsigned int)AnalyzerSnapshot::MAGIC);
+
+   // Replace the file with the buffer at once
+   if (!buffer.save(snapshotFileName))
+   {
+      throw exception("Could not write the analyzer snapshot");
+   }
+}
+
+//******************************************************************************
+// Function : setFromPortfolio
+// Process  : Check the portfolio is bounded
+//             Keep the portfolio's ranking slope periods
+//             Keep each stock's data file name, manifest index, and
+//                analyzer state
+// Notes    : Throws an exception unless the portfolio is bounded, or if a
+//             data file name is too long to save
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void AnalyzerSnapshot::setFromPortfolio(
+   const PortfolioAnalyzer& portfolioAnalyzer)
+{
+   const int NUMSTOCKS = portfolioAnalyzer.getNumStockAnalyzers();
+
+   // Check the portfolio is bounded
+   if (!portfolioAnalyzer.isHistoryBounded())
+   {
+      throw exception("Only a bounded portfolio has a snapshot");
+   }
+
+   // Keep the portfolio's ranking slope periods
+   this->periodsSlope = portfolioAnalyzer.getPeriodsSlope();
+
+   this->stockDataFileNames.resize(NUMSTOCKS);
+   this->manifestIndices.resize(NUMSTOCKS);
+   this->states.resize(NUMSTOCKS);
+
+   // Keep each stock's data file name, manifest index, and analyzer state
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(stockIndex);
+
+      this->stockDataFileNames[stockIndex] =
+         stockAnalyzer.getStockDataFileName();
+
+      if (this->stockDataFileNames[stockIndex].size() >
+          size_t(MAXFILENAMELENGTH))
+      {
+         throw exception("Stock data file name is too long for a snapshot");
+      }
+
+      this->manifestIndices[stockIndex] =
+         portfolioAnalyzer.getManifestIndexAtIndex(stockIndex);
+      stockAnalyzer.getState(this->states[stockIndex]);
+   }
+}
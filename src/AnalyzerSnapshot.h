@@ -0,0 +1,216 @@
+//******************************************************************************
+//
+// File Name:     AnalyzerSnapshot.h
+//
+// File Overview: Represents an AnalyzerSnapshot
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef AnalyzerSnapshot_h
+#define AnalyzerSnapshot_h
+
+#include <string>
+#include <vector>
+
+#include "PortfolioAnalyzer.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    AnalyzerSnapshot
+//
+// Overview: The state of every stock analyzer of a bounded portfolio, so a
+//             restarted process carries on updating where the last one
+//             stopped instead of parsing and analyzing every history again
+//             Each stock keeps its data file name, its manifest index, and
+//                its StockAnalyzerState
+//             Saved as one binary file, written to a temporary file and
+//                renamed over the last snapshot, so a crash while saving
+//                leaves the last snapshot whole, see
+//                Platform::writeFileAtomically
+//             A snapshot only loads into a build of the same price policy,
+//                its storage and accumulator sizes are in the header, and
+//                of the same VERSION
+//             PortfolioAnalyzer::addStocksFromSnapshot restores it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Version 2 adds the signal and last date
+//
+//******************************************************************************
+class AnalyzerSnapshot
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty snapshot
+   // Constraints : None
+   //***************************************************************************
+   AnalyzerSnapshot();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~AnalyzerSnapshot();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getManifestIndexAt
+   // Description : Retrieves the manifest index of the stock at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getManifestIndexAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : getNumStocks
+   // Description : Retrieve the number of stocks in the snapshot
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumStocks() const;
+
+   //***************************************************************************
+   // Function    : getPeriodsSlope
+   // Description : Retrieve the portfolio's ranking slope periods
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriodsSlope() const;
+
+   //***************************************************************************
+   // Function    : getStateAt
+   // Description : Retrieves the analyzer state of the stock at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const StockAnalyzerState& getStateAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : getStockDataFileNameAt
+   // Description : Retrieves the data file name of the stock at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const string& getStockDataFileNameAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : load
+   // Description : Reads a snapshot written by save
+   // Constraints : Throws an exception if the file can't be read, is not a
+   //                snapshot, or is of another version or price policy
+   //***************************************************************************
+   void load(const char* snapshotFileName);
+
+   //***************************************************************************
+   // Function    : save
+   // Description : Writes the snapshot as a binary file, replacing any file
+   //                of the name only once it is whole
+   // Constraints : Throws an exception if the file can't be written
+   //***************************************************************************
+   void save(const char* snapshotFileName) const;
+
+   //***************************************************************************
+   // Function    : setFromPortfolio
+   // Description : Keeps the state of every stock analyzer of the portfolio
+   // Constraints : Throws an exception unless the portfolio is bounded,
+   //                see PortfolioAnalyzer::setHistoryBounded
+   //***************************************************************************
+   void setFromPortfolio(const PortfolioAnalyzer& portfolioAnalyzer);
+
+   static const unsigned int MAGIC   = 0x50414E53; // "SNAP" little endian
+   static const unsigned int VERSION = 2;          // Of the file layout
+
+private:
+   int                        periodsSlope;       // Of the portfolio
+   vector<string>             stockDataFileNames; // Of each stock
+   vector<int>                manifestIndices;    // Of each stock
+   vector<StockAnalyzerState> states;             // Of each stock's analyzer
+}; // end class AnalyzerSnapshot
+
+//******************************************************************************
+// Function : getManifestIndexAt
+// Process  : The manifest index at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int AnalyzerSnapshot::getManifestIndexAt(const int index) const
+{
+   return this->manifestIndices.at(index);
+}
+
+//******************************************************************************
+// Function : getNumStocks
+// Process  : The number of states
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int AnalyzerSnapshot::getNumStocks() const
+{
+   return this->states.size();
+}
+
+//******************************************************************************
+// Function : getPeriodsSlope
+// Process  : Accessor for periodsSlope
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int AnalyzerSnapshot::getPeriodsSlope() const
+{
+   return this->periodsSlope;
+}
+
+//******************************************************************************
+// Function : getStateAt
+// Process  : The state at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const StockAnalyzerState& AnalyzerSnapshot::getStateAt(
+   const int index) const
+{
+   return this->states.at(index);
+}
+
+//******************************************************************************
+// Function : getStockDataFileNameAt
+// Process  : The stock data file name at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& AnalyzerSnapshot::getStockDataFileNameAt(
+   const int index) const
+{
+   return this->stockDataFileNames.at(index);
+}
+
+#endif // AnalyzerSnapshot_h
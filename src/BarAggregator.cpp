@@ -0,0 +1,94 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     BarAggregator.cpp
+//
+// File Overview: Represents a BarAggregator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <exception>
+
+#include "BarAggregator.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// None
+
+//******************************************************************************
+// Function : constructor
+// Process  : No bar in progress for any symbol
+// Notes    : Throws an exception if barMicros is not positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+BarAggregator::BarAggregator(
+   const int numSymbols,
+   const long long barMicros)
+   : barMicros(barMicros)
+{
+   Bar noBar = { 0, 0.0, 0.0, 0.0, 0.0, 0, 0 }; // Bar with no ticks
+
+   if (barMicros <= 0)
+   {
+      throw exception("Bar interval must be positive");
+   }
+
+   this->bars.assign(numSymbols, noBar);
+} // end BarAggregator::BarAggregator
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+BarAggregator::~BarAggregator()
+{
+} // end BarAggregator::~BarAggregator
+
+//******************************************************************************
+// Function : flushBar
+// Process  : Nothing to do without a bar in progress
+//             Complete the bar, the symbol has none in progress afterwards
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool BarAggregator::flushBar(
+   const int symbolIndex,
+   Bar& completedBar)
+{
+   Bar& bar = this->bars.at(symbolIndex); // Bar in progress
+
+   if (0 == bar.numTicks)
+   {
+      return false;
+   }
+
+   completedBar = bar;
+   bar.numTicks = 0;
+
+   return true;
+}
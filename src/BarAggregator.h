@@ -0,0 +1,221 @@
+//******************************************************************************
+//
+// File Name:     BarAggregator.h
+//
+// File Overview: Represents a BarAggregator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef BarAggregator_h
+#define BarAggregator_h
+
+#include <vector>
+
+#include "MarketData.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    BarAggregator
+//
+// Overview: Builds bars of a fixed interval from each symbol's ticks
+//             A bar completes when its symbol's first tick of a later
+//                interval arrives, or when it is flushed
+//             Ticks of a symbol must arrive in feed time order
+//             Symbols are indexed from 0, a shard uses its own indices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class BarAggregator
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Aggregates numSymbols symbols into bars of barMicros
+   // Constraints : barMicros must be positive
+   //***************************************************************************
+   BarAggregator(
+      const int numSymbols,
+      const long long barMicros);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~BarAggregator();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addTick
+   // Description : Adds the tick to its symbol's bar
+   //                Returns true, with the bar in completedBar, if the tick
+   //                starts a new interval and so completes the previous bar
+   // Constraints : Throws an out_of_range exception for an invalid
+   //                symbolIndex
+   //***************************************************************************
+   inline bool addTick(
+      const int symbolIndex,
+      const Tick& tick,
+      Bar& completedBar);
+
+   //***************************************************************************
+   // Function    : flushBar
+   // Description : Completes the symbol's bar in progress
+   //                Returns false if it has none
+   // Constraints : Throws an out_of_range exception for an invalid
+   //                symbolIndex
+   //***************************************************************************
+   bool flushBar(
+      const int symbolIndex,
+      Bar& completedBar);
+
+   //***************************************************************************
+   // Function    : getBarMicros
+   // Description : Accessor for barMicros
+   // Constraints : None
+   //***************************************************************************
+   inline long long getBarMicros() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the number of symbols aggregated
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+private:
+   //***************************************************************************
+   // Function    : startBar
+   // Description : Starts the bar with the tick
+   // Constraints : None
+   //***************************************************************************
+   inline void startBar(
+      const Tick& tick,
+      Bar& bar) const;
+
+   long long   barMicros; // Interval of each bar
+   vector<Bar> bars;      // Bar in progress of each symbol
+}; // end class BarAggregator
+
+//******************************************************************************
+// Function : addTick
+// Process  : Start the symbol's first bar with the tick
+//             A tick of a later interval completes the bar and starts the
+//                next one
+//             Otherwise update the high, low, close, and volume
+// Notes    : Intervals are aligned to feed time 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool BarAggregator::addTick(
+   const int symbolIndex,
+   const Tick& tick,
+   Bar& completedBar)
+{
+   Bar& bar = this->bars.at(symbolIndex); // Bar in progress
+
+   // Start the symbol's first bar with the tick
+   if (0 == bar.numTicks)
+   {
+      this->startBar(tick, bar);
+      return false;
+   }
+
+   // A tick of a later interval completes the bar and starts the next one
+   if (tick.timeMicros - bar.startMicros >= this->barMicros)
+   {
+      completedBar = bar;
+      this->startBar(tick, bar);
+      return true;
+   }
+
+   // Otherwise update the high, low, close, and volume
+   if (tick.price > bar.high)
+   {
+      bar.high = tick.price;
+   }
+
+   if (tick.price < bar.low)
+   {
+      bar.low = tick.price;
+   }
+
+   bar.close   = tick.price;
+   bar.volume += tick.volume;
+   ++bar.numTicks;
+
+   return false;
+}
+
+//******************************************************************************
+// Function : getBarMicros
+// Process  : Accessor for barMicros
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long BarAggregator::getBarMicros() const
+{
+   return this->barMicros;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Retrieve the number of symbols aggregated
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int BarAggregator::getNumSymbols() const
+{
+   return this->bars.size();
+}
+
+//******************************************************************************
+// Function : startBar
+// Process  : Align the start to the interval holding the tick
+//             Open, high, low, and close are the tick's price
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void BarAggregator::startBar(
+   const Tick& tick,
+   Bar& bar) const
+{
+   bar.startMicros = tick.timeMicros - tick.timeMicros % this->barMicros;
+   bar.open        = tick.price;
+   bar.high        = tick.price;
+   bar.low         = tick.price;
+   bar.close       = tick.price;
+   bar.volume      = tick.volume;
+   bar.numTicks    = 1;
+}
+
+#endif // BarAggregator_h
@@ -0,0 +1,100 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     BinaryBuffer.cpp
+//
+// File Overview: Represents a BinaryBuffer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <fstream>
+
+#include "BinaryBuffer.h"
+#include "Platform.h"
+
+//******************************************************************************
+// Function : constructor
+// Process  : No bytes, nothing read
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+BinaryBuffer::BinaryBuffer(const char* truncatedMessage)
+   : offset(0),
+     truncatedMessage(truncatedMessage)
+{
+} // end BinaryBuffer::BinaryBuffer
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+BinaryBuffer::~BinaryBuffer()
+{
+} // end BinaryBuffer::~BinaryBuffer
+
+//******************************************************************************
+// Function : load
+// Process  : Size the buffer to the file
+//             Read the whole file, and start reading from its first byte
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool BinaryBuffer::load(const char* fileName)
+{
+   ifstream fin(fileName, ios::binary); // File reader
+
+   if (!fin.good())
+   {
+      return false;
+   }
+
+   // Size the buffer to the file
+   fin.seekg(0, ios::end);
+   this->bytes.resize(size_t(fin.tellg()));
+   fin.seekg(0, ios::beg);
+   this->offset = 0;
+
+   // Read the whole file
+   return this->bytes.empty() ||
+          fin.read(&this->bytes[0], this->bytes.size());
+}
+
+//******************************************************************************
+// Function : save
+// Process  : Replace the file with the buffer at once
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool BinaryBuffer::save(const char* fileName) const
+{
+   return Platform::writeFileAtomically(
+      fileName, this->bytes.empty() ? NULL : &this->bytes[0],
+      this->bytes.size());
+}
@@ -0,0 +1,292 @@
+//******************************************************************************
+//
+// File Name:     BinaryBuffer.h
+//
+// File Overview: Represents a BinaryBuffer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef BinaryBuffer_h
+#define BinaryBuffer_h
+
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    BinaryBuffer
+//
+// Overview: The bytes of a whole binary file, laid out or read in order
+//             Values are stored as their bytes, in native byte order, little
+//             endian on every supported platform
+//             A list of values is an int count and that many values
+//             Reading past the end throws an exception with the message
+//             the buffer was constructed with
+//             Used by AnalyzerSnapshot and ShardResult
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class BinaryBuffer
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty buffer, reads past the end throw truncatedMessage
+   // Constraints : truncatedMessage must outlive the buffer
+   //***************************************************************************
+   explicit BinaryBuffer(const char* truncatedMessage);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~BinaryBuffer();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : appendBytes
+   // Description : Appends numBytes bytes
+   // Constraints : None
+   //***************************************************************************
+   inline void appendBytes(
+      const char* bytes,
+      const size_t numBytes);
+
+   //***************************************************************************
+   // Function    : appendValue
+   // Description : Appends the bytes of value
+   // Constraints : T must be trivially copyable
+   //***************************************************************************
+   template <class T>
+   inline void appendValue(const T& value);
+
+   //***************************************************************************
+   // Function    : appendValues
+   // Description : Appends the number of values, then the values
+   // Constraints : T must be trivially copyable
+   //***************************************************************************
+   template <class T>
+   inline void appendValues(const vector<T>& values);
+
+   //***************************************************************************
+   // Function    : getNumUnreadBytes
+   // Description : Retrieve the number of bytes not read yet
+   // Constraints : None
+   //***************************************************************************
+   inline size_t getNumUnreadBytes() const;
+
+   //***************************************************************************
+   // Function    : load
+   // Description : Replaces the buffer with the whole file, read from the
+   //                start
+   //                Returns false if it can't be read
+   // Constraints : None
+   //***************************************************************************
+   bool load(const char* fileName);
+
+   //***************************************************************************
+   // Function    : readBytes
+   // Description : Reads numBytes bytes into bytes
+   // Constraints : Throws an exception if the buffer ends first
+   //***************************************************************************
+   inline void readBytes(
+      const size_t numBytes,
+      string& bytes);
+
+   //***************************************************************************
+   // Function    : readValue
+   // Description : Reads the bytes of value
+   // Constraints : Throws an exception if the buffer ends first
+   //***************************************************************************
+   template <class T>
+   inline void readValue(T& value);
+
+   //***************************************************************************
+   // Function    : readValues
+   // Description : Reads the number of values, then the values
+   // Constraints : Throws an exception if the buffer ends first
+   //***************************************************************************
+   template <class T>
+   inline void readValues(vector<T>& values);
+
+   //***************************************************************************
+   // Function    : save
+   // Description : Replaces the file with the buffer at once, see
+   //                Platform::writeFileAtomically
+   //                Returns false if it can't be written
+   // Constraints : None
+   //***************************************************************************
+   bool save(const char* fileName) const;
+
+private:
+   vector<char> bytes;            // The whole file
+   size_t       offset;           // Next byte to read
+   const char*  truncatedMessage; // Thrown when a read passes the end
+}; // end class BinaryBuffer
+
+//******************************************************************************
+// Function : appendBytes
+// Process  : Append the bytes to the end
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void BinaryBuffer::appendBytes(
+   const char* bytes,
+   const size_t numBytes)
+{
+   this->bytes.insert(this->bytes.end(), bytes, bytes + numBytes);
+}
+
+//******************************************************************************
+// Function : appendValue
+// Process  : Append the bytes of value
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void BinaryBuffer::appendValue(const T& value)
+{
+   this->appendBytes((const char*)&value, sizeof(value));
+}
+
+//******************************************************************************
+// Function : appendValues
+// Process  : Append the number of values, then the values
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void BinaryBuffer::appendValues(const vector<T>& values)
+{
+   this->appendValue(int(values.size()));
+
+   if (!values.empty())
+   {
+      this->appendBytes((const char*)&values[0], values.size() * sizeof(T));
+   }
+}
+
+//******************************************************************************
+// Function : getNumUnreadBytes
+// Process  : Bytes after offset
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline size_t BinaryBuffer::getNumUnreadBytes() const
+{
+   return this->bytes.size() - this->offset;
+}
+
+//******************************************************************************
+// Function : readBytes
+// Process  : Copy numBytes bytes at offset, and move offset past them
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void BinaryBuffer::readBytes(
+   const size_t numBytes,
+   string& bytes)
+{
+   if (this->getNumUnreadBytes() < numBytes)
+   {
+      throw exception(this->truncatedMessage);
+   }
+
+   bytes.assign(&this->bytes[0] + this->offset, numBytes);
+   this->offset += numBytes;
+}
+
+//******************************************************************************
+// Function : readValue
+// Process  : Copy the bytes of value at offset, and move offset past them
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void BinaryBuffer::readValue(T& value)
+{
+   if (this->getNumUnreadBytes() < sizeof(value))
+   {
+      throw exception(this->truncatedMessage);
+   }
+
+   memcpy(&value, &this->bytes[this->offset], sizeof(value));
+   this->offset += sizeof(value);
+}
+
+//******************************************************************************
+// Function : readValues
+// Process  : Read the number of values, then the values
+// Notes    : The count is checked against the bytes left before the values
+//             are allocated
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void BinaryBuffer::readValues(vector<T>& values)
+{
+   int numValues = 0; // Values to read
+
+   this->readValue(numValues);
+
+   if (numValues < 0 ||
+       this->getNumUnreadBytes() / sizeof(T) < size_t(numValues))
+   {
+      throw exception(this->truncatedMessage);
+   }
+
+   values.resize(numValues);
+
+   if (numValues > 0)
+   {
+      memcpy(&values[0], &this->bytes[this->offset], numValues * sizeof(T));
+      this->offset += numValues * sizeof(T);
+   }
+}
+
+#endif // BinaryBuffer_h
@@ -0,0 +1,766 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     CompressedSeries.cpp
+//
+// File Overview: Represents a CompressedSeries
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include "CompressedSeries.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const unsigned char PRICECENTS = 0; // Block of whole cents deltas
+static const unsigned char PRICEXOR   = 1; // Block of XORed prices
+
+static const double MAXCENTSPRICE = 1.0e13; // Larger prices are XORed
+
+static const int DATEBITS    = 32; // Bits of the first date
+static const int ESCAPEBITS  = 64; // Bits of a large delta of delta
+static const int LEADINGBITS = 5;  // Bits of an XOR's leading zeros
+static const int LENGTHBITS  = 6;  // Bits of an XOR's length less one
+static const int MAXLEADING  = 31; // Leading zeros LEADINGBITS can hold
+static const int WIDTHBITS   = 7;  // Bits of a volume block's width
+
+//******************************************************************************
+//
+// Class:    BitWriter
+//
+// Overview: Appends bits to bytes, most significant first
+//             flush pads the last byte with zeros
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class BitWriter
+{
+public:
+   explicit BitWriter(vector<unsigned char>& bytes)
+      : buffer(0),
+        bytes(bytes),
+        numBits(0)
+   {
+   }
+
+   void flush()
+   {
+      if (this->numBits > 0)
+      {
+         this->bytes.push_back(
+            (unsigned char)(this->buffer << (8 - this->numBits)));
+         this->numBits = 0;
+      }
+   }
+
+   void write(
+      const unsigned long long value,
+      const int numValueBits)
+   {
+      if (numValueBits > 32)
+      {
+         this->write(value >> 32, numValueBits - 32);
+         this->write(value & 0xFFFFFFFFULL, 32);
+         return;
+      }
+
+      this->buffer = (this->buffer << numValueBits) |
+                     (value & ((1ULL << numValueBits) - 1));
+      this->numBits += numValueBits;
+
+      while (this->numBits >= 8)
+      {
+         this->numBits -= 8;
+         this->bytes.push_back((unsigned char)(this->buffer >> this->numBits));
+      }
+   }
+
+private:
+   unsigned long long     buffer;  // Bits not yet in a byte, and older ones
+   vector<unsigned char>& bytes;   // Appended to
+   int                    numBits; // Bits not yet in a byte
+}; // end class BitWriter
+
+//******************************************************************************
+//
+// Class:    BitReader
+//
+// Overview: Reads the bits of a BitWriter, most significant first
+//             Past the end every bit is 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class BitReader
+{
+public:
+   BitReader(
+      const unsigned char* first,
+      const unsigned char* end)
+      : buffer(0),
+        end(end),
+        next(first),
+        numBits(0)
+   {
+   }
+
+   inline unsigned long long read(const int numValueBits)
+   {
+      if (numValueBits > 32)
+      {
+         const unsigned long long HIGH = this->read(numValueBits - 32);
+
+         return (HIGH << 32) | this->read(32);
+      }
+
+      while (this->numBits < numValueBits)
+      {
+         this->buffer   = (this->buffer << 8) |
+                          ((this->next < this->end) ? *this->next++ : 0);
+         this->numBits += 8;
+      }
+
+      this->numBits -= numValueBits;
+
+      return (this->buffer >> this->numBits) & ((1ULL << numValueBits) - 1);
+   }
+
+private:
+   unsigned long long   buffer;  // Bits read from the bytes, and older ones
+   const unsigned char* end;     // Past the last byte
+   const unsigned char* next;    // Next byte to read
+   int                  numBits; // Bits in the buffer not yet read
+}; // end class BitReader
+
+//******************************************************************************
+// Function : countLeadingZeros, countTrailingZeros
+// Process  : Count the zero bits above the highest, below the lowest one bit
+// Notes    : value must not be 0
+//             Only the encoder counts, so a loop is fast enough
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static int countLeadingZeros(unsigned long long value)
+{
+   int numZeros = 0; // Counted so far
+
+   while (0 == (value & (1ULL << 63)))
+   {
+      value <<= 1;
+      ++numZeros;
+   }
+
+   return numZeros;
+}
+
+static int countTrailingZeros(unsigned long long value)
+{
+   int numZeros = 0; // Counted so far
+
+   while (0 == (value & 1))
+   {
+      value >>= 1;
+      ++numZeros;
+   }
+
+   return numZeros;
+}
+
+//******************************************************************************
+// Function : toBits, toPrice
+// Process  : The bits of the price, the price of the bits
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline unsigned long long toBits(const double price)
+{
+   unsigned long long bits; // Of the price
+
+   memcpy(&bits, &price, sizeof(bits));
+
+   return bits;
+}
+
+static inline double toPrice(const unsigned long long bits)
+{
+   double price; // Of the bits
+
+   memcpy(&price, &bits, sizeof(price));
+
+   return price;
+}
+
+//******************************************************************************
+// Function : readVarint, writeVarint
+// Process  : Seven bits per byte, lowest first, the high bit set on every
+//             byte but the last
+// Notes    : readVarint stops at the end
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline unsigned long long readVarint(
+   const unsigned char*& next,
+   const unsigned char* end)
+{
+   unsigned long long value = 0; // Bits read so far
+   int                shift = 0; // Of the next seven
+
+   while (next < end && shift < 64)
+   {
+      const unsigned char NEXTBYTE = *next++;
+
+      value |= (unsigned long long)(NEXTBYTE & 0x7F) << shift;
+
+      if (0 == (NEXTBYTE & 0x80))
+      {
+         break;
+      }
+
+      shift += 7;
+   }
+
+   return value;
+}
+
+static void writeVarint(
+   unsigned long long value,
+   vector<unsigned char>& bytes)
+{
+   while (value >= 0x80)
+   {
+      bytes.push_back((unsigned char)(value | 0x80));
+      value >>= 7;
+   }
+
+   bytes.push_back((unsigned char)value);
+}
+
+//******************************************************************************
+// Function : toZigzag, fromZigzag
+// Process  : 0, -1, 1, -2, 2, ... to 0, 1, 2, 3, 4, ... and back, so small
+//             differences of either sign take few bits
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline unsigned long long toZigzag(const long long value)
+{
+   return ((unsigned long long)value << 1) ^ (unsigned long long)(value >> 63);
+}
+
+static inline long long fromZigzag(const unsigned long long value)
+{
+   return (long long)((value >> 1) ^ (0ULL - (value & 1)));
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Empty
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CompressedSeries::CompressedSeries()
+{
+   this->reset(SERIESDATES, 0);
+} // end CompressedSeries::CompressedSeries
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CompressedSeries::~CompressedSeries()
+{
+} // end CompressedSeries::~CompressedSeries
+
+//******************************************************************************
+// Function : checkBlock
+// Process  : Check the type, then find the block's bytes
+// Notes    : Throws an exception unless the series is of the type
+//             Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const unsigned char* CompressedSeries::checkBlock(
+   const SeriesType type,
+   const int blockIndex,
+   const unsigned char*& blockEnd) const
+{
+   if (type != this->type)
+   {
+      throw exception("Compressed series holds something else");
+   }
+
+   if (blockIndex < 0 || blockIndex >= this->getNumBlocks())
+   {
+      throw out_of_range("Compressed series block is out of range");
+   }
+
+   blockEnd = this->bytes.data() + this->blockOffsets[blockIndex + 1];
+
+   return this->bytes.data() + this->blockOffsets[blockIndex];
+}
+
+//******************************************************************************
+// Function : compressDates
+// Process  : For each block
+//                The first date in DATEBITS bits
+//                Each next delta of delta, zigzagged, as
+//                   0                         for 0
+//                   10 and 7 bits             below 128
+//                   110 and 9 bits            below 512
+//                   1110 and 12 bits          below 4096
+//                   1111 and ESCAPEBITS bits  otherwise
+// Notes    : Consecutive trading days, or weeks, are a bit per date
+//             The delta before the first is 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CompressedSeries::compressDates(
+   const int* dates,
+   const int numDates)
+{
+   this->reset(SERIESDATES, numDates);
+
+   for (int blockIndex = 0; blockIndex < this->getNumBlocks(); ++blockIndex)
+   {
+      const int* blockDates = dates + blockIndex * BLOCKVALUES;
+      const int  BLOCKSIZE  = this->getBlockSize(blockIndex);
+      BitWriter  writer(this->bytes); // Of the block
+      long long  delta = 0;           // Of the previous date
+
+      writer.write((unsigned int)blockDates[0], DATEBITS);
+
+      for (int dateIndex = 1; dateIndex < BLOCKSIZE; ++dateIndex)
+      {
+         const long long          DELTA        =
+            (long long)blockDates[dateIndex] - blockDates[dateIndex - 1];
+         const unsigned long long DELTAOFDELTA = toZigzag(DELTA - delta);
+
+         if (0 == DELTAOFDELTA)
+         {
+            writer.write(0x0, 1);
+         }
+         else if (DELTAOFDELTA < (1ULL << 7))
+         {
+            writer.write(0x2, 2);
+            writer.write(DELTAOFDELTA, 7);
+         }
+         else if (DELTAOFDELTA < (1ULL << 9))
+         {
+            writer.write(0x6, 3);
+            writer.write(DELTAOFDELTA, 9);
+         }
+         else if (DELTAOFDELTA < (1ULL << 12))
+         {
+            writer.write(0xE, 4);
+            writer.write(DELTAOFDELTA, 12);
+         }
+         else
+         {
+            writer.write(0xF, 4);
+            writer.write(DELTAOFDELTA, ESCAPEBITS);
+         }
+
+         delta = DELTA;
+      }
+
+      writer.flush();
+      this->blockOffsets.push_back(this->bytes.size());
+   }
+}
+
+//******************************************************************************
+// Function : compressPrices
+// Process  : For each block
+//                If every price is whole cents, and round trips through
+//                   cents to the same bits
+//                   PRICECENTS, the first price in cents, then each
+//                   difference in cents, as zigzag varints
+//                Otherwise
+//                   PRICEXOR, the first price's 64 bits, then each price
+//                   XORed with the one before
+//                      0 if the same
+//                      10 and the changed bits, if they are within the
+//                         previous changed bits
+//                      11, the leading zeros, the length less one, and the
+//                         changed bits otherwise
+// Notes    : Both are lossless, cents are much smaller for quoted prices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CompressedSeries::compressPrices(
+   const double* prices,
+   const int numPrices)
+{
+   this->reset(SERIESPRICES, numPrices);
+
+   for (int blockIndex = 0; blockIndex < this->getNumBlocks(); ++blockIndex)
+   {
+      const double* blockPrices = prices + blockIndex * BLOCKVALUES;
+      const int     BLOCKSIZE   = this->getBlockSize(blockIndex);
+      bool          wholeCents  = true; // Every price?
+
+      // If every price is whole cents, and round trips
+      for (int priceIndex = 0; wholeCents && priceIndex < BLOCKSIZE;
+           ++priceIndex)
+      {
+         const double PRICE = blockPrices[priceIndex];
+
+         wholeCents = fabs(PRICE) < MAXCENTSPRICE &&
+                      toBits(double(llround(PRICE * 100.0)) / 100.0) ==
+                      toBits(PRICE);
+      }
+
+      if (wholeCents)
+      {
+         long long cents = 0; // Of the previous price
+
+         this->bytes.push_back(PRICECENTS);
+
+         for (int priceIndex = 0; priceIndex < BLOCKSIZE; ++priceIndex)
+         {
+            const long long CENTS = llround(blockPrices[priceIndex] * 100.0);
+
+            writeVarint(toZigzag(CENTS - cents), this->bytes);
+            cents = CENTS;
+         }
+      }
+      else
+      {
+         BitWriter          writer(this->bytes);      // Of the block
+         unsigned long long bits = toBits(blockPrices[0]); // Previous
+         int                leading  = -1; // Zeros above the changed bits,
+         int                trailing = 0;  // and below, -1 before any
+
+         this->bytes.push_back(PRICEXOR);
+         writer.write(bits, 64);
+
+         for (int priceIndex = 1; priceIndex < BLOCKSIZE; ++priceIndex)
+         {
+            const unsigned long long XOR =
+               toBits(blockPrices[priceIndex]) ^ bits;
+
+            bits ^= XOR;
+
+            if (0 == XOR)
+            {
+               writer.write(0x0, 1);
+               continue;
+            }
+
+            const int LEADING  = min(countLeadingZeros(XOR), MAXLEADING);
+            const int TRAILING = countTrailingZeros(XOR);
+
+            if (leading >= 0 && LEADING >= leading && TRAILING >= trailing)
+            {
+               // Within the previous changed bits
+               writer.write(0x2, 2);
+               writer.write(XOR >> trailing, 64 - leading - trailing);
+            }
+            else
+            {
+               const int LENGTH = 64 - LEADING - TRAILING; // Changed bits
+
+               writer.write(0x3, 2);
+               writer.write(LEADING, LEADINGBITS);
+               writer.write(LENGTH - 1, LENGTHBITS);
+               writer.write(XOR >> TRAILING, LENGTH);
+
+               leading  = LEADING;
+               trailing = TRAILING;
+            }
+         }
+
+         writer.flush();
+      }
+
+      this->blockOffsets.push_back(this->bytes.size());
+   }
+}
+
+//******************************************************************************
+// Function : compressVolumes
+// Process  : For each block
+//                The smallest volume, zigzagged, in 64 bits
+//                The width, the bits of the largest difference from it,
+//                   in WIDTHBITS bits
+//                Each volume's difference in width bits
+// Notes    : A block of equal volumes is just its header
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CompressedSeries::compressVolumes(
+   const long long* volumes,
+   const int numVolumes)
+{
+   this->reset(SERIESVOLUMES, numVolumes);
+
+   for (int blockIndex = 0; blockIndex < this->getNumBlocks(); ++blockIndex)
+   {
+      const long long* blockVolumes = volumes + blockIndex * BLOCKVALUES;
+      const int        BLOCKSIZE    = this->getBlockSize(blockIndex);
+      BitWriter        writer(this->bytes); // Of the block
+      long long        smallest = blockVolumes[0]; // Of the block
+      long long        largest  = blockVolumes[0];
+      int              width    = 0;               // Bits per difference
+
+      for (int volumeIndex = 1; volumeIndex < BLOCKSIZE; ++volumeIndex)
+      {
+         smallest = min(smallest, blockVolumes[volumeIndex]);
+         largest  = max(largest, blockVolumes[volumeIndex]);
+      }
+
+      while (width < 64 &&
+             ((unsigned long long)largest - smallest) >> width != 0)
+      {
+         ++width;
+      }
+
+      writer.write(toZigzag(smallest), 64);
+      writer.write(width, WIDTHBITS);
+
+      for (int volumeIndex = 0; volumeIndex < BLOCKSIZE; ++volumeIndex)
+      {
+         writer.write(
+            (unsigned long long)blockVolumes[volumeIndex] - smallest, width);
+      }
+
+      writer.flush();
+      this->blockOffsets.push_back(this->bytes.size());
+   }
+}
+
+//******************************************************************************
+// Function : decodeDateBlock
+// Process  : Read the first date, then each delta of delta by its prefix,
+//             see compressDates
+// Notes    : Throws an exception if the series holds something else
+//             Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int CompressedSeries::decodeDateBlock(
+   const int blockIndex,
+   int* dates) const
+{
+   const unsigned char* blockEnd = 0; // Of the block's bytes
+   const unsigned char* first    = this->checkBlock(
+      SERIESDATES, blockIndex, blockEnd);
+   const int            BLOCKSIZE = this->getBlockSize(blockIndex);
+   BitReader            reader(first, blockEnd);
+   long long            delta    = 0; // Of the previous date
+
+   dates[0] = (int)(unsigned int)reader.read(DATEBITS);
+
+   for (int dateIndex = 1; dateIndex < BLOCKSIZE; ++dateIndex)
+   {
+      if (0 != reader.read(1))
+      {
+         int numBits = ESCAPEBITS; // Of the delta of delta
+
+         if (0 == reader.read(1))
+         {
+            numBits = 7;
+         }
+         else if (0 == reader.read(1))
+         {
+            numBits = 9;
+         }
+         else if (0 == reader.read(1))
+         {
+            numBits = 12;
+         }
+
+         delta += fromZigzag(reader.read(numBits));
+      }
+
+      dates[dateIndex] = (int)(dates[dateIndex - 1] + delta);
+   }
+
+   return BLOCKSIZE;
+}
+
+//******************************************************************************
+// Function : decodePriceBlock
+// Process  : PRICECENTS: add each difference to the cents, the price is
+//                the cents over 100
+//             PRICEXOR: XOR each price's changed bits into the previous
+//                price's, see compressPrices
+// Notes    : Throws an exception if the series holds something else
+//             Throws an out_of_range exception for invalid index
+//             Dividing, not multiplying by 0.01, gives back the same bits
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int CompressedSeries::decodePriceBlock(
+   const int blockIndex,
+   double* prices) const
+{
+   const unsigned char* blockEnd = 0; // Of the block's bytes
+   const unsigned char* next     = this->checkBlock(
+      SERIESPRICES, blockIndex, blockEnd);
+   const int            BLOCKSIZE = this->getBlockSize(blockIndex);
+
+   if (PRICECENTS == *next++)
+   {
+      long long cents = 0; // Of the previous price
+
+      for (int priceIndex = 0; priceIndex < BLOCKSIZE; ++priceIndex)
+      {
+         // A difference below 64 cents is a single byte
+         if (next < blockEnd && *next < 0x80)
+         {
+            cents += fromZigzag(*next++);
+         }
+         else
+         {
+            cents += fromZigzag(readVarint(next, blockEnd));
+         }
+
+         prices[priceIndex] = double(cents) / 100.0;
+      }
+   }
+   else
+   {
+      BitReader          reader(next, blockEnd);
+      unsigned long long bits     = reader.read(64); // Previous price's
+      int                leading  = 0;  // Zeros above the changed bits,
+      int                trailing = 0;  // and below
+
+      prices[0] = toPrice(bits);
+
+      for (int priceIndex = 1; priceIndex < BLOCKSIZE; ++priceIndex)
+      {
+         if (0 != reader.read(1))
+         {
+            if (0 != reader.read(1))
+            {
+               leading  = (int)reader.read(LEADINGBITS);
+               trailing = 64 - leading - 1 - (int)reader.read(LENGTHBITS);
+            }
+
+            bits ^= reader.read(64 - leading - trailing) << trailing;
+         }
+
+         prices[priceIndex] = toPrice(bits);
+      }
+   }
+
+   return BLOCKSIZE;
+}
+
+//******************************************************************************
+// Function : decodeVolumeBlock
+// Process  : Read the smallest volume and the width, then add each
+//             difference to the smallest
+// Notes    : Throws an exception if the series holds something else
+//             Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int CompressedSeries::decodeVolumeBlock(
+   const int blockIndex,
+   long long* volumes) const
+{
+   const unsigned char* blockEnd = 0; // Of the block's bytes
+   const unsigned char* first    = this->checkBlock(
+      SERIESVOLUMES, blockIndex, blockEnd);
+   const int            BLOCKSIZE = this->getBlockSize(blockIndex);
+   BitReader            reader(first, blockEnd);
+   const long long      SMALLEST  = fromZigzag(reader.read(64));
+   const int            WIDTH     = (int)reader.read(WIDTHBITS);
+
+   for (int volumeIndex = 0; volumeIndex < BLOCKSIZE; ++volumeIndex)
+   {
+      volumes[volumeIndex] =
+         (long long)((unsigned long long)SMALLEST + reader.read(WIDTH));
+   }
+
+   return BLOCKSIZE;
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : No blocks, the first starts at 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CompressedSeries::reset(
+   const SeriesType type,
+   const int numValues)
+{
+   this->type      = type;
+   this->numValues = max(numValues, 0);
+   this->bytes.clear();
+   this->blockOffsets.assign(1, 0);
+}
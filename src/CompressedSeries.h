@@ -0,0 +1,265 @@
+//******************************************************************************
+//
+// File Name:     CompressedSeries.h
+//
+// File Overview: Represents a CompressedSeries
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef CompressedSeries_h
+#define CompressedSeries_h
+
+#include <algorithm>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    CompressedSeries
+//
+// Overview: One column of a price history, dates, prices, or volumes,
+//             compressed losslessly in blocks of BLOCKVALUES values
+//             Each block is decoded on its own, so a kernel can stream a
+//                long history through a buffer of one block
+//             Dates, day numbers of a TradingCalendar, are delta of delta
+//                encoded: a trading day after a trading day is one bit,
+//                other gaps a few bits, with Gorilla's variable length codes
+//             Prices are delta encoded as whole cents, a zigzag varint per
+//                price, when every price of the block is whole cents
+//                Otherwise each price is XORed with the one before,
+//                Gorilla style, keeping only the bits that changed
+//             Volumes are bit packed, each the difference from the block's
+//                smallest volume in the bits of the largest difference
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class CompressedSeries
+{
+public:
+   // What the series holds
+   enum SeriesType
+   {
+      SERIESDATES,
+      SERIESPRICES,
+      SERIESVOLUMES
+   };
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : An empty series of dates
+   // Constraints : None
+   //***************************************************************************
+   CompressedSeries();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~CompressedSeries();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : compressDates
+   // Description : Holds the dates, oldest first, replacing the series
+   // Constraints : None
+   //***************************************************************************
+   void compressDates(
+      const int* dates,
+      const int numDates);
+
+   //***************************************************************************
+   // Function    : compressPrices
+   // Description : Holds the prices, oldest first, replacing the series
+   //                Decoding gives back the same bits, whatever the prices
+   // Constraints : None
+   //***************************************************************************
+   void compressPrices(
+      const double* prices,
+      const int numPrices);
+
+   //***************************************************************************
+   // Function    : compressVolumes
+   // Description : Holds the volumes, oldest first, replacing the series
+   // Constraints : None
+   //***************************************************************************
+   void compressVolumes(
+      const long long* volumes,
+      const int numVolumes);
+
+   //***************************************************************************
+   // Function    : decodeDateBlock, decodePriceBlock, decodeVolumeBlock
+   // Description : Decodes the block at the index into values, which must
+   //                hold getBlockSize of the block
+   //                Returns the number of values decoded
+   // Constraints : Throw an exception if the series holds something else
+   //                Throw an out_of_range exception for invalid index
+   //***************************************************************************
+   int decodeDateBlock(
+      const int blockIndex,
+      int* dates) const;
+   int decodePriceBlock(
+      const int blockIndex,
+      double* prices) const;
+   int decodeVolumeBlock(
+      const int blockIndex,
+      long long* volumes) const;
+
+   //***************************************************************************
+   // Function    : getBlockSize
+   // Description : Retrieves the number of values in the block at the index,
+   //                BLOCKVALUES but for the last block
+   // Constraints : None
+   //***************************************************************************
+   inline int getBlockSize(const int blockIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumBlocks
+   // Description : Retrieves the number of blocks
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumBlocks() const;
+
+   //***************************************************************************
+   // Function    : getNumBytes
+   // Description : Retrieves the bytes the series takes, blocks and offsets
+   // Constraints : None
+   //***************************************************************************
+   inline size_t getNumBytes() const;
+
+   //***************************************************************************
+   // Function    : getNumValues
+   // Description : Retrieves the number of values held
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumValues() const;
+
+   //***************************************************************************
+   // Function    : getType
+   // Description : Accessor for type
+   // Constraints : None
+   //***************************************************************************
+   inline SeriesType getType() const;
+
+   static const int BLOCKVALUES = 1024; // Values in a full block
+
+private:
+   //***************************************************************************
+   // Function    : checkBlock
+   // Description : Retrieves the first byte of the block at the index, and
+   //                the byte after its last
+   // Constraints : Throws an exception unless the series is of the type
+   //                Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   const unsigned char* checkBlock(
+      const SeriesType type,
+      const int blockIndex,
+      const unsigned char*& blockEnd) const;
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Empties the series, to hold numValues of the type
+   // Constraints : None
+   //***************************************************************************
+   void reset(
+      const SeriesType type,
+      const int numValues);
+
+   vector<unsigned int>  blockOffsets; // Of each block in bytes, then the
+                                       // end of the last
+   vector<unsigned char> bytes;        // Every block, each byte aligned
+   int                   numValues;    // Values held
+   SeriesType            type;         // What they are
+}; // end class CompressedSeries
+
+//******************************************************************************
+// Function : getBlockSize
+// Process  : Full blocks, then what is left
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CompressedSeries::getBlockSize(const int blockIndex) const
+{
+   return min(CompressedSeries::BLOCKVALUES,
+              this->numValues - blockIndex * CompressedSeries::BLOCKVALUES);
+}
+
+//******************************************************************************
+// Function : getNumBlocks
+// Process  : Round the values up to whole blocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CompressedSeries::getNumBlocks() const
+{
+   return (this->numValues + CompressedSeries::BLOCKVALUES - 1) /
+          CompressedSeries::BLOCKVALUES;
+}
+
+//******************************************************************************
+// Function : getNumBytes
+// Process  : The blocks and their offsets
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline size_t CompressedSeries::getNumBytes() const
+{
+   return this->bytes.size() +
+          this->blockOffsets.size() * sizeof(this->blockOffsets[0]);
+}
+
+//******************************************************************************
+// Function : getNumValues
+// Process  : Accessor for numValues
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CompressedSeries::getNumValues() const
+{
+   return this->numValues;
+}
+
+//******************************************************************************
+// Function : getType
+// Process  : Accessor for type
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline CompressedSeries::SeriesType CompressedSeries::getType() const
+{
+   return this->type;
+}
+
+#endif // CompressedSeries_h
@@ -0,0 +1,708 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     CorrelationMatrix.cpp
+//
+// File Overview: Represents a CorrelationMatrix
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses SimdVector
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "CorrelationMatrix.h"
+#include "Metrics.h"
+#include "SimdVector.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const int PADFLOATS   = 8; // Rows padded for any SIMD width
+static const int TILEROWS    = 4; // Rows of a kernel tile
+static const int TILECOLUMNS = 3; // Columns of a kernel tile
+
+//******************************************************************************
+// Function : multiplyTile
+// Process  : Keep a vector sum for each of the TILEROWS x TILECOLUMNS pairs
+//                of rows, 12 sums and 4 values fill the 16 SIMD registers
+//             Load a slice of each second row, then of each first row in
+//                turn, multiplying it by every second row
+//             Add the lanes of each sum to its pair's sum
+// Notes    : numValues must be a multiple of VECTORFLOATS
+//             Rows of first and second are rowFloats apart, sums are
+//             BLOCKSYMBOLS apart
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline void multiplyTile(
+   const float* first,
+   const float* second,
+   const int rowFloats,
+   const int numValues,
+   float* sums)
+{
+   FloatVector sum00 = zeroVector(), sum01 = zeroVector(); // Row 0
+   FloatVector sum02 = zeroVector();
+   FloatVector sum10 = zeroVector(), sum11 = zeroVector(); // Row 1
+   FloatVector sum12 = zeroVector();
+   FloatVector sum20 = zeroVector(), sum21 = zeroVector(); // Row 2
+   FloatVector sum22 = zeroVector();
+   FloatVector sum30 = zeroVector(), sum31 = zeroVector(); // Row 3
+   FloatVector sum32 = zeroVector();
+
+   const float* first0  = first;
+   const float* first1  = first + rowFloats;
+   const float* first2  = first + 2 * rowFloats;
+   const float* first3  = first + 3 * rowFloats;
+   const float* second0 = second;
+   const float* second1 = second + rowFloats;
+   const float* second2 = second + 2 * rowFloats;
+
+   for (int valueIndex = 0; valueIndex < numValues; 
+        valueIndex += VECTORFLOATS)
+   {
+      const FloatVector SECOND0 = loadVector(second0 + valueIndex);
+      const FloatVector SECOND1 = loadVector(second1 + valueIndex);
+      const FloatVector SECOND2 = loadVector(second2 + valueIndex);
+      FloatVector       firstValues;                // One row's
+
+      firstValues = loadVector(first0 + valueIndex);
+      sum00 = multiplyAdd(firstValues, SECOND0, sum00);
+      sum01 = multiplyAdd(firstValues, SECOND1, sum01);
+      sum02 = multiplyAdd(firstValues, SECOND2, sum02);
+
+      firstValues = loadVector(first1 + valueIndex);
+      sum10 = multiplyAdd(firstValues, SECOND0, sum10);
+      sum11 = multiplyAdd(firstValues, SECOND1, sum11);
+      sum12 = multiplyAdd(firstValues, SECOND2, sum12);
+
+      firstValues = loadVector(first2 + valueIndex);
+      sum20 = multiplyAdd(firstValues, SECOND0, sum20);
+      sum21 = multiplyAdd(firstValues, SECOND1, sum21);
+      sum22 = multiplyAdd(firstValues, SECOND2, sum22);
+
+      firstValues = loadVector(first3 + valueIndex);
+      sum30 = multiplyAdd(firstValues, SECOND0, sum30);
+      sum31 = multiplyAdd(firstValues, SECOND1, sum31);
+      sum32 = multiplyAdd(firstValues, SECOND2, sum32);
+   }
+
+   float* sums1 = sums + CorrelationMatrix::BLOCKSYMBOLS;     // Row 1's
+   float* sums2 = sums + 2 * CorrelationMatrix::BLOCKSYMBOLS; // Row 2's
+   float* sums3 = sums + 3 * CorrelationMatrix::BLOCKSYMBOLS; // Row 3's
+
+   sums[0]  += sumVector(sum00);
+   sums[1]  += sumVector(sum01);
+   sums[2]  += sumVector(sum02);
+   sums1[0] += sumVector(sum10);
+   sums1[1] += sumVector(sum11);
+   sums1[2] += sumVector(sum12);
+   sums2[0] += sumVector(sum20);
+   sums2[1] += sumVector(sum21);
+   sums2[2] += sumVector(sum22);
+   sums3[0] += sumVector(sum30);
+   sums3[1] += sumVector(sum31);
+   sums3[2] += sumVector(sum32);
+}
+
+//******************************************************************************
+// Function : multiplyBlock
+// Process  : Add the products of every row of the first block with every 
+//                row of the second over numValues values, a tile at a time
+// Notes    : Both blocks are BLOCKSYMBOLS rows of rowFloats apart
+//             sums is BLOCKSYMBOLS x BLOCKSYMBOLS, first block's rows first
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void multiplyBlock(
+   const float* first,
+   const float* second,
+   const int rowFloats,
+   const int numValues,
+   float* sums)
+{
+   for (int row = 0; row < CorrelationMatrix::BLOCKSYMBOLS; row += TILEROWS)
+   {
+      for (int column = 0; column < CorrelationMatrix::BLOCKSYMBOLS; 
+           column += TILECOLUMNS)
+      {
+         multiplyTile(
+            first + row * rowFloats,
+            second + column * rowFloats,
+            rowFloats,
+            numValues,
+            sums + row * CorrelationMatrix::BLOCKSYMBOLS + column);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : isMoreCorrelated
+// Process  : Higher correlation first, then lower symbol index
+// Notes    : A total order, so the neighbours kept don't depend on the
+//             order the threads offer them
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool isMoreCorrelated(
+   const CorrelationMatrix::Neighbour& first,
+   const CorrelationMatrix::Neighbour& second)
+{
+   return first.correlation > second.correlation ||
+          (first.correlation == second.correlation && 
+           first.symbolIndex < second.symbolIndex);
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : No symbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CorrelationMatrix::CorrelationMatrix()
+   : nextBlockPair(0),
+     numFlops(0.0),
+     numNeighbours(0),
+     numPaddedReturns(0),
+     numPaddedSymbols(0),
+     numReturns(0),
+     numSymbols(0)
+{
+} // end CorrelationMatrix::CorrelationMatrix
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CorrelationMatrix::~CorrelationMatrix()
+{
+} // end CorrelationMatrix::~CorrelationMatrix
+
+//******************************************************************************
+// Function : calculate
+// Process  : List the block pairs on or above the diagonal, a block's pairs
+//                together so its rows stay cached, and count their flops
+//             Empty each thread's neighbour lists, and the matrix if kept
+//             Calculate the block pairs on the threads, or this thread
+//             Merge each symbol's neighbours from every thread
+// Notes    : Timed by Metrics
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::calculate(
+   const int numNeighbours,
+   const bool keepMatrix,
+   const int numThreads)
+{
+   METRICS_TIMER(PHASECORRELATE);
+
+   const int      NUMBLOCKS  = this->numPaddedSymbols / 
+                               CorrelationMatrix::BLOCKSYMBOLS;
+   const int      NUMTHREADS = max(1, 0 == numThreads ? 
+                     int(thread::hardware_concurrency()) : numThreads);
+   const double   BLOCKFLOPS = 2.0 * CorrelationMatrix::BLOCKSYMBOLS * 
+                               CorrelationMatrix::BLOCKSYMBOLS * 
+                               this->numPaddedReturns; // One product
+   vector<thread> workers;                             // Beyond this thread
+
+   // List the block pairs on or above the diagonal, and count their flops
+   this->blockPairs.clear();
+   this->numFlops = 0.0;
+
+   for (int block = 0; block < NUMBLOCKS; ++block)
+   {
+      for (int otherBlock = block; otherBlock < NUMBLOCKS; ++otherBlock)
+      {
+         this->blockPairs.push_back(block);
+         this->blockPairs.push_back(otherBlock);
+
+         // Masked pairs also take the squared returns by the other's mask
+         this->numFlops += BLOCKFLOPS * 
+            (this->completeBlocks[block] && this->completeBlocks[otherBlock] ?
+             1 : 3);
+      }
+   }
+
+   // Empty each thread's neighbour lists, and the matrix if kept
+   this->numNeighbours = max(0, numNeighbours);
+   this->threadLists.resize(NUMTHREADS);
+
+   for (int threadIndex = 0; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      NeighbourLists& lists = this->threadLists[threadIndex];
+
+      lists.neighbours.resize(size_t(this->numSymbols) * this->numNeighbours);
+      lists.numKept.assign(this->numSymbols, 0);
+      lists.worstIndices.assign(this->numSymbols, 0);
+   }
+
+   this->correlations.clear();
+
+   if (keepMatrix)
+   {
+      this->correlations.assign(
+         size_t(this->numSymbols) * this->numSymbols, 0.0f);
+
+      for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+      {
+         this->correlations[size_t(symbolIndex) * this->numSymbols + 
+                            symbolIndex] = 
+            this->usableSymbols[symbolIndex] ? 1.0f : 0.0f;
+      }
+   }
+
+   // Calculate the block pairs on the threads, or this thread
+   this->nextBlockPair.store(0);
+
+   for (int threadIndex = 1; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      workers.push_back(thread(
+         &CorrelationMatrix::calculateBlocks, this, threadIndex));
+   }
+
+   this->calculateBlocks(0);
+
+   for (size_t workerIndex = 0; workerIndex < workers.size(); ++workerIndex)
+   {
+      workers[workerIndex].join();
+   }
+
+   // Merge each symbol's neighbours from every thread
+   vector<Neighbour> candidates; // Of one symbol, from every thread
+
+   this->neighbours.resize(size_t(this->numSymbols) * this->numNeighbours);
+   this->numKept.assign(this->numSymbols, 0);
+
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      candidates.clear();
+
+      for (int threadIndex = 0; threadIndex < NUMTHREADS; ++threadIndex)
+      {
+         const NeighbourLists& lists = this->threadLists[threadIndex];
+         const Neighbour*      kept  = &lists.neighbours[
+                                size_t(symbolIndex) * this->numNeighbours];
+
+         candidates.insert(
+            candidates.end(), kept, kept + lists.numKept[symbolIndex]);
+      }
+
+      sort(candidates.begin(), candidates.end(), isMoreCorrelated);
+
+      this->numKept[symbolIndex] = 
+         min(int(candidates.size()), this->numNeighbours);
+      copy(candidates.begin(), 
+           candidates.begin() + this->numKept[symbolIndex],
+           this->neighbours.begin() + 
+              size_t(symbolIndex) * this->numNeighbours);
+   }
+}
+
+//******************************************************************************
+// Function : calculateBlockPair
+// Process  : Zero the sums, the masked sums too unless both blocks are
+//                complete
+//             Add each BLOCKRETURNS slice of the products of the normalized
+//                returns, and when masked, of each block's squared returns
+//                with the other's mask
+//             Correlate each pair, the diagonal block only above it, 
+//                dividing by the lengths over shared returns when masked
+//             Keep it in the matrix, and offer it to both symbols' lists
+// Notes    : Complete blocks' rows have unit length, or are all 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::calculateBlockPair(
+   const int block,
+   const int otherBlock,
+   NeighbourLists& lists,
+   float* sums)
+{
+   static const int BLOCKSUMS = CorrelationMatrix::BLOCKSYMBOLS * 
+                                CorrelationMatrix::BLOCKSYMBOLS;
+
+   const int    FIRST        = block * CorrelationMatrix::BLOCKSYMBOLS;
+   const int    OTHERFIRST   = otherBlock * CorrelationMatrix::BLOCKSYMBOLS;
+   const bool   MASKED       = !(this->completeBlocks[block] && 
+                                 this->completeBlocks[otherBlock]);
+   const size_t ROWS         = size_t(FIRST) * this->numPaddedReturns;
+   const size_t OTHERROWS    = size_t(OTHERFIRST) * this->numPaddedReturns;
+   float*       products     = sums;                 // Of normalized returns
+   float*       lengths      = sums + BLOCKSUMS;     // First's, shared
+   float*       otherLengths = sums + 2 * BLOCKSUMS; // Other's, shared
+
+   // Zero the sums
+   fill(sums, sums + (MASKED ? 3 : 1) * BLOCKSUMS, 0.0f);
+
+   // Add each slice of the products
+   for (int firstReturn = 0; firstReturn < this->numPaddedReturns; 
+        firstReturn += CorrelationMatrix::BLOCKRETURNS)
+   {
+      const int NUMVALUES = min(int(CorrelationMatrix::BLOCKRETURNS), 
+                                this->numPaddedReturns - firstReturn);
+
+      multiplyBlock(
+         &this->returns[ROWS + firstReturn],
+         &this->returns[OTHERROWS + firstReturn],
+         this->numPaddedReturns, NUMVALUES, products);
+
+      if (MASKED)
+      {
+         multiplyBlock(
+            &this->squaredReturns[ROWS + firstReturn],
+            &this->masks[OTHERROWS + firstReturn],
+            this->numPaddedReturns, NUMVALUES, lengths);
+         multiplyBlock(
+            &this->masks[ROWS + firstReturn],
+            &this->squaredReturns[OTHERROWS + firstReturn],
+            this->numPaddedReturns, NUMVALUES, otherLengths);
+      }
+   }
+
+   // Correlate each pair
+   for (int row = 0; row < CorrelationMatrix::BLOCKSYMBOLS; ++row)
+   {
+      const int SYMBOL = FIRST + row; // Of the first block
+
+      if (SYMBOL >= this->numSymbols || !this->usableSymbols[SYMBOL])
+      {
+         continue;
+      }
+
+      for (int column = (block == otherBlock ? row + 1 : 0); 
+           column < CorrelationMatrix::BLOCKSYMBOLS; 
+           ++column)
+      {
+         const int SUM   = row * CorrelationMatrix::BLOCKSYMBOLS + column;
+         const int OTHER = OTHERFIRST + column; // Of the other block
+         float     correlation = products[SUM];
+
+         if (OTHER >= this->numSymbols || !this->usableSymbols[OTHER])
+         {
+            continue;
+         }
+
+         if (MASKED)
+         {
+            const float SHAREDLENGTHS = lengths[SUM] * otherLengths[SUM];
+
+            correlation = (SHAREDLENGTHS > 0.0f) ? 
+               correlation / sqrt(SHAREDLENGTHS) : 0.0f;
+         }
+
+         correlation = max(-1.0f, min(1.0f, correlation));
+
+         // Keep it in the matrix, and offer it to both symbols' lists
+         if (!this->correlations.empty())
+         {
+            this->correlations[size_t(SYMBOL) * this->numSymbols + OTHER] =
+               correlation;
+            this->correlations[size_t(OTHER) * this->numSymbols + SYMBOL] =
+               correlation;
+         }
+
+         this->offerNeighbour(lists, SYMBOL, OTHER, correlation);
+         this->offerNeighbour(lists, OTHER, SYMBOL, correlation);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : calculateBlocks
+// Process  : Take the next block pair until none remain
+//             Calculate it into the thread's lists
+// Notes    : Worker thread entry point, one sums buffer per thread
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::calculateBlocks(const int threadIndex)
+{
+   vector<float> sums(3 * CorrelationMatrix::BLOCKSYMBOLS * 
+                      CorrelationMatrix::BLOCKSYMBOLS); // Of a block pair
+   const int     NUMBLOCKPAIRS = this->blockPairs.size() / 2;
+
+   for (int blockPair = this->nextBlockPair.fetch_add(1); 
+        blockPair < NUMBLOCKPAIRS; 
+        blockPair = this->nextBlockPair.fetch_add(1))
+   {
+      this->calculateBlockPair(
+         this->blockPairs[2 * blockPair],
+         this->blockPairs[2 * blockPair + 1],
+         this->threadLists[threadIndex],
+         &sums[0]);
+   }
+}
+
+//******************************************************************************
+// Function : getCorrelationAt
+// Process  : Check the matrix was kept and the indices
+//             Retrieve the pair's correlation
+// Notes    : Throws an exception if the matrix wasn't kept
+//             Throws an out_of_range exception for invalid indices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+float CorrelationMatrix::getCorrelationAt(
+   const int symbolIndex,
+   const int otherSymbolIndex) const
+{
+   if (this->correlations.empty() && this->numSymbols > 0)
+   {
+      throw exception("The correlation matrix was not kept");
+   }
+
+   if (symbolIndex < 0 || symbolIndex >= this->numSymbols ||
+       otherSymbolIndex < 0 || otherSymbolIndex >= this->numSymbols)
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   return this->correlations[
+      size_t(symbolIndex) * this->numSymbols + otherSymbolIndex];
+}
+
+//******************************************************************************
+// Function : getNeighbours
+// Process  : Copy the symbol's merged neighbours
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::getNeighbours(
+   const int symbolIndex,
+   vector<Neighbour>& neighbours) const
+{
+   const size_t FIRST = size_t(symbolIndex) * this->numNeighbours;
+
+   neighbours.assign(
+      this->neighbours.begin() + FIRST,
+      this->neighbours.begin() + FIRST + this->numKept.at(symbolIndex));
+}
+
+//******************************************************************************
+// Function : offerNeighbour
+// Process  : Fill the symbol's free slots, finding the worst once full
+//             Otherwise replace the worst if the neighbour is better, and 
+//                find the new worst
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::offerNeighbour(
+   NeighbourLists& lists,
+   const int symbolIndex,
+   const int neighbourIndex,
+   const float correlation)
+{
+   Neighbour* kept     = &lists.neighbours[ // Slots of the symbol
+                            size_t(symbolIndex) * this->numNeighbours];
+   int&       numKept  = lists.numKept[symbolIndex];
+   int&       worst    = lists.worstIndices[symbolIndex];
+   Neighbour  offered  = { neighbourIndex, correlation };
+
+   if (numKept < this->numNeighbours)
+   {
+      kept[numKept++] = offered;
+   }
+   else if (this->numNeighbours > 0 && 
+            correlation >= kept[worst].correlation &&
+            isMoreCorrelated(offered, kept[worst]))
+   {
+      kept[worst] = offered;
+   }
+   else
+   {
+      return;
+   }
+
+   // Find the worst once full
+   if (numKept == this->numNeighbours)
+   {
+      worst = 0;
+
+      for (int slot = 1; slot < numKept; ++slot)
+      {
+         if (isMoreCorrelated(kept[worst], kept[slot]))
+         {
+            worst = slot;
+         }
+      }
+   }
+}
+
+//******************************************************************************
+// Function : setReturns
+// Process  : Size the rows, padded, every return missing
+//             Take each symbol's return on each calendar date it and the
+//                previous date have prices
+//             Normalize each symbol's returns to zero mean and unit length,
+//                a symbol with fewer than two returns, or no variance, is
+//                all 0 and unusable
+//             Square the normalized returns
+//             A block is complete if none of its symbols misses a return
+// Notes    : Sums in double, stores in float
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CorrelationMatrix::setReturns(const TradingCalendar& calendar)
+{
+   const int NUMDATES = calendar.getNumDates();
+
+   // Size the rows, padded, every return missing
+   this->numSymbols       = calendar.getNumSymbols();
+   this->numReturns       = max(0, NUMDATES - 1);
+   this->numPaddedReturns = (this->numReturns + PADFLOATS - 1) / PADFLOATS * 
+                            PADFLOATS;
+   this->numPaddedSymbols = 
+      (this->numSymbols + CorrelationMatrix::BLOCKSYMBOLS - 1) / 
+      CorrelationMatrix::BLOCKSYMBOLS * CorrelationMatrix::BLOCKSYMBOLS;
+
+   const size_t NUMVALUES = size_t(this->numPaddedSymbols) * 
+                            this->numPaddedReturns; // Of each matrix
+
+   this->returns.assign(NUMVALUES, 0.0f);
+   this->masks.assign(NUMVALUES, 0.0f);
+   this->squaredReturns.assign(NUMVALUES, 0.0f);
+   this->usableSymbols.assign(this->numSymbols, 0);
+   this->completeBlocks.assign(
+      this->numPaddedSymbols / CorrelationMatrix::BLOCKSYMBOLS, 1);
+   this->correlations.clear();
+   this->neighbours.clear();
+   this->numKept.assign(this->numSymbols, 0);
+   this->numNeighbours = 0;
+   this->numFlops      = 0.0;
+
+   // Take each symbol's return where it has prices on both dates
+   for (int dateIndex = 1; dateIndex < NUMDATES; ++dateIndex)
+   {
+      const double*        PRICES         = calendar.getPriceRow(dateIndex);
+      const double*        PREVIOUSPRICES = calendar.getPriceRow(dateIndex - 1);
+      const unsigned char* VALID          = calendar.getValidRow(dateIndex);
+      const unsigned char* PREVIOUSVALID  = 
+         calendar.getValidRow(dateIndex - 1);
+
+      for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+      {
+         if (VALID[symbolIndex] && PREVIOUSVALID[symbolIndex] && 
+             0.0 != PREVIOUSPRICES[symbolIndex])
+         {
+            const size_t VALUE = size_t(symbolIndex) * this->numPaddedReturns +
+                                 dateIndex - 1;
+
+            this->returns[VALUE] = float(
+               PRICES[symbolIndex] / PREVIOUSPRICES[symbolIndex] - 1.0);
+            this->masks[VALUE]   = 1.0f;
+         }
+      }
+   }
+
+   // Normalize each symbol's returns to zero mean and unit length
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      float*       row      = &this->returns[
+                                 size_t(symbolIndex) * this->numPaddedReturns];
+      const float* mask     = &this->masks[
+                                 size_t(symbolIndex) * this->numPaddedReturns];
+      float*       squared  = &this->squaredReturns[
+                                 size_t(symbolIndex) * this->numPaddedReturns];
+      double       sum      = 0.0; // Of its returns
+      double       sumSquares = 0.0; // Of its centered returns
+      int          count    = 0;   // Of its returns
+
+      for (int returnIndex = 0; returnIndex < this->numReturns; ++returnIndex)
+      {
+         sum   += row[returnIndex];
+         count += int(mask[returnIndex]);
+      }
+
+      if (count < this->numReturns)
+      {
+         this->completeBlocks[symbolIndex / 
+                              CorrelationMatrix::BLOCKSYMBOLS] = 0;
+      }
+
+      if (count < 2)
+      {
+         fill(row, row + this->numReturns, 0.0f);
+         continue;
+      }
+
+      const double MEAN = sum / count;
+
+      for (int returnIndex = 0; returnIndex < this->numReturns; ++returnIndex)
+      {
+         row[returnIndex] = mask[returnIndex] * float(row[returnIndex] - MEAN);
+         sumSquares += double(row[returnIndex]) * row[returnIndex];
+      }
+
+      if (sumSquares <= 0.0)
+      {
+         fill(row, row + this->numReturns, 0.0f);
+         continue;
+      }
+
+      const double SCALE = 1.0 / sqrt(sumSquares);
+
+      for (int returnIndex = 0; returnIndex < this->numReturns; ++returnIndex)
+      {
+         row[returnIndex]     = float(row[returnIndex] * SCALE);
+         squared[returnIndex] = row[returnIndex] * row[returnIndex];
+      }
+
+      this->usableSymbols[symbolIndex] = 1;
+   }
+}
@@ -0,0 +1,268 @@
+//******************************************************************************
+//
+// File Name:     CorrelationMatrix.h
+//
+// File Overview: Represents a CorrelationMatrix, pairwise correlations of
+//                daily returns
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef CorrelationMatrix_h
+#define CorrelationMatrix_h
+
+#include <atomic>
+#include <vector>
+
+#include "TradingCalendar.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    CorrelationMatrix
+//
+// Overview: Correlates the daily returns of every pair of symbols of a 
+//             TradingCalendar, keeping each symbol's most correlated 
+//             neighbours, and optionally the whole matrix
+//             A return is the change from the previous calendar date's 
+//                price, missing unless the symbol has a price on both
+//             Each symbol's returns are normalized in place to zero mean 
+//                and unit length over its own returns, missing ones are 0,
+//                so a pair's correlation is the dot product of their rows
+//             When either symbol misses returns, the pair is normalized by
+//                the length of each over the returns both have, a second
+//                product of squared returns with the other's mask
+//             The products run on blocks of BLOCKSYMBOLS symbols and
+//                BLOCKRETURNS returns that stay in cache, with a SIMD 
+//                kernel, AVX or SSE2 when the compiler targets them, on a
+//                thread per hardware thread
+//             Only block pairs on or above the diagonal are computed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class CorrelationMatrix
+{
+public:
+
+   //***************************************************************************
+   //
+   // Class:    Neighbour
+   //
+   // Overview: A symbol correlated with another
+   //
+   //***************************************************************************
+   struct Neighbour
+   {
+      int   symbolIndex; // Calendar column of the neighbour
+      float correlation; // Of the daily returns, -1 to 1
+   }; // end struct Neighbour
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No symbols
+   // Constraints : None
+   //***************************************************************************
+   CorrelationMatrix();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~CorrelationMatrix();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : calculate
+   // Description : Correlates every pair of symbols, keeping each symbol's
+   //                numNeighbours most correlated, and the whole matrix when
+   //                keepMatrix
+   //                numThreads 0 uses a thread per hardware thread
+   // Constraints : Call setReturns first
+   //                The matrix takes 4 bytes per pair of symbols
+   //***************************************************************************
+   void calculate(
+      const int numNeighbours,
+      const bool keepMatrix,
+      const int numThreads = 0);
+
+   //***************************************************************************
+   // Function    : getCorrelationAt
+   // Description : Retrieve the correlation of the pair of symbols
+   //                0 if either has fewer than two returns, or no variance
+   // Constraints : Throws an exception if the matrix wasn't kept
+   //                Throws an out_of_range exception for invalid indices
+   //***************************************************************************
+   float getCorrelationAt(
+      const int symbolIndex,
+      const int otherSymbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getNeighbours
+   // Description : Retrieve the symbol's most correlated neighbours, most
+   //                correlated first
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   void getNeighbours(
+      const int symbolIndex,
+      vector<Neighbour>& neighbours) const;
+
+   //***************************************************************************
+   // Function    : getNumFlops
+   // Description : Retrieve the floating point operations of the products
+   //                of the last calculate, a multiply and add per return
+   // Constraints : None
+   //***************************************************************************
+   inline double getNumFlops() const;
+
+   //***************************************************************************
+   // Function    : getNumReturns
+   // Description : Retrieve the number of returns of each symbol
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumReturns() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the number of symbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : setReturns
+   // Description : Computes each symbol's returns from the calendar's prices
+   //                and normalizes them in place
+   //                Clears any previous calculate
+   // Constraints : None
+   //***************************************************************************
+   void setReturns(const TradingCalendar& calendar);
+
+   static const int BLOCKSYMBOLS = 48;  // Symbols of a cached block, a
+                                        // multiple of the kernel's tiles
+   static const int BLOCKRETURNS = 256; // Returns of a cached block
+
+private:
+   //***************************************************************************
+   //
+   // Class:    NeighbourLists
+   //
+   // Overview: One thread's most correlated neighbours of every symbol, 
+   //             numNeighbours slots per symbol, unsorted
+   //
+   //***************************************************************************
+   struct NeighbourLists
+   {
+      vector<Neighbour> neighbours;   // Slots of each symbol
+      vector<int>       numKept;      // Slots used of each symbol
+      vector<int>       worstIndices; // Least correlated kept, once full
+   }; // end struct NeighbourLists
+
+   //***************************************************************************
+   // Function    : calculateBlockPair
+   // Description : Correlates the symbols of the two blocks, offering each
+   //                pair to the thread's neighbour lists
+   // Constraints : sums must hold 3 x BLOCKSYMBOLS x BLOCKSYMBOLS values
+   //***************************************************************************
+   void calculateBlockPair(
+      const int block,
+      const int otherBlock,
+      NeighbourLists& lists,
+      float* sums);
+
+   //***************************************************************************
+   // Function    : calculateBlocks
+   // Description : Worker thread, calculates block pairs until none remain
+   //                into the thread's neighbour lists
+   // Constraints : None
+   //***************************************************************************
+   void calculateBlocks(const int threadIndex);
+
+   //***************************************************************************
+   // Function    : offerNeighbour
+   // Description : Keeps the neighbour if among the symbol's most
+   //                correlated in the thread's lists
+   // Constraints : None
+   //***************************************************************************
+   void offerNeighbour(
+      NeighbourLists& lists,
+      const int symbolIndex,
+      const int neighbourIndex,
+      const float correlation);
+
+   vector<int>            blockPairs;       // Block then other, other >= block
+   vector<unsigned char>  completeBlocks;   // 1 if no symbol misses returns
+   vector<float>          correlations;     // Of each pair, if kept
+   vector<float>          masks;            // 1 for a return present, else 0
+   vector<Neighbour>      neighbours;       // Each symbol's, merged
+   atomic<int>            nextBlockPair;    // Next pair for a worker
+   double                 numFlops;         // Of the last calculate
+   vector<int>            numKept;          // Neighbours of each symbol
+   int                    numNeighbours;    // Slots per symbol
+   int                    numPaddedReturns; // Row length, a SIMD multiple
+   int                    numPaddedSymbols; // Rows, a BLOCKSYMBOLS multiple
+   int                    numReturns;       // Of each symbol
+   int                    numSymbols;       // Calendar columns
+   vector<float>          returns;          // Normalized, a row per symbol
+   vector<float>          squaredReturns;   // Each normalized return squared
+   vector<unsigned char>  usableSymbols;    // 1 if it has returns that vary
+   vector<NeighbourLists> threadLists;      // Each thread's neighbours
+}; // end class CorrelationMatrix
+
+//******************************************************************************
+// Function : getNumFlops
+// Process  : Accessor for numFlops
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double CorrelationMatrix::getNumFlops() const
+{
+   return this->numFlops;
+}
+
+//******************************************************************************
+// Function : getNumReturns
+// Process  : Accessor for numReturns
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CorrelationMatrix::getNumReturns() const
+{
+   return this->numReturns;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Accessor for numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CorrelationMatrix::getNumSymbols() const
+{
+   return this->numSymbols;
+}
+
+#endif // CorrelationMatrix_h
@@ -0,0 +1,580 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     CrossoverDetector.cpp
+//
+// File Overview: Represents a CrossoverDetector
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses SimdVector
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#include "CrossoverDetector.h"
+#include "IndicatorEngine.h"
+#include "MACDKernel.h"
+#include "Metrics.h"
+#include "SimdVector.h"
+#include "StockAnalyzer.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const char* EVENTTYPENAMES[CrossoverDetector::NUMEVENTTYPES] =
+{
+   "MACD above signal",
+   "MACD below signal",
+   "MACD above zero",
+   "MACD below zero"
+};
+
+//******************************************************************************
+//
+// Class:    EventEarlier
+//
+// Overview: Orders events by date, then stock, then type
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class EventEarlier
+{
+public:
+   bool operator()(
+      const CrossoverDetector::Event& left,
+      const CrossoverDetector::Event& right) const
+   {
+      if (left.date != right.date)
+      {
+         return left.date < right.date;
+      }
+
+      if (left.symbolIndex != right.symbolIndex)
+      {
+         return left.symbolIndex < right.symbolIndex;
+      }
+
+      return left.type < right.type;
+   }
+}; // end class EventEarlier
+
+//******************************************************************************
+// Function : greaterMask, positiveMask
+// Process  : Compare VECTORDOUBLES values with as many levels, or with 0,
+//             a bit per lane set if the value is greater
+// Notes    : Loads are unaligned
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Built on SimdVector
+//******************************************************************************
+static inline int greaterMask(
+   const double* values,
+   const double* levels)
+{
+   return greaterVectors(loadVector(values), loadVector(levels));
+}
+
+static inline int positiveMask(const double* values)
+{
+   return greaterVectors(loadVector(values), broadcastVector(0.0));
+}
+
+//******************************************************************************
+// Function : lowestBitIndex
+// Process  : Index of the lowest set bit
+// Notes    : word must not be 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline int lowestBitIndex(const unsigned long long word)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+   unsigned long index = 0; // Of the bit
+
+   _BitScanForward64(&index, word);
+   return index;
+#elif defined(_MSC_VER)
+   unsigned long index = 0; // Of the bit
+
+   if (_BitScanForward(&index, (unsigned long)word))
+   {
+      return index;
+   }
+
+   _BitScanForward(&index, (unsigned long)(word >> 32));
+   return index + 32;
+#else
+   return __builtin_ctzll(word);
+#endif
+}
+
+//******************************************************************************
+// Function : markCrossings
+// Process  : For each word of bits, whether the value was above at each bar
+//                Shift in the bar before's bits, the last of the word
+//                   before at bit 0
+//                A bar whose bit differs crossed, up if it is now above,
+//                   else down
+//                Keep those from firstBar to endBar
+// Notes    : A crossing at firstBar compares it with the bar before, so
+//             both must be valid
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void markCrossings(
+   const unsigned long long* above,
+   const int                 numWords,
+   const int                 firstBar,
+   const int                 endBar,
+   unsigned long long*       ups,
+   unsigned long long*       downs)
+{
+   const int BITS = CrossoverDetector::BITSPERWORD;
+
+   unsigned long long before  = 0; // Bits of the bar before each bar
+   unsigned long long changes = 0; // Bars that crossed
+   unsigned long long valid   = 0; // Bars from firstBar to endBar
+   int                lowBit  = 0; // First valid bar of the word
+   int                endBit  = 0; // End of the valid bars of the word
+
+   for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+   {
+      before = above[wordIndex] << 1;
+
+      if (wordIndex > 0)
+      {
+         before |= above[wordIndex - 1] >> (BITS - 1);
+      }
+
+      changes = above[wordIndex] ^ before;
+
+      // Keep the bars from firstBar to endBar
+      lowBit = min(max(firstBar - wordIndex * BITS, 0), BITS);
+      endBit = min(max(endBar - wordIndex * BITS, 0), BITS);
+      valid  = (BITS == endBit) ? ~0ULL : (1ULL << endBit) - 1;
+      valid &= (BITS == lowBit) ? 0ULL : ~((1ULL << lowBit) - 1);
+
+      ups[wordIndex]   = changes & above[wordIndex] & valid;
+      downs[wordIndex] = changes & ~above[wordIndex] & valid;
+   }
+}
+
+//******************************************************************************
+// Function : packAbove
+// Process  : For each word of bars, compare the values with the levels, or
+//             with 0 if levels is NULL, VECTORDOUBLES bars at a time, each
+//             lane's bit to its bar's
+// Notes    : values and levels must hold numWords whole words of bars
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void packAbove(
+   const double*       values,
+   const double*       levels,
+   const int           numWords,
+   unsigned long long* above)
+{
+   const int BITS = CrossoverDetector::BITSPERWORD;
+
+   unsigned long long word = 0; // Bits of the word's bars
+
+   for (int wordIndex = 0; wordIndex < numWords; ++wordIndex)
+   {
+      const double* VALUES = values + wordIndex * BITS;
+
+      word = 0;
+
+      if (NULL == levels)
+      {
+         for (int bit = 0; bit < BITS; bit += VECTORDOUBLES)
+         {
+            word |= (unsigned long long)positiveMask(VALUES + bit) << bit;
+         }
+      }
+      else
+      {
+         const double* LEVELS = levels + wordIndex * BITS;
+
+         for (int bit = 0; bit < BITS; bit += VECTORDOUBLES)
+         {
+            word |= (unsigned long long)greaterMask(VALUES + bit,
+                                                    LEVELS + bit) << bit;
+         }
+      }
+
+      above[wordIndex] = word;
+   }
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : The default periods of StockAnalyzer and IndicatorEngine
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CrossoverDetector::CrossoverDetector()
+   : numBars(0),
+     periodsFast(StockAnalyzer::DEFAULTFASTPERIODS),
+     periodsSignal(IndicatorEngine::DEFAULTSIGNALPERIODS),
+     periodsSlow(StockAnalyzer::DEFAULTSLOWPERIODS),
+     stocks(NULL)
+{
+   this->nextSymbol.store(0);
+} // end CrossoverDetector::CrossoverDetector
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+CrossoverDetector::~CrossoverDetector()
+{
+} // end CrossoverDetector::~CrossoverDetector
+
+//******************************************************************************
+// Function : detect
+// Process  : Lay out each stock's bitsets, a word per BITSPERWORD bars of
+//                each type, and count the bars
+//             Empty each thread's events
+//             Detect the stocks on the threads, or this thread
+//             List the events of every thread by date, stock, and type
+// Notes    : Timed by Metrics
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CrossoverDetector::detect(
+   const vector<const Stock*>& stocks,
+   const int numThreads)
+{
+   METRICS_TIMER(PHASECROSSOVERS);
+
+   const int      NUMSYMBOLS = stocks.size();
+   const int      NUMTHREADS = max(1, 0 == numThreads ?
+                     int(thread::hardware_concurrency()) : numThreads);
+   size_t         numEvents  = 0;  // Of every thread
+   vector<thread> workers;         // Beyond this thread
+
+   // Lay out each stock's bitsets and count the bars
+   this->wordOffsets.resize(NUMSYMBOLS + 1);
+   this->wordOffsets[0] = 0;
+   this->numBars        = 0;
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      const int NUMPRICES = stocks[symbolIndex]->getNumPrices();
+
+      this->wordOffsets[symbolIndex + 1] = this->wordOffsets[symbolIndex] +
+         NUMEVENTTYPES * ((NUMPRICES + BITSPERWORD - 1) / BITSPERWORD);
+      this->numBars += NUMPRICES;
+   }
+
+   this->bits.assign(this->wordOffsets[NUMSYMBOLS], 0);
+
+   // Empty each thread's events
+   this->threadEvents.resize(NUMTHREADS);
+
+   for (int threadIndex = 0; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      this->threadEvents[threadIndex].clear();
+   }
+
+   // Detect the stocks on the threads, or this thread
+   this->stocks = &stocks;
+   this->nextSymbol.store(0);
+
+   for (int threadIndex = 1; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      workers.push_back(thread(
+         &CrossoverDetector::detectStocks, this, threadIndex));
+   }
+
+   this->detectStocks(0);
+
+   for (size_t workerIndex = 0; workerIndex < workers.size(); ++workerIndex)
+   {
+      workers[workerIndex].join();
+   }
+
+   this->stocks = NULL;
+
+   // List the events of every thread by date, stock, and type
+   for (int threadIndex = 0; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      numEvents += this->threadEvents[threadIndex].size();
+   }
+
+   this->events.clear();
+   this->events.reserve(numEvents);
+
+   for (int threadIndex = 0; threadIndex < NUMTHREADS; ++threadIndex)
+   {
+      this->events.insert(this->events.end(),
+                          this->threadEvents[threadIndex].begin(),
+                          this->threadEvents[threadIndex].end());
+   }
+
+   sort(this->events.begin(), this->events.end(), EventEarlier());
+}
+
+//******************************************************************************
+// Function : detectStock
+// Process  : Nothing crosses unless there are two MACDs
+//             Calculate the fast and slow EMAs with MACDKernel, and the MACD
+//                of each bar from the slow period's last, MACDs and signals
+//                padded to whole words with 0
+//             Calculate the signal, the EMA of the MACDs, if long enough
+//             Pack whether MACD is above its signal, and above 0, into a
+//                bit per bar
+//             Mark the crossings of each into the stock's bitsets, from the
+//                second bar with a signal, and the second with a MACD
+//             List the events of each bitset, a set bit at a time
+// Notes    : The stock's bitsets are its own, so threads don't share words
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CrossoverDetector::detectStock(
+   const int symbolIndex,
+   Scratch& scratch,
+   vector<Event>& events)
+{
+   typedef MACDKernel<AnalyzerPricePolicy> Kernel;
+   typedef MACDKernel<DoublePricePolicy>   SignalKernel;
+
+   const Stock&        stock       = *(*this->stocks)[symbolIndex];
+   const int           NUMPRICES   = stock.getNumPrices();
+   const int           NUMWORDS    = this->getNumEventWords(symbolIndex);
+   const int           FIRSTMACD   = this->periodsSlow - 1;
+   const int           FIRSTSIGNAL = FIRSTMACD + this->periodsSignal - 1;
+   const StorageType*  prices      = stock.getPriceData();
+   const int*          dates       = (stock.getNumDates() == NUMPRICES) ?
+                                     stock.getDateData() : NULL;
+   unsigned long long* stockBits   = &this->bits[0] +
+                                     this->wordOffsets[symbolIndex];
+   unsigned long long  word        = 0; // Of a bitset, a bit cleared at a
+                                        // time
+   Event               event;           // Of a set bit
+
+   // Nothing crosses unless there are two MACDs
+   if (NUMPRICES <= FIRSTMACD + 1)
+   {
+      return;
+   }
+
+   // Calculate the EMAs and the MACD of each bar
+   scratch.emasFast.resize(NUMPRICES - this->periodsFast + 1);
+   scratch.emasSlow.resize(NUMPRICES - this->periodsSlow + 1);
+   scratch.macds.assign(NUMWORDS * BITSPERWORD, 0.0);
+   scratch.signals.assign(NUMWORDS * BITSPERWORD, 0.0);
+   scratch.aboveSignal.resize(NUMWORDS);
+   scratch.aboveZero.resize(NUMWORDS);
+
+   Kernel::calculateEMA(
+      prices, NUMPRICES, this->periodsFast,
+      Kernel::calculateFirstPeriodSMA(prices, this->periodsFast),
+      Kernel::calculateMultEMA(this->periodsFast), &scratch.emasFast[0]);
+   Kernel::calculateEMA(
+      prices, NUMPRICES, this->periodsSlow,
+      Kernel::calculateFirstPeriodSMA(prices, this->periodsSlow),
+      Kernel::calculateMultEMA(this->periodsSlow), &scratch.emasSlow[0]);
+
+   for (int barIndex = FIRSTMACD; barIndex < NUMPRICES; ++barIndex)
+   {
+      scratch.macds[barIndex] =
+         AnalyzerPricePolicy::toAccum(
+            scratch.emasFast[barIndex - this->periodsFast + 1]) -
+         AnalyzerPricePolicy::toAccum(scratch.emasSlow[barIndex - FIRSTMACD]);
+   }
+
+   // Calculate the signal, if long enough
+   if (NUMPRICES > FIRSTSIGNAL)
+   {
+      SignalKernel::calculateEMA(
+         &scratch.macds[FIRSTMACD], NUMPRICES - FIRSTMACD,
+         this->periodsSignal,
+         SignalKernel::calculateFirstPeriodSMA(
+            &scratch.macds[FIRSTMACD], this->periodsSignal),
+         SignalKernel::calculateMultEMA(this->periodsSignal),
+         &scratch.signals[FIRSTSIGNAL]);
+   }
+
+   // Pack whether MACD is above its signal, and above 0
+   packAbove(&scratch.macds[0], &scratch.signals[0], NUMWORDS,
+             &scratch.aboveSignal[0]);
+   packAbove(&scratch.macds[0], NULL, NUMWORDS, &scratch.aboveZero[0]);
+
+   // Mark the crossings of each
+   markCrossings(&scratch.aboveSignal[0], NUMWORDS, FIRSTSIGNAL + 1,
+                 NUMPRICES, stockBits + EVENTSIGNALUP * NUMWORDS,
+                 stockBits + EVENTSIGNALDOWN * NUMWORDS);
+   markCrossings(&scratch.aboveZero[0], NUMWORDS, FIRSTMACD + 1,
+                 NUMPRICES, stockBits + EVENTZEROUP * NUMWORDS,
+                 stockBits + EVENTZERODOWN * NUMWORDS);
+
+   // List the events of each bitset
+   event.symbolIndex = symbolIndex;
+
+   for (int type = 0; type < NUMEVENTTYPES; ++type)
+   {
+      event.type = EventType(type);
+
+      for (int wordIndex = 0; wordIndex < NUMWORDS; ++wordIndex)
+      {
+         for (word = stockBits[type * NUMWORDS + wordIndex];
+              0 != word;
+              word &= word - 1)
+         {
+            event.barIndex = wordIndex * BITSPERWORD + lowestBitIndex(word);
+            event.date     = (NULL == dates) ? event.barIndex :
+                                               dates[event.barIndex];
+            events.push_back(event);
+         }
+      }
+   }
+}
+
+//******************************************************************************
+// Function : detectStocks
+// Process  : Take the next SYMBOLSPERCLAIM stocks until none remain
+//             Detect each into the thread's events
+// Notes    : Worker thread entry point, one scratch per thread
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CrossoverDetector::detectStocks(const int threadIndex)
+{
+   const int NUMSYMBOLS = this->stocks->size();
+
+   Scratch        scratch;                                 // Of a stock
+   vector<Event>& events = this->threadEvents[threadIndex]; // Of the thread
+
+   for (int firstSymbol = this->nextSymbol.fetch_add(SYMBOLSPERCLAIM);
+        firstSymbol < NUMSYMBOLS;
+        firstSymbol = this->nextSymbol.fetch_add(SYMBOLSPERCLAIM))
+   {
+      const int ENDSYMBOL = min(firstSymbol + SYMBOLSPERCLAIM, NUMSYMBOLS);
+
+      for (int symbolIndex = firstSymbol; symbolIndex < ENDSYMBOL;
+           ++symbolIndex)
+      {
+         this->detectStock(symbolIndex, scratch, events);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : getEventBits
+// Process  : Check the type
+//             The type's words of the stock's bitsets
+// Notes    : Throws an out_of_range exception for invalid index or type
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const unsigned long long* CrossoverDetector::getEventBits(
+   const int symbolIndex,
+   const EventType type) const
+{
+   const int NUMWORDS = this->getNumEventWords(symbolIndex);
+
+   if (type < 0 || type >= NUMEVENTTYPES)
+   {
+      throw out_of_range("Invalid event type");
+   }
+
+   return this->bits.empty() ? NULL :
+      &this->bits[0] + this->wordOffsets[symbolIndex] + type * NUMWORDS;
+}
+
+//******************************************************************************
+// Function : getEventTypeName
+// Process  : Look up the type's name
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* CrossoverDetector::getEventTypeName(const EventType type)
+{
+   return EVENTTYPENAMES[type];
+}
+
+//******************************************************************************
+// Function : setPeriods
+// Process  : Check the periods
+//             Set them
+// Notes    : Throws an exception unless every period is positive and
+//             periodsFast is less than periodsSlow
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void CrossoverDetector::setPeriods(
+   const int periodsFast,
+   const int periodsSlow,
+   const int periodsSignal)
+{
+   if (periodsFast <= 0 || periodsSignal <= 0 || periodsFast >= periodsSlow)
+   {
+      throw exception("Crossover periods must be positive, fast < slow");
+   }
+
+   this->periodsFast   = periodsFast;
+   this->periodsSlow   = periodsSlow;
+   this->periodsSignal = periodsSignal;
+}
@@ -0,0 +1,360 @@
+//******************************************************************************
+//
+// File Name:     CrossoverDetector.h
+//
+// File Overview: Represents a CrossoverDetector
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef CrossoverDetector_h
+#define CrossoverDetector_h
+
+#include <atomic>
+#include <vector>
+
+#include "Stock.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    CrossoverDetector
+//
+// Overview: Finds every MACD crossover of every bar of every stock of a
+//             universe: MACD crossing its signal line, the EMA of the MACD,
+//             and MACD crossing zero, up or down
+//             Each stock's MACD and signal are computed with MACDKernel, a
+//                signal at every bar from the periodsSlow + periodsSignal
+//                - 1 th
+//             A SIMD compare of MACD against the signal, and against zero,
+//                packs whether MACD is above into a bit per bar, 64 bars a
+//                word, and a crossover is a bit that differs from the bar
+//                before's, found a word at a time with shifts and xors
+//             Each stock keeps a bitset per event type, a bit per bar, and
+//                the events of every stock are listed by date, then stock,
+//                then type
+//             Stocks are taken SYMBOLSPERCLAIM at a time by a thread per
+//                hardware thread
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class CrossoverDetector
+{
+public:
+
+   enum EventType
+   {
+      EVENTSIGNALUP,   // MACD crosses above its signal
+      EVENTSIGNALDOWN, // MACD crosses below its signal
+      EVENTZEROUP,     // MACD crosses above zero
+      EVENTZERODOWN,   // MACD crosses below zero
+      NUMEVENTTYPES
+   };
+
+   //***************************************************************************
+   //
+   // Class:    Event
+   //
+   // Overview: A crossover of a stock at a bar
+   //
+   //***************************************************************************
+   struct Event
+   {
+      int       date;        // Day number of the bar, or the bar index if
+                             // the stock is undated
+      int       symbolIndex; // Of the stock in the universe
+      int       barIndex;    // Of the stock's prices, oldest first
+      EventType type;        // Of the crossover
+   }; // end struct Event
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : The default periods, 12, 26, and 9, and no stocks
+   // Constraints : None
+   //***************************************************************************
+   CrossoverDetector();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~CrossoverDetector();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : detect
+   // Description : Finds the crossovers of every bar of the stocks, their
+   //                bitsets and the list of events, replacing any before
+   //                numThreads 0 uses a thread per hardware thread
+   // Constraints : A stock's dates are used only if it has one per price
+   //***************************************************************************
+   void detect(
+      const vector<const Stock*>& stocks,
+      const int numThreads = 0);
+
+   //***************************************************************************
+   // Function    : getEventAt
+   // Description : Retrieve the event at the index, by date, then stock,
+   //                then type
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const Event& getEventAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : getEventBits
+   // Description : Retrieve the stock's bitset of the type, bit b of word
+   //                b / 64 set if the event is at bar b
+   //                getNumEventWords words long
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   const unsigned long long* getEventBits(
+      const int symbolIndex,
+      const EventType type) const;
+
+   //***************************************************************************
+   // Function    : getEventTypeName
+   // Description : Retrieve the name of the type for output
+   // Constraints : None
+   //***************************************************************************
+   static const char* getEventTypeName(const EventType type);
+
+   //***************************************************************************
+   // Function    : getNumBars
+   // Description : Retrieve the bars of every stock of the last detect
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumBars() const;
+
+   //***************************************************************************
+   // Function    : getNumEvents
+   // Description : Retrieve the number of events of the last detect
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumEvents() const;
+
+   //***************************************************************************
+   // Function    : getNumEventWords
+   // Description : Retrieve the words of each of the stock's bitsets
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getNumEventWords(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the stocks of the last detect
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getPeriodsFast, getPeriodsSignal, getPeriodsSlow
+   // Description : Retrieve the EMA periods of the fast and slow EMAs of
+   //                the MACD, and of its signal
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriodsFast() const;
+   inline int getPeriodsSignal() const;
+   inline int getPeriodsSlow() const;
+
+   //***************************************************************************
+   // Function    : setPeriods
+   // Description : Sets the EMA periods of the MACD and its signal
+   // Constraints : Throws an exception unless every period is positive and
+   //                periodsFast is less than periodsSlow
+   //***************************************************************************
+   void setPeriods(
+      const int periodsFast,
+      const int periodsSlow,
+      const int periodsSignal);
+
+   static const int SYMBOLSPERCLAIM = 16; // Stocks a thread takes at once
+   static const int BITSPERWORD     = 64; // Bars of a bitset word
+
+private:
+   typedef AnalyzerPricePolicy::StorageType StorageType; // Of Stock prices
+
+   //***************************************************************************
+   //
+   // Class:    Scratch
+   //
+   // Overview: One thread's buffers for a stock, sized as needed
+   //
+   //***************************************************************************
+   struct Scratch
+   {
+      vector<unsigned long long> aboveSignal; // Bit per bar, MACD > signal
+      vector<unsigned long long> aboveZero;   // Bit per bar, MACD > 0
+      vector<StorageType>        emasFast;    // Of the prices
+      vector<StorageType>        emasSlow;    // Of the prices
+      vector<double>             macds;       // Of each bar, whole words
+      vector<double>             signals;     // Of each bar, whole words
+   }; // end struct Scratch
+
+   //***************************************************************************
+   // Function    : detectStock
+   // Description : Finds the stock's crossovers into its bitsets and the
+   //                thread's events
+   // Constraints : None
+   //***************************************************************************
+   void detectStock(
+      const int symbolIndex,
+      Scratch& scratch,
+      vector<Event>& events);
+
+   //***************************************************************************
+   // Function    : detectStocks
+   // Description : Worker thread, takes stocks until none remain and finds
+   //                their crossovers into the thread's events
+   // Constraints : None
+   //***************************************************************************
+   void detectStocks(const int threadIndex);
+
+   vector<unsigned long long>  bits;          // Each stock's bitsets, a
+                                              // type after another
+   vector<Event>               events;        // By date, stock, and type
+   atomic<int>                 nextSymbol;    // Next stock for a worker
+   long long                   numBars;       // Of every stock
+   int                         periodsFast;   // Of the fast EMA
+   int                         periodsSignal; // Of the EMA of MACD
+   int                         periodsSlow;   // Of the slow EMA
+   const vector<const Stock*>* stocks;        // While detecting
+   vector< vector<Event> >     threadEvents;  // Each thread's events
+   vector<int>                 wordOffsets;   // Of each stock's bitsets,
+                                              // and the end
+}; // end class CrossoverDetector
+
+//******************************************************************************
+// Function : getEventAt
+// Process  : Retrieve the event at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const CrossoverDetector::Event& CrossoverDetector::getEventAt(
+   const int index) const
+{
+   return this->events.at(index);
+}
+
+//******************************************************************************
+// Function : getNumBars
+// Process  : Accessor for numBars
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long CrossoverDetector::getNumBars() const
+{
+   return this->numBars;
+}
+
+//******************************************************************************
+// Function : getNumEvents
+// Process  : Retrieve the number of events
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getNumEvents() const
+{
+   return this->events.size();
+}
+
+//******************************************************************************
+// Function : getNumEventWords
+// Process  : The stock's words / NUMEVENTTYPES
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getNumEventWords(const int symbolIndex) const
+{
+   return (this->wordOffsets.at(symbolIndex + 1) -
+           this->wordOffsets.at(symbolIndex)) / NUMEVENTTYPES;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Retrieve the number of stocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getNumSymbols() const
+{
+   return this->wordOffsets.empty() ? 0 : this->wordOffsets.size() - 1;
+}
+
+//******************************************************************************
+// Function : getPeriodsFast
+// Process  : Accessor for periodsFast
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getPeriodsFast() const
+{
+   return this->periodsFast;
+}
+
+//******************************************************************************
+// Function : getPeriodsSignal
+// Process  : Accessor for periodsSignal
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getPeriodsSignal() const
+{
+   return this->periodsSignal;
+}
+
+//******************************************************************************
+// Function : getPeriodsSlow
+// Process  : Accessor for periodsSlow
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int CrossoverDetector::getPeriodsSlow() const
+{
+   return this->periodsSlow;
+}
+
+#endif // CrossoverDetector_h
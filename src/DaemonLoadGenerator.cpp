@@ -0,0 +1,211 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     DaemonLoadGenerator.cpp
+//
+// File Overview: Represents a DaemonLoadGenerator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+#include "DaemonLoadGenerator.h"
+#include "LocalSocket.h"
+#include "SyntheticPriceGenerator.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+typedef chrono::steady_clock LatencyClock; // Monotonic clock for latencies
+
+static const int TOPREQUESTINTERVAL = 10;  // Every tenth request is a TOP
+
+//******************************************************************************
+// Function : constructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+DaemonLoadGenerator::DaemonLoadGenerator()
+{
+} // end DaemonLoadGenerator::DaemonLoadGenerator
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+DaemonLoadGenerator::~DaemonLoadGenerator()
+{
+} // end DaemonLoadGenerator::~DaemonLoadGenerator
+
+//******************************************************************************
+// Function : outputLatencies
+// Process  : Sort the latencies
+//             Output the count, p50, p99, and max in microseconds
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void DaemonLoadGenerator::outputLatencies(
+   const char* requestKind,
+   vector<double>& latencies) const
+{
+   if (latencies.empty())
+   {
+      return;
+   }
+
+   sort(latencies.begin(), latencies.end());
+
+   cout << setw(8) << requestKind
+        << setw(10) << latencies.size()
+        << fixed << setprecision(1)
+        << setw(12) << latencies[latencies.size() / 2]
+        << setw(12) << latencies[latencies.size() * 99 / 100]
+        << setw(12) << latencies.back() << endl;
+   cout.unsetf(ios::floatfield);
+}
+
+//******************************************************************************
+// Function : run
+// Process  : Connect to the daemon
+//             Discover symbols with a TOP request
+//             Send the requests, timing each round trip
+//                Every tenth request is a TOP
+//                Otherwise a MACD, or alternately a BAR when sendBars
+//             Output the latencies of each kind
+// Notes    : Throws an exception if the daemon can't be reached or answers
+//             with an error
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void DaemonLoadGenerator::run(
+   const string& socketPath,
+   const int numRequests,
+   const bool sendBars)
+{
+   LocalSocket             connection;    // Connection to the daemon
+   SyntheticPriceGenerator priceGenerator(1); // Prices for BAR requests
+   vector<string>          symbols;       // Symbols to query
+   vector<double>          latenciesTop;  // Microseconds per TOP
+   vector<double>          latenciesMACD; // Microseconds per MACD
+   vector<double>          latenciesBar;  // Microseconds per BAR
+   vector<double>*         latencies = NULL; // Latencies of this request
+   string                  request;       // Request sent
+   string                  response;      // Daemon's answer
+   ostringstream           topRequest;    // TOP request text
+   LatencyClock::time_point start;        // Start of a round trip
+
+   connection.connectTo(socketPath);
+
+   // Discover symbols with a TOP request
+   topRequest << "TOP " << DaemonLoadGenerator::NUMSYMBOLSQUERIED;
+   connection.sendLine(topRequest.str());
+
+   if (!connection.readLine(response) || 0 != response.compare(0, 2, "OK"))
+   {
+      throw exception("Daemon did not answer the TOP request");
+   }
+
+   istringstream ranking(response); // OK <count> <symbol> <slope> ...
+   string        word;              // Next word of the ranking
+   double        slope = 0.0;       // Slope of the symbol
+   int           count = 0;         // Stocks ranked
+
+   ranking >> word >> count;
+
+   while (ranking >> word >> slope)
+   {
+      symbols.push_back(word);
+   }
+
+   if (symbols.empty())
+   {
+      throw exception("Daemon has no stocks");
+   }
+
+   topRequest.str("");
+   topRequest << "TOP " << DaemonLoadGenerator::TOPREQUESTSTOCKS;
+
+   // Send the requests, timing each round trip
+   for (int requestIndex = 0; requestIndex < numRequests; ++requestIndex)
+   {
+      const string& symbol = symbols[requestIndex % symbols.size()];
+
+      if (0 == requestIndex % TOPREQUESTINTERVAL)
+      {
+         request   = topRequest.str();
+         latencies = &latenciesTop;
+      }
+      else if (sendBars && 0 == requestIndex % 2)
+      {
+         ostringstream barRequest; // BAR request text
+         barRequest << "BAR " << symbol << ' ' << fixed << setprecision(2)
+                    << priceGenerator.nextPrice();
+         request   = barRequest.str();
+         latencies = &latenciesBar;
+      }
+      else
+      {
+         request   = "MACD " + symbol;
+         latencies = &latenciesMACD;
+      }
+
+      start = LatencyClock::now();
+      connection.sendLine(request);
+
+      if (!connection.readLine(response))
+      {
+         throw exception("Daemon closed the connection");
+      }
+
+      latencies->push_back(
+         chrono::duration<double, micro>(LatencyClock::now() - start).count());
+
+      if (0 != response.compare(0, 2, "OK"))
+      {
+         throw exception("Daemon answered with an error");
+      }
+   }
+
+   // Output the latencies of each kind
+   cout << "---Daemon latency, microseconds per round trip---" << endl << endl;
+   cout << setw(8) << "request" << setw(10) << "count"
+        << setw(12) << "p50" << setw(12) << "p99"
+        << setw(12) << "max" << endl;
+   this->outputLatencies("TOP", latenciesTop);
+   this->outputLatencies("MACD", latenciesMACD);
+   this->outputLatencies("BAR", latenciesBar);
+   cout << endl;
+}
\ No newline at end of file
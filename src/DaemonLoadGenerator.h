@@ -0,0 +1,88 @@
+//******************************************************************************
+//
+// File Name:     DaemonLoadGenerator.h
+//
+// File Overview: Represents a DaemonLoadGenerator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef DaemonLoadGenerator_h
+#define DaemonLoadGenerator_h
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    DaemonLoadGenerator
+//
+// Overview: A local client that sends a mix of requests to an AnalysisDaemon
+//             and reports the round trip latency of each kind
+//             Symbols are discovered with a TOP request
+//             BAR requests change the daemon's state, so they are only sent
+//             when asked for
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class DaemonLoadGenerator
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : None
+   // Constraints : None
+   //***************************************************************************
+   DaemonLoadGenerator();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~DaemonLoadGenerator();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : run
+   // Description : Sends numRequests requests to the daemon on socketPath
+   //                One in ten is TOP 20, the rest MACD, or alternately
+   //                MACD and BAR when sendBars is true
+   //                Outputs p50, p99, and max latency for each kind
+   // Constraints : Throws an exception if the daemon can't be reached or
+   //                answers with an error
+   //***************************************************************************
+   void run(
+      const string& socketPath,
+      const int numRequests,
+      const bool sendBars);
+
+   static const int DEFAULTNUMREQUESTS = 100000; // Requests per run
+   static const int NUMSYMBOLSQUERIED  = 100;    // Symbols discovered with TOP
+   static const int TOPREQUESTSTOCKS   = 20;     // n in each TOP request
+
+private:
+   //***************************************************************************
+   // Function    : outputLatencies
+   // Description : Outputs the count, p50, p99, and max of the latencies
+   // Constraints : Sorts latencies
+   //***************************************************************************
+   void outputLatencies(
+      const char* requestKind,
+      vector<double>& latencies) const;
+}; // end class DaemonLoadGenerator
+
+#endif // DaemonLoadGenerator_h
\ No newline at end of file
@@ -0,0 +1,338 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     EMARibbon.cpp
+//
+// File Overview: Represents an EMARibbon
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses SimdVector
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+#include "EMARibbon.h"
+#include "MACDKernel.h"
+#include "SimdVector.h"
+
+//******************************************************************************
+// Function : advanceVector
+// Process  : (price - EMA) x multiplier + EMA per lane
+// Notes    : The subtract, multiply, and add are those of calculateEMA, so
+//             each lane rounds as it does
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Moved the vector shim to SimdVector.h
+//******************************************************************************
+#if defined(SIMDVECTOR_AVX)
+static inline DoubleVector advanceVector(
+   const DoubleVector price,
+   const DoubleVector ema,
+   const DoubleVector multiplier)
+{
+   return _mm256_add_pd(
+      _mm256_mul_pd(_mm256_sub_pd(price, ema), multiplier), ema);
+}
+#elif defined(SIMDVECTOR_SSE2)
+static inline DoubleVector advanceVector(
+   const DoubleVector price,
+   const DoubleVector ema,
+   const DoubleVector multiplier)
+{
+   return _mm_add_pd(_mm_mul_pd(_mm_sub_pd(price, ema), multiplier), ema);
+}
+#else
+static inline DoubleVector advanceVector(
+   const DoubleVector price,
+   const DoubleVector ema,
+   const DoubleVector multiplier)
+{
+   return (price - ema) * multiplier + ema;
+}
+#endif
+
+//******************************************************************************
+// Function : advanceLanes
+// Process  : Load NUMVECTORS vectors of EMAs and multipliers into registers
+//             Advance every lane by each price, storing each bar's EMAs to
+//                its history row if HISTORY
+//             Store the EMAs
+// Notes    : The lanes of a vector are independent, so a bar's NUMVECTORS
+//             advances overlap rather than wait on each other
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <int NUMVECTORS, bool HISTORY>
+static void advanceLanes(
+   const double* prices,
+   const int     firstPrice,
+   const int     numPrices,
+   const double* multipliers,
+   double*       emas,
+   double*       history,
+   const int     historyStride)
+{
+   DoubleVector states[NUMVECTORS]; // EMAs in registers
+   DoubleVector mults[NUMVECTORS];  // Multipliers in registers
+
+   // Load the EMAs and multipliers into registers
+   for (int vectorIndex = 0; vectorIndex < NUMVECTORS; ++vectorIndex)
+   {
+      states[vectorIndex] = loadVector(emas + vectorIndex * VECTORDOUBLES);
+      mults[vectorIndex]  =
+         loadVector(multipliers + vectorIndex * VECTORDOUBLES);
+   }
+
+   // Advance every lane by each price
+   for (int priceIndex = firstPrice; priceIndex < numPrices; ++priceIndex)
+   {
+      const DoubleVector PRICE = broadcastVector(prices[priceIndex]);
+
+      for (int vectorIndex = 0; vectorIndex < NUMVECTORS; ++vectorIndex)
+      {
+         states[vectorIndex] =
+            advanceVector(PRICE, states[vectorIndex], mults[vectorIndex]);
+
+         if (HISTORY)
+         {
+            storeVector(history + priceIndex * historyStride +
+                           vectorIndex * VECTORDOUBLES,
+                        states[vectorIndex]);
+         }
+      }
+   }
+
+   // Store the EMAs
+   for (int vectorIndex = 0; vectorIndex < NUMVECTORS; ++vectorIndex)
+   {
+      storeVector(emas + vectorIndex * VECTORDOUBLES, states[vectorIndex]);
+   }
+}
+
+//******************************************************************************
+// Function : advancePass
+// Process  : Advance the pass's numVectors vectors of lanes with the
+//             kernel holding that many
+// Notes    : numVectors is 1 to EMARibbon::MAXPASSVECTORS
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <bool HISTORY>
+static void advancePass(
+   const int     numVectors,
+   const double* prices,
+   const int     firstPrice,
+   const int     numPrices,
+   const double* multipliers,
+   double*       emas,
+   double*       history,
+   const int     historyStride)
+{
+   switch (numVectors)
+   {
+   case 1:
+      advanceLanes<1, HISTORY>(prices, firstPrice, numPrices, multipliers,
+                               emas, history, historyStride);
+      break;
+   case 2:
+      advanceLanes<2, HISTORY>(prices, firstPrice, numPrices, multipliers,
+                               emas, history, historyStride);
+      break;
+   case 3:
+      advanceLanes<3, HISTORY>(prices, firstPrice, numPrices, multipliers,
+                               emas, history, historyStride);
+      break;
+   default:
+      advanceLanes<4, HISTORY>(prices, firstPrice, numPrices, multipliers,
+                               emas, history, historyStride);
+      break;
+   }
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : No periods
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+EMARibbon::EMARibbon()
+   : maxPeriod(0)
+{
+} // end EMARibbon::EMARibbon
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+EMARibbon::~EMARibbon()
+{
+} // end EMARibbon::~EMARibbon
+
+//******************************************************************************
+// Function : calculate
+// Process  : No lane is seeded
+//             Until the longest period is seeded, for each price
+//                Add it to the running sum of the prices
+//                Seed each lane whose period it completes with the SMA, the
+//                   running sum / period
+//                Advance each lane already seeded
+//                Fill the history row, if any
+//             Advance the lanes a vector at a time over the other prices, in
+//                passes of up to MAXPASSVECTORS vectors
+//             Keep the current EMA of each lane
+// Notes    : The running sum is the sum calculateFirstPeriodSMA takes, the
+//             same additions in the same order
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void EMARibbon::calculate(
+   const double* prices,
+   const int     numPrices,
+   double*       history)
+{
+   const double NOTKNOWN   = numeric_limits<double>::quiet_NaN();
+   const int    NUMLANES   = this->getNumPeriods();
+   const int    STRIDE     = this->getHistoryStride();
+   const int    NUMSEEDING = min(numPrices, this->maxPeriod);
+   const int    PASSLANES  = EMARibbon::MAXPASSVECTORS * VECTORDOUBLES;
+
+   double sum = 0.0; // Of the prices so far, oldest first
+
+   // No lane is seeded
+   fill(this->laneEMAs.begin(), this->laneEMAs.begin() + NUMLANES,
+        NOTKNOWN);
+
+   // Until the longest period is seeded, for each price
+   for (int priceIndex = 0; priceIndex < NUMSEEDING; ++priceIndex)
+   {
+      const double PRICE = prices[priceIndex];
+
+      sum += PRICE;
+
+      for (int lane = 0; lane < NUMLANES; ++lane)
+      {
+         const int PERIOD = this->periods[lane];
+         double&   ema    = this->laneEMAs[lane];
+
+         if (priceIndex + 1 == PERIOD)
+         {
+            ema = sum / PERIOD;
+         }
+         else if (priceIndex >= PERIOD)
+         {
+            ema = (PRICE - ema) * this->multipliers[lane] + ema;
+         }
+      }
+
+      if (NULL != history)
+      {
+         copy(this->laneEMAs.begin(), this->laneEMAs.end(),
+              history + priceIndex * STRIDE);
+      }
+   }
+
+   // Advance the lanes a vector at a time over the other prices
+   for (int firstLane = 0; firstLane < STRIDE; firstLane += PASSLANES)
+   {
+      const int NUMVECTORS = min(PASSLANES, STRIDE - firstLane) /
+                             VECTORDOUBLES;
+
+      if (NULL != history)
+      {
+         advancePass<true>(NUMVECTORS, prices, NUMSEEDING, numPrices,
+                           &this->multipliers[firstLane],
+                           &this->laneEMAs[firstLane], history + firstLane,
+                           STRIDE);
+      }
+      else
+      {
+         advancePass<false>(NUMVECTORS, prices, NUMSEEDING, numPrices,
+                            &this->multipliers[firstLane],
+                            &this->laneEMAs[firstLane], NULL, STRIDE);
+      }
+   }
+
+   // Keep the current EMA of each lane
+   copy(this->laneEMAs.begin(), this->laneEMAs.begin() + NUMLANES,
+        this->currentEMAs.begin());
+}
+
+//******************************************************************************
+// Function : setPeriods
+// Process  : Check the periods
+//             Pad the lanes to whole vectors
+//             Calculate each lane's multiplier with MACDKernel, 0 for the
+//                padding, which leaves its EMA as it is
+//             Forget the EMAs
+// Notes    : Throws an exception unless there is a period and every period
+//             is positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void EMARibbon::setPeriods(const vector<int>& periods)
+{
+   typedef MACDKernel<DoublePricePolicy> Kernel;
+
+   const int NUMLANES = periods.size();
+
+   // Check the periods
+   if (periods.empty() || *min_element(periods.begin(), periods.end()) <= 0)
+   {
+      throw exception("EMA ribbon periods must be positive");
+   }
+
+   this->periods   = periods;
+   this->maxPeriod = *max_element(periods.begin(), periods.end());
+
+   // Pad the lanes to whole vectors
+   const int STRIDE = (NUMLANES + VECTORDOUBLES - 1) / VECTORDOUBLES *
+                      VECTORDOUBLES;
+
+   // Calculate each lane's multiplier, 0 for the padding
+   this->multipliers.assign(STRIDE, 0.0);
+
+   for (int lane = 0; lane < NUMLANES; ++lane)
+   {
+      this->multipliers[lane] = Kernel::calculateMultEMA(periods[lane]);
+   }
+
+   // Forget the EMAs
+   this->laneEMAs.assign(STRIDE, 0.0);
+   this->currentEMAs.assign(
+      NUMLANES, numeric_limits<double>::quiet_NaN());
+}
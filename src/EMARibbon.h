@@ -0,0 +1,216 @@
+//******************************************************************************
+//
+// File Name:     EMARibbon.h
+//
+// File Overview: Represents an EMARibbon
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef EMARibbon_h
+#define EMARibbon_h
+
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    EMARibbon
+//
+// Overview: EMAs of several periods of one price series, a ribbon, computed
+//             in one pass over the prices
+//             Each period is a SIMD lane, EMA states and multipliers side by
+//                side, so a bar advances every lane of a vector at once:
+//                EMA = (price - EMA) x multiplier + EMA
+//             Each lane is seeded with the SMA of its first period prices,
+//                from one running sum of the prices shared by every lane,
+//                summed oldest first like calculateFirstPeriodSMA
+//             Until the longest period is seeded the lanes are advanced one
+//                at a time, after that a vector at a time, the states held
+//                in registers for up to MAXPASSVECTORS vectors of lanes a
+//                pass, so a ribbon that fits is one pass over the prices
+//             Every EMA matches MACDKernel<DoublePricePolicy>::calculateEMA
+//                of its period bit for bit
+//             The history of every EMA at every bar is optional, the current
+//                EMAs are always kept
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class EMARibbon
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No periods, set them before calculating
+   // Constraints : None
+   //***************************************************************************
+   EMARibbon();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~EMARibbon();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : calculate
+   // Description : Calculates the EMA of each period of numPrices prices,
+   //                oldest first
+   //                If history isn't NULL, fills the EMAs of each bar into
+   //                   a row of getHistoryStride values, the lanes in the
+   //                   order of the periods, NaN before a lane is seeded
+   // Constraints : history, if not NULL, must hold numPrices rows
+   //***************************************************************************
+   void calculate(
+      const double* prices,
+      const int numPrices,
+      double* history);
+
+   //***************************************************************************
+   // Function    : getCurrentEMA
+   // Description : Retrieves the EMA of the lane's period at the newest
+   //                price calculated
+   //                NaN if there were fewer prices than the period
+   // Constraints : Throws an out_of_range exception for invalid lane
+   //***************************************************************************
+   inline double getCurrentEMA(const int lane) const;
+
+   //***************************************************************************
+   // Function    : getHistoryStride
+   // Description : Retrieves the values in a row of history, the number of
+   //                periods padded to a whole number of SIMD lanes
+   // Constraints : None
+   //***************************************************************************
+   inline int getHistoryStride() const;
+
+   //***************************************************************************
+   // Function    : getMaxPeriod
+   // Description : Retrieves the longest period
+   // Constraints : None
+   //***************************************************************************
+   inline int getMaxPeriod() const;
+
+   //***************************************************************************
+   // Function    : getNumPeriods
+   // Description : Retrieves the number of periods, the lanes of the ribbon
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumPeriods() const;
+
+   //***************************************************************************
+   // Function    : getPeriod
+   // Description : Retrieves the period of the lane
+   // Constraints : Throws an out_of_range exception for invalid lane
+   //***************************************************************************
+   inline int getPeriod(const int lane) const;
+
+   //***************************************************************************
+   // Function    : setPeriods
+   // Description : Sets the period of each lane, forgetting the EMAs
+   // Constraints : Throws an exception unless there is a period and every
+   //                period is positive
+   //***************************************************************************
+   void setPeriods(const vector<int>& periods);
+
+   static const int MAXPASSVECTORS = 4; // Vectors of lanes held in
+                                        // registers by a pass
+
+private:
+   vector<double> currentEMAs; // Of each lane, after calculate
+   vector<double> laneEMAs;    // Of each padded lane, while calculating
+   int            maxPeriod;   // Longest period
+   vector<double> multipliers; // EMA multiplier of each padded lane, 0 for
+                               // padding
+   vector<int>    periods;     // Of each lane
+}; // end class EMARibbon
+
+//******************************************************************************
+// Function : getCurrentEMA
+// Process  : Retrieve the lane's current EMA
+// Notes    : Throws an out_of_range exception for invalid lane
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double EMARibbon::getCurrentEMA(const int lane) const
+{
+   return this->currentEMAs.at(lane);
+}
+
+//******************************************************************************
+// Function : getHistoryStride
+// Process  : The padded lanes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int EMARibbon::getHistoryStride() const
+{
+   return this->laneEMAs.size();
+}
+
+//******************************************************************************
+// Function : getMaxPeriod
+// Process  : Accessor for maxPeriod
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int EMARibbon::getMaxPeriod() const
+{
+   return this->maxPeriod;
+}
+
+//******************************************************************************
+// Function : getNumPeriods
+// Process  : Retrieve the number of periods
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int EMARibbon::getNumPeriods() const
+{
+   return this->periods.size();
+}
+
+//******************************************************************************
+// Function : getPeriod
+// Process  : Retrieve the period of the lane
+// Notes    : Throws an out_of_range exception for invalid lane
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int EMARibbon::getPeriod(const int lane) const
+{
+   return this->periods.at(lane);
+}
+
+#endif // EMARibbon_h
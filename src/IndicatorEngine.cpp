@@ -0,0 +1,894 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     IndicatorEngine.cpp
+//
+// File Overview: Represents an IndicatorEngine
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <exception>
+#include <limits>
+
+#include "IndicatorEngine.h"
+#include "StockAnalyzer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const double BOLLINGERDEVIATIONS = 2.0;   // Width of the bands
+static const double MIDDLEVALUE         = 50.0;  // Of an RSI or stochastic
+                                                 // with nothing to compare
+static const double PERCENT             = 100.0; // Scale of RSI, stochastic
+static const int    MAXPERIODDIGITS     = 9;     // Keeps N within an int
+static const char   PERIODSEPARATOR     = '_';   // Between periods
+
+// Name prefix of each kind of indicator, in IndicatorKind's order
+static const char* KINDPREFIXES[] =
+{
+   "sma",
+   "ema",
+   "rsi",
+   "atr",
+   "stoch",
+   "bbupper",
+   "bblower",
+   "high",
+   "low",
+   "macd",
+   "signal"
+};
+
+// Periods after each prefix, or none for the default periods
+static const int KINDNUMPERIODS[] =
+{
+   1,
+   1,
+   1,
+   1,
+   1,
+   1,
+   1,
+   1,
+   1,
+   2,
+   3
+};
+
+static const int NUMKINDPREFIXES =
+   sizeof(KINDPREFIXES) / sizeof(KINDPREFIXES[0]);
+
+//******************************************************************************
+// Function : constructor
+// Process  : No indicators and no bars
+//             The inputs are the graph's first nodes, at level 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+IndicatorEngine::IndicatorEngine()
+   : lastClose(0.0),
+     numBars(0),
+     numNodesRequested(0),
+     sharing(true)
+{
+   Node input; // Of the bar
+
+   input.kind        = NODEINPUT;
+   input.second      = -1;
+   input.periods     = 0;
+   input.smoothing   = 0.0;
+   input.keepSquares = false;
+   input.level       = 0;
+
+   for (int inputIndex = 0; inputIndex < NUMINPUTS; ++inputIndex)
+   {
+      input.source = inputIndex;
+      input.slot   = inputIndex;
+      this->nodes.push_back(input);
+   }
+
+   this->compile();
+} // end IndicatorEngine::IndicatorEngine
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+IndicatorEngine::~IndicatorEngine()
+{
+} // end IndicatorEngine::~IndicatorEngine
+
+//******************************************************************************
+// Function : addAverage, addDifference, addMaximum, addSum
+// Process  : Describe the node and add it
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+int IndicatorEngine::addAverage(
+   const int    source,
+   const int    periods,
+   const double smoothing)
+{
+   Node node = Node(); // Described, 0 but for its fields
+
+   node.kind      = NODEAVERAGE;
+   node.source    = source;
+   node.second    = -1;
+   node.periods   = periods;
+   node.smoothing = smoothing;
+
+   return this->addNode(node);
+}
+
+int IndicatorEngine::addDifference(
+   const int first,
+   const int second)
+{
+   Node node = Node(); // Described, 0 but for its fields
+
+   node.kind   = NODEDIFFERENCE;
+   node.source = first;
+   node.second = second;
+
+   return this->addNode(node);
+}
+
+int IndicatorEngine::addMaximum(
+   const int source,
+   const int periods)
+{
+   Node node = Node(); // Described, 0 but for its fields
+
+   node.kind    = NODEMAXIMUM;
+   node.source  = source;
+   node.second  = -1;
+   node.periods = periods;
+
+   return this->addNode(node);
+}
+
+int IndicatorEngine::addSum(
+   const int  source,
+   const int  periods,
+   const bool keepSquares)
+{
+   Node node = Node(); // Described, 0 but for its fields
+
+   node.kind        = NODESUM;
+   node.source      = source;
+   node.second      = -1;
+   node.periods     = periods;
+   node.keepSquares = keepSquares;
+
+   return this->addNode(node);
+}
+
+//******************************************************************************
+// Function : addIndicator
+// Process  : Parse the name into the kind and periods
+//             Add the nodes the kind is derived from
+//             Retrieve the index of an indicator already added, when
+//                sharing
+//             Compile the graph, and forget the bars, the new nodes have
+//                none
+// Notes    : Throws an exception if the name isn't an indicator
+//             The nodes are added even for an indicator already added, so
+//                they count as requested and eliminated
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+int IndicatorEngine::addIndicator(const string& indicatorName)
+{
+   Indicator   indicator;           // Being added
+   vector<int> periods;             // Parsed
+   int         fast           = 0;  // EMA of a MACD
+   int         slow           = 0;  // EMA of a MACD
+   int         indicatorIndex = -1; // Added
+
+   // Parse the name into the kind and periods
+   if (!IndicatorEngine::parseIndicatorName(
+          indicatorName, indicator.kind, periods))
+   {
+      throw exception("Unknown indicator");
+   }
+
+   indicator.name    = indicatorName;
+   indicator.periods = periods.back();
+   indicator.second  = -1;
+
+   // Add the nodes the kind is derived from
+   const int    PERIODS = periods.back();
+   const double EMA     = ExponentialAverage::getEMASmoothing(PERIODS);
+   const double WILDER  = ExponentialAverage::getWilderSmoothing(PERIODS);
+
+   switch (indicator.kind)
+   {
+   case KINDSMA:
+      indicator.first = this->addSum(INPUTCLOSE, PERIODS, false);
+      break;
+
+   case KINDEMA:
+      indicator.first = this->addAverage(INPUTCLOSE, PERIODS, EMA);
+      break;
+
+   case KINDRSI:
+      indicator.first  = this->addAverage(INPUTGAIN, PERIODS, WILDER);
+      indicator.second = this->addAverage(INPUTLOSS, PERIODS, WILDER);
+      break;
+
+   case KINDATR:
+      indicator.first = this->addAverage(INPUTTRUERANGE, PERIODS, WILDER);
+      break;
+
+   case KINDSTOCHASTIC:
+      indicator.first  = this->addMaximum(INPUTHIGH, PERIODS);
+      indicator.second = this->addMaximum(INPUTNEGATEDLOW, PERIODS);
+      break;
+
+   case KINDBOLLINGERUPPER:
+   case KINDBOLLINGERLOWER:
+      indicator.first = this->addSum(INPUTCLOSE, PERIODS, true);
+      break;
+
+   case KINDHIGH:
+      indicator.first = this->addMaximum(INPUTHIGH, PERIODS);
+      break;
+
+   case KINDLOW:
+      indicator.first = this->addMaximum(INPUTNEGATEDLOW, PERIODS);
+      break;
+
+   case KINDMACD:
+   case KINDSIGNAL:
+      fast            = this->addAverage(INPUTCLOSE, periods[0],
+         ExponentialAverage::getEMASmoothing(periods[0]));
+      slow            = this->addAverage(INPUTCLOSE, periods[1],
+         ExponentialAverage::getEMASmoothing(periods[1]));
+      indicator.first = this->addDifference(fast, slow);
+
+      if (KINDSIGNAL == indicator.kind)
+      {
+         indicator.first = this->addAverage(indicator.first, PERIODS, EMA);
+      }
+      break;
+   }
+
+   // Retrieve the index of an indicator already added, when sharing
+   indicatorIndex = this->findIndicator(indicatorName);
+
+   if (!this->sharing || -1 == indicatorIndex)
+   {
+      indicatorIndex = this->indicators.size();
+      this->indicators.push_back(indicator);
+   }
+
+   // Compile the graph, and forget the bars
+   this->compile();
+
+   return indicatorIndex;
+}
+
+//******************************************************************************
+// Function : addNode
+// Process  : Count the node as requested
+//             When sharing, find an identical node, the same kind, sources,
+//                periods, and smoothing, keeping the squares of a sum if
+//                either keeps them
+//             Otherwise add the node, one level deeper than its sources
+// Notes    : Sources are added before the nodes they feed, so the graph
+//             has no cycles
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int IndicatorEngine::addNode(const Node& node)
+{
+   ++this->numNodesRequested;
+
+   // When sharing, find an identical node
+   for (size_t nodeIndex = NUMINPUTS;
+        this->sharing && nodeIndex < this->nodes.size(); ++nodeIndex)
+   {
+      Node& shared = this->nodes[nodeIndex]; // Candidate
+
+      if (shared.kind == node.kind && shared.source == node.source &&
+          shared.second == node.second && shared.periods == node.periods &&
+          shared.smoothing == node.smoothing)
+      {
+         shared.keepSquares = shared.keepSquares || node.keepSquares;
+         return nodeIndex;
+      }
+   }
+
+   // Otherwise add the node, one level deeper than its sources
+   Node added = node; // To the graph
+
+   added.level = this->nodes[node.source].level + 1;
+
+   if (-1 != node.second)
+   {
+      added.level = max(added.level, this->nodes[node.second].level + 1);
+   }
+
+   added.slot = -1;
+   this->nodes.push_back(added);
+
+   return this->nodes.size() - 1;
+}
+
+//******************************************************************************
+// Function : compile
+// Process  : Order the nodes by level, then kind, then source, so a level's
+//                nodes of a kind are contiguous, and those on one source
+//                are adjacent
+//                The order is of sort keys packing the level, kind, source,
+//                and index of each node
+//             Place each node in the vector of its kind, in order, its
+//                source's slot already known
+//             End a stage after each level
+//             Size the values to the inputs and differences, and reset
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void IndicatorEngine::compile()
+{
+   const long long NUMNODES = this->nodes.size();
+
+   vector<long long> keys; // Sort key of each node but the inputs
+   Stage             stage = { 0, 0, 0, 0 }; // Ends of the current level
+   int               level = 1;              // Of the current stage
+
+   // Order the nodes by level, then kind, then source
+   for (long long nodeIndex = NUMINPUTS; nodeIndex < NUMNODES; ++nodeIndex)
+   {
+      const Node& node = this->nodes[nodeIndex];
+
+      keys.push_back(
+         ((node.level * NUMNODEKINDS + node.kind) * NUMNODES + node.source) *
+         NUMNODES + nodeIndex);
+   }
+
+   sort(keys.begin(), keys.end());
+
+   this->averageSources.clear();
+   this->averages.clear();
+   this->differences.clear();
+   this->maximumSources.clear();
+   this->maximums.clear();
+   this->stages.clear();
+   this->sumSources.clear();
+   this->sums.clear();
+
+   // Place each node in the vector of its kind, in order
+   for (size_t keyIndex = 0; keyIndex < keys.size(); ++keyIndex)
+   {
+      Node&       node   = this->nodes[keys[keyIndex] % NUMNODES];
+      const int   SOURCE = this->nodes[node.source].slot; // Feeding it
+      Difference  difference;                             // Of the node
+
+      // End a stage after each level
+      while (level < node.level)
+      {
+         this->stages.push_back(stage);
+         ++level;
+      }
+
+      switch (node.kind)
+      {
+      case NODEINPUT:
+         break;
+
+      case NODESUM:
+         node.slot = this->sums.size();
+         this->sums.push_back(RollingSum(node.periods, node.keepSquares));
+         this->sumSources.push_back(SOURCE);
+         stage.sumEnd = this->sums.size();
+         break;
+
+      case NODEMAXIMUM:
+         node.slot = this->maximums.size();
+         this->maximums.push_back(RollingMaximum(node.periods));
+         this->maximumSources.push_back(SOURCE);
+         stage.maximumEnd = this->maximums.size();
+         break;
+
+      case NODEAVERAGE:
+         node.slot = this->averages.size();
+         this->averages.push_back(
+            ExponentialAverage(node.periods, node.smoothing));
+         this->averageSources.push_back(SOURCE);
+         stage.averageEnd = this->averages.size();
+         break;
+
+      case NODEDIFFERENCE:
+         node.slot            = NUMINPUTS + this->differences.size();
+         difference.first     = SOURCE;
+         difference.second    = this->nodes[node.second].slot;
+         difference.valueSlot = node.slot;
+         this->differences.push_back(difference);
+         stage.differenceEnd = this->differences.size();
+         break;
+
+      case NUMNODEKINDS:
+         break;
+      }
+   }
+
+   this->stages.push_back(stage);
+
+   // Size the values to the inputs and differences, and reset
+   this->values.assign(NUMINPUTS + this->differences.size(), 0.0);
+   this->valuesKnown.assign(this->values.size(), 0);
+   this->reset();
+}
+
+//******************************************************************************
+// Function : findIndicator
+// Process  : Compare the name with each indicator's
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int IndicatorEngine::findIndicator(const string& indicatorName) const
+{
+   for (int indicatorIndex = 0; indicatorIndex < this->getNumIndicators();
+        ++indicatorIndex)
+   {
+      if (this->indicators[indicatorIndex].name == indicatorName)
+      {
+         return indicatorIndex;
+      }
+   }
+
+   return -1;
+}
+
+//******************************************************************************
+// Function : getValue
+// Process  : NaN until the indicator's nodes have enough bars
+//             Derive the indicator from its nodes:
+//                SMA           sum / N
+//                EMA, ATR,     the average
+//                signal
+//                RSI           100 - 100 / (1 + average gain / average loss)
+//                stochastic    100 x (close - lowest low) / range
+//                Bollinger     SMA +- deviations x standard deviation
+//                high, low     the maximum, or the negated maximum
+//                MACD          the difference, fast EMA - slow EMA
+// Notes    : Throws an out_of_range exception for invalid index
+//             An RSI with no losses, or a stochastic with no range, is 100
+//                or MIDDLEVALUE, rather than a division by 0
+//             The Bollinger variance is the window's mean square less its
+//                squared mean, clamped at 0 against rounding
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+double IndicatorEngine::getValue(const int indicatorIndex) const
+{
+   const double NOTKNOWN = numeric_limits<double>::quiet_NaN();
+
+   const Indicator& indicator = this->indicators.at(indicatorIndex);
+   const int        FIRST     = this->nodes[indicator.first].slot;
+   const int        SECOND    = (-1 == indicator.second) ? -1 :
+                                this->nodes[indicator.second].slot;
+
+   switch (indicator.kind)
+   {
+   case KINDSMA:
+   {
+      const RollingSum& sum = this->sums[FIRST]; // Of the closes
+
+      return sum.isFull() ? sum.getSum() / indicator.periods : NOTKNOWN;
+   }
+
+   case KINDEMA:
+   case KINDATR:
+   case KINDSIGNAL:
+   {
+      const ExponentialAverage& average = this->averages[FIRST];
+
+      return average.isReady() ? average.getAverage() : NOTKNOWN;
+   }
+
+   case KINDRSI:
+   {
+      const ExponentialAverage& gains  = this->averages[FIRST];
+      const ExponentialAverage& losses = this->averages[SECOND];
+
+      if (!gains.isReady() || !losses.isReady())
+      {
+         return NOTKNOWN;
+      }
+
+      if (0.0 == losses.getAverage())
+      {
+         return (0.0 == gains.getAverage()) ? MIDDLEVALUE : PERCENT;
+      }
+
+      return PERCENT -
+             PERCENT / (1.0 + gains.getAverage() / losses.getAverage());
+   }
+
+   case KINDSTOCHASTIC:
+   {
+      const RollingMaximum& highs = this->maximums[FIRST];
+      const RollingMaximum& lows  = this->maximums[SECOND];
+
+      if (!highs.isFull() || !lows.isFull())
+      {
+         return NOTKNOWN;
+      }
+
+      double range = highs.getMaximum() + lows.getMaximum(); // High - low
+
+      if (range <= 0.0)
+      {
+         return MIDDLEVALUE;
+      }
+
+      return PERCENT * (this->lastClose + lows.getMaximum()) / range;
+   }
+
+   case KINDBOLLINGERUPPER:
+   case KINDBOLLINGERLOWER:
+   {
+      const RollingSum& sum = this->sums[FIRST]; // Of the closes
+
+      if (!sum.isFull())
+      {
+         return NOTKNOWN;
+      }
+
+      double mean     = sum.getSum() / indicator.periods;
+      double variance = max(
+         sum.getSumSquares() / indicator.periods - mean * mean, 0.0);
+      double width    = BOLLINGERDEVIATIONS * sqrt(variance);
+
+      return (KINDBOLLINGERUPPER == indicator.kind) ? mean + width :
+                                                      mean - width;
+   }
+
+   case KINDHIGH:
+   case KINDLOW:
+   {
+      const RollingMaximum& maximum = this->maximums[FIRST];
+
+      if (!maximum.isFull())
+      {
+         return NOTKNOWN;
+      }
+
+      return (KINDHIGH == indicator.kind) ? maximum.getMaximum() :
+                                            -maximum.getMaximum();
+   }
+
+   case KINDMACD:
+      return this->valuesKnown[FIRST] ? this->values[FIRST] : NOTKNOWN;
+   }
+
+   return NOTKNOWN;
+}
+
+//******************************************************************************
+// Function : isIndicatorName
+// Process  : Parse the name
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool IndicatorEngine::isIndicatorName(const string& indicatorName)
+{
+   IndicatorKind kind = KINDSMA; // Parsed
+   vector<int>   periods;        // Parsed
+
+   return IndicatorEngine::parseIndicatorName(indicatorName, kind, periods);
+}
+
+//******************************************************************************
+// Function : parseIndicatorName
+// Process  : Find the kind whose prefix the name starts with
+//             Parse the periods after it, separated by PERIODSEPARATOR, each
+//                at most MAXPERIODDIGITS digits, not all 0
+//             macd and signal without periods have the default periods
+// Notes    : Returns false if the name isn't an indicator
+//             No prefix is the start of another, so at most one matches
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added macdF_S and signalF_S_P
+//******************************************************************************
+bool IndicatorEngine::parseIndicatorName(
+   const string&  indicatorName,
+   IndicatorKind& kind,
+   vector<int>&   periods)
+{
+   for (int kindIndex = 0; kindIndex < NUMKINDPREFIXES; ++kindIndex)
+   {
+      const string PREFIX = KINDPREFIXES[kindIndex]; // Of the kind
+
+      if (0 != indicatorName.compare(0, PREFIX.size(), PREFIX))
+      {
+         continue;
+      }
+
+      kind = IndicatorKind(kindIndex);
+      periods.clear();
+
+      // Parse the periods after it
+      size_t position = PREFIX.size(); // In the name
+
+      while (position < indicatorName.size())
+      {
+         int numDigits = 0; // Of the period
+
+         if (!periods.empty() &&
+             PERIODSEPARATOR != indicatorName[position++])
+         {
+            return false;
+         }
+
+         periods.push_back(0);
+
+         while (position < indicatorName.size() &&
+                isdigit((unsigned char)indicatorName[position]) &&
+                numDigits < MAXPERIODDIGITS)
+         {
+            periods.back() =
+               periods.back() * 10 + (indicatorName[position++] - '0');
+            ++numDigits;
+         }
+
+         if (0 == periods.back() ||
+             (position < indicatorName.size() &&
+              PERIODSEPARATOR != indicatorName[position]))
+         {
+            return false;
+         }
+      }
+
+      // macd and signal without periods have the default periods
+      if (periods.empty() && KINDNUMPERIODS[kindIndex] > 1)
+      {
+         periods.resize(KINDNUMPERIODS[kindIndex]);
+         periods[0] = StockAnalyzer::DEFAULTFASTPERIODS;
+         periods[1] = StockAnalyzer::DEFAULTSLOWPERIODS;
+
+         if (KINDSIGNAL == kind)
+         {
+            periods[2] = IndicatorEngine::DEFAULTSIGNALPERIODS;
+         }
+      }
+
+      return int(periods.size()) == KINDNUMPERIODS[kindIndex];
+   }
+
+   return false;
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Reset every primitive, and forget the differences
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+void IndicatorEngine::reset()
+{
+   for (size_t averageIndex = 0; averageIndex < this->averages.size();
+        ++averageIndex)
+   {
+      this->averages[averageIndex].reset();
+   }
+
+   for (size_t maximumIndex = 0; maximumIndex < this->maximums.size();
+        ++maximumIndex)
+   {
+      this->maximums[maximumIndex].reset();
+   }
+
+   for (size_t sumIndex = 0; sumIndex < this->sums.size(); ++sumIndex)
+   {
+      this->sums[sumIndex].reset();
+   }
+
+   fill(this->valuesKnown.begin(), this->valuesKnown.end(), 0);
+   this->lastClose = 0.0;
+   this->numBars   = 0;
+}
+
+//******************************************************************************
+// Function : run
+// Process  : Reset
+//             Update with each bar, the closes standing in for missing
+//                highs and lows
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void IndicatorEngine::run(
+   const double* closes,
+   const double* highs,
+   const double* lows,
+   const int     numBars)
+{
+   const double* HIGHS = (NULL == highs) ? closes : highs; // Or the closes
+   const double* LOWS  = (NULL == lows) ? closes : lows;   // Or the closes
+
+   this->reset();
+
+   for (int barIndex = 0; barIndex < numBars; ++barIndex)
+   {
+      this->update(closes[barIndex], HIGHS[barIndex], LOWS[barIndex]);
+   }
+}
+
+//******************************************************************************
+// Function : update
+// Process  : Derive the bar's inputs
+//                The gain, loss, and the previous close's part of the true
+//                range need a previous bar, the first bar's gain and loss
+//                aren't known
+//             Sweep each stage, a level of the graph
+//                Feed each primitive its source, if known
+//                Take each difference, known once both averages are ready
+// Notes    : The first bar's true range is its high less its low
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+void IndicatorEngine::update(
+   const double close,
+   const double high,
+   const double low)
+{
+   double* values          = this->values.data();      // Inputs first
+   char*   known           = this->valuesKnown.data(); // Can each be fed?
+   int     sumIndex        = 0;                        // Next to feed
+   int     maximumIndex    = 0;                        // Next to feed
+   int     averageIndex    = 0;                        // Next to feed
+   int     differenceIndex = 0;                        // Next to take
+
+   // Derive the bar's inputs
+   values[INPUTCLOSE]      = close;
+   values[INPUTHIGH]       = high;
+   values[INPUTLOW]        = low;
+   values[INPUTNEGATEDLOW] = -low;
+   values[INPUTTRUERANGE]  = high - low;
+   values[INPUTGAIN]       = 0.0;
+   values[INPUTLOSS]       = 0.0;
+   fill(known, known + NUMINPUTS, 1);
+
+   if (this->numBars > 0)
+   {
+      double change = close - this->lastClose; // Since the previous bar
+
+      values[INPUTGAIN]      = max(change, 0.0);
+      values[INPUTLOSS]      = max(-change, 0.0);
+      values[INPUTTRUERANGE] = max(values[INPUTTRUERANGE],
+                                   max(fabs(high - this->lastClose),
+                                       fabs(low - this->lastClose)));
+   }
+   else
+   {
+      known[INPUTGAIN] = 0;
+      known[INPUTLOSS] = 0;
+   }
+
+   // Sweep each stage, a level of the graph
+   for (size_t stageIndex = 0; stageIndex < this->stages.size();
+        ++stageIndex)
+   {
+      const Stage& stage = this->stages[stageIndex];
+
+      // Feed each primitive its source, if known
+      for (; sumIndex < stage.sumEnd; ++sumIndex)
+      {
+         const int SOURCE = this->sumSources[sumIndex];
+
+         if (known[SOURCE])
+         {
+            this->sums[sumIndex].add(values[SOURCE]);
+         }
+      }
+
+      for (; maximumIndex < stage.maximumEnd; ++maximumIndex)
+      {
+         const int SOURCE = this->maximumSources[maximumIndex];
+
+         if (known[SOURCE])
+         {
+            this->maximums[maximumIndex].add(values[SOURCE]);
+         }
+      }
+
+      for (; averageIndex < stage.averageEnd; ++averageIndex)
+      {
+         const int SOURCE = this->averageSources[averageIndex];
+
+         if (known[SOURCE])
+         {
+            this->averages[averageIndex].add(values[SOURCE]);
+         }
+      }
+
+      // Take each difference, known once both averages are ready
+      for (; differenceIndex < stage.differenceEnd; ++differenceIndex)
+      {
+         const Difference&         difference =
+            this->differences[differenceIndex];
+         const ExponentialAverage& first      =
+            this->averages[difference.first];
+         const ExponentialAverage& second     =
+            this->averages[difference.second];
+
+         known[difference.valueSlot] = first.isReady() && second.isReady();
+         values[difference.valueSlot] =
+            first.getAverage() - second.getAverage();
+      }
+   }
+
+   this->lastClose = close;
+   ++this->numBars;
+}
@@ -0,0 +1,484 @@
+//******************************************************************************
+//
+// File Name:     IndicatorEngine.h
+//
+// File Overview: Represents an IndicatorEngine
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the dependency graph
+//******************************************************************************
+
+#ifndef IndicatorEngine_h
+#define IndicatorEngine_h
+
+#include <string>
+#include <vector>
+
+#include "IndicatorPrimitives.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    IndicatorEngine
+//
+// Overview: Computes any set of indicators of a stock in one pass over its
+//             bars, oldest first
+//             Each indicator is named by its kind and its periods N:
+//                smaN          simple moving average of the closes
+//                emaN          exponential moving average of the closes
+//                rsiN          relative strength index, Wilder smoothed
+//                atrN          average true range, Wilder smoothed
+//                stochN        stochastic %K, the close in the N bar range
+//                bbupperN,     Bollinger bands, the SMA plus or minus
+//                bblowerN         two standard deviations
+//                highN, lowN   highest high and lowest low of N bars
+//                macdF_S       EMA F less EMA S of the closes
+//                signalF_S_P   EMA P of macdF_S
+//             and macd and signal have StockAnalyzer's default periods and
+//                DEFAULTSIGNALPERIODS, macd matching its MACD bit for bit
+//             The indicators are declared with addIndicator, and built
+//                into a graph of nodes:
+//                inputs        of the bar: the close, high, low, the close's
+//                                 gain or loss, or the true range
+//                primitives    of IndicatorPrimitives.h, each fed by an
+//                                 input or a difference
+//                differences   of two EMAs, the MACD lines
+//             Identical nodes, the same primitive of the same periods on the
+//                same source, are shared by every indicator needing them,
+//                such as the EMA 12 of macd, signal, and macd12_50, or the
+//                rolling sum of sma20 and the Bollinger bands
+//             The graph is ordered by depth, then by kind and source, so
+//                update feeds each level's nodes in one sweep of contiguous
+//                primitives, and a pass costs one loop over the bars however
+//                many indicators there are
+//             getValue derives an indicator from its nodes, only when it is
+//                read
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the dependency graph
+//
+//******************************************************************************
+class IndicatorEngine
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No indicators and no bars, sharing nodes
+   // Constraints : None
+   //***************************************************************************
+   IndicatorEngine();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~IndicatorEngine();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addIndicator
+   // Description : Adds the named indicator, with no bars, retrieving its
+   //                index, or the index it already has when sharing
+   // Constraints : Throws an exception if the name isn't an indicator
+   //                Call before update, or reset after
+   //***************************************************************************
+   int addIndicator(const string& indicatorName);
+
+   //***************************************************************************
+   // Function    : findIndicator
+   // Description : Retrieves the index of the named indicator
+   //                Returns -1 if it hasn't been added
+   // Constraints : None
+   //***************************************************************************
+   int findIndicator(const string& indicatorName) const;
+
+   //***************************************************************************
+   // Function    : getIndicatorName
+   // Description : Retrieves the name of the indicator at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const string& getIndicatorName(const int indicatorIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumBars
+   // Description : Retrieves the bars updated since the last reset
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumBars() const;
+
+   //***************************************************************************
+   // Function    : getNumIndicators
+   // Description : Retrieves the number of indicators
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumIndicators() const;
+
+   //***************************************************************************
+   // Function    : getNumNodes
+   // Description : Retrieves the number of primitives and differences in
+   //                the graph
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumNodes() const;
+
+   //***************************************************************************
+   // Function    : getNumNodesEliminated
+   // Description : Retrieves the number of nodes the indicators asked for
+   //                that were shared with a node already in the graph
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumNodesEliminated() const;
+
+   //***************************************************************************
+   // Function    : getNumPrimitives
+   // Description : Retrieves the number of primitives updated per bar
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumPrimitives() const;
+
+   //***************************************************************************
+   // Function    : getValue
+   // Description : Retrieves the indicator at the index, as of the newest
+   //                bar
+   //                NaN until there are enough bars
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   double getValue(const int indicatorIndex) const;
+
+   //***************************************************************************
+   // Function    : isIndicatorName
+   // Description : Is the name one addIndicator accepts?
+   // Constraints : None
+   //***************************************************************************
+   static bool isIndicatorName(const string& indicatorName);
+
+   //***************************************************************************
+   // Function    : isSharing
+   // Description : Are identical nodes and indicators shared?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isSharing() const;
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Forgets the bars, keeping the indicators
+   // Constraints : None
+   //***************************************************************************
+   void reset();
+
+   //***************************************************************************
+   // Function    : run
+   // Description : Resets, then updates with each of numBars bars, oldest
+   //                first
+   //                NULL highs and lows are taken to be the closes
+   // Constraints : None
+   //***************************************************************************
+   void run(
+      const double* closes,
+      const double* highs,
+      const double* lows,
+      const int numBars);
+
+   //***************************************************************************
+   // Function    : setSharing
+   // Description : Shares identical nodes and indicators, or gives every
+   //                indicator nodes of its own, as computing each on its
+   //                own would
+   // Constraints : Applies to the indicators added after
+   //***************************************************************************
+   inline void setSharing(const bool sharing);
+
+   //***************************************************************************
+   // Function    : update
+   // Description : Adds the newest bar to every indicator
+   // Constraints : None
+   //***************************************************************************
+   void update(
+      const double close,
+      const double high,
+      const double low);
+
+   static const int DEFAULTSIGNALPERIODS = 9; // EMA periods of signal
+
+private:
+   // Kinds of indicator
+   enum IndicatorKind
+   {
+      KINDSMA,
+      KINDEMA,
+      KINDRSI,
+      KINDATR,
+      KINDSTOCHASTIC,
+      KINDBOLLINGERUPPER,
+      KINDBOLLINGERLOWER,
+      KINDHIGH,
+      KINDLOW,
+      KINDMACD,
+      KINDSIGNAL
+   };
+
+   // Inputs of a bar, the graph's first nodes
+   enum BarInput
+   {
+      INPUTCLOSE,
+      INPUTHIGH,
+      INPUTLOW,
+      INPUTNEGATEDLOW,    // Whose rolling maximum is the lowest low
+      INPUTGAIN,          // Rise of the close, or 0, from the second bar
+      INPUTLOSS,          // Fall of the close, or 0, from the second bar
+      INPUTTRUERANGE,     // High less low, widened to the previous close
+      NUMINPUTS
+   };
+
+   // Kinds of node, in the order each level is updated
+   enum NodeKind
+   {
+      NODEINPUT,
+      NODESUM,
+      NODEMAXIMUM,
+      NODEAVERAGE,
+      NODEDIFFERENCE,
+      NUMNODEKINDS
+   };
+
+   // One node of the graph
+   struct Node
+   {
+      NodeKind kind;        // What it is
+      int      source;      // Node feeding it, the first of a difference
+      int      second;      // Node subtracted by a difference, or -1
+      int      periods;     // Of a primitive
+      double   smoothing;   // Of an average
+      bool     keepSquares; // Of a sum, by any indicator sharing it
+      int      level;       // One deeper than its deepest source
+      int      slot;        // Index in the vector of its kind, or in
+                            // values for an input or a difference
+   };
+
+   // A difference of two averages, by slot
+   struct Difference
+   {
+      int first;     // Average
+      int second;    // Average subtracted
+      int valueSlot; // In values
+   };
+
+   // Ends, in the vector of each kind, of the nodes up to a level
+   struct Stage
+   {
+      int sumEnd;
+      int maximumEnd;
+      int averageEnd;
+      int differenceEnd;
+   };
+
+   // One indicator, and the nodes it is derived from
+   struct Indicator
+   {
+      string        name;    // As added
+      IndicatorKind kind;    // What it is
+      int           periods; // Its N
+      int           first;   // Its first node
+      int           second;  // Its second node, or -1
+   };
+
+   //***************************************************************************
+   // Function    : addAverage, addDifference, addMaximum, addSum
+   // Description : Adds a node of the kind, retrieving its index
+   // Constraints : None
+   //***************************************************************************
+   int addAverage(
+      const int source,
+      const int periods,
+      const double smoothing);
+   int addDifference(
+      const int first,
+      const int second);
+   int addMaximum(
+      const int source,
+      const int periods);
+   int addSum(
+      const int source,
+      const int periods,
+      const bool keepSquares);
+
+   //***************************************************************************
+   // Function    : addNode
+   // Description : Adds the node, retrieving its index, or the index of the
+   //                identical node already in the graph when sharing
+   // Constraints : None
+   //***************************************************************************
+   int addNode(const Node& node);
+
+   //***************************************************************************
+   // Function    : compile
+   // Description : Orders the nodes into the primitives, differences, and
+   //                stages update sweeps
+   // Constraints : None
+   //***************************************************************************
+   void compile();
+
+   //***************************************************************************
+   // Function    : parseIndicatorName
+   // Description : Retrieves the kind and periods of the named indicator
+   //                Returns false if the name isn't an indicator
+   // Constraints : None
+   //***************************************************************************
+   static bool parseIndicatorName(
+      const string& indicatorName,
+      IndicatorKind& kind,
+      vector<int>& periods);
+
+   vector<int>                averageSources;    // Value slot of each
+   vector<ExponentialAverage> averages;          // EMAs and Wilder averages
+   vector<Difference>         differences;       // MACD lines
+   vector<Indicator>          indicators;        // In the order added
+   double                     lastClose;         // Of the newest bar
+   vector<int>                maximumSources;    // Value slot of each
+   vector<RollingMaximum>     maximums;          // Rolling highs and lows
+   vector<Node>               nodes;             // The graph, inputs first
+   int                        numBars;           // Since the last reset
+   int                        numNodesRequested; // By the indicators
+   bool                       sharing;           // Share identical nodes?
+   vector<Stage>              stages;            // Of each level
+   vector<int>                sumSources;        // Value slot of each
+   vector<RollingSum>         sums;              // Rolling sums
+   vector<double>             values;            // Of each input and
+                                                 // difference
+   vector<char>               valuesKnown;       // Can each be fed?
+}; // end class IndicatorEngine
+
+//******************************************************************************
+// Function : getIndicatorName
+// Process  : Retrieve the name of the indicator
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& IndicatorEngine::getIndicatorName(
+   const int indicatorIndex) const
+{
+   return this->indicators.at(indicatorIndex).name;
+}
+
+//******************************************************************************
+// Function : getNumBars
+// Process  : Accessor for numBars
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int IndicatorEngine::getNumBars() const
+{
+   return this->numBars;
+}
+
+//******************************************************************************
+// Function : getNumIndicators
+// Process  : Retrieve the number of indicators
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int IndicatorEngine::getNumIndicators() const
+{
+   return this->indicators.size();
+}
+
+//******************************************************************************
+// Function : getNumNodes
+// Process  : The nodes that aren't inputs
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int IndicatorEngine::getNumNodes() const
+{
+   return this->nodes.size() - NUMINPUTS;
+}
+
+//******************************************************************************
+// Function : getNumNodesEliminated
+// Process  : The nodes requested less the nodes added
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int IndicatorEngine::getNumNodesEliminated() const
+{
+   return this->numNodesRequested - this->getNumNodes();
+}
+
+//******************************************************************************
+// Function : getNumPrimitives
+// Process  : The averages, maximums, and sums
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int IndicatorEngine::getNumPrimitives() const
+{
+   return this->averages.size() + this->maximums.size() + this->sums.size();
+}
+
+//******************************************************************************
+// Function : isSharing
+// Process  : Accessor for sharing
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool IndicatorEngine::isSharing() const
+{
+   return this->sharing;
+}
+
+//******************************************************************************
+// Function : setSharing
+// Process  : Mutator for sharing
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void IndicatorEngine::setSharing(const bool sharing)
+{
+   this->sharing = sharing;
+}
+
+#endif // IndicatorEngine_h
@@ -0,0 +1,491 @@
+//******************************************************************************
+//
+// File Name:     IndicatorPrimitives.h
+//
+// File Overview: Streaming rolling window primitives indicators are built on
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added primitives
+// 10.19.26       Donne Martin         ExponentialAverage getState and setState
+//******************************************************************************
+
+#ifndef IndicatorPrimitives_h
+#define IndicatorPrimitives_h
+
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Overview: Each primitive takes one value per bar, oldest first, in O(1)
+//             amortized time and O(periods) memory, and can be read after
+//             any bar:
+//                RollingSum          - sum, and optionally sum of squares,
+//                                         of the newest periods values
+//                RollingMaximum      - largest of the newest periods values,
+//                                         a rolling minimum is the maximum of
+//                                         the negated values
+//                ExponentialAverage  - EMA, or Wilder smoothing, seeded with
+//                                         the SMA of the first periods values
+//           IndicatorEngine updates each primitive it needs once per bar and
+//              derives its indicators from them when they are read
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added primitives
+//
+//******************************************************************************
+
+//******************************************************************************
+//
+// Class:    RollingSum
+//
+// Overview: The sum of the newest periods values, and of their squares when
+//             kept, updated by adding the newest value and subtracting the
+//             one leaving the window
+//             The sums are recomputed from the window each time it wraps, so
+//             the rounding of the subtractions doesn't accumulate over a
+//             long series, at an amortized cost of one add per value
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class RollingSum
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty window of periods values, keeping the sum of
+   //                squares if asked
+   // Constraints : periods must be positive
+   //***************************************************************************
+   RollingSum(
+      const int periods,
+      const bool keepSquares)
+      : keepSquares(keepSquares),
+        newestIndex(-1),
+        numValues(0),
+        sum(0.0),
+        sumSquares(0.0),
+        values(periods)
+   {
+   } // end RollingSum::RollingSum
+
+   //***************************************************************************
+   // Function    : add
+   // Description : Adds the newest value, dropping the oldest once full
+   // Constraints : None
+   //***************************************************************************
+   inline void add(const double value)
+   {
+      const int PERIODS = this->getPeriods(); // Values in the window
+
+      if (++this->newestIndex == PERIODS)
+      {
+         this->newestIndex = 0;
+      }
+
+      double& slot = this->values[this->newestIndex]; // Oldest value's
+
+      // Drop the oldest value once full
+      if (this->numValues >= PERIODS)
+      {
+         this->sum -= slot;
+
+         if (this->keepSquares)
+         {
+            this->sumSquares -= slot * slot;
+         }
+      }
+      else
+      {
+         ++this->numValues;
+      }
+
+      slot       = value;
+      this->sum += value;
+
+      if (this->keepSquares)
+      {
+         this->sumSquares += value * value;
+      }
+
+      // Recompute the sums from the window each time it wraps
+      if (PERIODS - 1 == this->newestIndex && this->numValues == PERIODS)
+      {
+         this->sum        = 0.0;
+         this->sumSquares = 0.0;
+
+         for (int valueIndex = 0; valueIndex < PERIODS; ++valueIndex)
+         {
+            this->sum += this->values[valueIndex];
+
+            if (this->keepSquares)
+            {
+               this->sumSquares +=
+                  this->values[valueIndex] * this->values[valueIndex];
+            }
+         }
+      }
+   }
+
+   //***************************************************************************
+   // Function    : getPeriods
+   // Description : Retrieve the number of values in a full window
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriods() const
+   {
+      return this->values.size();
+   }
+
+   //***************************************************************************
+   // Function    : getSum
+   // Description : Retrieve the sum of the values in the window
+   // Constraints : None
+   //***************************************************************************
+   inline double getSum() const
+   {
+      return this->sum;
+   }
+
+   //***************************************************************************
+   // Function    : getSumSquares
+   // Description : Retrieve the sum of the squares of the values in the
+   //                window, 0 unless kept
+   // Constraints : None
+   //***************************************************************************
+   inline double getSumSquares() const
+   {
+      return this->sumSquares;
+   }
+
+   //***************************************************************************
+   // Function    : isFull
+   // Description : Has a whole window of values been added?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isFull() const
+   {
+      return this->numValues == this->getPeriods();
+   }
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Empties the window
+   // Constraints : None
+   //***************************************************************************
+   inline void reset()
+   {
+      this->newestIndex = -1;
+      this->numValues   = 0;
+      this->sum         = 0.0;
+      this->sumSquares  = 0.0;
+   }
+
+private:
+   bool           keepSquares; // Is sumSquares kept?
+   int            newestIndex; // Of the newest value in values
+   int            numValues;   // In the window, at most periods
+   double         sum;         // Of the window
+   double         sumSquares;  // Of the window, when kept
+   vector<double> values;      // The window, sized to the periods once
+}; // end class RollingSum
+
+//******************************************************************************
+//
+// Class:    RollingMaximum
+//
+// Overview: The largest of the newest periods values, from a monotonic deque
+//             The deque holds the values that could still be the maximum,
+//                decreasing from the front, each with its position
+//             A new value pops the smaller values off the back, and the
+//                front leaves once it is out of the window, so each value
+//                is pushed and popped once
+//             The deque is a ring of periods slots, it never holds more
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class RollingMaximum
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty window of periods values
+   // Constraints : periods must be positive
+   //***************************************************************************
+   explicit RollingMaximum(const int periods)
+      : dequeFront(0),
+        dequeSize(0),
+        numValues(0),
+        positions(periods),
+        values(periods)
+   {
+   } // end RollingMaximum::RollingMaximum
+
+   //***************************************************************************
+   // Function    : add
+   // Description : Adds the newest value, dropping the oldest once full
+   // Constraints : None
+   //***************************************************************************
+   inline void add(const double value)
+   {
+      const int PERIODS = this->getPeriods(); // Values in the window
+      int       back    = 0;                  // Slot of the deque's back
+
+      // Drop the front once it is out of the window
+      if (this->dequeSize > 0 &&
+          this->positions[this->dequeFront] <= this->numValues - PERIODS)
+      {
+         this->dequeFront = (this->dequeFront + 1) % PERIODS;
+         --this->dequeSize;
+      }
+
+      // Pop the values the new one is at least as large as off the back
+      while (this->dequeSize > 0)
+      {
+         back = (this->dequeFront + this->dequeSize - 1) % PERIODS;
+
+         if (this->values[back] > value)
+         {
+            break;
+         }
+
+         --this->dequeSize;
+      }
+
+      // Push the value on the back
+      back                  = (this->dequeFront + this->dequeSize) % PERIODS;
+      this->values[back]    = value;
+      this->positions[back] = this->numValues;
+      ++this->dequeSize;
+      ++this->numValues;
+   }
+
+   //***************************************************************************
+   // Function    : getMaximum
+   // Description : Retrieve the largest value in the window
+   // Constraints : At least one value must have been added
+   //***************************************************************************
+   inline double getMaximum() const
+   {
+      return this->values[this->dequeFront];
+   }
+
+   //***************************************************************************
+   // Function    : getPeriods
+   // Description : Retrieve the number of values in a full window
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriods() const
+   {
+      return this->values.size();
+   }
+
+   //***************************************************************************
+   // Function    : isFull
+   // Description : Has a whole window of values been added?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isFull() const
+   {
+      return this->numValues >= this->getPeriods();
+   }
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Empties the window
+   // Constraints : None
+   //***************************************************************************
+   inline void reset()
+   {
+      this->dequeFront = 0;
+      this->dequeSize  = 0;
+      this->numValues  = 0;
+   }
+
+private:
+   int               dequeFront; // Slot of the largest value in the window
+   int               dequeSize;  // Slots in the deque
+   long long         numValues;  // Ever added, the next value's position
+   vector<long long> positions;  // Of each deque slot's value
+   vector<double>    values;     // Of each deque slot
+}; // end class RollingMaximum
+
+//******************************************************************************
+//
+// Class:    ExponentialAverage
+//
+// Overview: An exponential moving average of periods values, seeded with the
+//             SMA of the first periods values, then
+//                average = (value - average) x smoothing + average
+//             getEMASmoothing is 2 / (periods + 1), an EMA computed as
+//                MACDKernel does, bit for bit
+//             getWilderSmoothing is 1 / periods, Wilder's smoothing of RSI
+//                and ATR
+//             getState and setState copy the average and the values counted,
+//                so a restored average continues bit for bit
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added getState and setState
+//
+//******************************************************************************
+class ExponentialAverage
+{
+public:
+
+   //***************************************************************************
+   //
+   // Class:    State
+   //
+   // Overview: The average and values counted of an ExponentialAverage
+   //
+   //***************************************************************************
+   struct State
+   {
+      double average;   // The seed's sum until ready, then the average
+      int    numValues; // Added, counted up to periods
+   }; // end struct State
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No values yet, with the periods and smoothing
+   // Constraints : periods must be positive
+   //***************************************************************************
+   ExponentialAverage(
+      const int periods,
+      const double smoothing)
+      : average(0.0),
+        numValues(0),
+        periods(periods),
+        smoothing(smoothing)
+   {
+   } // end ExponentialAverage::ExponentialAverage
+
+   //***************************************************************************
+   // Function    : add
+   // Description : Adds the newest value
+   // Constraints : None
+   //***************************************************************************
+   inline void add(const double value)
+   {
+      // Average the values after the seed
+      if (this->numValues >= this->periods)
+      {
+         this->average = (value - this->average) * this->smoothing +
+                         this->average;
+         return;
+      }
+
+      // Sum the seed's values, then divide once there are periods of them
+      this->average += value;
+
+      if (++this->numValues == this->periods)
+      {
+         this->average /= this->periods;
+      }
+   }
+
+   //***************************************************************************
+   // Function    : getAverage
+   // Description : Retrieve the average
+   // Constraints : Only meaningful once isReady
+   //***************************************************************************
+   inline double getAverage() const
+   {
+      return this->average;
+   }
+
+   //***************************************************************************
+   // Function    : getEMASmoothing, getWilderSmoothing
+   // Description : Retrieve the smoothing of an EMA, or of Wilder's average,
+   //                of periods values
+   // Constraints : None
+   //***************************************************************************
+   static inline double getEMASmoothing(const int periods)
+   {
+      return 2.0 / (periods + 1.0);
+   }
+
+   static inline double getWilderSmoothing(const int periods)
+   {
+      return 1.0 / periods;
+   }
+
+   //***************************************************************************
+   // Function    : getState
+   // Description : Retrieves the average and the values counted
+   // Constraints : None
+   //***************************************************************************
+   inline void getState(State& state) const
+   {
+      state.average   = this->average;
+      state.numValues = this->numValues;
+   }
+
+   //***************************************************************************
+   // Function    : isReady
+   // Description : Has the seed's periods values been added?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isReady() const
+   {
+      return this->numValues >= this->periods;
+   }
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Forgets every value
+   // Constraints : None
+   //***************************************************************************
+   inline void reset()
+   {
+      this->average   = 0.0;
+      this->numValues = 0;
+   }
+
+   //***************************************************************************
+   // Function    : setState
+   // Description : Replaces the average and the values counted with those of
+   //                state, keeping the periods and smoothing
+   // Constraints : Throws an exception if numValues is outside 0 to periods
+   //***************************************************************************
+   inline void setState(const State& state)
+   {
+      if (state.numValues < 0 || state.numValues > this->periods)
+      {
+         throw exception("Invalid exponential average state");
+      }
+
+      this->average   = state.average;
+      this->numValues = state.numValues;
+   }
+
+private:
+   double average;   // The seed's sum until ready, then the average
+   int    numValues; // Added, counted up to periods
+   int    periods;   // Of the seed
+   double smoothing; // Weight of the newest value
+}; // end class ExponentialAverage
+
+#endif // IndicatorPrimitives_h
@@ -0,0 +1,515 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     LocalSocket.cpp
+//
+// File Overview: Represents a LocalSocket
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Bounded lines, send timeout
+//******************************************************************************
+
+#include "stdafx.h"
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+#include "LocalSocket.h"
+
+#ifdef _WIN32
+#pragma comment(lib, "Ws2_32.lib")
+#else
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const int LISTENBACKLOG = 64; // Pending connections before refusing
+
+#ifdef MSG_NOSIGNAL
+static const int SENDFLAGS = MSG_NOSIGNAL; // No SIGPIPE if the peer is gone
+#else
+static const int SENDFLAGS = 0;
+#endif
+
+//******************************************************************************
+// Function : startupSockets
+// Process  : Start Winsock once per process
+// Notes    : Nothing to do outside of Windows
+//             Throws an exception if Winsock can't be started
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void startupSockets()
+{
+#ifdef _WIN32
+   static bool isStarted = false; // Winsock started?
+   WSADATA     wsaData;           // Winsock details, unused
+
+   if (!isStarted)
+   {
+      if (0 != WSAStartup(MAKEWORD(2, 2), &wsaData))
+      {
+         throw exception("WSAStartup failed");
+      }
+
+      isStarted = true;
+   }
+#endif
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Start closed
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+LocalSocket::LocalSocket()
+   : nativeSocket(LocalSocket::INVALIDSOCKET)
+{
+} // end LocalSocket::LocalSocket
+
+//******************************************************************************
+// Function : destructor
+// Process  : Close the socket
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+LocalSocket::~LocalSocket()
+{
+   this->closeSocket();
+} // end LocalSocket::~LocalSocket
+
+//******************************************************************************
+// Function : acceptConnection
+// Process  : Accept the next pending connection
+//             Hand the accepted socket to connection
+// Notes    : Returns false if there was none
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool LocalSocket::acceptConnection(LocalSocket& connection)
+{
+   NativeSocket accepted = accept(this->nativeSocket, NULL, NULL);
+
+   if (LocalSocket::INVALIDSOCKET == accepted)
+   {
+      return false;
+   }
+
+   connection.closeSocket();
+   connection.nativeSocket = accepted;
+   connection.pendingInput.clear();
+
+   return true;
+}
+
+//******************************************************************************
+// Function : closeSocket
+// Process  : Close the socket, if open
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::closeSocket()
+{
+   if (this->isOpen())
+   {
+#ifdef _WIN32
+      closesocket(this->nativeSocket);
+#else
+      close(this->nativeSocket);
+#endif
+      this->nativeSocket = LocalSocket::INVALIDSOCKET;
+   }
+}
+
+//******************************************************************************
+// Function : connectTo
+// Process  : Create the socket
+//             Connect it to path
+// Notes    : Throws an exception if the connection fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::connectTo(const string& path)
+{
+   sockaddr_un address; // Address of the listening socket
+
+   LocalSocket::makeAddress(path, address);
+   this->openSocket();
+
+   if (0 != connect(
+               this->nativeSocket,
+               reinterpret_cast<sockaddr*>(&address),
+               sizeof(address)))
+   {
+      this->closeSocket();
+      throw exception("Could not connect to the local socket");
+   }
+}
+
+//******************************************************************************
+// Function : listenOn
+// Process  : Remove any stale socket file at path
+//             Create the socket, bind it to path, and listen
+// Notes    : Throws an exception if the socket can't be bound
+//             Any other kind of file at path is kept, so the bind fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Only replaces a socket file
+//******************************************************************************
+void LocalSocket::listenOn(const string& path)
+{
+   sockaddr_un address; // Address to listen on
+
+   LocalSocket::makeAddress(path, address);
+   LocalSocket::removeSocketFile(path);
+   this->openSocket();
+
+   if (0 != bind(
+               this->nativeSocket,
+               reinterpret_cast<sockaddr*>(&address),
+               sizeof(address)) ||
+       0 != listen(this->nativeSocket, LISTENBACKLOG))
+   {
+      this->closeSocket();
+      throw exception("Could not listen on the local socket");
+   }
+}
+
+//******************************************************************************
+// Function : makeAddress
+// Process  : Fill the AF_UNIX address with the path
+// Notes    : Throws an exception if the path is too long
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::makeAddress(
+   const string& path,
+   sockaddr_un& address)
+{
+   memset(&address, 0, sizeof(address));
+   address.sun_family = AF_UNIX;
+
+   if (path.size() >= sizeof(address.sun_path))
+   {
+      throw exception("Local socket path is too long");
+   }
+
+   memcpy(address.sun_path, path.c_str(), path.size());
+}
+
+//******************************************************************************
+// Function : openSocket
+// Process  : Close any previous socket
+//             Create the AF_UNIX stream socket
+// Notes    : Throws an exception if the socket can't be created
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::openSocket()
+{
+   startupSockets();
+   this->closeSocket();
+   this->pendingInput.clear();
+
+   this->nativeSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+
+   if (!this->isOpen())
+   {
+      throw exception("Could not create the local socket");
+   }
+}
+
+//******************************************************************************
+// Function : readLine
+// Process  : Until pendingInput holds a whole line
+//                Receive more input
+//                Return false if the peer closed the connection
+//                Check the line isn't too long
+//             Return the line and keep anything after it
+// Notes    : Throws an exception if the receive fails or the line is longer
+//             than MAXLINEBYTES
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Bounded the line
+//******************************************************************************
+bool LocalSocket::readLine(string& line)
+{
+   char   buffer[LocalSocket::RECEIVEBUFFERSIZE]; // Received input
+   size_t endOfLine = this->pendingInput.find('\n'); // End of the next line
+   int    numBytes  = 0;                          // Bytes received
+
+   // Until pendingInput holds a whole line, receive more input
+   while (string::npos == endOfLine)
+   {
+      numBytes = this->receiveSome(buffer, LocalSocket::RECEIVEBUFFERSIZE);
+
+      if (0 == numBytes)
+      {
+         return false;
+      }
+
+      this->pendingInput.append(buffer, numBytes);
+      endOfLine = this->pendingInput.find('\n');
+
+      // Check the line isn't too long
+      if (min(endOfLine, this->pendingInput.size()) >
+          size_t(LocalSocket::MAXLINEBYTES))
+      {
+         throw exception("Local socket line is too long");
+      }
+   }
+
+   // Return the line and keep anything after it
+   line.assign(this->pendingInput, 0, endOfLine);
+   this->pendingInput.erase(0, endOfLine + 1);
+
+   return true;
+}
+
+//******************************************************************************
+// Function : receiveLines
+// Process  : Receive once
+//             Return false if the peer closed the connection
+//             Move every complete line from pendingInput to lines
+//             Check no line, nor the incomplete line left, is too long
+// Notes    : Throws an exception if the receive fails or a line is longer
+//             than MAXLINEBYTES, so a peer never sending '\n' is dropped
+//             rather than buffered without limit
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Bounded the lines
+//******************************************************************************
+bool LocalSocket::receiveLines(vector<string>& lines)
+{
+   char   buffer[LocalSocket::RECEIVEBUFFERSIZE]; // Received input
+   size_t startOfLine = 0;                        // Start of the next line
+   size_t endOfLine   = 0;                        // End of the next line
+   int    numBytes    = 0;                        // Bytes received
+
+   numBytes = this->receiveSome(buffer, LocalSocket::RECEIVEBUFFERSIZE);
+
+   if (0 == numBytes)
+   {
+      return false;
+   }
+
+   this->pendingInput.append(buffer, numBytes);
+
+   // Move every complete line from pendingInput to lines
+   endOfLine = this->pendingInput.find('\n');
+
+   while (string::npos != endOfLine)
+   {
+      if (endOfLine - startOfLine > size_t(LocalSocket::MAXLINEBYTES))
+      {
+         throw exception("Local socket line is too long");
+      }
+
+      lines.push_back(
+         this->pendingInput.substr(startOfLine, endOfLine - startOfLine));
+      startOfLine = endOfLine + 1;
+      endOfLine   = this->pendingInput.find('\n', startOfLine);
+   }
+
+   this->pendingInput.erase(0, startOfLine);
+
+   if (this->pendingInput.size() > size_t(LocalSocket::MAXLINEBYTES))
+   {
+      throw exception("Local socket line is too long");
+   }
+
+   return true;
+}
+
+//******************************************************************************
+// Function : receiveSome
+// Process  : Receive up to maxBytes
+// Notes    : Returns 0 once the peer closes the connection
+//             Throws an exception if the receive fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int LocalSocket::receiveSome(
+   char* buffer,
+   const int maxBytes)
+{
+   int numBytes = recv(this->nativeSocket, buffer, maxBytes, 0);
+
+   if (numBytes < 0)
+   {
+      throw exception("Local socket receive failed");
+   }
+
+   return numBytes;
+}
+
+//******************************************************************************
+// Function : removeSocketFile
+// Process  : Check the file at path is a socket, without following a link
+//             Remove it
+// Notes    : A missing file is not an error
+//             Windows keeps an AF_UNIX socket file as a reparse point
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Only removes sockets
+//******************************************************************************
+void LocalSocket::removeSocketFile(const string& path)
+{
+#ifdef _WIN32
+   DWORD attributes = GetFileAttributesA(path.c_str()); // Of the file
+
+   // Check the file at path is a socket
+   if (INVALID_FILE_ATTRIBUTES == attributes ||
+       0 == (attributes & FILE_ATTRIBUTE_REPARSE_POINT) ||
+       0 != (attributes & FILE_ATTRIBUTE_DIRECTORY))
+   {
+      return;
+   }
+#else
+   struct stat status; // Of the file, not a link's target
+
+   // Check the file at path is a socket, without following a link
+   if (0 != lstat(path.c_str(), &status) || !S_ISSOCK(status.st_mode))
+   {
+      return;
+   }
+#endif
+
+   remove(path.c_str());
+}
+
+//******************************************************************************
+// Function : sendAll
+// Process  : Send until every byte is sent
+// Notes    : Throws an exception if the send fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::sendAll(
+   const char* data,
+   const int numBytes)
+{
+   int numSent = 0; // Bytes sent so far
+   int sent    = 0; // Bytes sent by one call
+
+   while (numSent < numBytes)
+   {
+      sent = send(this->nativeSocket, data + numSent, numBytes - numSent,
+                  SENDFLAGS);
+
+      if (sent <= 0)
+      {
+         throw exception("Local socket send failed");
+      }
+
+      numSent += sent;
+   }
+}
+
+//******************************************************************************
+// Function : sendLine
+// Process  : Send the line and its '\n' together
+// Notes    : Throws an exception if the send fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::sendLine(const string& line)
+{
+   string terminated = line + '\n'; // Line as sent
+
+   this->sendAll(terminated.data(), terminated.size());
+}
+
+//******************************************************************************
+// Function : setSendTimeout
+// Process  : Set the socket's send timeout
+// Notes    : Winsock takes milliseconds, POSIX a timeval
+//             Throws an exception if the socket rejects it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void LocalSocket::setSendTimeout(const int timeoutMillis)
+{
+#ifdef _WIN32
+   DWORD   timeout = DWORD(timeoutMillis); // Longest wait of a send
+#else
+   timeval timeout;                        // Longest wait of a send
+
+   timeout.tv_sec  = timeoutMillis / 1000;
+   timeout.tv_usec = (timeoutMillis % 1000) * 1000;
+#endif
+
+   if (0 != setsockopt(
+               this->nativeSocket,
+               SOL_SOCKET,
+               SO_SNDTIMEO,
+               reinterpret_cast<const char*>(&timeout),
+               sizeof(timeout)))
+   {
+      throw exception("Could not set the local socket send timeout");
+   }
+}
\ No newline at end of file
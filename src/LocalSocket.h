@@ -0,0 +1,244 @@
+//******************************************************************************
+//
+// File Name:     LocalSocket.h
+//
+// File Overview: Represents a LocalSocket
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Bounded lines, send timeout
+//******************************************************************************
+
+#ifndef LocalSocket_h
+#define LocalSocket_h
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    LocalSocket
+//
+// Overview: A stream socket in the Unix domain (AF_UNIX), addressed by a
+//             file system path, for processes on the same machine
+//             Windows 10 and later support AF_UNIX through Winsock
+//             Lines are terminated by '\n' and at most MAXLINEBYTES long
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Bounded lines, send timeout
+//
+//******************************************************************************
+class LocalSocket
+{
+public:
+#ifdef _WIN32
+   typedef SOCKET NativeSocket;                       // Winsock handle
+   static const NativeSocket INVALIDSOCKET = INVALID_SOCKET;
+#else
+   typedef int NativeSocket;                          // File descriptor
+   static const NativeSocket INVALIDSOCKET = -1;
+#endif
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Creates a closed socket
+   // Constraints : None
+   //***************************************************************************
+   LocalSocket();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Closes the socket
+   // Constraints : None
+   //***************************************************************************
+   virtual ~LocalSocket();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : acceptConnection
+   // Description : Accepts a pending connection into connection
+   //                Returns false if there was none
+   // Constraints : Call listenOn first
+   //***************************************************************************
+   bool acceptConnection(LocalSocket& connection);
+
+   //***************************************************************************
+   // Function    : closeSocket
+   // Description : Closes the socket, if open
+   // Constraints : None
+   //***************************************************************************
+   void closeSocket();
+
+   //***************************************************************************
+   // Function    : connectTo
+   // Description : Connects to the socket listening on path
+   // Constraints : Throws an exception if the connection fails
+   //***************************************************************************
+   void connectTo(const string& path);
+
+   //***************************************************************************
+   // Function    : getNativeSocket
+   // Description : Accessor for nativeSocket, for select
+   // Constraints : None
+   //***************************************************************************
+   inline NativeSocket getNativeSocket() const;
+
+   //***************************************************************************
+   // Function    : isOpen
+   // Description : Is the socket open?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isOpen() const;
+
+   //***************************************************************************
+   // Function    : listenOn
+   // Description : Listens for connections on path, replacing any stale
+   //                socket file left there
+   // Constraints : Throws an exception if the socket can't be bound, which
+   //                includes path naming a file that is not a socket
+   //***************************************************************************
+   void listenOn(const string& path);
+
+   //***************************************************************************
+   // Function    : readLine
+   // Description : Reads the next line, without its '\n'
+   //                Returns false once the peer closes the connection
+   // Constraints : Throws an exception if the receive fails or the line is
+   //                longer than MAXLINEBYTES
+   //***************************************************************************
+   bool readLine(string& line);
+
+   //***************************************************************************
+   // Function    : receiveLines
+   // Description : Receives what is available without waiting for more
+   //                Adds every complete line to lines, without its '\n'
+   //                Returns false once the peer closes the connection
+   //                For servers multiplexing connections with select
+   // Constraints : Throws an exception if the receive fails or a line is
+   //                longer than MAXLINEBYTES
+   //***************************************************************************
+   bool receiveLines(vector<string>& lines);
+
+   //***************************************************************************
+   // Function    : receiveSome
+   // Description : Receives up to maxBytes that are available
+   //                Returns 0 once the peer closes the connection
+   // Constraints : Throws an exception if the receive fails
+   //***************************************************************************
+   int receiveSome(
+      char* buffer,
+      const int maxBytes);
+
+   //***************************************************************************
+   // Function    : removeSocketFile
+   // Description : Removes the socket file at path, if any
+   // Constraints : Any other kind of file at path is left alone
+   //***************************************************************************
+   static void removeSocketFile(const string& path);
+
+   //***************************************************************************
+   // Function    : sendAll
+   // Description : Sends all numBytes of data
+   // Constraints : Throws an exception if the send fails
+   //***************************************************************************
+   void sendAll(
+      const char* data,
+      const int numBytes);
+
+   //***************************************************************************
+   // Function    : sendLine
+   // Description : Sends line followed by '\n'
+   // Constraints : Throws an exception if the send fails
+   //***************************************************************************
+   void sendLine(const string& line);
+
+   //***************************************************************************
+   // Function    : setSendTimeout
+   // Description : Fails any send that waits more than timeoutMillis for the
+   //                peer to read, so a stalled peer can't block the sender
+   // Constraints : Call once connected, throws an exception if the socket
+   //                rejects the timeout
+   //***************************************************************************
+   void setSendTimeout(const int timeoutMillis);
+
+   static const int RECEIVEBUFFERSIZE = 4096;  // Bytes read at a time
+   static const int MAXLINEBYTES      = 65536; // Longest line received
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : A socket has a single owner, not implemented
+   // Constraints : None
+   //***************************************************************************
+   LocalSocket(const LocalSocket&);
+   LocalSocket& operator=(const LocalSocket&);
+
+   //***************************************************************************
+   // Function    : makeAddress
+   // Description : Fills the AF_UNIX address for path
+   // Constraints : Throws an exception if the path is too long
+   //***************************************************************************
+   static void makeAddress(
+      const string& path,
+      sockaddr_un& address);
+
+   //***************************************************************************
+   // Function    : openSocket
+   // Description : Creates the AF_UNIX stream socket
+   // Constraints : Throws an exception if the socket can't be created
+   //***************************************************************************
+   void openSocket();
+
+   NativeSocket nativeSocket;  // Socket handle or descriptor
+   string       pendingInput;  // Received but not yet returned by readLine
+}; // end class LocalSocket
+
+//******************************************************************************
+// Function : getNativeSocket
+// Process  : Accessor for nativeSocket
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline LocalSocket::NativeSocket LocalSocket::getNativeSocket() const
+{
+   return this->nativeSocket;
+}
+
+//******************************************************************************
+// Function : isOpen
+// Process  : Is the socket open?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool LocalSocket::isOpen() const
+{
+   return LocalSocket::INVALIDSOCKET != this->nativeSocket;
+}
+
+#endif // LocalSocket_h
\ No newline at end of file
@@ -0,0 +1,180 @@
+//******************************************************************************
+//
+// File Name:     MACDKernel.h
+//
+// File Overview: SMA, EMA, and MACD kernels templated on a price policy
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef MACDKernel_h
+#define MACDKernel_h
+
+#include "PricePolicy.h"
+
+//******************************************************************************
+//
+// Class:    MACDKernel
+//
+// Overview: The calculations behind StockAnalyzer, working directly on the
+//             stored prices of a BasicStock
+//             PricePolicy decides the storage and accumulation types
+//             With DoublePricePolicy the results match StockAnalyzer's
+//             original calculations bit for bit
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+template <class PricePolicy>
+class MACDKernel
+{
+public:
+   typedef typename PricePolicy::StorageType StorageType;
+   typedef typename PricePolicy::AccumType   AccumType;
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : calculateEMA
+   // Description : Calculates the EMAs of the period into emas
+   //                emas[0] is the first period SMA, emas[i] is the EMA of
+   //                the price at index period - 1 + i
+   //                Returns the number of EMAs, numPrices - period + 1
+   //                Sets lastEMA, if given, to the newest EMA before it is
+   //                converted to storage, to continue the EMAs from
+   // Constraints : emas must hold numPrices - period + 1 values
+   //                numPrices must be at least period
+   //***************************************************************************
+   static inline int calculateEMA(
+      const StorageType* prices,
+      const int numPrices,
+      const int period,
+      const AccumType firstPeriodSMA,
+      const AccumType multEMA,
+      StorageType* emas,
+      AccumType* lastEMA = NULL);
+
+   //***************************************************************************
+   // Function    : calculateFirstPeriodSMA
+   // Description : Calculates the SMA of the first period prices
+   // Constraints : prices must hold at least period values
+   //***************************************************************************
+   static inline AccumType calculateFirstPeriodSMA(
+      const StorageType* prices,
+      const int period);
+
+   //***************************************************************************
+   // Function    : calculateMultEMA
+   // Description : Calculates the EMA multiplier of the period
+   // Constraints : None
+   //***************************************************************************
+   static inline AccumType calculateMultEMA(const int period);
+}; // end class MACDKernel
+
+//******************************************************************************
+// Function : calculateEMA
+// Process  : EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)
+//             The first EMA is the input SMA
+//             Loop through the remaining prices
+//                Calculate the EMA in the accumulation type
+//                Store the EMA in the storage type
+//             Keep the newest EMA, if asked
+// Notes    : The running EMA is kept in the accumulation type so the storage
+//             rounding does not compound
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Returns the unrounded newest EMA
+//******************************************************************************
+template <class PricePolicy>
+inline int MACDKernel<PricePolicy>::calculateEMA(
+   const StorageType* prices,
+   const int numPrices,
+   const int period,
+   const AccumType firstPeriodSMA,
+   const AccumType multEMA,
+   StorageType* emas,
+   AccumType* lastEMA)
+{
+   AccumType currentEMA = firstPeriodSMA; // Today's EMA
+   int       numEMAs    = 1;              // Number of EMAs stored
+
+   // The first EMA is the input SMA
+   emas[0] = PricePolicy::toStorage(currentEMA);
+
+   // Loop through the remaining prices
+   for (int priceIndex = period; priceIndex < numPrices; ++priceIndex)
+   {
+      currentEMA =
+         (PricePolicy::toAccum(prices[priceIndex]) - currentEMA) * multEMA +
+         currentEMA;
+
+      emas[numEMAs++] = PricePolicy::toStorage(currentEMA);
+   }
+
+   // Keep the newest EMA, if asked
+   if (NULL != lastEMA)
+   {
+      *lastEMA = currentEMA;
+   }
+
+   return numEMAs;
+}
+
+//******************************************************************************
+// Function : calculateFirstPeriodSMA
+// Process  : SMA: period sum / number of periods
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline typename MACDKernel<PricePolicy>::AccumType
+   MACDKernel<PricePolicy>::calculateFirstPeriodSMA(
+      const StorageType* prices,
+      const int period)
+{
+   AccumType sumSMA = AccumType(0); // Sum of the first period prices
+
+   for (int priceIndex = 0; priceIndex < period; ++priceIndex)
+   {
+      sumSMA += PricePolicy::toAccum(prices[priceIndex]);
+   }
+
+   return sumSMA / period;
+}
+
+//******************************************************************************
+// Function : calculateMultEMA
+// Process  : Multiplier: (2 / (Time periods + 1))
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline typename MACDKernel<PricePolicy>::AccumType
+   MACDKernel<PricePolicy>::calculateMultEMA(const int period)
+{
+   static const double MULTNUMERATOR           = 2.0; // Numerator
+   static const double MULTDENOMADDITIONFACTOR = 1.0; // Denominator add factor
+
+   return AccumType(MULTNUMERATOR / (period + MULTDENOMADDITIONFACTOR));
+}
+
+#endif // MACDKernel_h
\ No newline at end of file
@@ -0,0 +1,312 @@
+//******************************************************************************
+//
+// File Name:     MPSCQueue.h
+//
+// File Overview: Represents an MPSCQueue
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef MPSCQueue_h
+#define MPSCQueue_h
+
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    MPSCQueue
+//
+// Overview: A bounded, lock-free, multiple producer single consumer queue
+//             Any number of threads may call tryPush and one thread tryPop
+//             The capacity is rounded up to a power of two so a slot is
+//                found with a mask
+//             Each slot has a sequence number that says whose turn it is:
+//                equal to an index when the slot is free for the push of
+//                that index, one past it once the value is written, and a
+//                lap past that once the consumer has read it
+//             Producers claim an index by compare and swap of tail, then
+//                write the slot and publish it by its sequence number, so a
+//                slow producer only holds back the consumer at its own slot
+//             head is only touched by the consumer, on its own cache line
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+template <class T>
+class MPSCQueue
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty queue of at least the specified capacity
+   // Constraints : Throws an exception if capacity is over MAXCAPACITY
+   //***************************************************************************
+   explicit MPSCQueue(const int capacity);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~MPSCQueue();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getCapacity
+   // Description : Retrieve the number of values the queue can hold
+   // Constraints : None
+   //***************************************************************************
+   inline int getCapacity() const;
+
+   //***************************************************************************
+   // Function    : tryPop
+   // Description : Removes the oldest published value into value
+   //                Returns false if the queue is empty, or the oldest
+   //                claimed slot is still being written
+   // Constraints : Consumer thread only
+   //***************************************************************************
+   inline bool tryPop(T& value);
+
+   //***************************************************************************
+   // Function    : tryPush
+   // Description : Adds value as the newest value
+   //                Returns false if the queue is full
+   // Constraints : None, any thread
+   //***************************************************************************
+   inline bool tryPush(const T& value);
+
+   static const int CACHELINEBYTES = 64;      // Keeps the indices apart
+   static const int MAXCAPACITY    = 1 << 30; // Largest int power of two
+
+private:
+   //***************************************************************************
+   //
+   // Class:    Slot
+   //
+   // Overview: A value and the sequence number of its turn
+   //
+   //***************************************************************************
+   struct Slot
+   {
+      atomic<unsigned> sequence; // Index whose turn it is, see Overview
+      T                value;    // Written by a producer, read by consumer
+   }; // end struct Slot
+
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, the indices are shared between threads
+   // Constraints : None
+   //***************************************************************************
+   MPSCQueue(const MPSCQueue&);
+   MPSCQueue& operator=(const MPSCQueue&);
+
+   //***************************************************************************
+   // Function    : roundCapacity
+   // Description : Retrieve the power of two at least capacity
+   // Constraints : Throws an exception if capacity is over MAXCAPACITY
+   //***************************************************************************
+   static unsigned roundCapacity(const int capacity);
+
+   vector<Slot>     slots;                          // Values, a power of two
+   unsigned         mask;                           // Slot of an index
+
+   char             paddingProducers[CACHELINEBYTES];
+   atomic<unsigned> tail;                           // Next push, producers
+
+   char             paddingConsumer[CACHELINEBYTES];
+   unsigned         head;                           // Next pop, consumer
+
+   char             paddingEnd[CACHELINEBYTES];
+}; // end class MPSCQueue
+
+//******************************************************************************
+// Function : constructor
+// Process  : Size the slots once, a power of two
+//             Every slot free for the push of its own index
+//             Empty, head and tail both at 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+MPSCQueue<T>::MPSCQueue(const int capacity)
+   : slots(MPSCQueue<T>::roundCapacity(capacity)),
+     mask(MPSCQueue<T>::roundCapacity(capacity) - 1),
+     tail(0),
+     head(0)
+{
+   for (size_t slotIndex = 0; slotIndex < this->slots.size(); ++slotIndex)
+   {
+      this->slots[slotIndex].sequence.store(
+         unsigned(slotIndex), memory_order_relaxed);
+   }
+} // end MPSCQueue::MPSCQueue
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+MPSCQueue<T>::~MPSCQueue()
+{
+} // end MPSCQueue::~MPSCQueue
+
+//******************************************************************************
+// Function : getCapacity
+// Process  : Retrieve the number of slots
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline int MPSCQueue<T>::getCapacity() const
+{
+   return this->slots.size();
+}
+
+//******************************************************************************
+// Function : roundCapacity
+// Process  : Check the capacity has a power of two in an int
+//             Double from 1 until at least capacity
+// Notes    : Throws an exception if capacity is over MAXCAPACITY, doubling
+//             past it would overflow and never end
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Rejects capacities over MAXCAPACITY
+//******************************************************************************
+template <class T>
+unsigned MPSCQueue<T>::roundCapacity(const int capacity)
+{
+   unsigned roundedCapacity = 1; // Power of two at least capacity
+
+   if (capacity > MPSCQueue<T>::MAXCAPACITY)
+   {
+      throw exception("MPSCQueue capacity is too large");
+   }
+
+   while (int(roundedCapacity) < capacity)
+   {
+      roundedCapacity <<= 1;
+   }
+
+   return roundedCapacity;
+}
+
+//******************************************************************************
+// Function : tryPop
+// Process  : The slot at head holds a value once its sequence is head + 1
+//                Otherwise it is empty, or its producer is still writing,
+//                return false
+//             Copy the value out of its slot
+//             Free the slot for the push a lap later, head + capacity
+// Notes    : Indices wrap around unsigned, only their difference matters
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline bool MPSCQueue<T>::tryPop(T& value)
+{
+   Slot&          slot     = this->slots[this->head & this->mask];
+   const unsigned SEQUENCE = slot.sequence.load(memory_order_acquire);
+
+   if (SEQUENCE != this->head + 1)
+   {
+      return false;
+   }
+
+   value = slot.value;
+   slot.sequence.store(this->head + this->mask + 1, memory_order_release);
+   ++this->head;
+
+   return true;
+}
+
+//******************************************************************************
+// Function : tryPush
+// Process  : Until an index is claimed
+//                The slot at tail is free once its sequence is tail
+//                   Claim the index by moving tail past it, if no other
+//                   producer has
+//                A sequence behind tail is a value not yet popped a lap
+//                   ago, the queue is full, return false
+//                A sequence ahead of tail means another producer claimed
+//                   it, reload tail
+//             Copy the value into the claimed slot
+//             Publish it to the consumer, sequence index + 1
+// Notes    : Indices wrap around unsigned, only their difference matters
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline bool MPSCQueue<T>::tryPush(const T& value)
+{
+   unsigned index      = this->tail.load(memory_order_relaxed); // Claimed
+   Slot*    slot       = NULL;                                  // Of index
+   int      difference = 0;                // Slot's sequence less the index
+
+   while (true)
+   {
+      slot       = &this->slots[index & this->mask];
+      difference = int(slot->sequence.load(memory_order_acquire) - index);
+
+      if (0 == difference)
+      {
+         if (this->tail.compare_exchange_weak(
+                index, index + 1, memory_order_relaxed))
+         {
+            break;
+         }
+      }
+      else if (difference < 0)
+      {
+         return false;
+      }
+      else
+      {
+         index = this->tail.load(memory_order_relaxed);
+      }
+   }
+
+   slot->value = value;
+   slot->sequence.store(index + 1, memory_order_release);
+
+   return true;
+}
+
+#endif // MPSCQueue_h
@@ -0,0 +1,100 @@
+//******************************************************************************
+//
+// File Name:     MarketData.h
+//
+// File Overview: Tick, Bar, and Alert records passed through the tick
+//                 ingestion path
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added file
+// 10.19.26       Donne Martin         Added Alert
+//******************************************************************************
+
+#ifndef MarketData_h
+#define MarketData_h
+
+//******************************************************************************
+//
+// Class:    Tick
+//
+// Overview: One trade print for a symbol
+//             Copied by value through SPSCQueue, so it holds no pointers
+//             publishNanos is set by TickIngestor on sampled ticks to
+//                measure latency, and is 0 otherwise
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct Tick
+{
+   int       symbolIndex;  // Symbol, an index into the feed's symbols
+   int       volume;       // Shares traded
+   long long timeMicros;   // Feed time of the trade, in microseconds
+   double    price;        // Trade price
+   long long publishNanos; // Steady clock when published, 0 if not sampled
+}; // end struct Tick
+
+//******************************************************************************
+//
+// Class:    Bar
+//
+// Overview: Open, high, low, close, and volume of a symbol's ticks over one
+//             bar interval, built by BarAggregator
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct Bar
+{
+   long long startMicros; // Feed time the interval starts, in microseconds
+   double    open;        // First trade price
+   double    high;        // Highest trade price
+   double    low;         // Lowest trade price
+   double    close;       // Last trade price
+   long long volume;      // Shares traded
+   int       numTicks;    // Ticks in the bar, 0 for no bar
+}; // end struct Bar
+
+enum AlertType
+{
+   ALERTZEROUP,    // MACD crossed above zero
+   ALERTZERODOWN,  // MACD crossed below zero
+   ALERTSLOPEUP,   // MACD slope rose above the slope threshold
+   ALERTSLOPEDOWN, // MACD slope fell below minus the slope threshold
+   NUMALERTTYPES
+};
+
+//******************************************************************************
+//
+// Class:    Alert
+//
+// Overview: A MACD event of a symbol at a completed bar, for AlertPublisher
+//             Copied by value through MPSCQueue, so it holds no pointers
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct Alert
+{
+   int       symbolIndex;  // Symbol, an index into the feed's symbols
+   AlertType type;         // Event
+   long long barMicros;    // Feed time the bar starts, in microseconds
+   double    macd;         // MACD after the bar
+   double    slopeMACD;    // MACD two day slope after the bar
+   long long arrivalNanos; // Steady clock when the bar completed
+}; // end struct Alert
+
+#endif // MarketData_h
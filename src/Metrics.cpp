@@ -0,0 +1,407 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     Metrics.cpp
+//
+// File Overview: Represents Metrics
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added analyzestock
+// 10.19.26       Donne Martin         Added correlate
+// 10.19.26       Donne Martin         Added screen
+// 10.19.26       Donne Martin         Added packload
+// 10.19.26       Donne Martin         Added crossovers
+// 10.19.26       Donne Martin         Added timeframes
+// 10.19.26       Donne Martin         Added snapshotload
+// 10.19.26       Donne Martin         Uses Metrics::addRelaxed
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#include "Metrics.h"
+
+//******************************************************************************
+//
+// Class:    MetricsAccumulator
+//
+// Overview: One thread's phase times and counters
+//             Only its thread writes them, with a relaxed load and store 
+//                rather than a locked add, so collect can read them safely
+//             Registered while its thread runs, folded into the retired
+//                totals when its thread exits
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct MetricsAccumulator
+{
+   MetricsAccumulator();
+   ~MetricsAccumulator();
+
+   atomic<long long> phaseNanos[Metrics::NUMPHASES]; // Time in each phase
+   atomic<long long> phaseCalls[Metrics::NUMPHASES]; // Calls of each phase
+   atomic<long long> counters[Metrics::NUMCOUNTERS]; // Value of each counter
+}; // end struct MetricsAccumulator
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+atomic<bool> Metrics::enabled(false);
+
+static mutex                       accumulatorsMutex; // Guards the two below
+static vector<MetricsAccumulator*> accumulators;      // Of running threads
+static Metrics::Totals             retiredTotals;     // Of exited threads
+
+static thread_local MetricsAccumulator threadAccumulator; // This thread's
+
+static const char* PHASENAMES[Metrics::NUMPHASES] =
+{
+   "analyze",
+   "analyzestock",
+   "correlate",
+   "crossovers",
+   "ema",
+   "fileopen",
+   "macd",
+   "packload",
+   "parse",
+   "rank",
+   "screen",
+   "sma",
+   "snapshotload",
+   "stream",
+   "timeframes"
+};
+
+static const char* COUNTERNAMES[Metrics::NUMCOUNTERS] =
+{
+   "bytes_parsed",
+   "rows_parsed",
+   "symbols_processed"
+};
+
+static const double NANOSPERSECOND = 1.0e9; // For exports
+
+//******************************************************************************
+// Function : addAccumulator
+// Process  : Add every phase time, phase call, and counter of the 
+//             accumulator to the totals
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void addAccumulator(
+   const MetricsAccumulator& accumulator,
+   Metrics::Totals& totals)
+{
+   for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+   {
+      totals.phaseNanos[phase] += 
+         accumulator.phaseNanos[phase].load(memory_order_relaxed);
+      totals.phaseCalls[phase] += 
+         accumulator.phaseCalls[phase].load(memory_order_relaxed);
+   }
+
+   for (int counter = 0; counter < Metrics::NUMCOUNTERS; ++counter)
+   {
+      totals.counters[counter] += 
+         accumulator.counters[counter].load(memory_order_relaxed);
+   }
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Zero everything
+//             Register with the running threads' accumulators
+// Notes    : Runs on the thread's first timer or counter
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+MetricsAccumulator::MetricsAccumulator()
+{
+   for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+   {
+      this->phaseNanos[phase].store(0);
+      this->phaseCalls[phase].store(0);
+   }
+
+   for (int counter = 0; counter < Metrics::NUMCOUNTERS; ++counter)
+   {
+      this->counters[counter].store(0);
+   }
+
+   lock_guard<mutex> lock(accumulatorsMutex);
+   accumulators.push_back(this);
+} // end MetricsAccumulator::MetricsAccumulator
+
+//******************************************************************************
+// Function : destructor
+// Process  : Fold into the retired totals
+//             Unregister
+// Notes    : Runs when the thread exits
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+MetricsAccumulator::~MetricsAccumulator()
+{
+   lock_guard<mutex> lock(accumulatorsMutex);
+
+   addAccumulator(*this, retiredTotals);
+   accumulators.erase(
+      remove(accumulators.begin(), accumulators.end(), this),
+      accumulators.end());
+} // end MetricsAccumulator::~MetricsAccumulator
+
+//******************************************************************************
+// Function : addCount
+// Process  : Add to the counter in this thread's accumulator
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::addCount(
+   const Counter counter,
+   const long long amount)
+{
+   Metrics::addRelaxed(threadAccumulator.counters[counter], amount);
+}
+
+//******************************************************************************
+// Function : addPhaseNanos
+// Process  : Add the time and one call to the phase in this thread's 
+//             accumulator
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::addPhaseNanos(
+   const Phase phase,
+   const long long nanos)
+{
+   Metrics::addRelaxed(threadAccumulator.phaseNanos[phase], nanos);
+   Metrics::addRelaxed(threadAccumulator.phaseCalls[phase], 1);
+}
+
+//******************************************************************************
+// Function : collect
+// Process  : Start from the retired totals
+//             Add the accumulator of every running thread
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::collect(Totals& totals)
+{
+   lock_guard<mutex> lock(accumulatorsMutex);
+
+   totals = retiredTotals;
+
+   for (size_t index = 0; index < accumulators.size(); ++index)
+   {
+      addAccumulator(*accumulators[index], totals);
+   }
+}
+
+//******************************************************************************
+// Function : getCounterName
+// Process  : Look up the name
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* Metrics::getCounterName(const Counter counter)
+{
+   return COUNTERNAMES[counter];
+}
+
+//******************************************************************************
+// Function : getPhaseName
+// Process  : Look up the name
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* Metrics::getPhaseName(const Phase phase)
+{
+   return PHASENAMES[phase];
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Zero the retired totals and every running thread's accumulator
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::reset()
+{
+   static const Totals NOTOTALS = Totals(); // All zero
+
+   lock_guard<mutex> lock(accumulatorsMutex);
+
+   retiredTotals = NOTOTALS;
+
+   for (size_t index = 0; index < accumulators.size(); ++index)
+   {
+      for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+      {
+         accumulators[index]->phaseNanos[phase].store(0);
+         accumulators[index]->phaseCalls[phase].store(0);
+      }
+
+      for (int counter = 0; counter < Metrics::NUMCOUNTERS; ++counter)
+      {
+         accumulators[index]->counters[counter].store(0);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : setEnabled
+// Process  : Mutator for enabled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::setEnabled(const bool enabled)
+{
+   Metrics::enabled.store(enabled);
+}
+
+//******************************************************************************
+// Function : writeJSON
+// Process  : Collect the totals
+//             Write each phase's seconds and calls, then each counter
+// Notes    : {"phases": {"<phase>": {"seconds": s, "calls": n}, ...},
+//             "counters": {"<counter>": n, ...}}
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::writeJSON(ostream& out)
+{
+   Totals totals; // Of every thread
+
+   Metrics::collect(totals);
+
+   out << "{" << endl << "  \"phases\": {" << endl;
+   out << setprecision(9);
+
+   for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+   {
+      out << "    \"" << PHASENAMES[phase] << "\": {\"seconds\": "
+          << totals.phaseNanos[phase] / NANOSPERSECOND
+          << ", \"calls\": " << totals.phaseCalls[phase] << "}"
+          << (phase + 1 < Metrics::NUMPHASES ? "," : "") << endl;
+   }
+
+   out << "  }," << endl << "  \"counters\": {" << endl;
+
+   for (int counter = 0; counter < Metrics::NUMCOUNTERS; ++counter)
+   {
+      out << "    \"" << COUNTERNAMES[counter] << "\": " 
+          << totals.counters[counter]
+          << (counter + 1 < Metrics::NUMCOUNTERS ? "," : "") << endl;
+   }
+
+   out << "  }" << endl << "}" << endl;
+   out << setprecision(6);
+}
+
+//******************************************************************************
+// Function : writePrometheus
+// Process  : Collect the totals
+//             Write the phase seconds and calls as labelled counters
+//             Write each counter
+// Notes    : Metric names are prefixed stockanalyzer_ and end in _total
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Metrics::writePrometheus(ostream& out)
+{
+   Totals totals; // Of every thread
+
+   Metrics::collect(totals);
+
+   out << setprecision(9);
+   out << "# HELP stockanalyzer_phase_seconds_total "
+       << "Time spent in each analysis phase" << endl;
+   out << "# TYPE stockanalyzer_phase_seconds_total counter" << endl;
+
+   for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+   {
+      out << "stockanalyzer_phase_seconds_total{phase=\"" 
+          << PHASENAMES[phase] << "\"} " 
+          << totals.phaseNanos[phase] / NANOSPERSECOND << endl;
+   }
+
+   out << "# HELP stockanalyzer_phase_calls_total "
+       << "Times each analysis phase was entered" << endl;
+   out << "# TYPE stockanalyzer_phase_calls_total counter" << endl;
+
+   for (int phase = 0; phase < Metrics::NUMPHASES; ++phase)
+   {
+      out << "stockanalyzer_phase_calls_total{phase=\"" 
+          << PHASENAMES[phase] << "\"} " << totals.phaseCalls[phase] << endl;
+   }
+
+   for (int counter = 0; counter < Metrics::NUMCOUNTERS; ++counter)
+   {
+      out << "# TYPE stockanalyzer_" << COUNTERNAMES[counter] 
+          << "_total counter" << endl;
+      out << "stockanalyzer_" << COUNTERNAMES[counter] << "_total " 
+          << totals.counters[counter] << endl;
+   }
+
+   out << setprecision(6);
+}
@@ -0,0 +1,405 @@
+//******************************************************************************
+//
+// File Name:     Metrics.h
+//
+// File Overview: Represents Metrics, phase timers and counters of an analysis
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added tracing
+// 10.19.26       Donne Martin         Added allocation tracking
+// 10.19.26       Donne Martin         Shares addRelaxed
+//******************************************************************************
+
+#ifndef Metrics_h
+#define Metrics_h
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+#include "AllocationTracker.h"
+#include "Tracer.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    Metrics
+//
+// Overview: Accumulates the time spent in each phase of an analysis and
+//             counters of the work done
+//             Each thread adds to its own accumulator, collect merges them
+//             Phases are inclusive, analyze contains the phases it calls
+//             Disabled by default, when disabled each timer and counter is 
+//                one relaxed load and a branch
+//             Define STOCK_METRICS_OFF to compile every METRICS_TIMER and 
+//                METRICS_COUNT out, which also removes tracing
+//             Everything is static, there is nothing to construct
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added analyzestock
+// 10.19.26       Donne Martin         Added correlate
+// 10.19.26       Donne Martin         Added screen
+// 10.19.26       Donne Martin         Added packload
+// 10.19.26       Donne Martin         Added crossovers
+// 10.19.26       Donne Martin         Added timeframes
+// 10.19.26       Donne Martin         Added snapshotload
+//
+//******************************************************************************
+class Metrics
+{
+public:
+
+   enum Phase
+   {
+      PHASEANALYZE,      // PortfolioAnalyzer::analyzePortfolio
+      PHASEANALYZESTOCK, // StockAnalyzer::analyzeStock
+      PHASECORRELATE,    // CorrelationMatrix::calculate
+      PHASECROSSOVERS,   // CrossoverDetector::detect
+      PHASEEMA,          // StockAnalyzer::calculateEMA
+      PHASEFILEOPEN,     // Opening a stock data file
+      PHASEMACD,         // StockAnalyzer::calculateMACDs
+      PHASEPACKLOAD,     // PortfolioAnalyzer::addStocksFromPack
+      PHASEPARSE,        // Reading the prices of a stock data file
+      PHASERANK,         // Ranking stocks by MACD slope
+      PHASESCREEN,       // Screener::select
+      PHASESMA,          // StockAnalyzer::calculateFirstPeriodSMA
+      PHASESNAPSHOTLOAD, // PortfolioAnalyzer::addStocksFromSnapshot
+      PHASESTREAM,       // StockAnalyzer::streamStockPrices, bounded history
+      PHASETIMEFRAMES,   // TimeframeAnalyzer::analyzeStock
+      NUMPHASES
+   };
+
+   enum Counter
+   {
+      COUNTERBYTESPARSED, // Bytes read from stock data files
+      COUNTERROWSPARSED,  // Prices read from stock data files
+      COUNTERSYMBOLS,     // Stocks analyzed
+      NUMCOUNTERS
+   };
+
+   //***************************************************************************
+   //
+   // Class:    Totals
+   //
+   // Overview: Merged phase times and counters of every thread
+   //
+   //***************************************************************************
+   struct Totals
+   {
+      long long phaseNanos[NUMPHASES]; // Time in each phase
+      long long phaseCalls[NUMPHASES]; // Times each phase was entered
+      long long counters[NUMCOUNTERS]; // Value of each counter
+   }; // end struct Totals
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addPhaseNanos
+   // Description : Adds one call of the phase taking nanos to this thread's
+   //                accumulator
+   // Constraints : Only call when enabled, see MetricsTimer
+   //***************************************************************************
+   static void addPhaseNanos(
+      const Phase phase,
+      const long long nanos);
+
+   //***************************************************************************
+   // Function    : addRelaxed
+   // Description : Adds amount to an atomic only its owning thread writes,
+   //                with a relaxed load and store
+   // Constraints : Only the owning thread may write value
+   //***************************************************************************
+   static inline void addRelaxed(
+      atomic<long long>& value,
+      const long long amount);
+
+   //***************************************************************************
+   // Function    : collect
+   // Description : Merges the accumulators of every thread, including 
+   //                threads that have exited, into totals
+   // Constraints : None
+   //***************************************************************************
+   static void collect(Totals& totals);
+
+   //***************************************************************************
+   // Function    : count
+   // Description : Adds amount to the counter when enabled
+   // Constraints : None
+   //***************************************************************************
+   static inline void count(
+      const Counter counter,
+      const long long amount);
+
+   //***************************************************************************
+   // Function    : getCounterName
+   // Description : Retrieve the name of the counter used in exports
+   // Constraints : None
+   //***************************************************************************
+   static const char* getCounterName(const Counter counter);
+
+   //***************************************************************************
+   // Function    : getPhaseName
+   // Description : Retrieve the name of the phase used in exports
+   // Constraints : None
+   //***************************************************************************
+   static const char* getPhaseName(const Phase phase);
+
+   //***************************************************************************
+   // Function    : isEnabled
+   // Description : Accessor for enabled
+   // Constraints : None
+   //***************************************************************************
+   static inline bool isEnabled();
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Zeroes every thread's accumulator
+   // Constraints : Don't call while other threads record
+   //***************************************************************************
+   static void reset();
+
+   //***************************************************************************
+   // Function    : setEnabled
+   // Description : Mutator for enabled
+   // Constraints : None
+   //***************************************************************************
+   static void setEnabled(const bool enabled);
+
+   //***************************************************************************
+   // Function    : writeJSON
+   // Description : Writes the collected totals as a JSON object
+   // Constraints : None
+   //***************************************************************************
+   static void writeJSON(ostream& out);
+
+   //***************************************************************************
+   // Function    : writePrometheus
+   // Description : Writes the collected totals in the Prometheus text format
+   // Constraints : None
+   //***************************************************************************
+   static void writePrometheus(ostream& out);
+
+private:
+   //***************************************************************************
+   // Function    : addCount
+   // Description : Adds amount to the counter in this thread's accumulator
+   // Constraints : Only call when enabled
+   //***************************************************************************
+   static void addCount(
+      const Counter counter,
+      const long long amount);
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Not constructed, everything is static
+   // Constraints : None
+   //***************************************************************************
+   Metrics();
+
+   static atomic<bool> enabled; // Record timers and counters?
+}; // end class Metrics
+
+//******************************************************************************
+//
+// Class:    MetricsTimer
+//
+// Overview: Adds the time from its construction to its destruction to a
+//             phase, when metrics are enabled at construction
+//             Also records it as a Tracer event named after the phase, with
+//                the detail, when tracing is enabled at construction
+//             Also makes the phase, and detail, the thread's active ones for
+//                AllocationTracker when it is enabled at construction
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Records Tracer events
+// 10.19.26       Donne Martin         Sets the AllocationTracker phase
+//
+//******************************************************************************
+class MetricsTimer
+{
+public:
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Starts timing the phase when metrics or tracing are
+   //                enabled, detail is added to the trace event
+   // Constraints : detail must outlive the timer
+   //***************************************************************************
+   explicit inline MetricsTimer(
+      const Metrics::Phase phase,
+      const char* detail = NULL);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Adds the elapsed time to the phase when started
+   // Constraints : None
+   //***************************************************************************
+   inline ~MetricsTimer();
+
+private:
+   Metrics::Phase                      phase;          // Phase timed
+   const char*                         detail;         // Of the trace event
+   bool                                timed;          // Metrics enabled?
+   bool                                traced;         // Tracer enabled?
+   bool                                tracked;        // Allocations enabled?
+   int                                 previousPhase;  // Restored at the end
+   const char*                         previousDetail; // Restored at the end
+   chrono::steady_clock::time_point    start;          // Monotonic start time
+}; // end class MetricsTimer
+
+// Time the rest of the enclosing scope as the phase, or compile to nothing
+#ifdef STOCK_METRICS_OFF
+#define METRICS_TIMER(phase)
+#define METRICS_TIMER_DETAIL(phase, detail)
+#define METRICS_COUNT(counter, amount)
+#else
+#define METRICS_TIMER(phase) MetricsTimer metricsTimer(Metrics::phase)
+#define METRICS_TIMER_DETAIL(phase, detail) \
+   MetricsTimer metricsTimer(Metrics::phase, detail)
+#define METRICS_COUNT(counter, amount) \
+   Metrics::count(Metrics::counter, amount)
+#endif
+
+//******************************************************************************
+// Function : addRelaxed
+// Process  : Add amount to an atomic only its owning thread writes
+// Notes    : A load and a store, no locked instruction, shared by the
+//             per-thread counts of Metrics and AllocationTracker
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void Metrics::addRelaxed(
+   atomic<long long>& value,
+   const long long amount)
+{
+   value.store(value.load(memory_order_relaxed) + amount, 
+               memory_order_relaxed);
+}
+
+//******************************************************************************
+// Function : count
+// Process  : Add the amount when enabled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void Metrics::count(
+   const Counter counter,
+   const long long amount)
+{
+   if (Metrics::isEnabled())
+   {
+      Metrics::addCount(counter, amount);
+   }
+}
+
+//******************************************************************************
+// Function : isEnabled
+// Process  : Accessor for enabled
+// Notes    : Relaxed, a timer started just before a change is still counted
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool Metrics::isEnabled()
+{
+   return Metrics::enabled.load(memory_order_relaxed);
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Make the phase active when allocations are tracked
+//             Start timing when metrics or tracing are enabled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Checks Tracer
+// 10.19.26       Donne Martin         Checks AllocationTracker
+//******************************************************************************
+inline MetricsTimer::MetricsTimer(
+   const Metrics::Phase phase,
+   const char* detail)
+   : phase(phase),
+     detail(detail),
+     timed(Metrics::isEnabled()),
+     traced(Tracer::isEnabled()),
+     tracked(AllocationTracker::isEnabled())
+{
+   if (this->tracked)
+   {
+      AllocationTracker::enterPhase(
+         phase, detail, this->previousPhase, this->previousDetail);
+   }
+
+   if (this->timed || this->traced)
+   {
+      this->start = chrono::steady_clock::now();
+   }
+} // end MetricsTimer::MetricsTimer
+
+//******************************************************************************
+// Function : destructor
+// Process  : Restore the AllocationTracker phase when tracked
+//             Read the clock once when started
+//             Add the elapsed time to the phase when timed
+//             Record the trace event when traced
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Records Tracer events
+// 10.19.26       Donne Martin         Restores the AllocationTracker phase
+//******************************************************************************
+inline MetricsTimer::~MetricsTimer()
+{
+   if (this->tracked)
+   {
+      AllocationTracker::exitPhase(this->previousPhase, this->previousDetail);
+   }
+
+   if (!this->timed && !this->traced)
+   {
+      return;
+   }
+
+   chrono::steady_clock::time_point end = chrono::steady_clock::now();
+
+   if (this->timed)
+   {
+      Metrics::addPhaseNanos(
+         this->phase,
+         chrono::duration_cast<chrono::nanoseconds>(end - this->start).count());
+   }
+
+   if (this->traced)
+   {
+      Tracer::addEvent(
+         Metrics::getPhaseName(this->phase), this->detail, this->start, end);
+   }
+} // end MetricsTimer::~MetricsTimer
+
+#endif // Metrics_h
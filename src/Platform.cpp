@@ -0,0 +1,727 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     Platform.cpp
+//
+// File Overview: Represents a Platform
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added child processes
+// 10.19.26       Donne Martin         Added file mapping and directories
+// 10.19.26       Donne Martin         Added releaseMappedPages
+// 10.19.26       Donne Martin         Added writeFileAtomically
+// 10.19.26       Donne Martin         Added shared memory
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+
+#include "Platform.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#else
+#include <cstdio>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// None
+
+//******************************************************************************
+// Function : createSharedMemory
+// Process  : Windows: CreateFileMapping of the paging file named
+//                Local\name, MapViewOfFile, the mapping handle is the
+//                mapping
+//             POSIX: remove any old /name, shm_open it, size it with
+//                ftruncate, and mmap it shared
+//             New memory is zeroed by the operating system
+// Notes    : Throws an exception if it can't be created or mapped
+//             On Windows the memory goes once every mapping of it is closed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+char* Platform::createSharedMemory(
+   const string& name,
+   const size_t  numBytes,
+   long long&    mapping)
+{
+   void* address = NULL; // First byte mapped
+
+#ifdef _WIN32
+   HANDLE sharedMapping = CreateFileMappingA(
+      INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 
+      DWORD((unsigned long long)numBytes >> 32), DWORD(numBytes), 
+      ("Local\\" + name).c_str());
+
+   if (NULL == sharedMapping)
+   {
+      throw exception("Could not create the shared memory");
+   }
+
+   if (ERROR_ALREADY_EXISTS == GetLastError())
+   {
+      CloseHandle(sharedMapping);
+      throw exception("Shared memory of the name is already open");
+   }
+
+   address = MapViewOfFile(sharedMapping, FILE_MAP_WRITE, 0, 0, numBytes);
+
+   if (NULL == address)
+   {
+      CloseHandle(sharedMapping);
+      throw exception("Could not map the shared memory");
+   }
+
+   mapping = (long long)sharedMapping;
+#else
+   const string SHAREDNAME = "/" + name; // POSIX shared memory name
+
+   shm_unlink(SHAREDNAME.c_str());
+
+   int shared = shm_open(SHAREDNAME.c_str(), O_RDWR | O_CREAT | O_EXCL, 
+                         0644); // Being mapped
+
+   if (shared < 0)
+   {
+      throw exception("Could not create the shared memory");
+   }
+
+   if (0 != ftruncate(shared, off_t(numBytes)))
+   {
+      ::close(shared);
+      shm_unlink(SHAREDNAME.c_str());
+      throw exception("Could not size the shared memory");
+   }
+
+   address = mmap(NULL, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED, 
+                  shared, 0);
+   ::close(shared);
+
+   if (MAP_FAILED == address)
+   {
+      shm_unlink(SHAREDNAME.c_str());
+      throw exception("Could not map the shared memory");
+   }
+
+   mapping = 0;
+#endif
+
+   return static_cast<char*>(address);
+}
+
+//******************************************************************************
+// Function : getResidentSetBytes
+// Process  : Windows: the working set size of this process
+//             POSIX: the resident pages in /proc/self/statm times the page size
+// Notes    : Returns 0 if the operating system can't tell us
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+long long Platform::getResidentSetBytes()
+{
+#ifdef _WIN32
+   PROCESS_MEMORY_COUNTERS counters; // Memory use of this process
+
+   if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+   {
+      return 0;
+   }
+
+   return counters.WorkingSetSize;
+#else
+   long  totalPages    = 0;    // Virtual size in pages, unused
+   long  residentPages = 0;    // Resident size in pages
+   FILE* statm         = fopen("/proc/self/statm", "r");
+
+   if (NULL == statm)
+   {
+      return 0;
+   }
+
+   if (2 != fscanf(statm, "%ld %ld", &totalPages, &residentPages))
+   {
+      residentPages = 0;
+   }
+
+   fclose(statm);
+
+   return (long long)residentPages * sysconf(_SC_PAGESIZE);
+#endif
+}
+
+//******************************************************************************
+// Function : listDirectory
+// Process  : Windows: FindFirstFile and FindNextFile over directory\*
+//             POSIX: opendir and readdir
+//             Skip . and .., then sort the names
+// Notes    : Returns false if the directory can't be read
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Platform::listDirectory(
+   const string&   directoryName,
+   vector<string>& fileNames)
+{
+   string fileName; // Of an entry
+
+   fileNames.clear();
+
+#ifdef _WIN32
+   WIN32_FIND_DATAA findData; // Entry found
+   HANDLE           find = FindFirstFileA(
+      (directoryName + "\\*").c_str(), &findData);
+
+   if (INVALID_HANDLE_VALUE == find)
+   {
+      return false;
+   }
+
+   do
+   {
+      fileName = findData.cFileName;
+
+      if ("." != fileName && ".." != fileName)
+      {
+         fileNames.push_back(fileName);
+      }
+   } while (FindNextFileA(find, &findData));
+
+   FindClose(find);
+#else
+   DIR*    directory = opendir(directoryName.c_str()); // Being read
+   dirent* entry     = NULL;                           // Entry read
+
+   if (NULL == directory)
+   {
+      return false;
+   }
+
+   while (NULL != (entry = readdir(directory)))
+   {
+      fileName = entry->d_name;
+
+      if ("." != fileName && ".." != fileName)
+      {
+         fileNames.push_back(fileName);
+      }
+   }
+
+   closedir(directory);
+#endif
+
+   sort(fileNames.begin(), fileNames.end());
+
+   return true;
+}
+
+//******************************************************************************
+// Function : makeDirectory
+// Process  : Windows: CreateDirectory
+//             POSIX: mkdir, readable and writable by the user
+// Notes    : Returns false if it can't be created or already exists
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Platform::makeDirectory(const string& directoryName)
+{
+#ifdef _WIN32
+   return FALSE != CreateDirectoryA(directoryName.c_str(), NULL);
+#else
+   return 0 == mkdir(directoryName.c_str(), 0755);
+#endif
+}
+
+//******************************************************************************
+// Function : mapFile
+// Process  : Windows: open the file, CreateFileMapping, MapViewOfFile,
+//                the mapping handle is the mapping
+//             POSIX: open the file, fstat its size, mmap it shared
+//             The file itself is closed, the mapping keeps it open
+// Notes    : Throws an exception if the file can't be mapped or is empty
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* Platform::mapFile(
+   const string& fileName,
+   size_t&       numBytes,
+   long long&    mapping)
+{
+   void* address = NULL; // First byte mapped
+
+#ifdef _WIN32
+   LARGE_INTEGER fileSize;    // Of the file
+   HANDLE        fileMapping; // Of the file
+   HANDLE        file = CreateFileA(
+      fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+      FILE_ATTRIBUTE_NORMAL, NULL);
+
+   if (INVALID_HANDLE_VALUE == file)
+   {
+      throw exception("Could not open the file to map");
+   }
+
+   if (!GetFileSizeEx(file, &fileSize) || 0 == fileSize.QuadPart)
+   {
+      CloseHandle(file);
+      throw exception("Could not map an empty file");
+   }
+
+   fileMapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+   CloseHandle(file);
+
+   if (NULL == fileMapping)
+   {
+      throw exception("Could not map the file");
+   }
+
+   address = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+
+   if (NULL == address)
+   {
+      CloseHandle(fileMapping);
+      throw exception("Could not map the file");
+   }
+
+   numBytes = size_t(fileSize.QuadPart);
+   mapping  = (long long)fileMapping;
+#else
+   struct stat fileStat;                               // Size of the file
+   int         file = open(fileName.c_str(), O_RDONLY); // Being mapped
+
+   if (file < 0)
+   {
+      throw exception("Could not open the file to map");
+   }
+
+   if (0 != fstat(file, &fileStat) || 0 == fileStat.st_size)
+   {
+      ::close(file);
+      throw exception("Could not map an empty file");
+   }
+
+   address = mmap(NULL, size_t(fileStat.st_size), PROT_READ, MAP_SHARED, 
+                  file, 0);
+   ::close(file);
+
+   if (MAP_FAILED == address)
+   {
+      throw exception("Could not map the file");
+   }
+
+   numBytes = size_t(fileStat.st_size);
+   mapping  = 0;
+#endif
+
+   return static_cast<const char*>(address);
+}
+
+//******************************************************************************
+// Function : openSharedMemory
+// Process  : Windows: OpenFileMapping of Local\name, MapViewOfFile, and
+//                VirtualQuery the view's size
+//             POSIX: shm_open /name, fstat its size, mmap it shared
+//             The shared memory itself is closed, the mapping keeps it open
+// Notes    : Throws an exception if it doesn't exist or can't be mapped
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* Platform::openSharedMemory(
+   const string& name,
+   size_t&       numBytes,
+   long long&    mapping)
+{
+   void* address = NULL; // First byte mapped
+
+#ifdef _WIN32
+   MEMORY_BASIC_INFORMATION viewInfo;  // Size of the view
+   HANDLE                   sharedMapping = OpenFileMappingA(
+      FILE_MAP_READ, FALSE, ("Local\\" + name).c_str());
+
+   if (NULL == sharedMapping)
+   {
+      throw exception("Could not open the shared memory");
+   }
+
+   address = MapViewOfFile(sharedMapping, FILE_MAP_READ, 0, 0, 0);
+
+   if (NULL == address || 0 == VirtualQuery(address, &viewInfo, 
+                                            sizeof(viewInfo)))
+   {
+      if (NULL != address)
+      {
+         UnmapViewOfFile(address);
+      }
+
+      CloseHandle(sharedMapping);
+      throw exception("Could not map the shared memory");
+   }
+
+   numBytes = viewInfo.RegionSize;
+   mapping  = (long long)sharedMapping;
+#else
+   struct stat sharedStat; // Size of the shared memory
+   int         shared = shm_open(("/" + name).c_str(), O_RDONLY, 0);
+
+   if (shared < 0)
+   {
+      throw exception("Could not open the shared memory");
+   }
+
+   if (0 != fstat(shared, &sharedStat) || 0 == sharedStat.st_size)
+   {
+      ::close(shared);
+      throw exception("Could not map empty shared memory");
+   }
+
+   address = mmap(NULL, size_t(sharedStat.st_size), PROT_READ, MAP_SHARED, 
+                  shared, 0);
+   ::close(shared);
+
+   if (MAP_FAILED == address)
+   {
+      throw exception("Could not map the shared memory");
+   }
+
+   numBytes = size_t(sharedStat.st_size);
+   mapping  = 0;
+#endif
+
+   return static_cast<const char*>(address);
+}
+
+//******************************************************************************
+// Function : releaseMappedPages
+// Process  : Windows: unlock the range, which removes unlocked pages from
+//                the working set
+//             POSIX: round the range out to whole pages and advise that
+//                they aren't needed, clean file pages are simply dropped
+// Notes    : The mapping is read only, so nothing is lost
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Platform::releaseMappedPages(
+   const char*  address,
+   const size_t numBytes)
+{
+   if (0 == numBytes)
+   {
+      return;
+   }
+
+#ifdef _WIN32
+   VirtualUnlock(const_cast<char*>(address), numBytes);
+#else
+   size_t pageBytes = sysconf(_SC_PAGESIZE);                 // Page size
+   size_t first     = (size_t)address / pageBytes * pageBytes; // First page
+   size_t end       = ((size_t)address + numBytes + pageBytes - 1) / 
+                      pageBytes * pageBytes;                 // Past last page
+
+   madvise((void*)first, end - first, MADV_DONTNEED);
+#endif
+}
+
+//******************************************************************************
+// Function : removeDirectory
+// Process  : Windows: RemoveDirectory
+//             POSIX: rmdir
+// Notes    : Returns false if it can't be removed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Platform::removeDirectory(const string& directoryName)
+{
+#ifdef _WIN32
+   return FALSE != RemoveDirectoryA(directoryName.c_str());
+#else
+   return 0 == rmdir(directoryName.c_str());
+#endif
+}
+
+//******************************************************************************
+// Function : removeSharedMemory
+// Process  : Windows: nothing to remove, the memory goes with its last
+//                mapping
+//             POSIX: shm_unlink /name
+// Notes    : Returns false if there is no such name
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Platform::removeSharedMemory(const string& name)
+{
+#ifdef _WIN32
+   return true;
+#else
+   return 0 == shm_unlink(("/" + name).c_str());
+#endif
+}
+
+//******************************************************************************
+// Function : startProcess
+// Process  : Windows: quote each argument into one command line and 
+//                CreateProcess it
+//             POSIX: fork, and exec the arguments in the child
+// Notes    : Throws an exception if the process can't be started
+//             A POSIX child that can't exec exits with 127
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+long long Platform::startProcess(const vector<string>& arguments)
+{
+   if (arguments.empty())
+   {
+      throw exception("No program to start");
+   }
+
+#ifdef _WIN32
+   STARTUPINFOA        startupInfo;  // Inherits our console
+   PROCESS_INFORMATION processInfo;  // Handles of the child
+   string              commandLine;  // Quoted arguments
+
+   for (size_t argIndex = 0; argIndex < arguments.size(); ++argIndex)
+   {
+      commandLine += (0 == argIndex ? "\"" : " \"");
+      commandLine += arguments[argIndex];
+      commandLine += "\"";
+   }
+
+   ZeroMemory(&startupInfo, sizeof(startupInfo));
+   startupInfo.cb = sizeof(startupInfo);
+
+   if (!CreateProcessA(NULL, &commandLine[0], NULL, NULL, FALSE, 0, NULL, 
+                       NULL, &startupInfo, &processInfo))
+   {
+      throw exception("Could not start process");
+   }
+
+   CloseHandle(processInfo.hThread);
+
+   return (long long)processInfo.hProcess;
+#else
+   vector<char*> argv; // Null terminated argument list for exec
+
+   for (size_t argIndex = 0; argIndex < arguments.size(); ++argIndex)
+   {
+      argv.push_back(const_cast<char*>(arguments[argIndex].c_str()));
+   }
+
+   argv.push_back(NULL);
+
+   pid_t processId = fork();
+
+   if (processId < 0)
+   {
+      throw exception("Could not start process");
+   }
+
+   if (0 == processId)
+   {
+      execv(argv[0], &argv[0]);
+      _exit(127);
+   }
+
+   return processId;
+#endif
+}
+
+//******************************************************************************
+// Function : unmapFile
+// Process  : Windows: UnmapViewOfFile and close the mapping handle
+//             POSIX: munmap
+// Notes    : POSIX has no mapping handle, mapping is unused
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Marks mapping unused on POSIX
+//******************************************************************************
+void Platform::unmapFile(
+   const char*     address,
+   const size_t    numBytes,
+   const long long mapping)
+{
+#ifdef _WIN32
+   UnmapViewOfFile(address);
+   CloseHandle((HANDLE)mapping);
+#else
+   (void)mapping;
+   munmap(const_cast<char*>(address), numBytes);
+#endif
+}
+
+//******************************************************************************
+// Function : waitForProcess
+// Process  : Windows: wait on the handle, read the exit code, close it
+//             POSIX: waitpid, the exit status, or 1 if it was signalled
+// Notes    : Returns 1 if the wait fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Platform::waitForProcess(const long long process)
+{
+#ifdef _WIN32
+   HANDLE handle   = (HANDLE)process; // From startProcess
+   DWORD  exitCode = 1;               // Of the child
+
+   if (WAIT_OBJECT_0 != WaitForSingleObject(handle, INFINITE) ||
+       !GetExitCodeProcess(handle, &exitCode))
+   {
+      exitCode = 1;
+   }
+
+   CloseHandle(handle);
+
+   return int(exitCode);
+#else
+   int status = 0; // From waitpid
+
+   if (waitpid(pid_t(process), &status, 0) < 0 || !WIFEXITED(status))
+   {
+      return 1;
+   }
+
+   return WEXITSTATUS(status);
+#endif
+}
+
+//******************************************************************************
+// Function : writeFileAtomically
+// Process  : Write the data to fileName.tmp
+//             Flush it to disk, Windows: FlushFileBuffers, POSIX: fsync
+//             Rename it over the file, Windows: MoveFileEx replacing it,
+//                POSIX: rename
+//             Remove fileName.tmp if anything failed
+// Notes    : Returns false if the file can't be written
+//             Windows writes at most MAXWRITEBYTES per WriteFile
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Platform::writeFileAtomically(
+   const string& fileName,
+   const char* data,
+   const size_t numBytes)
+{
+   const string TEMPFILENAME = fileName + ".tmp"; // Written, then renamed
+   size_t       offset       = 0;                 // Bytes written
+   bool         written      = true;              // Every step succeeded?
+
+#ifdef _WIN32
+   static const size_t MAXWRITEBYTES = 1 << 30; // DWORD counts
+
+   DWORD  numWritten = 0; // By one WriteFile
+   HANDLE file       = CreateFileA(TEMPFILENAME.c_str(), GENERIC_WRITE, 0, 
+                          NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+
+   if (INVALID_HANDLE_VALUE == file)
+   {
+      return false;
+   }
+
+   // Write the data to fileName.tmp
+   while (written && offset < numBytes)
+   {
+      written = FALSE != WriteFile(file, data + offset, 
+                            DWORD(min(numBytes - offset, MAXWRITEBYTES)), 
+                            &numWritten, NULL) && numWritten > 0;
+      offset += numWritten;
+   }
+
+   // Flush it to disk and rename it over the file
+   written = written && FALSE != FlushFileBuffers(file);
+   CloseHandle(file);
+   written = written && FALSE != MoveFileExA(TEMPFILENAME.c_str(), 
+                                    fileName.c_str(), 
+                                    MOVEFILE_REPLACE_EXISTING | 
+                                    MOVEFILE_WRITE_THROUGH);
+
+   if (!written)
+   {
+      DeleteFileA(TEMPFILENAME.c_str());
+   }
+#else
+   ssize_t numWritten = 0; // By one write
+   int     file       = open(TEMPFILENAME.c_str(), 
+                             O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+   if (file < 0)
+   {
+      return false;
+   }
+
+   // Write the data to fileName.tmp
+   while (written && offset < numBytes)
+   {
+      numWritten = write(file, data + offset, numBytes - offset);
+      written    = numWritten > 0;
+      offset    += written ? size_t(numWritten) : 0;
+   }
+
+   // Flush it to disk and rename it over the file
+   written = written && 0 == fsync(file);
+   written = (0 == close(file)) && written;
+   written = written && 0 == rename(TEMPFILENAME.c_str(), fileName.c_str());
+
+   if (!written)
+   {
+      unlink(TEMPFILENAME.c_str());
+   }
+#endif
+
+   return written;
+}
@@ -0,0 +1,232 @@
+//******************************************************************************
+//
+// File Name:     Platform.h
+//
+// File Overview: Represents a Platform
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added child processes
+// 10.19.26       Donne Martin         Added file mapping and directories
+// 10.19.26       Donne Martin         Added releaseMappedPages
+// 10.19.26       Donne Martin         Added writeFileAtomically
+// 10.19.26       Donne Martin         Added shared memory
+// 10.19.26       Donne Martin         Added getSteadyNanos
+//******************************************************************************
+
+#ifndef Platform_h
+#define Platform_h
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    Platform
+//
+// Overview: Operating system services that differ between Windows and POSIX
+//             Everything is static, there is nothing to construct
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added child processes
+// 10.19.26       Donne Martin         Added file mapping and directories
+// 10.19.26       Donne Martin         Added releaseMappedPages
+// 10.19.26       Donne Martin         Added writeFileAtomically
+// 10.19.26       Donne Martin         Added shared memory
+// 10.19.26       Donne Martin         Added getSteadyNanos
+//
+//******************************************************************************
+class Platform
+{
+public:
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : createSharedMemory
+   // Description : Creates the named shared memory of numBytes zeroed
+   //                bytes and maps it read and write
+   //                Returns its first byte, and sets the mapping to pass to
+   //                unmapFile
+   //                The name is a plain name, without slashes
+   //                POSIX replaces memory of the name left by a dead writer
+   // Constraints : Throws an exception if it can't be created or mapped,
+   //                or on Windows, if memory of the name is still open
+   //***************************************************************************
+   static char* createSharedMemory(
+      const string& name,
+      const size_t numBytes,
+      long long& mapping);
+
+   //***************************************************************************
+   // Function    : getResidentSetBytes
+   // Description : Retrieve the bytes of this process currently in physical
+   //                memory, the working set on Windows
+   // Constraints : Returns 0 if the operating system can't tell us
+   //***************************************************************************
+   static long long getResidentSetBytes();
+
+   //***************************************************************************
+   // Function    : getSteadyNanos
+   // Description : Reads the steady clock in nanoseconds
+   //                The clock is system wide, so readings of different
+   //                threads and processes compare
+   // Constraints : None
+   //***************************************************************************
+   static inline long long getSteadyNanos();
+
+   //***************************************************************************
+   // Function    : listDirectory
+   // Description : Retrieves the names of the files in the directory, 
+   //                without the directory, sorted
+   //                Returns false if the directory can't be read
+   // Constraints : None
+   //***************************************************************************
+   static bool listDirectory(
+      const string& directoryName,
+      vector<string>& fileNames);
+
+   //***************************************************************************
+   // Function    : makeDirectory
+   // Description : Creates the directory
+   //                Returns false if it can't be created or already exists
+   // Constraints : None
+   //***************************************************************************
+   static bool makeDirectory(const string& directoryName);
+
+   //***************************************************************************
+   // Function    : mapFile
+   // Description : Maps the whole file read only into memory
+   //                Returns its first byte, and sets numBytes and the 
+   //                mapping to pass to unmapFile
+   // Constraints : Throws an exception if the file can't be mapped or is
+   //                empty
+   //***************************************************************************
+   static const char* mapFile(
+      const string& fileName,
+      size_t& numBytes,
+      long long& mapping);
+
+   //***************************************************************************
+   // Function    : openSharedMemory
+   // Description : Maps the named shared memory from createSharedMemory
+   //                read only
+   //                Returns its first byte, and sets numBytes and the
+   //                mapping to pass to unmapFile
+   //                numBytes may be rounded up to whole pages on Windows
+   // Constraints : Throws an exception if it doesn't exist or can't be
+   //                mapped
+   //***************************************************************************
+   static const char* openSharedMemory(
+      const string& name,
+      size_t& numBytes,
+      long long& mapping);
+
+   //***************************************************************************
+   // Function    : releaseMappedPages
+   // Description : Drops the pages of a range of a file mapped by mapFile
+   //                from physical memory, they are read back if touched
+   //                The pages holding the first and last bytes are whole
+   // Constraints : The range must be in one mapping
+   //***************************************************************************
+   static void releaseMappedPages(
+      const char* address,
+      const size_t numBytes);
+
+   //***************************************************************************
+   // Function    : removeDirectory
+   // Description : Removes the directory, which must be empty
+   //                Returns false if it can't be removed
+   // Constraints : None
+   //***************************************************************************
+   static bool removeDirectory(const string& directoryName);
+
+   //***************************************************************************
+   // Function    : removeSharedMemory
+   // Description : Removes the name of shared memory from
+   //                createSharedMemory, mappings of it stay valid until
+   //                unmapped
+   //                Returns false if there is no such name
+   // Constraints : None
+   //***************************************************************************
+   static bool removeSharedMemory(const string& name);
+
+   //***************************************************************************
+   // Function    : startProcess
+   // Description : Starts a child process running arguments[0] with the 
+   //                remaining arguments, without waiting for it
+   //                Returns the process to pass to waitForProcess
+   // Constraints : Throws an exception if the process can't be started
+   //***************************************************************************
+   static long long startProcess(const vector<string>& arguments);
+
+   //***************************************************************************
+   // Function    : unmapFile
+   // Description : Unmaps a file mapped by mapFile, or shared memory
+   //                mapped by createSharedMemory or openSharedMemory
+   // Constraints : Call once per mapping
+   //***************************************************************************
+   static void unmapFile(
+      const char* address,
+      const size_t numBytes,
+      const long long mapping);
+
+   //***************************************************************************
+   // Function    : waitForProcess
+   // Description : Waits for a process from startProcess to exit
+   //                Returns its exit code
+   // Constraints : Call once per process
+   //***************************************************************************
+   static int waitForProcess(const long long process);
+
+   //***************************************************************************
+   // Function    : writeFileAtomically
+   // Description : Replaces the file with numBytes of data, so a reader
+   //                or a crash sees either the old file or the whole new one
+   //                The data is written to fileName.tmp, flushed to disk,
+   //                and renamed over the file
+   //                Returns false if it can't be written, the old file is
+   //                left as it was
+   // Constraints : None
+   //***************************************************************************
+   static bool writeFileAtomically(
+      const string& fileName,
+      const char* data,
+      const size_t numBytes);
+
+private:
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Not constructed, everything is static
+   // Constraints : None
+   //***************************************************************************
+   Platform();
+}; // end class Platform
+
+//******************************************************************************
+// Function : getSteadyNanos
+// Process  : Nanoseconds of the steady clock since its epoch
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long Platform::getSteadyNanos()
+{
+   return chrono::duration_cast<chrono::nanoseconds>(
+      chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // Platform_h
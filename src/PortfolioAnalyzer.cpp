@@ -13,60 +13,2050 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Added manifests, ranking, and updates
+// 10.19.26       Donne Martin         Added -replay and -maketicks
+// 10.19.26       Donne Martin         Added manifest shards
+// 10.19.26       Donne Martin         Added -metrics
+// 10.19.26       Donne Martin         Added -trace
+// 10.19.26       Donne Martin         Added -allocations
+// 10.19.26       Donne Martin         Added -align
+// 10.19.26       Donne Martin         Added -correlate
+// 10.19.26       Donne Martin         Added ranking by regression slope
+// 10.19.26       Donne Martin         Added -screen
+// 10.19.26       Donne Martin         Added -pack and -packappend
+// 10.19.26       Donne Martin         Added -stream
+// 10.19.26       Donne Martin         Added -crossovers
+// 10.19.26       Donne Martin         Added -alerts
+// 10.19.26       Donne Martin         Added -timeframes
+// 10.19.26       Donne Martin         Added analyzer snapshots
+// 10.19.26       Donne Martin         Added -shmtop and -shmreader
+// 10.19.26       Donne Martin         Slope periods of 1 are rejected
 //******************************************************************************
 
 #include "stdafx.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include "AlertPublisher.h"
+#include "AllocationTracker.h"
+#include "AnalysisDaemon.h"
+#include "AnalyzerSnapshot.h"
+#include "CorrelationMatrix.h"
+#include "CrossoverDetector.h"
+#include "DaemonLoadGenerator.h"
+#include "Metrics.h"
 #include "PortfolioAnalyzer.h"
+#include "PortfolioBenchmark.h"
+#include "Platform.h"
+#include "Screener.h"
+#include "ShardResult.h"
+#include "SharedRanking.h"
+#include "StreamingAnalyzer.h"
+#include "TickIngestor.h"
+#include "TickReplayer.h"
+#include "TimeframeAnalyzer.h"
+#include "Tracer.h"
+#include "TradingCalendar.h"
+#include "UniversePack.h"
 
 //******************************************************************************
 // File scope (static) variable definitions
 //******************************************************************************
 
-// None
+static const int DEFAULTNUMTOPSTOCKS = 10; // Stocks ranked by -rank, -merge
+static const int NUMALLOCATIONDETAILS = 10; // Stocks output by -allocations
+static const int DEFAULTNUMNEIGHBOURS = 3;  // Output by -correlate
+static const int DEFAULTNUMCROSSOVERS = 20; // Output by -crossovers
+static const int DEFAULTNUMTIMEFRAMESTOCKS = 10; // Ranked by -timeframes
+static const char* DEFAULTRANKCOLUMN = "slope"; // Ranks -screen
+
+//******************************************************************************
+//
+// Class:    MACDSlopeGreater
+//
+// Overview: Orders stock analyzer indices by MACD slope, highest first
+//             The slope is the portfolio's ranking slope, see 
+//             PortfolioAnalyzer::getRankingSlopeAtIndex
+//             Equal slopes keep their portfolio order, matching 
+//             outputStockWithHighestMACDSlope
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Ranks by the ranking slope
+//
+//******************************************************************************
+class MACDSlopeGreater
+{
+public:
+   explicit MACDSlopeGreater(const PortfolioAnalyzer& portfolioAnalyzer)
+      : portfolioAnalyzer(portfolioAnalyzer)
+   {
+   }
+
+   bool operator()(const int leftIndex, const int rightIndex) const
+   {
+      double leftSlope  = 
+         this->portfolioAnalyzer.getRankingSlopeAtIndex(leftIndex);
+      double rightSlope = 
+         this->portfolioAnalyzer.getRankingSlopeAtIndex(rightIndex);
+
+      if (leftSlope != rightSlope)
+      {
+         return leftSlope > rightSlope;
+      }
+
+      return leftIndex < rightIndex;
+   }
+
+private:
+   const PortfolioAnalyzer& portfolioAnalyzer; // Portfolio being ranked
+}; // end class MACDSlopeGreater
+
+//******************************************************************************
+//
+// Class:    ValueGreater
+//
+// Overview: Orders indices by their values, highest first
+//             Equal values keep their index order
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class ValueGreater
+{
+public:
+   explicit ValueGreater(const vector<double>& values)
+      : values(values)
+   {
+   }
+
+   bool operator()(const int leftIndex, const int rightIndex) const
+   {
+      if (this->values[leftIndex] != this->values[rightIndex])
+      {
+         return this->values[leftIndex] > this->values[rightIndex];
+      }
+
+      return leftIndex < rightIndex;
+   }
+
+private:
+   const vector<double>& values; // Of each index
+}; // end class ValueGreater
+
+//******************************************************************************
+// Function : analyzeShard                                   
+// Process  : Load the shard's stocks from the manifest
+//             Analyze them, without output and with bounded history
+//             Summarize them and keep the top numTopStocks
+// Notes    : The whole manifest is the only shard of 1
+//             Ranked by the regression slope of periodsSlope MACDs, or by
+//                the MACD slope for 0
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added periodsSlope
+//******************************************************************************
+static void analyzeShard(
+   const string& manifestFileName,
+   const int shardIndex,
+   const int numShards,
+   const int numTopStocks,
+   ShardResult& shardResult,
+   const int periodsSlope = 0)
+{
+   PortfolioAnalyzer portfolioAnalyzer; // Stocks of the shard
+
+   portfolioAnalyzer.setVerbose(false);
+   portfolioAnalyzer.setPeriodsSlope(periodsSlope);
+   portfolioAnalyzer.setHistoryBounded(true);
+   portfolioAnalyzer.addStocksFromManifest(
+      manifestFileName.c_str(), shardIndex, numShards);
+   portfolioAnalyzer.analyzePortfolio();
+
+   shardResult.setFromPortfolio(
+      portfolioAnalyzer, shardIndex, numShards, numTopStocks);
+}
+
+//******************************************************************************
+// Function : listStockDataFiles                                   
+// Process  : A directory lists its .csv files, with the directory
+//             Otherwise read the manifest's file names, skipping blank lines
+//                and comments
+// Notes    : Throws an exception if the manifest can't be read
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void listStockDataFiles(
+   const string&   source,
+   vector<string>& stockDataFileNames)
+{
+   static const string EXTENSION  = ".csv";    // Of a stock data file
+   static const char*  WHITESPACE = " \t\r\n"; // Stripped from each line
+   vector<string>      fileNames;               // In the directory
+   ifstream            fin;                     // Manifest reader
+   string              line;                    // Line of the manifest
+   size_t              first = 0;               // First non whitespace char
+
+   stockDataFileNames.clear();
+
+   // A directory lists its .csv files, with the directory
+   if (Platform::listDirectory(source, fileNames))
+   {
+      for (size_t fileIndex = 0; fileIndex < fileNames.size(); ++fileIndex)
+      {
+         string extension; // Lower case, of the file name
+
+         if (fileNames[fileIndex].size() > EXTENSION.size())
+         {
+            extension = fileNames[fileIndex].substr(
+               fileNames[fileIndex].size() - EXTENSION.size());
+            transform(extension.begin(), extension.end(), extension.begin(),
+                      ::tolower);
+         }
+
+         if (EXTENSION == extension)
+         {
+            stockDataFileNames.push_back(source + "/" + fileNames[fileIndex]);
+         }
+      }
+
+      return;
+   }
+
+   // Otherwise read the manifest's file names
+   fin.open(source.c_str());
+
+   if (!fin.good())
+   {
+      throw exception("Could not read the manifest");
+   }
+
+   while (getline(fin, line))
+   {
+      first = line.find_first_not_of(WHITESPACE);
+
+      if (string::npos != first && '#' != line[first])
+      {
+         stockDataFileNames.push_back(line.substr(
+            first, line.find_last_not_of(WHITESPACE) - first + 1));
+      }
+   }
+}
+
+//******************************************************************************
+// Function : loadTicks
+// Process  : Load the tick file into the replayer, with TICKFILEBARMICROS
+//                bars
+//             For "-", load the default stocks' data files as one tick per
+//                open, high, low, and close, with day bars
+// Notes    : Returns the bar interval in microseconds
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function, from runReplay
+//******************************************************************************
+static long long loadTicks(
+   const string& tickFileName,
+   TickReplayer& replayer)
+{
+   static const long long TICKFILEBARMICROS = 60000000LL; // One minute bars
+
+   // Load the tick file
+   if ("-" != tickFileName)
+   {
+      replayer.loadTickFile(tickFileName.c_str());
+      return TICKFILEBARMICROS;
+   }
+
+   // Or the default stocks' data files
+   PortfolioAnalyzer portfolioAnalyzer; // Holds the default data files
+   portfolioAnalyzer.addDefaultStocksToPortfolio();
+
+   for (int analyzerIndex = 0;
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers();
+        ++analyzerIndex)
+   {
+      replayer.addTicksFromStockDataFile(portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockDataFileName());
+   }
+
+   return TickReplayer::DAYMICROS;
+}
+
+//******************************************************************************
+// Function : narrowArgument                                   
+// Process  : Converts a command line argument to a narrow string
+// Notes    : Unicode builds pass wide arguments
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static string narrowArgument(const _TCHAR* argument)
+{
+#ifdef _UNICODE
+   string narrowed;  // Narrowed argument
+
+   for (const _TCHAR* character = argument; *character != 0; ++character)
+   {
+      narrowed.push_back(char(*character));
+   }
+
+   return narrowed;
+#else
+   return string(argument);
+#endif
+}
+
+//******************************************************************************
+// Function : outputRankedStocks                                   
+// Process  : Output the rank, symbol, MACD slope, and MACD of each stock
+// Notes    : Full precision, so rankings can be compared as text
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void outputRankedStocks(const vector<ShardStockSummary>& rankedStocks)
+{
+   cout << setw(6) << "rank" << "  " << setw(10) << left << "symbol" 
+        << right << setw(26) << "MACD slope" << setw(26) << "MACD" << endl;
+   cout << setprecision(17);
+
+   for (size_t rank = 0; rank < rankedStocks.size(); ++rank)
+   {
+      cout << setw(6) << rank + 1 << "  " 
+           << setw(10) << left << rankedStocks[rank].symbol << right
+           << setw(26) << rankedStocks[rank].slopeMACD 
+           << setw(26) << rankedStocks[rank].currentMACD << endl;
+   }
+
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : parsePeriodsSlope                                   
+// Process  : Convert the slope periods argument
+//             Check it is at least MINSLOPEPERIODS
+// Notes    : Throws an exception otherwise, the slope of one MACD is always
+//             0 and would rank the stocks in manifest order
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static int parsePeriodsSlope(const string& argument)
+{
+   int periodsSlope = atoi(argument.c_str()); // MACDs in the slope
+
+   // Check it is at least MINSLOPEPERIODS
+   if (periodsSlope < StockAnalyzer::MINSLOPEPERIODS)
+   {
+      throw exception("Slope periods must be at least 2");
+   }
+
+   return periodsSlope;
+}
+
+//******************************************************************************
+// Function : runAlerts
+// Process  : Load the ticks as -replay does
+//             Open an AlertPublisher on the alert log file, and the
+//                consumer's socket if given, writing the symbol names
+//             Rate limit it, if a rate is given
+//             Replay the ticks through a TickIngestor publishing the MACD
+//                alerts of its bars, flush the last bars, and stop the
+//                publisher once it has written every alert
+//             Output the ingestion and alert statistics
+// Notes    : -alerts <log file> [tick file] [speed] [shards] [alerts per
+//                second] [socket path]
+//             A tick file of "-" or none replays the default stocks
+//             The log file is appended to, a line per alert
+//             A consumer, such as another process, must be listening on
+//                the socket path
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runAlerts(const vector<string>& arguments)
+{
+   static const double BURSTSECONDS = 1.0; // Of the rate limit
+
+   TickReplayer   replayer;        // Feed of the ticks
+   vector<string> symbolNames;     // Of the feed's symbols
+   double         speed     = 0.0; // Feed time multiple
+   int            numShards = 1;   // Worker threads
+   double         rate      = 0.0; // Alerts per second per symbol
+   long long      barMicros = 0;   // Bar interval
+   double         seconds   = 0.0; // Replaying
+
+   if (arguments.size() < 2)
+   {
+      throw exception("-alerts requires an alert log file name");
+   }
+
+   // Load the ticks as -replay does
+   barMicros = loadTicks(
+      arguments.size() > 2 ? arguments[2] : string("-"), replayer);
+
+   if (arguments.size() > 3)
+   {
+      speed = atof(arguments[3].c_str());
+   }
+
+   if (arguments.size() > 4)
+   {
+      numShards = atoi(arguments[4].c_str());
+   }
+
+   if (arguments.size() > 5)
+   {
+      rate = atof(arguments[5].c_str());
+   }
+
+   for (int symbolIndex = 0; symbolIndex < replayer.getNumSymbols();
+        ++symbolIndex)
+   {
+      symbolNames.push_back(replayer.getSymbol(symbolIndex));
+   }
+
+   // Open the publisher on the log file, and the consumer's socket
+   TickIngestor   ingestor(replayer.getNumSymbols(), numShards, barMicros);
+   AlertPublisher alertPublisher(replayer.getNumSymbols());
+
+   alertPublisher.openLogFile(arguments[1]);
+
+   if (arguments.size() > 6)
+   {
+      alertPublisher.connectSocket(arguments[6]);
+   }
+
+   alertPublisher.setSymbolNames(symbolNames);
+
+   if (rate > 0.0)
+   {
+      alertPublisher.setRateLimit(rate, rate * BURSTSECONDS);
+   }
+
+   // Replay the ticks, publishing the alerts of their bars
+   ingestor.setAlertPublisher(&alertPublisher);
+   alertPublisher.start();
+
+   seconds = replayer.replay(ingestor, speed);
+   ingestor.flushBars();
+   alertPublisher.stop();
+
+   cout << "Replayed:" << endl;
+   ingestor.outputStatistics(seconds);
+   cout << "Alerts to " << arguments[1] << ":" << endl;
+   alertPublisher.outputStatistics(seconds);
+}
+
+//******************************************************************************
+// Function : runAlign                                   
+// Process  : Analyze the manifest, or the default stocks, without output
+//             Align the stocks on their TradingCalendar
+//             Output the calendar, and each stock's dates and missing dates
+// Notes    : -align [manifest]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runAlign(const vector<string>& arguments)
+{
+   PortfolioAnalyzer     portfolioAnalyzer; // Portfolio aligned
+   TradingCalendar       calendar;          // Of its stocks
+   vector<const Stock*>  stocks;            // Each analyzer's stock
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 1)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[1].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Align the stocks on their calendar
+   for (int analyzerIndex = 0; 
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+        ++analyzerIndex)
+   {
+      stocks.push_back(&portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockRef());
+   }
+
+   calendar.align(stocks);
+
+   if (0 == calendar.getNumDates())
+   {
+      cout << "No dates to align" << endl;
+      return;
+   }
+
+   // Output the calendar, and each stock's dates and missing dates
+   cout << "Aligned " << calendar.getNumSymbols() << " stocks on " 
+        << calendar.getNumDates() << " dates from " 
+        << TradingCalendar::formatDate(calendar.getDateAt(0)) << " to "
+        << TradingCalendar::formatDate(
+              calendar.getDateAt(calendar.getNumDates() - 1)) 
+        << ", " << calendar.getNumValid() << " prices" << endl << endl;
+   cout << setw(10) << left << "symbol" << right << setw(8) << "dates"
+        << setw(12) << "first" << setw(12) << "last" 
+        << setw(10) << "missing" << endl;
+
+   for (int symbolIndex = 0; symbolIndex < calendar.getNumSymbols(); 
+        ++symbolIndex)
+   {
+      const Stock& stock = *stocks[symbolIndex];
+
+      cout << setw(10) << left << portfolioAnalyzer.
+                 getStockAnalyzerRefAtIndex(symbolIndex).getStockSymbol() 
+           << right << setw(8) << stock.getNumDates();
+
+      if (stock.getNumDates() > 0)
+      {
+         cout << setw(12) << TradingCalendar::formatDate(stock.getDateAt(0))
+              << setw(12) << TradingCalendar::formatDate(
+                    stock.getDateAt(stock.getNumDates() - 1));
+      }
+      else
+      {
+         cout << setw(12) << "-" << setw(12) << "-";
+      }
+
+      cout << setw(10) << calendar.getNumDates() - stock.getNumDates() 
+           << endl;
+   }
+}
+
+//******************************************************************************
+// Function : runAllocations                                   
+// Process  : Load the manifest, or the default stocks
+//             Track allocations while analyzing without output and ranking
+//             Output the allocations of each phase and of the stocks 
+//                allocating the most, per stock
+// Notes    : -allocations [manifest]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runAllocations(const vector<string>& arguments)
+{
+   PortfolioAnalyzer portfolioAnalyzer; // Portfolio tracked
+   vector<int>       topIndices;        // Ranked stock analyzers
+
+   // Load the manifest, or the default stocks
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 1)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[1].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   // Track allocations while analyzing and ranking
+   AllocationTracker::reset();
+   AllocationTracker::setEnabled(true);
+   portfolioAnalyzer.analyzePortfolio();
+   portfolioAnalyzer.getTopStocksByMACDSlope(DEFAULTNUMTOPSTOCKS, topIndices);
+   AllocationTracker::setEnabled(false);
+
+   // Output the allocations per stock
+   cout << "Allocations of " << portfolioAnalyzer.getNumStockAnalyzers() 
+        << " stocks" << endl << endl;
+   AllocationTracker::outputSummary(
+      cout, NUMALLOCATIONDETAILS, portfolioAnalyzer.getNumStockAnalyzers());
+}
+
+//******************************************************************************
+// Function : runCorrelate                                   
+// Process  : Analyze the manifest, or the default stocks, without output
+//             Align the stocks on their TradingCalendar
+//             Correlate their daily returns
+//             Output each stock's most correlated neighbours
+// Notes    : -correlate [manifest] [neighbours]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runCorrelate(const vector<string>& arguments)
+{
+   PortfolioAnalyzer                    portfolioAnalyzer; // Portfolio
+   TradingCalendar                      calendar;          // Of its stocks
+   CorrelationMatrix                    correlationMatrix; // Of the calendar
+   vector<const Stock*>                 stocks;            // Each analyzer's
+   vector<CorrelationMatrix::Neighbour> neighbours;        // Of one stock
+   const int                            NUMNEIGHBOURS = 
+      (arguments.size() > 2) ? atoi(arguments[2].c_str()) : 
+                               DEFAULTNUMNEIGHBOURS;
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 1)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[1].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Align the stocks and correlate their daily returns
+   for (int analyzerIndex = 0; 
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+        ++analyzerIndex)
+   {
+      stocks.push_back(&portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockRef());
+   }
+
+   calendar.align(stocks);
+   correlationMatrix.setReturns(calendar);
+   correlationMatrix.calculate(NUMNEIGHBOURS, false);
+
+   // Output each stock's most correlated neighbours
+   cout << "Correlated " << correlationMatrix.getNumSymbols() 
+        << " stocks over " << correlationMatrix.getNumReturns() 
+        << " daily returns" << endl << endl;
+   cout << fixed << setprecision(3);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < correlationMatrix.getNumSymbols(); 
+        ++symbolIndex)
+   {
+      correlationMatrix.getNeighbours(symbolIndex, neighbours);
+
+      cout << setw(10) << left << portfolioAnalyzer.
+                 getStockAnalyzerRefAtIndex(symbolIndex).getStockSymbol();
+
+      for (size_t neighbourIndex = 0; neighbourIndex < neighbours.size(); 
+           ++neighbourIndex)
+      {
+         cout << setw(8) << portfolioAnalyzer.getStockAnalyzerRefAtIndex(
+                    neighbours[neighbourIndex].symbolIndex).getStockSymbol()
+              << right << setw(7) 
+              << neighbours[neighbourIndex].correlation << "   " << left;
+      }
+
+      cout << right << endl;
+   }
+
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : runCrossovers                                   
+// Process  : Analyze the manifest, or the default stocks, without output
+//             Detect the MACD crossovers of every bar of the stocks
+//             Output the number of each type, and the newest events
+// Notes    : -crossovers [manifest] [events]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runCrossovers(const vector<string>& arguments)
+{
+   PortfolioAnalyzer    portfolioAnalyzer; // Portfolio
+   CrossoverDetector    detector;          // Of its stocks
+   vector<const Stock*> stocks;            // Each analyzer's
+   vector<int>          numOfType(CrossoverDetector::NUMEVENTTYPES); // Events
+   const int            NUMEVENTS = 
+      (arguments.size() > 2) ? atoi(arguments[2].c_str()) : 
+                               DEFAULTNUMCROSSOVERS;
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 1)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[1].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Detect the crossovers of every bar of the stocks
+   for (int analyzerIndex = 0; 
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+        ++analyzerIndex)
+   {
+      stocks.push_back(&portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockRef());
+   }
+
+   detector.detect(stocks);
+
+   // Output the number of each type
+   for (int eventIndex = 0; eventIndex < detector.getNumEvents(); 
+        ++eventIndex)
+   {
+      ++numOfType[detector.getEventAt(eventIndex).type];
+   }
+
+   cout << "Found " << detector.getNumEvents() << " crossovers in " 
+        << detector.getNumBars() << " bars of " << detector.getNumSymbols()
+        << " stocks" << endl << endl;
+
+   for (int type = 0; type < CrossoverDetector::NUMEVENTTYPES; ++type)
+   {
+      cout << setw(20) << left << CrossoverDetector::getEventTypeName(
+                 CrossoverDetector::EventType(type)) 
+           << right << setw(10) << numOfType[type] << endl;
+   }
+
+   // Output the newest events, oldest first
+   cout << endl;
+
+   for (int eventIndex = max(0, detector.getNumEvents() - NUMEVENTS); 
+        eventIndex < detector.getNumEvents(); 
+        ++eventIndex)
+   {
+      const CrossoverDetector::Event& event = 
+         detector.getEventAt(eventIndex);
+      const Stock& stock = *stocks[event.symbolIndex];
+
+      cout << setw(10) << left << portfolioAnalyzer.
+                 getStockAnalyzerRefAtIndex(event.symbolIndex).
+                 getStockSymbol();
+
+      if (stock.getNumDates() == stock.getNumPrices())
+      {
+         cout << setw(12) << TradingCalendar::formatDate(event.date);
+      }
+      else
+      {
+         cout << "bar " << setw(8) << event.barIndex;
+      }
+
+      cout << CrossoverDetector::getEventTypeName(event.type) << right 
+           << endl;
+   }
+}
+
+//******************************************************************************
+// Function : runDaemon                                   
+// Process  : With a snapshot file that exists, restore the portfolio from
+//                the AnalyzerSnapshot
+//             Otherwise load the manifest, or the default stocks
+//                Analyze the portfolio once, without output
+//                Save its snapshot, if a snapshot file is given
+//             Publish it to the shared ranking, if one is named, with
+//                every BAR
+//             Serve it with an AnalysisDaemon until SHUTDOWN, SNAPSHOT
+//                saving to the snapshot file
+//             Save its snapshot again, with every BAR since
+// Notes    : -daemon [socket path] [manifest] [snapshot file]
+//                [shared ranking]
+//             A snapshot file of "-" is none
+//             The history is bounded, so BAR requests use no more memory
+//             A restored portfolio is exactly where the last daemon left
+//                it, the manifest is not read
+//             Other processes read the shared ranking with -shmtop, or a
+//                SharedRankingReader
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Bounds the history
+// 10.19.26       Donne Martin         Added the snapshot file
+// 10.19.26       Donne Martin         Added the shared ranking
+// 10.19.26       Donne Martin         SNAPSHOT saves to the snapshot file
+//******************************************************************************
+static void runDaemon(const vector<string>& arguments)
+{
+   PortfolioAnalyzer    portfolioAnalyzer; // Portfolio kept in memory
+   AnalyzerSnapshot     analyzerSnapshot;  // State of every stock
+   string               socketPath = AnalysisDaemon::DEFAULTSOCKETPATH;
+   string               snapshotFileName;  // Restored from and saved to
+   vector<string>       symbols;           // Of the shared ranking
+   SharedRankingWriter* sharedRanking = NULL; // Published to, if named
+
+   if (arguments.size() > 1)
+   {
+      socketPath = arguments[1];
+   }
+
+   if (arguments.size() > 3 && "-" != arguments[3])
+   {
+      snapshotFileName = arguments[3];
+   }
+
+   portfolioAnalyzer.setVerbose(false);
+   portfolioAnalyzer.setHistoryBounded(true);
+
+   // With a snapshot file that exists, restore the portfolio from it
+   if (!snapshotFileName.empty() && ifstream(snapshotFileName.c_str()).good())
+   {
+      analyzerSnapshot.load(snapshotFileName.c_str());
+      portfolioAnalyzer.addStocksFromSnapshot(analyzerSnapshot);
+
+      cout << "Restored " << analyzerSnapshot.getNumStocks() 
+           << " stocks from " << snapshotFileName << endl;
+   }
+   else
+   {
+      // Otherwise load the manifest, or the default stocks
+      if (arguments.size() > 2)
+      {
+         portfolioAnalyzer.addStocksFromManifest(arguments[2].c_str());
+      }
+      else
+      {
+         portfolioAnalyzer.addDefaultStocksToPortfolio();
+      }
+
+      // Analyze the portfolio once
+      portfolioAnalyzer.analyzePortfolio();
+
+      // Save its snapshot, if a snapshot file is given
+      if (!snapshotFileName.empty())
+      {
+         analyzerSnapshot.setFromPortfolio(portfolioAnalyzer);
+         analyzerSnapshot.save(snapshotFileName.c_str());
+      }
+   }
+
+   AnalysisDaemon daemon(portfolioAnalyzer); // Serves the portfolio
+
+   daemon.setSnapshotFileName(snapshotFileName);
+
+   // Publish it to the shared ranking, if one is named
+   if (arguments.size() > 4)
+   {
+      for (int analyzerIndex = 0; 
+           analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+           ++analyzerIndex)
+      {
+         symbols.push_back(portfolioAnalyzer.getStockAnalyzerRefAtIndex(
+            analyzerIndex).getStockSymbol());
+      }
+
+      sharedRanking = new SharedRankingWriter(
+         arguments[4], symbols, DEFAULTNUMTOPSTOCKS);
+      sharedRanking->publishPortfolio(portfolioAnalyzer);
+      daemon.setSharedRanking(sharedRanking);
+
+      cout << "Publishing the ranking to " << arguments[4] << endl;
+   }
+
+   cout << "Serving " << portfolioAnalyzer.getNumStockAnalyzers() 
+        << " stocks on " << socketPath << endl;
+
+   daemon.run(socketPath);
+
+   // The shared ranking closes once served
+   daemon.setSharedRanking(NULL);
+   delete sharedRanking;
+
+   // Save its snapshot again, with every BAR since
+   if (!snapshotFileName.empty())
+   {
+      analyzerSnapshot.setFromPortfolio(portfolioAnalyzer);
+      analyzerSnapshot.save(snapshotFileName.c_str());
+   }
+}
+
+//******************************************************************************
+// Function : runLoadGenerator                                   
+// Process  : Run a DaemonLoadGenerator against a running daemon
+// Notes    : -loadgen [socket path] [number of requests] [bars]
+//             BAR requests are only sent when the last argument is "bars"
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runLoadGenerator(const vector<string>& arguments)
+{
+   DaemonLoadGenerator loadGenerator; // Client sending the requests
+   string              socketPath  = AnalysisDaemon::DEFAULTSOCKETPATH;
+   int                 numRequests = DaemonLoadGenerator::DEFAULTNUMREQUESTS;
+
+   if (arguments.size() > 1)
+   {
+      socketPath = arguments[1];
+   }
+
+   if (arguments.size() > 2)
+   {
+      numRequests = atoi(arguments[2].c_str());
+   }
+
+   loadGenerator.run(
+      socketPath, 
+      numRequests, 
+      arguments.size() > 3 && "bars" == arguments[3]);
+}
+
+//******************************************************************************
+// Function : runMakeTicks                                   
+// Process  : Generate synthetic ticks with a TickReplayer
+//             Save them as a tick file
+// Notes    : -maketicks <tick file> [number of symbols] [number of ticks]
+//             Ticks are TICKFILEMICROS apart, round robin over the symbols
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runMakeTicks(const vector<string>& arguments)
+{
+   static const int       DEFAULTNUMSYMBOLS = 100;     // Symbols generated
+   static const int       DEFAULTNUMTICKS   = 1000000; // Ticks generated
+   static const long long TICKFILEMICROS    = 1000;    // Between ticks
+
+   TickReplayer replayer;                      // Generates the ticks
+   int          numSymbols = DEFAULTNUMSYMBOLS;
+   int          numTicks   = DEFAULTNUMTICKS;
+
+   if (arguments.size() < 2)
+   {
+      throw exception("-maketicks requires a tick file name");
+   }
+
+   if (arguments.size() > 2)
+   {
+      numSymbols = atoi(arguments[2].c_str());
+   }
+
+   if (arguments.size() > 3)
+   {
+      numTicks = atoi(arguments[3].c_str());
+   }
+
+   if (numSymbols < 1 || numTicks < 1)
+   {
+      throw exception("-maketicks requires positive counts");
+   }
+
+   replayer.generateTicks(numSymbols, numTicks, TICKFILEMICROS);
+   replayer.saveTickFile(arguments[1].c_str());
+
+   cout << "Wrote " << replayer.getNumTicks() << " ticks of " 
+        << replayer.getNumSymbols() << " symbols to " << arguments[1] << endl;
+}
+
+//******************************************************************************
+// Function : runMerge                                   
+// Process  : Load every shard result
+//             Merge their top stocks and output the ranking
+// Notes    : -merge <number of stocks> <result file> [result file ...]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runMerge(const vector<string>& arguments)
+{
+   vector<ShardResult>       shardResults; // Result of every shard
+   vector<ShardStockSummary> rankedStocks; // Merged ranking
+
+   if (arguments.size() < 3)
+   {
+      throw exception("-merge requires a number of stocks and result files");
+   }
+
+   // Load every shard result
+   shardResults.resize(arguments.size() - 2);
+
+   for (size_t resultIndex = 0; 
+        resultIndex < shardResults.size(); 
+        ++resultIndex)
+   {
+      shardResults[resultIndex].load(arguments[resultIndex + 2].c_str());
+   }
+
+   // Merge their top stocks and output the ranking
+   ShardResult::mergeTopStocks(
+      shardResults, atoi(arguments[1].c_str()), rankedStocks);
+   outputRankedStocks(rankedStocks);
+}
+
+//******************************************************************************
+// Function : runMetrics                                   
+// Process  : Enable Metrics
+//             Analyze the manifest, or the default stocks, without output
+//             Rank the top stocks
+//             Write the metrics as JSON and in the Prometheus text format
+//             Output the JSON
+// Notes    : -metrics <JSON file> <Prometheus file> [manifest]
+//             Throws an exception if a file can't be written
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runMetrics(const vector<string>& arguments)
+{
+   PortfolioAnalyzer portfolioAnalyzer; // Portfolio measured
+   vector<int>       topIndices;        // Ranked stock analyzers
+   ofstream          jsonFile;          // JSON export
+   ofstream          prometheusFile;    // Prometheus export
+
+   if (arguments.size() < 3)
+   {
+      throw exception("-metrics requires a JSON and a Prometheus file");
+   }
+
+   Metrics::setEnabled(true);
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 3)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[3].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+   portfolioAnalyzer.getTopStocksByMACDSlope(DEFAULTNUMTOPSTOCKS, topIndices);
+
+   // Write the metrics
+   jsonFile.open(arguments[1].c_str());
+   Metrics::writeJSON(jsonFile);
+   prometheusFile.open(arguments[2].c_str());
+   Metrics::writePrometheus(prometheusFile);
+
+   if (!jsonFile.good() || !prometheusFile.good())
+   {
+      throw exception("Could not write the metrics");
+   }
+
+   Metrics::writeJSON(cout);
+}
+
+//******************************************************************************
+// Function : runPack                                   
+// Process  : List the stock data files of the directory or manifest
+//             -pack writes a new UniversePack of them, -packappend adds
+//                their new rows to the pack
+//             Open the pack and output its symbols, rows, and size
+// Notes    : -pack <pack file> <directory or manifest>
+//             -packappend <pack file> <directory or manifest>
+//             Any manifest argument of the other options can be a pack
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runPack(const vector<string>& arguments)
+{
+   vector<string> stockDataFileNames; // Packed
+   UniversePack   universePack;       // Written
+   long long      numRows = 0;        // Of every symbol
+
+   if (arguments.size() < 3)
+   {
+      throw exception("-pack requires a pack file and a directory");
+   }
+
+   // List the stock data files of the directory or manifest
+   listStockDataFiles(arguments[2], stockDataFileNames);
+
+   if ("-packappend" == arguments[0])
+   {
+      UniversePack::appendStocks(arguments[1], stockDataFileNames);
+   }
+   else
+   {
+      UniversePack::buildPack(arguments[1], stockDataFileNames);
+   }
+
+   // Open the pack and output its symbols, rows, and size
+   universePack.open(arguments[1]);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < universePack.getNumSymbols(); 
+        ++symbolIndex)
+   {
+      numRows += universePack.getNumRows(symbolIndex);
+   }
+
+   cout << "Packed " << stockDataFileNames.size() << " stock data files, "
+        << universePack.getNumSymbols() << " symbols of " << numRows 
+        << " rows in " << universePack.getNumBytes() << " bytes, to " 
+        << arguments[1] << endl;
+}
+
+//******************************************************************************
+// Function : runRank                                   
+// Process  : Analyze the whole manifest as the only shard
+//             Output its top stocks
+// Notes    : -rank <manifest> [number of stocks] [slope periods]
+//             The single process ranking -merge reproduces
+//             With slope periods, stocks are ranked by the regression slope
+//                of their last slope periods MACDs, at least 2
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added slope periods
+// 10.19.26       Donne Martin         Checks the slope periods
+//******************************************************************************
+static void runRank(const vector<string>& arguments)
+{
+   vector<ShardResult>       shardResults(1); // The only shard
+   vector<ShardStockSummary> rankedStocks;    // Its ranking
+   int                       numTopStocks = DEFAULTNUMTOPSTOCKS;
+   int                       periodsSlope = 0; // MACD slope by default
+
+   if (arguments.size() < 2)
+   {
+      throw exception("-rank requires a manifest");
+   }
+
+   if (arguments.size() > 2)
+   {
+      numTopStocks = atoi(arguments[2].c_str());
+   }
+
+   if (arguments.size() > 3)
+   {
+      periodsSlope = parsePeriodsSlope(arguments[3]);
+   }
+
+   analyzeShard(
+      arguments[1], 0, 1, numTopStocks, shardResults[0], periodsSlope);
+   ShardResult::mergeTopStocks(shardResults, numTopStocks, rankedStocks);
+   outputRankedStocks(rankedStocks);
+}
+
+//******************************************************************************
+// Function : runReplay                                   
+// Process  : Load the tick file into a TickReplayer, or the default stocks'
+//                data files as one tick per open, high, low, and close
+//             Replay it through a TickIngestor at the speed, which turns
+//                the ticks into bars and updates each symbol's MACD
+//             Flush the last bars
+//             Output the ingestion statistics and the highest MACD slope
+// Notes    : -replay [tick file] [speed] [number of shards]
+//             A tick file of "-" or none replays the default stocks with 
+//                day bars, whose MACDs match the portfolio analysis
+//             Tick files are replayed with TICKFILEBARMICROS bars
+//             A speed of 0 replays as fast as possible, 1 in feed time
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Loads the ticks with loadTicks
+//******************************************************************************
+static void runReplay(const vector<string>& arguments)
+{
+   TickReplayer replayer;        // Feed of the ticks
+   double       speed     = 0.0; // Feed time multiple
+   int          numShards = 1;   // Worker threads
+   long long    barMicros = 0;   // Bar interval
+   int          highIndex = -1;  // Highest MACD slope
+
+   // Load the tick file, or the default stocks' data files
+   barMicros = loadTicks(
+      arguments.size() > 1 ? arguments[1] : string("-"), replayer);
+
+   if (arguments.size() > 2)
+   {
+      speed = atof(arguments[2].c_str());
+   }
+
+   if (arguments.size() > 3)
+   {
+      numShards = atoi(arguments[3].c_str());
+   }
+
+   TickIngestor ingestor(replayer.getNumSymbols(), numShards, barMicros);
+
+   // Replay it, then flush the last bars
+   double seconds = replayer.replay(ingestor, speed);
+   ingestor.flushBars();
+
+   ingestor.outputStatistics(seconds);
+
+   // Output the highest MACD slope
+   for (int symbolIndex = 0; 
+        symbolIndex < replayer.getNumSymbols(); 
+        ++symbolIndex)
+   {
+      const StockAnalyzer& stockAnalyzer = 
+         ingestor.getStockAnalyzer(symbolIndex);
+
+      if (stockAnalyzer.hasMACD() && 
+          (-1 == highIndex || stockAnalyzer.getSlopeMACD() > 
+             ingestor.getStockAnalyzer(highIndex).getSlopeMACD()))
+      {
+         highIndex = symbolIndex;
+      }
+   }
+
+   if (-1 == highIndex)
+   {
+      cout << "Not enough bars for a MACD" << endl;
+      return;
+   }
+
+   cout << "Highest MACD two day slope found replaying: " 
+        << replayer.getSymbol(highIndex) << endl;
+   cout << "Highest MACD two day slope value: " 
+        << ingestor.getStockAnalyzer(highIndex).getSlopeMACD() << endl;
+}
+
+//******************************************************************************
+// Function : runScreen                                   
+// Process  : Compile the screen
+//             Analyze the manifest, or the default stocks, without output
+//             Fill the columns the screen and the rank column use
+//             Screen the stocks and output the top stocks selected
+// Notes    : -screen <screen> [manifest] [number of stocks] [rank column]
+//             A manifest of "-" screens the default stocks
+//             The screen is one argument, such as 
+//                "macd > 0 && slope > 0.05 && close > sma200"
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runScreen(const vector<string>& arguments)
+{
+   PortfolioAnalyzer portfolioAnalyzer; // Portfolio screened
+   Screener          screener;          // Compiled screen
+   ScreenerColumns   columns;           // Of the portfolio
+   vector<string>    columnNames;       // Columns to fill
+   vector<int>       symbolIndices;     // Top stocks selected
+   int               numTopStocks = DEFAULTNUMTOPSTOCKS;
+   string            rankColumnName = DEFAULTRANKCOLUMN;
+
+   if (arguments.size() < 2)
+   {
+      throw exception("-screen requires a screen");
+   }
+
+   if (arguments.size() > 3)
+   {
+      numTopStocks = atoi(arguments[3].c_str());
+   }
+
+   if (arguments.size() > 4)
+   {
+      rankColumnName = arguments[4];
+   }
+
+   // Compile the screen
+   screener.compile(arguments[1]);
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 2 && "-" != arguments[2])
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[2].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Fill the columns the screen and the rank column use
+   columnNames = screener.getColumnNames();
+   columnNames.push_back(rankColumnName);
+   columns.setFromPortfolio(portfolioAnalyzer, columnNames);
+
+   // Screen the stocks and output the top stocks selected
+   screener.screen(columns, rankColumnName, numTopStocks, symbolIndices);
+
+   cout << setw(6) << "rank" << "  " << setw(10) << left << "symbol" 
+        << right << setw(26) << rankColumnName << endl;
+   cout << setprecision(17);
+
+   for (size_t rank = 0; rank < symbolIndices.size(); ++rank)
+   {
+      cout << setw(6) << rank + 1 << "  " << setw(10) << left 
+           << columns.getSymbolAt(symbolIndices[rank]) << right 
+           << setw(26) << columns.getColumnData(
+                 columns.findColumn(rankColumnName))[symbolIndices[rank]] 
+           << endl;
+   }
+
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : runShard                                   
+// Process  : Analyze the stocks of the manifest in the shard
+//             Save the shard result
+// Notes    : -shard <manifest> <shard index> <number of shards> 
+//                <result file> [number of top stocks]
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runShard(const vector<string>& arguments)
+{
+   ShardResult shardResult;                        // Partial result
+   int         numTopStocks = DEFAULTNUMTOPSTOCKS; // Top stocks kept
+
+   if (arguments.size() < 5)
+   {
+      throw exception("-shard requires a manifest, shard, shards, and file");
+   }
+
+   if (arguments.size() > 5)
+   {
+      numTopStocks = atoi(arguments[5].c_str());
+   }
+
+   analyzeShard(
+      arguments[1], 
+      atoi(arguments[2].c_str()), 
+      atoi(arguments[3].c_str()), 
+      numTopStocks, 
+      shardResult);
+   shardResult.save(arguments[4].c_str());
+
+   cout << "Shard " << shardResult.getShardIndex() << " of " 
+        << shardResult.getNumShards() << ": " 
+        << shardResult.getNumStocks() << " stocks" << endl;
+}
+
+//******************************************************************************
+// Function : runSharedReader                                   
+// Process  : Read the shared ranking until its writer closes it, as a
+//             reader process of the shared ranking benchmark
+// Notes    : -shmreader <shared ranking> <result file>
+//             See PortfolioBenchmark::runSharedRankingReader
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runSharedReader(const vector<string>& arguments)
+{
+   if (arguments.size() < 3)
+   {
+      throw exception("-shmreader requires a shared ranking and a file");
+   }
+
+   PortfolioBenchmark::runSharedRankingReader(arguments[1], arguments[2]);
+}
+
+//******************************************************************************
+// Function : runSharedTop                                   
+// Process  : Map the shared ranking of a running daemon
+//             Read its top stocks, all of one publish
+//             Output the rank, symbol, MACD, MACD slope, signal, histogram,
+//                and last close of each
+// Notes    : -shmtop <shared ranking> [number of stocks]
+//             At most the top stocks the writer publishes
+//             Full precision, as outputRankedStocks
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runSharedTop(const vector<string>& arguments)
+{
+   vector<int>                 topIndices;       // Read
+   vector<SharedSymbolSummary> topSummaries;     // Read
+   long long                   version      = 0; // Of the ranking
+   long long                   publishNanos = 0; // Of the ranking
+   int                         numTopStocks = DEFAULTNUMTOPSTOCKS;
+
+   if (arguments.size() < 2)
+   {
+      throw exception("-shmtop requires a shared ranking");
+   }
+
+   if (arguments.size() > 2)
+   {
+      numTopStocks = atoi(arguments[2].c_str());
+   }
+
+   SharedRankingReader reader(arguments[1]); // Of the daemon
+
+   // Read its top stocks, all of one publish
+   if (!reader.readTopStocks(topIndices, topSummaries, version, publishNanos))
+   {
+      throw exception("The shared ranking's writer stopped mid-publish");
+   }
+
+   numTopStocks = max(0, min(numTopStocks, int(topIndices.size())));
+
+   cout << "Version " << version << " of " << reader.getNumSymbols() 
+        << " stocks" << (reader.isClosed() ? ", writer closed" : "") 
+        << endl;
+   cout << setw(6) << "rank" << "  " << setw(10) << left << "symbol" 
+        << right << setw(26) << "MACD" << setw(26) << "MACD slope" 
+        << setw(26) << "signal" << setw(26) << "histogram" 
+        << setw(26) << "last close" << endl;
+   cout << setprecision(17);
+
+   for (int rank = 0; rank < numTopStocks; ++rank)
+   {
+      const SharedSymbolSummary& summary = topSummaries[rank];
+
+      cout << setw(6) << summary.rank << "  " << setw(10) << left 
+           << reader.getSymbolName(topIndices[rank]) << right
+           << setw(26) << summary.currentMACD 
+           << setw(26) << summary.slopeMACD;
+
+      if (0 != summary.hasSignal)
+      {
+         cout << setw(26) << summary.signal 
+              << setw(26) << summary.histogram;
+      }
+      else
+      {
+         cout << setw(26) << "-" << setw(26) << "-";
+      }
+
+      cout << setw(26) << summary.lastClose << endl;
+   }
+
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : runShardLocal                                   
+// Process  : Start a -shard process of this program for every shard
+//             Wait for them all, any failure fails the run
+//             Load and delete their results
+//             Merge their top stocks and output the ranking
+//             Check it is identical to analyzing the whole manifest here
+// Notes    : -shardlocal <manifest> <number of shards> [number of stocks]
+//             Results are written next to the manifest
+//             Throws an exception if the rankings differ
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runShardLocal(
+   const string& programPath,
+   const vector<string>& arguments)
+{
+   vector<long long>         processes;     // Shard processes
+   vector<string>            resultNames;   // Result of each shard
+   vector<ShardResult>       shardResults;  // Loaded results
+   vector<ShardResult>       wholeResult(1); // Whole manifest, one process
+   vector<ShardStockSummary> rankedStocks;  // Merged ranking
+   vector<ShardStockSummary> singleStocks;  // Single process ranking
+   int                       numShards    = 0;
+   int                       numTopStocks = DEFAULTNUMTOPSTOCKS;
+   bool                      failed       = false; // A shard failed?
+
+   if (arguments.size() < 3)
+   {
+      throw exception("-shardlocal requires a manifest and number of shards");
+   }
+
+   numShards = atoi(arguments[2].c_str());
+
+   if (arguments.size() > 3)
+   {
+      numTopStocks = atoi(arguments[3].c_str());
+   }
+
+   if (numShards < 1)
+   {
+      throw exception("Invalid manifest shard");
+   }
+
+   // Start a -shard process of this program for every shard
+   for (int shardIndex = 0; shardIndex < numShards; ++shardIndex)
+   {
+      ostringstream  resultName; // Next to the manifest
+      ostringstream  shard;      // Shard index argument
+      ostringstream  shards;     // Number of shards argument
+      ostringstream  topStocks;  // Number of top stocks argument
+      vector<string> shardArguments;
+
+      resultName << arguments[1] << ".shard" << shardIndex;
+      shard      << shardIndex;
+      shards     << numShards;
+      topStocks  << numTopStocks;
+      resultNames.push_back(resultName.str());
+
+      shardArguments.push_back(programPath);
+      shardArguments.push_back("-shard");
+      shardArguments.push_back(arguments[1]);
+      shardArguments.push_back(shard.str());
+      shardArguments.push_back(shards.str());
+      shardArguments.push_back(resultName.str());
+      shardArguments.push_back(topStocks.str());
+
+      processes.push_back(Platform::startProcess(shardArguments));
+   }
+
+   // Wait for them all
+   for (int shardIndex = 0; shardIndex < numShards; ++shardIndex)
+   {
+      if (0 != Platform::waitForProcess(processes[shardIndex]))
+      {
+         failed = true;
+      }
+   }
+
+   if (failed)
+   {
+      throw exception("A shard process failed");
+   }
+
+   // Load and delete their results
+   shardResults.resize(numShards);
+
+   for (int shardIndex = 0; shardIndex < numShards; ++shardIndex)
+   {
+      shardResults[shardIndex].load(resultNames[shardIndex].c_str());
+      remove(resultNames[shardIndex].c_str());
+   }
+
+   // Merge their top stocks and output the ranking
+   ShardResult::mergeTopStocks(shardResults, numTopStocks, rankedStocks);
+   outputRankedStocks(rankedStocks);
+
+   // Check it is identical to analyzing the whole manifest here
+   analyzeShard(arguments[1], 0, 1, numTopStocks, wholeResult[0]);
+   ShardResult::mergeTopStocks(wholeResult, numTopStocks, singleStocks);
+
+   for (size_t rank = 0; rank < max(rankedStocks.size(), singleStocks.size()); 
+        ++rank)
+   {
+      if (rank >= rankedStocks.size() || rank >= singleStocks.size() ||
+          rankedStocks[rank].symbol != singleStocks[rank].symbol ||
+          rankedStocks[rank].manifestIndex != 
+             singleStocks[rank].manifestIndex ||
+          rankedStocks[rank].slopeMACD != singleStocks[rank].slopeMACD ||
+          rankedStocks[rank].currentMACD != singleStocks[rank].currentMACD)
+      {
+         throw exception("Merged ranking differs from the single process");
+      }
+   }
+
+   cout << "Merged ranking of " << numShards 
+        << " shards matches the single process ranking" << endl;
+}
+
+//******************************************************************************
+// Function : runStream                                   
+// Process  : Open the manifest if it is a pack, otherwise list the stock
+//                data files of the directory or manifest
+//             Analyze them with a StreamingAnalyzer under the memory limit,
+//                with bounded history as -rank does
+//             Output the top stocks as -rank does, then the batches and
+//                memory
+// Notes    : -stream <manifest> <memory MB> [stocks] [slope periods]
+//             Throws an exception unless the memory limit is positive
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Checks the slope periods
+// 10.19.26       Donne Martin         Requires a positive memory limit
+//******************************************************************************
+static void runStream(const vector<string>& arguments)
+{
+   static const double BYTESPERMB = 1024.0 * 1024.0; // Memory limit unit
+
+   StreamingAnalyzer streamingAnalyzer;  // Analyzes a batch at a time
+   UniversePack      universePack;       // When the manifest is a pack
+   vector<string>    stockDataFileNames; // Otherwise
+   long long         memoryLimitBytes;   // From the memory limit in MB
+
+   if (arguments.size() < 3)
+   {
+      throw exception("-stream requires a manifest and a memory limit");
+   }
+
+   memoryLimitBytes = (long long)(atof(arguments[2].c_str()) * BYTESPERMB);
+
+   if (memoryLimitBytes <= 0)
+   {
+      throw exception("-stream memory limit must be positive");
+   }
+
+   streamingAnalyzer.setMemoryLimitBytes(memoryLimitBytes);
+   streamingAnalyzer.setNumTopStocks(DEFAULTNUMTOPSTOCKS);
+   streamingAnalyzer.setHistoryBounded(true);
+
+   if (arguments.size() > 3)
+   {
+      streamingAnalyzer.setNumTopStocks(atoi(arguments[3].c_str()));
+   }
+
+   if (arguments.size() > 4)
+   {
+      streamingAnalyzer.setPeriodsSlope(parsePeriodsSlope(arguments[4]));
+   }
+
+   // Analyze the pack, or the stock data files, under the memory limit
+   if (UniversePack::isPackFile(arguments[1]))
+   {
+      universePack.open(arguments[1]);
+      streamingAnalyzer.analyzePack(universePack);
+   }
+   else
+   {
+      listStockDataFiles(arguments[1], stockDataFileNames);
+      streamingAnalyzer.analyzeStockDataFiles(stockDataFileNames);
+   }
+
+   // Output the top stocks as -rank does, then the batches and memory
+   outputRankedStocks(streamingAnalyzer.getTopStocks());
+
+   cout << endl << "Streamed " << streamingAnalyzer.getNumStocks() 
+        << " stocks in " << streamingAnalyzer.getNumBatches() 
+        << " batches of at most " << streamingAnalyzer.getMaxBatchStocks()
+        << " stocks" << endl;
+   cout << "Stocks with a positive slope: " 
+        << streamingAnalyzer.getNumPositiveSlopes() << ", mean MACD: " 
+        << streamingAnalyzer.getMeanMACD() << endl;
+   cout << fixed << setprecision(1) << "Analyzers held " 
+        << streamingAnalyzer.getAccountedBytes() / BYTESPERMB 
+        << " MB in all, peak resident set " 
+        << streamingAnalyzer.getPeakResidentBytes() / BYTESPERMB << " MB" 
+        << endl;
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : runTimeframes                                   
+// Process  : Analyze the manifest, or the default stocks, without output
+//             Analyze the daily, weekly, and monthly MACD of each dated
+//                stock in one pass of a TimeframeAnalyzer
+//             For each timeframe, output the top stocks by MACD slope, with
+//                whether MACD is above its signal in every timeframe
+// Notes    : -timeframes [manifest] [stocks]
+//             A stock without a date per price is left out
+//             + is MACD above signal, - below, blank without a signal
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runTimeframes(const vector<string>& arguments)
+{
+   const int NUMTIMEFRAMES = TimeframeAnalyzer::NUMTIMEFRAMES;
+   const int NUMSTOCKS     = (arguments.size() > 2) ? 
+                                atoi(arguments[2].c_str()) : 
+                                DEFAULTNUMTIMEFRAMESTOCKS;
+
+   PortfolioAnalyzer      portfolioAnalyzer; // Portfolio
+   TimeframeAnalyzer      timeframeAnalyzer; // Of each stock in turn
+   vector<int>            analyzerIndices;   // Of each dated stock
+   vector<vector<int>>    ranked(NUMTIMEFRAMES); // Stocks with a MACD slope
+   vector<vector<double>> slopes(NUMTIMEFRAMES);  // Per timeframe and stock
+   vector<vector<double>> macds(NUMTIMEFRAMES);   // Per timeframe and stock
+   vector<vector<double>> signals(NUMTIMEFRAMES); // Per timeframe and stock
+   vector<string>         aboveSignals;      // A flag per timeframe, each
+
+   // Analyze the manifest, or the default stocks, without output
+   portfolioAnalyzer.setVerbose(false);
+
+   if (arguments.size() > 1)
+   {
+      portfolioAnalyzer.addStocksFromManifest(arguments[1].c_str());
+   }
+   else
+   {
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+   }
+
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Analyze every timeframe of each dated stock in one pass
+   for (int analyzerIndex = 0; 
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+        ++analyzerIndex)
+   {
+      const Stock& stock = portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockRef();
+      string       flags(NUMTIMEFRAMES, ' '); // Above signal, per timeframe
+
+      if (stock.getNumDates() != stock.getNumPrices())
+      {
+         continue;
+      }
+
+      timeframeAnalyzer.analyzeStock(stock);
+      analyzerIndices.push_back(analyzerIndex);
+
+      for (int timeframe = 0; timeframe < NUMTIMEFRAMES; ++timeframe)
+      {
+         const TimeframeAnalyzer::Timeframe TIMEFRAME = 
+            TimeframeAnalyzer::Timeframe(timeframe);
+
+         slopes[timeframe].push_back(
+            timeframeAnalyzer.getSlopeMACD(TIMEFRAME));
+         macds[timeframe].push_back(timeframeAnalyzer.getMACD(TIMEFRAME));
+         signals[timeframe].push_back(
+            timeframeAnalyzer.getSignal(TIMEFRAME));
+
+         if (timeframeAnalyzer.hasMACD(TIMEFRAME))
+         {
+            ranked[timeframe].push_back(analyzerIndices.size() - 1);
+         }
+
+         if (timeframeAnalyzer.hasSignal(TIMEFRAME))
+         {
+            flags[timeframe] = 
+               macds[timeframe].back() > signals[timeframe].back() ? 
+                  '+' : '-';
+         }
+      }
+
+      aboveSignals.push_back(flags);
+   }
+
+   cout << "Analyzed " << analyzerIndices.size() << " of " 
+        << portfolioAnalyzer.getNumStockAnalyzers() 
+        << " stocks, MACD above signal daily, weekly, monthly" << endl;
+
+   // Output the top stocks of each timeframe by MACD slope
+   for (int timeframe = 0; timeframe < NUMTIMEFRAMES; ++timeframe)
+   {
+      const TimeframeAnalyzer::Timeframe TIMEFRAME = 
+         TimeframeAnalyzer::Timeframe(timeframe);
+      const int NUMRANKED = min(NUMSTOCKS, int(ranked[timeframe].size()));
+
+      sort(ranked[timeframe].begin(), ranked[timeframe].end(), 
+           ValueGreater(slopes[timeframe]));
+
+      cout << endl << "---" << TimeframeAnalyzer::getTimeframeName(TIMEFRAME)
+           << "---" << endl << endl;
+      cout << setw(6) << "rank" << "  " << setw(10) << left << "symbol" 
+           << right << setw(14) << "MACD slope" << setw(14) << "MACD" 
+           << setw(14) << "signal" << "   DWM" << endl;
+      cout << fixed << setprecision(6);
+
+      for (int rank = 0; rank < NUMRANKED; ++rank)
+      {
+         const int STOCKINDEX = ranked[timeframe][rank];
+
+         cout << setw(6) << rank + 1 << "  " << setw(10) << left 
+              << portfolioAnalyzer.getStockAnalyzerRefAtIndex(
+                    analyzerIndices[STOCKINDEX]).getStockSymbol() 
+              << right << setw(14) << slopes[timeframe][STOCKINDEX] 
+              << setw(14) << macds[timeframe][STOCKINDEX] 
+              << setw(14) << signals[timeframe][STOCKINDEX] 
+              << "   " << aboveSignals[STOCKINDEX] << endl;
+      }
+
+      if (0 == NUMRANKED)
+      {
+         cout << "No stock has the bars for a MACD slope" << endl;
+      }
+
+      cout.unsetf(ios::floatfield);
+      cout << setprecision(6);
+   }
+}
 
 //******************************************************************************
 // Function : main                                   
 // Process  : Runs PortfolioAnalyzer            
+//             -alerts <log file> [tick file] [speed] [shards] [alerts per
+//                second] [socket path] replays ticks as -replay does and
+//                publishes their MACD alerts to the log file and socket
+//             -align [manifest] aligns the stocks on their TradingCalendar
+//             -allocations [manifest] outputs the analysis' allocations
+//             -benchmark [name] runs PortfolioBenchmark instead
+//             -correlate [manifest] [neighbours] outputs each stock's most
+//                correlated stocks by daily returns
+//             -crossovers [manifest] [events] outputs the MACD crossovers
+//                of every bar of the stocks, and the newest events
+//             -daemon [socket path] [manifest] [snapshot file] runs an 
+//                AnalysisDaemon, restored from the snapshot file if it 
+//                exists, which is saved at startup, SNAPSHOT, and SHUTDOWN
+//             -loadgen [socket path] [requests] [bars] runs a 
+//                DaemonLoadGenerator against a daemon
+//             -maketicks <tick file> [symbols] [ticks] writes synthetic ticks
+//             -replay [tick file] [speed] [shards] replays ticks through a
+//                TickIngestor
+//             -rank <manifest> [stocks] [slope periods] ranks the 
+//                manifest's top stocks, by the regression slope of MACD 
+//                over slope periods when given
+//             -screen <screen> [manifest] [stocks] [rank column] outputs
+//                the top stocks the Screener selects
+//             -shard <manifest> <shard> <shards> <result file> [stocks]
+//                analyzes one shard of the manifest into a ShardResult
+//             -merge <stocks> <result files> ranks the shards' top stocks
+//             -shardlocal <manifest> <shards> [stocks] runs a -shard 
+//                process per shard, merges, and checks against -rank
+//             -metrics <JSON file> <Prometheus file> [manifest] writes the
+//                analysis' phase timers and counters
+//             -pack <pack file> <directory or manifest> writes a
+//                UniversePack of the stock data files, -packappend adds 
+//                their new rows to one, a manifest can then be the pack
+//             -stream <manifest> <memory MB> [stocks] [slope periods]
+//                ranks as -rank does, a batch of stocks at a time, 
+//                keeping the process under the memory limit, which must
+//                be positive
+//             -timeframes [manifest] [stocks] ranks the stocks by daily,
+//                weekly, and monthly MACD slope
+//             -trace <trace file> before any of the above, or alone, traces
+//                the run with Tracer and writes the trace file at exit
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Added -benchmark, -daemon, -loadgen
+// 10.19.26       Donne Martin         Added -maketicks, -replay
+// 10.19.26       Donne Martin         Added -rank, -shard, -merge, -shardlocal
+// 10.19.26       Donne Martin         Added -metrics
+// 10.19.26       Donne Martin         Added -trace
+// 10.19.26       Donne Martin         Added -allocations
+// 10.19.26       Donne Martin         Added -align
+// 10.19.26       Donne Martin         Added -correlate
+// 10.19.26       Donne Martin         Added -rank slope periods
+// 10.19.26       Donne Martin         Added -screen
+// 10.19.26       Donne Martin         Added -pack and -packappend
+// 10.19.26       Donne Martin         Added -crossovers
+// 10.19.26       Donne Martin         Added -alerts
+// 10.19.26       Donne Martin         Added -timeframes
+// 10.19.26       Donne Martin         Added the -daemon snapshot file
+// 10.19.26       Donne Martin         Added -shmtop and -shmreader
 //******************************************************************************
 int _tmain(int argc, _TCHAR* argv[])
 {
+   vector<string> arguments;           // Command line arguments
+   bool           pauseBeforeExit = true; // Interactive run?
+   int            exitCode        = 0;    // Returned to the shell
+
+   for (int argIndex = 1; argIndex < argc; ++argIndex)
+   {
+      arguments.push_back(narrowArgument(argv[argIndex]));
+   }
+
+   if (!arguments.empty())
+   {
+      pauseBeforeExit = false;
+   }
+
+   try
+   {
+      // Trace the run, the trace is written at exit
+      if (arguments.size() > 1 && "-trace" == arguments[0])
+      {
+         Tracer::start(arguments[1]);
+         Tracer::setThreadName("main");
+         arguments.erase(arguments.begin(), arguments.begin() + 2);
+      }
+
+      if (!arguments.empty() && "-alerts" == arguments[0])
+      {
+         runAlerts(arguments);
+      }
+      else if (!arguments.empty() && "-align" == arguments[0])
+      {
+         runAlign(arguments);
+      }
+      else if (!arguments.empty() && "-allocations" == arguments[0])
+      {
+         runAllocations(arguments);
+      }
+      else if (!arguments.empty() && "-benchmark" == arguments[0])
+      {
+         PortfolioBenchmark benchmark; // Runs the benchmarks
+
+         benchmark.setProgramPath(narrowArgument(argv[0]));
+
+         if (!benchmark.runBenchmark(
+                arguments.size() > 1 ? arguments[1] : string("all")))
+         {
+            cout << "Unknown benchmark" << endl;
+            exitCode = 1;
+         }
+      }
+      else if (!arguments.empty() && "-correlate" == arguments[0])
+      {
+         runCorrelate(arguments);
+      }
+      else if (!arguments.empty() && "-crossovers" == arguments[0])
+      {
+         runCrossovers(arguments);
+      }
+      else if (!arguments.empty() && "-daemon" == arguments[0])
+      {
+         runDaemon(arguments);
+      }
+      else if (!arguments.empty() && "-loadgen" == arguments[0])
+      {
+         runLoadGenerator(arguments);
+      }
+      else if (!arguments.empty() && "-maketicks" == arguments[0])
+      {
+         runMakeTicks(arguments);
+      }
+      else if (!arguments.empty() && "-replay" == arguments[0])
+      {
+         runReplay(arguments);
+      }
+      else if (!arguments.empty() && "-rank" == arguments[0])
+      {
+         runRank(arguments);
+      }
+      else if (!arguments.empty() && "-screen" == arguments[0])
+      {
+         runScreen(arguments);
+      }
+      else if (!arguments.empty() && "-shard" == arguments[0])
+      {
+         runShard(arguments);
+      }
+      else if (!arguments.empty() && "-merge" == arguments[0])
+      {
+         runMerge(arguments);
+      }
+      else if (!arguments.empty() && "-shmreader" == arguments[0])
+      {
+         runSharedReader(arguments);
+      }
+      else if (!arguments.empty() && "-shmtop" == arguments[0])
+      {
+         runSharedTop(arguments);
+      }
+      else if (!arguments.empty() && "-shardlocal" == arguments[0])
+      {
+         runShardLocal(narrowArgument(argv[0]), arguments);
+      }
+      else if (!arguments.empty() && "-metrics" == arguments[0])
+      {
+         runMetrics(arguments);
+      }
+      else if (!arguments.empty() && 
+               ("-pack" == arguments[0] || "-packappend" == arguments[0]))
+      {
+         runPack(arguments);
+      }
+      else if (!arguments.empty() && "-stream" == arguments[0])
+      {
+         runStream(arguments);
+      }
+      else if (!arguments.empty() && "-timeframes" == arguments[0])
+      {
+         runTimeframes(arguments);
+      }
+      else
+      {
+         PortfolioAnalyzer portfolioAnalyzer; // Analyzes the list of stocks
+         portfolioAnalyzer.addDefaultStocksToPortfolio();
+         portfolioAnalyzer.analyzePortfolio();
+      }
+   }
+   catch (const exception& exception)
+   {
+      cout << exception.what() << endl;
+      cout << "Terminating program" << endl;
+      exitCode = 1;
+   }
+
    try
    {
-      PortfolioAnalyzer portfolioAnalyzer; // Analyzes the list of stocks
-      portfolioAnalyzer.addDefaultStocksToPortfolio();
-      portfolioAnalyzer.analyzePortfolio();
+      Tracer::stop();
    }
    catch (const exception& exception)
    {
       cout << exception.what() << endl;
-      cout << "Terminating program" << endl;
+      exitCode = 1;
    }
       
-   char pauseBeforeTerminate = ' '; // Don't let the program terminate by itself
-   cin >> pauseBeforeTerminate;
+   if (pauseBeforeExit)
+   {
+      char pauseBeforeTerminate = ' '; // Don't let the program terminate by itself
+      cin >> pauseBeforeTerminate;
+   }
 
-   return 0;
+   return exitCode;
 }
 
 //******************************************************************************
 // Function : constructor                                   
-// Process  : None
+// Process  : Output the analysis by default
+//             Keep the whole history by default
+//             Rank by the MACD slope by default
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Initializes verbose
+// 10.19.26       Donne Martin         Initializes historyBounded
+// 10.19.26       Donne Martin         Initializes periodsSlope
 //******************************************************************************                    
 PortfolioAnalyzer::PortfolioAnalyzer() 
 {
+   this->setVerbose(true);
+   this->setHistoryBounded(false);
+   this->setPeriodsSlope(StockAnalyzer::DEFAULTSLOPEPERIODS);
 } // end PortfolioAnalyzer::PortfolioAnalyzer
 
 //******************************************************************************
@@ -121,20 +2111,296 @@ void PortfolioAnalyzer::addDefaultStocksToPortfolio()
    this->setStockDataFiles(stockDataFileNames);
 }
 
+//******************************************************************************
+// Function : addStocksFromManifest                                   
+// Process  : Read every line of the manifest
+//                Strip surrounding whitespace
+//                Skip blank lines and comments
+//                Count the file name's position in the manifest
+//                Keep the file name if its symbol is in our shard
+//             Set our data files to the file names read
+//             Remember each file's position in the manifest
+// Notes    : Throws an exception if the manifest can't be read or the
+//             shard is invalid
+//             stockDataFileNames points into manifestFileNames, so those are
+//             not modified again until the next manifest
+//             A manifest that is a UniversePack is mapped and added with
+//                addStocksFromPack instead
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added shards
+// 10.19.26       Donne Martin         Added universe packs
+//******************************************************************************
+void PortfolioAnalyzer::addStocksFromManifest(
+   const char* manifestFileName,
+   const int shardIndex,
+   const int numShards)
+{
+   static const char* WHITESPACE = " \t\r\n"; // Stripped from each line
+   static const char  COMMENT    = '#';        // Starts a comment line
+   vector<char*>      stockDataFileNames;      // List of stock data file names
+   vector<int>        manifestIndices;         // Position of each file name
+   ifstream           fin;                     // Manifest reader
+   string             line;                    // Line of the manifest
+   string             fileName;                // File name of the line
+   size_t             first      = 0;          // First non whitespace char
+   size_t             last       = 0;          // Last non whitespace char
+   int                numListed  = 0;          // File names in the manifest
+
+   if (numShards < 1 || shardIndex < 0 || shardIndex >= numShards)
+   {
+      throw exception("Invalid manifest shard");
+   }
+
+   if (UniversePack::isPackFile(manifestFileName))
+   {
+      UniversePack universePack; // Mapped until its stocks are added
+
+      universePack.open(manifestFileName);
+      this->addStocksFromPack(universePack, shardIndex, numShards);
+      return;
+   }
+
+   fin.open(manifestFileName);
+
+   if (!fin.good())
+   {
+      throw exception("Could not read the manifest");
+   }
+
+   this->manifestFileNames.clear();
+
+   // Read every line of the manifest
+   while (getline(fin, line))
+   {
+      // Strip surrounding whitespace
+      first = line.find_first_not_of(WHITESPACE);
+
+      // Skip blank lines and comments
+      if (string::npos == first || COMMENT == line[first])
+      {
+         continue;
+      }
+
+      last     = line.find_last_not_of(WHITESPACE);
+      fileName = line.substr(first, last - first + 1);
+
+      // Keep the file name if its symbol is in our shard
+      if (1 == numShards || shardIndex == PortfolioAnalyzer::getShardOfSymbol(
+             StockAnalyzer::getSymbolFromFileName(fileName.c_str()), 
+             numShards))
+      {
+         this->manifestFileNames.push_back(fileName);
+         manifestIndices.push_back(numListed);
+      }
+
+      ++numListed;
+   }
+
+   // Set our data files to the file names read
+   stockDataFileNames.reserve(this->manifestFileNames.size());
+
+   for (size_t fileIndex = 0; 
+        fileIndex < this->manifestFileNames.size(); 
+        ++fileIndex)
+   {
+      stockDataFileNames.push_back(&this->manifestFileNames[fileIndex][0]);
+   }
+
+   this->setStockDataFiles(stockDataFileNames);
+
+   // Remember each file's position in the manifest
+   this->manifestIndices = manifestIndices;
+}
+
+//******************************************************************************
+// Function : addStocksFromPack                                   
+// Process  : Keep the pack's symbols in our shard, and their rows
+//                Remember each symbol's position in the directory
+//             Set our data files to the symbols, an analyzer's symbol is
+//                its data file name without a directory or extension
+//             Load each stock's dates, closes, and bars from the pack, and
+//                its newest bar
+// Notes    : Throws an exception if the shard or range is invalid
+//             Symbols with no rows are skipped, analyzePortfolio would try
+//                to parse a data file named for the symbol
+//             The histories are copied, the pack can be closed after
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added the symbol range
+// 10.19.26       Donne Martin         Loads the bars
+//******************************************************************************
+void PortfolioAnalyzer::addStocksFromPack(
+   const UniversePack& universePack,
+   const int           shardIndex,
+   const int           numShards,
+   const int           firstSymbolIndex,
+   const int           endSymbolIndex)
+{
+   METRICS_TIMER(PHASEPACKLOAD);
+
+   vector<char*> stockDataFileNames; // Symbols of the stocks added
+   vector<int>   manifestIndices;    // Directory index of each stock
+   Stock         stock;              // History of a stock
+   Bar           lastBar;            // Newest bar of a stock
+   string        symbol;             // Of a directory entry
+
+   if (numShards < 1 || shardIndex < 0 || shardIndex >= numShards)
+   {
+      throw exception("Invalid manifest shard");
+   }
+
+   int endIndex = (endSymbolIndex < 0) ? universePack.getNumSymbols() : 
+                                         endSymbolIndex; // Past the range
+
+   if (firstSymbolIndex < 0 || firstSymbolIndex > endIndex || 
+       endIndex > universePack.getNumSymbols())
+   {
+      throw exception("Invalid pack symbol range");
+   }
+
+   this->manifestFileNames.clear();
+
+   // Keep the pack's symbols in our shard, and their rows
+   for (int symbolIndex = firstSymbolIndex; 
+        symbolIndex < endIndex; 
+        ++symbolIndex)
+   {
+      symbol = universePack.getSymbolAt(symbolIndex);
+
+      if (universePack.getNumRows(symbolIndex) > 0 &&
+          (1 == numShards || shardIndex == 
+              PortfolioAnalyzer::getShardOfSymbol(symbol, numShards)))
+      {
+         // Remember each symbol's position in the directory
+         this->manifestFileNames.push_back(symbol);
+         manifestIndices.push_back(symbolIndex);
+      }
+   }
+
+   // Set our data files to the symbols
+   stockDataFileNames.reserve(this->manifestFileNames.size());
+
+   for (size_t fileIndex = 0; 
+        fileIndex < this->manifestFileNames.size(); 
+        ++fileIndex)
+   {
+      stockDataFileNames.push_back(&this->manifestFileNames[fileIndex][0]);
+   }
+
+   this->setStockDataFiles(stockDataFileNames);
+   this->manifestIndices = manifestIndices;
+
+   // Load each stock's dates, closes, and bars from the pack, and its newest
+   // bar
+   lastBar.startMicros = 0;
+   lastBar.numTicks    = 1;
+
+   for (size_t analyzerIndex = 0; 
+        analyzerIndex < manifestIndices.size(); 
+        ++analyzerIndex)
+   {
+      int symbolIndex = manifestIndices[analyzerIndex];     // In the pack
+      int newestRow   = universePack.getNumRows(symbolIndex) - 1;
+
+      stock.setHistory(universePack.getDates(symbolIndex), 
+                       universePack.getCloses(symbolIndex), 
+                       newestRow + 1);
+      stock.setBars(universePack.getHighs(symbolIndex), 
+                    universePack.getLows(symbolIndex), 
+                    universePack.getVolumes(symbolIndex), 
+                    newestRow + 1);
+      this->setStockAtIndex(analyzerIndex, stock);
+
+      lastBar.open   = universePack.getOpens(symbolIndex)[newestRow];
+      lastBar.high   = universePack.getHighs(symbolIndex)[newestRow];
+      lastBar.low    = universePack.getLows(symbolIndex)[newestRow];
+      lastBar.close  = universePack.getCloses(symbolIndex)[newestRow];
+      lastBar.volume = universePack.getVolumes(symbolIndex)[newestRow];
+      this->stockAnalyzers[analyzerIndex].setLastBar(lastBar);
+   }
+}
+
+//******************************************************************************
+// Function : addStocksFromSnapshot                                   
+// Process  : Keep the snapshot's stock data file names
+//             Set our data files to them, bounded, with the snapshot's 
+//                ranking slope periods
+//             Set each stock's manifest index
+//             Restore each analyzer from its state
+// Notes    : Throws an exception if a state is invalid
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioAnalyzer::addStocksFromSnapshot(
+   const AnalyzerSnapshot& analyzerSnapshot)
+{
+   METRICS_TIMER(PHASESNAPSHOTLOAD);
+
+   const int     NUMSTOCKS = analyzerSnapshot.getNumStocks();
+   vector<char*> stockDataFileNames; // Of the stocks added
+
+   // Keep the snapshot's stock data file names
+   this->manifestFileNames.resize(NUMSTOCKS);
+
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      this->manifestFileNames[stockIndex] = 
+         analyzerSnapshot.getStockDataFileNameAt(stockIndex);
+   }
+
+   stockDataFileNames.reserve(NUMSTOCKS);
+
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      stockDataFileNames.push_back(&this->manifestFileNames[stockIndex][0]);
+   }
+
+   // Set our data files to them, bounded, with the snapshot's ranking 
+   // slope periods
+   this->setHistoryBounded(true);
+   this->setPeriodsSlope(analyzerSnapshot.getPeriodsSlope());
+   this->setStockDataFiles(stockDataFileNames);
+
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      // Set each stock's manifest index
+      this->manifestIndices[stockIndex] = 
+         analyzerSnapshot.getManifestIndexAt(stockIndex);
+
+      // Restore each analyzer from its state
+      this->stockAnalyzers[stockIndex].setState(
+         analyzerSnapshot.getStateAt(stockIndex));
+   }
+}
+
 //******************************************************************************
 // Function : analyzePortfolio                                   
 // Process  : Loop through all of the stock data analyzers
 //             Analyze the stock
 //             Determine the highest MACD of all stocks analyzed
-// Notes    : None
+// Notes    : Output is only written when verbose
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Output only when verbose
+// 10.19.26       Donne Martin         Timed by Metrics
 //******************************************************************************
 void PortfolioAnalyzer::analyzePortfolio()
 {
+   METRICS_TIMER(PHASEANALYZE);
+
    int numFiles = this->getNumStockDataFiles(); // Number of stock data files
 
    // Loop through all of the stock data analyzers
@@ -144,10 +2410,132 @@ void PortfolioAnalyzer::analyzePortfolio()
       this->stockAnalyzers[analyzerIndex].analyzeStock();
    }
 
-   cout << "---Calculating highest MACD from all stock data---" << endl << endl;
+   if (this->isVerbose())
+   {
+      cout << "---Calculating highest MACD from all stock data---" << endl << endl;
+
+      // Determine the highest MACD of all stocks analyzed
+      this->outputStockWithHighestMACDSlope();
+   }
+}
+
+//******************************************************************************
+// Function : findStockAnalyzerIndex                                   
+// Process  : Look up the symbol in our symbol index
+// Notes    : Returns -1 if the symbol is not in the portfolio
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int PortfolioAnalyzer::findStockAnalyzerIndex(const string& symbol) const
+{
+   unordered_map<string, int>::const_iterator found = 
+      this->symbolIndices.find(symbol); // Symbol's entry
+
+   return (this->symbolIndices.end() == found) ? -1 : found->second;
+}
+
+//******************************************************************************
+// Function : getShardOfSymbol                                   
+// Process  : FNV-1a hash of the symbol's characters
+//             The shard is the hash modulo numShards
+// Notes    : Fixed width arithmetic, so every process and platform agrees
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int PortfolioAnalyzer::getShardOfSymbol(
+   const string& symbol,
+   const int numShards)
+{
+   static const unsigned long long FNVOFFSETBASIS = 14695981039346656037ULL;
+   static const unsigned long long FNVPRIME       = 1099511628211ULL;
+
+   unsigned long long hash = FNVOFFSETBASIS; // Hash of the symbol so far
+
+   for (size_t charIndex = 0; charIndex < symbol.size(); ++charIndex)
+   {
+      hash ^= (unsigned char)symbol[charIndex];
+      hash *= FNVPRIME;
+   }
+
+   return int(hash % (unsigned long long)numShards);
+}
+
+//******************************************************************************
+// Function : getTopStocksByMACDSlope                                   
+// Process  : List every stock analyzer index
+//             Sort the highest numStocks ranking slopes to the front
+//             Keep only those
+// Notes    : O(n log numStocks)
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Timed by Metrics
+// 10.19.26       Donne Martin         Sorts by the ranking slope
+//******************************************************************************
+void PortfolioAnalyzer::getTopStocksByMACDSlope(
+   const int numStocks, 
+   vector<int>& analyzerIndices) const
+{
+   METRICS_TIMER(PHASERANK);
+
+   int numAnalyzers = this->getNumStockAnalyzers();  // Analyzers to rank
+   int numRanked    = min(max(numStocks, 0), numAnalyzers); // Indices kept
+
+   // List every stock analyzer index
+   analyzerIndices.resize(numAnalyzers);
+
+   for (int analyzerIndex = 0; analyzerIndex < numAnalyzers; ++analyzerIndex)
+   {
+      analyzerIndices[analyzerIndex] = analyzerIndex;
+   }
+
+   // Sort the highest numStocks slopes to the front
+   partial_sort(
+      analyzerIndices.begin(), 
+      analyzerIndices.begin() + numRanked, 
+      analyzerIndices.end(), 
+      MACDSlopeGreater(*this));
+
+   analyzerIndices.resize(numRanked);
+}
+
+//******************************************************************************
+// Function : loadStockData                                   
+// Process  : Loop through all of the stock data analyzers
+//                Parse the stock's data file unless it has prices
+// Notes    : Throws an exception if a data file can't be parsed
+//             analyzeStock then skips parsing, so the parse can be done
+//                ahead, such as while another portfolio is analyzed
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioAnalyzer::loadStockData()
+{
+   int numFiles = this->getNumStockDataFiles(); // Number of stock data files
+
+   // Loop through all of the stock data analyzers
+   for (int analyzerIndex = 0; analyzerIndex < numFiles; ++analyzerIndex)
+   {
+      StockAnalyzer& stockAnalyzer = this->stockAnalyzers[analyzerIndex];
 
-   // Determine the highest MACD of all stocks analyzed
-   this->outputStockWithHighestMACDSlope();
+      // Parse the stock's data file unless it has prices
+      if (0 == stockAnalyzer.getStockRef().getNumPrices() && 
+          0 == stockAnalyzer.getNumStockPrices())
+      {
+         stockAnalyzer.parsePricesFromDataFile();
+      }
+   }
 }
 
 //******************************************************************************
@@ -167,9 +2555,12 @@ void PortfolioAnalyzer::analyzePortfolio()
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Timed by Metrics
 //******************************************************************************
 char* PortfolioAnalyzer::outputStockWithHighestMACDSlope()
 {
+   METRICS_TIMER(PHASERANK);
+
    double currMACDSlope = 0.0;                          // Current MACD slope 
                                                         // from past two days
    double highMACDSlope = 0.0;                          // Highest MACD slope 
@@ -215,20 +2606,86 @@ char* PortfolioAnalyzer::outputStockWithHighestMACDSlope()
    return dataFileName;
 }
 
+//******************************************************************************
+// Function : setHistoryBounded                                   
+// Process  : Mutator for historyBounded
+//             Loop through all of the stock data analyzers
+//                Set the analyzer's historyBounded
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioAnalyzer::setHistoryBounded(const bool historyBounded)
+{
+   int numAnalyzers = this->getNumStockAnalyzers(); // Number of analyzers 
+
+   this->historyBounded = historyBounded;
+
+   // Loop through all of the stock data analyzers
+   for (int analyzerIndex = 0; analyzerIndex < numAnalyzers; ++analyzerIndex)
+   {
+      this->stockAnalyzers[analyzerIndex].setHistoryBounded(historyBounded);
+   }
+}
+
+//******************************************************************************
+// Function : setPeriodsSlope                                   
+// Process  : Mutator for periodsSlope
+//             Loop through all of the stock data analyzers
+//                Set the analyzer's periodsSlope
+// Notes    : Throws an exception if periodsSlope is negative or 1, see
+//             StockAnalyzer::setPeriodsSlope
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Rejects 1
+//******************************************************************************
+void PortfolioAnalyzer::setPeriodsSlope(const int periodsSlope)
+{
+   int numAnalyzers = this->getNumStockAnalyzers(); // Number of analyzers 
+
+   if (periodsSlope < 0 ||
+       (periodsSlope > 0 && periodsSlope < StockAnalyzer::MINSLOPEPERIODS))
+   {
+      throw exception("Regression slope periods must be 0 or at least 2");
+   }
+
+   this->periodsSlope = periodsSlope;
+
+   // Loop through all of the stock data analyzers
+   for (int analyzerIndex = 0; analyzerIndex < numAnalyzers; ++analyzerIndex)
+   {
+      this->stockAnalyzers[analyzerIndex].setPeriodsSlope(periodsSlope);
+   }
+}
+
 //******************************************************************************
 // Function : setStockDataFiles                                   
 // Process  : Mutator for stockDataFileNames
 //             Set our data files to the input files           
 //             Set the size of our stock and stock analyzer lists based 
 //             on the number of stock data files provided.
+//             Start every stock analyzer over
 //             Loop through all of the stock data analyzers
 //                Ensure our analyzer has the proper data file and stock set
+//                Index the analyzer by its symbol
+//                Its manifest index is its index
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Indexes symbols, sets verbose
+// 10.19.26       Donne Martin         Sets historyBounded
+// 10.19.26       Donne Martin         Sets manifestIndices
+// 10.19.26       Donne Martin         Sets periodsSlope
+// 10.19.26       Donne Martin         Starts every analyzer over
 //******************************************************************************
 void PortfolioAnalyzer::setStockDataFiles(
    const vector<char*>& stockDataFileNames)
@@ -240,7 +2697,12 @@ void PortfolioAnalyzer::setStockDataFiles(
    // on the number of stock data files provided.
    int numDataFiles = this->getNumStockDataFiles();
    this->stocks.resize(numDataFiles);
-   this->stockAnalyzers.resize(numDataFiles);
+   this->symbolIndices.clear();
+   this->manifestIndices.resize(numDataFiles);
+
+   // Start every stock analyzer over, a history kept for another data file
+   // doesn't carry over
+   this->stockAnalyzers.assign(numDataFiles, StockAnalyzer());
 
    // Loop through all of the stock data analyzers
    for (int analyzerIndex = 0; analyzerIndex < numDataFiles; ++analyzerIndex)
@@ -250,5 +2712,42 @@ void PortfolioAnalyzer::setStockDataFiles(
          setStockDataFileName(this->stockDataFileNames[analyzerIndex]);
 
       this->stockAnalyzers[analyzerIndex].setStock(this->stocks[analyzerIndex]);
+      this->stockAnalyzers[analyzerIndex].setVerbose(this->isVerbose());
+      this->stockAnalyzers[analyzerIndex].
+         setPeriodsSlope(this->getPeriodsSlope());
+      this->stockAnalyzers[analyzerIndex].
+         setHistoryBounded(this->isHistoryBounded());
+
+      // Index the analyzer by its symbol
+      this->symbolIndices[
+         this->stockAnalyzers[analyzerIndex].getStockSymbol()] = analyzerIndex;
+
+      // Its manifest index is its index
+      this->manifestIndices[analyzerIndex] = analyzerIndex;
+   }
+}
+
+//******************************************************************************
+// Function : setVerbose                                   
+// Process  : Mutator for verbose
+//             Loop through all of the stock data analyzers
+//                Set the analyzer's verbose
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioAnalyzer::setVerbose(const bool verbose)
+{
+   int numAnalyzers = this->getNumStockAnalyzers(); // Number of analyzers 
+
+   this->verbose = verbose;
+
+   // Loop through all of the stock data analyzers
+   for (int analyzerIndex = 0; analyzerIndex < numAnalyzers; ++analyzerIndex)
+   {
+      this->stockAnalyzers[analyzerIndex].setVerbose(verbose);
    }
 }
\ No newline at end of file
@@ -10,13 +10,26 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Added manifests, ranking, and updates
+// 10.19.26       Donne Martin         Added bounded history
+// 10.19.26       Donne Martin         Added manifest shards
+// 10.19.26       Donne Martin         Added ranking by regression slope
+// 10.19.26       Donne Martin         Added universe packs
+// 10.19.26       Donne Martin         Added pack ranges and loadStockData
+// 10.19.26       Donne Martin         Added analyzer snapshots
 //******************************************************************************
 
 #ifndef PortfolioAnalyzer_h
 #define PortfolioAnalyzer_h
 
+#include <string>
+#include <unordered_map>
+
 #include "StockAnalyzer.h"
 
+class AnalyzerSnapshot;
+class UniversePack;
+
 //******************************************************************************
 //
 // Class:    PortfolioAnalyzer
@@ -27,11 +40,34 @@
 //                and analyze each stock
 //             Contains a list of stock data files, used to setup each
 //                stock analyzer
+//             Stock data files come from the defaults or from a manifest,
+//                a text file with one stock data file name per line
+//             Stocks are looked up by the symbol in their file name
+//             With setHistoryBounded, every stock analyzer keeps only the 
+//                recent history, see StockAnalyzer
+//             A manifest can be split into shards by symbol, each stock 
+//                remembers its line in the whole manifest so shard rankings
+//                can be merged in manifest order, see ShardResult
+//             With setPeriodsSlope, stocks are ranked by the regression 
+//                slope of their last periodsSlope MACDs instead of the two
+//                day MACD slope
+//             Stocks can also come from a UniversePack, whose histories 
+//                are copied from the mapped pack without parsing, and 
+//                a manifest that is a pack is read as one
+//             A bounded portfolio can be restored from an AnalyzerSnapshot,
+//                its analyzers carry on from their saved states
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Added manifests, ranking, and updates
+// 10.19.26       Donne Martin         Added bounded history
+// 10.19.26       Donne Martin         Added manifest shards
+// 10.19.26       Donne Martin         Added ranking by regression slope
+// 10.19.26       Donne Martin         Added universe packs
+// 10.19.26       Donne Martin         Added pack ranges and loadStockData
+// 10.19.26       Donne Martin         Added analyzer snapshots
 //
 //******************************************************************************
 class PortfolioAnalyzer
@@ -62,12 +98,76 @@ public:
    //***************************************************************************
    void addDefaultStocksToPortfolio();
       
+   //***************************************************************************
+   // Function    : addStocksFromManifest                                   
+   // Description : Adds the stock data files listed in the manifest file
+   //                One file name per line, blank lines and lines starting
+   //                with # are skipped
+   //                With numShards, only the files whose symbol is in shard
+   //                shardIndex are added, see getShardOfSymbol
+   //                A manifest that is a UniversePack adds its stocks, see
+   //                addStocksFromPack
+   // Constraints : Throws an exception if the manifest can't be read or the
+   //                shard is invalid
+   //***************************************************************************
+   void addStocksFromManifest(
+      const char* manifestFileName,
+      const int shardIndex = 0,
+      const int numShards = 1);
+      
+   //***************************************************************************
+   // Function    : addStocksFromPack                                   
+   // Description : Adds the stocks of the pack, in its directory order,
+   //                with their histories and newest bars, so 
+   //                analyzePortfolio parses nothing
+   //                With numShards, only the symbols in shard shardIndex
+   //                are added, see getShardOfSymbol
+   //                Symbols with no rows are skipped
+   //                With endSymbolIndex, only the directory entries from
+   //                firstSymbolIndex up to endSymbolIndex are added, -1 is
+   //                the end of the directory
+   // Constraints : Throws an exception if the shard or range is invalid
+   //                The pack must be open, it can be closed after
+   //***************************************************************************
+   void addStocksFromPack(
+      const UniversePack& universePack,
+      const int shardIndex = 0,
+      const int numShards = 1,
+      const int firstSymbolIndex = 0,
+      const int endSymbolIndex = -1);
+      
+   //***************************************************************************
+   // Function    : addStocksFromSnapshot                                   
+   // Description : Adds the stocks of the snapshot, in its order, with 
+   //                bounded history and their analyzers restored from 
+   //                their saved states, so nothing is parsed or analyzed
+   //                Ready for updates and rankings, without analyzePortfolio
+   // Constraints : Throws an exception if a state is invalid
+   //***************************************************************************
+   void addStocksFromSnapshot(const AnalyzerSnapshot& analyzerSnapshot);
+      
    //***************************************************************************
    // Function    : analyzePortfolio                                   
    // Description : Calls analyzeStock on all stocks then findHighestMACDStock            
    // Constraints : None
    //***************************************************************************
    void analyzePortfolio();
+      
+   //***************************************************************************
+   // Function    : findStockAnalyzerIndex                                   
+   // Description : Retrieves the index of the stock analyzer for the symbol
+   //                Returns -1 if the symbol is not in the portfolio
+   // Constraints : None
+   //***************************************************************************
+   int findStockAnalyzerIndex(const string& symbol) const;
+
+   //***************************************************************************
+   // Function    : getManifestIndexAtIndex                                   
+   // Description : Retrieves the position in the whole manifest of the stock
+   //                at the specified index, its index when not sharded
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getManifestIndexAtIndex(const int index) const;
 
    //***************************************************************************
    // Function    : getNumStockAnalyzers                                   
@@ -90,6 +190,33 @@ public:
    //***************************************************************************
    inline int getNumStocks() const;
       
+   //***************************************************************************
+   // Function    : getPeriodsSlope                                   
+   // Description : Accessor for periodsSlope            
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriodsSlope() const;
+      
+   //***************************************************************************
+   // Function    : getRankingSlopeAtIndex                                   
+   // Description : Retrieves the slope the stock at the specified index is 
+   //                ranked by, its regression slope of MACD when 
+   //                periodsSlope is set, otherwise its MACD slope
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline double getRankingSlopeAtIndex(const int index) const;
+      
+   //***************************************************************************
+   // Function    : getShardOfSymbol                                   
+   // Description : Retrieves the shard, of numShards, that owns the symbol
+   //                A FNV-1a hash of the symbol, so every process and
+   //                platform agrees
+   // Constraints : numShards must be positive
+   //***************************************************************************
+   static int getShardOfSymbol(
+      const string& symbol,
+      const int numShards);
+      
    //***************************************************************************
    // Function    : getStockAnalyzerAtIndex                                   
    // Description : Retrieves the stock analyzer at the specified index            
@@ -99,6 +226,15 @@ public:
       const int index, 
       StockAnalyzer& stockAnalyzer) const;
       
+   //***************************************************************************
+   // Function    : getStockAnalyzerRefAtIndex                                   
+   // Description : Retrieves the stock analyzer at the specified index 
+   //                without copying it
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const StockAnalyzer& getStockAnalyzerRefAtIndex(
+      const int index) const;
+      
    //***************************************************************************
    // Function    : getStockAtIndex                                   
    // Description : Retrieves the stock at the specified index            
@@ -115,7 +251,41 @@ public:
    //***************************************************************************
    inline void getStockDataFileNameAtIndex(
       const int index, 
-      char* stockDataFileName) const;
+      char*& stockDataFileName) const;
+      
+   //***************************************************************************
+   // Function    : getTopStocksByMACDSlope                                   
+   // Description : Retrieves the indices of the stock analyzers with the 
+   //                highest MACD slopes, highest first
+   //                See getRankingSlopeAtIndex for the slope used
+   //                Equal slopes keep their portfolio order
+   // Constraints : Call analyzePortfolio first
+   //***************************************************************************
+   void getTopStocksByMACDSlope(
+      const int numStocks, 
+      vector<int>& analyzerIndices) const;
+      
+   //***************************************************************************
+   // Function    : isHistoryBounded                                   
+   // Description : Accessor for historyBounded            
+   // Constraints : None
+   //***************************************************************************
+   inline bool isHistoryBounded() const;
+      
+   //***************************************************************************
+   // Function    : isVerbose                                   
+   // Description : Accessor for verbose            
+   // Constraints : None
+   //***************************************************************************
+   inline bool isVerbose() const;
+      
+   //***************************************************************************
+   // Function    : loadStockData                                   
+   // Description : Parses the data file of each stock that has no prices,
+   //                so analyzePortfolio parses nothing
+   // Constraints : Throws an exception if a data file can't be parsed
+   //***************************************************************************
+   void loadStockData();
       
    //***************************************************************************
    // Function    : outputStockWithHighestMACDSlope                                  
@@ -125,6 +295,23 @@ public:
    //***************************************************************************
    char* outputStockWithHighestMACDSlope();
       
+   //***************************************************************************
+   // Function    : setHistoryBounded                                   
+   // Description : Mutator for historyBounded, also sets every stock analyzer
+   //                See StockAnalyzer::setHistoryBounded
+   // Constraints : None
+   //***************************************************************************
+   void setHistoryBounded(const bool historyBounded);
+      
+   //***************************************************************************
+   // Function    : setPeriodsSlope                                   
+   // Description : Mutator for periodsSlope, also sets every stock analyzer
+   //                0 ranks by the two day MACD slope
+   //                See StockAnalyzer::setPeriodsSlope
+   // Constraints : Throws an exception if periodsSlope is negative or 1
+   //***************************************************************************
+   void setPeriodsSlope(const int periodsSlope);
+      
    //***************************************************************************
    // Function    : setStockDataFiles                                   
    // Description : Mutator for stockDataFileNames
@@ -132,13 +319,67 @@ public:
    // Constraints : None
    //***************************************************************************
    void setStockDataFiles(const vector<char*>& stockDataFileNames);
+      
+   //***************************************************************************
+   // Function    : setStockAtIndex                                   
+   // Description : Sets the prices of the stock at the specified index, 
+   //                analyzePortfolio then skips parsing its data file
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline void setStockAtIndex(
+      const int index, 
+      const Stock& stock);
+      
+   //***************************************************************************
+   // Function    : setVerbose                                   
+   // Description : Mutator for verbose, also sets every stock analyzer
+   //                When false, the analysis writes nothing to cout
+   // Constraints : None
+   //***************************************************************************
+   void setVerbose(const bool verbose);
+      
+   //***************************************************************************
+   // Function    : updateStockWithPrice                                   
+   // Description : Adds a new closing price to the stock at the specified 
+   //                index, see StockAnalyzer::updateWithPrice
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline void updateStockWithPrice(
+      const int index, 
+      const double closingPrice);
 
 private:   
+   bool                    historyBounded;      // Keep only recent history?
+   vector<int>             manifestIndices;     // Manifest line of each stock
+   vector<string>          manifestFileNames;   // File names read from the 
+                                                // manifest, stockDataFileNames
+                                                // points into these
+   int                     periodsSlope;        // MACDs in the ranking's
+                                                // regression slope, 0 for 
+                                                // the MACD slope
    vector<char*>           stockDataFileNames;  // List of stock data file names
    vector<Stock>           stocks;              // List of stocks
    vector<StockAnalyzer>   stockAnalyzers;      // List of stock analyzers
+   unordered_map<string, int> symbolIndices;    // Stock analyzer index for 
+                                                // each symbol
+   bool                    verbose;             // Output the analysis to cout?
 }; // end class PortfolioAnalyzer
 
+//******************************************************************************
+// Function : getManifestIndexAtIndex                                   
+// Process  : Retrieve the manifest index at the specified index
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int PortfolioAnalyzer::getManifestIndexAtIndex(const int index) const
+{
+   return this->manifestIndices.at(index);
+}
+
 //******************************************************************************
 // Function : getNumStockAnalyzers                                   
 // Process  : Retrieve the number of stock analyzers          
@@ -184,6 +425,44 @@ inline int PortfolioAnalyzer::getNumStocks() const
    return this->stocks.size();
 }
 
+//******************************************************************************
+// Function : getPeriodsSlope                                   
+// Process  : Accessor for periodsSlope
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int PortfolioAnalyzer::getPeriodsSlope() const
+{
+   return this->periodsSlope;
+}
+
+//******************************************************************************
+// Function : getRankingSlopeAtIndex                                   
+// Process  : The regression slope of MACD when periodsSlope is set
+//             Otherwise the MACD slope
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double PortfolioAnalyzer::getRankingSlopeAtIndex(const int index) const
+{
+   const StockAnalyzer& stockAnalyzer = this->stockAnalyzers.at(index);
+
+   if (this->getPeriodsSlope() > 0)
+   {
+      return stockAnalyzer.getRegressionSlopeMACD();
+   }
+
+   return stockAnalyzer.getSlopeMACD();
+}
+
 //******************************************************************************
 // Function : getStockAnalyzerAtIndex                                   
 // Process  : Retrieve the stock analyzer at the specified index            
@@ -201,6 +480,22 @@ inline void PortfolioAnalyzer::getStockAnalyzerAtIndex(
    stockAnalyzer = this->stockAnalyzers.at(index); 
 }
 
+//******************************************************************************
+// Function : getStockAnalyzerRefAtIndex                                   
+// Process  : Retrieve the stock analyzer at the specified index            
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const StockAnalyzer& PortfolioAnalyzer::getStockAnalyzerRefAtIndex(
+   const int index) const
+{ 
+   return this->stockAnalyzers.at(index); 
+}
+
 //******************************************************************************
 // Function : getStockAtIndex                                   
 // Process  : Retrieve the stock at the specified index            
@@ -227,12 +522,77 @@ inline void PortfolioAnalyzer::getStockAtIndex(
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Returns the name through a reference
 //******************************************************************************
 inline void PortfolioAnalyzer::getStockDataFileNameAtIndex(
    const int index, 
-   char* stockDataFileName) const
+   char*& stockDataFileName) const
 { 
    stockDataFileName = this->stockDataFileNames.at(index); 
 }
+
+//******************************************************************************
+// Function : isHistoryBounded                                   
+// Process  : Accessor for historyBounded
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool PortfolioAnalyzer::isHistoryBounded() const
+{
+   return this->historyBounded; 
+}
+
+//******************************************************************************
+// Function : isVerbose                                   
+// Process  : Accessor for verbose
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool PortfolioAnalyzer::isVerbose() const
+{ 
+   return this->verbose; 
+}
+
+//******************************************************************************
+// Function : setStockAtIndex                                   
+// Process  : Set the stock of the stock analyzer at the specified index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void PortfolioAnalyzer::setStockAtIndex(
+   const int index, 
+   const Stock& stock)
+{ 
+   this->stockAnalyzers.at(index).setStock(stock); 
+}
+
+//******************************************************************************
+// Function : updateStockWithPrice                                   
+// Process  : Update the stock analyzer at the specified index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void PortfolioAnalyzer::updateStockWithPrice(
+   const int index, 
+   const double closingPrice)
+{ 
+   this->stockAnalyzers.at(index).updateWithPrice(closingPrice); 
+}
       
 #endif // PortfolioAnalyzer_h
\ No newline at end of file
@@ -0,0 +1,4940 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     PortfolioBenchmark.cpp
+//
+// File Overview: Represents a PortfolioBenchmark
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the bounded history soak
+// 10.19.26       Donne Martin         Added the tick ingestion benchmark
+// 10.19.26       Donne Martin         Added the metrics benchmark
+// 10.19.26       Donne Martin         Added the allocation benchmark
+// 10.19.26       Donne Martin         Added the calendar benchmark
+// 10.19.26       Donne Martin         Added the correlation benchmark
+// 10.19.26       Donne Martin         Added the regression slope benchmark
+// 10.19.26       Donne Martin         Added the screener benchmark
+// 10.19.26       Donne Martin         Added the compression benchmark
+// 10.19.26       Donne Martin         Added the pack benchmark
+// 10.19.26       Donne Martin         Added the streaming benchmark
+// 10.19.26       Donne Martin         Reads Platform::getSteadyNanos
+//******************************************************************************
+
+#include "stdafx.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+#include "AlertPublisher.h"
+#include "AllocationTracker.h"
+#include "AnalysisDaemon.h"
+#include "AnalyzerSnapshot.h"
+#include "CompressedSeries.h"
+#include "CorrelationMatrix.h"
+#include "CrossoverDetector.h"
+#include "DaemonLoadGenerator.h"
+#include "LocalSocket.h"
+#include "EMARibbon.h"
+#include "IndicatorEngine.h"
+#include "Metrics.h"
+#include "Platform.h"
+#include "PortfolioAnalyzer.h"
+#include "PortfolioBenchmark.h"
+#include "RankingPublisher.h"
+#include "RingSeries.h"
+#include "Screener.h"
+#include "ScreenerColumns.h"
+#include "SharedRanking.h"
+#include "StockAnalyzer.h"
+#include "StreamingAnalyzer.h"
+#include "SyntheticPriceGenerator.h"
+#include "TickIngestor.h"
+#include "TickReplayer.h"
+#include "TimeframeAnalyzer.h"
+#include "TradingCalendar.h"
+#include "UniversePack.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+typedef chrono::steady_clock BenchmarkClock; // Monotonic clock for timing
+
+static const double BYTESPERMEGABYTE = 1024.0 * 1024.0; // For reporting
+
+//******************************************************************************
+//
+// Class:    LockedRanking
+//
+// Overview: The coarse locked baseline of benchmarkRanking: one
+//             RankingSnapshot updated in place, readers and writers both
+//             holding the mutex
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct LockedRanking
+{
+   mutex           rankingMutex; // Held to read or update
+   RankingSnapshot snapshot;     // Updated in place
+}; // end struct LockedRanking
+
+//******************************************************************************
+// Function : checkRanking
+// Process  : Check the top symbols are in ranking slope order
+//             With checkSummaries, check the summaries' prices add up to
+//                the snapshot's, which a torn or freed snapshot would not
+// Notes    : Returns false if a check fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool checkRanking(
+   const RankingSnapshot& snapshot,
+   const bool checkSummaries)
+{
+   long long numPrices = 0; // Of every summary
+
+   // Check the top symbols are in ranking slope order
+   for (int rank = 1; rank < snapshot.getNumTopStocks(); ++rank)
+   {
+      if (snapshot.getSummaryAt(snapshot.getTopIndexAtRank(rank)).
+             rankingSlope >
+          snapshot.getSummaryAt(snapshot.getTopIndexAtRank(rank - 1)).
+             rankingSlope)
+      {
+         return false;
+      }
+   }
+
+   // With checkSummaries, check the summaries' prices add up
+   if (checkSummaries)
+   {
+      for (int symbolIndex = 0; 
+           symbolIndex < snapshot.getNumSymbols(); 
+           ++symbolIndex)
+      {
+         numPrices += snapshot.getSummaryAt(symbolIndex).numPrices;
+      }
+
+      return numPrices == snapshot.getNumPrices();
+   }
+
+   return true;
+}
+
+//******************************************************************************
+// Function : compressColumn
+// Process  : Compress the dates, prices, or volumes
+// Notes    : Lets outputCompression work on any column
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void compressColumn(
+   const vector<int>& dates,
+   CompressedSeries& series)
+{
+   series.compressDates(dates.data(), dates.size());
+}
+
+static void compressColumn(
+   const vector<double>& prices,
+   CompressedSeries& series)
+{
+   series.compressPrices(prices.data(), prices.size());
+}
+
+static void compressColumn(
+   const vector<long long>& volumes,
+   CompressedSeries& series)
+{
+   series.compressVolumes(volumes.data(), volumes.size());
+}
+
+//******************************************************************************
+// Function : consumeAlerts
+// Process  : Accept the publisher's connection
+//             Count the alert lines received until it closes
+// Notes    : Thread entry point, the stand-in for a downstream consumer
+//             Failures are reported rather than thrown
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void consumeAlerts(
+   LocalSocket* listener,
+   long long* numLines)
+{
+   LocalSocket connection; // From the publisher
+   string      line;       // Alert received
+
+   try
+   {
+      if (!listener->acceptConnection(connection))
+      {
+         throw exception("Could not accept the alert connection");
+      }
+
+      while (connection.readLine(line))
+      {
+         ++*numLines;
+      }
+   }
+   catch (const exception& exception)
+   {
+      cout << "Alert consumer failed: " << exception.what() << endl;
+   }
+}
+
+//******************************************************************************
+// Function : decodeColumnBlock
+// Process  : Decode a block of dates, prices, or volumes
+// Notes    : Lets outputCompression work on any column
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline int decodeColumnBlock(
+   const CompressedSeries& series,
+   const int blockIndex,
+   int* dates)
+{
+   return series.decodeDateBlock(blockIndex, dates);
+}
+
+static inline int decodeColumnBlock(
+   const CompressedSeries& series,
+   const int blockIndex,
+   double* prices)
+{
+   return series.decodePriceBlock(blockIndex, prices);
+}
+
+static inline int decodeColumnBlock(
+   const CompressedSeries& series,
+   const int blockIndex,
+   long long* volumes)
+{
+   return series.decodeVolumeBlock(blockIndex, volumes);
+}
+
+//******************************************************************************
+// Function : elapsedSeconds
+// Process  : Seconds between start and now on the benchmark clock
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static double elapsedSeconds(const BenchmarkClock::time_point& start)
+{
+   return chrono::duration<double>(BenchmarkClock::now() - start).count();
+}
+
+//******************************************************************************
+// Function : isWholeSharedSummary
+// Process  : The rank is one of numSymbols
+//             The histogram is the MACD less the signal, or 0 without one
+// Notes    : The writer computes the histogram from the same doubles, so a
+//             summary read whole matches exactly
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool isWholeSharedSummary(
+   const SharedSymbolSummary& summary,
+   const int numSymbols)
+{
+   if (summary.rank < 1 || summary.rank > numSymbols)
+   {
+      return false;
+   }
+
+   if (0 == summary.hasSignal)
+   {
+      return 0.0 == summary.signal && 0.0 == summary.histogram;
+   }
+
+   return summary.currentMACD - summary.signal == summary.histogram;
+}
+
+//******************************************************************************
+// Function : publishAlerts
+// Process  : Publish numAlerts alerts of the producer's own symbol, each a
+//                bar later, stamped as they are raised
+// Notes    : Thread entry point
+//             A symbol per producer, so a producer's alerts written out of
+//                order would be counted as duplicates
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void publishAlerts(
+   AlertPublisher* alertPublisher,
+   const int producerIndex,
+   const int numAlerts)
+{
+   Alert alert; // Published
+
+   alert.symbolIndex = producerIndex;
+   alert.type        = ALERTZEROUP;
+   alert.macd        = 0.0;
+   alert.slopeMACD   = 0.0;
+
+   for (int alertIndex = 0; alertIndex < numAlerts; ++alertIndex)
+   {
+      alert.barMicros    = alertIndex;
+      alert.arrivalNanos = Platform::getSteadyNanos();
+
+      alertPublisher->publish(alert);
+   }
+}
+
+//******************************************************************************
+// Function : readRankings
+// Process  : Until the writers are done
+//                Read the latest ranking, from the RankingPublisher if any,
+//                   otherwise under the LockedRanking's mutex
+//                Copy the top symbols and their slopes, as a query would
+//                Check the ranking, and every RANKINGCHECKREADS reads the
+//                   summaries too
+//                Check the version never goes back
+//                Record the latency of every RANKINGCHECKREADS reads
+// Notes    : Thread entry point
+//             A failed check is counted in numFailures
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void readRankings(
+   RankingPublisher* rankingPublisher,
+   LockedRanking* lockedRanking,
+   const int readerIndex,
+   const atomic<bool>* writersDone,
+   vector<double>* latencyNanos,
+   long long* numReads,
+   atomic<long long>* numFailures)
+{
+   static const int RANKINGCHECKREADS = 64; // Reads per full check
+
+   const RankingSnapshot* snapshot    = NULL; // Read
+   long long              lastVersion = 0;    // Of the last read
+   int                    topIndices[PortfolioBenchmark::RANKINGNUMTOPSTOCKS];
+   double                 topSlopes[PortfolioBenchmark::RANKINGNUMTOPSTOCKS];
+   bool                   isConsistent = true;  // Read passed the checks?
+
+   *numReads = 0;
+
+   while (!writersDone->load(memory_order_relaxed))
+   {
+      const bool CHECKSUMMARIES = (0 == *numReads % RANKINGCHECKREADS);
+
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      // Read the latest ranking
+      if (NULL != rankingPublisher)
+      {
+         snapshot = rankingPublisher->beginRead(readerIndex);
+      }
+      else
+      {
+         lockedRanking->rankingMutex.lock();
+         snapshot = &lockedRanking->snapshot;
+      }
+
+      // Copy the top symbols and their slopes
+      for (int rank = 0; rank < snapshot->getNumTopStocks(); ++rank)
+      {
+         topIndices[rank] = snapshot->getTopIndexAtRank(rank);
+         topSlopes[rank]  = 
+            snapshot->getSummaryAt(topIndices[rank]).rankingSlope;
+      }
+
+      // Check the ranking, the copy, and the version never goes back
+      isConsistent = checkRanking(*snapshot, CHECKSUMMARIES) &&
+                     snapshot->getVersion() >= lastVersion;
+      lastVersion  = snapshot->getVersion();
+
+      for (int rank = 1; rank < snapshot->getNumTopStocks(); ++rank)
+      {
+         isConsistent = isConsistent && topSlopes[rank - 1] >= topSlopes[rank];
+      }
+
+      if (NULL != rankingPublisher)
+      {
+         rankingPublisher->endRead(readerIndex);
+      }
+      else
+      {
+         lockedRanking->rankingMutex.unlock();
+      }
+
+      // Record the latency of every RANKINGCHECKREADS reads
+      if (1 == *numReads % RANKINGCHECKREADS)
+      {
+         latencyNanos->push_back(chrono::duration<double, nano>(
+            BenchmarkClock::now() - start).count());
+      }
+
+      if (!isConsistent)
+      {
+         ++(*numFailures);
+      }
+
+      ++(*numReads);
+   }
+}
+
+//******************************************************************************
+// Function : referenceCorrelation
+// Process  : Take both symbols' returns from the calendar in double
+//             Center each on its own mean
+//             Divide their products by each one's length over the returns
+//                both have, as CorrelationMatrix does
+// Notes    : 0 if either has fewer than two returns or no variance
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static double referenceCorrelation(
+   const TradingCalendar& calendar,
+   const int symbolIndex,
+   const int otherSymbolIndex)
+{
+   const int      SYMBOLS[2] = { symbolIndex, otherSymbolIndex };
+   vector<double> returns[2];  // Of each symbol, 0 when missing
+   vector<int>    present[2];  // 1 where each has a return
+   double         means[2];    // Of each symbol's returns
+   double         product = 0.0;
+   double         lengths[2] = { 0.0, 0.0 }; // Over shared returns
+
+   // Take both symbols' returns, and center each on its own mean
+   for (int side = 0; side < 2; ++side)
+   {
+      double sum   = 0.0; // Of its returns
+      int    count = 0;   // Of its returns
+
+      for (int dateIndex = 1; dateIndex < calendar.getNumDates(); ++dateIndex)
+      {
+         const bool PRESENT = 
+            calendar.isValidAt(dateIndex, SYMBOLS[side]) &&
+            calendar.isValidAt(dateIndex - 1, SYMBOLS[side]);
+
+         returns[side].push_back(PRESENT ? 
+            calendar.getPriceAt(dateIndex, SYMBOLS[side]) / 
+            calendar.getPriceAt(dateIndex - 1, SYMBOLS[side]) - 1.0 : 0.0);
+         present[side].push_back(PRESENT ? 1 : 0);
+         sum   += returns[side].back();
+         count += present[side].back();
+      }
+
+      if (count < 2)
+      {
+         return 0.0;
+      }
+
+      means[side] = sum / count;
+   }
+
+   // Divide the products by the lengths over shared returns
+   for (size_t returnIndex = 0; returnIndex < returns[0].size(); ++returnIndex)
+   {
+      const double FIRST  = present[0][returnIndex] * 
+                            (returns[0][returnIndex] - means[0]);
+      const double SECOND = present[1][returnIndex] * 
+                            (returns[1][returnIndex] - means[1]);
+
+      product += FIRST * SECOND;
+
+      if (present[0][returnIndex] && present[1][returnIndex])
+      {
+         lengths[0] += FIRST * FIRST;
+         lengths[1] += SECOND * SECOND;
+      }
+   }
+
+   return (lengths[0] * lengths[1] > 0.0) ? 
+      product / sqrt(lengths[0] * lengths[1]) : 0.0;
+}
+
+//******************************************************************************
+// Function : referenceCrossovers
+// Process  : Calculate the stock's MACD and signal with MACDKernel, as
+//                CrossoverDetector does
+//             For each bar after the first MACD, compare MACD and the bar
+//                before's with 0, and after the first signal with the
+//                signal, a bar at a time
+//             Check each event type's bit against the comparisons
+// Notes    : Returns the number of events
+//             Throws an exception if a bit differs
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static int referenceCrossovers(
+   const Stock& stock,
+   const int symbolIndex,
+   const CrossoverDetector& detector)
+{
+   typedef MACDKernel<AnalyzerPricePolicy> Kernel;
+   typedef MACDKernel<DoublePricePolicy>   SignalKernel;
+
+   const int    NUMPRICES   = stock.getNumPrices();
+   const int    FAST        = detector.getPeriodsFast();
+   const int    SLOW        = detector.getPeriodsSlow();
+   const int    SIGNAL      = detector.getPeriodsSignal();
+   const int    FIRSTMACD   = SLOW - 1;
+   const int    FIRSTSIGNAL = FIRSTMACD + SIGNAL - 1;
+   const int    BITS        = CrossoverDetector::BITSPERWORD;
+
+   vector<AnalyzerPricePolicy::StorageType> emasFast(NUMPRICES); // Of prices
+   vector<AnalyzerPricePolicy::StorageType> emasSlow(NUMPRICES); // Of prices
+   vector<double> macds(NUMPRICES);   // Of each bar
+   vector<double> signals(NUMPRICES); // Of each bar
+   bool           crossed[CrossoverDetector::NUMEVENTTYPES]; // At a bar
+   bool           marked  = false;    // The detector's bit at a bar
+   int            numEvents = 0;      // Of the stock
+
+   if (NUMPRICES <= SLOW)
+   {
+      return 0;
+   }
+
+   // Calculate the MACD and signal
+   Kernel::calculateEMA(
+      stock.getPriceData(), NUMPRICES, FAST,
+      Kernel::calculateFirstPeriodSMA(stock.getPriceData(), FAST),
+      Kernel::calculateMultEMA(FAST), &emasFast[0]);
+   Kernel::calculateEMA(
+      stock.getPriceData(), NUMPRICES, SLOW,
+      Kernel::calculateFirstPeriodSMA(stock.getPriceData(), SLOW),
+      Kernel::calculateMultEMA(SLOW), &emasSlow[0]);
+
+   for (int barIndex = FIRSTMACD; barIndex < NUMPRICES; ++barIndex)
+   {
+      macds[barIndex] =
+         AnalyzerPricePolicy::toAccum(emasFast[barIndex - FAST + 1]) -
+         AnalyzerPricePolicy::toAccum(emasSlow[barIndex - FIRSTMACD]);
+   }
+
+   if (NUMPRICES > FIRSTSIGNAL)
+   {
+      SignalKernel::calculateEMA(
+         &macds[FIRSTMACD], NUMPRICES - FIRSTMACD, SIGNAL,
+         SignalKernel::calculateFirstPeriodSMA(&macds[FIRSTMACD], SIGNAL),
+         SignalKernel::calculateMultEMA(SIGNAL), &signals[FIRSTSIGNAL]);
+   }
+
+   // Compare each bar, and check each type's bit
+   for (int barIndex = FIRSTMACD + 1; barIndex < NUMPRICES; ++barIndex)
+   {
+      const bool ABOVEZERO  = macds[barIndex] > 0.0;
+      const bool WASABOVE   = macds[barIndex - 1] > 0.0;
+      const bool SIGNALED   = barIndex > FIRSTSIGNAL;
+      const bool ABOVE      = SIGNALED && macds[barIndex] > signals[barIndex];
+      const bool WASSIGNAL  = SIGNALED &&
+                              macds[barIndex - 1] > signals[barIndex - 1];
+
+      crossed[CrossoverDetector::EVENTSIGNALUP]   =
+         SIGNALED && ABOVE && !WASSIGNAL;
+      crossed[CrossoverDetector::EVENTSIGNALDOWN] =
+         SIGNALED && !ABOVE && WASSIGNAL;
+      crossed[CrossoverDetector::EVENTZEROUP]     = ABOVEZERO && !WASABOVE;
+      crossed[CrossoverDetector::EVENTZERODOWN]   = !ABOVEZERO && WASABOVE;
+
+      for (int type = 0; type < CrossoverDetector::NUMEVENTTYPES; ++type)
+      {
+         marked = 0 != ((detector.getEventBits(
+            symbolIndex, CrossoverDetector::EventType(type))[barIndex / BITS]
+               >> (barIndex % BITS)) & 1);
+
+         if (marked != crossed[type])
+         {
+            throw exception("Crossover check failed");
+         }
+
+         numEvents += crossed[type] ? 1 : 0;
+      }
+   }
+
+   return numEvents;
+}
+
+//******************************************************************************
+// Function : referenceSlope
+// Process  : Least squares slope of the newest numValues values, summing
+//                about their means, x counted from 0 at the oldest
+// Notes    : 0 for fewer than two values
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static double referenceSlope(
+   const RingSeries<double>& values,
+   const int numValues)
+{
+   const double MEANX = (numValues - 1) / 2.0; // Mean of x
+   double       meanY = 0.0;                   // Mean of the values
+   double       sumXY = 0.0;                   // Centered products
+   double       sumXX = 0.0;                   // Centered squares
+
+   if (numValues < 2)
+   {
+      return 0.0;
+   }
+
+   for (int age = 0; age < numValues; ++age)
+   {
+      meanY += values.getFromNewest(age);
+   }
+
+   meanY /= numValues;
+
+   for (int x = 0; x < numValues; ++x)
+   {
+      const double DX = x - MEANX;
+
+      sumXY += DX * (values.getFromNewest(numValues - 1 - x) - meanY);
+      sumXX += DX * DX;
+   }
+
+   return sumXY / sumXX;
+}
+
+//******************************************************************************
+// Function : resampleCloses
+// Process  : Key each day by its day, its week from Monday, or its year and
+//                month
+//             Add the close of the last day of each key to resampled
+// Notes    : A reference apart from TimeframeAnalyzer's period ends
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void resampleCloses(
+   const Stock& stock,
+   const TimeframeAnalyzer::Timeframe timeframe,
+   Stock& resampled)
+{
+   const int NUMPRICES = stock.getNumPrices();
+   vector<int> keys(NUMPRICES); // Period of each day
+   int         year  = 0;       // Of a day
+   int         month = 0;       // Of a day
+   int         day   = 0;       // Of a day
+
+   for (int index = 0; index < NUMPRICES; ++index)
+   {
+      const int DATE = stock.getDateAt(index);
+
+      if (TimeframeAnalyzer::TIMEFRAMEWEEKLY == timeframe)
+      {
+         // Day 0 is a Thursday, day -3 a Monday, dates are past 1970
+         keys[index] = (DATE + 3) / 7;
+      }
+      else if (TimeframeAnalyzer::TIMEFRAMEMONTHLY == timeframe)
+      {
+         TradingCalendar::splitDate(DATE, year, month, day);
+         keys[index] = year * 12 + month;
+      }
+      else
+      {
+         keys[index] = DATE;
+      }
+   }
+
+   for (int index = 0; index < NUMPRICES; ++index)
+   {
+      if (NUMPRICES - 1 == index || keys[index] != keys[index + 1])
+      {
+         resampled.addPrice(stock.getPriceAt(index));
+      }
+   }
+}
+
+//******************************************************************************
+// Function : runDaemon
+// Process  : Serve requests until the daemon is stopped
+// Notes    : Thread entry point, failures are reported rather than thrown
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void runDaemon(
+   AnalysisDaemon* daemon,
+   const string socketPath)
+{
+   try
+   {
+      daemon->run(socketPath);
+   }
+   catch (const exception& exception)
+   {
+      cout << "Daemon failed: " << exception.what() << endl;
+   }
+}
+
+//******************************************************************************
+// Function : maxAbsDifference
+// Process  : Largest absolute difference between matching values
+// Notes    : Both lists must have the same size
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static double maxAbsDifference(
+   const vector<double>& values,
+   const vector<double>& baseline)
+{
+   double maxDifference = 0.0; // Largest difference so far
+
+   for (size_t valueIndex = 0; valueIndex < values.size(); ++valueIndex)
+   {
+      maxDifference = max(
+         maxDifference,
+         fabs(values[valueIndex] - baseline[valueIndex]));
+   }
+
+   return maxDifference;
+}
+
+//******************************************************************************
+// Function : outputCompression
+// Process  : Compress each symbol's column
+//             Check each decodes, a block at a time, to the same bits
+//             Time decoding every block DEFAULTNUMREPS times
+//             Output the values, raw and compressed megabytes, the ratio,
+//                and the values and raw gigabytes decoded per second
+// Notes    : Throws an exception if a column doesn't round trip
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+static void outputCompression(
+   const string& columnName,
+   const vector< vector<T> >& columns)
+{
+   vector<CompressedSeries> series(columns.size()); // Of each column
+   vector<T>                block(CompressedSeries::BLOCKVALUES);
+   long long                numValues = 0;   // Of every column
+   size_t                   numBytes  = 0;   // Compressed
+   T                        checksum  = 0;   // Keeps the decoding
+
+   // Compress each symbol's column, check it round trips
+   for (size_t symbolIndex = 0; symbolIndex < columns.size(); ++symbolIndex)
+   {
+      compressColumn(columns[symbolIndex], series[symbolIndex]);
+      numValues += columns[symbolIndex].size();
+      numBytes  += series[symbolIndex].getNumBytes();
+
+      for (int blockIndex = 0; 
+           blockIndex < series[symbolIndex].getNumBlocks(); 
+           ++blockIndex)
+      {
+         const int BLOCKSIZE = decodeColumnBlock(
+            series[symbolIndex], blockIndex, block.data());
+
+         if (0 != memcmp(
+                block.data(), 
+                &columns[symbolIndex][blockIndex * 
+                                      CompressedSeries::BLOCKVALUES],
+                BLOCKSIZE * sizeof(T)))
+         {
+            throw exception("Compressed column did not round trip");
+         }
+      }
+   }
+
+   // Time decoding every block
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int repIndex = 0; repIndex < PortfolioBenchmark::DEFAULTNUMREPS; 
+        ++repIndex)
+   {
+      for (size_t symbolIndex = 0; symbolIndex < series.size(); ++symbolIndex)
+      {
+         for (int blockIndex = 0; 
+              blockIndex < series[symbolIndex].getNumBlocks(); 
+              ++blockIndex)
+         {
+            decodeColumnBlock(series[symbolIndex], blockIndex, block.data());
+            checksum += block[0];
+         }
+      }
+   }
+
+   const double SECONDS = 
+      elapsedSeconds(start) / PortfolioBenchmark::DEFAULTNUMREPS;
+   const double RAWBYTES = double(numValues) * sizeof(T);
+
+   cout << setw(18) << left << columnName << right 
+        << setw(10) << numValues 
+        << fixed << setprecision(2)
+        << setw(10) << RAWBYTES / BYTESPERMEGABYTE
+        << setw(10) << numBytes / BYTESPERMEGABYTE
+        << setw(8) << RAWBYTES / max(numBytes, size_t(1))
+        << setw(12) << numValues / SECONDS / 1.0e6
+        << setw(10) << RAWBYTES / SECONDS / 1.0e9 
+        << (0 == checksum ? " " : "") << endl;
+   cout.unsetf(ios::floatfield);
+}
+
+//******************************************************************************
+// Function : outputSharedLatency
+// Process  : Sort the latencies
+//             Output the count, its rate over seconds, and the median, 99th
+//                percentile, and largest latency
+// Notes    : A row of the shared ranking benchmark
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void outputSharedLatency(
+   const string& rowName,
+   const long long count,
+   const double seconds,
+   vector<double>& latencyNanos)
+{
+   if (latencyNanos.empty())
+   {
+      latencyNanos.push_back(0.0);
+   }
+
+   sort(latencyNanos.begin(), latencyNanos.end());
+
+   cout << setw(14) << left << rowName << right 
+        << setw(12) << count
+        << fixed << setprecision(0)
+        << setw(12) << count / seconds
+        << setw(10) << latencyNanos[latencyNanos.size() / 2]
+        << setw(10) << latencyNanos[latencyNanos.size() * 99 / 100]
+        << setw(12) << latencyNanos.back() << endl;
+   cout.unsetf(ios::floatfield);
+}
+
+//******************************************************************************
+// Function : writeRankings
+// Process  : Update the writer's symbols, every numWriters symbol from its
+//                own index, round robin with synthetic prices
+//             After each update, summarize the symbol
+//             Every RANKINGBATCHUPDATES updates, publish the summaries, 
+//                to the RankingPublisher if any, otherwise in place under 
+//                the LockedRanking's mutex, and rank
+// Notes    : Thread entry point
+//             Writers update disjoint analyzers of the portfolio
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void writeRankings(
+   RankingPublisher* rankingPublisher,
+   LockedRanking* lockedRanking,
+   PortfolioAnalyzer* portfolioAnalyzer,
+   const int writerIndex,
+   const int numWriters,
+   const long long numUpdates)
+{
+   const int NUMSYMBOLS = portfolioAnalyzer->getNumStockAnalyzers();
+   const int BATCH      = PortfolioBenchmark::RANKINGBATCHUPDATES;
+
+   SyntheticPriceGenerator generator(NUMSYMBOLS + writerIndex + 1);
+   vector<int>             symbolIndices;              // Of the batch
+   vector<RankingSummary>  summaries;                  // Of the batch
+   int                     symbolIndex = writerIndex;  // Next updated
+
+   symbolIndices.reserve(BATCH);
+   summaries.resize(BATCH);
+
+   for (long long update = 0; update < numUpdates; ++update)
+   {
+      // Update the writer's symbols, round robin
+      portfolioAnalyzer->updateStockWithPrice(
+         symbolIndex, generator.nextPrice());
+
+      // Summarize the symbol
+      RankingPublisher::summarizeAnalyzer(
+         portfolioAnalyzer->getStockAnalyzerRefAtIndex(symbolIndex),
+         portfolioAnalyzer->getPeriodsSlope(),
+         summaries[symbolIndices.size()]);
+      symbolIndices.push_back(symbolIndex);
+
+      symbolIndex += numWriters;
+
+      if (symbolIndex >= NUMSYMBOLS)
+      {
+         symbolIndex = writerIndex;
+      }
+
+      // Publish the summaries, and rank
+      if (BATCH == int(symbolIndices.size()) || update + 1 == numUpdates)
+      {
+         summaries.resize(symbolIndices.size());
+
+         if (NULL != rankingPublisher)
+         {
+            rankingPublisher->update(symbolIndices, summaries);
+         }
+         else
+         {
+            lock_guard<mutex> lock(lockedRanking->rankingMutex);
+            RankingSnapshot&  snapshot = lockedRanking->snapshot;
+
+            for (size_t batchIndex = 0; 
+                 batchIndex < symbolIndices.size(); 
+                 ++batchIndex)
+            {
+               snapshot.setSummaryAt(
+                  symbolIndices[batchIndex], summaries[batchIndex]);
+            }
+
+            snapshot.rank(PortfolioBenchmark::RANKINGNUMTOPSTOCKS);
+            snapshot.setVersion(snapshot.getVersion() + 1);
+         }
+
+         symbolIndices.clear();
+         summaries.resize(BATCH);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : writeStockDataFile
+// Process  : Generate the symbol's closes from its seed
+//             Write a row per bar, newest first, with whole cent prices on
+//                weekdays from FIRSTDATE, the open at yesterday's close
+// Notes    : Returns the bytes written
+//             Throws an exception if the file can't be written
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function, from benchmarkPack
+//******************************************************************************
+static long long writeStockDataFile(
+   const string& stockDataFileName,
+   const int seed,
+   const int numBars)
+{
+   const int               FIRSTDATE = TradingCalendar::toDate(2000, 1, 3);
+   SyntheticPriceGenerator generator(seed); // Of the symbol
+   vector<double>          prices;          // Its closes
+   ofstream                file;            // Being written
+   long long               numBytes = 0;    // Written
+
+   // Generate the symbol's closes from its seed
+   generator.generatePrices(numBars, prices);
+
+   file.open(stockDataFileName.c_str());
+   file << "Date,Open,High,Low,Close,Volume" << endl << fixed 
+        << setprecision(2);
+
+   // Write a row per bar, newest first
+   for (int barIndex = numBars - 1; barIndex >= 0; --barIndex)
+   {
+      double open = prices[max(barIndex - 1, 0)]; // Yesterday's close
+
+      file << TradingCalendar::formatDate(
+                 FIRSTDATE + (barIndex / 5) * 7 + barIndex % 5) 
+           << ',' << open 
+           << ',' << max(open, prices[barIndex]) * 1.01
+           << ',' << min(open, prices[barIndex]) * 0.99
+           << ',' << prices[barIndex]
+           << ',' << 100000 + generator.nextRandom() % 2000000 << '\n';
+   }
+
+   numBytes = file.tellp();
+   file.close();
+
+   if (file.fail())
+   {
+      throw exception("Could not write a stock data file");
+   }
+
+   return numBytes;
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+PortfolioBenchmark::PortfolioBenchmark()
+{
+} // end PortfolioBenchmark::PortfolioBenchmark
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+PortfolioBenchmark::~PortfolioBenchmark()
+{
+} // end PortfolioBenchmark::~PortfolioBenchmark
+
+//******************************************************************************
+// Function : benchmarkAlerts
+// Process  : For 1 producer, doubling up to a producer per hardware thread,
+//                at least 2
+//                Publish ALERTNUMPERPRODUCER alerts from each, as fast as
+//                   they can, to an AlertPublisher with no outputs
+//                Check every alert was written or dropped, and none out of
+//                   order
+//                Output the alerts per second, drops, and latency
+//             Replay ALERTNUMTICKS synthetic ticks through a TickIngestor,
+//                unthrottled, then at ALERTREPLAYSPEED times feed time
+//                Publish the MACD alerts of its bars to a log file and to a
+//                   consumer thread on a LocalSocket
+//                Check the consumer and the log file got every alert
+//                   written
+//                Output the ingestion and alert statistics
+// Notes    : Throws an exception if a check fails
+//             Latency is from an alert's bar completing to its write
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkAlerts()
+{
+   static const char* LOGFILENAME = "stockanalyzer_benchmark_alerts.log";
+   static const char* SOCKETPATH  = "stockanalyzer_benchmark_alerts.sock";
+
+   const int NUMALERTS    = PortfolioBenchmark::ALERTNUMPERPRODUCER;
+   const int MAXPRODUCERS = max(2, int(thread::hardware_concurrency()));
+
+   vector<thread> producers;         // Publishing threads but the main
+   TickReplayer   replayer;          // Synthetic feed
+   double         seconds     = 0.0; // Of a run
+   long long      numConsumed = 0;   // Lines the consumer received
+   long long      numLogged   = 0;   // Lines of the log file
+   string         line;              // Of the log file
+
+   cout << "---Alerts: " << NUMALERTS << " alerts per producer---"
+        << endl << endl;
+   cout << setw(10) << "producers" << setw(14) << "alerts/s" << setw(10)
+        << "dropped" << setw(10) << "p50 us" << setw(10) << "p99 us"
+        << endl;
+
+   // Publish from each number of producers
+   for (int numProducers = 1; numProducers <= MAXPRODUCERS;
+        numProducers = (numProducers < MAXPRODUCERS &&
+                        2 * numProducers > MAXPRODUCERS) ?
+                       MAXPRODUCERS : 2 * numProducers)
+   {
+      AlertPublisher alertPublisher(numProducers);
+      vector<double> latencyNanos; // Sorted
+
+      alertPublisher.start();
+
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int producerIndex = 1; producerIndex < numProducers;
+           ++producerIndex)
+      {
+         producers.push_back(thread(
+            publishAlerts, &alertPublisher, producerIndex, NUMALERTS));
+      }
+
+      publishAlerts(&alertPublisher, 0, NUMALERTS);
+
+      for (size_t producerIndex = 0; producerIndex < producers.size();
+           ++producerIndex)
+      {
+         producers[producerIndex].join();
+      }
+
+      producers.clear();
+      alertPublisher.stop();
+      seconds = elapsedSeconds(start);
+
+      // Check every alert was written or dropped, and none out of order
+      if (alertPublisher.getNumReceived() + alertPublisher.getNumDropped() !=
+             (long long)numProducers * NUMALERTS ||
+          alertPublisher.getNumWritten() != alertPublisher.getNumReceived() ||
+          0 != alertPublisher.getNumDuplicates())
+      {
+         throw exception("Alert publish check failed");
+      }
+
+      latencyNanos = alertPublisher.getLatencyNanos();
+      sort(latencyNanos.begin(), latencyNanos.end());
+
+      cout << setw(10) << numProducers << fixed << setprecision(0)
+           << setw(14) << alertPublisher.getNumWritten() / seconds
+           << setw(10) << alertPublisher.getNumDropped()
+           << setprecision(2)
+           << setw(10) << latencyNanos[latencyNanos.size() / 2] / 1.0e3
+           << setw(10) << latencyNanos[latencyNanos.size() * 99 / 100] / 1.0e3
+           << endl;
+      cout.unsetf(ios::floatfield);
+
+      if (MAXPRODUCERS == numProducers)
+      {
+         break;
+      }
+   }
+
+   cout << endl << "Every alert written or dropped, each producer's in order"
+        << endl << endl;
+
+   // Generate the synthetic ticks
+   replayer.generateTicks(
+      PortfolioBenchmark::ALERTNUMSYMBOLS,
+      PortfolioBenchmark::ALERTNUMTICKS,
+      PortfolioBenchmark::TICKMICROS);
+
+   // Replay them unthrottled, then paced, to a log file and a consumer
+   for (int speedIndex = 0; speedIndex < 2; ++speedIndex)
+   {
+      const double SPEED = (0 == speedIndex) ?
+         0.0 : PortfolioBenchmark::ALERTREPLAYSPEED;
+
+      TickIngestor   ingestor(
+         replayer.getNumSymbols(), 1, PortfolioBenchmark::ALERTBARMICROS);
+      AlertPublisher alertPublisher(replayer.getNumSymbols());
+      LocalSocket    listener; // Of the consumer
+
+      cout << "---Alerts of " << PortfolioBenchmark::ALERTNUMSYMBOLS
+           << " symbols x " << PortfolioBenchmark::ALERTNUMTICKS
+           << " ticks, " << PortfolioBenchmark::ALERTBARMICROS
+           << " us bars, ";
+
+      if (0 == speedIndex)
+      {
+         cout << "unthrottled";
+      }
+      else
+      {
+         cout << SPEED << "x feed time";
+      }
+
+      cout << ", to a log file and socket---" << endl << endl;
+
+      remove(LOGFILENAME);
+      listener.listenOn(SOCKETPATH);
+      numConsumed = 0;
+      numLogged   = 0;
+
+      thread consumer(consumeAlerts, &listener, &numConsumed);
+
+      alertPublisher.openLogFile(LOGFILENAME);
+      alertPublisher.connectSocket(SOCKETPATH);
+      ingestor.setAlertPublisher(&alertPublisher);
+      alertPublisher.start();
+
+      seconds = replayer.replay(ingestor, SPEED);
+      ingestor.flushBars();
+      alertPublisher.stop();
+      consumer.join();
+      LocalSocket::removeSocketFile(SOCKETPATH);
+
+      ingestor.outputStatistics(seconds);
+      alertPublisher.outputStatistics(seconds);
+
+      // Check the consumer and the log file got every alert written
+      ifstream logFile(LOGFILENAME); // Alerts written
+
+      while (getline(logFile, line))
+      {
+         ++numLogged;
+      }
+
+      logFile.close();
+      remove(LOGFILENAME);
+
+      if (numConsumed != alertPublisher.getNumWritten() ||
+          numLogged != alertPublisher.getNumWritten())
+      {
+         throw exception("Alert consumer check failed");
+      }
+
+      cout << endl << numConsumed << " alerts received by the consumer and "
+           << "logged" << endl << endl;
+   }
+
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : benchmarkAllocations
+// Process  : Generate a synthetic portfolio
+//             Track the allocations of its first analysis and ranking, then
+//                of a repeated one, which reuses the analyzers
+//             Write a stock data file for each of ALLOCATIONNUMFILES symbols
+//             Track the allocations of parsing, analyzing, and ranking them,
+//                then remove the files
+//             Output the allocations per symbol of each, and the summary of
+//                the first
+//             Restore whether AllocationTracker was enabled, and reset it
+// Notes    : Throws an exception if the first analysis allocates more than
+//             ALLOCATIONSPERSYMBOL per symbol, or the parsed one more than
+//             PARSEALLOCATIONSPERSYMBOL, so a change that allocates per bar
+//             or per row fails the benchmark
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Tracks parsing stock data files
+//******************************************************************************
+void PortfolioBenchmark::benchmarkAllocations()
+{
+   static const char* DIRECTORYNAME = "AllocationBenchmark"; // Of the files
+   static const int   NUMRUNS       = 3; // First, repeated, parsed
+   static const int   PARSEDRUN     = 2; // From the stock data files
+
+   const bool        WASENABLED = AllocationTracker::isEnabled(); // Restored
+   PortfolioAnalyzer portfolioAnalyzer;   // Synthetic stocks
+   PortfolioAnalyzer parsedAnalyzer;      // From the stock data files
+   vector<string>    stockNames;          // Its file names
+   vector<string>    stockDataFileNames(PortfolioBenchmark::ALLOCATIONNUMFILES);
+   vector<char*>     fileNamePointers;    // Handed to parsedAnalyzer
+   vector<int>       topIndices;          // Ranked analyzers
+   long long         numAllocations[NUMRUNS]; // Of each run
+   const char*       runNames[NUMRUNS] = { "first", "repeated", "parsed" };
+   const int         numSymbols[NUMRUNS] = {
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::ALLOCATIONNUMFILES };
+   const int         budgets[NUMRUNS] = {
+      PortfolioBenchmark::ALLOCATIONSPERSYMBOL,
+      0,
+      PortfolioBenchmark::PARSEALLOCATIONSPERSYMBOL }; // Per symbol, if any
+
+   this->generatePortfolio(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      stockNames,
+      portfolioAnalyzer);
+
+   // Write a stock data file for each of ALLOCATIONNUMFILES symbols
+   Platform::makeDirectory(DIRECTORYNAME);
+
+   for (int fileIndex = 0;
+        fileIndex < PortfolioBenchmark::ALLOCATIONNUMFILES;
+        ++fileIndex)
+   {
+      ostringstream name; // Of the file
+
+      name << DIRECTORYNAME << "/StockDataSYN" << setw(6) << setfill('0')
+           << fileIndex << ".csv";
+      stockDataFileNames[fileIndex] = name.str();
+      writeStockDataFile(
+         stockDataFileNames[fileIndex],
+         fileIndex + 1,
+         PortfolioBenchmark::DEFAULTNUMBARS);
+      fileNamePointers.push_back(&stockDataFileNames[fileIndex][0]);
+   }
+
+   parsedAnalyzer.setVerbose(false);
+   parsedAnalyzer.setStockDataFiles(fileNamePointers);
+
+   cout << "---Allocations: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " bars, " << PortfolioBenchmark::ALLOCATIONNUMFILES
+        << " parsed from stock data files---" << endl << endl;
+
+   // Track the first analysis and ranking, then a repeated one, then one
+   // parsed from the stock data files
+   for (int run = 0; run < NUMRUNS; ++run)
+   {
+      PortfolioAnalyzer& analyzer = (PARSEDRUN == run) ?
+         parsedAnalyzer : portfolioAnalyzer; // Of the run
+
+      AllocationTracker::reset();
+      AllocationTracker::setEnabled(true);
+
+      analyzer.analyzePortfolio();
+      analyzer.getTopStocksByMACDSlope(numSymbols[run], topIndices);
+
+      AllocationTracker::setEnabled(false);
+      numAllocations[run] = AllocationTracker::getNumAllocations();
+
+      if (0 == run)
+      {
+         AllocationTracker::outputSummary(
+            cout, 0, PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+      }
+   }
+
+   // Remove the files
+   for (int fileIndex = 0;
+        fileIndex < PortfolioBenchmark::ALLOCATIONNUMFILES;
+        ++fileIndex)
+   {
+      remove(stockDataFileNames[fileIndex].c_str());
+   }
+
+   Platform::removeDirectory(DIRECTORYNAME);
+
+   cout << setw(10) << "analysis" << setw(14) << "allocations" 
+        << setw(16) << "allocs/symbol" << setw(10) << "budget" << endl;
+
+   for (int run = 0; run < NUMRUNS; ++run)
+   {
+      cout << setw(10) << runNames[run]
+           << setw(14) << numAllocations[run]
+           << setw(16) << fixed << setprecision(2)
+           << double(numAllocations[run]) / numSymbols[run];
+      cout.unsetf(ios::floatfield);
+
+      if (budgets[run] > 0)
+      {
+         cout << setw(10) << budgets[run];
+      }
+
+      cout << endl;
+   }
+
+   cout << endl;
+
+   // Restore whether AllocationTracker was enabled, and reset it
+   AllocationTracker::setEnabled(WASENABLED);
+   AllocationTracker::reset();
+
+   for (int run = 0; run < NUMRUNS; ++run)
+   {
+      if (budgets[run] > 0 &&
+          numAllocations[run] > (long long)budgets[run] * numSymbols[run])
+      {
+         throw exception("Analysis exceeded its allocations per symbol budget");
+      }
+   }
+}
+
+//******************************************************************************
+// Function : benchmarkBoundedHistory
+// Process  : Generate the synthetic universe
+//             For every symbol
+//                Analyze it unbounded, bounded, and streamed into an empty 
+//                   bounded analyzer one price at a time
+//                Compare the MACDs and the bytes held
+//             Check a bounded analyzer rejects a new slow period
+//             Soak SOAKNUMSYMBOLS empty bounded analyzers with SOAKNUMUPDATES
+//                updates, round robin
+//                Output the resident set size SOAKNUMSAMPLES times
+//             Output the growth after the first sample, when every analyzer
+//                is warmed up, against what unbounded lists would have added
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Checks periods are fixed once bounded
+//******************************************************************************
+void PortfolioBenchmark::benchmarkBoundedHistory()
+{
+   const long long UPDATESPERSAMPLE = 
+      PortfolioBenchmark::SOAKNUMUPDATES / PortfolioBenchmark::SOAKNUMSAMPLES;
+   const int       BYTESPERUPDATE   = 
+      3 * sizeof(AnalyzerPricePolicy::StorageType); // Price and two EMAs
+
+   vector< vector<double> > universe;           // Prices of every symbol
+   vector<double>           macdsUnbounded;     // Current MACD per symbol
+   vector<double>           macdsBounded;       // Current MACD per symbol
+   vector<double>           macdsStreamed;      // Current MACD per symbol
+   vector<double>           slopesUnbounded;    // MACD slope per symbol
+   vector<double>           slopesStreamed;     // MACD slope per symbol
+   int                      bytesUnbounded = 0; // Bytes held by the last
+   int                      bytesBounded   = 0; // symbol of each kind
+
+   this->generateUniverse(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      universe);
+
+   // Analyze every symbol unbounded, bounded, and streamed
+   for (size_t symbolIndex = 0; symbolIndex < universe.size(); ++symbolIndex)
+   {
+      StockAnalyzer unbounded; // Keeps every price and EMA
+      StockAnalyzer bounded;   // Bounded after the prices are set
+      StockAnalyzer streamed;  // Bounded from the start
+      Stock         stock;     // Prices of the symbol
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         stock.addPrice(universe[symbolIndex][barIndex]);
+      }
+
+      unbounded.setVerbose(false);
+      unbounded.setStock(stock);
+      unbounded.analyzeStock();
+
+      bounded.setVerbose(false);
+      bounded.setStock(stock);
+      bounded.setHistoryBounded(true);
+      bounded.analyzeStock();
+
+      streamed.setVerbose(false);
+      streamed.setHistoryBounded(true);
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         streamed.updateWithPrice(universe[symbolIndex][barIndex]);
+      }
+
+      macdsUnbounded.push_back(unbounded.getCurrentMACD());
+      macdsBounded.push_back(bounded.getCurrentMACD());
+      macdsStreamed.push_back(streamed.getCurrentMACD());
+      slopesUnbounded.push_back(unbounded.getSlopeMACD());
+      slopesStreamed.push_back(streamed.getSlopeMACD());
+      bytesUnbounded = unbounded.getHistoryStorageBytes();
+      bytesBounded   = streamed.getHistoryStorageBytes();
+   }
+
+   cout << "---Bounded history: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " bars---" << endl << endl;
+   cout << "   history bytes/symbol, unbounded: " << bytesUnbounded << endl;
+   cout << "   history bytes/symbol, bounded:   " << bytesBounded << endl;
+   cout << "   max |dMACD| bounded vs unbounded:  " 
+        << maxAbsDifference(macdsBounded, macdsUnbounded) << endl;
+   cout << "   max |dMACD| streamed vs unbounded: " 
+        << maxAbsDifference(macdsStreamed, macdsUnbounded) << endl;
+   cout << "   max |dSlope| streamed vs unbounded: " 
+        << maxAbsDifference(slopesStreamed, slopesUnbounded) << endl;
+
+   // Check a bounded analyzer rejects new periods, its history was sized by
+   // the old ones
+   StockAnalyzer resized; // Bounded, then given a longer slow period
+   string        resizedResult = "accepted, FAILED"; // Of the period change
+
+   resized.setVerbose(false);
+   resized.setHistoryBounded(true);
+
+   try
+   {
+      resized.setPeriodsSlow(PortfolioBenchmark::BOUNDEDCHANGEDPERIODS);
+      resized.updateWithPrice(universe[0][0]);
+   }
+   catch (const exception&)
+   {
+      resizedResult = "rejected";
+   }
+
+   cout << "   new periods once bounded:          " << resizedResult
+        << endl << endl;
+
+   // Soak empty bounded analyzers, round robin
+   vector<StockAnalyzer>   analyzers(PortfolioBenchmark::SOAKNUMSYMBOLS);
+   SyntheticPriceGenerator generator(1);        // Prices for every symbol
+   long long               numUpdates    = 0;   // Updates so far
+   long long               firstRSSBytes = 0;   // RSS once warmed up
+   long long               rssBytes      = 0;   // RSS at the sample
+   int                     analyzerIndex = 0;   // Next analyzer updated
+
+   for (size_t index = 0; index < analyzers.size(); ++index)
+   {
+      analyzers[index].setVerbose(false);
+      analyzers[index].setHistoryBounded(true);
+   }
+
+   cout << "---Bounded history soak: " << PortfolioBenchmark::SOAKNUMSYMBOLS
+        << " symbols, " << PortfolioBenchmark::SOAKNUMUPDATES
+        << " updates---" << endl << endl;
+   cout << setw(14) << "updates" << setw(12) << "RSS MB"
+        << setw(12) << "ns/update" << endl;
+   cout << setw(14) << 0 << setw(12) << fixed << setprecision(1)
+        << Platform::getResidentSetBytes() / BYTESPERMEGABYTE << endl;
+
+   for (int sample = 0; sample < PortfolioBenchmark::SOAKNUMSAMPLES; ++sample)
+   {
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (long long update = 0; update < UPDATESPERSAMPLE; ++update)
+      {
+         analyzers[analyzerIndex].updateWithPrice(generator.nextPrice());
+
+         if (++analyzerIndex == PortfolioBenchmark::SOAKNUMSYMBOLS)
+         {
+            analyzerIndex = 0;
+         }
+      }
+
+      double seconds = elapsedSeconds(start); // Time for the sample
+
+      numUpdates += UPDATESPERSAMPLE;
+      rssBytes    = Platform::getResidentSetBytes();
+
+      if (0 == sample)
+      {
+         firstRSSBytes = rssBytes;
+      }
+
+      cout << setw(14) << numUpdates
+           << setw(12) << rssBytes / BYTESPERMEGABYTE
+           << setw(12) << seconds * 1.0e9 / UPDATESPERSAMPLE << endl;
+   }
+
+   cout << endl;
+   cout << "   RSS growth after warm up, MB:          " 
+        << (rssBytes - firstRSSBytes) / BYTESPERMEGABYTE << endl;
+   cout << "   Unbounded lists would have added, MB:  " 
+        << (numUpdates - UPDATESPERSAMPLE) * BYTESPERUPDATE / BYTESPERMEGABYTE
+        << endl << endl;
+   cout.unsetf(ios::floatfield);
+}
+
+//******************************************************************************
+// Function : benchmarkCalendar
+// Process  : Generate dated synthetic stocks on a weekday calendar, each
+//                listed up to CALENDARLISTINGDAYS late and halted every
+//                CALENDARHALTPERIOD days from its own offset
+//             Time CALENDARNUMPARSES date parses of the calendar's dates
+//             Time DEFAULTNUMREPS alignments of the stocks
+//             Check every price landed in its stock's column on its date
+//             Output the parse and alignment rates and the matrix density
+// Notes    : Throws an exception if the check fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkCalendar()
+{
+   const int            FIRSTDATE = TradingCalendar::toDate(2000, 1, 3);
+   vector<Stock>        stocks(PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+   vector<const Stock*> stockPointers;   // Aligned
+   vector<string>       dateTexts;       // Of the weekday calendar
+   vector<double>       prices;          // Of one stock
+   TradingCalendar      calendar;        // Aligned stocks
+   long long            numPrices  = 0;  // Of every stock
+   long long            dateSum    = 0;  // Keeps the parses
+   double               parseSeconds;    // All parses
+   double               alignSeconds;    // All alignments
+
+   // Generate dated synthetic stocks on a weekday calendar
+   for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+        ++barIndex)
+   {
+      dateTexts.push_back(TradingCalendar::formatDate(
+         FIRSTDATE + (barIndex / 5) * 7 + barIndex % 5));
+   }
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::DEFAULTNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(symbolIndex + 1); // Seed per symbol
+      const int               LISTING = (symbolIndex * 7) % 
+                              PortfolioBenchmark::CALENDARLISTINGDAYS;
+
+      generator.generatePrices(PortfolioBenchmark::DEFAULTNUMBARS, prices);
+
+      for (int barIndex = LISTING; 
+           barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         if (0 == (barIndex + symbolIndex) % 
+                  PortfolioBenchmark::CALENDARHALTPERIOD)
+         {
+            continue;
+         }
+
+         stocks[symbolIndex].addPrice(prices[barIndex]);
+         stocks[symbolIndex].addDate(
+            FIRSTDATE + (barIndex / 5) * 7 + barIndex % 5);
+         ++numPrices;
+      }
+
+      stockPointers.push_back(&stocks[symbolIndex]);
+   }
+
+   // Time date parses of the calendar's dates
+   BenchmarkClock::time_point parseStart = BenchmarkClock::now();
+
+   for (int parseIndex = 0, textIndex = 0; 
+        parseIndex < PortfolioBenchmark::CALENDARNUMPARSES; 
+        ++parseIndex)
+   {
+      int date = 0; // Parsed
+
+      TradingCalendar::parseDate(dateTexts[textIndex].c_str(), date);
+      dateSum += date;
+
+      if (++textIndex == int(dateTexts.size()))
+      {
+         textIndex = 0;
+      }
+   }
+
+   parseSeconds = elapsedSeconds(parseStart);
+
+   // Time alignments of the stocks
+   BenchmarkClock::time_point alignStart = BenchmarkClock::now();
+
+   for (int rep = 0; rep < PortfolioBenchmark::DEFAULTNUMREPS; ++rep)
+   {
+      calendar.align(stockPointers);
+   }
+
+   alignSeconds = elapsedSeconds(alignStart);
+
+   // Check every price landed in its stock's column on its date
+   for (int symbolIndex = 0; symbolIndex < calendar.getNumSymbols(); 
+        ++symbolIndex)
+   {
+      int dateIndex = 0; // Calendar row of the stock's date
+
+      for (int priceIndex = 0; 
+           priceIndex < stocks[symbolIndex].getNumPrices(); 
+           ++priceIndex)
+      {
+         while (calendar.getDateAt(dateIndex) != 
+                stocks[symbolIndex].getDateAt(priceIndex))
+         {
+            ++dateIndex;
+         }
+
+         if (!calendar.isValidAt(dateIndex, symbolIndex) ||
+             calendar.getPriceAt(dateIndex, symbolIndex) != 
+             stocks[symbolIndex].getPriceAt(priceIndex))
+         {
+            throw exception("Calendar alignment check failed");
+         }
+      }
+   }
+
+   if (calendar.getNumValid() != numPrices ||
+       dateSum < PortfolioBenchmark::CALENDARNUMPARSES)
+   {
+      throw exception("Calendar alignment check failed");
+   }
+
+   cout << "---Calendar: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " weekdays---" << endl << endl;
+   cout << fixed << setprecision(2);
+   cout << "Date parse:  " 
+        << parseSeconds * 1.0e9 / PortfolioBenchmark::CALENDARNUMPARSES 
+        << " ns/date" << endl;
+   cout << "Align:       " 
+        << alignSeconds * 1000.0 / PortfolioBenchmark::DEFAULTNUMREPS 
+        << " ms, " 
+        << numPrices * PortfolioBenchmark::DEFAULTNUMREPS / alignSeconds / 1.0e6
+        << " M prices/s" << endl;
+   cout << "Matrix:      " << calendar.getNumDates() << " dates x " 
+        << calendar.getNumSymbols() << " symbols, " 
+        << 100.0 * calendar.getNumValid() / 
+           ((double)calendar.getNumDates() * calendar.getNumSymbols())
+        << "% valid" << endl << endl;
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : benchmarkCompression
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks on a weekday 
+//                calendar with halts, with whole cent prices, adjusted
+//                prices that aren't whole cents, and random volumes
+//             Load the default stocks' dates and prices, if run from res
+//             Output the compression and decoding of each column
+//             Time an EMA over the synthetic prices as doubles, then 
+//                decoding them a block at a time into the same EMA
+// Notes    : Throws an exception if a column doesn't round trip or the 
+//             EMAs differ
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkCompression()
+{
+   static const double ADJUSTMENT = 0.987654; // Of the adjusted prices
+   static const double MULTEMA    = 2.0 / (26 + 1); // Slow EMA multiplier
+
+   const int                   FIRSTDATE = TradingCalendar::toDate(2000, 1, 3);
+   vector< vector<int> >       dates(PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+   vector< vector<double> >    prices;    // Whole cents
+   vector< vector<double> >    adjusted(PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+   vector< vector<long long> > volumes(PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+   vector< vector<int> >       stockDates;  // Of the default stocks
+   vector< vector<double> >    stockPrices; // Of the default stocks
+   PortfolioAnalyzer           portfolioAnalyzer; // Default stocks
+   vector<CompressedSeries>    series(PortfolioBenchmark::DEFAULTNUMSYMBOLS);
+   vector<double>              block(CompressedSeries::BLOCKVALUES);
+   double                      rawEMA     = 0.0; // Of the doubles
+   double                      decodedEMA = 0.0; // Of the decoded blocks
+
+   // Generate the synthetic stocks
+   this->generateUniverse(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      prices);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::DEFAULTNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(symbolIndex + 1); // Of the volumes
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         if (0 == (barIndex + symbolIndex) % 
+                  PortfolioBenchmark::CALENDARHALTPERIOD)
+         {
+            continue;
+         }
+
+         dates[symbolIndex].push_back(
+            FIRSTDATE + (barIndex / 5) * 7 + barIndex % 5);
+      }
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         adjusted[symbolIndex].push_back(
+            prices[symbolIndex][barIndex] * ADJUSTMENT);
+         volumes[symbolIndex].push_back(
+            100000 + generator.nextRandom() % 2000000);
+      }
+   }
+
+   // Load the default stocks' dates and prices, if run from res
+   try
+   {
+      portfolioAnalyzer.setVerbose(false);
+      portfolioAnalyzer.addDefaultStocksToPortfolio();
+      portfolioAnalyzer.analyzePortfolio();
+   }
+   catch (const exception&)
+   {
+      cout << "Default stocks not found, run from res to include them" 
+           << endl << endl;
+   }
+
+   for (int analyzerIndex = 0; 
+        analyzerIndex < portfolioAnalyzer.getNumStockAnalyzers(); 
+        ++analyzerIndex)
+   {
+      const Stock& stock = portfolioAnalyzer.
+         getStockAnalyzerRefAtIndex(analyzerIndex).getStockRef();
+
+      if (stock.getNumDates() > 0)
+      {
+         stockDates.push_back(vector<int>(
+            stock.getDateData(), stock.getDateData() + stock.getNumDates()));
+      }
+
+      if (stock.getNumPrices() > 0)
+      {
+         stockPrices.push_back(vector<double>(
+            stock.getPriceData(), 
+            stock.getPriceData() + stock.getNumPrices()));
+      }
+   }
+
+   // Output the compression and decoding of each column
+   cout << "---Compression: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " synthetic stocks x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " bars, " << stockPrices.size() << " res stocks---" << endl 
+        << endl;
+   cout << setw(18) << left << "column" << right << setw(10) << "values" 
+        << setw(10) << "raw MB" << setw(10) << "MB" << setw(8) << "ratio" 
+        << setw(12) << "Mvalues/s" << setw(10) << "raw GB/s" << endl;
+
+   outputCompression("synthetic dates", dates);
+   outputCompression("synthetic prices", prices);
+   outputCompression("adjusted prices", adjusted);
+   outputCompression("synthetic volumes", volumes);
+
+   if (!stockPrices.empty())
+   {
+      outputCompression("res dates", stockDates);
+      outputCompression("res prices", stockPrices);
+   }
+
+   // Time an EMA over the prices as doubles
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::DEFAULTNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      double ema = prices[symbolIndex][0]; // Of the stock
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         ema = (prices[symbolIndex][barIndex] - ema) * MULTEMA + ema;
+      }
+
+      rawEMA += ema;
+   }
+
+   double rawSeconds = elapsedSeconds(start); // EMA of the doubles
+
+   // Then decoding them a block at a time into the same EMA
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::DEFAULTNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      series[symbolIndex].compressPrices(
+         prices[symbolIndex].data(), prices[symbolIndex].size());
+   }
+
+   start = BenchmarkClock::now();
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::DEFAULTNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      double ema = prices[symbolIndex][0]; // Of the stock
+
+      for (int blockIndex = 0; 
+           blockIndex < series[symbolIndex].getNumBlocks(); 
+           ++blockIndex)
+      {
+         const int BLOCKSIZE = series[symbolIndex].decodePriceBlock(
+            blockIndex, block.data());
+
+         for (int priceIndex = 0; priceIndex < BLOCKSIZE; ++priceIndex)
+         {
+            ema = (block[priceIndex] - ema) * MULTEMA + ema;
+         }
+      }
+
+      decodedEMA += ema;
+   }
+
+   double decodedSeconds = elapsedSeconds(start); // EMA of the blocks
+
+   if (rawEMA != decodedEMA)
+   {
+      throw exception("EMA of the decoded prices differs");
+   }
+
+   const double NUMPRICES = double(PortfolioBenchmark::DEFAULTNUMSYMBOLS) * 
+                            PortfolioBenchmark::DEFAULTNUMBARS;
+
+   cout << endl << fixed << setprecision(2)
+        << "EMA from doubles:           " 
+        << rawSeconds * 1.0e9 / NUMPRICES << " ns/price" << endl
+        << "EMA from compressed blocks: " 
+        << decodedSeconds * 1.0e9 / NUMPRICES << " ns/price" << endl;
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkCorrelation
+// Process  : For each of CORRELATIONNUMSIZES numbers of symbols
+//                Generate dated synthetic stocks over 
+//                   CORRELATIONNUMRETURNS weekdays, halted every 
+//                   CALENDARHALTPERIOD days from each one's offset, and 
+//                   align them
+//                Set the returns and time the correlation, keeping the
+//                   matrix at the smallest size
+//                Check sampled pairs, and the first symbol's neighbours,
+//                   against referenceCorrelation at the smallest size
+//                Output the wall time and GFLOP/s
+// Notes    : Throws an exception if a check fails
+//             Halts leave every block masked, the slower path
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkCorrelation()
+{
+   static const int NUMSIZES                    = 3;  // Symbol counts
+   static const int SIZES[NUMSIZES]             = { 1000, 5000, 20000 };
+   static const int NUMSAMPLES                  = 1000; // Pairs checked
+   static const int NUMNEIGHBOURS               = 10;   // Per symbol
+   static const double TOLERANCE                = 1.0e-4; // Float sums
+
+   const int FIRSTDATE  = TradingCalendar::toDate(2000, 1, 3);
+   const int NUMTHREADS = max(1, int(thread::hardware_concurrency()));
+
+   cout << "---Correlation: " << PortfolioBenchmark::CORRELATIONNUMRETURNS
+        << " daily returns, halts every " 
+        << PortfolioBenchmark::CALENDARHALTPERIOD << " days, " 
+        << NUMTHREADS << " threads---" << endl << endl;
+   cout << setw(10) << "symbols" << setw(14) << "pairs" 
+        << setw(12) << "seconds" << setw(12) << "GFLOP/s" 
+        << setw(14) << "max error" << endl;
+
+   for (int sizeIndex = 0; sizeIndex < NUMSIZES; ++sizeIndex)
+   {
+      const int                            NUMSYMBOLS = SIZES[sizeIndex];
+      const bool                           CHECKED    = (0 == sizeIndex);
+      vector<Stock>                        stocks(NUMSYMBOLS);
+      vector<const Stock*>                 stockPointers;
+      vector<double>                       prices;     // Of one stock
+      TradingCalendar                      calendar;   // Aligned stocks
+      CorrelationMatrix                    correlationMatrix;
+      vector<CorrelationMatrix::Neighbour> neighbours; // Of the first symbol
+      double                               maxError = 0.0; // Of the checks
+
+      // Generate dated synthetic stocks, halted, and align them
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         SyntheticPriceGenerator generator(symbolIndex + 1); // Seed per symbol
+
+         generator.generatePrices(
+            PortfolioBenchmark::CORRELATIONNUMRETURNS + 1, prices);
+
+         for (int barIndex = 0; 
+              barIndex <= PortfolioBenchmark::CORRELATIONNUMRETURNS; 
+              ++barIndex)
+         {
+            if (0 == (barIndex + symbolIndex) % 
+                     PortfolioBenchmark::CALENDARHALTPERIOD)
+            {
+               continue;
+            }
+
+            stocks[symbolIndex].addPrice(prices[barIndex]);
+            stocks[symbolIndex].addDate(
+               FIRSTDATE + (barIndex / 5) * 7 + barIndex % 5);
+         }
+
+         stockPointers.push_back(&stocks[symbolIndex]);
+      }
+
+      calendar.align(stockPointers);
+      correlationMatrix.setReturns(calendar);
+
+      // Time the correlation
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      correlationMatrix.calculate(NUMNEIGHBOURS, CHECKED, NUMTHREADS);
+
+      const double SECONDS = elapsedSeconds(start);
+
+      // Check sampled pairs and the first symbol's neighbours
+      if (CHECKED)
+      {
+         for (int sample = 0; sample < NUMSAMPLES; ++sample)
+         {
+            const int SYMBOL = (sample * 7919) % NUMSYMBOLS;
+            const int OTHER  = (sample * 104729 + 1) % NUMSYMBOLS;
+
+            maxError = max(maxError, fabs(
+               correlationMatrix.getCorrelationAt(SYMBOL, OTHER) -
+               referenceCorrelation(calendar, SYMBOL, OTHER)));
+         }
+
+         correlationMatrix.getNeighbours(0, neighbours);
+
+         for (int otherIndex = 1; otherIndex < NUMSYMBOLS; ++otherIndex)
+         {
+            if (neighbours.size() < size_t(NUMNEIGHBOURS) ||
+                correlationMatrix.getCorrelationAt(0, otherIndex) > 
+                neighbours.back().correlation)
+            {
+               bool found = false; // Among the neighbours?
+
+               for (size_t neighbourIndex = 0; 
+                    neighbourIndex < neighbours.size(); 
+                    ++neighbourIndex)
+               {
+                  found = found || 
+                     otherIndex == neighbours[neighbourIndex].symbolIndex;
+               }
+
+               if (!found)
+               {
+                  throw exception("Correlation neighbour check failed");
+               }
+            }
+         }
+
+         if (maxError > TOLERANCE)
+         {
+            throw exception("Correlation check failed");
+         }
+      }
+
+      cout << setw(10) << NUMSYMBOLS 
+           << setw(14) << (long long)NUMSYMBOLS * (NUMSYMBOLS - 1) / 2
+           << setw(12) << fixed << setprecision(3) << SECONDS
+           << setw(12) << setprecision(2) 
+           << correlationMatrix.getNumFlops() / SECONDS / 1.0e9;
+
+      if (CHECKED)
+      {
+         cout << setw(14) << scientific << setprecision(2) << maxError;
+      }
+
+      cout << endl;
+      cout.unsetf(ios::floatfield);
+      cout << setprecision(6);
+   }
+
+   cout << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkCrossovers
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks of DEFAULTNUMBARS
+//                bars
+//             For 1 thread, doubling up to a thread per hardware thread
+//                Time CROSSOVERNUMREPS detections of every crossover of the
+//                   universe
+//                Check every bit of the first against referenceCrossovers,
+//                   and that every event is listed in order
+//                Output the time, bars per second, and speedup
+// Notes    : Throws an exception if a check fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkCrossovers()
+{
+   const int NUMSYMBOLS = PortfolioBenchmark::DEFAULTNUMSYMBOLS;
+   const int NUMBARS    = PortfolioBenchmark::DEFAULTNUMBARS;
+   const int NUMREPS    = PortfolioBenchmark::CROSSOVERNUMREPS;
+   const int MAXTHREADS = max(1, int(thread::hardware_concurrency()));
+
+   vector< vector<double> > universe;        // Closes of each stock
+   vector<Stock>            stocks(NUMSYMBOLS);
+   vector<const Stock*>     stockPointers;   // Of each stock
+   CrossoverDetector        detector;        // Of the universe
+   double                   seconds    = 0.0; // Of a thread count
+   double                   oneThread  = 0.0; // Seconds of 1 thread
+   int                      numEvents  = 0;   // By the reference
+
+   // Generate the synthetic stocks
+   this->generateUniverse(NUMSYMBOLS, NUMBARS, universe);
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      stocks[symbolIndex].setHistory(
+         NULL, universe[symbolIndex].data(), NUMBARS);
+      stockPointers.push_back(&stocks[symbolIndex]);
+   }
+
+   cout << "---Crossovers: " << NUMSYMBOLS << " symbols, " << NUMBARS
+        << " bars, MACD " << detector.getPeriodsFast() << "/"
+        << detector.getPeriodsSlow() << "/" << detector.getPeriodsSignal()
+        << "---" << endl << endl;
+   cout << setw(8) << "threads" << setw(12) << "ms" << setw(14)
+        << "Mbars/s" << setw(12) << "speedup" << endl;
+
+   for (int numThreads = 1; numThreads <= MAXTHREADS;
+        numThreads = (numThreads < MAXTHREADS && 2 * numThreads > MAXTHREADS) ?
+                     MAXTHREADS : 2 * numThreads)
+   {
+      // Time the detections
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+      {
+         detector.detect(stockPointers, numThreads);
+      }
+
+      seconds = elapsedSeconds(start) / NUMREPS;
+
+      if (1 == numThreads)
+      {
+         oneThread = seconds;
+      }
+
+      // Check every bit against the reference, and the list of events
+      numEvents = 0;
+
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         numEvents += referenceCrossovers(
+            stocks[symbolIndex], symbolIndex, detector);
+      }
+
+      if (numEvents != detector.getNumEvents())
+      {
+         throw exception("Crossover event list check failed");
+      }
+
+      for (int eventIndex = 1; eventIndex < numEvents; ++eventIndex)
+      {
+         const CrossoverDetector::Event& BEFORE =
+            detector.getEventAt(eventIndex - 1);
+         const CrossoverDetector::Event& EVENT  =
+            detector.getEventAt(eventIndex);
+
+         if (BEFORE.date > EVENT.date ||
+             (BEFORE.date == EVENT.date &&
+              BEFORE.symbolIndex > EVENT.symbolIndex))
+         {
+            throw exception("Crossover event order check failed");
+         }
+      }
+
+      cout << setw(8) << numThreads << fixed << setprecision(2)
+           << setw(12) << seconds * 1.0e3
+           << setprecision(1)
+           << setw(14) << detector.getNumBars() / seconds / 1.0e6
+           << setprecision(2)
+           << setw(12) << oneThread / seconds << endl;
+      cout.unsetf(ios::floatfield);
+
+      if (MAXTHREADS == numThreads)
+      {
+         break;
+      }
+   }
+
+   cout << endl << numEvents << " crossovers, each detection checked bar "
+        << "by bar" << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkDaemonLatency
+// Process  : Generate and analyze a synthetic portfolio
+//             Serve it with an AnalysisDaemon on a background thread
+//             Wait for the daemon to listen
+//             Throws an exception if it does not start
+//             Run the DaemonLoadGenerator against it, with BAR requests
+//             Stop the daemon
+// Notes    : Client and daemon share the machine, as they would in use
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkDaemonLatency()
+{
+   static const char* SOCKETPATH = "stockanalyzer_benchmark.sock";
+   static const int   NUMBARS    = 252;   // One year of daily bars
+   static const int   WAITMILLIS = 1;     // Poll interval while starting
+   static const int   MAXWAITS   = 5000;  // Polls before giving up
+
+   vector<string>      stockNames;        // Synthetic stock names
+   PortfolioAnalyzer   portfolioAnalyzer; // Portfolio being served
+   DaemonLoadGenerator loadGenerator;     // Client sending the requests
+
+   // Generate and analyze a synthetic portfolio
+   this->generatePortfolio(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      NUMBARS,
+      stockNames,
+      portfolioAnalyzer);
+   portfolioAnalyzer.analyzePortfolio();
+
+   // Serve it with an AnalysisDaemon on a background thread
+   AnalysisDaemon daemon(portfolioAnalyzer);
+   thread         daemonThread(runDaemon, &daemon, string(SOCKETPATH));
+
+   for (int wait = 0; !daemon.isRunning() && wait < MAXWAITS; ++wait)
+   {
+      this_thread::sleep_for(chrono::milliseconds(WAITMILLIS));
+   }
+
+   if (!daemon.isRunning())
+   {
+      daemon.stop();
+      daemonThread.join();
+      throw exception("Daemon did not start");
+   }
+
+   cout << "---Daemon serving " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols---" << endl << endl;
+
+   try
+   {
+      loadGenerator.run(
+         SOCKETPATH,
+         DaemonLoadGenerator::DEFAULTNUMREQUESTS,
+         true);
+   }
+   catch (const exception&)
+   {
+      daemon.stop();
+      daemonThread.join();
+      throw;
+   }
+
+   daemon.stop();
+   daemonThread.join();
+}
+
+//******************************************************************************
+// Function : benchmarkIndicatorGraph
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks
+//             Add each strategy's indicators to an engine of its own, and
+//                every strategy's to one unshared and one shared engine
+//             Time a pass per stock of each strategy's engine, then of the
+//                unshared and the shared engine
+//             Check every indicator's values are the same from each
+//             Output the nodes and time per bar of each, and the nodes the
+//                shared engine eliminated
+// Notes    : Throws an exception if the values differ
+//             The strategies overlap as strategies evaluated together do:
+//                MACDs sharing an EMA, EMA crossovers on a MACD's EMAs, and
+//                Bollinger bands on an SMA
+//             The highs and lows are the closes
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkIndicatorGraph()
+{
+   static const char* STRATEGIES[] =
+   {
+      "macd signal",
+      "macd12_50 signal12_50_9 sma200",
+      "ema12 ema26",
+      "ema26 ema50 sma50",
+      "sma20 bbupper20 bblower20 rsi14",
+      "rsi14 stoch14 sma50",
+      "high20 low20 atr14 sma20",
+      "macd sma50 sma200"
+   };
+   static const int   NUMSTRATEGIES =
+      sizeof(STRATEGIES) / sizeof(STRATEGIES[0]);
+   static const char* ENGINENAMES[] =
+   {
+      "per strategy",
+      "one, unshared",
+      "one, shared"
+   };
+   static const int   NUMENGINES = sizeof(ENGINENAMES) / sizeof(ENGINENAMES[0]);
+
+   const int NUMSYMBOLS = PortfolioBenchmark::DEFAULTNUMSYMBOLS;
+   const int NUMBARS    = PortfolioBenchmark::DEFAULTNUMBARS;
+
+   vector< vector<double> > closes;                    // Of each stock
+   vector<IndicatorEngine>  strategies(NUMSTRATEGIES);  // An engine each
+   IndicatorEngine          unshared;                  // Of every strategy
+   IndicatorEngine          shared;                    // Of every strategy
+   vector<double>           values[NUMENGINES];        // Of each engine
+   double                   seconds[NUMENGINES];       // Of each engine
+   int                      numNodes[NUMENGINES] = { 0, 0, 0 };
+   int                      numIndicators  = 0;        // Of every strategy
+   int                      strategyOffset = 0;        // Of its values
+   int                      unsharedOffset = 0;        // Of its indicators
+
+   // Generate the synthetic stocks
+   this->generateUniverse(NUMSYMBOLS, NUMBARS, closes);
+
+   // Add each strategy's indicators to an engine of its own, and every
+   // strategy's to one unshared and one shared engine
+   unshared.setSharing(false);
+
+   for (int strategyIndex = 0; strategyIndex < NUMSTRATEGIES;
+        ++strategyIndex)
+   {
+      istringstream indicators(STRATEGIES[strategyIndex]); // Its names
+      string        indicatorName;                         // Of each
+
+      while (indicators >> indicatorName)
+      {
+         strategies[strategyIndex].addIndicator(indicatorName);
+         unshared.addIndicator(indicatorName);
+         shared.addIndicator(indicatorName);
+      }
+
+      numNodes[0] += strategies[strategyIndex].getNumNodes();
+   }
+
+   numNodes[1]   = unshared.getNumNodes();
+   numNodes[2]   = shared.getNumNodes();
+   numIndicators = unshared.getNumIndicators();
+
+   for (int engineIndex = 0; engineIndex < NUMENGINES; ++engineIndex)
+   {
+      values[engineIndex].reserve(NUMSYMBOLS * numIndicators);
+   }
+
+   // Time a pass per stock of each strategy's engine
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int strategyIndex = 0; strategyIndex < NUMSTRATEGIES;
+        ++strategyIndex)
+   {
+      IndicatorEngine& engine = strategies[strategyIndex];
+
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         engine.run(closes[symbolIndex].data(), NULL, NULL, NUMBARS);
+
+         for (int indicatorIndex = 0;
+              indicatorIndex < engine.getNumIndicators(); ++indicatorIndex)
+         {
+            values[0].push_back(engine.getValue(indicatorIndex));
+         }
+      }
+   }
+
+   seconds[0] = elapsedSeconds(start);
+
+   // Then of the unshared and the shared engine
+   for (int engineIndex = 1; engineIndex < NUMENGINES; ++engineIndex)
+   {
+      IndicatorEngine& engine = (1 == engineIndex) ? unshared : shared;
+
+      start = BenchmarkClock::now();
+
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         engine.run(closes[symbolIndex].data(), NULL, NULL, NUMBARS);
+
+         for (int indicatorIndex = 0;
+              indicatorIndex < engine.getNumIndicators(); ++indicatorIndex)
+         {
+            values[engineIndex].push_back(engine.getValue(indicatorIndex));
+         }
+      }
+
+      seconds[engineIndex] = elapsedSeconds(start);
+   }
+
+   // Check every indicator's values are the same from each
+   for (int strategyIndex = 0; strategyIndex < NUMSTRATEGIES;
+        ++strategyIndex)
+   {
+      const IndicatorEngine& engine        = strategies[strategyIndex];
+      const int              NUMINDICATORS = engine.getNumIndicators();
+
+      for (int indicatorIndex = 0; indicatorIndex < NUMINDICATORS;
+           ++indicatorIndex)
+      {
+         const int SHAREDINDEX =
+            shared.findIndicator(engine.getIndicatorName(indicatorIndex));
+
+         for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+         {
+            const double VALUE = values[0][strategyOffset +
+               symbolIndex * NUMINDICATORS + indicatorIndex];
+
+            if (VALUE != values[1][symbolIndex * numIndicators +
+                                   unsharedOffset + indicatorIndex] ||
+                VALUE != values[2][symbolIndex * shared.getNumIndicators() +
+                                   SHAREDINDEX])
+            {
+               throw exception("Shared indicators differ from unshared");
+            }
+         }
+      }
+
+      strategyOffset += NUMSYMBOLS * NUMINDICATORS;
+      unsharedOffset += NUMINDICATORS;
+   }
+
+   cout << "---Indicator graph: " << NUMSTRATEGIES << " strategies, "
+        << NUMSYMBOLS << " symbols, " << NUMBARS << " bars---" << endl
+        << endl;
+
+   for (int strategyIndex = 0; strategyIndex < NUMSTRATEGIES;
+        ++strategyIndex)
+   {
+      cout << setw(4) << strategyIndex + 1 << ": "
+           << STRATEGIES[strategyIndex] << endl;
+   }
+
+   cout << endl << setw(16) << "engines" << setw(8) << "nodes"
+        << setw(10) << "ns/bar" << setw(10) << "speedup" << endl;
+
+   for (int engineIndex = 0; engineIndex < NUMENGINES; ++engineIndex)
+   {
+      cout << setw(16) << ENGINENAMES[engineIndex]
+           << setw(8) << numNodes[engineIndex] << fixed << setprecision(1)
+           << setw(10) << seconds[engineIndex] * 1.0e9 / NUMSYMBOLS / NUMBARS
+           << setw(10) << setprecision(2)
+           << seconds[0] / seconds[engineIndex] << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   cout << endl << "Nodes eliminated: " << shared.getNumNodesEliminated()
+        << " of " << numNodes[1] << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkIndicators
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks, with highs and
+//                lows around the closes as writeStockDataFile writes them
+//             Add each indicator to an engine of its own
+//             For the first 1 to NUMINDICATORS indicators
+//                Time one fused pass per stock of an engine with them all
+//                Time a pass per stock of each indicator's own engine
+//                Check the fused values are the separate values
+//                Output the primitives, the time per bar of each, and the
+//                   fused pass's speedup
+//             Check the engine's macd is StockAnalyzer's current MACD
+// Notes    : Throws an exception if the values differ
+//             Adding an indicator to the fused pass costs only its
+//                primitives' updates, a separate pass also costs a loop
+//                over the bars and their inputs
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkIndicators()
+{
+   static const char* INDICATORS[] =
+   {
+      "sma50",
+      "ema20",
+      "rsi14",
+      "atr14",
+      "stoch14",
+      "bbupper20",
+      "bblower20",
+      "high252",
+      "low252",
+      "macd"
+   };
+   static const int   NUMINDICATORS =
+      sizeof(INDICATORS) / sizeof(INDICATORS[0]);
+
+   const int NUMSYMBOLS = PortfolioBenchmark::DEFAULTNUMSYMBOLS;
+   const int NUMBARS    = PortfolioBenchmark::DEFAULTNUMBARS;
+
+   vector< vector<double> > closes;                 // Of each stock
+   vector< vector<double> > highs(NUMSYMBOLS);      // Of each stock
+   vector< vector<double> > lows(NUMSYMBOLS);       // Of each stock
+   vector<IndicatorEngine>  separate(NUMINDICATORS); // An engine each
+   vector<double>           fusedValues(NUMSYMBOLS * NUMINDICATORS);
+   vector<double>           separateValues(NUMSYMBOLS * NUMINDICATORS);
+
+   // Generate the synthetic stocks, with highs and lows
+   this->generateUniverse(NUMSYMBOLS, NUMBARS, closes);
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      const vector<double>& prices = closes[symbolIndex];
+
+      highs[symbolIndex].resize(NUMBARS);
+      lows[symbolIndex].resize(NUMBARS);
+
+      for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+      {
+         double open = prices[max(barIndex - 1, 0)]; // Yesterday's close
+
+         highs[symbolIndex][barIndex] = max(open, prices[barIndex]) * 1.01;
+         lows[symbolIndex][barIndex]  = min(open, prices[barIndex]) * 0.99;
+      }
+   }
+
+   // Add each indicator to an engine of its own
+   for (int indicatorIndex = 0; indicatorIndex < NUMINDICATORS;
+        ++indicatorIndex)
+   {
+      separate[indicatorIndex].addIndicator(INDICATORS[indicatorIndex]);
+   }
+
+   cout << "---Indicator engine: " << NUMSYMBOLS << " symbols, " << NUMBARS
+        << " bars---" << endl << endl;
+   cout << setw(12) << "indicators" << setw(12) << "primitives"
+        << setw(16) << "fused ns/bar" << setw(18) << "separate ns/bar"
+        << setw(10) << "speedup" << endl;
+
+   for (int numIndicators = 1; numIndicators <= NUMINDICATORS;
+        ++numIndicators)
+   {
+      IndicatorEngine fused; // Of the first numIndicators
+
+      for (int indicatorIndex = 0; indicatorIndex < numIndicators;
+           ++indicatorIndex)
+      {
+         fused.addIndicator(INDICATORS[indicatorIndex]);
+      }
+
+      // Time one fused pass per stock
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         fused.run(closes[symbolIndex].data(), highs[symbolIndex].data(),
+                   lows[symbolIndex].data(), NUMBARS);
+
+         for (int indicatorIndex = 0; indicatorIndex < numIndicators;
+              ++indicatorIndex)
+         {
+            fusedValues[symbolIndex * NUMINDICATORS + indicatorIndex] =
+               fused.getValue(indicatorIndex);
+         }
+      }
+
+      double fusedSeconds = elapsedSeconds(start); // For every stock
+
+      // Time a pass per stock of each indicator's own engine
+      start = BenchmarkClock::now();
+
+      for (int indicatorIndex = 0; indicatorIndex < numIndicators;
+           ++indicatorIndex)
+      {
+         IndicatorEngine& engine = separate[indicatorIndex];
+
+         for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+         {
+            engine.run(closes[symbolIndex].data(),
+                       highs[symbolIndex].data(),
+                       lows[symbolIndex].data(), NUMBARS);
+            separateValues[symbolIndex * NUMINDICATORS + indicatorIndex] =
+               engine.getValue(0);
+         }
+      }
+
+      double separateSeconds = elapsedSeconds(start); // For every stock
+
+      // Check the fused values are the separate values
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         for (int indicatorIndex = 0; indicatorIndex < numIndicators;
+              ++indicatorIndex)
+         {
+            const int VALUEINDEX = symbolIndex * NUMINDICATORS +
+                                   indicatorIndex;
+
+            if (fusedValues[VALUEINDEX] != separateValues[VALUEINDEX])
+            {
+               throw exception("Fused indicators differ from separate");
+            }
+         }
+      }
+
+      cout << setw(12) << numIndicators << setw(12)
+           << fused.getNumPrimitives() << fixed << setprecision(1)
+           << setw(16) << fusedSeconds * 1.0e9 / NUMSYMBOLS / NUMBARS
+           << setw(18) << separateSeconds * 1.0e9 / NUMSYMBOLS / NUMBARS
+           << setw(10) << setprecision(2) << separateSeconds / fusedSeconds
+           << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   // Check the engine's macd is StockAnalyzer's current MACD
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      StockAnalyzer stockAnalyzer; // Of the closes
+      Stock         stock;         // Of the closes
+
+      for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+      {
+         stock.addPrice(closes[symbolIndex][barIndex]);
+      }
+
+      stockAnalyzer.setVerbose(false);
+      stockAnalyzer.setStock(stock);
+      stockAnalyzer.analyzeStock();
+
+      if (stockAnalyzer.getCurrentMACD() !=
+          fusedValues[symbolIndex * NUMINDICATORS + NUMINDICATORS - 1])
+      {
+         throw exception("Indicator engine MACD differs from analyzer's");
+      }
+   }
+
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkMetrics
+// Process  : Time METRICSNUMTIMERS empty timed scopes, disabled then enabled
+//             Generate a synthetic portfolio
+//             Time DEFAULTNUMREPS analyses and rankings of it, alternating
+//                disabled and enabled so both see the same machine state
+//             Output the cost per timer and the overhead of enabling
+//             Restore whether Metrics was enabled, and reset it
+// Notes    : Compiled with STOCK_METRICS_OFF, every timer is gone and both
+//             columns match
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkMetrics()
+{
+   static const int NUMMODES = 2; // Disabled, enabled
+
+   const bool        WASENABLED = Metrics::isEnabled(); // Restored afterwards
+   PortfolioAnalyzer portfolioAnalyzer;                  // Synthetic stocks
+   vector<string>    stockNames;                         // Its file names
+   vector<int>       topIndices;                         // Ranked analyzers
+   double            timerSeconds[NUMMODES];             // Empty scopes
+   double            analysisSeconds[NUMMODES] = { 0.0, 0.0 };
+   const char*       modeNames[NUMMODES] = { "disabled", "enabled" };
+
+   // Time empty timed scopes, disabled then enabled
+   for (int mode = 0; mode < NUMMODES; ++mode)
+   {
+      Metrics::setEnabled(1 == mode);
+
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int timerIndex = 0; 
+           timerIndex < PortfolioBenchmark::METRICSNUMTIMERS; 
+           ++timerIndex)
+      {
+         METRICS_TIMER(PHASESMA);
+      }
+
+      timerSeconds[mode] = elapsedSeconds(start);
+   }
+
+   // Time analyses and rankings of a synthetic portfolio
+   this->generatePortfolio(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      stockNames,
+      portfolioAnalyzer);
+
+   for (int rep = 0; rep < PortfolioBenchmark::DEFAULTNUMREPS; ++rep)
+   {
+      for (int mode = 0; mode < NUMMODES; ++mode)
+      {
+         Metrics::setEnabled(1 == mode);
+
+         BenchmarkClock::time_point start = BenchmarkClock::now();
+
+         portfolioAnalyzer.analyzePortfolio();
+         portfolioAnalyzer.getTopStocksByMACDSlope(
+            PortfolioBenchmark::DEFAULTNUMSYMBOLS, topIndices);
+
+         analysisSeconds[mode] += elapsedSeconds(start);
+      }
+   }
+
+   cout << "---Metrics: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " bars---" << endl << endl;
+   cout << setw(10) << "metrics"
+        << setw(14) << "ns/timer"
+        << setw(14) << "analysis ms"
+        << setw(12) << "overhead" << endl;
+
+   for (int mode = 0; mode < NUMMODES; ++mode)
+   {
+      cout << setw(10) << modeNames[mode]
+           << setw(14) << fixed << setprecision(2)
+           << timerSeconds[mode] * 1.0e9 / PortfolioBenchmark::METRICSNUMTIMERS
+           << setw(14) << setprecision(3)
+           << analysisSeconds[mode] * 1000.0 / 
+              PortfolioBenchmark::DEFAULTNUMREPS
+           << setw(11) << setprecision(2)
+           << (analysisSeconds[mode] / analysisSeconds[0] - 1.0) * 100.0 
+           << "%" << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   cout << endl;
+
+   // Restore whether Metrics was enabled, and reset it
+   Metrics::setEnabled(WASENABLED);
+   Metrics::reset();
+}
+
+//******************************************************************************
+// Function : benchmarkPack
+// Process  : Write a stock data file per symbol, newest row first, with
+//                whole cent prices on weekdays
+//             Time starting an analysis from the stock data files: parse,
+//                analyze, and rank, with bounded history as -rank does
+//             Time building a UniversePack of the stock data files
+//             Time starting an analysis from the pack: map, load, analyze,
+//                and rank
+//             Check the two rankings, remove the files, output the times
+// Notes    : Throws an exception if the rankings differ
+//             Both start from files just written, in the page cache, a
+//                cold start adds a disk seek per stock data file, and one
+//                sequential read of the pack
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Writes with writeStockDataFile
+//******************************************************************************
+void PortfolioBenchmark::benchmarkPack()
+{
+   static const char* DIRECTORYNAME  = "PackBenchmark";      // Of the files
+   static const char* PACKFILENAME   = "PackBenchmark.pack"; // Of the pack
+   static const int   NUMTOPSTOCKS   = 100;                  // Compared
+
+   vector<string>    stockDataFileNames(PortfolioBenchmark::PACKNUMSYMBOLS);
+   vector<char*>     fileNamePointers;  // Handed to the portfolio
+   vector<int>       fileTopIndices;    // Ranked from the stock data files
+   vector<int>       packTopIndices;    // Ranked from the pack
+   vector<double>    fileTopSlopes;     // Of fileTopIndices
+   UniversePack      universePack;      // Mapped
+   long long         fileBytes = 0;     // Of every stock data file
+
+   // Write a stock data file per symbol, newest row first
+   Platform::makeDirectory(DIRECTORYNAME);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::PACKNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      ostringstream name; // Of the file
+
+      name << DIRECTORYNAME << "/StockDataSYN" << setw(6) << setfill('0') 
+           << symbolIndex << ".csv";
+      stockDataFileNames[symbolIndex] = name.str();
+      fileBytes += writeStockDataFile(
+         stockDataFileNames[symbolIndex], 
+         symbolIndex + 1, 
+         PortfolioBenchmark::PACKNUMBARS);
+      fileNamePointers.push_back(&stockDataFileNames[symbolIndex][0]);
+   }
+
+   // Time starting an analysis from the stock data files
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   {
+      PortfolioAnalyzer portfolioAnalyzer; // From the stock data files
+
+      portfolioAnalyzer.setVerbose(false);
+      portfolioAnalyzer.setHistoryBounded(true);
+      portfolioAnalyzer.setStockDataFiles(fileNamePointers);
+      portfolioAnalyzer.analyzePortfolio();
+      portfolioAnalyzer.getTopStocksByMACDSlope(NUMTOPSTOCKS, fileTopIndices);
+
+      for (size_t rank = 0; rank < fileTopIndices.size(); ++rank)
+      {
+         fileTopSlopes.push_back(
+            portfolioAnalyzer.getRankingSlopeAtIndex(fileTopIndices[rank]));
+      }
+   }
+
+   double fileSeconds = elapsedSeconds(start); // Startup from the files
+
+   // Time building a UniversePack of the stock data files
+   start = BenchmarkClock::now();
+   UniversePack::buildPack(PACKFILENAME, stockDataFileNames);
+   double buildSeconds = elapsedSeconds(start); // Of the pack
+
+   // Time starting an analysis from the pack
+   start = BenchmarkClock::now();
+
+   {
+      PortfolioAnalyzer portfolioAnalyzer; // From the pack
+
+      portfolioAnalyzer.setVerbose(false);
+      portfolioAnalyzer.setHistoryBounded(true);
+      universePack.open(PACKFILENAME);
+      portfolioAnalyzer.addStocksFromPack(universePack);
+
+      double loadSeconds = elapsedSeconds(start); // Map and load
+
+      portfolioAnalyzer.analyzePortfolio();
+      portfolioAnalyzer.getTopStocksByMACDSlope(NUMTOPSTOCKS, packTopIndices);
+
+      double packSeconds = elapsedSeconds(start); // Startup from the pack
+
+      // Check the two rankings
+      for (size_t rank = 0; rank < packTopIndices.size(); ++rank)
+      {
+         if (rank >= fileTopIndices.size() ||
+             packTopIndices[rank] != fileTopIndices[rank] ||
+             portfolioAnalyzer.getRankingSlopeAtIndex(packTopIndices[rank]) !=
+                fileTopSlopes[rank])
+         {
+            throw exception("Pack ranking differs from the stock data files");
+         }
+      }
+
+      // Output the times
+      cout << "---Universe pack: " << PortfolioBenchmark::PACKNUMSYMBOLS
+           << " stock data files x " << PortfolioBenchmark::PACKNUMBARS
+           << " bars---" << endl << endl << fixed << setprecision(2)
+           << "Stock data files: " << fileBytes / BYTESPERMEGABYTE 
+           << " MB, startup " << fileSeconds << " s" << endl
+           << "Pack:             " 
+           << universePack.getNumBytes() / BYTESPERMEGABYTE 
+           << " MB, built in " << buildSeconds << " s" << endl
+           << "Pack startup:     " << packSeconds << " s, map and load " 
+           << loadSeconds << " s, analysis " << packSeconds - loadSeconds 
+           << " s" << endl
+           << "Startup speedup:  " << fileSeconds / packSeconds << "x" 
+           << endl
+           << "Load speedup:     " 
+           << (fileSeconds - (packSeconds - loadSeconds)) / loadSeconds 
+           << "x, stock data files less the analysis" << endl;
+      cout.unsetf(ios::floatfield);
+      cout << setprecision(6) << endl;
+   }
+
+   // Remove the files
+   universePack.close();
+   remove(PACKFILENAME);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::PACKNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      remove(stockDataFileNames[symbolIndex].c_str());
+   }
+
+   Platform::removeDirectory(DIRECTORYNAME);
+}
+
+//******************************************************************************
+// Function : benchmarkPricePolicies
+// Process  : Generate the synthetic universe
+//             Run the kernels with every policy
+//             Output memory per symbol, kernel time, speedup, and the largest
+//                error against DoublePricePolicy for each policy
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkPricePolicies()
+{
+   static const int NUMPOLICIES = 3; // Policies in PricePolicy.h
+
+   vector< vector<double> > universe;             // Prices of every symbol
+   vector<double>           currentMACDs[NUMPOLICIES]; // Per policy
+   vector<double>           slopeMACDs[NUMPOLICIES];   // Per policy
+   vector<double>           emasSlow[NUMPOLICIES];     // Per policy
+   double                   kernelSeconds[NUMPOLICIES];
+   int                      bytesPerSymbol[NUMPOLICIES];
+   const char*              policyNames[NUMPOLICIES] =
+   {
+      DoublePricePolicy::getName(),
+      FloatPricePolicy::getName(),
+      FixedCentsPricePolicy::getName()
+   };
+
+   this->generateUniverse(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      universe);
+
+   // Run the kernels with every policy, double first as the baseline
+   this->benchmarkPricePolicy<DoublePricePolicy>(universe,
+      currentMACDs[0], slopeMACDs[0], emasSlow[0],
+      kernelSeconds[0], bytesPerSymbol[0]);
+   this->benchmarkPricePolicy<FloatPricePolicy>(universe,
+      currentMACDs[1], slopeMACDs[1], emasSlow[1],
+      kernelSeconds[1], bytesPerSymbol[1]);
+   this->benchmarkPricePolicy<FixedCentsPricePolicy>(universe,
+      currentMACDs[2], slopeMACDs[2], emasSlow[2],
+      kernelSeconds[2], bytesPerSymbol[2]);
+
+   cout << "---Price policies: " << PortfolioBenchmark::DEFAULTNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::DEFAULTNUMBARS
+        << " bars---" << endl << endl;
+   cout << setw(14) << "policy"
+        << setw(14) << "bytes/symbol"
+        << setw(12) << "kernel ms"
+        << setw(10) << "speedup"
+        << setw(14) << "max |dEMA|"
+        << setw(14) << "max |dMACD|"
+        << setw(14) << "max |dSlope|" << endl;
+
+   for (int policyIndex = 0; policyIndex < NUMPOLICIES; ++policyIndex)
+   {
+      cout << setw(14) << policyNames[policyIndex]
+           << setw(14) << bytesPerSymbol[policyIndex]
+           << setw(12) << fixed << setprecision(3)
+           << kernelSeconds[policyIndex] * 1000.0
+           << setw(10) << setprecision(2)
+           << kernelSeconds[0] / kernelSeconds[policyIndex]
+           << setw(14) << scientific << setprecision(2)
+           << maxAbsDifference(emasSlow[policyIndex], emasSlow[0])
+           << setw(14)
+           << maxAbsDifference(currentMACDs[policyIndex], currentMACDs[0])
+           << setw(14)
+           << maxAbsDifference(slopeMACDs[policyIndex], slopeMACDs[0])
+           << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   cout << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkPricePolicy
+// Process  : Load every symbol into a BasicStock of the policy
+//             Time DEFAULTNUMREPS runs of the SMA, EMA, and MACD kernels over
+//                every symbol
+//             Run the kernels once more, untimed, to collect the slow EMAs
+//             Bytes per symbol are the stored prices plus both EMA lists
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+void PortfolioBenchmark::benchmarkPricePolicy(
+   const vector< vector<double> >& universe,
+   vector<double>& currentMACDs,
+   vector<double>& slopeMACDs,
+   vector<double>& emasSlow,
+   double& kernelSeconds,
+   int& bytesPerSymbol)
+{
+   typedef MACDKernel<PricePolicy>           Kernel;
+   typedef typename PricePolicy::StorageType StorageType;
+   typedef typename PricePolicy::AccumType   AccumType;
+
+   const int NUMSYMBOLS  = universe.size();        // Symbols in the universe
+   const int NUMBARS     = universe[0].size();     // Bars per symbol
+   const int PERIODSFAST = StockAnalyzer::DEFAULTFASTPERIODS;
+   const int PERIODSSLOW = StockAnalyzer::DEFAULTSLOWPERIODS;
+   const int NUMEMASFAST = NUMBARS - PERIODSFAST + 1; // EMAs per symbol
+   const int NUMEMASSLOW = NUMBARS - PERIODSSLOW + 1; // EMAs per symbol
+
+   vector< BasicStock<PricePolicy> > stocks(NUMSYMBOLS);  // Stored prices
+   vector<StorageType>               listEMAFast(NUMEMASFAST);
+   vector<StorageType>               listEMASlow(NUMEMASSLOW);
+   const AccumType multEMAFast = Kernel::calculateMultEMA(PERIODSFAST);
+   const AccumType multEMASlow = Kernel::calculateMultEMA(PERIODSSLOW);
+
+   // Load every symbol into a BasicStock of the policy
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+      {
+         stocks[symbolIndex].addPrice(universe[symbolIndex][barIndex]);
+      }
+   }
+
+   currentMACDs.resize(NUMSYMBOLS);
+   slopeMACDs.resize(NUMSYMBOLS);
+
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int rep = 0; rep < PortfolioBenchmark::DEFAULTNUMREPS; ++rep)
+   {
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         const StorageType* prices = stocks[symbolIndex].getPriceData();
+
+         Kernel::calculateEMA(prices, NUMBARS, PERIODSFAST,
+            Kernel::calculateFirstPeriodSMA(prices, PERIODSFAST),
+            multEMAFast, &listEMAFast[0]);
+         Kernel::calculateEMA(prices, NUMBARS, PERIODSSLOW,
+            Kernel::calculateFirstPeriodSMA(prices, PERIODSSLOW),
+            multEMASlow, &listEMASlow[0]);
+
+         double currentMACD   =
+            PricePolicy::toAccum(listEMAFast[NUMEMASFAST - 1]) -
+            PricePolicy::toAccum(listEMASlow[NUMEMASSLOW - 1]);
+         double yesterdayMACD =
+            PricePolicy::toAccum(listEMAFast[NUMEMASFAST - 2]) -
+            PricePolicy::toAccum(listEMASlow[NUMEMASSLOW - 2]);
+
+         currentMACDs[symbolIndex] = currentMACD;
+         slopeMACDs[symbolIndex]   = currentMACD - yesterdayMACD;
+      }
+   }
+
+   kernelSeconds = elapsedSeconds(start) / PortfolioBenchmark::DEFAULTNUMREPS;
+
+   // Run the kernels once more, untimed, to collect the slow EMAs
+   emasSlow.resize(NUMSYMBOLS * NUMEMASSLOW);
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      const StorageType* prices = stocks[symbolIndex].getPriceData();
+
+      Kernel::calculateEMA(prices, NUMBARS, PERIODSSLOW,
+         Kernel::calculateFirstPeriodSMA(prices, PERIODSSLOW),
+         multEMASlow, &listEMASlow[0]);
+
+      for (int emaIndex = 0; emaIndex < NUMEMASSLOW; ++emaIndex)
+      {
+         emasSlow[symbolIndex * NUMEMASSLOW + emaIndex] =
+            PricePolicy::toAccum(listEMASlow[emaIndex]);
+      }
+   }
+
+   bytesPerSymbol = stocks[0].getPriceStorageBytes() +
+                    (NUMEMASFAST + NUMEMASSLOW) * sizeof(StorageType);
+}
+
+//******************************************************************************
+// Function : benchmarkRanges
+// Process  : Generate a synthetic stock of DEFAULTNUMBARS bars, its highs
+//                and lows 1% around the close, and copy its columns to
+//                arrays for the linear scans
+//             Time building the range indexes of a copy of the stock for
+//                each repetition, by a first query of each column, and
+//                report the time and bytes per bar
+//             For each range length
+//                Pick RANGENUMQUERIES ranges
+//                Time a sum of closes, maximum of highs, minimum of lows,
+//                   and mean of volumes of each by linear scans, and by
+//                   range queries
+//                Check each of the range queries against the scans
+//                Output the time per range of each and the speedup
+//             Time adding the bars one at a time to an empty stock, with a
+//                range query after each, so each query extends the indexes
+// Notes    : Throws an exception if a range query differs from its scan,
+//             sums by more than a relative TOLERANCE
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkRanges()
+{
+   static const int    LENGTHS[]  = { 5, 20, 250, 2520 }; // Bars per range
+   static const int    NUMLENGTHS = sizeof(LENGTHS) / sizeof(LENGTHS[0]);
+   static const double TOLERANCE  = 1.0e-12; // Relative, of the sums
+   static const int    RECENTBARS = 20;      // Range of each query after
+                                             // adding a bar
+
+   const int NUMBARS = PortfolioBenchmark::DEFAULTNUMBARS;
+   const int NUMREPS = PortfolioBenchmark::DEFAULTNUMREPS;
+
+   SyntheticPriceGenerator generator(1); // Prices, volumes, and ranges
+   Stock                   stock;        // Of the bars
+   vector<Stock>           builds;       // Copies of stock to index
+   vector<double>          closes;       // Of each bar, for the scans
+   vector<double>          highs;        // Of each bar, for the scans
+   vector<double>          lows;         // Of each bar, for the scans
+   vector<double>          volumes;      // Of each bar, for the scans
+   vector<int>             firsts;       // Of each range of a length
+   double                  seconds[2];   // Scans, range queries
+   double                  totals[2];    // Of every sum and mean
+   int                     barBytes = 0; // Of the bars, before indexing
+   int                     last     = 0; // Of a range
+
+   // Generate the synthetic stock
+   generator.generatePrices(NUMBARS, closes);
+   highs.resize(NUMBARS);
+   lows.resize(NUMBARS);
+   volumes.resize(NUMBARS);
+
+   for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+   {
+      highs[barIndex]   = closes[barIndex] * 1.01;
+      lows[barIndex]    = closes[barIndex] * 0.99;
+      volumes[barIndex] = 100000 + generator.nextRandom() % 2000000;
+
+      stock.addPrice(closes[barIndex]);
+      stock.addBar(highs[barIndex], lows[barIndex],
+                   (long long)volumes[barIndex]);
+   }
+
+   // Copy the columns back from the stock, as its price policy stores them
+   for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+   {
+      closes[barIndex] = stock.getPriceAt(barIndex);
+      highs[barIndex]  = stock.getHighAt(barIndex);
+      lows[barIndex]   = stock.getLowAt(barIndex);
+   }
+
+   barBytes = stock.getBarStorageBytes();
+   builds.assign(NUMREPS, stock);
+
+   // Time building the range indexes of each copy
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+   {
+      builds[repIndex].getRangeSum(Stock::COLUMNCLOSE, 0, 0);
+      builds[repIndex].getRangeMaximum(Stock::COLUMNHIGH, 0, 0);
+      builds[repIndex].getRangeMinimum(Stock::COLUMNLOW, 0, 0);
+      builds[repIndex].getRangeMean(Stock::COLUMNVOLUME, 0, 0);
+   }
+
+   seconds[0] = elapsedSeconds(start);
+
+   cout << "---Range queries: " << NUMBARS << " bars, "
+        << PortfolioBenchmark::RANGENUMQUERIES << " ranges per length---"
+        << endl << endl;
+   cout << "Build: " << fixed << setprecision(1)
+        << seconds[0] * 1.0e9 / (double(NUMREPS) * NUMBARS)
+        << " ns per bar, "
+        << double(builds[0].getBarStorageBytes() - barBytes) / NUMBARS
+        << " bytes per bar" << endl << endl;
+   cout.unsetf(ios::floatfield);
+
+   cout << setw(8) << "bars" << setw(14) << "scan ns" << setw(14)
+        << "query ns" << setw(12) << "speedup" << endl;
+
+   for (int lengthIndex = 0; lengthIndex < NUMLENGTHS; ++lengthIndex)
+   {
+      const int LENGTH = LENGTHS[lengthIndex];
+
+      // Pick the ranges
+      firsts.resize(PortfolioBenchmark::RANGENUMQUERIES);
+
+      for (size_t queryIndex = 0; queryIndex < firsts.size(); ++queryIndex)
+      {
+         firsts[queryIndex] = generator.nextRandom() % (NUMBARS - LENGTH + 1);
+      }
+
+      // Time the linear scans of each range
+      totals[0] = 0.0;
+      start     = BenchmarkClock::now();
+
+      for (size_t queryIndex = 0; queryIndex < firsts.size(); ++queryIndex)
+      {
+         const int FIRST = firsts[queryIndex];
+
+         double sum     = 0.0;           // Of the closes
+         double maximum = highs[FIRST];  // Of the highs
+         double minimum = lows[FIRST];   // Of the lows
+         double volume  = 0.0;           // Sum of the volumes
+
+         for (int barIndex = FIRST; barIndex < FIRST + LENGTH; ++barIndex)
+         {
+            sum     += closes[barIndex];
+            maximum  = max(maximum, highs[barIndex]);
+            minimum  = min(minimum, lows[barIndex]);
+            volume  += volumes[barIndex];
+         }
+
+         totals[0] += sum + maximum - minimum + volume / LENGTH;
+      }
+
+      seconds[0] = elapsedSeconds(start);
+
+      // Time the range queries of each range
+      totals[1] = 0.0;
+      start     = BenchmarkClock::now();
+
+      for (size_t queryIndex = 0; queryIndex < firsts.size(); ++queryIndex)
+      {
+         const int FIRST = firsts[queryIndex];
+
+         last       = FIRST + LENGTH - 1;
+         totals[1] += stock.getRangeSum(Stock::COLUMNCLOSE, FIRST, last) +
+                      stock.getRangeMaximum(Stock::COLUMNHIGH, FIRST, last) -
+                      stock.getRangeMinimum(Stock::COLUMNLOW, FIRST, last) +
+                      stock.getRangeMean(Stock::COLUMNVOLUME, FIRST, last);
+      }
+
+      seconds[1] = elapsedSeconds(start);
+
+      // Check each range query against the scans
+      for (size_t queryIndex = 0; queryIndex < firsts.size(); ++queryIndex)
+      {
+         const int FIRST = firsts[queryIndex];
+
+         double sum     = 0.0;           // Of the closes
+         double maximum = highs[FIRST];  // Of the highs
+         double minimum = lows[FIRST];   // Of the lows
+
+         last = FIRST + LENGTH - 1;
+
+         for (int barIndex = FIRST; barIndex <= last; ++barIndex)
+         {
+            sum     += closes[barIndex];
+            maximum  = max(maximum, highs[barIndex]);
+            minimum  = min(minimum, lows[barIndex]);
+         }
+
+         if (stock.getRangeMaximum(Stock::COLUMNHIGH, FIRST, last) !=
+                maximum ||
+             stock.getRangeMinimum(Stock::COLUMNLOW, FIRST, last) !=
+                minimum ||
+             fabs(stock.getRangeSum(Stock::COLUMNCLOSE, FIRST, last) - sum) >
+                TOLERANCE * fabs(sum))
+         {
+            throw exception("Range query differs from a linear scan");
+         }
+      }
+
+      if (fabs(totals[1] - totals[0]) > TOLERANCE * fabs(totals[0]) * LENGTH)
+      {
+         throw exception("Range queries differ from linear scans");
+      }
+
+      cout << setw(8) << LENGTH << fixed << setprecision(1)
+           << setw(14) << seconds[0] * 1.0e9 / firsts.size()
+           << setw(14) << seconds[1] * 1.0e9 / firsts.size()
+           << setprecision(2)
+           << setw(12) << seconds[0] / seconds[1] << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   // Time adding the bars one at a time, each query extending the indexes
+   Stock growing; // Of the bars added so far
+
+   totals[1] = 0.0;
+   start     = BenchmarkClock::now();
+
+   for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+   {
+      growing.addPrice(closes[barIndex]);
+      growing.addBar(highs[barIndex], lows[barIndex],
+                     (long long)volumes[barIndex]);
+
+      totals[1] += growing.getRangeMaximum(
+         Stock::COLUMNHIGH, max(0, barIndex - RECENTBARS + 1), barIndex);
+   }
+
+   seconds[1] = elapsedSeconds(start);
+
+   if (growing.getRangeMaximum(Stock::COLUMNHIGH, 0, NUMBARS - 1) !=
+       stock.getRangeMaximum(Stock::COLUMNHIGH, 0, NUMBARS - 1))
+   {
+      throw exception("Extended range index differs");
+   }
+
+   cout << endl << "Add a bar, then the maximum high of the last "
+        << RECENTBARS << ": " << fixed << setprecision(1)
+        << seconds[1] * 1.0e9 / NUMBARS << " ns per bar" << endl;
+   cout.unsetf(ios::floatfield);
+   cout << endl << "Each range is a sum of closes, maximum of highs, "
+        << "minimum of lows, and mean of volumes" << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkRanking
+// Process  : For a RankingPublisher, then the LockedRanking baseline
+//                Warm up RANKINGNUMSYMBOLS bounded synthetic stocks with
+//                   RANKINGNUMBARS prices each, and publish them
+//                Start RANKINGNUMREADERS reader threads, reading the
+//                   ranking until the writers are done
+//                Run RANKINGNUMWRITERS writer threads, updating their own
+//                   symbols RANKINGNUMUPDATES times in all and publishing
+//                   every RANKINGBATCHUPDATES updates
+//                Output the reads per second, the read latency, and the
+//                   updates and publishes per second
+//             Output the snapshots the publisher freed
+// Notes    : Throws an exception if a reader saw an inconsistent ranking
+//             or the publisher kept more snapshots than it needs
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkRanking()
+{
+   const int       NUMSYMBOLS = PortfolioBenchmark::RANKINGNUMSYMBOLS;
+   const int       NUMREADERS = PortfolioBenchmark::RANKINGNUMREADERS;
+   const int       NUMWRITERS = PortfolioBenchmark::RANKINGNUMWRITERS;
+   const long long NUMUPDATES = PortfolioBenchmark::RANKINGNUMUPDATES;
+
+   long long numPublished = 0; // By the RankingPublisher
+   long long numReclaimed = 0; // Freed by the RankingPublisher
+
+   cout << "---Ranking snapshots: " << NUMSYMBOLS << " symbols, " 
+        << NUMREADERS << " readers, " << NUMWRITERS << " writers---" 
+        << endl << endl;
+   cout << setw(10) << "ranking" << setw(12) << "reads/s" 
+        << setw(10) << "p50 ns" << setw(10) << "p99 ns" 
+        << setw(12) << "max ns" << setw(12) << "updates/s" 
+        << setw(12) << "publish/s" << endl;
+
+   for (int runIndex = 0; runIndex < 2; ++runIndex)
+   {
+      PortfolioAnalyzer  portfolioAnalyzer; // Analyzers being updated
+      vector<string>     stockNames;        // Of the synthetic stocks
+      RankingPublisher   rankingPublisher(
+         NUMSYMBOLS, PortfolioBenchmark::RANKINGNUMTOPSTOCKS, NUMREADERS);
+      LockedRanking      lockedRanking;     // Baseline
+      RankingPublisher*  publisher = (0 == runIndex) ? 
+         &rankingPublisher : NULL;          // NULL for the baseline
+      vector<thread>     readers;           // Reading threads
+      vector<thread>     writers;           // Updating threads
+      vector< vector<double> > latencyNanos(NUMREADERS); // Of each reader
+      vector<long long>  numReads(NUMREADERS);           // Of each reader
+      vector<double>     allLatencyNanos;   // Of every reader, sorted
+      atomic<bool>       writersDone(false);
+      atomic<long long>  numFailures(0);    // Inconsistent reads
+      long long          totalReads = 0;    // Of every reader
+      double             seconds    = 0.0;  // Of the writers
+
+      // Warm up the bounded synthetic stocks, and publish them
+      portfolioAnalyzer.setHistoryBounded(true);
+      this->generatePortfolio(NUMSYMBOLS, 0, stockNames, portfolioAnalyzer);
+
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         SyntheticPriceGenerator generator(symbolIndex + 1); // Per symbol
+
+         for (int barIndex = 0; 
+              barIndex < PortfolioBenchmark::RANKINGNUMBARS; 
+              ++barIndex)
+         {
+            portfolioAnalyzer.updateStockWithPrice(
+               symbolIndex, generator.nextPrice());
+         }
+      }
+
+      rankingPublisher.publishPortfolio(portfolioAnalyzer);
+      lockedRanking.snapshot = *rankingPublisher.beginRead(0);
+      rankingPublisher.endRead(0);
+
+      // Start the reader threads
+      for (int readerIndex = 0; readerIndex < NUMREADERS; ++readerIndex)
+      {
+         readers.push_back(thread(
+            readRankings, publisher, &lockedRanking, readerIndex, 
+            &writersDone, &latencyNanos[readerIndex], 
+            &numReads[readerIndex], &numFailures));
+      }
+
+      // Run the writer threads
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int writerIndex = 0; writerIndex < NUMWRITERS; ++writerIndex)
+      {
+         writers.push_back(thread(
+            writeRankings, publisher, &lockedRanking, &portfolioAnalyzer, 
+            writerIndex, NUMWRITERS, NUMUPDATES / NUMWRITERS));
+      }
+
+      for (int writerIndex = 0; writerIndex < NUMWRITERS; ++writerIndex)
+      {
+         writers[writerIndex].join();
+      }
+
+      seconds = elapsedSeconds(start);
+      writersDone.store(true);
+
+      for (int readerIndex = 0; readerIndex < NUMREADERS; ++readerIndex)
+      {
+         readers[readerIndex].join();
+         totalReads += numReads[readerIndex];
+         allLatencyNanos.insert(allLatencyNanos.end(), 
+                                latencyNanos[readerIndex].begin(), 
+                                latencyNanos[readerIndex].end());
+      }
+
+      if (0 != numFailures.load())
+      {
+         throw exception("A reader saw an inconsistent ranking");
+      }
+
+      if (allLatencyNanos.empty())
+      {
+         allLatencyNanos.push_back(0.0);
+      }
+
+      sort(allLatencyNanos.begin(), allLatencyNanos.end());
+
+      const long long NUMBATCHES = NUMWRITERS * 
+         ((NUMUPDATES / NUMWRITERS + PortfolioBenchmark::RANKINGBATCHUPDATES -
+           1) / PortfolioBenchmark::RANKINGBATCHUPDATES);
+
+      cout << setw(10) << ((0 == runIndex) ? "rcu" : "mutex") 
+           << fixed << setprecision(0)
+           << setw(12) << totalReads / seconds
+           << setw(10) << allLatencyNanos[allLatencyNanos.size() / 2]
+           << setw(10) << allLatencyNanos[allLatencyNanos.size() * 99 / 100]
+           << setw(12) << allLatencyNanos.back()
+           << setw(12) << (NUMUPDATES / NUMWRITERS) * NUMWRITERS / seconds
+           << setw(12) << NUMBATCHES / seconds << endl;
+      cout.unsetf(ios::floatfield);
+
+      if (0 == runIndex)
+      {
+         numPublished = rankingPublisher.getNumPublished();
+         numReclaimed = rankingPublisher.getNumReclaimed();
+
+         // Every snapshot but the latest is freed once the readers are done
+         rankingPublisher.publishPortfolio(portfolioAnalyzer);
+
+         if (rankingPublisher.getNumReclaimed() != 
+                rankingPublisher.getNumPublished())
+         {
+            throw exception("Ranking publisher kept a retired snapshot");
+         }
+      }
+   }
+
+   cout << endl << "Every read saw a whole ranking, in order, never older; "
+        << numReclaimed << " of " << numPublished 
+        << " snapshots freed while reading" << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkRegressionSlope
+// Process  : Generate SLOPENUMBARS synthetic prices once
+//             Stream them through a bounded analyzer without a regression
+//                slope, keeping the newest MACDs for the reference slopes
+//             For each window, 0 being none
+//                Time streaming the prices through a bounded analyzer 
+//                   with the regression slope of the window
+//                Check its slope against a direct least squares slope of 
+//                   the newest MACDs
+//                Check analyzeStock over the first DEFAULTNUMBARS prices
+//                   matches streaming them
+//                Output the time per bar and the differences
+// Notes    : Throws an exception if a slope is off by more than TOLERANCE
+//             The time per bar should not grow with the window
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkRegressionSlope()
+{
+   static const int    WINDOWS[]  = { 0, 2, 10, 100, 1000, 10000, 100000 };
+   static const int    NUMWINDOWS = sizeof(WINDOWS) / sizeof(WINDOWS[0]);
+   static const double TOLERANCE  = 1.0e-9; // Largest slope difference
+
+   vector<double>          prices(PortfolioBenchmark::SLOPENUMBARS);
+   RingSeries<double>      macds(WINDOWS[NUMWINDOWS - 1]); // Newest MACDs
+   SyntheticPriceGenerator generator(1);                  // Of the prices
+   StockAnalyzer           reference;                     // No slope
+   Stock                   stock;                         // First prices
+
+   // Generate the prices once
+   for (int barIndex = 0; barIndex < PortfolioBenchmark::SLOPENUMBARS; 
+        ++barIndex)
+   {
+      prices[barIndex] = generator.nextPrice();
+
+      if (barIndex < PortfolioBenchmark::DEFAULTNUMBARS)
+      {
+         stock.addPrice(prices[barIndex]);
+      }
+   }
+
+   // Keep the newest MACDs for the reference slopes
+   reference.setVerbose(false);
+   reference.setHistoryBounded(true);
+
+   for (int barIndex = 0; barIndex < PortfolioBenchmark::SLOPENUMBARS; 
+        ++barIndex)
+   {
+      reference.updateWithPrice(prices[barIndex]);
+
+      if (reference.hasMACD())
+      {
+         macds.append(reference.getCurrentMACD());
+      }
+   }
+
+   cout << "---Regression slope of MACD: " 
+        << PortfolioBenchmark::SLOPENUMBARS << " bars---" << endl << endl;
+   cout << setw(10) << "window" << setw(12) << "ns/bar"
+        << setw(22) << "|dSlope| vs direct"
+        << setw(22) << "|dSlope| analyzed" << endl;
+
+   for (int windowIndex = 0; windowIndex < NUMWINDOWS; ++windowIndex)
+   {
+      const int     WINDOW = WINDOWS[windowIndex];
+      StockAnalyzer streamed;  // Bounded, with the regression slope
+      StockAnalyzer analyzed;  // Unbounded, over the first prices
+      StockAnalyzer firstBars; // Bounded, over the first prices
+
+      // Time streaming the prices with the regression slope
+      streamed.setVerbose(false);
+      streamed.setPeriodsSlope(WINDOW);
+      streamed.setHistoryBounded(true);
+
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::SLOPENUMBARS; 
+           ++barIndex)
+      {
+         streamed.updateWithPrice(prices[barIndex]);
+      }
+
+      double seconds = elapsedSeconds(start); // Time for every bar
+
+      // Check against a direct least squares slope
+      const double DIRECTDIFFERENCE = fabs(
+         streamed.getRegressionSlopeMACD() - referenceSlope(macds, WINDOW));
+
+      // Check analyzeStock matches streaming the same prices
+      analyzed.setVerbose(false);
+      analyzed.setPeriodsSlope(WINDOW);
+      analyzed.setStock(stock);
+      analyzed.analyzeStock();
+
+      firstBars.setVerbose(false);
+      firstBars.setPeriodsSlope(WINDOW);
+      firstBars.setHistoryBounded(true);
+
+      for (int barIndex = 0; barIndex < PortfolioBenchmark::DEFAULTNUMBARS; 
+           ++barIndex)
+      {
+         firstBars.updateWithPrice(prices[barIndex]);
+      }
+
+      const double ANALYZEDDIFFERENCE = fabs(
+         analyzed.getRegressionSlopeMACD() - 
+         firstBars.getRegressionSlopeMACD());
+
+      cout << setw(10) << WINDOW 
+           << setw(12) << fixed << setprecision(1) 
+           << seconds * 1.0e9 / PortfolioBenchmark::SLOPENUMBARS
+           << setw(22) << scientific << setprecision(2) << DIRECTDIFFERENCE
+           << setw(22) << ANALYZEDDIFFERENCE << endl;
+      cout.unsetf(ios::floatfield);
+
+      if (DIRECTDIFFERENCE > TOLERANCE || ANALYZEDDIFFERENCE > TOLERANCE)
+      {
+         throw exception("Regression slope of MACD is wrong");
+      }
+   }
+
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkRibbon
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks
+//             For each ribbon, of periods 5, 10, 15, ...
+//                Time a calculateFirstPeriodSMA and calculateEMA per period
+//                   of each stock, keeping the EMAs
+//                Time the EMARibbon of each stock, with and without history
+//                Check every EMA of the ribbon is calculateEMA's
+//                Output the time per bar of each, and the ribbon's speedups
+//                   with and without history
+// Notes    : Throws an exception if an EMA differs
+//             calculateEMA always fills the EMAs, like a ribbon with history
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkRibbon()
+{
+   typedef MACDKernel<DoublePricePolicy> Kernel;
+
+   static const int RIBBONS[]   = { 4, 8, 16 }; // Periods of each ribbon
+   static const int NUMRIBBONS  = sizeof(RIBBONS) / sizeof(RIBBONS[0]);
+   static const int PERIODSTEP  = 5;            // Between periods
+   static const int NUMREPS     = 5;            // Of each timed loop
+
+   const int NUMSYMBOLS = PortfolioBenchmark::DEFAULTNUMSYMBOLS;
+   const int NUMBARS    = PortfolioBenchmark::DEFAULTNUMBARS;
+
+   vector< vector<double> > universe; // Closes of each stock
+
+   // Generate the synthetic stocks
+   this->generateUniverse(NUMSYMBOLS, NUMBARS, universe);
+
+   cout << "---EMA ribbon: " << NUMSYMBOLS << " symbols, " << NUMBARS
+        << " bars---" << endl << endl;
+   cout << setw(8) << "periods" << setw(14) << "separate ns"
+        << setw(14) << "history ns" << setw(14) << "ribbon ns"
+        << setw(12) << "history x" << setw(12) << "ribbon x" << endl;
+
+   for (int ribbonIndex = 0; ribbonIndex < NUMRIBBONS; ++ribbonIndex)
+   {
+      const int      NUMPERIODS = RIBBONS[ribbonIndex];
+      vector<int>    periods(NUMPERIODS);             // Of the ribbon
+      vector<double> emas(NUMPERIODS * NUMBARS);      // By calculateEMA
+      vector<int>    numEMAs(NUMPERIODS);             // Of each period
+      vector<double> history;                         // Of the ribbon
+      EMARibbon      ribbon;                          // Of the periods
+      double         seconds[3];                      // Of each way
+
+      for (int lane = 0; lane < NUMPERIODS; ++lane)
+      {
+         periods[lane] = (lane + 1) * PERIODSTEP;
+      }
+
+      ribbon.setPeriods(periods);
+      history.resize(NUMBARS * ribbon.getHistoryStride());
+
+      // Time a calculateEMA per period of each stock
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+      {
+         for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+         {
+            const double* prices = universe[symbolIndex].data();
+
+            for (int lane = 0; lane < NUMPERIODS; ++lane)
+            {
+               const int PERIOD = periods[lane];
+
+               numEMAs[lane] = Kernel::calculateEMA(
+                  prices, NUMBARS, PERIOD,
+                  Kernel::calculateFirstPeriodSMA(prices, PERIOD),
+                  Kernel::calculateMultEMA(PERIOD), &emas[lane * NUMBARS]);
+            }
+         }
+      }
+
+      seconds[0] = elapsedSeconds(start);
+
+      // Time the EMARibbon of each stock, with and without history
+      for (int wayIndex = 1; wayIndex < 3; ++wayIndex)
+      {
+         double* ribbonHistory = (1 == wayIndex) ? history.data() : NULL;
+
+         start = BenchmarkClock::now();
+
+         for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+         {
+            for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS;
+                 ++symbolIndex)
+            {
+               ribbon.calculate(
+                  universe[symbolIndex].data(), NUMBARS, ribbonHistory);
+            }
+         }
+
+         seconds[wayIndex] = elapsedSeconds(start);
+      }
+
+      // Check every EMA of the ribbon is calculateEMA's
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         const double* prices = universe[symbolIndex].data();
+
+         ribbon.calculate(prices, NUMBARS, history.data());
+
+         for (int lane = 0; lane < NUMPERIODS; ++lane)
+         {
+            const int PERIOD = periods[lane];
+
+            numEMAs[lane] = Kernel::calculateEMA(
+               prices, NUMBARS, PERIOD,
+               Kernel::calculateFirstPeriodSMA(prices, PERIOD),
+               Kernel::calculateMultEMA(PERIOD), &emas[lane * NUMBARS]);
+
+            if (ribbon.getCurrentEMA(lane) !=
+                emas[lane * NUMBARS + numEMAs[lane] - 1])
+            {
+               throw exception("EMA ribbon differs from calculateEMA");
+            }
+
+            for (int emaIndex = 0; emaIndex < numEMAs[lane]; ++emaIndex)
+            {
+               if (history[(PERIOD - 1 + emaIndex) *
+                           ribbon.getHistoryStride() + lane] !=
+                   emas[lane * NUMBARS + emaIndex])
+               {
+                  throw exception("EMA ribbon history differs");
+               }
+            }
+         }
+      }
+
+      const double BARS = double(NUMREPS) * NUMSYMBOLS * NUMBARS;
+
+      cout << setw(8) << NUMPERIODS << fixed << setprecision(1)
+           << setw(14) << seconds[0] * 1.0e9 / BARS
+           << setw(14) << seconds[1] * 1.0e9 / BARS
+           << setw(14) << seconds[2] * 1.0e9 / BARS
+           << setprecision(2)
+           << setw(12) << seconds[0] / seconds[1]
+           << setw(12) << seconds[0] / seconds[2] << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   cout << endl << "Periods 5, 10, 15, ..., ns per bar for every period"
+        << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkScreener
+// Process  : Analyze DEFAULTNUMSYMBOLS synthetic stocks and fill their 
+//                columns, with sma200
+//             Tile them to SCREENERNUMSYMBOLS symbols, with a synthetic 
+//                volume, as the stocks have no bars
+//             For each screen
+//                Compile it
+//                Time selecting with the plan and with the interpreter
+//                Check they select the same symbols
+//                Output the symbols screened per second of each and the 
+//                   speedup
+// Notes    : Throws an exception if the selections differ
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkScreener()
+{
+   static const char* SCREENS[] =
+   {
+      "macd > 0 && slope > 0.05 && close > sma200 && volume > 1e6",
+      "macd > 0",
+      "emafast > emaslow && close >= sma200",
+      "(slope > 0 || close > sma200) && !(volume < 1e6)"
+   };
+   static const int   NUMSCREENS = sizeof(SCREENS) / sizeof(SCREENS[0]);
+   static const int   NUMINTERPRETEDREPS = 2; // The interpreter is slow
+
+   PortfolioAnalyzer          portfolioAnalyzer; // Synthetic stocks
+   vector<string>             stockNames;        // Of the stocks
+   ScreenerColumns            stockColumns;      // Of the stocks
+   ScreenerColumns            columns;           // Tiled to every symbol
+   vector<double>             values(PortfolioBenchmark::SCREENERNUMSYMBOLS);
+   SyntheticPriceGenerator    generator(1);      // Of the volumes
+   vector<unsigned long long> compiled;          // Selected by the plan
+   vector<unsigned long long> interpreted;       // By the interpreter
+
+   // Analyze the synthetic stocks and fill their columns
+   this->generatePortfolio(
+      PortfolioBenchmark::DEFAULTNUMSYMBOLS,
+      PortfolioBenchmark::DEFAULTNUMBARS,
+      stockNames,
+      portfolioAnalyzer);
+   portfolioAnalyzer.analyzePortfolio();
+   stockColumns.setFromPortfolio(
+      portfolioAnalyzer, vector<string>(1, "sma200"));
+
+   // Tile them to every symbol, with a synthetic volume
+   columns.reset(PortfolioBenchmark::SCREENERNUMSYMBOLS);
+
+   for (int columnIndex = 0; columnIndex < stockColumns.getNumColumns(); 
+        ++columnIndex)
+   {
+      const double* stockValues = stockColumns.getColumnData(columnIndex);
+
+      for (int symbolIndex = 0; 
+           symbolIndex < PortfolioBenchmark::SCREENERNUMSYMBOLS; 
+           ++symbolIndex)
+      {
+         values[symbolIndex] = 
+            stockValues[symbolIndex % stockColumns.getNumSymbols()];
+      }
+
+      columns.setColumn(stockColumns.getColumnName(columnIndex), values);
+   }
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::SCREENERNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      values[symbolIndex] = 1.0e4 * generator.nextPrice();
+   }
+
+   columns.setColumn("volume", values);
+
+   cout << "---Screener: " << PortfolioBenchmark::SCREENERNUMSYMBOLS 
+        << " symbols---" << endl << endl;
+
+   for (int screenIndex = 0; screenIndex < NUMSCREENS; ++screenIndex)
+   {
+      cout << setw(4) << screenIndex + 1 << ": " << SCREENS[screenIndex] 
+           << endl;
+   }
+
+   cout << endl << setw(6) << "screen" << setw(8) << "plan" 
+        << setw(12) << "selected" << setw(16) << "plan Msym/s" 
+        << setw(16) << "naive Msym/s" << setw(10) << "speedup" << endl;
+
+   for (int screenIndex = 0; screenIndex < NUMSCREENS; ++screenIndex)
+   {
+      Screener screener; // Of the screen
+
+      screener.compile(SCREENS[screenIndex]);
+
+      // Time selecting with the plan and with the interpreter
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int repIndex = 0; repIndex < PortfolioBenchmark::DEFAULTNUMREPS; 
+           ++repIndex)
+      {
+         screener.select(columns, compiled);
+      }
+
+      double compiledSeconds = 
+         elapsedSeconds(start) / PortfolioBenchmark::DEFAULTNUMREPS;
+
+      start = BenchmarkClock::now();
+
+      for (int repIndex = 0; repIndex < NUMINTERPRETEDREPS; ++repIndex)
+      {
+         screener.selectInterpreted(columns, interpreted);
+      }
+
+      double interpretedSeconds = elapsedSeconds(start) / NUMINTERPRETEDREPS;
+
+      // Check they select the same symbols
+      if (compiled != interpreted)
+      {
+         throw exception("Screener plan and interpreter differ");
+      }
+
+      cout << setw(6) << screenIndex + 1 
+           << setw(8) << screener.getNumInstructions()
+           << setw(12) << Screener::countSelected(compiled)
+           << fixed << setprecision(1)
+           << setw(16) << PortfolioBenchmark::SCREENERNUMSYMBOLS / 
+                          compiledSeconds / 1.0e6
+           << setw(16) << PortfolioBenchmark::SCREENERNUMSYMBOLS / 
+                          interpretedSeconds / 1.0e6
+           << setw(10) << interpretedSeconds / compiledSeconds << endl;
+      cout.unsetf(ios::floatfield);
+   }
+
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkSharedRanking
+// Process  : Warm up SHAREDNUMSYMBOLS bounded synthetic stocks with
+//                RANKINGNUMBARS prices each
+//             Publish them to a SharedRankingWriter
+//             Start SHAREDNUMREADERS -shmreader processes of this program,
+//                and give them SHAREDATTACHMILLIS to map the memory
+//             Publish SHAREDNUMPUBLISHES batches of SHAREDBATCHUPDATES
+//                round robin updates, a batch every SHAREDPUBLISHMICROS,
+//                timing each publish
+//             Close the memory, and wait for the readers
+//             Merge and delete their results
+//             Output each reader read's rate and latency, the latency
+//                from a publish to a reader seeing it, and the publish time
+// Notes    : Throws an exception without the program path, if a reader
+//             fails, or if a reader read a torn summary or ranking
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkSharedRanking()
+{
+   const int    NUMSYMBOLS  = PortfolioBenchmark::SHAREDNUMSYMBOLS;
+   const int    NUMREADERS  = PortfolioBenchmark::SHAREDNUMREADERS;
+   const int    BATCH       = PortfolioBenchmark::SHAREDBATCHUPDATES;
+   const string SEGMENTNAME = "stockanalyzer.benchmark";
+
+   PortfolioAnalyzer       portfolioAnalyzer; // Analyzers being updated
+   vector<string>          stockNames;        // Of the synthetic stocks
+   SyntheticPriceGenerator generator(NUMSYMBOLS + 1); // Updates' prices
+   vector<int>             symbolIndices(BATCH);      // Of a batch
+   vector<RankingSummary>  summaries(BATCH);          // Of a batch
+   vector<long long>       processes;         // Reader processes
+   vector<string>          resultNames;       // Result of each reader
+   vector<double>          publishNanos;      // Of each publish
+   vector<double>          summaryNanos;      // Sampled, every reader
+   vector<double>          topNanos;          // Sampled, every reader
+   vector<double>          propagationNanos;  // Every publish seen
+   long long               numSummaryReads = 0; // Every reader
+   long long               numTopReads     = 0; // Every reader
+   long long               numRetries      = 0; // Every reader
+   long long               numFailures     = 0; // Torn reads, every reader
+   int                     symbolIndex     = 0; // Next updated
+   double                  seconds         = 0.0; // Of the publishes
+   bool                    failed          = false; // A reader failed?
+
+   if (this->programPath.empty())
+   {
+      throw exception("The shared ranking benchmark needs the program path");
+   }
+
+   cout << "---Shared memory ranking: " << NUMSYMBOLS << " symbols, " 
+        << NUMREADERS << " reader processes, a publish of " << BATCH 
+        << " updates every " << PortfolioBenchmark::SHAREDPUBLISHMICROS 
+        << " us---" << endl << endl;
+
+   // Warm up the bounded synthetic stocks
+   portfolioAnalyzer.setHistoryBounded(true);
+   this->generatePortfolio(NUMSYMBOLS, 0, stockNames, portfolioAnalyzer);
+
+   for (int stockIndex = 0; stockIndex < NUMSYMBOLS; ++stockIndex)
+   {
+      SyntheticPriceGenerator stockGenerator(stockIndex + 1); // Per symbol
+
+      for (int barIndex = 0; 
+           barIndex < PortfolioBenchmark::RANKINGNUMBARS; 
+           ++barIndex)
+      {
+         portfolioAnalyzer.updateStockWithPrice(
+            stockIndex, stockGenerator.nextPrice());
+      }
+   }
+
+   {
+      SharedRankingWriter writer(
+         SEGMENTNAME, stockNames, PortfolioBenchmark::SHAREDNUMTOPSTOCKS);
+
+      // Publish them
+      writer.publishPortfolio(portfolioAnalyzer);
+
+      // Start the reader processes, and give them time to map the memory
+      for (int readerIndex = 0; readerIndex < NUMREADERS; ++readerIndex)
+      {
+         ostringstream  resultName; // In the working directory
+         vector<string> readerArguments;
+
+         resultName << "sharedranking.reader" << readerIndex;
+         resultNames.push_back(resultName.str());
+
+         readerArguments.push_back(this->programPath);
+         readerArguments.push_back("-shmreader");
+         readerArguments.push_back(SEGMENTNAME);
+         readerArguments.push_back(resultName.str());
+
+         processes.push_back(Platform::startProcess(readerArguments));
+      }
+
+      this_thread::sleep_for(
+         chrono::milliseconds(PortfolioBenchmark::SHAREDATTACHMILLIS));
+
+      // Publish the batches, timing each publish
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      for (int publishIndex = 0; 
+           publishIndex < PortfolioBenchmark::SHAREDNUMPUBLISHES; 
+           ++publishIndex)
+      {
+         for (int batchIndex = 0; batchIndex < BATCH; ++batchIndex)
+         {
+            portfolioAnalyzer.updateStockWithPrice(
+               symbolIndex, generator.nextPrice());
+            RankingPublisher::summarizeAnalyzer(
+               portfolioAnalyzer.getStockAnalyzerRefAtIndex(symbolIndex),
+               portfolioAnalyzer.getPeriodsSlope(),
+               summaries[batchIndex]);
+            symbolIndices[batchIndex] = symbolIndex;
+            symbolIndex = (symbolIndex + 1) % NUMSYMBOLS;
+         }
+
+         BenchmarkClock::time_point publishStart = BenchmarkClock::now();
+
+         writer.update(symbolIndices, summaries);
+         publishNanos.push_back(chrono::duration<double, nano>(
+            BenchmarkClock::now() - publishStart).count());
+
+         this_thread::sleep_for(chrono::microseconds(
+            PortfolioBenchmark::SHAREDPUBLISHMICROS));
+      }
+
+      seconds = elapsedSeconds(start);
+   }
+
+   // Wait for the readers
+   for (int readerIndex = 0; readerIndex < NUMREADERS; ++readerIndex)
+   {
+      if (0 != Platform::waitForProcess(processes[readerIndex]))
+      {
+         failed = true;
+      }
+   }
+
+   if (failed)
+   {
+      throw exception("A shared ranking reader failed");
+   }
+
+   // Merge and delete their results
+   for (int readerIndex = 0; readerIndex < NUMREADERS; ++readerIndex)
+   {
+      ifstream        resultFile(resultNames[readerIndex].c_str());
+      long long       counts[4]; // Reads, top reads, retries, failures
+      vector<double>* latencyLists[3] = 
+         { &summaryNanos, &topNanos, &propagationNanos };
+
+      if (!(resultFile >> counts[0] >> counts[1] >> counts[2] >> counts[3]))
+      {
+         throw exception("Could not read a shared ranking reader's result");
+      }
+
+      numSummaryReads += counts[0];
+      numTopReads     += counts[1];
+      numRetries      += counts[2];
+      numFailures     += counts[3];
+
+      for (int listIndex = 0; listIndex < 3; ++listIndex)
+      {
+         size_t numLatencies = 0;   // In the list
+         double latency      = 0.0; // Nanoseconds
+
+         resultFile >> numLatencies;
+
+         for (size_t latencyIndex = 0; 
+              latencyIndex < numLatencies && resultFile >> latency; 
+              ++latencyIndex)
+         {
+            latencyLists[listIndex]->push_back(latency);
+         }
+      }
+
+      resultFile.close();
+      remove(resultNames[readerIndex].c_str());
+   }
+
+   if (0 != numFailures)
+   {
+      throw exception("A shared ranking reader read a torn summary");
+   }
+
+   // Output each read's rate and latency, propagation, and publish time
+   cout << setw(14) << left << "nanoseconds" << right 
+        << setw(12) << "count" << setw(12) << "per second" 
+        << setw(10) << "p50" << setw(10) << "p99" 
+        << setw(12) << "max" << endl;
+
+   outputSharedLatency("summary read", numSummaryReads, seconds, 
+                       summaryNanos);
+   outputSharedLatency("top read", numTopReads, seconds, topNanos);
+   outputSharedLatency("propagation", propagationNanos.size(), seconds, 
+                       propagationNanos);
+   outputSharedLatency("publish", publishNanos.size(), seconds, 
+                       publishNanos);
+
+   cout << endl << "Every read was whole, " << numRetries 
+        << " retried; reads are sampled one in " 
+        << PortfolioBenchmark::SHAREDSAMPLEREADS 
+        << ", propagation is per publish a reader saw" << endl;
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkSnapshot
+// Process  : Name SNAPSHOTNUMSYMBOLS bounded synthetic stocks, ranked by
+//                the regression slope
+//             Time the cold analysis, every symbol's SNAPSHOTNUMBARS prices
+//                through updateWithPrice, already in memory
+//             Time saving the portfolio's AnalyzerSnapshot
+//             Time loading it and restoring a new portfolio from it
+//             Update both portfolios with SNAPSHOTNUMUPDATES more prices
+//                per symbol, and check every MACD, slope, EMA, and signal is
+//                the same, bit for bit
+//             Remove the snapshot, output the times and speedup
+// Notes    : Throws an exception if a value differs
+//             The cold analysis parses nothing, a real cold start also
+//                reads every stock data file, see benchmarkPack
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Checks the signal
+//******************************************************************************
+void PortfolioBenchmark::benchmarkSnapshot()
+{
+   static const char* SNAPSHOTFILENAME = "SnapshotBenchmark.snap"; // Saved
+   static const int   PERIODSSLOPE     = 20; // MACDs in the ranking slope
+
+   const int NUMSYMBOLS = PortfolioBenchmark::SNAPSHOTNUMSYMBOLS;
+   const int NUMBARS    = PortfolioBenchmark::SNAPSHOTNUMBARS;
+
+   PortfolioAnalyzer original;           // Analyzed cold
+   PortfolioAnalyzer restored;           // Restored from the snapshot
+   AnalyzerSnapshot  savedSnapshot;      // Of original
+   AnalyzerSnapshot  loadedSnapshot;     // Read back
+   vector<string>    stockNames;         // Of the synthetic stocks
+   double            seconds[3];         // Analyze, save, restore
+   long long         snapshotBytes = 0;  // Of the file
+
+   // Name the bounded synthetic stocks, ranked by the regression slope
+   original.setHistoryBounded(true);
+   original.setPeriodsSlope(PERIODSSLOPE);
+   this->generatePortfolio(NUMSYMBOLS, 0, stockNames, original);
+
+   // Time the cold analysis
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(symbolIndex + 1); // Seed per symbol
+
+      for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+      {
+         original.updateStockWithPrice(symbolIndex, generator.nextPrice());
+      }
+   }
+
+   seconds[0] = elapsedSeconds(start);
+
+   // Time saving the portfolio's snapshot
+   start = BenchmarkClock::now();
+   savedSnapshot.setFromPortfolio(original);
+   savedSnapshot.save(SNAPSHOTFILENAME);
+   seconds[1] = elapsedSeconds(start);
+
+   ifstream snapshotFile(SNAPSHOTFILENAME, ios::binary | ios::ate);
+   snapshotBytes = snapshotFile.tellg();
+   snapshotFile.close();
+
+   // Time loading it and restoring a new portfolio from it
+   start = BenchmarkClock::now();
+   loadedSnapshot.load(SNAPSHOTFILENAME);
+   restored.setVerbose(false);
+   restored.addStocksFromSnapshot(loadedSnapshot);
+   seconds[2] = elapsedSeconds(start);
+
+   remove(SNAPSHOTFILENAME);
+
+   // Update both portfolios with more prices per symbol, and check every 
+   // value is the same
+   if (restored.getNumStockAnalyzers() != NUMSYMBOLS)
+   {
+      throw exception("Restored portfolio has the wrong number of stocks");
+   }
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(NUMSYMBOLS + symbolIndex + 1);
+
+      for (int update = 0; 
+           update < PortfolioBenchmark::SNAPSHOTNUMUPDATES; 
+           ++update)
+      {
+         const double PRICE = generator.nextPrice(); // New close
+
+         original.updateStockWithPrice(symbolIndex, PRICE);
+         restored.updateStockWithPrice(symbolIndex, PRICE);
+
+         const StockAnalyzer& originalAnalyzer = 
+            original.getStockAnalyzerRefAtIndex(symbolIndex);
+         const StockAnalyzer& restoredAnalyzer = 
+            restored.getStockAnalyzerRefAtIndex(symbolIndex);
+
+         if (originalAnalyzer.getCurrentMACD() != 
+                restoredAnalyzer.getCurrentMACD() ||
+             originalAnalyzer.getSlopeMACD() != 
+                restoredAnalyzer.getSlopeMACD() ||
+             originalAnalyzer.getRegressionSlopeMACD() != 
+                restoredAnalyzer.getRegressionSlopeMACD() ||
+             originalAnalyzer.getCurrentEMAFast() != 
+                restoredAnalyzer.getCurrentEMAFast() ||
+             originalAnalyzer.getCurrentEMASlow() != 
+                restoredAnalyzer.getCurrentEMASlow() ||
+             originalAnalyzer.hasSignalMACD() !=
+                restoredAnalyzer.hasSignalMACD() ||
+             originalAnalyzer.getSignalMACD() !=
+                restoredAnalyzer.getSignalMACD() ||
+             original.getRankingSlopeAtIndex(symbolIndex) != 
+                restored.getRankingSlopeAtIndex(symbolIndex))
+         {
+            throw exception("Restored analyzer differs from the original");
+         }
+      }
+   }
+
+   cout << "---Analyzer snapshot: " << NUMSYMBOLS << " symbols, " << NUMBARS
+        << " bars---" << endl << endl;
+   cout << setw(24) << left << "step" << right << setw(12) << "ms" << endl;
+   cout << fixed << setprecision(2);
+   cout << setw(24) << left << "cold analysis" << right 
+        << setw(12) << seconds[0] * 1.0e3 << endl;
+   cout << setw(24) << left << "save snapshot" << right 
+        << setw(12) << seconds[1] * 1.0e3 << endl;
+   cout << setw(24) << left << "load and restore" << right 
+        << setw(12) << seconds[2] * 1.0e3 << endl;
+   cout << endl << "Snapshot MB " << snapshotBytes / BYTESPERMEGABYTE 
+        << ", restore speedup " << seconds[0] / seconds[2] << endl;
+   cout << "Every MACD, slope, EMA, and signal identical over "
+        << PortfolioBenchmark::SNAPSHOTNUMUPDATES << " updates after restore"
+        << endl;
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : benchmarkStream
+// Process  : Write a stock data file per symbol and a UniversePack of them
+//             Limit the resident set to STREAMBUDGETBYTES over the memory
+//                in use
+//             Time streaming the pack, then the stock data files, through a
+//                StreamingAnalyzer with full history under the limit
+//             Analyze the whole pack in memory, for the resident set the
+//                universe needs and the ranking streaming must match
+//             Check the rankings, remove the files, output the batches,
+//                times, and memory
+// Notes    : Throws an exception if a ranking differs, or if streaming
+//             exceeds the limit
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkStream()
+{
+   static const char* DIRECTORYNAME = "StreamBenchmark";      // Of the files
+   static const char* PACKFILENAME  = "StreamBenchmark.pack"; // Of the pack
+   static const int   NUMTOPSTOCKS  = 100;                    // Compared
+
+   vector<string>            stockDataFileNames(
+                                PortfolioBenchmark::STREAMNUMSYMBOLS);
+   vector<ShardStockSummary> packTopStocks; // Streamed from the pack
+   vector<ShardStockSummary> fileTopStocks; // Streamed from the files
+   vector<int>               topIndices;    // Ranked in memory
+   UniversePack              universePack;  // Mapped
+   StreamingAnalyzer         streamingAnalyzer; // Under the limit
+
+   // Write a stock data file per symbol and a UniversePack of them
+   Platform::makeDirectory(DIRECTORYNAME);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::STREAMNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      ostringstream name; // Of the file
+
+      name << DIRECTORYNAME << "/StockDataSYN" << setw(6) << setfill('0') 
+           << symbolIndex << ".csv";
+      stockDataFileNames[symbolIndex] = name.str();
+      writeStockDataFile(
+         stockDataFileNames[symbolIndex], 
+         symbolIndex + 1, 
+         PortfolioBenchmark::STREAMNUMBARS);
+   }
+
+   UniversePack::buildPack(PACKFILENAME, stockDataFileNames);
+   universePack.open(PACKFILENAME);
+
+   // Limit the resident set to STREAMBUDGETBYTES over the memory in use
+   const long long BASEBYTES  = Platform::getResidentSetBytes();
+   const long long LIMITBYTES = 
+      BASEBYTES + PortfolioBenchmark::STREAMBUDGETBYTES;
+
+   streamingAnalyzer.setMemoryLimitBytes(LIMITBYTES);
+   streamingAnalyzer.setNumTopStocks(NUMTOPSTOCKS);
+
+   cout << "---Streaming analysis: " << PortfolioBenchmark::STREAMNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::STREAMNUMBARS 
+        << " bars, full history---" << endl << endl << fixed 
+        << setprecision(2) << "Memory limit:     " 
+        << LIMITBYTES / BYTESPERMEGABYTE << " MB, " 
+        << BASEBYTES / BYTESPERMEGABYTE << " MB in use before" << endl;
+
+   // Time streaming the pack, then the stock data files
+   for (int sourceIndex = 0; sourceIndex < 2; ++sourceIndex)
+   {
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      if (0 == sourceIndex)
+      {
+         streamingAnalyzer.analyzePack(universePack);
+         packTopStocks = streamingAnalyzer.getTopStocks();
+      }
+      else
+      {
+         streamingAnalyzer.analyzeStockDataFiles(stockDataFileNames);
+         fileTopStocks = streamingAnalyzer.getTopStocks();
+      }
+
+      double seconds = elapsedSeconds(start); // Of the stream
+
+      cout << ((0 == sourceIndex) ? "Pack stream:      " : 
+                                    "File stream:      ")
+           << seconds << " s, " << streamingAnalyzer.getNumBatches() 
+           << " batches of at most " << streamingAnalyzer.getMaxBatchStocks()
+           << " stocks, peak resident set " 
+           << streamingAnalyzer.getPeakResidentBytes() / BYTESPERMEGABYTE 
+           << " MB" << endl;
+   }
+
+   cout << "Analyzers held:   " 
+        << streamingAnalyzer.getAccountedBytes() / BYTESPERMEGABYTE 
+        << " MB in all, " 
+        << double(streamingAnalyzer.getAccountedBytes()) / 
+              PortfolioBenchmark::STREAMBUDGETBYTES 
+        << "x the budget" << endl;
+
+   // Analyze the whole pack in memory
+   {
+      PortfolioAnalyzer portfolioAnalyzer; // The whole universe
+
+      BenchmarkClock::time_point start = BenchmarkClock::now();
+
+      portfolioAnalyzer.setVerbose(false);
+      portfolioAnalyzer.addStocksFromPack(universePack);
+      portfolioAnalyzer.analyzePortfolio();
+      portfolioAnalyzer.getTopStocksByMACDSlope(NUMTOPSTOCKS, topIndices);
+
+      double    seconds       = elapsedSeconds(start); // In memory
+      long long residentBytes = Platform::getResidentSetBytes(); // Holding it
+
+      cout << "In memory:        " << seconds << " s, resident set " 
+           << residentBytes / BYTESPERMEGABYTE << " MB, " 
+           << double(residentBytes - BASEBYTES) / 
+                 PortfolioBenchmark::STREAMBUDGETBYTES 
+           << "x the budget" << endl;
+      cout.unsetf(ios::floatfield);
+      cout << setprecision(6) << endl;
+
+      // Check the rankings
+      for (size_t rank = 0; rank < topIndices.size(); ++rank)
+      {
+         const StockAnalyzer& stockAnalyzer = 
+            portfolioAnalyzer.getStockAnalyzerRefAtIndex(topIndices[rank]);
+
+         if (rank >= packTopStocks.size() || rank >= fileTopStocks.size() ||
+             packTopStocks[rank].symbol != stockAnalyzer.getStockSymbol() ||
+             fileTopStocks[rank].symbol != stockAnalyzer.getStockSymbol() ||
+             packTopStocks[rank].slopeMACD != 
+                portfolioAnalyzer.getRankingSlopeAtIndex(topIndices[rank]) ||
+             fileTopStocks[rank].slopeMACD != packTopStocks[rank].slopeMACD)
+         {
+            throw exception("Streamed ranking differs from the analysis");
+         }
+      }
+   }
+
+   // Remove the files
+   universePack.close();
+   remove(PACKFILENAME);
+
+   for (int symbolIndex = 0; 
+        symbolIndex < PortfolioBenchmark::STREAMNUMSYMBOLS; 
+        ++symbolIndex)
+   {
+      remove(stockDataFileNames[symbolIndex].c_str());
+   }
+
+   Platform::removeDirectory(DIRECTORYNAME);
+}
+
+//******************************************************************************
+// Function : benchmarkTickIngestion
+// Process  : Generate the synthetic ticks once
+//             Replay them unthrottled through a TickIngestor with one shard,
+//                then with a shard per spare hardware thread if more
+//             Output each ingestor's statistics
+// Notes    : The replaying thread is the feed reader, so one hardware 
+//             thread is left to it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkTickIngestion()
+{
+   TickReplayer replayer;          // Synthetic feed
+   vector<int>  shardCounts(1, 1); // Shards of each run
+   const int    SPARETHREADS = int(thread::hardware_concurrency()) - 1;
+
+   replayer.generateTicks(
+      PortfolioBenchmark::TICKNUMSYMBOLS,
+      PortfolioBenchmark::TICKNUMTICKS,
+      PortfolioBenchmark::TICKMICROS);
+
+   if (SPARETHREADS > 1)
+   {
+      shardCounts.push_back(SPARETHREADS);
+   }
+
+   cout << "---Tick ingestion: " << PortfolioBenchmark::TICKNUMSYMBOLS
+        << " symbols x " << PortfolioBenchmark::TICKNUMTICKS
+        << " ticks, " << PortfolioBenchmark::TICKBARMICROS 
+        << " us bars---" << endl << endl;
+
+   // Replay them through each shard count
+   for (size_t runIndex = 0; runIndex < shardCounts.size(); ++runIndex)
+   {
+      TickIngestor ingestor(
+         replayer.getNumSymbols(),
+         shardCounts[runIndex],
+         PortfolioBenchmark::TICKBARMICROS);
+
+      double seconds = replayer.replay(ingestor, 0.0);
+      ingestor.outputStatistics(seconds);
+      cout << endl;
+   }
+}
+
+//******************************************************************************
+// Function : benchmarkTimeframes
+// Process  : Generate DEFAULTNUMSYMBOLS synthetic stocks of DEFAULTNUMBARS
+//                weekdays, with highs, lows, and volumes
+//             Time TIMEFRAMENUMREPS passes of a TimeframeAnalyzer over every
+//                stock, keeping the daily, weekly, and monthly MACD and slope
+//             Time as many resamplings of every stock to daily, weekly, and
+//                monthly closes, each analyzed by a StockAnalyzer
+//             Check every MACD and slope of the one pass against the
+//                StockAnalyzer of the resampled closes
+//             Output the time, bars per second, and speedup
+// Notes    : Throws an exception if a check fails
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::benchmarkTimeframes()
+{
+   const int NUMSYMBOLS    = PortfolioBenchmark::DEFAULTNUMSYMBOLS;
+   const int NUMBARS       = PortfolioBenchmark::DEFAULTNUMBARS;
+   const int NUMREPS       = PortfolioBenchmark::TIMEFRAMENUMREPS;
+   const int NUMTIMEFRAMES = TimeframeAnalyzer::NUMTIMEFRAMES;
+   const int DAYSPERWEEK   = 7;
+   const int WEEKDAYS      = 5;
+
+   vector< vector<double> > universe;  // Closes of each stock
+   vector<Stock>            stocks(NUMSYMBOLS);
+   vector<int>              dates(NUMBARS);   // Weekdays, shared
+   vector<double>           highs(NUMBARS);   // Of a stock
+   vector<double>           lows(NUMBARS);    // Of a stock
+   vector<long long>        volumes(NUMBARS); // Of a stock
+   TimeframeAnalyzer        timeframeAnalyzer; // Of each stock in turn
+   vector<double>           macds(NUMSYMBOLS * NUMTIMEFRAMES);  // One pass
+   vector<double>           slopes(NUMSYMBOLS * NUMTIMEFRAMES); // One pass
+   vector<char>             hasMACDs(NUMSYMBOLS * NUMTIMEFRAMES);
+   vector<double>           resampledMACDs(NUMSYMBOLS * NUMTIMEFRAMES);
+   vector<double>           resampledSlopes(NUMSYMBOLS * NUMTIMEFRAMES);
+   vector<char>             resampledHasMACDs(NUMSYMBOLS * NUMTIMEFRAMES);
+   double                   onePass    = 0.0; // Seconds per pass
+   double                   resampling = 0.0; // Seconds per resampling
+   int                      date       = TradingCalendar::toDate(2000, 1, 3);
+
+   // Weekdays from Monday 1.3.2000
+   for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+   {
+      dates[barIndex] = date;
+      date += (WEEKDAYS - 1 == barIndex % WEEKDAYS) ? 
+                 DAYSPERWEEK - WEEKDAYS + 1 : 1;
+   }
+
+   // Generate the synthetic stocks
+   this->generateUniverse(NUMSYMBOLS, NUMBARS, universe);
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      for (int barIndex = 0; barIndex < NUMBARS; ++barIndex)
+      {
+         highs[barIndex]   = universe[symbolIndex][barIndex] * 1.01;
+         lows[barIndex]    = universe[symbolIndex][barIndex] * 0.99;
+         volumes[barIndex] = 1000 + barIndex;
+      }
+
+      stocks[symbolIndex].setHistory(
+         dates.data(), universe[symbolIndex].data(), NUMBARS);
+      stocks[symbolIndex].setBars(
+         highs.data(), lows.data(), volumes.data(), NUMBARS);
+   }
+
+   cout << "---Timeframes: " << NUMSYMBOLS << " symbols, " << NUMBARS
+        << " daily bars, MACD " << timeframeAnalyzer.getPeriodsFast() << "/"
+        << timeframeAnalyzer.getPeriodsSlow() << "/" 
+        << timeframeAnalyzer.getPeriodsSignal() << "---" << endl << endl;
+
+   // Time the one pass analyses
+   BenchmarkClock::time_point start = BenchmarkClock::now();
+
+   for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+   {
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         timeframeAnalyzer.analyzeStock(stocks[symbolIndex]);
+
+         for (int timeframe = 0; timeframe < NUMTIMEFRAMES; ++timeframe)
+         {
+            const TimeframeAnalyzer::Timeframe TIMEFRAME = 
+               TimeframeAnalyzer::Timeframe(timeframe);
+            const int RESULTINDEX = symbolIndex * NUMTIMEFRAMES + timeframe;
+
+            macds[RESULTINDEX]    = timeframeAnalyzer.getMACD(TIMEFRAME);
+            slopes[RESULTINDEX]   = timeframeAnalyzer.getSlopeMACD(TIMEFRAME);
+            hasMACDs[RESULTINDEX] = timeframeAnalyzer.hasMACD(TIMEFRAME);
+         }
+      }
+   }
+
+   onePass = elapsedSeconds(start) / NUMREPS;
+
+   // Time resampling each timeframe and analyzing it
+   start = BenchmarkClock::now();
+
+   for (int repIndex = 0; repIndex < NUMREPS; ++repIndex)
+   {
+      for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+      {
+         for (int timeframe = 0; timeframe < NUMTIMEFRAMES; ++timeframe)
+         {
+            const int     RESULTINDEX = 
+               symbolIndex * NUMTIMEFRAMES + timeframe;
+            Stock         resampled;     // Closes of the timeframe
+            StockAnalyzer stockAnalyzer; // Of the closes
+
+            resampleCloses(stocks[symbolIndex], 
+                           TimeframeAnalyzer::Timeframe(timeframe), 
+                           resampled);
+            stockAnalyzer.setVerbose(false);
+            stockAnalyzer.setStock(resampled);
+            stockAnalyzer.analyzeStock();
+
+            resampledMACDs[RESULTINDEX]    = stockAnalyzer.getCurrentMACD();
+            resampledSlopes[RESULTINDEX]   = stockAnalyzer.getSlopeMACD();
+            resampledHasMACDs[RESULTINDEX] = stockAnalyzer.hasMACD();
+         }
+      }
+   }
+
+   resampling = elapsedSeconds(start) / NUMREPS;
+
+   // Check the one pass against the resampled closes' analyzers
+   for (size_t resultIndex = 0; resultIndex < macds.size(); ++resultIndex)
+   {
+      if (hasMACDs[resultIndex] != resampledHasMACDs[resultIndex] ||
+          (hasMACDs[resultIndex] &&
+           (macds[resultIndex] != resampledMACDs[resultIndex] ||
+            slopes[resultIndex] != resampledSlopes[resultIndex])))
+      {
+         throw exception("Timeframe MACD differs from the resampled one");
+      }
+   }
+
+   cout << setw(24) << left << "analysis" << right << setw(12) << "ms" 
+        << setw(14) << "Mbars/s" << endl;
+   cout << fixed << setprecision(2) << setw(24) << left << "one pass" 
+        << right << setw(12) << onePass * 1.0e3 << setw(14) 
+        << double(NUMSYMBOLS) * NUMBARS / onePass / 1.0e6 << endl;
+   cout << setw(24) << left << "resample and analyze x3" << right 
+        << setw(12) << resampling * 1.0e3 << setw(14) 
+        << double(NUMSYMBOLS) * NUMBARS / resampling / 1.0e6 << endl;
+   cout << endl << "One pass speedup " << resampling / onePass 
+        << ", every daily, weekly, and monthly MACD and slope checked" 
+        << endl;
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6) << endl;
+}
+
+//******************************************************************************
+// Function : generatePortfolio
+// Process  : Name every synthetic stock
+//             Set the portfolio's stock data files to the names
+//             Generate and set each stock's prices
+//             Turn off the portfolio's output
+// Notes    : No stock data files are read, analyzePortfolio uses the prices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::generatePortfolio(
+   const int numSymbols,
+   const int numBars,
+   vector<string>& stockNames,
+   PortfolioAnalyzer& portfolioAnalyzer)
+{
+   vector<char*>  stockDataFileNames; // Names handed to the portfolio
+   vector<double> prices;             // Prices of one stock
+
+   // Name every synthetic stock
+   stockNames.resize(numSymbols);
+
+   for (int symbolIndex = 0; symbolIndex < numSymbols; ++symbolIndex)
+   {
+      ostringstream name; // SYN00000, SYN00001, ...
+      name << "SYN" << setw(5) << setfill('0') << symbolIndex;
+      stockNames[symbolIndex] = name.str();
+   }
+
+   for (int symbolIndex = 0; symbolIndex < numSymbols; ++symbolIndex)
+   {
+      stockDataFileNames.push_back(&stockNames[symbolIndex][0]);
+   }
+
+   portfolioAnalyzer.setVerbose(false);
+   portfolioAnalyzer.setStockDataFiles(stockDataFileNames);
+
+   // Generate and set each stock's prices
+   for (int symbolIndex = 0; symbolIndex < numSymbols; ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(symbolIndex + 1); // Seed per symbol
+      Stock                   stock;                      // Generated stock
+
+      generator.generatePrices(numBars, prices);
+
+      for (int barIndex = 0; barIndex < numBars; ++barIndex)
+      {
+         stock.addPrice(prices[barIndex]);
+      }
+
+      portfolioAnalyzer.setStockAtIndex(symbolIndex, stock);
+   }
+}
+
+//******************************************************************************
+// Function : generateUniverse
+// Process  : Generate each symbol's prices with its own seed
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::generateUniverse(
+   const int numSymbols,
+   const int numBars,
+   vector< vector<double> >& universe)
+{
+   universe.resize(numSymbols);
+
+   for (int symbolIndex = 0; symbolIndex < numSymbols; ++symbolIndex)
+   {
+      SyntheticPriceGenerator generator(symbolIndex + 1); // Seed per symbol
+      generator.generatePrices(numBars, universe[symbolIndex]);
+   }
+}
+
+//******************************************************************************
+// Function : runBenchmark
+// Process  : Run the benchmark matching the name
+//             "all" runs every benchmark except the soak, which takes minutes,
+//                and the pack and stream, which write gigabytes
+// Notes    : Returns false if the name is unknown
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added soak
+// 10.19.26       Donne Martin         Added ticks
+// 10.19.26       Donne Martin         Added metrics
+// 10.19.26       Donne Martin         Added allocations
+// 10.19.26       Donne Martin         Added calendar
+// 10.19.26       Donne Martin         Added correlation
+// 10.19.26       Donne Martin         Added slope
+// 10.19.26       Donne Martin         Added screener
+// 10.19.26       Donne Martin         Added compression
+// 10.19.26       Donne Martin         Added pack
+// 10.19.26       Donne Martin         Added stream
+// 10.19.26       Donne Martin         Added indicators
+// 10.19.26       Donne Martin         Added graph
+// 10.19.26       Donne Martin         Added ribbon
+// 10.19.26       Donne Martin         Added ranges
+// 10.19.26       Donne Martin         Added crossovers
+// 10.19.26       Donne Martin         Added alerts
+// 10.19.26       Donne Martin         Added timeframes
+// 10.19.26       Donne Martin         Added snapshot
+// 10.19.26       Donne Martin         Added ranking
+// 10.19.26       Donne Martin         Added sharedranking
+//******************************************************************************
+bool PortfolioBenchmark::runBenchmark(const string& benchmarkName)
+{
+   bool runAll   = ("all" == benchmarkName); // Run every benchmark?
+   bool foundOne = false;                    // Name matched a benchmark?
+
+   if (runAll || "pricepolicy" == benchmarkName)
+   {
+      this->benchmarkPricePolicies();
+      foundOne = true;
+   }
+
+   if (runAll || "daemon" == benchmarkName)
+   {
+      this->benchmarkDaemonLatency();
+      foundOne = true;
+   }
+
+   if (runAll || "metrics" == benchmarkName)
+   {
+      this->benchmarkMetrics();
+      foundOne = true;
+   }
+
+   if (runAll || "ticks" == benchmarkName)
+   {
+      this->benchmarkTickIngestion();
+      foundOne = true;
+   }
+
+   if (runAll || "allocations" == benchmarkName)
+   {
+      this->benchmarkAllocations();
+      foundOne = true;
+   }
+
+   if (runAll || "calendar" == benchmarkName)
+   {
+      this->benchmarkCalendar();
+      foundOne = true;
+   }
+
+   if (runAll || "correlation" == benchmarkName)
+   {
+      this->benchmarkCorrelation();
+      foundOne = true;
+   }
+
+   if (runAll || "slope" == benchmarkName)
+   {
+      this->benchmarkRegressionSlope();
+      foundOne = true;
+   }
+
+   if (runAll || "screener" == benchmarkName)
+   {
+      this->benchmarkScreener();
+      foundOne = true;
+   }
+
+   if (runAll || "compression" == benchmarkName)
+   {
+      this->benchmarkCompression();
+      foundOne = true;
+   }
+
+   if (runAll || "indicators" == benchmarkName)
+   {
+      this->benchmarkIndicators();
+      foundOne = true;
+   }
+
+   if (runAll || "graph" == benchmarkName)
+   {
+      this->benchmarkIndicatorGraph();
+      foundOne = true;
+   }
+
+   if (runAll || "ribbon" == benchmarkName)
+   {
+      this->benchmarkRibbon();
+      foundOne = true;
+   }
+
+   if (runAll || "ranges" == benchmarkName)
+   {
+      this->benchmarkRanges();
+      foundOne = true;
+   }
+
+   if (runAll || "crossovers" == benchmarkName)
+   {
+      this->benchmarkCrossovers();
+      foundOne = true;
+   }
+
+   if (runAll || "alerts" == benchmarkName)
+   {
+      this->benchmarkAlerts();
+      foundOne = true;
+   }
+
+   if (runAll || "timeframes" == benchmarkName)
+   {
+      this->benchmarkTimeframes();
+      foundOne = true;
+   }
+
+   if (runAll || "snapshot" == benchmarkName)
+   {
+      this->benchmarkSnapshot();
+      foundOne = true;
+   }
+
+   if (runAll || "ranking" == benchmarkName)
+   {
+      this->benchmarkRanking();
+      foundOne = true;
+   }
+
+   if (runAll || "sharedranking" == benchmarkName)
+   {
+      this->benchmarkSharedRanking();
+      foundOne = true;
+   }
+
+   if ("soak" == benchmarkName)
+   {
+      this->benchmarkBoundedHistory();
+      foundOne = true;
+   }
+
+   if ("pack" == benchmarkName)
+   {
+      this->benchmarkPack();
+      foundOne = true;
+   }
+
+   if ("stream" == benchmarkName)
+   {
+      this->benchmarkStream();
+      foundOne = true;
+   }
+
+   return foundOne;
+}
+
+//******************************************************************************
+// Function : runSharedRankingReader
+// Process  : Map the shared ranking
+//             Until the writer closes it
+//                When the version moves on, read the top symbols, and the
+//                   latency from their publish to noticing it
+//                Otherwise read the summary of the next symbol, striding
+//                   through the symbols
+//                Check every summary read is whole, and every ranking is
+//                   in order and never older
+//                Time one read in SHAREDSAMPLEREADS of each kind
+//             Write the counts, then each list of latencies, to the result
+//                file
+// Notes    : The -shmreader process of benchmarkSharedRanking
+//             Throws an exception if the result file can't be written
+//             The first ranking read was published before the reader
+//                started, so it has no propagation latency
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void PortfolioBenchmark::runSharedRankingReader(
+   const string& segmentName,
+   const string& resultFileName)
+{
+   static const int SYMBOLSTRIDE = 7919; // Prime, visits every symbol
+
+   SharedRankingReader         reader(segmentName); // Of the benchmark
+   SharedSymbolSummary         summary;             // Read
+   vector<int>                 topIndices;          // Read
+   vector<SharedSymbolSummary> topSummaries;        // Read
+   vector<double>              latencyLists[3];     // Summary, top, and
+                                                    // propagation
+   long long                   numSummaryReads = 0;
+   long long                   numTopReads     = 0;
+   long long                   numFailures     = 0; // Torn reads
+   long long                   lastVersion     = 0; // Of the last ranking
+   long long                   version         = 0; // Of a ranking
+   long long                   publishNanos    = 0; // Of a ranking
+   int                         symbolIndex     = 0; // Next read
+   ofstream                    resultFile;
+
+   while (!reader.isClosed())
+   {
+      const long long START   = Platform::getSteadyNanos();
+      bool            isWhole = true; // Read passed the checks?
+
+      if (reader.getVersion() != lastVersion)
+      {
+         // Read the top symbols, and the latency from their publish
+         isWhole = reader.readTopStocks(
+            topIndices, topSummaries, version, publishNanos) &&
+            version >= lastVersion;
+
+         for (int rank = 0; rank < int(topSummaries.size()); ++rank)
+         {
+            isWhole = isWhole &&
+               rank + 1 == topSummaries[rank].rank &&
+               isWholeSharedSummary(
+                  topSummaries[rank], reader.getNumSymbols()) &&
+               (0 == rank || topSummaries[rank - 1].rankingSlope >=
+                                topSummaries[rank].rankingSlope);
+         }
+
+         if (0 == numTopReads % PortfolioBenchmark::SHAREDSAMPLEREADS)
+         {
+            latencyLists[1].push_back(double(Platform::getSteadyNanos() - START));
+         }
+
+         if (0 != lastVersion && version > lastVersion)
+         {
+            latencyLists[2].push_back(double(START - publishNanos));
+         }
+
+         lastVersion = version;
+         ++numTopReads;
+      }
+      else
+      {
+         // Read the summary of the next symbol
+         isWhole = reader.readSummary(symbolIndex, summary) &&
+                   isWholeSharedSummary(summary, reader.getNumSymbols());
+
+         if (0 == numSummaryReads % PortfolioBenchmark::SHAREDSAMPLEREADS)
+         {
+            latencyLists[0].push_back(double(Platform::getSteadyNanos() - START));
+         }
+
+         symbolIndex = (symbolIndex + SYMBOLSTRIDE) % reader.getNumSymbols();
+         ++numSummaryReads;
+      }
+
+      if (!isWhole)
+      {
+         ++numFailures;
+      }
+   }
+
+   // Write the counts, then each list of latencies
+   resultFile.open(resultFileName.c_str());
+   resultFile << numSummaryReads << ' ' << numTopReads << ' '
+              << reader.getNumRetries() << ' ' << numFailures << endl;
+
+   for (int listIndex = 0; listIndex < 3; ++listIndex)
+   {
+      resultFile << latencyLists[listIndex].size();
+
+      for (size_t latencyIndex = 0;
+           latencyIndex < latencyLists[listIndex].size();
+           ++latencyIndex)
+      {
+         resultFile << ' ' << latencyLists[listIndex][latencyIndex];
+      }
+
+      resultFile << endl;
+   }
+
+   resultFile.close();
+
+   if (resultFile.fail())
+   {
+      throw exception("Could not write the shared ranking reader's result");
+   }
+}
\ No newline at end of file
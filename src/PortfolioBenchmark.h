@@ -0,0 +1,506 @@
+//******************************************************************************
+//
+// File Name:     PortfolioBenchmark.h
+//
+// File Overview: Represents a PortfolioBenchmark
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the bounded history soak
+// 10.19.26       Donne Martin         Added the allocation budget
+// 10.19.26       Donne Martin         Added the calendar benchmark
+// 10.19.26       Donne Martin         Added the correlation benchmark
+// 10.19.26       Donne Martin         Added the regression slope benchmark
+// 10.19.26       Donne Martin         Added the screener benchmark
+// 10.19.26       Donne Martin         Added the compression benchmark
+// 10.19.26       Donne Martin         Added the pack benchmark
+// 10.19.26       Donne Martin         Added the streaming benchmark
+// 10.19.26       Donne Martin         Added the indicator engine benchmark
+// 10.19.26       Donne Martin         Added the indicator graph benchmark
+// 10.19.26       Donne Martin         Added the EMA ribbon benchmark
+// 10.19.26       Donne Martin         Added the range query benchmark
+// 10.19.26       Donne Martin         Added the crossover benchmark
+// 10.19.26       Donne Martin         Added the alert pipeline benchmark
+// 10.19.26       Donne Martin         Added the timeframe benchmark
+// 10.19.26       Donne Martin         Added the snapshot benchmark
+// 10.19.26       Donne Martin         Added the ranking snapshot benchmark
+// 10.19.26       Donne Martin         Added the shared memory ranking benchmark
+//******************************************************************************
+
+#ifndef PortfolioBenchmark_h
+#define PortfolioBenchmark_h
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class PortfolioAnalyzer;
+
+//******************************************************************************
+//
+// Class:    PortfolioBenchmark
+//
+// Overview: Runs the performance benchmarks and reports them to cout
+//             Run with: stockanalyzer -benchmark [name]
+//             Without a name every benchmark is run, except the long soak
+//                and the pack and streaming benchmarks, which write
+//                gigabytes to disk
+//             Benchmarks use synthetic data from SyntheticPriceGenerator
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the bounded history soak
+// 10.19.26       Donne Martin         Added the allocation budget
+// 10.19.26       Donne Martin         Added the calendar benchmark
+// 10.19.26       Donne Martin         Added the correlation benchmark
+// 10.19.26       Donne Martin         Added the regression slope benchmark
+// 10.19.26       Donne Martin         Added the screener benchmark
+// 10.19.26       Donne Martin         Added the compression benchmark
+// 10.19.26       Donne Martin         Added the pack benchmark
+// 10.19.26       Donne Martin         Added the streaming benchmark
+// 10.19.26       Donne Martin         Added the indicator engine benchmark
+// 10.19.26       Donne Martin         Added the indicator graph benchmark
+// 10.19.26       Donne Martin         Added the EMA ribbon benchmark
+// 10.19.26       Donne Martin         Added the range query benchmark
+// 10.19.26       Donne Martin         Added the crossover benchmark
+// 10.19.26       Donne Martin         Added the alert pipeline benchmark
+// 10.19.26       Donne Martin         Added the timeframe benchmark
+// 10.19.26       Donne Martin         Added the snapshot benchmark
+// 10.19.26       Donne Martin         Added the ranking snapshot benchmark
+// 10.19.26       Donne Martin         Added the shared memory ranking benchmark
+//
+//******************************************************************************
+class PortfolioBenchmark
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : None
+   // Constraints : None
+   //***************************************************************************
+   PortfolioBenchmark();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~PortfolioBenchmark();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : benchmarkAlerts
+   // Description : Publishes alerts from a growing number of producer
+   //                threads to an AlertPublisher, then replays synthetic
+   //                ticks whose MACD alerts go to a log file and a local
+   //                consumer, and reports alerts per second and the bar
+   //                to write latency
+   // Constraints : Throws an exception if an alert is lost, duplicated, or
+   //                out of order
+   //***************************************************************************
+   void benchmarkAlerts();
+
+   //***************************************************************************
+   // Function    : benchmarkAllocations
+   // Description : Counts the allocations per symbol of analyzing and
+   //                ranking a synthetic portfolio with AllocationTracker,
+   //                and of parsing, analyzing, and ranking
+   //                ALLOCATIONNUMFILES stock data files
+   // Constraints : Throws an exception if over ALLOCATIONSPERSYMBOL, or
+   //                PARSEALLOCATIONSPERSYMBOL for the stock data files
+   //***************************************************************************
+   void benchmarkAllocations();
+
+   //***************************************************************************
+   // Function    : benchmarkBoundedHistory
+   // Description : Checks bounded StockAnalyzers match unbounded ones and 
+   //                compares their memory
+   //                Then soaks SOAKNUMSYMBOLS bounded analyzers with 
+   //                SOAKNUMUPDATES updates, reporting the resident set size
+   // Constraints : Takes minutes, only run when named
+   //***************************************************************************
+   void benchmarkBoundedHistory();
+
+   //***************************************************************************
+   // Function    : benchmarkCalendar
+   // Description : Times date parsing and TradingCalendar alignment of 
+   //                synthetic stocks with staggered listings and halts
+   // Constraints : Throws an exception if a price is misaligned
+   //***************************************************************************
+   void benchmarkCalendar();
+
+   //***************************************************************************
+   // Function    : benchmarkCompression
+   // Description : Compresses the dates, prices, and volumes of synthetic 
+   //                and res stocks with CompressedSeries
+   //                Reports the compression ratio and decoding throughput,
+   //                and an EMA fed from doubles and from compressed blocks
+   // Constraints : Throws an exception if a column doesn't round trip
+   //***************************************************************************
+   void benchmarkCompression();
+
+   //***************************************************************************
+   // Function    : benchmarkCorrelation
+   // Description : Times CorrelationMatrix at 1000, 5000, and 20000 
+   //                symbols with missing returns, in seconds and GFLOP/s
+   // Constraints : Throws an exception if a checked correlation is wrong
+   //***************************************************************************
+   void benchmarkCorrelation();
+
+   //***************************************************************************
+   // Function    : benchmarkCrossovers
+   // Description : Detects every MACD crossover of DEFAULTNUMSYMBOLS
+   //                synthetic stocks with a CrossoverDetector on 1 thread,
+   //                doubling up to a thread per hardware thread, and reports
+   //                the bars detected per second of each
+   // Constraints : Throws an exception if a bit or event differs from a
+   //                bar by bar reference
+   //***************************************************************************
+   void benchmarkCrossovers();
+
+   //***************************************************************************
+   // Function    : benchmarkDaemonLatency
+   // Description : Serves a synthetic portfolio with an AnalysisDaemon on a
+   //                background thread and reports the round trip latencies 
+   //                of a DaemonLoadGenerator
+   // Constraints : None
+   //***************************************************************************
+   void benchmarkDaemonLatency();
+
+   //***************************************************************************
+   // Function    : benchmarkIndicatorGraph
+   // Description : Computes the indicators of a set of overlapping
+   //                strategies on DEFAULTNUMSYMBOLS synthetic stocks, with
+   //                an IndicatorEngine per strategy, and with one engine,
+   //                without and with its identical nodes shared
+   //                Reports the nodes eliminated and the time per bar
+   // Constraints : Throws an exception if the values differ
+   //***************************************************************************
+   void benchmarkIndicatorGraph();
+
+   //***************************************************************************
+   // Function    : benchmarkIndicators
+   // Description : Computes from 1 to 10 indicators of DEFAULTNUMSYMBOLS
+   //                synthetic stocks in one fused IndicatorEngine pass per
+   //                stock, and in a pass per indicator, and reports the
+   //                time per bar of each
+   // Constraints : Throws an exception if the two differ, or the engine's
+   //                MACD differs from StockAnalyzer's
+   //***************************************************************************
+   void benchmarkIndicators();
+
+   //***************************************************************************
+   // Function    : benchmarkMetrics
+   // Description : Reports the cost of one Metrics timer disabled and
+   //                enabled, and the overhead of enabled Metrics on 
+   //                analyzing and ranking a synthetic portfolio
+   // Constraints : None
+   //***************************************************************************
+   void benchmarkMetrics();
+
+   //***************************************************************************
+   // Function    : benchmarkPack
+   // Description : Writes PACKNUMSYMBOLS synthetic stock data files, then
+   //                times starting an analysis from them and from a
+   //                UniversePack of them
+   //                The files and the pack are written to the current
+   //                directory, and removed
+   // Constraints : Throws an exception if the two rank differently
+   //***************************************************************************
+   void benchmarkPack();
+
+   //***************************************************************************
+   // Function    : benchmarkPricePolicies
+   // Description : Reports memory per symbol, kernel time, and error against
+   //                DoublePricePolicy for each policy in PricePolicy.h
+   // Constraints : None
+   //***************************************************************************
+   void benchmarkPricePolicies();
+
+   //***************************************************************************
+   // Function    : benchmarkRanges
+   // Description : Times range queries of a synthetic stock, a sum of
+   //                closes, maximum of highs, minimum of lows, and mean of
+   //                volumes, against linear scans for ranges of 5 bars to
+   //                10 years, and reports the cost of building and of
+   //                extending the range indexes
+   // Constraints : Throws an exception if a range query differs from its
+   //                scan
+   //***************************************************************************
+   void benchmarkRanges();
+
+   //***************************************************************************
+   // Function    : benchmarkRanking
+   // Description : Reads the top stocks of RANKINGNUMSYMBOLS synthetic
+   //                stocks from RANKINGNUMREADERS threads while
+   //                RANKINGNUMWRITERS threads update the stocks, with the
+   //                rankings published by a RankingPublisher and, as the
+   //                baseline, under one mutex
+   //                Reports reads per second, read latency, and updates
+   //                per second of each
+   // Constraints : Throws an exception if a reader sees an inconsistent
+   //                ranking
+   //***************************************************************************
+   void benchmarkRanking();
+
+   //***************************************************************************
+   // Function    : benchmarkRegressionSlope
+   // Description : Times streaming SLOPENUMBARS synthetic prices through a
+   //                bounded StockAnalyzer with regression slopes of MACD
+   //                from none to 100000 MACDs, and checks the slopes
+   // Constraints : Throws an exception if a slope is wrong
+   //***************************************************************************
+   void benchmarkRegressionSlope();
+
+   //***************************************************************************
+   // Function    : benchmarkRibbon
+   // Description : Calculates EMA ribbons of 4, 8, and 16 periods of
+   //                DEFAULTNUMSYMBOLS synthetic stocks with an EMARibbon,
+   //                with and without history, and with a calculateEMA per
+   //                period, and reports the time per bar of each
+   // Constraints : Throws an exception if an EMA differs
+   //***************************************************************************
+   void benchmarkRibbon();
+
+   //***************************************************************************
+   // Function    : benchmarkScreener
+   // Description : Screens SCREENERNUMSYMBOLS symbols of synthetic columns
+   //                with compiled Screener plans and with the interpreter
+   //                Reports symbols screened per second and the speedup
+   // Constraints : Throws an exception if the two select different symbols
+   //***************************************************************************
+   void benchmarkScreener();
+
+   //***************************************************************************
+   // Function    : benchmarkSharedRanking
+   // Description : Publishes batches of updates of SHAREDNUMSYMBOLS
+   //                synthetic stocks to a SharedRankingWriter, read by
+   //                SHAREDNUMREADERS -shmreader processes of this program
+   //                Reports each reader read's rate and latency, the latency
+   //                from a publish to a reader seeing it, and the time to
+   //                publish
+   // Constraints : Needs setProgramPath
+   //                Throws an exception if a reader fails or reads a torn
+   //                summary or ranking
+   //***************************************************************************
+   void benchmarkSharedRanking();
+
+   //***************************************************************************
+   // Function    : benchmarkSnapshot
+   // Description : Warms up SNAPSHOTNUMSYMBOLS bounded synthetic stocks of
+   //                SNAPSHOTNUMBARS bars, then saves them to an
+   //                AnalyzerSnapshot and restores them in a new portfolio
+   //                Reports the save and restore times against the cold
+   //                analysis
+   //                The snapshot is written to the current directory, and
+   //                removed
+   // Constraints : Throws an exception if a restored analyzer's updates
+   //                differ from the original's
+   //***************************************************************************
+   void benchmarkSnapshot();
+
+   //***************************************************************************
+   // Function    : benchmarkStream
+   // Description : Streams STREAMNUMSYMBOLS synthetic stocks with full
+   //                history through a StreamingAnalyzer limited to
+   //                STREAMBUDGETBYTES more memory, from a UniversePack and
+   //                from stock data files, and reports the peak resident set
+   //                against analyzing them all in memory
+   //                The files and the pack are written to the current
+   //                directory, and removed
+   // Constraints : Throws an exception if a ranking differs or the limit
+   //                is exceeded
+   //***************************************************************************
+   void benchmarkStream();
+
+   //***************************************************************************
+   // Function    : benchmarkTickIngestion
+   // Description : Replays TICKNUMTICKS synthetic ticks of TICKNUMSYMBOLS
+   //                symbols through a TickIngestor, unthrottled, with one 
+   //                shard and with a shard per spare hardware thread
+   //                Reports ticks per second and per tick latency
+   // Constraints : None
+   //***************************************************************************
+   void benchmarkTickIngestion();
+
+   //***************************************************************************
+   // Function    : benchmarkTimeframes
+   // Description : Analyzes the daily, weekly, and monthly MACD of
+   //                DEFAULTNUMSYMBOLS synthetic stocks in one pass of a
+   //                TimeframeAnalyzer, against resampling each timeframe's
+   //                closes for a StockAnalyzer, and reports the speedup
+   // Constraints : Throws an exception if a MACD or slope differs from the
+   //                resampled one
+   //***************************************************************************
+   void benchmarkTimeframes();
+
+   //***************************************************************************
+   // Function    : runBenchmark
+   // Description : Runs the named benchmark, or all of them for "all"
+   //                Returns false if the name is unknown
+   // Constraints : None
+   //***************************************************************************
+   bool runBenchmark(const string& benchmarkName);
+
+   //***************************************************************************
+   // Function    : runSharedRankingReader
+   // Description : Reads the shared ranking of the segment name until its
+   //                writer closes it, and writes the reads, retries, torn
+   //                reads, and latencies to the result file
+   // Constraints : Throws an exception if the ranking can't be mapped or
+   //                the result file can't be written
+   //***************************************************************************
+   static void runSharedRankingReader(
+      const string& segmentName,
+      const string& resultFileName);
+
+   //***************************************************************************
+   // Function    : setProgramPath
+   // Description : Sets the path of this program, which benchmarks start
+   //                child processes of
+   // Constraints : None
+   //***************************************************************************
+   inline void setProgramPath(const string& programPath);
+
+   static const int DEFAULTNUMBARS    = 2520; // 10 years of daily bars
+   static const int DEFAULTNUMSYMBOLS = 1000; // Symbols per benchmark
+   static const int DEFAULTNUMREPS    = 20;   // Repetitions of timed loops
+
+   static const int       SOAKNUMSYMBOLS = 100000;      // Streamed symbols
+   static const long long SOAKNUMUPDATES = 1000000000LL; // Updates per soak
+   static const int       SOAKNUMSAMPLES = 10;          // RSS samples
+   static const int       BOUNDEDCHANGEDPERIODS = 50;   // Slow period set
+                                                        // once bounded
+
+   static const int       TICKNUMSYMBOLS = 10000;    // Symbols in the feed
+   static const int       TICKNUMTICKS   = 10000000; // Ticks replayed
+   static const long long TICKMICROS     = 10;       // Feed time between ticks
+   static const long long TICKBARMICROS  = 1000000;  // One second bars
+
+   static const int       METRICSNUMTIMERS = 10000000; // Timers per sample
+
+   static const int       ALLOCATIONSPERSYMBOL      = 4;   // Budget of an
+                                                           // analysis
+   static const int       ALLOCATIONNUMFILES        = 100; // Files parsed
+   static const int       PARSEALLOCATIONSPERSYMBOL = 100; // Budget of a
+                                                           // parsed one
+
+   static const int       CALENDARLISTINGDAYS = 250;      // Latest listing
+   static const int       CALENDARHALTPERIOD  = 97;       // Days between halts
+   static const int       CALENDARNUMPARSES   = 10000000; // Dates parsed
+
+   static const int       CORRELATIONNUMRETURNS = 252; // A year of returns
+
+   static const int       SLOPENUMBARS = 4000000; // Bars streamed per window
+
+   static const int       SCREENERNUMSYMBOLS = 1000000; // Symbols screened
+
+   static const int       PACKNUMSYMBOLS = 100000; // Stock data files packed
+   static const int       PACKNUMBARS    = 252;    // A year of daily bars
+
+   static const int       STREAMNUMSYMBOLS  = 4000;  // Symbols streamed
+   static const int       STREAMNUMBARS     = 2520;  // 10 years of daily bars
+   static const long long STREAMBUDGETBYTES = 64LL * 1024 * 1024; // Memory
+                                                     // over what is in use
+
+   static const int       RANGENUMQUERIES = 100000; // Ranges of each length
+
+   static const int       CROSSOVERNUMREPS = 10; // Detections per thread count
+
+   static const int       ALERTNUMPERPRODUCER = 1000000; // Alerts published
+   static const int       ALERTNUMSYMBOLS     = 1000;    // Symbols in the feed
+   static const int       ALERTNUMTICKS       = 4000000; // Ticks replayed
+   static const long long ALERTBARMICROS      = 100000;  // Tenth second bars
+   static const int       ALERTREPLAYSPEED    = 10;      // Paced replay
+
+   static const int       TIMEFRAMENUMREPS = 5; // Analyses of the universe
+
+   static const int       SNAPSHOTNUMSYMBOLS = 100000; // Symbols restored
+   static const int       SNAPSHOTNUMBARS    = 2520;   // 10 years of daily bars
+   static const int       SNAPSHOTNUMUPDATES = 10;     // Checked after restore
+
+   static const int       RANKINGNUMSYMBOLS   = 10000;   // Symbols ranked
+   static const int       RANKINGNUMBARS      = 260;     // Warm up prices
+   static const int       RANKINGNUMTOPSTOCKS = 10;      // Read per query
+   static const int       RANKINGNUMREADERS   = 4;       // Query threads
+   static const int       RANKINGNUMWRITERS   = 2;       // Update threads
+   static const long long RANKINGNUMUPDATES   = 4000000; // Prices, all writers
+   static const int       RANKINGBATCHUPDATES = 1000;    // Per publish
+
+   static const int       SHAREDNUMSYMBOLS    = 10000; // Symbols published
+   static const int       SHAREDNUMTOPSTOCKS  = 10;    // Top symbols published
+   static const int       SHAREDNUMREADERS    = 4;     // Reader processes
+   static const int       SHAREDNUMPUBLISHES  = 4000;  // Batches published
+   static const int       SHAREDBATCHUPDATES  = 100;   // Prices per publish
+   static const int       SHAREDPUBLISHMICROS = 500;   // Between publishes
+   static const int       SHAREDATTACHMILLIS  = 500;   // For readers to map
+   static const int       SHAREDSAMPLEREADS   = 64;    // Reads per sample
+
+private:
+   //***************************************************************************
+   // Function    : benchmarkPricePolicy
+   // Description : Runs the kernels of one policy over the universe
+   //                Fills the current MACD, MACD slope, and slow EMAs of every
+   //                symbol, the kernel time, and the bytes per symbol
+   // Constraints : None
+   //***************************************************************************
+   template <class PricePolicy>
+   void benchmarkPricePolicy(
+      const vector< vector<double> >& universe,
+      vector<double>& currentMACDs,
+      vector<double>& slopeMACDs,
+      vector<double>& emasSlow,
+      double& kernelSeconds,
+      int& bytesPerSymbol);
+
+   //***************************************************************************
+   // Function    : generatePortfolio
+   // Description : Sets up the portfolio with numSymbols synthetic stocks of
+   //                numBars prices, named SYN00000, SYN00001, ...
+   //                The portfolio points into stockNames
+   // Constraints : stockNames must outlive the portfolio unchanged
+   //***************************************************************************
+   void generatePortfolio(
+      const int numSymbols,
+      const int numBars,
+      vector<string>& stockNames,
+      PortfolioAnalyzer& portfolioAnalyzer);
+
+   //***************************************************************************
+   // Function    : generateUniverse
+   // Description : Generates numSymbols synthetic price lists of numBars
+   // Constraints : None
+   //***************************************************************************
+   void generateUniverse(
+      const int numSymbols,
+      const int numBars,
+      vector< vector<double> >& universe);
+
+   string programPath; // Of this program, for child processes
+}; // end class PortfolioBenchmark
+
+//******************************************************************************
+// Function : setProgramPath
+// Process  : Mutator for programPath
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void PortfolioBenchmark::setProgramPath(const string& programPath)
+{
+   this->programPath = programPath;
+}
+
+#endif // PortfolioBenchmark_h
\ No newline at end of file
@@ -0,0 +1,235 @@
+//******************************************************************************
+//
+// File Name:     PricePolicy.h
+//
+// File Overview: Precision policies for price and indicator storage
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added policies
+//******************************************************************************
+
+#ifndef PricePolicy_h
+#define PricePolicy_h
+
+#include <climits>
+#include <cmath>
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Overview: A price policy decides how a price (or an indicator derived from
+//             prices) is stored per bar and which type the kernels accumulate
+//             in.  Every policy provides:
+//                StorageType          - type kept in Stock and EMA lists
+//                AccumType            - type the SMA/EMA kernels compute in
+//                toStorage(AccumType) - converts a computed value to storage
+//                toAccum(StorageType) - converts a stored value for compute
+//                getName()            - name used in benchmark reports
+//
+//           Error bounds against DoublePricePolicy, for prices p with
+//           |p| <= P, EMA multiplier a = 2 / (period + 1) and unit roundoff
+//           u = 2^-24 (float):
+//
+//             DoublePricePolicy     : baseline, today's behavior
+//
+//             FloatPricePolicy      : each stored price is off by <= u * P
+//                                       The EMA recursion is a contraction
+//                                       (weights sum to 1), so the error in
+//                                       any EMA is <= u * P * (1 + 3 / a)
+//                                       e.g. period 26, P = 100: <= 2.5e-4
+//                                       MACD and the 2 day slope are off by
+//                                       at most the sum of both EMA bounds
+//
+//             FixedCentsPricePolicy : prices with 2 decimals are exact
+//                                       (others are rounded, <= 0.005)
+//                                       Kernels accumulate in double, so only
+//                                       the stored EMA is rounded, <= 0.005
+//                                       MACD is off by <= 0.01 and the 2 day
+//                                       slope by <= 0.02
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added policies
+//
+//******************************************************************************
+
+//******************************************************************************
+//
+// Class:    DoublePricePolicy
+//
+// Overview: Stores and accumulates in double, 8 bytes per bar
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class DoublePricePolicy
+{
+public:
+   typedef double StorageType;   // Stored per bar
+   typedef double AccumType;     // Used by the kernels
+
+   //***************************************************************************
+   // Function    : getName
+   // Description : Name of the policy for reports
+   // Constraints : None
+   //***************************************************************************
+   static inline const char* getName()
+   {
+      return "double";
+   }
+
+   //***************************************************************************
+   // Function    : toAccum
+   // Description : Converts a stored value to the accumulation type
+   // Constraints : None
+   //***************************************************************************
+   static inline AccumType toAccum(const StorageType value)
+   {
+      return value;
+   }
+
+   //***************************************************************************
+   // Function    : toStorage
+   // Description : Converts a computed value to the storage type
+   // Constraints : None
+   //***************************************************************************
+   static inline StorageType toStorage(const AccumType value)
+   {
+      return value;
+   }
+}; // end class DoublePricePolicy
+
+//******************************************************************************
+//
+// Class:    FloatPricePolicy
+//
+// Overview: Stores and accumulates in float, 4 bytes per bar
+//             Halves the footprint and doubles the SIMD width
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class FloatPricePolicy
+{
+public:
+   typedef float StorageType;    // Stored per bar
+   typedef float AccumType;      // Used by the kernels
+
+   //***************************************************************************
+   // Function    : getName
+   // Description : Name of the policy for reports
+   // Constraints : None
+   //***************************************************************************
+   static inline const char* getName()
+   {
+      return "float";
+   }
+
+   //***************************************************************************
+   // Function    : toAccum
+   // Description : Converts a stored value to the accumulation type
+   // Constraints : None
+   //***************************************************************************
+   static inline AccumType toAccum(const StorageType value)
+   {
+      return value;
+   }
+
+   //***************************************************************************
+   // Function    : toStorage
+   // Description : Converts a computed value to the storage type
+   // Constraints : None
+   //***************************************************************************
+   static inline StorageType toStorage(const AccumType value)
+   {
+      return value;
+   }
+}; // end class FloatPricePolicy
+
+//******************************************************************************
+//
+// Class:    FixedCentsPricePolicy
+//
+// Overview: Stores int32 cents, 4 bytes per bar, accumulates in double
+//             The source data has 2 decimal places so prices are exact
+//             An int32 holds prices up to 21,474,836.47
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Rejects values an int32 can't hold
+//
+//******************************************************************************
+class FixedCentsPricePolicy
+{
+public:
+   typedef int    StorageType;   // Stored per bar, in cents
+   typedef double AccumType;     // Used by the kernels, in dollars
+
+   static const int CENTSPERDOLLAR = 100; // Fixed point scale
+
+   //***************************************************************************
+   // Function    : getName
+   // Description : Name of the policy for reports
+   // Constraints : None
+   //***************************************************************************
+   static inline const char* getName()
+   {
+      return "int32 cents";
+   }
+
+   //***************************************************************************
+   // Function    : toAccum
+   // Description : Converts stored cents to dollars
+   // Constraints : None
+   //***************************************************************************
+   static inline AccumType toAccum(const StorageType value)
+   {
+      return value / double(CENTSPERDOLLAR);
+   }
+
+   //***************************************************************************
+   // Function    : toStorage
+   // Description : Converts dollars to cents, rounding to the nearest cent
+   // Constraints : Throws an exception if the cents don't fit in an int32,
+   //                or value is not a number
+   //***************************************************************************
+   static inline StorageType toStorage(const AccumType value)
+   {
+      const double CENTS = floor(value * CENTSPERDOLLAR + 0.5); // Rounded
+
+      if (!(CENTS >= INT_MIN && CENTS <= INT_MAX))
+      {
+         throw exception("Price out of range for int32 cents");
+      }
+
+      return StorageType(CENTS);
+   }
+}; // end class FixedCentsPricePolicy
+
+// Policy used by Stock and StockAnalyzer, selected at build time
+// Define STOCK_PRICE_POLICY_FLOAT or STOCK_PRICE_POLICY_FIXEDCENTS to change it
+#if defined(STOCK_PRICE_POLICY_FLOAT)
+typedef FloatPricePolicy AnalyzerPricePolicy;
+#elif defined(STOCK_PRICE_POLICY_FIXEDCENTS)
+typedef FixedCentsPricePolicy AnalyzerPricePolicy;
+#else
+typedef DoublePricePolicy AnalyzerPricePolicy;
+#endif
+
+#endif // PricePolicy_h
\ No newline at end of file
@@ -0,0 +1,377 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     RangeIndex.cpp
+//
+// File Overview: Represents a RangeIndex
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+
+#include "RangeIndex.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// None
+
+//******************************************************************************
+// Function : constructor
+// Process  : No values, nothing built
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RangeIndex::RangeIndex()
+   : numMaximumValues(0),
+     numMinimumValues(0)
+{
+} // end RangeIndex::RangeIndex
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RangeIndex::~RangeIndex()
+{
+} // end RangeIndex::~RangeIndex
+
+//******************************************************************************
+// Function : checkRange
+// Process  : Check 0 <= first <= last < getNumValues
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RangeIndex::checkRange(
+   const int first,
+   const int last) const
+{
+   if (first < 0 || last < first || last >= this->getNumValues())
+   {
+      throw exception("Invalid range");
+   }
+}
+
+//******************************************************************************
+// Function : clear
+// Process  : Release the values, the prefix sums, and the sparse tables
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RangeIndex::clear()
+{
+   vector<unsigned char>().swap(this->floorLogs);
+   vector< vector<double> >().swap(this->maximums);
+   vector< vector<double> >().swap(this->minimums);
+   vector<double>().swap(this->prefixErrors);
+   vector<double>().swap(this->prefixSums);
+   vector<double>().swap(this->values);
+   this->numMaximumValues = 0;
+   this->numMinimumValues = 0;
+}
+
+//******************************************************************************
+// Function : extendSums
+// Process  : Start the prefix sums at 0, if not started, sized for the
+//                values
+//             For each value appended since, add it to the running sum with
+//                Neumaier's compensation: keep the low order bits the add
+//                rounds off, from whichever of the two is smaller
+//             Keep the sum and its compensation before each index
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RangeIndex::extendSums()
+{
+   const int NUMVALUES = this->getNumValues();
+
+   double sum   = 0.0; // Running sum
+   double error = 0.0; // Rounded off the running sum
+   double added = 0.0; // Running sum after the add
+
+   // Start the prefix sums at 0, if not started, sized for the values
+   if (this->prefixSums.empty())
+   {
+      this->prefixSums.reserve(NUMVALUES + 1);
+      this->prefixErrors.reserve(NUMVALUES + 1);
+      this->prefixSums.push_back(0.0);
+      this->prefixErrors.push_back(0.0);
+   }
+
+   sum   = this->prefixSums.back();
+   error = this->prefixErrors.back();
+
+   // Add each value appended since with Neumaier's compensation
+   for (int valueIndex = this->prefixSums.size() - 1;
+        valueIndex < NUMVALUES;
+        ++valueIndex)
+   {
+      const double VALUE = this->values[valueIndex];
+
+      added = sum + VALUE;
+
+      if (fabs(sum) >= fabs(VALUE))
+      {
+         error += (sum - added) + VALUE;
+      }
+      else
+      {
+         error += (VALUE - added) + sum;
+      }
+
+      sum = added;
+
+      this->prefixSums.push_back(sum);
+      this->prefixErrors.push_back(error);
+   }
+}
+
+//******************************************************************************
+// Function : extendTable
+// Process  : Extend floor(log2) to every range length
+//             For each level k whose 2^k values fit, add the entries of the
+//                indices the values appended since complete, each the
+//                larger (smaller) of two entries of level k - 1, sizing a
+//                new level for the values
+//             Count the values in the table
+// Notes    : Level 0 is the values themselves, so it isn't stored
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RangeIndex::extendTable(
+   vector< vector<double> >& levels,
+   int&                      numTableValues,
+   const bool                maximum)
+{
+   const int NUMVALUES = this->getNumValues();
+
+   double first  = 0.0; // Level k - 1 entry at the index
+   double second = 0.0; // Level k - 1 entry 2^(k - 1) after
+
+   // Extend floor(log2) to every range length
+   if (this->floorLogs.empty())
+   {
+      this->floorLogs.push_back(0);
+   }
+
+   for (int length = this->floorLogs.size(); length <= NUMVALUES; ++length)
+   {
+      this->floorLogs.push_back(
+         (1 == length) ? 0 : this->floorLogs[length / 2] + 1);
+   }
+
+   // For each level whose 2^k values fit, add the entries completed
+   for (int level = 1; (1 << level) <= NUMVALUES; ++level)
+   {
+      const int HALF    = 1 << (level - 1);
+      const int ENTRIES = NUMVALUES - (1 << level) + 1;
+
+      if (int(levels.size()) < level)
+      {
+         levels.push_back(vector<double>());
+      }
+
+      const vector<double>& below =
+         (1 == level) ? this->values : levels[level - 2];
+      vector<double>&       above = levels[level - 1];
+
+      // Size a new level for the values, a level extended grows as usual
+      if (above.empty())
+      {
+         above.reserve(ENTRIES);
+      }
+
+      for (int index = above.size(); index < ENTRIES; ++index)
+      {
+         first  = below[index];
+         second = below[index + HALF];
+
+         above.push_back(maximum ? max(first, second) : min(first, second));
+      }
+   }
+
+   numTableValues = NUMVALUES;
+}
+
+//******************************************************************************
+// Function : getMaximum
+// Process  : Check the range
+//             Add the values appended since to the sparse table of maximums
+//             Query the table
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double RangeIndex::getMaximum(
+   const int first,
+   const int last)
+{
+   this->checkRange(first, last);
+
+   if (last >= this->numMaximumValues)
+   {
+      this->extendTable(this->maximums, this->numMaximumValues, true);
+   }
+
+   return this->queryTable(this->maximums, true, first, last);
+}
+
+//******************************************************************************
+// Function : getMinimum
+// Process  : Check the range
+//             Add the values appended since to the sparse table of minimums
+//             Query the table
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double RangeIndex::getMinimum(
+   const int first,
+   const int last)
+{
+   this->checkRange(first, last);
+
+   if (last >= this->numMinimumValues)
+   {
+      this->extendTable(this->minimums, this->numMinimumValues, false);
+   }
+
+   return this->queryTable(this->minimums, false, first, last);
+}
+
+//******************************************************************************
+// Function : getStorageBytes
+// Process  : Add the bytes of the values, the prefix sums, floor(log2), and
+//             every level of both sparse tables
+// Notes    : Counts reserved capacity, not just the used size
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int RangeIndex::getStorageBytes() const
+{
+   int bytes = 0; // Of every part
+
+   bytes += (this->values.capacity() + this->prefixSums.capacity() +
+             this->prefixErrors.capacity()) * sizeof(double);
+   bytes += this->floorLogs.capacity() * sizeof(unsigned char);
+
+   for (size_t level = 0; level < this->maximums.size(); ++level)
+   {
+      bytes += this->maximums[level].capacity() * sizeof(double);
+   }
+
+   for (size_t level = 0; level < this->minimums.size(); ++level)
+   {
+      bytes += this->minimums[level].capacity() * sizeof(double);
+   }
+
+   return bytes;
+}
+
+//******************************************************************************
+// Function : getSum
+// Process  : Check the range
+//             Add the values appended since to the prefix sums
+//             The difference of the prefix sums after last and before first,
+//                plus the difference of their compensations
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double RangeIndex::getSum(
+   const int first,
+   const int last)
+{
+   this->checkRange(first, last);
+
+   if (last + 1 >= int(this->prefixSums.size()))
+   {
+      this->extendSums();
+   }
+
+   return (this->prefixSums[last + 1] - this->prefixSums[first]) +
+          (this->prefixErrors[last + 1] - this->prefixErrors[first]);
+}
+
+//******************************************************************************
+// Function : queryTable
+// Process  : Take the level k of the largest power of 2 in the range length
+//             The two entries of the level from first and ending at last
+//                cover the range, overlapping in the middle
+// Notes    : A range of one value is the value
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double RangeIndex::queryTable(
+   const vector< vector<double> >& levels,
+   const bool                      maximum,
+   const int                       first,
+   const int                       last) const
+{
+   const int LEVEL = this->floorLogs[last - first + 1];
+
+   double fromFirst = 0.0; // Entry of the 2^k values from first
+   double toLast    = 0.0; // Entry of the 2^k values ending at last
+
+   if (0 == LEVEL)
+   {
+      return this->values[first];
+   }
+
+   fromFirst = levels[LEVEL - 1][first];
+   toLast    = levels[LEVEL - 1][last - (1 << LEVEL) + 1];
+
+   return maximum ? max(fromFirst, toLast) : min(fromFirst, toLast);
+}
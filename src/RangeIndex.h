@@ -0,0 +1,239 @@
+//******************************************************************************
+//
+// File Name:     RangeIndex.h
+//
+// File Overview: Represents a RangeIndex
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef RangeIndex_h
+#define RangeIndex_h
+
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    RangeIndex
+//
+// Overview: Answers the sum, mean, minimum, and maximum of any range of a
+//             series of values in O(1), instead of rescanning the range
+//             Prefix sums answer the sum and mean: the sum of the values
+//                before each index, kept with its Neumaier compensation so
+//                the rounding of a long series doesn't accumulate
+//             Sparse tables answer the minimum and maximum: level k holds
+//                the minimum (maximum) of the 2^k values from each index, so
+//                any range is covered by two overlapping entries of a level
+//             Each part is built on the first query that needs it, and
+//                values appended after are added to it by the next such
+//                query, O(1) amortized per value for the sums and O(log n)
+//                for each table
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class RangeIndex
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No values
+   // Constraints : None
+   //***************************************************************************
+   RangeIndex();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~RangeIndex();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : append
+   // Description : Adds the newest value, indexed by the next query
+   // Constraints : None
+   //***************************************************************************
+   inline void append(const double value);
+
+   //***************************************************************************
+   // Function    : clear
+   // Description : Forgets the values and everything built from them
+   // Constraints : None
+   //***************************************************************************
+   void clear();
+
+   //***************************************************************************
+   // Function    : getMaximum, getMinimum
+   // Description : Retrieves the largest (smallest) of the values at first
+   //                through last
+   //                Builds or extends the sparse table of maximums (minimums)
+   // Constraints : Throws an exception unless
+   //                0 <= first <= last < getNumValues
+   //***************************************************************************
+   double getMaximum(
+      const int first,
+      const int last);
+   double getMinimum(
+      const int first,
+      const int last);
+
+   //***************************************************************************
+   // Function    : getMean
+   // Description : Retrieves the mean of the values at first through last
+   //                Builds or extends the prefix sums
+   // Constraints : Throws an exception unless
+   //                0 <= first <= last < getNumValues
+   //***************************************************************************
+   inline double getMean(
+      const int first,
+      const int last);
+
+   //***************************************************************************
+   // Function    : getNumValues
+   // Description : Retrieves the number of values appended
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumValues() const;
+
+   //***************************************************************************
+   // Function    : getStorageBytes
+   // Description : Retrieves the number of bytes used by the values, the
+   //                prefix sums, and the sparse tables built so far
+   // Constraints : None
+   //***************************************************************************
+   int getStorageBytes() const;
+
+   //***************************************************************************
+   // Function    : getSum
+   // Description : Retrieves the sum of the values at first through last
+   //                Builds or extends the prefix sums
+   // Constraints : Throws an exception unless
+   //                0 <= first <= last < getNumValues
+   //***************************************************************************
+   double getSum(
+      const int first,
+      const int last);
+
+private:
+
+   //***************************************************************************
+   // Function    : checkRange
+   // Description : Checks 0 <= first <= last < getNumValues
+   // Constraints : Throws an exception for an invalid range
+   //***************************************************************************
+   void checkRange(
+      const int first,
+      const int last) const;
+
+   //***************************************************************************
+   // Function    : extendSums
+   // Description : Adds the values appended since to the prefix sums
+   // Constraints : None
+   //***************************************************************************
+   void extendSums();
+
+   //***************************************************************************
+   // Function    : extendTable
+   // Description : Adds the values appended since to the sparse table of
+   //                maximums if maximum, else of minimums, and counts them
+   //                in numTableValues
+   // Constraints : None
+   //***************************************************************************
+   void extendTable(
+      vector< vector<double> >& levels,
+      int& numTableValues,
+      const bool maximum);
+
+   //***************************************************************************
+   // Function    : queryTable
+   // Description : Retrieves the extreme of first through last from the
+   //                sparse table, the larger of two entries if maximum, else
+   //                the smaller
+   // Constraints : The table must cover last
+   //***************************************************************************
+   double queryTable(
+      const vector< vector<double> >& levels,
+      const bool maximum,
+      const int first,
+      const int last) const;
+
+   vector<unsigned char>    floorLogs;        // floor(log2(length)) of
+                                              // each range length
+   vector< vector<double> > maximums;         // Level k - 1, maximum of
+                                              // the 2^k values from each
+                                              // index
+   vector< vector<double> > minimums;         // Level k - 1, minimum of
+                                              // the 2^k values from each
+                                              // index
+   int                      numMaximumValues; // Values in maximums
+   int                      numMinimumValues; // Values in minimums
+   vector<double>           prefixErrors;     // Neumaier compensation of
+                                              // each prefix sum
+   vector<double>           prefixSums;       // Sum of the values before
+                                              // each index, 0 first
+   vector<double>           values;           // Oldest first, level 0 of
+                                              // both sparse tables
+}; // end class RangeIndex
+
+//******************************************************************************
+// Function : append
+// Process  : Add to our list of values
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void RangeIndex::append(const double value)
+{
+   this->values.push_back(value);
+}
+
+//******************************************************************************
+// Function : getMean
+// Process  : The sum / the number of values
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double RangeIndex::getMean(
+   const int first,
+   const int last)
+{
+   return this->getSum(first, last) / (last - first + 1);
+}
+
+//******************************************************************************
+// Function : getNumValues
+// Process  : Retrieve the number of values
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RangeIndex::getNumValues() const
+{
+   return this->values.size();
+}
+
+#endif // RangeIndex_h
@@ -0,0 +1,374 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     RankingPublisher.cpp
+//
+// File Overview: Represents a RankingPublisher
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Moved RankingSlopeGreater to the header
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+
+#include "RankingPublisher.h"
+
+//******************************************************************************
+// Function : constructor
+// Process  : Zero every summary, version 0, none ranked
+// Notes    : The summaries are value initialized, so zeroed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RankingSnapshot::RankingSnapshot(const int numSymbols)
+   : numPrices(0),
+     summaries(max(0, numSymbols)),
+     version(0)
+{
+} // end RankingSnapshot::RankingSnapshot
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RankingSnapshot::~RankingSnapshot()
+{
+} // end RankingSnapshot::~RankingSnapshot
+
+//******************************************************************************
+// Function : rank
+// Process  : List every symbol index
+//             Sort the highest numTopStocks ranking slopes to the front
+//             Keep only those
+// Notes    : O(n log numTopStocks)
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RankingSnapshot::rank(const int numTopStocks)
+{
+   const int NUMSYMBOLS = this->getNumSymbols();
+   const int NUMTOP     = max(0, min(numTopStocks, NUMSYMBOLS));
+
+   // List every symbol index
+   this->topIndices.resize(NUMSYMBOLS);
+
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      this->topIndices[symbolIndex] = symbolIndex;
+   }
+
+   // Sort the highest numTopStocks ranking slopes to the front
+   partial_sort(this->topIndices.begin(),
+                this->topIndices.begin() + NUMTOP,
+                this->topIndices.end(),
+                RankingSlopeGreater(this->summaries));
+
+   // Keep only those
+   this->topIndices.resize(NUMTOP);
+}
+
+//******************************************************************************
+// Function : setSummaryAt
+// Process  : Take the old summary's prices off numPrices, add the new one's
+//             Replace the summary
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RankingSnapshot::setSummaryAt(
+   const int symbolIndex,
+   const RankingSummary& summary)
+{
+   RankingSummary& oldSummary = this->summaries.at(symbolIndex);
+
+   this->numPrices += summary.numPrices - oldSummary.numPrices;
+   oldSummary       = summary;
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Check the sizes
+//             Clear every reader slot
+//             Publish an empty version 0
+// Notes    : Throws an exception unless every size is positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RankingPublisher::RankingPublisher(
+   const int numSymbols,
+   const int numTopStocks,
+   const int maxReaders)
+   : readerSlots(max(0, maxReaders)),
+     latest(NULL),
+     epoch(1),
+     numSymbols(numSymbols),
+     numTopStocks(numTopStocks),
+     numPublished(0),
+     numReclaimed(0)
+{
+   // Check the sizes
+   if (numSymbols < 1 || numTopStocks < 1 || maxReaders < 1)
+   {
+      throw exception("Invalid ranking publisher size");
+   }
+
+   // Clear every reader slot
+   for (size_t readerIndex = 0;
+        readerIndex < this->readerSlots.size();
+        ++readerIndex)
+   {
+      this->readerSlots[readerIndex].epoch.store(0);
+   }
+
+   // Publish an empty version 0
+   this->latest.store(new RankingSnapshot(numSymbols));
+} // end RankingPublisher::RankingPublisher
+
+//******************************************************************************
+// Function : destructor
+// Process  : Free the latest snapshot and every retired one
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RankingPublisher::~RankingPublisher()
+{
+   delete this->latest.load();
+
+   for (size_t retiredIndex = 0;
+        retiredIndex < this->retired.size();
+        ++retiredIndex)
+   {
+      delete this->retired[retiredIndex].snapshot;
+   }
+} // end RankingPublisher::~RankingPublisher
+
+//******************************************************************************
+// Function : publish
+// Process  : Swap in the snapshot
+//             Move the epoch on, the replaced snapshot is retired at the new
+//                epoch
+//             Find the oldest epoch a reader entered at
+//             Free every retired snapshot retired at or before it, keep the
+//                rest
+// Notes    : A reader at an older epoch may have loaded the replaced
+//             snapshot, a reader at the new epoch or later read the epoch
+//             after the swap, so loaded the new snapshot or a newer one
+//             With no readers, every retired snapshot is freed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RankingPublisher::publish(RankingSnapshot* snapshot)
+{
+   RetiredSnapshot    replaced;                  // By the snapshot
+   unsigned long long oldestEpoch = ~0ULL;       // Of the busy readers
+   size_t             numKept     = 0;           // Retired, still held
+
+   // Swap in the snapshot
+   replaced.snapshot = this->latest.exchange(snapshot);
+   ++this->numPublished;
+
+   // Move the epoch on, the replaced snapshot is retired at the new epoch
+   replaced.epoch = this->epoch.fetch_add(1) + 1;
+   this->retired.push_back(replaced);
+
+   // Find the oldest epoch a reader entered at
+   for (size_t readerIndex = 0;
+        readerIndex < this->readerSlots.size();
+        ++readerIndex)
+   {
+      unsigned long long readerEpoch =
+         this->readerSlots[readerIndex].epoch.load();
+
+      if (0 != readerEpoch)
+      {
+         oldestEpoch = min(oldestEpoch, readerEpoch);
+      }
+   }
+
+   // Free every retired snapshot retired at or before it, keep the rest
+   for (size_t retiredIndex = 0;
+        retiredIndex < this->retired.size();
+        ++retiredIndex)
+   {
+      if (this->retired[retiredIndex].epoch <= oldestEpoch)
+      {
+         delete this->retired[retiredIndex].snapshot;
+         ++this->numReclaimed;
+      }
+      else
+      {
+         this->retired[numKept++] = this->retired[retiredIndex];
+      }
+   }
+
+   this->retired.resize(numKept);
+}
+
+//******************************************************************************
+// Function : publishPortfolio
+// Process  : Check the portfolio's size
+//             Summarize every stock analyzer
+//             Update every symbol
+// Notes    : Throws an exception unless the portfolio has numSymbols stock
+//             analyzers
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RankingPublisher::publishPortfolio(
+   const PortfolioAnalyzer& portfolioAnalyzer)
+{
+   vector<int>            symbolIndices(this->numSymbols); // Every symbol
+   vector<RankingSummary> summaries(this->numSymbols);     // Of each
+
+   // Check the portfolio's size
+   if (portfolioAnalyzer.getNumStockAnalyzers() != this->numSymbols)
+   {
+      throw exception("Portfolio doesn't match the ranking publisher");
+   }
+
+   // Summarize every stock analyzer
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      symbolIndices[symbolIndex] = symbolIndex;
+      RankingPublisher::summarizeAnalyzer(
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(symbolIndex),
+         portfolioAnalyzer.getPeriodsSlope(),
+         summaries[symbolIndex]);
+   }
+
+   // Update every symbol
+   this->update(symbolIndices, summaries);
+}
+
+//******************************************************************************
+// Function : summarizeAnalyzer
+// Process  : Copy the MACDs, slopes, EMAs, signal, and the latest price
+//             The ranking slope is the regression slope when periodsSlope
+//                is set, as PortfolioAnalyzer::getRankingSlopeAtIndex
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Copies the signal
+//******************************************************************************
+void RankingPublisher::summarizeAnalyzer(
+   const StockAnalyzer& stockAnalyzer,
+   const int periodsSlope,
+   RankingSummary& summary)
+{
+   const int NUMPRICES = stockAnalyzer.getNumStockPrices();
+
+   // Copy the MACDs, slopes, EMAs, signal, and the latest price
+   summary.currentMACD    = stockAnalyzer.getCurrentMACD();
+   summary.yesterdayMACD  = stockAnalyzer.getYesterdayMACD();
+   summary.slopeMACD      = stockAnalyzer.getSlopeMACD();
+   summary.currentEMAFast = stockAnalyzer.getCurrentEMAFast();
+   summary.currentEMASlow = stockAnalyzer.getCurrentEMASlow();
+   summary.signalMACD     = stockAnalyzer.getSignalMACD();
+   summary.hasSignalMACD  = stockAnalyzer.hasSignalMACD();
+   summary.lastClose      = (NUMPRICES > 0) ?
+      stockAnalyzer.getStockPriceAtIndex(NUMPRICES - 1) : 0.0;
+   summary.numPrices      = NUMPRICES;
+
+   // The ranking slope is the regression slope when periodsSlope is set
+   summary.rankingSlope   = (periodsSlope > 0) ?
+      stockAnalyzer.getRegressionSlopeMACD() : stockAnalyzer.getSlopeMACD();
+}
+
+//******************************************************************************
+// Function : update
+// Process  : Check the lists
+//             Copy the latest snapshot, only writers replace it and they
+//                hold writerMutex
+//             Replace the summaries, rank, and number the copy
+//             Publish it
+// Notes    : Throws an exception if a symbol index is invalid or the lists
+//             differ in size, nothing is published
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RankingPublisher::update(
+   const vector<int>& symbolIndices,
+   const vector<RankingSummary>& summaries)
+{
+   RankingSnapshot* snapshot = NULL; // Copy being built
+
+   // Check the lists
+   if (symbolIndices.size() != summaries.size())
+   {
+      throw exception("Invalid ranking update");
+   }
+
+   for (size_t updateIndex = 0;
+        updateIndex < symbolIndices.size();
+        ++updateIndex)
+   {
+      if (symbolIndices[updateIndex] < 0 ||
+          symbolIndices[updateIndex] >= this->numSymbols)
+      {
+         throw exception("Invalid ranking update");
+      }
+   }
+
+   lock_guard<mutex> lock(this->writerMutex);
+
+   // Copy the latest snapshot
+   snapshot = new RankingSnapshot(*this->latest.load());
+
+   // Replace the summaries, rank, and number the copy
+   for (size_t updateIndex = 0;
+        updateIndex < symbolIndices.size();
+        ++updateIndex)
+   {
+      snapshot->setSummaryAt(
+         symbolIndices[updateIndex], summaries[updateIndex]);
+   }
+
+   snapshot->rank(this->numTopStocks);
+   snapshot->setVersion(snapshot->getVersion() + 1);
+
+   // Publish it
+   this->publish(snapshot);
+}
@@ -0,0 +1,570 @@
+//******************************************************************************
+//
+// File Name:     RankingPublisher.h
+//
+// File Overview: Represents a RankingPublisher
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Exposes RankingSlopeGreater
+//******************************************************************************
+
+#ifndef RankingPublisher_h
+#define RankingPublisher_h
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "PortfolioAnalyzer.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    RankingSummary
+//
+// Overview: What a query needs of one symbol's analysis, copied out of its
+//             StockAnalyzer so readers never touch the analyzer
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the signal
+//
+//******************************************************************************
+struct RankingSummary
+{
+   double    currentMACD;    // MACD of the latest price
+   double    yesterdayMACD;  // MACD of the price before
+   double    slopeMACD;      // Two day MACD slope
+   double    rankingSlope;   // Slope the symbol is ranked by, see
+                             // PortfolioAnalyzer::getRankingSlopeAtIndex
+   double    currentEMAFast; // Of the latest price
+   double    currentEMASlow; // Of the latest price
+   double    lastClose;      // Latest price, 0 for none
+   double    signalMACD;     // Signal EMA of the MACD, see
+                             // StockAnalyzer::getSignalMACD
+   long long numPrices;      // Ever added
+   bool      hasSignalMACD;  // Signal has its periods of MACDs?
+}; // end struct RankingSummary
+
+//******************************************************************************
+//
+// Class:    RankingSlopeGreater
+//
+// Overview: Orders symbol indices by the ranking slope of their summaries,
+//             highest first
+//             Equal slopes keep their index order, matching
+//             PortfolioAnalyzer::getTopStocksByMACDSlope
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Shared with SharedRankingWriter
+//
+//******************************************************************************
+class RankingSlopeGreater
+{
+public:
+   explicit RankingSlopeGreater(const vector<RankingSummary>& summaries)
+      : summaries(summaries)
+   {
+   }
+
+   bool operator()(const int leftIndex, const int rightIndex) const
+   {
+      double leftSlope  = this->summaries[leftIndex].rankingSlope;
+      double rightSlope = this->summaries[rightIndex].rankingSlope;
+
+      if (leftSlope != rightSlope)
+      {
+         return leftSlope > rightSlope;
+      }
+
+      return leftIndex < rightIndex;
+   }
+
+private:
+   const vector<RankingSummary>& summaries; // Of each symbol
+}; // end class RankingSlopeGreater
+
+//******************************************************************************
+//
+// Class:    RankingSnapshot
+//
+// Overview: The summary of every symbol and the top symbols by ranking
+//             slope, as of one version
+//             Built by a RankingPublisher, and never changed once published
+//             Equal slopes are ranked by symbol index, as
+//                PortfolioAnalyzer::getTopStocksByMACDSlope ranks them
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class RankingSnapshot
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Version 0 of numSymbols zeroed summaries, none ranked
+   // Constraints : None
+   //***************************************************************************
+   explicit RankingSnapshot(const int numSymbols = 0);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~RankingSnapshot();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getNumPrices
+   // Description : Retrieve the sum of every summary's numPrices
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumPrices() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the number of summaries
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumTopStocks
+   // Description : Retrieve the number of symbols ranked
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumTopStocks() const;
+
+   //***************************************************************************
+   // Function    : getSummaryAt
+   // Description : Retrieves the summary of the symbol at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const RankingSummary& getSummaryAt(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getTopIndexAtRank
+   // Description : Retrieves the symbol index at the rank, 0 is the highest
+   //                ranking slope
+   // Constraints : Throws an out_of_range exception for invalid rank
+   //***************************************************************************
+   inline int getTopIndexAtRank(const int rank) const;
+
+   //***************************************************************************
+   // Function    : getVersion
+   // Description : Accessor for version, one more for each publish
+   // Constraints : None
+   //***************************************************************************
+   inline long long getVersion() const;
+
+   //***************************************************************************
+   // Function    : rank
+   // Description : Ranks the top numTopStocks symbols by ranking slope
+   // Constraints : None
+   //***************************************************************************
+   void rank(const int numTopStocks);
+
+   //***************************************************************************
+   // Function    : setSummaryAt
+   // Description : Replaces the summary of the symbol at the index
+   //                The ranking is stale until rank
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   void setSummaryAt(
+      const int symbolIndex,
+      const RankingSummary& summary);
+
+   //***************************************************************************
+   // Function    : setVersion
+   // Description : Mutator for version
+   // Constraints : None
+   //***************************************************************************
+   inline void setVersion(const long long version);
+
+private:
+   long long              numPrices;  // Sum of every summary's numPrices
+   vector<RankingSummary> summaries;  // Of each symbol
+   vector<int>            topIndices; // Symbol indices, highest slope first
+   long long              version;    // Of the publish
+}; // end class RankingSnapshot
+
+//******************************************************************************
+//
+// Class:    RankingPublisher
+//
+// Overview: Publishes RankingSnapshots for query threads to read while
+//             update threads keep advancing their StockAnalyzers
+//             Read, copy, update: a writer copies the latest snapshot,
+//                replaces the summaries it has new analysis for, ranks the
+//                copy, and swaps it in with one atomic store
+//             Readers load the latest snapshot without locking or waiting,
+//                and only ever see a whole snapshot
+//             A replaced snapshot is freed once no reader can still hold
+//                it, by epochs: a reader records the global epoch in its
+//                own slot before loading the snapshot and clears it after,
+//                and each publish moves the epoch on, so a snapshot retired
+//                at epoch E is safe once every busy slot is at E or later
+//             Writers are serialized by a mutex, so update threads wait
+//                for each other's copies, never for readers
+//             Each reader thread has its own slot, on its own cache line
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class RankingPublisher
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Publishes an empty version 0 of numSymbols symbols,
+   //                ranking the top numTopStocks, for up to maxReaders
+   //                reader threads
+   // Constraints : Throws an exception unless every size is positive
+   //***************************************************************************
+   RankingPublisher(
+      const int numSymbols,
+      const int numTopStocks,
+      const int maxReaders);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Frees every snapshot
+   // Constraints : No reader may be between beginRead and endRead
+   //***************************************************************************
+   virtual ~RankingPublisher();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : beginRead
+   // Description : Retrieve the latest snapshot, which stays valid until
+   //                endRead
+   // Constraints : One thread per readerIndex, no nested reads
+   //                Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const RankingSnapshot* beginRead(const int readerIndex);
+
+   //***************************************************************************
+   // Function    : endRead
+   // Description : Lets the snapshot from beginRead be freed
+   // Constraints : The reader of the matching beginRead
+   //***************************************************************************
+   inline void endRead(const int readerIndex);
+
+   //***************************************************************************
+   // Function    : getMaxReaders
+   // Description : Retrieve the number of reader slots
+   // Constraints : None
+   //***************************************************************************
+   inline int getMaxReaders() const;
+
+   //***************************************************************************
+   // Function    : getNumPublished, getNumReclaimed
+   // Description : Retrieve the snapshots published, and of those replaced,
+   //                the snapshots freed
+   // Constraints : Once the writers are done
+   //***************************************************************************
+   inline long long getNumPublished() const;
+   inline long long getNumReclaimed() const;
+
+   //***************************************************************************
+   // Function    : publishPortfolio
+   // Description : Publishes the summary of every stock of the portfolio,
+   //                by analyzer index
+   // Constraints : The portfolio's analyzers must not be updated meanwhile
+   //                Throws an exception unless the portfolio has numSymbols
+   //                stock analyzers
+   //***************************************************************************
+   void publishPortfolio(const PortfolioAnalyzer& portfolioAnalyzer);
+
+   //***************************************************************************
+   // Function    : summarizeAnalyzer
+   // Description : Copies the analysis of the stock analyzer to the summary,
+   //                ranked by the regression slope of MACD when periodsSlope
+   //                is set, otherwise by the MACD slope
+   // Constraints : None
+   //***************************************************************************
+   static void summarizeAnalyzer(
+      const StockAnalyzer& stockAnalyzer,
+      const int periodsSlope,
+      RankingSummary& summary);
+
+   //***************************************************************************
+   // Function    : update
+   // Description : Publishes a copy of the latest snapshot with the
+   //                summaries of the symbol indices replaced and ranked
+   // Constraints : Any writer thread
+   //                Throws an exception if a symbol index is invalid or the
+   //                lists differ in size
+   //***************************************************************************
+   void update(
+      const vector<int>& symbolIndices,
+      const vector<RankingSummary>& summaries);
+
+   static const int CACHELINEBYTES = 64; // Keeps reader slots apart
+
+private:
+   //***************************************************************************
+   //
+   // Class:    ReaderSlot
+   //
+   // Overview: The epoch a reader entered at, 0 while not reading
+   //
+   //***************************************************************************
+   struct ReaderSlot
+   {
+      atomic<unsigned long long> epoch;   // At beginRead, 0 after endRead
+      char                       padding[CACHELINEBYTES -
+                                         sizeof(atomic<unsigned long long>)];
+   }; // end struct ReaderSlot
+
+   //***************************************************************************
+   //
+   // Class:    RetiredSnapshot
+   //
+   // Overview: A replaced snapshot and the epoch it was replaced at
+   //
+   //***************************************************************************
+   struct RetiredSnapshot
+   {
+      RankingSnapshot*   snapshot; // No longer the latest
+      unsigned long long epoch;    // Readers at or after it can't hold it
+   }; // end struct RetiredSnapshot
+
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its snapshots
+   // Constraints : None
+   //***************************************************************************
+   RankingPublisher(const RankingPublisher&);
+   RankingPublisher& operator=(const RankingPublisher&);
+
+   //***************************************************************************
+   // Function    : publish
+   // Description : Swaps in the snapshot, retires the one it replaces, and
+   //                frees every retired snapshot no reader can hold
+   // Constraints : Holding writerMutex
+   //***************************************************************************
+   void publish(RankingSnapshot* snapshot);
+
+   vector<ReaderSlot>         readerSlots;     // One per reader thread
+   atomic<RankingSnapshot*>   latest;          // Published, read by readers
+   atomic<unsigned long long> epoch;           // Moved on by each publish
+   mutex                      writerMutex;     // Serializes the writers
+   vector<RetiredSnapshot>    retired;         // Replaced, not yet freed
+   int                        numSymbols;      // Summaries per snapshot
+   int                        numTopStocks;    // Ranked per snapshot
+   long long                  numPublished;    // Snapshots published
+   long long                  numReclaimed;    // Retired snapshots freed
+}; // end class RankingPublisher
+
+//******************************************************************************
+// Function : getNumPrices
+// Process  : Accessor for numPrices
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long RankingSnapshot::getNumPrices() const
+{
+   return this->numPrices;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : The number of summaries
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RankingSnapshot::getNumSymbols() const
+{
+   return this->summaries.size();
+}
+
+//******************************************************************************
+// Function : getNumTopStocks
+// Process  : The number of top indices
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RankingSnapshot::getNumTopStocks() const
+{
+   return this->topIndices.size();
+}
+
+//******************************************************************************
+// Function : getSummaryAt
+// Process  : The summary at the symbol index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const RankingSummary& RankingSnapshot::getSummaryAt(
+   const int symbolIndex) const
+{
+   return this->summaries.at(symbolIndex);
+}
+
+//******************************************************************************
+// Function : getTopIndexAtRank
+// Process  : The top index at the rank
+// Notes    : Throws an out_of_range exception for invalid rank
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RankingSnapshot::getTopIndexAtRank(const int rank) const
+{
+   return this->topIndices.at(rank);
+}
+
+//******************************************************************************
+// Function : getVersion
+// Process  : Accessor for version
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long RankingSnapshot::getVersion() const
+{
+   return this->version;
+}
+
+//******************************************************************************
+// Function : setVersion
+// Process  : Mutator for version
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void RankingSnapshot::setVersion(const long long version)
+{
+   this->version = version;
+}
+
+//******************************************************************************
+// Function : beginRead
+// Process  : Record the global epoch in the reader's slot
+//             Load the latest snapshot
+// Notes    : Sequentially consistent, so a writer that finds the slot
+//             clear published before the slot was set, and the snapshot
+//             loaded is that one or newer, see publish
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const RankingSnapshot* RankingPublisher::beginRead(
+   const int readerIndex)
+{
+   this->readerSlots.at(readerIndex).epoch.store(this->epoch.load());
+
+   return this->latest.load();
+}
+
+//******************************************************************************
+// Function : endRead
+// Process  : Clear the reader's slot
+// Notes    : Release, so the reads of the snapshot finish before a writer
+//             can see the slot clear and free it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void RankingPublisher::endRead(const int readerIndex)
+{
+   this->readerSlots[readerIndex].epoch.store(0, memory_order_release);
+}
+
+//******************************************************************************
+// Function : getMaxReaders
+// Process  : The number of reader slots
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RankingPublisher::getMaxReaders() const
+{
+   return this->readerSlots.size();
+}
+
+//******************************************************************************
+// Function : getNumPublished
+// Process  : Accessor for numPublished
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long RankingPublisher::getNumPublished() const
+{
+   return this->numPublished;
+}
+
+//******************************************************************************
+// Function : getNumReclaimed
+// Process  : Accessor for numReclaimed
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long RankingPublisher::getNumReclaimed() const
+{
+   return this->numReclaimed;
+}
+
+#endif // RankingPublisher_h
@@ -0,0 +1,165 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     RegressionSlope.cpp
+//
+// File Overview: Represents a RegressionSlope
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added getState and setState
+//******************************************************************************
+
+#include "stdafx.h"
+#include <exception>
+
+#include "RegressionSlope.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// None
+
+//******************************************************************************
+// Function : constructor
+// Process  : Reset to the capacity
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RegressionSlope::RegressionSlope(const int capacity)
+{
+   this->reset(capacity);
+} // end RegressionSlope::RegressionSlope
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+RegressionSlope::~RegressionSlope()
+{
+} // end RegressionSlope::~RegressionSlope
+
+//******************************************************************************
+// Function : getState
+// Process  : Copy the window, oldest first, and the running sums
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RegressionSlope::getState(State& state) const
+{
+   const int SIZE = this->getSize(); // Values in the window
+
+   state.values.resize(SIZE);
+
+   for (int x = 0; x < SIZE; ++x)
+   {
+      state.values[x] = this->values.getFromNewest(SIZE - 1 - x);
+   }
+
+   state.sumXY        = this->sumXY;
+   state.sumY         = this->sumY;
+   state.numSinceSums = this->numSinceSums;
+}
+
+//******************************************************************************
+// Function : recalculateSums
+// Process  : Sum y and x * y over the window, oldest at x = 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RegressionSlope::recalculateSums()
+{
+   const int SIZE = this->getSize(); // Values in the window
+
+   this->sumXY        = 0.0;
+   this->sumY         = 0.0;
+   this->numSinceSums = 0;
+
+   for (int x = 0; x < SIZE; ++x)
+   {
+      const double Y = this->values.getFromNewest(SIZE - 1 - x);
+
+      this->sumXY += x * Y;
+      this->sumY  += Y;
+   }
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Size the window to the capacity
+//             Nothing held, the sums are 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RegressionSlope::reset(const int capacity)
+{
+   this->values.reset(capacity);
+   this->sumXY        = 0.0;
+   this->sumY         = 0.0;
+   this->numSinceSums = 0;
+}
+
+//******************************************************************************
+// Function : setState
+// Process  : Empty the window, keeping its capacity
+//             Append the state's window, oldest first
+//             Set the running sums as they were, not recalculated, so the
+//                next add rounds as it would have
+// Notes    : Throws an exception if the window is larger than the capacity,
+//                or numSinceSums is outside 0 to capacity - 1
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void RegressionSlope::setState(const State& state)
+{
+   const int CAPACITY = this->getCapacity(); // Values in a full window
+
+   if (int(state.values.size()) > CAPACITY || state.numSinceSums < 0 ||
+       (CAPACITY > 0 && state.numSinceSums >= CAPACITY))
+   {
+      throw exception("Regression slope state doesn't fit the window");
+   }
+
+   this->values.reset(CAPACITY);
+
+   for (size_t x = 0; x < state.values.size(); ++x)
+   {
+      this->values.append(state.values[x]);
+   }
+
+   this->sumXY        = state.sumXY;
+   this->sumY         = state.sumY;
+   this->numSinceSums = state.numSinceSums;
+}
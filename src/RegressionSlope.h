@@ -0,0 +1,246 @@
+//******************************************************************************
+//
+// File Name:     RegressionSlope.h
+//
+// File Overview: Represents a RegressionSlope
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added getState and setState
+//******************************************************************************
+
+#ifndef RegressionSlope_h
+#define RegressionSlope_h
+
+#include <vector>
+
+#include "RingSeries.h"
+
+//******************************************************************************
+//
+// Class:    RegressionSlope
+//
+// Overview: Least squares slope of the newest values of a series, one step
+//             of x between consecutive values
+//             Keeps the window in a RingSeries with the running sums of y
+//                and x * y, x counted from 0 at the oldest value, so add
+//                and getSlope take constant time whatever the window
+//             Once the window is full, dropping the oldest value moves every
+//                other value one step closer to x = 0, which takes the sum
+//                of y off the sum of x * y
+//             The sums are recalculated from the window every capacity adds,
+//                so rounding can't build up over a long stream, which is
+//                still constant time per add on average
+//             Used by StockAnalyzer for the regression slope of MACD
+//             getState and setState copy the window and the running sums,
+//                so a restored slope continues bit for bit
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added getState and setState
+//
+//******************************************************************************
+class RegressionSlope
+{
+public:
+
+   //***************************************************************************
+   //
+   // Class:    State
+   //
+   // Overview: The window and running sums of a RegressionSlope
+   //
+   //***************************************************************************
+   struct State
+   {
+      vector<double> values;       // The window, oldest first
+      double         sumXY;        // Sum of x * y over the window
+      double         sumY;         // Sum of y over the window
+      int            numSinceSums; // Adds since the sums were recalculated
+   }; // end struct State
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty window of the specified capacity
+   // Constraints : None
+   //***************************************************************************
+   explicit RegressionSlope(const int capacity = 0);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~RegressionSlope();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : add
+   // Description : Adds the newest value, dropping the oldest once full
+   // Constraints : Throws an exception if the capacity is 0
+   //***************************************************************************
+   inline void add(const double value);
+
+   //***************************************************************************
+   // Function    : getCapacity
+   // Description : Retrieve the number of values in a full window
+   // Constraints : None
+   //***************************************************************************
+   inline int getCapacity() const;
+
+   //***************************************************************************
+   // Function    : getSize
+   // Description : Retrieve the number of values in the window
+   // Constraints : None
+   //***************************************************************************
+   inline int getSize() const;
+
+   //***************************************************************************
+   // Function    : getState
+   // Description : Retrieves the window and the running sums
+   // Constraints : None
+   //***************************************************************************
+   void getState(State& state) const;
+
+   //***************************************************************************
+   // Function    : getSlope
+   // Description : Retrieve the least squares slope of the window
+   //                0 until it holds two values
+   // Constraints : None
+   //***************************************************************************
+   inline double getSlope() const;
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Empties the window and changes its capacity
+   // Constraints : None
+   //***************************************************************************
+   void reset(const int capacity);
+
+   //***************************************************************************
+   // Function    : setState
+   // Description : Replaces the window and running sums with those of state,
+   //                keeping the capacity
+   // Constraints : Throws an exception if the window is larger than the
+   //                capacity, or numSinceSums is outside 0 to capacity - 1
+   //***************************************************************************
+   void setState(const State& state);
+
+private:
+   //***************************************************************************
+   // Function    : recalculateSums
+   // Description : Recalculates sumY and sumXY from the window
+   // Constraints : None
+   //***************************************************************************
+   void recalculateSums();
+
+   int                numSinceSums; // Adds since the sums were recalculated
+   double             sumXY;        // Sum of x * y over the window
+   double             sumY;         // Sum of y over the window
+   RingSeries<double> values;       // The window, newest last
+}; // end class RegressionSlope
+
+//******************************************************************************
+// Function : add
+// Process  : While filling, the value is at x = size
+//             Once full, drop the oldest value, at x = 0, and move the others
+//                one step down by taking their sum off sumXY
+//                The value is at x = capacity - 1
+//             Append the value to the window
+//             Recalculate the sums every capacity adds
+// Notes    : Throws an exception if the capacity is 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void RegressionSlope::add(const double value)
+{
+   const int CAPACITY = this->getCapacity(); // Values in a full window
+   const int SIZE     = this->getSize();     // Values before this one
+
+   if (SIZE < CAPACITY)
+   {
+      this->sumXY += SIZE * value;
+      this->sumY  += value;
+   }
+   else if (CAPACITY > 0)
+   {
+      const double OLDEST = this->values.getFromNewest(CAPACITY - 1);
+
+      this->sumXY += (CAPACITY - 1) * value - (this->sumY - OLDEST);
+      this->sumY  += value - OLDEST;
+   }
+
+   this->values.append(value);
+
+   if (++this->numSinceSums == CAPACITY)
+   {
+      this->recalculateSums();
+   }
+}
+
+//******************************************************************************
+// Function : getCapacity
+// Process  : Retrieve the capacity of the window
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RegressionSlope::getCapacity() const
+{
+   return this->values.getCapacity();
+}
+
+//******************************************************************************
+// Function : getSize
+// Process  : Retrieve the size of the window
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int RegressionSlope::getSize() const
+{
+   return this->values.getSize();
+}
+
+//******************************************************************************
+// Function : getSlope
+// Process  : Slope: (n Sxy - Sx Sy) / (n Sxx - Sx Sx)
+//             With x = 0 .. n - 1, Sx = n (n - 1) / 2 and the denominator
+//                is n n (n n - 1) / 12
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double RegressionSlope::getSlope() const
+{
+   const double SIZE = this->getSize(); // n
+
+   if (SIZE < 2.0)
+   {
+      return 0.0;
+   }
+
+   return (SIZE * this->sumXY - SIZE * (SIZE - 1.0) / 2.0 * this->sumY) /
+          (SIZE * SIZE * (SIZE * SIZE - 1.0) / 12.0);
+}
+
+#endif // RegressionSlope_h
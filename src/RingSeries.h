@@ -0,0 +1,351 @@
+//******************************************************************************
+//
+// File Name:     RingSeries.h
+//
+// File Overview: Represents a RingSeries
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added setNumAppended
+//******************************************************************************
+
+#ifndef RingSeries_h
+#define RingSeries_h
+
+#include <vector>
+#include <exception>
+#include <stdexcept>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    RingSeries
+//
+// Overview: A fixed capacity series keeping only the newest values
+//             append overwrites the oldest value once the series is full, so
+//             memory stays constant however many values are appended
+//             Values are indexed by age, 0 is the newest
+//             Used by StockAnalyzer when its history is bounded
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added setNumAppended
+//
+//******************************************************************************
+template <class T>
+class RingSeries
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty series of the specified capacity
+   // Constraints : None
+   //***************************************************************************
+   explicit RingSeries(const int capacity = 0);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~RingSeries();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : append
+   // Description : Adds the newest value, dropping the oldest once full
+   // Constraints : Throws an exception if the capacity is 0
+   //***************************************************************************
+   inline void append(const T& value);
+
+   //***************************************************************************
+   // Function    : getCapacity
+   // Description : Retrieve the number of values kept
+   // Constraints : None
+   //***************************************************************************
+   inline int getCapacity() const;
+
+   //***************************************************************************
+   // Function    : getFromNewest
+   // Description : Retrieve the value appended age appends ago
+   //                getFromNewest(0) is the newest value
+   // Constraints : Throws an out_of_range exception if age is not kept
+   //***************************************************************************
+   inline const T& getFromNewest(const int age) const;
+
+   //***************************************************************************
+   // Function    : getNumAppended
+   // Description : Retrieve the number of values ever appended
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumAppended() const;
+
+   //***************************************************************************
+   // Function    : getSize
+   // Description : Retrieve the number of values held, at most the capacity
+   // Constraints : None
+   //***************************************************************************
+   inline int getSize() const;
+
+   //***************************************************************************
+   // Function    : getStorageBytes
+   // Description : Retrieve the number of bytes used to store the values
+   // Constraints : None
+   //***************************************************************************
+   inline int getStorageBytes() const;
+
+   //***************************************************************************
+   // Function    : isEmpty
+   // Description : Has nothing been appended?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isEmpty() const;
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Empties the series and changes its capacity
+   // Constraints : None
+   //***************************************************************************
+   void reset(const int capacity);
+
+   //***************************************************************************
+   // Function    : setNumAppended
+   // Description : Sets the number of values ever appended, for a series
+   //                restored from its newest values
+   // Constraints : Throws an exception if numAppended is less than the size
+   //***************************************************************************
+   inline void setNumAppended(const long long numAppended);
+
+private:
+   vector<T> values;      // Storage, sized to the capacity once
+   int       newestIndex; // Index of the newest value in values
+   int       size;        // Values held
+   long long numAppended; // Values ever appended
+}; // end class RingSeries
+
+//******************************************************************************
+// Function : constructor
+// Process  : Reset to the capacity
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+RingSeries<T>::RingSeries(const int capacity)
+{
+   this->reset(capacity);
+} // end RingSeries::RingSeries
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+RingSeries<T>::~RingSeries()
+{
+} // end RingSeries::~RingSeries
+
+//******************************************************************************
+// Function : append
+// Process  : Advance the newest index, wrapping to the start
+//             Overwrite the oldest value there
+// Notes    : Throws an exception if the capacity is 0
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void RingSeries<T>::append(const T& value)
+{
+   const int CAPACITY = this->getCapacity(); // Values kept
+
+   if (0 == CAPACITY)
+   {
+      throw exception("RingSeries has no capacity");
+   }
+
+   if (++this->newestIndex == CAPACITY)
+   {
+      this->newestIndex = 0;
+   }
+
+   this->values[this->newestIndex] = value;
+
+   if (this->size < CAPACITY)
+   {
+      ++this->size;
+   }
+
+   ++this->numAppended;
+}
+
+//******************************************************************************
+// Function : getCapacity
+// Process  : Retrieve the number of values kept
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline int RingSeries<T>::getCapacity() const
+{
+   return this->values.size();
+}
+
+//******************************************************************************
+// Function : getFromNewest
+// Process  : Step back age values from the newest, wrapping to the end
+// Notes    : Throws an out_of_range exception if age is not kept
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline const T& RingSeries<T>::getFromNewest(const int age) const
+{
+   int index = this->newestIndex - age; // Index of the value in values
+
+   if (age < 0 || age >= this->size)
+   {
+      throw out_of_range("RingSeries age is not kept");
+   }
+
+   if (index < 0)
+   {
+      index += this->getCapacity();
+   }
+
+   return this->values[index];
+}
+
+//******************************************************************************
+// Function : getNumAppended
+// Process  : Accessor for numAppended
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline long long RingSeries<T>::getNumAppended() const
+{
+   return this->numAppended;
+}
+
+//******************************************************************************
+// Function : getSize
+// Process  : Accessor for size
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline int RingSeries<T>::getSize() const
+{
+   return this->size;
+}
+
+//******************************************************************************
+// Function : getStorageBytes
+// Process  : Retrieve the number of bytes used to store the values
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline int RingSeries<T>::getStorageBytes() const
+{
+   return this->values.capacity() * sizeof(T);
+}
+
+//******************************************************************************
+// Function : isEmpty
+// Process  : Has nothing been appended?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline bool RingSeries<T>::isEmpty() const
+{
+   return 0 == this->size;
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Size the storage to the capacity, releasing any excess
+//             Nothing held
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+void RingSeries<T>::reset(const int capacity)
+{
+   vector<T>(capacity).swap(this->values);
+   this->newestIndex = capacity - 1;
+   this->size        = 0;
+   this->numAppended = 0;
+}
+
+//******************************************************************************
+// Function : setNumAppended
+// Process  : Mutator for numAppended
+// Notes    : Throws an exception if numAppended is less than the size
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline void RingSeries<T>::setNumAppended(const long long numAppended)
+{
+   if (numAppended < this->size)
+   {
+      throw exception("RingSeries holds more values than were appended");
+   }
+
+   this->numAppended = numAppended;
+}
+
+#endif // RingSeries_h
@@ -0,0 +1,252 @@
+//******************************************************************************
+//
+// File Name:     SPSCQueue.h
+//
+// File Overview: Represents an SPSCQueue
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef SPSCQueue_h
+#define SPSCQueue_h
+
+#include <atomic>
+#include <exception>
+#include <stdexcept>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    SPSCQueue
+//
+// Overview: A bounded, lock-free, single producer single consumer queue
+//             One thread may call tryPush and one other thread tryPop
+//             The capacity is rounded up to a power of two so a slot is
+//                found with a mask
+//             tail is only written by the producer and head only by the
+//                consumer, each on its own cache line, and each side keeps
+//                a cached copy of the other's index so it only reads the
+//                shared one when the queue looks full or empty
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+template <class T>
+class SPSCQueue
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty queue of at least the specified capacity
+   // Constraints : Throws an exception if capacity is over MAXCAPACITY
+   //***************************************************************************
+   explicit SPSCQueue(const int capacity);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~SPSCQueue();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getCapacity
+   // Description : Retrieve the number of values the queue can hold
+   // Constraints : None
+   //***************************************************************************
+   inline int getCapacity() const;
+
+   //***************************************************************************
+   // Function    : tryPop
+   // Description : Removes the oldest value into value
+   //                Returns false if the queue is empty
+   // Constraints : Consumer thread only
+   //***************************************************************************
+   inline bool tryPop(T& value);
+
+   //***************************************************************************
+   // Function    : tryPush
+   // Description : Adds value as the newest value
+   //                Returns false if the queue is full
+   // Constraints : Producer thread only
+   //***************************************************************************
+   inline bool tryPush(const T& value);
+
+   static const int CACHELINEBYTES = 64;      // Keeps the indices apart
+   static const int MAXCAPACITY    = 1 << 30; // Largest int power of two
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, the indices are shared between threads
+   // Constraints : None
+   //***************************************************************************
+   SPSCQueue(const SPSCQueue&);
+   SPSCQueue& operator=(const SPSCQueue&);
+
+   vector<T>        slots;                          // Values, a power of two
+   unsigned         mask;                           // Slot of an index
+
+   char             paddingProducer[CACHELINEBYTES];
+   atomic<unsigned> tail;                           // Next push, producer
+   unsigned         cachedHead;                     // Producer's copy of head
+
+   char             paddingConsumer[CACHELINEBYTES];
+   atomic<unsigned> head;                           // Next pop, consumer
+   unsigned         cachedTail;                     // Consumer's copy of tail
+
+   char             paddingEnd[CACHELINEBYTES];
+}; // end class SPSCQueue
+
+//******************************************************************************
+// Function : constructor
+// Process  : Check the capacity has a power of two in an int
+//             Round the capacity up to a power of two
+//             Size the slots once
+//             Empty, head and tail both at 0
+// Notes    : Throws an exception if capacity is over MAXCAPACITY, doubling
+//             past it would overflow and never end
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Rejects capacities over MAXCAPACITY
+//******************************************************************************
+template <class T>
+SPSCQueue<T>::SPSCQueue(const int capacity)
+   : tail(0),
+     cachedHead(0),
+     head(0),
+     cachedTail(0)
+{
+   unsigned roundedCapacity = 1; // Power of two at least capacity
+
+   if (capacity > SPSCQueue<T>::MAXCAPACITY)
+   {
+      throw exception("SPSCQueue capacity is too large");
+   }
+
+   while (int(roundedCapacity) < capacity)
+   {
+      roundedCapacity <<= 1;
+   }
+
+   this->slots.resize(roundedCapacity);
+   this->mask = roundedCapacity - 1;
+} // end SPSCQueue::SPSCQueue
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+SPSCQueue<T>::~SPSCQueue()
+{
+} // end SPSCQueue::~SPSCQueue
+
+//******************************************************************************
+// Function : getCapacity
+// Process  : Retrieve the number of slots
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline int SPSCQueue<T>::getCapacity() const
+{
+   return this->slots.size();
+}
+
+//******************************************************************************
+// Function : tryPop
+// Process  : If the cached tail says empty, refresh it from tail
+//                Still empty, return false
+//             Copy the value out of its slot
+//             Publish the new head, releasing the slot to the producer
+// Notes    : Indices wrap around unsigned, only their difference matters
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline bool SPSCQueue<T>::tryPop(T& value)
+{
+   const unsigned HEAD = this->head.load(memory_order_relaxed); // Next pop
+
+   if (HEAD == this->cachedTail)
+   {
+      this->cachedTail = this->tail.load(memory_order_acquire);
+
+      if (HEAD == this->cachedTail)
+      {
+         return false;
+      }
+   }
+
+   value = this->slots[HEAD & this->mask];
+   this->head.store(HEAD + 1, memory_order_release);
+
+   return true;
+}
+
+//******************************************************************************
+// Function : tryPush
+// Process  : If the cached head says full, refresh it from head
+//                Still full, return false
+//             Copy the value into its slot
+//             Publish the new tail, releasing the value to the consumer
+// Notes    : Indices wrap around unsigned, only their difference matters
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+inline bool SPSCQueue<T>::tryPush(const T& value)
+{
+   const unsigned TAIL     = this->tail.load(memory_order_relaxed); // Next push
+   const unsigned CAPACITY = this->mask + 1;                        // Slots
+
+   if (TAIL - this->cachedHead == CAPACITY)
+   {
+      this->cachedHead = this->head.load(memory_order_acquire);
+
+      if (TAIL - this->cachedHead == CAPACITY)
+      {
+         return false;
+      }
+   }
+
+   this->slots[TAIL & this->mask] = value;
+   this->tail.store(TAIL + 1, memory_order_release);
+
+   return true;
+}
+
+#endif // SPSCQueue_h
@@ -0,0 +1,1159 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     Screener.cpp
+//
+// File Overview: Represents a Screener
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Uses SimdVector
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <sstream>
+
+#include "Metrics.h"
+#include "Screener.h"
+#include "SimdVector.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const unsigned long long ALLSELECTED = ~0ULL; // Every symbol of a word
+
+// How a kernel combines a comparison with the bitmap it writes
+enum Combine
+{
+   COMBINESET, // words = comparison
+   COMBINEAND, // words &= comparison, skipping words already 0
+   COMBINEOR   // words |= comparison, skipping words already ALLSELECTED
+};
+
+//******************************************************************************
+//
+// Class:    ColumnGreater
+//
+// Overview: Orders symbol indices by the value of a column, highest first
+//             Equal values keep their symbol order, NaN ranks last
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class ColumnGreater
+{
+public:
+   explicit ColumnGreater(const double* values)
+      : values(values)
+   {
+   }
+
+   bool operator()(
+      const int left,
+      const int right) const
+   {
+      const double LEFTVALUE  = this->values[left];
+      const double RIGHTVALUE = this->values[right];
+
+      if (std::isnan(LEFTVALUE) != std::isnan(RIGHTVALUE))
+      {
+         return !std::isnan(LEFTVALUE);
+      }
+
+      if (LEFTVALUE > RIGHTVALUE || LEFTVALUE < RIGHTVALUE)
+      {
+         return LEFTVALUE > RIGHTVALUE;
+      }
+
+      return left < right;
+   }
+
+private:
+   const double* values; // Column ordered by
+}; // end class ColumnGreater
+
+//******************************************************************************
+// Function : compareVectors
+// Process  : A bit per lane of first comparison second
+// Notes    : Like the C++ operators, a comparison with NaN is false but !=
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Moved the vector shim to SimdVector.h
+//******************************************************************************
+#if defined(SIMDVECTOR_AVX)
+template <int COMPARISON>
+static inline unsigned int compareVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   switch (COMPARISON)
+   {
+   case Screener::COMPARELESS:
+      return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_LT_OQ));
+   case Screener::COMPARELESSEQUAL:
+      return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_LE_OQ));
+   case Screener::COMPAREGREATER:
+      return greaterVectors(first, second);
+   case Screener::COMPAREGREATEREQUAL:
+      return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_GE_OQ));
+   case Screener::COMPAREEQUAL:
+      return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_EQ_OQ));
+   default:
+      return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_NEQ_UQ));
+   }
+}
+#elif defined(SIMDVECTOR_SSE2)
+template <int COMPARISON>
+static inline unsigned int compareVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   switch (COMPARISON)
+   {
+   case Screener::COMPARELESS:
+      return _mm_movemask_pd(_mm_cmplt_pd(first, second));
+   case Screener::COMPARELESSEQUAL:
+      return _mm_movemask_pd(_mm_cmple_pd(first, second));
+   case Screener::COMPAREGREATER:
+      return greaterVectors(first, second);
+   case Screener::COMPAREGREATEREQUAL:
+      return _mm_movemask_pd(_mm_cmpge_pd(first, second));
+   case Screener::COMPAREEQUAL:
+      return _mm_movemask_pd(_mm_cmpeq_pd(first, second));
+   default:
+      return _mm_movemask_pd(_mm_cmpneq_pd(first, second));
+   }
+}
+#else
+template <int COMPARISON>
+static inline unsigned int compareVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   switch (COMPARISON)
+   {
+   case Screener::COMPARELESS:
+      return first < second;
+   case Screener::COMPARELESSEQUAL:
+      return first <= second;
+   case Screener::COMPAREGREATER:
+      return greaterVectors(first, second);
+   case Screener::COMPAREGREATEREQUAL:
+      return first >= second;
+   case Screener::COMPAREEQUAL:
+      return first == second;
+   default:
+      return first != second;
+   }
+}
+#endif
+
+//******************************************************************************
+// Function : compareValues
+// Process  : first comparison second
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool compareValues(
+   const Screener::Comparison comparison,
+   const double first,
+   const double second)
+{
+   switch (comparison)
+   {
+   case Screener::COMPARELESS:
+      return first < second;
+   case Screener::COMPARELESSEQUAL:
+      return first <= second;
+   case Screener::COMPAREGREATER:
+      return first > second;
+   case Screener::COMPAREGREATEREQUAL:
+      return first >= second;
+   case Screener::COMPAREEQUAL:
+      return first == second;
+   default:
+      return first != second;
+   }
+}
+
+//******************************************************************************
+// Function : compareWords
+// Process  : Loop through the words of the bitmap
+//             Skip a word the combination already decides
+//             Compare the word's symbols a vector at a time, a bit for each
+//             Combine the bits with the word
+// Notes    : The comparison, combination, and whether the second operand is
+//             a column are template parameters, so the inner loop has
+//             no branches
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <int COMPARISON, int COMBINE, bool COLUMNS>
+static void compareWords(
+   const double* values,
+   const double* otherValues,
+   const double constant,
+   unsigned long long* words,
+   const int numWords)
+{
+   const DoubleVector CONSTANT = broadcastVector(constant); // Compared with
+
+   // Loop through the words of the bitmap
+   for (int word = 0; word < numWords; ++word)
+   {
+      // Skip a word the combination already decides
+      if ((COMBINEAND == COMBINE && 0 == words[word]) ||
+          (COMBINEOR == COMBINE && ALLSELECTED == words[word]))
+      {
+         continue;
+      }
+
+      const int FIRST = word * ScreenerColumns::WORDSYMBOLS; // First symbol
+      unsigned long long bits = 0;                    // Comparison of each
+
+      // Compare the word's symbols a vector at a time, a bit for each
+      for (int lane = 0; lane < ScreenerColumns::WORDSYMBOLS;
+           lane += VECTORDOUBLES)
+      {
+         const DoubleVector SECOND = COLUMNS ?
+            loadVector(otherValues + FIRST + lane) : CONSTANT;
+
+         bits |= (unsigned long long)compareVectors<COMPARISON>(
+            loadVector(values + FIRST + lane), SECOND) << lane;
+      }
+
+      // Combine the bits with the word
+      if (COMBINEAND == COMBINE)
+      {
+         words[word] &= bits;
+      }
+      else if (COMBINEOR == COMBINE)
+      {
+         words[word] |= bits;
+      }
+      else
+      {
+         words[word] = bits;
+      }
+   }
+}
+
+//******************************************************************************
+// Function : compareWordsBy
+// Process  : Choose the kernel for the combination and second operand
+// Notes    : otherValues is 0 to compare with the constant
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <int COMPARISON>
+static void compareWordsBy(
+   const Combine combine,
+   const double* values,
+   const double* otherValues,
+   const double constant,
+   unsigned long long* words,
+   const int numWords)
+{
+   if (0 != otherValues)
+   {
+      switch (combine)
+      {
+      case COMBINEAND:
+         compareWords<COMPARISON, COMBINEAND, true>(
+            values, otherValues, constant, words, numWords);
+         break;
+      case COMBINEOR:
+         compareWords<COMPARISON, COMBINEOR, true>(
+            values, otherValues, constant, words, numWords);
+         break;
+      default:
+         compareWords<COMPARISON, COMBINESET, true>(
+            values, otherValues, constant, words, numWords);
+         break;
+      }
+   }
+   else
+   {
+      switch (combine)
+      {
+      case COMBINEAND:
+         compareWords<COMPARISON, COMBINEAND, false>(
+            values, otherValues, constant, words, numWords);
+         break;
+      case COMBINEOR:
+         compareWords<COMPARISON, COMBINEOR, false>(
+            values, otherValues, constant, words, numWords);
+         break;
+      default:
+         compareWords<COMPARISON, COMBINESET, false>(
+            values, otherValues, constant, words, numWords);
+         break;
+      }
+   }
+}
+
+//******************************************************************************
+// Function : compareWordsFor
+// Process  : Choose the kernel for the comparison
+// Notes    : otherValues is 0 to compare with the constant
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void compareWordsFor(
+   const Screener::Comparison comparison,
+   const Combine combine,
+   const double* values,
+   const double* otherValues,
+   const double constant,
+   unsigned long long* words,
+   const int numWords)
+{
+   switch (comparison)
+   {
+   case Screener::COMPARELESS:
+      compareWordsBy<Screener::COMPARELESS>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   case Screener::COMPARELESSEQUAL:
+      compareWordsBy<Screener::COMPARELESSEQUAL>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   case Screener::COMPAREGREATER:
+      compareWordsBy<Screener::COMPAREGREATER>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   case Screener::COMPAREGREATEREQUAL:
+      compareWordsBy<Screener::COMPAREGREATEREQUAL>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   case Screener::COMPAREEQUAL:
+      compareWordsBy<Screener::COMPAREEQUAL>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   default:
+      compareWordsBy<Screener::COMPARENOTEQUAL>(
+         combine, values, otherValues, constant, words, numWords);
+      break;
+   }
+}
+
+//******************************************************************************
+// Function : mirrorComparison
+// Process  : The comparison with its operands swapped
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static Screener::Comparison mirrorComparison(
+   const Screener::Comparison comparison)
+{
+   switch (comparison)
+   {
+   case Screener::COMPARELESS:
+      return Screener::COMPAREGREATER;
+   case Screener::COMPARELESSEQUAL:
+      return Screener::COMPAREGREATEREQUAL;
+   case Screener::COMPAREGREATER:
+      return Screener::COMPARELESS;
+   case Screener::COMPAREGREATEREQUAL:
+      return Screener::COMPARELESSEQUAL;
+   default:
+      return comparison;
+   }
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : No screen
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+Screener::Screener()
+   : numSlots(0),
+     position(0),
+     rootNode(-1)
+{
+} // end Screener::Screener
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+Screener::~Screener()
+{
+} // end Screener::~Screener
+
+//******************************************************************************
+// Function : addColumnName
+// Process  : Look for the name, add it if it's not there
+// Notes    : A screen names few columns
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::addColumnName(const string& columnName)
+{
+   vector<string>::const_iterator found = find(
+      this->columnNames.begin(), this->columnNames.end(), columnName);
+
+   if (found != this->columnNames.end())
+   {
+      return found - this->columnNames.begin();
+   }
+
+   this->columnNames.push_back(columnName);
+
+   return this->columnNames.size() - 1;
+}
+
+//******************************************************************************
+// Function : addNode
+// Process  : Append the node
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::addNode(const Node& node)
+{
+   this->nodes.push_back(node);
+
+   return this->nodes.size() - 1;
+}
+
+//******************************************************************************
+// Function : compile
+// Process  : Forget the previous screen
+//             Parse the screen, which must be all used
+//             Plan the instructions writing the screen's selection to the
+//                first bitmap
+// Notes    : Throws an exception for a syntax error, leaving no screen
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::compile(const string& expression)
+{
+   // Forget the previous screen
+   this->expression = expression;
+   this->columnNames.clear();
+   this->instructions.clear();
+   this->nodes.clear();
+   this->numSlots = 0;
+   this->position = 0;
+   this->rootNode = -1;
+
+   // Parse the screen, which must be all used
+   const int ROOTNODE = this->parseOr(); // Node of the whole screen
+
+   this->matchText("");
+
+   if (this->position != this->expression.size())
+   {
+      this->throwSyntaxError("expected && or ||");
+   }
+
+   // Plan the instructions
+   this->compileNode(ROOTNODE, 0);
+   this->rootNode = ROOTNODE;
+}
+
+//******************************************************************************
+// Function : compileNode
+// Process  : Note the slot is used
+//             A comparison or a number is one instruction
+//             ! negates its operand in place
+//             && and || write the first operand to the slot
+//                A comparison second operand is fused with the join,
+//                   otherwise it is written to the next slot and joined
+// Notes    : A chain of && or || of comparisons uses one slot
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::compileNode(
+   const int nodeIndex,
+   const int slot)
+{
+   const Node NODE        = this->nodes[nodeIndex]; // Node compiled
+   Instruction instruction = {                      // Its last instruction
+      OPCOMPARE,
+      NODE.comparison,
+      slot,
+      -1,
+      NODE.column,
+      NODE.otherColumn,
+      NODE.constant };
+
+   // Note the slot is used
+   this->numSlots = max(this->numSlots, slot + 1);
+
+   switch (NODE.type)
+   {
+   case NODECOMPARE:
+   case NODECOMPARECOLUMNS:
+      break;
+
+   case NODECONSTANT:
+      instruction.opcode = OPSET;
+      break;
+
+   case NODENOT:
+      this->compileNode(NODE.first, slot);
+      instruction.opcode = OPNOT;
+      break;
+
+   default:
+      {
+         const Node SECOND = this->nodes[NODE.second]; // Second operand
+
+         this->compileNode(NODE.first, slot);
+
+         if (NODECOMPARE == SECOND.type || NODECOMPARECOLUMNS == SECOND.type)
+         {
+            instruction.opcode      = (NODEAND == NODE.type) ?
+                                      OPANDCOMPARE : OPORCOMPARE;
+            instruction.comparison  = SECOND.comparison;
+            instruction.column      = SECOND.column;
+            instruction.otherColumn = SECOND.otherColumn;
+            instruction.constant    = SECOND.constant;
+         }
+         else
+         {
+            this->compileNode(NODE.second, slot + 1);
+            instruction.opcode = (NODEAND == NODE.type) ? OPAND : OPOR;
+            instruction.source = slot + 1;
+         }
+      }
+      break;
+   }
+
+   this->instructions.push_back(instruction);
+}
+
+//******************************************************************************
+// Function : countSelected
+// Process  : Count the bits of each word
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::countSelected(const vector<unsigned long long>& bitmap)
+{
+   int numSelected = 0; // Bits counted
+
+   for (size_t word = 0; word < bitmap.size(); ++word)
+   {
+      unsigned long long bits = bitmap[word]; // Bits not yet counted
+
+      while (0 != bits)
+      {
+         bits &= bits - 1;
+         ++numSelected;
+      }
+   }
+
+   return numSelected;
+}
+
+//******************************************************************************
+// Function : evaluateNode
+// Process  : Compare the symbol's values, or combine the node's operands
+// Notes    : && and || skip the second operand once the first decides
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Screener::evaluateNode(
+   const int nodeIndex,
+   const vector<const double*>& columnData,
+   const int symbolIndex) const
+{
+   const Node& node = this->nodes[nodeIndex]; // Node evaluated
+
+   switch (node.type)
+   {
+   case NODECOMPARE:
+      return compareValues(
+         node.comparison,
+         columnData[node.column][symbolIndex],
+         node.constant);
+
+   case NODECOMPARECOLUMNS:
+      return compareValues(
+         node.comparison,
+         columnData[node.column][symbolIndex],
+         columnData[node.otherColumn][symbolIndex]);
+
+   case NODEAND:
+      return this->evaluateNode(node.first, columnData, symbolIndex) &&
+             this->evaluateNode(node.second, columnData, symbolIndex);
+
+   case NODEOR:
+      return this->evaluateNode(node.first, columnData, symbolIndex) ||
+             this->evaluateNode(node.second, columnData, symbolIndex);
+
+   case NODENOT:
+      return !this->evaluateNode(node.first, columnData, symbolIndex);
+
+   default:
+      return 0.0 != node.constant;
+   }
+}
+
+//******************************************************************************
+// Function : matchText
+// Process  : Skip spaces
+//             If the text is next, move past it
+// Notes    : Empty text just skips spaces
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool Screener::matchText(const char* text)
+{
+   const size_t LENGTH = strlen(text); // Characters to match
+
+   // Skip spaces
+   while (this->position < this->expression.size() &&
+          isspace((unsigned char)this->expression[this->position]))
+   {
+      ++this->position;
+   }
+
+   // If the text is next, move past it
+   if (0 != this->expression.compare(this->position, LENGTH, text))
+   {
+      return false;
+   }
+
+   this->position += LENGTH;
+
+   return true;
+}
+
+//******************************************************************************
+// Function : parseAnd
+// Process  : and := unary ('&&' unary)*, joined left to right
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::parseAnd()
+{
+   int nodeIndex = this->parseUnary(); // Operands joined so far
+
+   while (this->matchText("&&"))
+   {
+      Node node = { NODEAND, COMPARELESS, nodeIndex, -1, -1, -1, 0.0 };
+
+      node.second = this->parseUnary();
+      nodeIndex   = this->addNode(node);
+   }
+
+   return nodeIndex;
+}
+
+//******************************************************************************
+// Function : parseComparison
+// Process  : comparison := operand op operand
+//             Two numbers are compared now
+//             A number first swaps the operands, so the column is first
+// Notes    : Throws an exception without a comparison
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::parseComparison()
+{
+   Node   node          = { NODECOMPARE, COMPARELESS, -1, -1, -1, -1, 0.0 };
+   int    otherColumn   = -1;  // Column of the second operand
+   double otherConstant = 0.0; // Number of the second operand
+
+   this->parseOperand(node.column, node.constant);
+
+   // Longer operators first, so <= isn't read as <
+   if (this->matchText("<="))
+   {
+      node.comparison = COMPARELESSEQUAL;
+   }
+   else if (this->matchText(">="))
+   {
+      node.comparison = COMPAREGREATEREQUAL;
+   }
+   else if (this->matchText("=="))
+   {
+      node.comparison = COMPAREEQUAL;
+   }
+   else if (this->matchText("!="))
+   {
+      node.comparison = COMPARENOTEQUAL;
+   }
+   else if (this->matchText("<"))
+   {
+      node.comparison = COMPARELESS;
+   }
+   else if (this->matchText(">"))
+   {
+      node.comparison = COMPAREGREATER;
+   }
+   else
+   {
+      this->throwSyntaxError("expected <, <=, >, >=, ==, or !=");
+   }
+
+   this->parseOperand(otherColumn, otherConstant);
+
+   if (node.column < 0 && otherColumn < 0)
+   {
+      // Two numbers are compared now
+      node.type     = NODECONSTANT;
+      node.constant = compareValues(
+         node.comparison, node.constant, otherConstant) ? 1.0 : 0.0;
+   }
+   else if (node.column < 0)
+   {
+      // A number first swaps the operands
+      node.comparison = mirrorComparison(node.comparison);
+      node.column     = otherColumn;
+   }
+   else if (otherColumn < 0)
+   {
+      node.constant = otherConstant;
+   }
+   else
+   {
+      node.type        = NODECOMPARECOLUMNS;
+      node.otherColumn = otherColumn;
+   }
+
+   return this->addNode(node);
+}
+
+//******************************************************************************
+// Function : parseOperand
+// Process  : operand := column | number
+//             A column name is letters, digits, and _, starting with a letter
+//                or _
+//             A number is anything strtod reads, such as 0.05 or 1e6
+// Notes    : Throws an exception without an operand
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::parseOperand(
+   int& column,
+   double& constant)
+{
+   this->matchText("");
+
+   const size_t START = this->position; // First character of the operand
+
+   column   = -1;
+   constant = 0.0;
+
+   if (START < this->expression.size() &&
+       (isalpha((unsigned char)this->expression[START]) ||
+        '_' == this->expression[START]))
+   {
+      // A column name
+      while (this->position < this->expression.size() &&
+             (isalnum((unsigned char)this->expression[this->position]) ||
+              '_' == this->expression[this->position]))
+      {
+         ++this->position;
+      }
+
+      column = this->addColumnName(
+         this->expression.substr(START, this->position - START));
+   }
+   else
+   {
+      // A number
+      const char* text = this->expression.c_str() + START; // Number text
+      char*       end  = 0;                                // Past it
+
+      constant = strtod(text, &end);
+
+      if (end == text)
+      {
+         this->throwSyntaxError("expected a column or a number");
+      }
+
+      this->position += end - text;
+   }
+}
+
+//******************************************************************************
+// Function : parseOr
+// Process  : or := and ('||' and)*, joined left to right
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::parseOr()
+{
+   int nodeIndex = this->parseAnd(); // Operands joined so far
+
+   while (this->matchText("||"))
+   {
+      Node node = { NODEOR, COMPARELESS, nodeIndex, -1, -1, -1, 0.0 };
+
+      node.second = this->parseAnd();
+      nodeIndex   = this->addNode(node);
+   }
+
+   return nodeIndex;
+}
+
+//******************************************************************************
+// Function : parseUnary
+// Process  : unary := '!' unary | '(' or ')' | comparison
+// Notes    : Throws an exception for an unclosed parenthesis
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int Screener::parseUnary()
+{
+   this->matchText("");
+
+   // ! but not !=, which only follows an operand
+   if (this->expression.compare(this->position, 2, "!=") != 0 &&
+       this->matchText("!"))
+   {
+      Node node = { NODENOT, COMPARELESS, -1, -1, -1, -1, 0.0 };
+
+      node.first = this->parseUnary();
+
+      return this->addNode(node);
+   }
+
+   if (this->matchText("("))
+   {
+      const int NODEINDEX = this->parseOr(); // Node in the parentheses
+
+      if (!this->matchText(")"))
+      {
+         this->throwSyntaxError("expected )");
+      }
+
+      return NODEINDEX;
+   }
+
+   return this->parseComparison();
+}
+
+//******************************************************************************
+// Function : resolveColumns
+// Process  : Find each of columnNames in the columns
+// Notes    : Throws an exception if a column is missing
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::resolveColumns(
+   const ScreenerColumns& columns,
+   vector<const double*>& columnData) const
+{
+   if (this->rootNode < 0)
+   {
+      throw exception("Screener has no screen compiled");
+   }
+
+   columnData.resize(this->columnNames.size());
+
+   for (size_t name = 0; name < this->columnNames.size(); ++name)
+   {
+      const int COLUMNINDEX = columns.findColumn(this->columnNames[name]);
+
+      if (COLUMNINDEX < 0)
+      {
+         throw exception("Screener column is missing");
+      }
+
+      columnData[name] = columns.getColumnData(COLUMNINDEX);
+   }
+}
+
+//******************************************************************************
+// Function : screen
+// Process  : Select the symbols
+//             List each selected symbol index
+//             Sort the highest numTopStocks to the front, keep only those
+// Notes    : Throws an exception if a column is missing
+//             O(selected log numTopStocks) after selecting
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::screen(
+   const ScreenerColumns& columns,
+   const string& rankColumnName,
+   const int numTopStocks,
+   vector<int>& symbolIndices)
+{
+   const int RANKCOLUMN = columns.findColumn(rankColumnName); // Ranked by
+   vector<unsigned long long> bitmap;                         // Selected
+
+   if (RANKCOLUMN < 0)
+   {
+      throw exception("Screener rank column is missing");
+   }
+
+   // Select the symbols
+   this->select(columns, bitmap);
+
+   METRICS_TIMER(PHASERANK);
+
+   // List each selected symbol index
+   symbolIndices.clear();
+
+   for (size_t word = 0; word < bitmap.size(); ++word)
+   {
+      for (int bit = 0; 0 != bitmap[word] && bit < ScreenerColumns::WORDSYMBOLS;
+           ++bit)
+      {
+         if (0 != ((bitmap[word] >> bit) & 1))
+         {
+            symbolIndices.push_back(word * ScreenerColumns::WORDSYMBOLS + bit);
+         }
+      }
+   }
+
+   // Sort the highest numTopStocks to the front, keep only those
+   const int NUMRANKED = min(max(numTopStocks, 0), (int)symbolIndices.size());
+
+   partial_sort(
+      symbolIndices.begin(),
+      symbolIndices.begin() + NUMRANKED,
+      symbolIndices.end(),
+      ColumnGreater(columns.getColumnData(RANKCOLUMN)));
+
+   symbolIndices.resize(NUMRANKED);
+}
+
+//******************************************************************************
+// Function : select
+// Process  : Find the columns, size the bitmaps
+//             Run each instruction over whole words of every symbol
+//                The first slot is the bitmap itself
+//             Clear the padding symbols of the last word
+// Notes    : Throws an exception if a column is missing
+//             Allocates only when the symbols or screen grow
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::select(
+   const ScreenerColumns& columns,
+   vector<unsigned long long>& bitmap)
+{
+   METRICS_TIMER(PHASESCREEN);
+
+   const int NUMWORDS = columns.getNumWords();    // Words of each bitmap
+   const int REMAINDER = columns.getNumSymbols() %
+                         ScreenerColumns::WORDSYMBOLS; // Symbols in last word
+   vector<const double*> columnData;              // Values of each column
+
+   // Find the columns, size the bitmaps
+   this->resolveColumns(columns, columnData);
+
+   bitmap.resize(NUMWORDS);
+   this->slots.resize(this->numSlots);
+
+   for (int slot = 1; slot < this->numSlots; ++slot)
+   {
+      this->slots[slot].resize(NUMWORDS);
+   }
+
+   // Run each instruction over whole words of every symbol
+   for (size_t index = 0; index < this->instructions.size(); ++index)
+   {
+      const Instruction& instruction = this->instructions[index];
+      unsigned long long* words = (0 == instruction.destination) ?
+         bitmap.data() : this->slots[instruction.destination].data();
+
+      switch (instruction.opcode)
+      {
+      case OPCOMPARE:
+      case OPANDCOMPARE:
+      case OPORCOMPARE:
+         compareWordsFor(
+            instruction.comparison,
+            (OPANDCOMPARE == instruction.opcode) ? COMBINEAND :
+            (OPORCOMPARE == instruction.opcode) ? COMBINEOR : COMBINESET,
+            columnData[instruction.column],
+            (instruction.otherColumn < 0) ?
+               0 : columnData[instruction.otherColumn],
+            instruction.constant,
+            words,
+            NUMWORDS);
+         break;
+
+      case OPAND:
+      case OPOR:
+         {
+            const unsigned long long* source =
+               this->slots[instruction.source].data(); // Joined operand
+
+            for (int word = 0; word < NUMWORDS; ++word)
+            {
+               words[word] = (OPAND == instruction.opcode) ?
+                  (words[word] & source[word]) : (words[word] | source[word]);
+            }
+         }
+         break;
+
+      case OPNOT:
+         for (int word = 0; word < NUMWORDS; ++word)
+         {
+            words[word] = ~words[word];
+         }
+         break;
+
+      default:
+         fill(words, words + NUMWORDS,
+              (0.0 != instruction.constant) ? ALLSELECTED : 0);
+         break;
+      }
+   }
+
+   // Clear the padding symbols of the last word
+   if (0 != REMAINDER)
+   {
+      bitmap[NUMWORDS - 1] &= (1ULL << REMAINDER) - 1;
+   }
+}
+
+//******************************************************************************
+// Function : selectInterpreted
+// Process  : Find the columns, clear the bitmap
+//             Evaluate the parsed screen for each symbol, setting its bit
+//                if selected
+// Notes    : Throws an exception if a column is missing
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::selectInterpreted(
+   const ScreenerColumns& columns,
+   vector<unsigned long long>& bitmap) const
+{
+   const int NUMSYMBOLS = columns.getNumSymbols(); // Symbols evaluated
+   vector<const double*> columnData;               // Values of each column
+
+   // Find the columns, clear the bitmap
+   this->resolveColumns(columns, columnData);
+   bitmap.assign(columns.getNumWords(), 0);
+
+   // Evaluate the parsed screen for each symbol
+   for (int symbol = 0; symbol < NUMSYMBOLS; ++symbol)
+   {
+      if (this->evaluateNode(this->rootNode, columnData, symbol))
+      {
+         bitmap[symbol / ScreenerColumns::WORDSYMBOLS] |=
+            1ULL << (symbol % ScreenerColumns::WORDSYMBOLS);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : throwSyntaxError
+// Process  : Name the problem and the position in the screen
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Screener::throwSyntaxError(const char* problem) const
+{
+   ostringstream message; // Exception text
+
+   message << "Screener " << problem << " at position " << this->position
+           << " of: " << this->expression;
+
+   throw exception(message.str().c_str());
+}
@@ -0,0 +1,333 @@
+//******************************************************************************
+//
+// File Name:     Screener.h
+//
+// File Overview: Represents a Screener
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef Screener_h
+#define Screener_h
+
+#include <string>
+#include <vector>
+
+#include "ScreenerColumns.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    Screener
+//
+// Overview: Filters the symbols of a ScreenerColumns with a screen such as
+//                macd > 0 && slope > 0.05 && close > sma200 && volume > 1e6
+//             A screen is comparisons joined by && and ||, negated by !,
+//                and grouped by parentheses, && binding tighter than ||
+//             A comparison is <, <=, >, >=, ==, or != between two columns
+//                or a column and a number
+//             compile turns the screen into a plan of instructions over
+//                selection bitmaps, one bit per symbol
+//                A comparison is a vectorized kernel comparing a whole
+//                   bitmap word of a column at a time
+//                A comparison joined by && or || is fused with the join,
+//                   and skips the words the join already decides
+//             select runs the plan, screen also ranks the selected symbols
+//             selectInterpreted evaluates the screen a symbol at a time by
+//                walking the parsed screen, the naive way, for comparison
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class Screener
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No screen, compile one before selecting
+   // Constraints : None
+   //***************************************************************************
+   Screener();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~Screener();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : compile
+   // Description : Parses the screen and plans its instructions
+   // Constraints : Throws an exception, naming the position, if the screen
+   //                can't be parsed
+   //***************************************************************************
+   void compile(const string& expression);
+
+   //***************************************************************************
+   // Function    : countSelected
+   // Description : Retrieves the number of symbols selected in the bitmap
+   // Constraints : None
+   //***************************************************************************
+   static int countSelected(const vector<unsigned long long>& bitmap);
+
+   //***************************************************************************
+   // Function    : getColumnNames
+   // Description : Retrieves the names of the columns the screen uses
+   // Constraints : None
+   //***************************************************************************
+   inline const vector<string>& getColumnNames() const;
+
+   //***************************************************************************
+   // Function    : getExpression
+   // Description : Accessor for expression
+   // Constraints : None
+   //***************************************************************************
+   inline const string& getExpression() const;
+
+   //***************************************************************************
+   // Function    : getNumInstructions
+   // Description : Retrieves the number of instructions in the plan
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumInstructions() const;
+
+   //***************************************************************************
+   // Function    : screen
+   // Description : Selects the symbols, then retrieves the indices of the
+   //                numTopStocks selected symbols with the highest values
+   //                of the rank column, highest first
+   //                Equal values keep their symbol order, NaN ranks last
+   // Constraints : Throws an exception if a column is missing
+   //***************************************************************************
+   void screen(
+      const ScreenerColumns& columns,
+      const string& rankColumnName,
+      const int numTopStocks,
+      vector<int>& symbolIndices);
+
+   //***************************************************************************
+   // Function    : select
+   // Description : Runs the plan, setting the bit of each symbol the screen
+   //                selects in bitmap, getNumWords words
+   // Constraints : Throws an exception if a column is missing
+   //***************************************************************************
+   void select(
+      const ScreenerColumns& columns,
+      vector<unsigned long long>& bitmap);
+
+   //***************************************************************************
+   // Function    : selectInterpreted
+   // Description : Selects the same symbols as select, evaluating the
+   //                parsed screen one symbol at a time
+   // Constraints : Throws an exception if a column is missing
+   //***************************************************************************
+   void selectInterpreted(
+      const ScreenerColumns& columns,
+      vector<unsigned long long>& bitmap) const;
+
+   // Comparisons between two operands
+   enum Comparison
+   {
+      COMPARELESS,
+      COMPARELESSEQUAL,
+      COMPAREGREATER,
+      COMPAREGREATEREQUAL,
+      COMPAREEQUAL,
+      COMPARENOTEQUAL
+   };
+
+private:
+   // Kinds of node in the parsed screen
+   enum NodeType
+   {
+      NODECOMPARE,        // column comparison constant
+      NODECOMPARECOLUMNS, // column comparison otherColumn
+      NODEAND,            // first && second
+      NODEOR,             // first || second
+      NODENOT,            // !first
+      NODECONSTANT        // constant, 0 or 1, from comparing two numbers
+   };
+
+   // Instructions of the plan, each writing the destination bitmap
+   enum Opcode
+   {
+      OPCOMPARE,          // destination = comparison
+      OPANDCOMPARE,       // destination &= comparison
+      OPORCOMPARE,        // destination |= comparison
+      OPAND,              // destination &= source
+      OPOR,               // destination |= source
+      OPNOT,              // destination = ~destination
+      OPSET               // destination = constant for every symbol
+   };
+
+   // One node of the parsed screen
+   struct Node
+   {
+      NodeType   type;        // Kind of node
+      Comparison comparison;  // Of a comparison
+      int        first;       // Node of an operand of &&, ||, or !
+      int        second;      // Node of the other operand of && or ||
+      int        column;      // Column, in columnNames, of a comparison
+      int        otherColumn; // Column compared with, or -1 for constant
+      double     constant;    // Number compared with
+   };
+
+   // One instruction of the plan
+   struct Instruction
+   {
+      Opcode     opcode;      // What it does
+      Comparison comparison;  // Of a comparison
+      int        destination; // Bitmap written
+      int        source;      // Bitmap read by OPAND and OPOR
+      int        column;      // Column, in columnNames, of a comparison
+      int        otherColumn; // Column compared with, or -1 for constant
+      double     constant;    // Number compared with, or set
+   };
+
+   //***************************************************************************
+   // Function    : addColumnName
+   // Description : Retrieves the index of the column name in columnNames,
+   //                adding it if it is new
+   // Constraints : None
+   //***************************************************************************
+   int addColumnName(const string& columnName);
+
+   //***************************************************************************
+   // Function    : addNode
+   // Description : Adds the node, retrieving its index
+   // Constraints : None
+   //***************************************************************************
+   int addNode(const Node& node);
+
+   //***************************************************************************
+   // Function    : compileNode
+   // Description : Adds the instructions writing the node's selection to
+   //                the bitmap slot, using the slots after it for operands
+   // Constraints : None
+   //***************************************************************************
+   void compileNode(
+      const int nodeIndex,
+      const int slot);
+
+   //***************************************************************************
+   // Function    : evaluateNode
+   // Description : Evaluates the node for one symbol, stopping && and ||
+   //                once the first operand decides
+   // Constraints : None
+   //***************************************************************************
+   bool evaluateNode(
+      const int nodeIndex,
+      const vector<const double*>& columnData,
+      const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : matchText
+   // Description : Skips spaces, then the text if it is next
+   //                Returns whether it was
+   // Constraints : None
+   //***************************************************************************
+   bool matchText(const char* text);
+
+   //***************************************************************************
+   // Function    : parseAnd, parseComparison, parseOperand, parseOr,
+   //                parseUnary
+   // Description : Recursive descent over the screen, from position
+   //                Each returns the node parsed, parseOperand fills
+   //                the column, or -1 and the number
+   // Constraints : Throw an exception for a syntax error
+   //***************************************************************************
+   int parseAnd();
+   int parseComparison();
+   void parseOperand(
+      int& column,
+      double& constant);
+   int parseOr();
+   int parseUnary();
+
+   //***************************************************************************
+   // Function    : resolveColumns
+   // Description : Retrieves the values of each of columnNames in columns
+   // Constraints : Throws an exception if a column is missing
+   //***************************************************************************
+   void resolveColumns(
+      const ScreenerColumns& columns,
+      vector<const double*>& columnData) const;
+
+   //***************************************************************************
+   // Function    : throwSyntaxError
+   // Description : Throws an exception with the problem and the position
+   // Constraints : None
+   //***************************************************************************
+   void throwSyntaxError(const char* problem) const;
+
+   vector<string>                       columnNames;  // Columns used
+   string                               expression;   // Screen compiled
+   vector<Instruction>                  instructions; // The plan
+   vector<Node>                         nodes;        // Parsed screen
+   int                                  numSlots;     // Bitmaps the plan
+                                                      // uses
+   size_t                               position;     // Parsed up to
+   int                                  rootNode;     // Node of the screen
+   vector< vector<unsigned long long> > slots;        // Bitmaps after the
+                                                      // first, reused
+}; // end class Screener
+
+//******************************************************************************
+// Function : getColumnNames
+// Process  : Accessor for columnNames
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const vector<string>& Screener::getColumnNames() const
+{
+   return this->columnNames;
+}
+
+//******************************************************************************
+// Function : getExpression
+// Process  : Accessor for expression
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& Screener::getExpression() const
+{
+   return this->expression;
+}
+
+//******************************************************************************
+// Function : getNumInstructions
+// Process  : Retrieve the size of the plan
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int Screener::getNumInstructions() const
+{
+   return this->instructions.size();
+}
+
+#endif // Screener_h
@@ -0,0 +1,336 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     ScreenerColumns.cpp
+//
+// File Overview: Represents a ScreenerColumns
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added IndicatorEngine columns
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <limits>
+
+#include "IndicatorEngine.h"
+#include "PortfolioAnalyzer.h"
+#include "ScreenerColumns.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// Columns setFromPortfolio always fills, see the class overview
+enum FixedColumn
+{
+   COLUMNCLOSE,
+   COLUMNOPEN,
+   COLUMNHIGH,
+   COLUMNLOW,
+   COLUMNVOLUME,
+   COLUMNMACD,
+   COLUMNSLOPE,
+   COLUMNREGRESSION,
+   COLUMNEMAFAST,
+   COLUMNEMASLOW,
+   NUMFIXEDCOLUMNS
+};
+
+static const char* FIXEDCOLUMNS[NUMFIXEDCOLUMNS] =
+{
+   "close",
+   "open",
+   "high",
+   "low",
+   "volume",
+   "macd",
+   "slope",
+   "regression",
+   "emafast",
+   "emaslow"
+};
+
+//******************************************************************************
+// Function : constructor
+// Process  : No symbols and no columns
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+ScreenerColumns::ScreenerColumns()
+{
+   this->reset(0);
+} // end ScreenerColumns::ScreenerColumns
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+ScreenerColumns::~ScreenerColumns()
+{
+} // end ScreenerColumns::~ScreenerColumns
+
+//******************************************************************************
+// Function : findColumn
+// Process  : Compare the name with each column's
+// Notes    : A screen looks up only the columns it uses, once per screen
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int ScreenerColumns::findColumn(const string& columnName) const
+{
+   for (int columnIndex = 0; columnIndex < this->getNumColumns();
+        ++columnIndex)
+   {
+      if (this->columnNames[columnIndex] == columnName)
+      {
+         return columnIndex;
+      }
+   }
+
+   return -1;
+}
+
+//******************************************************************************
+// Function : isStandardColumn
+// Process  : One of FIXEDCOLUMNS, or an indicator of IndicatorEngine
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added IndicatorEngine columns
+//******************************************************************************
+bool ScreenerColumns::isStandardColumn(const string& columnName)
+{
+   for (int columnIndex = 0; columnIndex < NUMFIXEDCOLUMNS; ++columnIndex)
+   {
+      if (columnName == FIXEDCOLUMNS[columnIndex])
+      {
+         return true;
+      }
+   }
+
+   return IndicatorEngine::isIndicatorName(columnName);
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : Drop every column
+//             Hold numSymbols symbols, each with no symbol set
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void ScreenerColumns::reset(const int numSymbols)
+{
+   this->columnNames.clear();
+   this->columns.clear();
+   this->numSymbols = numSymbols;
+   this->symbols.assign(numSymbols, string());
+}
+
+//******************************************************************************
+// Function : setColumn
+// Process  : Find the column, adding it if there is none
+//             Copy the values, padded with 0 to whole words
+// Notes    : Throws an exception unless there is a value per symbol
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void ScreenerColumns::setColumn(
+   const string& columnName,
+   const vector<double>& values)
+{
+   int columnIndex = this->findColumn(columnName); // Column set
+
+   if (int(values.size()) != this->getNumSymbols())
+   {
+      throw exception("Screener column needs a value per symbol");
+   }
+
+   // Find the column, adding it if there is none
+   if (-1 == columnIndex)
+   {
+      columnIndex = this->getNumColumns();
+      this->columnNames.push_back(columnName);
+      this->columns.push_back(vector<double>());
+   }
+
+   // Copy the values, padded with 0 to whole words
+   vector<double>& column = this->columns[columnIndex];
+
+   column.assign(this->getNumPaddedSymbols(), 0.0);
+   copy(values.begin(), values.end(), column.begin());
+}
+
+//******************************************************************************
+// Function : setFromPortfolio
+// Process  : Hold a symbol per stock analyzer
+//             Fill the fixed columns from each analyzer, NaN when not known
+//                The MACDs need two EMAs of each period
+//                The regression slope needs periodsSlope
+//                The open, high, low, and volume need the last bar
+//             Add each other column in columnNames to one IndicatorEngine
+//             Run the engine over each analyzer's prices held, oldest first,
+//                in one fused pass however many indicators there are
+//             Fill each indicator's column, NaN if there were too few prices
+// Notes    : Throws an exception if a column name is not standard
+//             A bounded analyzer holds only its getMaxLookback newest prices
+//             The stocks hold closes only, so the close is also each bar's
+//                high and low
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Added IndicatorEngine columns
+//******************************************************************************
+void ScreenerColumns::setFromPortfolio(
+   const PortfolioAnalyzer& portfolioAnalyzer,
+   const vector<string>& columnNames)
+{
+   const int    NUMSYMBOLS = portfolioAnalyzer.getNumStockAnalyzers();
+   const double NOTKNOWN   = numeric_limits<double>::quiet_NaN();
+
+   vector< vector<double> > fixedValues(     // Of each fixed column
+      NUMFIXEDCOLUMNS, vector<double>(NUMSYMBOLS, NOTKNOWN));
+   IndicatorEngine          engine;                    // Of the others
+   vector< vector<double> > indicatorValues;           // Of each indicator
+   vector<int>              numPricesHeld(NUMSYMBOLS); // Of each analyzer
+
+   this->reset(NUMSYMBOLS);
+
+   // Fill the fixed columns from each analyzer
+   for (int symbolIndex = 0; symbolIndex < NUMSYMBOLS; ++symbolIndex)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(symbolIndex);
+      const Bar&           lastBar       = stockAnalyzer.getLastBar();
+      const int            NUMPRICES     = stockAnalyzer.getNumStockPrices();
+
+      this->setSymbolAt(symbolIndex, stockAnalyzer.getStockSymbol());
+
+      numPricesHeld[symbolIndex] = stockAnalyzer.isHistoryBounded() ?
+         min(NUMPRICES, stockAnalyzer.getMaxLookback()) : NUMPRICES;
+
+      if (NUMPRICES > 0)
+      {
+         fixedValues[COLUMNCLOSE][symbolIndex] =
+            stockAnalyzer.getStockPriceAtIndex(NUMPRICES - 1);
+      }
+
+      if (0 != lastBar.numTicks)
+      {
+         fixedValues[COLUMNOPEN][symbolIndex]   = lastBar.open;
+         fixedValues[COLUMNHIGH][symbolIndex]   = lastBar.high;
+         fixedValues[COLUMNLOW][symbolIndex]    = lastBar.low;
+         fixedValues[COLUMNVOLUME][symbolIndex] = double(lastBar.volume);
+      }
+
+      if (stockAnalyzer.hasMACD())
+      {
+         fixedValues[COLUMNMACD][symbolIndex]    =
+            stockAnalyzer.getCurrentMACD();
+         fixedValues[COLUMNSLOPE][symbolIndex]   =
+            stockAnalyzer.getSlopeMACD();
+         fixedValues[COLUMNEMAFAST][symbolIndex] =
+            stockAnalyzer.getCurrentEMAFast();
+         fixedValues[COLUMNEMASLOW][symbolIndex] =
+            stockAnalyzer.getCurrentEMASlow();
+
+         if (stockAnalyzer.getPeriodsSlope() > 0)
+         {
+            fixedValues[COLUMNREGRESSION][symbolIndex] =
+               stockAnalyzer.getRegressionSlopeMACD();
+         }
+      }
+   }
+
+   for (int columnIndex = 0; columnIndex < NUMFIXEDCOLUMNS; ++columnIndex)
+   {
+      this->setColumn(FIXEDCOLUMNS[columnIndex], fixedValues[columnIndex]);
+   }
+
+   // Add each other column in columnNames to one IndicatorEngine
+   for (size_t nameIndex = 0; nameIndex < columnNames.size(); ++nameIndex)
+   {
+      if (-1 != this->findColumn(columnNames[nameIndex]))
+      {
+         continue;
+      }
+
+      if (!IndicatorEngine::isIndicatorName(columnNames[nameIndex]))
+      {
+         throw exception("Unknown screener column");
+      }
+
+      engine.addIndicator(columnNames[nameIndex]);
+   }
+
+   indicatorValues.assign(
+      engine.getNumIndicators(), vector<double>(NUMSYMBOLS, NOTKNOWN));
+
+   // Run the engine over each analyzer's prices held, oldest first
+   for (int symbolIndex = 0;
+        symbolIndex < NUMSYMBOLS && engine.getNumIndicators() > 0;
+        ++symbolIndex)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(symbolIndex);
+      const int            NUMPRICES     = stockAnalyzer.getNumStockPrices();
+
+      engine.reset();
+
+      for (int priceIndex = NUMPRICES - numPricesHeld[symbolIndex];
+           priceIndex < NUMPRICES; ++priceIndex)
+      {
+         const double PRICE = stockAnalyzer.getStockPriceAtIndex(priceIndex);
+
+         engine.update(PRICE, PRICE, PRICE);
+      }
+
+      for (int indicatorIndex = 0;
+           indicatorIndex < engine.getNumIndicators(); ++indicatorIndex)
+      {
+         indicatorValues[indicatorIndex][symbolIndex] =
+            engine.getValue(indicatorIndex);
+      }
+   }
+
+   // Fill each indicator's column
+   for (int indicatorIndex = 0; indicatorIndex < engine.getNumIndicators();
+        ++indicatorIndex)
+   {
+      this->setColumn(engine.getIndicatorName(indicatorIndex),
+                      indicatorValues[indicatorIndex]);
+   }
+}
@@ -0,0 +1,314 @@
+//******************************************************************************
+//
+// File Name:     ScreenerColumns.h
+//
+// File Overview: Represents a ScreenerColumns
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef ScreenerColumns_h
+#define ScreenerColumns_h
+
+#include <string>
+#include <vector>
+
+using namespace std;
+
+class PortfolioAnalyzer;
+
+//******************************************************************************
+//
+// Class:    ScreenerColumns
+//
+// Overview: A column store of one value per symbol for each named indicator,
+//             screened by Screener
+//             Each column is a contiguous array of doubles, padded to a whole
+//                number of WORDSYMBOLS symbols so a kernel can compare a
+//                whole bitmap word at a time without a tail
+//             setFromPortfolio fills the columns from the StockAnalyzers:
+//                close         newest price
+//                open, high,   newest bar, from the stock data file or
+//                low, volume      updateWithBar
+//                macd          current MACD
+//                slope         two day MACD slope
+//                regression    regression slope of MACD, see
+//                                 StockAnalyzer::setPeriodsSlope
+//                emafast,      current EMAs
+//                emaslow
+//                smaN, rsiN,   any indicator of IndicatorEngine, from
+//                   ...           one fused pass over the prices held
+//             A value that isn't known, such as the volume of a stock with
+//                no bar or an SMA longer than the prices held, is NaN,
+//                which fails every comparison but !=
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added IndicatorEngine columns
+//
+//******************************************************************************
+class ScreenerColumns
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No symbols and no columns
+   // Constraints : None
+   //***************************************************************************
+   ScreenerColumns();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~ScreenerColumns();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : findColumn
+   // Description : Retrieves the index of the named column
+   //                Returns -1 if there is no such column
+   // Constraints : None
+   //***************************************************************************
+   int findColumn(const string& columnName) const;
+
+   //***************************************************************************
+   // Function    : getColumnData
+   // Description : Retrieves the values of the column at the specified index
+   //                getNumPaddedSymbols values, the padding is 0
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const double* getColumnData(const int columnIndex) const;
+
+   //***************************************************************************
+   // Function    : getColumnName
+   // Description : Retrieves the name of the column at the specified index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const string& getColumnName(const int columnIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumColumns
+   // Description : Retrieves the number of columns
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumColumns() const;
+
+   //***************************************************************************
+   // Function    : getNumPaddedSymbols
+   // Description : Retrieves the number of values in each column, the
+   //                number of symbols rounded up to WORDSYMBOLS
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumPaddedSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieves the number of symbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumWords
+   // Description : Retrieves the number of words in a bitmap of the symbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumWords() const;
+
+   //***************************************************************************
+   // Function    : getSymbolAt
+   // Description : Retrieves the symbol at the specified index
+   //                Empty unless set
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const string& getSymbolAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : isStandardColumn
+   // Description : Can setFromPortfolio fill the named column?
+   // Constraints : None
+   //***************************************************************************
+   static bool isStandardColumn(const string& columnName);
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Holds numSymbols symbols, with no columns
+   // Constraints : None
+   //***************************************************************************
+   void reset(const int numSymbols);
+
+   //***************************************************************************
+   // Function    : setColumn
+   // Description : Sets the named column to the values, one per symbol,
+   //                adding it if there is no such column
+   // Constraints : Throws an exception unless there is a value per symbol
+   //***************************************************************************
+   void setColumn(
+      const string& columnName,
+      const vector<double>& values);
+
+   //***************************************************************************
+   // Function    : setFromPortfolio
+   // Description : Holds the portfolio's stock analyzers, with the fixed
+   //                columns and any indicator columns in columnNames
+   // Constraints : Throws an exception if a column name is not standard
+   //***************************************************************************
+   void setFromPortfolio(
+      const PortfolioAnalyzer& portfolioAnalyzer,
+      const vector<string>& columnNames);
+
+   //***************************************************************************
+   // Function    : setSymbolAt
+   // Description : Sets the symbol at the specified index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline void setSymbolAt(
+      const int index,
+      const string& symbol);
+
+   static const int WORDSYMBOLS = 64; // Symbols in a bitmap word
+
+private:
+   vector<string>           columnNames; // Name of each column
+   vector< vector<double> > columns;     // Padded values of each column
+   int                      numSymbols;  // Symbols with values
+   vector<string>           symbols;     // Symbol of each value
+}; // end class ScreenerColumns
+
+//******************************************************************************
+// Function : getColumnData
+// Process  : Retrieve the values of the column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* ScreenerColumns::getColumnData(
+   const int columnIndex) const
+{
+   return this->columns.at(columnIndex).data();
+}
+
+//******************************************************************************
+// Function : getColumnName
+// Process  : Retrieve the name of the column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& ScreenerColumns::getColumnName(
+   const int columnIndex) const
+{
+   return this->columnNames.at(columnIndex);
+}
+
+//******************************************************************************
+// Function : getNumColumns
+// Process  : Retrieve the number of columns
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ScreenerColumns::getNumColumns() const
+{
+   return this->columns.size();
+}
+
+//******************************************************************************
+// Function : getNumPaddedSymbols
+// Process  : Whole words of symbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ScreenerColumns::getNumPaddedSymbols() const
+{
+   return this->getNumWords() * ScreenerColumns::WORDSYMBOLS;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Accessor for numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ScreenerColumns::getNumSymbols() const
+{
+   return this->numSymbols;
+}
+
+//******************************************************************************
+// Function : getNumWords
+// Process  : Round the symbols up to whole words
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ScreenerColumns::getNumWords() const
+{
+   return (this->numSymbols + ScreenerColumns::WORDSYMBOLS - 1) /
+          ScreenerColumns::WORDSYMBOLS;
+}
+
+//******************************************************************************
+// Function : getSymbolAt
+// Process  : Retrieve the symbol at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& ScreenerColumns::getSymbolAt(const int index) const
+{
+   return this->symbols.at(index);
+}
+
+//******************************************************************************
+// Function : setSymbolAt
+// Process  : Set the symbol at the index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void ScreenerColumns::setSymbolAt(
+   const int index,
+   const string& symbol)
+{
+   this->symbols.at(index) = symbol;
+}
+
+#endif // ScreenerColumns_h
@@ -0,0 +1,311 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     ShardResult.cpp
+//
+// File Overview: Represents a ShardResult
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Keeps the portfolio's ranking slope
+// 10.19.26       Donne Martin         Moved SummarySlopeGreater to the header
+// 10.19.26       Donne Martin         Uses BinaryBuffer
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+
+#include "BinaryBuffer.h"
+#include "ShardResult.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const int MAXSYMBOLLENGTH = 255; // Symbol length is stored in a byte
+
+//******************************************************************************
+// Function : constructor
+// Process  : The only shard, no stocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+ShardResult::ShardResult()
+   : numShards(1),
+     shardIndex(0)
+{
+} // end ShardResult::ShardResult
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+ShardResult::~ShardResult()
+{
+} // end ShardResult::~ShardResult
+
+//******************************************************************************
+// Function : load
+// Process  : Read the whole file
+//             Check the magic number and version
+//             Read the shard, the stock summaries, and the top indices
+//             Check every top index refers to a stock
+// Notes    : Layout, all native byte order:
+//                unsigned MAGIC, unsigned VERSION, int shardIndex, 
+//                int numShards, int numStocks, int numTopStocks
+//                numStocks x (int manifestIndex, double currentMACD, 
+//                   double slopeMACD, unsigned char length, symbol chars)
+//                numTopStocks x int index into the stocks
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Reads with BinaryBuffer
+//******************************************************************************
+void ShardResult::load(const char* resultFileName)
+{
+   BinaryBuffer  buffer("Shard result is truncated"); // The whole file
+   unsigned int  magic        = 0;                 // Identifies the file
+   unsigned int  version      = 0;                 // Of the file layout
+   int           numStocks    = 0;                 // Stocks to read
+   int           numTopStocks = 0;                 // Top indices to read
+   unsigned char length       = 0;                 // Of a symbol
+
+   // Read the whole file
+   if (!buffer.load(resultFileName))
+   {
+      throw exception("Could not read the shard result");
+   }
+
+   // Check the magic number and version
+   buffer.readValue(magic);
+   buffer.readValue(version);
+
+   if (ShardResult::MAGIC != magic || ShardResult::VERSION != version)
+   {
+      throw exception("Not a shard result");
+   }
+
+   // Read the shard, the stock summaries, and the top indices
+   buffer.readValue(this->shardIndex);
+   buffer.readValue(this->numShards);
+   buffer.readValue(numStocks);
+   buffer.readValue(numTopStocks);
+
+   if (numStocks < 0 || numTopStocks < 0 || numTopStocks > numStocks)
+   {
+      throw exception("Not a shard result");
+   }
+
+   this->stocks.resize(numStocks);
+   this->topIndices.resize(numTopStocks);
+
+   for (int stockIndex = 0; stockIndex < numStocks; ++stockIndex)
+   {
+      ShardStockSummary& stock = this->stocks[stockIndex];
+
+      buffer.readValue(stock.manifestIndex);
+      buffer.readValue(stock.currentMACD);
+      buffer.readValue(stock.slopeMACD);
+      buffer.readValue(length);
+      buffer.readBytes(length, stock.symbol);
+   }
+
+   for (int rank = 0; rank < numTopStocks; ++rank)
+   {
+      buffer.readValue(this->topIndices[rank]);
+
+      // Check every top index refers to a stock
+      if (this->topIndices[rank] < 0 || this->topIndices[rank] >= numStocks)
+      {
+         throw exception("Not a shard result");
+      }
+   }
+}
+
+//******************************************************************************
+// Function : mergeTopStocks
+// Process  : Check there is exactly one result for every shard
+//             Gather the top numStocks stocks of every result
+//             Sort the highest numStocks of them to the front
+// Notes    : Each global top stock is one of its shard's top stocks, so
+//             the other stocks of each shard are never needed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void ShardResult::mergeTopStocks(
+   const vector<ShardResult>& shardResults,
+   const int numStocks,
+   vector<ShardStockSummary>& rankedStocks)
+{
+   const int    NUMSHARDS = 
+      shardResults.empty() ? 0 : shardResults[0].getNumShards();
+   vector<bool> foundShards(NUMSHARDS, false); // Result seen for each shard?
+   int          numRanked = 0;                 // Stocks kept
+
+   // Check there is exactly one result for every shard
+   if (int(shardResults.size()) != NUMSHARDS)
+   {
+      throw exception("Need exactly one result for every shard");
+   }
+
+   for (int resultIndex = 0; resultIndex < NUMSHARDS; ++resultIndex)
+   {
+      const ShardResult& shardResult = shardResults[resultIndex];
+
+      if (shardResult.getNumShards() != NUMSHARDS || 
+          shardResult.getShardIndex() < 0 ||
+          shardResult.getShardIndex() >= NUMSHARDS ||
+          foundShards[shardResult.getShardIndex()])
+      {
+         throw exception("Need exactly one result for every shard");
+      }
+
+      foundShards[shardResult.getShardIndex()] = true;
+   }
+
+   // Gather the top numStocks stocks of every result
+   rankedStocks.clear();
+
+   for (int resultIndex = 0; resultIndex < NUMSHARDS; ++resultIndex)
+   {
+      const ShardResult& shardResult = shardResults[resultIndex];
+
+      for (int rank = 0; 
+           rank < min(numStocks, shardResult.getNumTopStocks()); 
+           ++rank)
+      {
+         rankedStocks.push_back(shardResult.getTopStockAtRank(rank));
+      }
+   }
+
+   // Sort the highest numStocks of them to the front
+   numRanked = min(max(numStocks, 0), int(rankedStocks.size()));
+
+   partial_sort(
+      rankedStocks.begin(),
+      rankedStocks.begin() + numRanked,
+      rankedStocks.end(),
+      SummarySlopeGreater());
+
+   rankedStocks.resize(numRanked);
+}
+
+//******************************************************************************
+// Function : save
+// Process  : Lay the result out in a buffer
+//                The magic number, version, and shard, every stock
+//                summary, and the top indices
+//             Replace the file with the buffer at once
+// Notes    : See load for the layout
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Lays out with BinaryBuffer
+//******************************************************************************
+void ShardResult::save(const char* resultFileName) const
+{
+   BinaryBuffer buffer("Shard result is truncated"); // The whole file
+
+   // Lay the result out in a buffer
+   buffer.appendValue((unsigned int)ShardResult::MAGIC);
+   buffer.appendValue((unsigned int)ShardResult::VERSION);
+   buffer.appendValue(this->shardIndex);
+   buffer.appendValue(this->numShards);
+   buffer.appendValue(this->getNumStocks());
+   buffer.appendValue(this->getNumTopStocks());
+
+   for (int stockIndex = 0; stockIndex < this->getNumStocks(); ++stockIndex)
+   {
+      const ShardStockSummary& stock = this->stocks[stockIndex];
+
+      buffer.appendValue(stock.manifestIndex);
+      buffer.appendValue(stock.currentMACD);
+      buffer.appendValue(stock.slopeMACD);
+      buffer.appendValue((unsigned char)stock.symbol.size());
+      buffer.appendBytes(stock.symbol.data(), stock.symbol.size());
+   }
+
+   for (int rank = 0; rank < this->getNumTopStocks(); ++rank)
+   {
+      buffer.appendValue(this->topIndices[rank]);
+   }
+
+   // Replace the file with the buffer at once
+   if (!buffer.save(resultFileName))
+   {
+      throw exception("Could not write the shard result");
+   }
+}
+
+//******************************************************************************
+// Function : setFromPortfolio
+// Process  : Summarize every stock analyzer of the portfolio
+//                Its slope is the portfolio's ranking slope
+//             Keep the indices of its top numTopStocks stocks
+// Notes    : Throws an exception if a symbol is longer than MAXSYMBOLLENGTH
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Keeps the ranking slope
+//******************************************************************************
+void ShardResult::setFromPortfolio(
+   const PortfolioAnalyzer& portfolioAnalyzer,
+   const int shardIndex,
+   const int numShards,
+   const int numTopStocks)
+{
+   const int NUMSTOCKS = portfolioAnalyzer.getNumStockAnalyzers();
+
+   this->shardIndex = shardIndex;
+   this->numShards  = numShards;
+   this->stocks.resize(NUMSTOCKS);
+
+   // Summarize every stock analyzer of the portfolio
+   for (int stockIndex = 0; stockIndex < NUMSTOCKS; ++stockIndex)
+   {
+      const StockAnalyzer& stockAnalyzer = 
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(stockIndex);
+      ShardStockSummary&   stock         = this->stocks[stockIndex];
+
+      stock.symbol        = stockAnalyzer.getStockSymbol();
+      stock.manifestIndex = portfolioAnalyzer.getManifestIndexAtIndex(
+                               stockIndex);
+      stock.currentMACD   = stockAnalyzer.getCurrentMACD();
+      stock.slopeMACD     = portfolioAnalyzer.getRankingSlopeAtIndex(
+                               stockIndex);
+
+      if (int(stock.symbol.size()) > MAXSYMBOLLENGTH)
+      {
+         throw exception("Symbol too long for a shard result");
+      }
+   }
+
+   // Keep the indices of its top numTopStocks stocks
+   portfolioAnalyzer.getTopStocksByMACDSlope(numTopStocks, this->topIndices);
+}
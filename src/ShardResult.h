@@ -0,0 +1,311 @@
+//******************************************************************************
+//
+// File Name:     ShardResult.h
+//
+// File Overview: Represents a ShardResult
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Keeps the portfolio's ranking slope
+// 10.19.26       Donne Martin         Exposes SummarySlopeGreater
+// 10.19.26       Donne Martin         Saves with BinaryBuffer
+//******************************************************************************
+
+#ifndef ShardResult_h
+#define ShardResult_h
+
+#include <string>
+#include <vector>
+
+#include "PortfolioAnalyzer.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    ShardStockSummary
+//
+// Overview: The analysis of one stock of a shard, enough to rank it against
+//             the stocks of every other shard
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Keeps the portfolio's ranking slope
+//
+//******************************************************************************
+struct ShardStockSummary
+{
+   string symbol;        // Symbol from the stock data file name
+   int    manifestIndex; // Position in the whole manifest, breaks ties
+   double currentMACD;   // MACD of the latest price
+   double slopeMACD;     // MACD slope the portfolio is ranked by, see
+                         // PortfolioAnalyzer::getRankingSlopeAtIndex
+}; // end struct ShardStockSummary
+
+//******************************************************************************
+//
+// Class:    SummarySlopeGreater
+//
+// Overview: Orders stock summaries by MACD slope, highest first
+//             Equal slopes keep their manifest order, matching
+//             PortfolioAnalyzer::getTopStocksByMACDSlope
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Shared with StreamingAnalyzer
+//
+//******************************************************************************
+class SummarySlopeGreater
+{
+public:
+   bool operator()(
+      const ShardStockSummary& left,
+      const ShardStockSummary& right) const
+   {
+      if (left.slopeMACD != right.slopeMACD)
+      {
+         return left.slopeMACD > right.slopeMACD;
+      }
+
+      return left.manifestIndex < right.manifestIndex;
+   }
+}; // end class SummarySlopeGreater
+
+//******************************************************************************
+//
+// Class:    ShardResult
+//
+// Overview: The partial result of analyzing one shard of a manifest
+//             Holds a summary of every stock in the shard and the shard's
+//                top stocks by MACD slope
+//             Saved to and loaded from a compact binary file, so shards can
+//                run in separate processes or on separate machines
+//             mergeTopStocks combines the results of every shard into the
+//                ranking one process analyzing the whole manifest gives:
+//                each global top stock is in its own shard's top stocks, 
+//                and equal slopes are ordered by manifest position
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class ShardResult
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty result of the only shard
+   // Constraints : None
+   //***************************************************************************
+   ShardResult();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~ShardResult();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getNumShards
+   // Description : Accessor for numShards
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumShards() const;
+
+   //***************************************************************************
+   // Function    : getNumStocks
+   // Description : Retrieve the number of stocks summarized
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumStocks() const;
+
+   //***************************************************************************
+   // Function    : getNumTopStocks
+   // Description : Retrieve the number of top stocks kept
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumTopStocks() const;
+
+   //***************************************************************************
+   // Function    : getShardIndex
+   // Description : Accessor for shardIndex
+   // Constraints : None
+   //***************************************************************************
+   inline int getShardIndex() const;
+
+   //***************************************************************************
+   // Function    : getStockAtIndex
+   // Description : Retrieves the summary of the stock at the specified index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const ShardStockSummary& getStockAtIndex(const int index) const;
+
+   //***************************************************************************
+   // Function    : getTopStockAtRank
+   // Description : Retrieves the summary of the top stock at the specified 
+   //                rank, 0 is the highest MACD slope
+   // Constraints : Throws an out_of_range exception for invalid rank
+   //***************************************************************************
+   inline const ShardStockSummary& getTopStockAtRank(const int rank) const;
+
+   //***************************************************************************
+   // Function    : load
+   // Description : Reads a result written by save
+   // Constraints : Throws an exception if the file can't be read or is not
+   //                a shard result
+   //***************************************************************************
+   void load(const char* resultFileName);
+
+   //***************************************************************************
+   // Function    : mergeTopStocks
+   // Description : Ranks the top numStocks stocks of every shard's results
+   //                together, highest MACD slope first, equal slopes in
+   //                manifest order
+   //                Each result must have kept at least numStocks top stocks
+   //                for the ranking to match one process
+   // Constraints : Throws an exception unless there is exactly one result
+   //                for every shard
+   //***************************************************************************
+   static void mergeTopStocks(
+      const vector<ShardResult>& shardResults,
+      const int numStocks,
+      vector<ShardStockSummary>& rankedStocks);
+
+   //***************************************************************************
+   // Function    : save
+   // Description : Writes the result as a binary file, replacing any file
+   //                of the name only once it is whole
+   // Constraints : Throws an exception if the file can't be written
+   //***************************************************************************
+   void save(const char* resultFileName) const;
+
+   //***************************************************************************
+   // Function    : setFromPortfolio
+   // Description : Summarizes every stock of the analyzed portfolio, the 
+   //                shard shardIndex of numShards, and keeps its top
+   //                numTopStocks stocks
+   // Constraints : Call PortfolioAnalyzer::analyzePortfolio first
+   //***************************************************************************
+   void setFromPortfolio(
+      const PortfolioAnalyzer& portfolioAnalyzer,
+      const int shardIndex,
+      const int numShards,
+      const int numTopStocks);
+
+   static const unsigned int MAGIC   = 0x44524853; // "SHRD" little endian
+   static const unsigned int VERSION = 1;          // Of the file layout
+
+private:
+   int                       numShards;     // Shards the manifest was split in
+   int                       shardIndex;    // This shard
+   vector<ShardStockSummary> stocks;        // Every stock of the shard
+   vector<int>               topIndices;    // Top stocks, indices into stocks
+}; // end class ShardResult
+
+//******************************************************************************
+// Function : getNumShards
+// Process  : Accessor for numShards
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ShardResult::getNumShards() const
+{
+   return this->numShards;
+}
+
+//******************************************************************************
+// Function : getNumStocks
+// Process  : Retrieve the number of stocks summarized
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ShardResult::getNumStocks() const
+{
+   return this->stocks.size();
+}
+
+//******************************************************************************
+// Function : getNumTopStocks
+// Process  : Retrieve the number of top stocks kept
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ShardResult::getNumTopStocks() const
+{
+   return this->topIndices.size();
+}
+
+//******************************************************************************
+// Function : getShardIndex
+// Process  : Accessor for shardIndex
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int ShardResult::getShardIndex() const
+{
+   return this->shardIndex;
+}
+
+//******************************************************************************
+// Function : getStockAtIndex
+// Process  : Retrieve the summary at the specified index
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const ShardStockSummary& ShardResult::getStockAtIndex(
+   const int index) const
+{
+   return this->stocks.at(index);
+}
+
+//******************************************************************************
+// Function : getTopStockAtRank
+// Process  : Retrieve the summary the top index at the rank refers to
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const ShardStockSummary& ShardResult::getTopStockAtRank(
+   const int rank) const
+{
+   return this->stocks.at(this->topIndices.at(rank));
+}
+
+#endif // ShardResult_h
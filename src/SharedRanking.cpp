@@ -0,0 +1,615 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     SharedRanking.cpp
+//
+// File Overview: Represents a SharedRankingWriter and a SharedRankingReader
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added classes
+// 10.19.26       Donne Martin         Shares the slope order and the clock
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#include "Platform.h"
+#include "SharedRanking.h"
+
+//******************************************************************************
+// Function : constructor
+// Process  : Check the sizes, at most every symbol is a top symbol
+//             Create the shared memory, and construct its header and records
+//             Write the layout and every symbol's name
+//             Publish the zeroed summaries, each symbol ranked by index
+//             Write the magic last, for readers to find the layout whole
+// Notes    : Throws an exception unless there are symbols and every size
+//             is positive, or if the memory can't be created
+//             Names are cut to SYMBOLNAMEBYTES less the null
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SharedRankingWriter::SharedRankingWriter(
+   const string& segmentName,
+   const vector<string>& symbolNames,
+   const int numTopStocks)
+   : segment(NULL),
+     numBytes(0),
+     mapping(0),
+     segmentName(segmentName),
+     header(NULL),
+     records(NULL),
+     topIndices(NULL),
+     numSymbols(symbolNames.size()),
+     numTopStocks(min(numTopStocks, int(symbolNames.size()))),
+     summaries(symbolNames.size()),
+     rankedIndices(symbolNames.size()),
+     ranks(symbolNames.size()),
+     isChanged(symbolNames.size())
+{
+   char* names = NULL; // Of every symbol, in the memory
+
+   // Check the sizes
+   if (symbolNames.empty() || numTopStocks < 1)
+   {
+      throw exception("Invalid shared ranking size");
+   }
+
+   // Create the shared memory, and construct its header and records
+   this->numBytes = SharedRankingWriter::getSegmentBytes(
+      this->numSymbols, this->numTopStocks);
+   this->segment  = Platform::createSharedMemory(
+      segmentName, this->numBytes, this->mapping);
+
+   this->header     = new (this->segment) SharedRankingHeader();
+   this->records    = reinterpret_cast<SharedRankingRecord*>(
+      this->segment + sizeof(SharedRankingHeader));
+   this->topIndices = reinterpret_cast<int*>(
+      this->records + this->numSymbols);
+   names            = reinterpret_cast<char*>(
+      this->topIndices + this->numTopStocks);
+
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      new (&this->records[symbolIndex]) SharedRankingRecord();
+      this->rankedIndices[symbolIndex] = symbolIndex;
+   }
+
+   // Write the layout and every symbol's name
+   this->header->layoutVersion = SharedRankingWriter::LAYOUTVERSION;
+   this->header->numSymbols    = this->numSymbols;
+   this->header->numTopStocks  = this->numTopStocks;
+
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      memcpy(names + symbolIndex * SharedRankingWriter::SYMBOLNAMEBYTES,
+             symbolNames[symbolIndex].c_str(),
+             min(symbolNames[symbolIndex].size(),
+                 size_t(SharedRankingWriter::SYMBOLNAMEBYTES - 1)));
+   }
+
+   // Publish the zeroed summaries, then write the magic
+   this->publish();
+   this->header->magic.store(SharedRankingWriter::MAGIC,
+                             memory_order_release);
+} // end SharedRankingWriter::SharedRankingWriter
+
+//******************************************************************************
+// Function : destructor
+// Process  : Mark the memory closed
+//             Unmap it and remove its name, readers keep their mappings
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SharedRankingWriter::~SharedRankingWriter()
+{
+   this->header->isClosed.store(1, memory_order_release);
+
+   Platform::unmapFile(this->segment, this->numBytes, this->mapping);
+   Platform::removeSharedMemory(this->segmentName);
+} // end SharedRankingWriter::~SharedRankingWriter
+
+//******************************************************************************
+// Function : getSegmentBytes
+// Process  : The header, a record per symbol, the top symbol indices, and
+//             a name per symbol
+// Notes    : Records follow the cache line of the header, so each record
+//             is a cache line of its own in the page aligned memory
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+size_t SharedRankingWriter::getSegmentBytes(
+   const int numSymbols,
+   const int numTopStocks)
+{
+   return sizeof(SharedRankingHeader) +
+          size_t(numSymbols) * sizeof(SharedRankingRecord) +
+          size_t(numTopStocks) * sizeof(int) +
+          size_t(numSymbols) * SharedRankingWriter::SYMBOLNAMEBYTES;
+}
+
+//******************************************************************************
+// Function : publish
+// Process  : Rank every symbol
+//                Take the updated symbols out of the ranking, which stays
+//                   in order, sort them, and merge them back in
+//             Note the symbols whose rank moved
+//             Open the publish, the header's sequence goes odd
+//             Write the changed records and the top symbols
+//             Close the publish with its version and steady clock, the
+//                header's sequence goes even
+// Notes    : O(n + k log k) for k updated symbols, a full sort of every
+//             publish would be O(n log n)
+//             Ranking before the publish is opened keeps readers of the
+//             top symbols waiting only while the records are written
+//             The release fence keeps the records' writes after the odd
+//             sequence, the release store keeps them before the even one
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void SharedRankingWriter::publish()
+{
+   const unsigned long long SEQUENCE =
+      this->header->sequence.load(memory_order_relaxed);
+   const long long          VERSION  =
+      this->header->version.load(memory_order_relaxed);
+
+   RankingSlopeGreater      slopeGreater(this->summaries); // Ranks
+   size_t                   numKept = 0; // Symbols not updated
+
+   // Take the updated symbols out of the ranking, sort them, merge them in
+   for (int rank = 0; rank < this->numSymbols; ++rank)
+   {
+      if (!this->isChanged[this->rankedIndices[rank]])
+      {
+         this->rankedIndices[numKept++] = this->rankedIndices[rank];
+      }
+   }
+
+   this->updatedIndices = this->changedIndices;
+   sort(this->updatedIndices.begin(), this->updatedIndices.end(),
+        slopeGreater);
+
+   this->mergedIndices.resize(this->numSymbols);
+   merge(this->rankedIndices.begin(), this->rankedIndices.begin() + numKept,
+         this->updatedIndices.begin(), this->updatedIndices.end(),
+         this->mergedIndices.begin(), slopeGreater);
+   this->rankedIndices.swap(this->mergedIndices);
+
+   // Note the symbols whose rank moved
+   for (int rank = 0; rank < this->numSymbols; ++rank)
+   {
+      const int SYMBOLINDEX = this->rankedIndices[rank];
+
+      if (this->ranks[SYMBOLINDEX] != rank + 1)
+      {
+         this->ranks[SYMBOLINDEX] = rank + 1;
+
+         if (!this->isChanged[SYMBOLINDEX])
+         {
+            this->isChanged[SYMBOLINDEX] = true;
+            this->changedIndices.push_back(SYMBOLINDEX);
+         }
+      }
+   }
+
+   // Open the publish
+   this->header->sequence.store(SEQUENCE + 1, memory_order_relaxed);
+   atomic_thread_fence(memory_order_release);
+
+   // Write the changed records and the top symbols
+   for (size_t changedIndex = 0;
+        changedIndex < this->changedIndices.size();
+        ++changedIndex)
+   {
+      this->writeRecord(this->changedIndices[changedIndex]);
+      this->isChanged[this->changedIndices[changedIndex]] = false;
+   }
+
+   this->changedIndices.clear();
+
+   for (int rank = 0; rank < this->numTopStocks; ++rank)
+   {
+      this->topIndices[rank] = this->rankedIndices[rank];
+   }
+
+   // Close the publish with its version and steady clock
+   this->header->version.store(VERSION + 1, memory_order_relaxed);
+   this->header->publishNanos.store(Platform::getSteadyNanos(), memory_order_relaxed);
+   this->header->sequence.store(SEQUENCE + 2, memory_order_release);
+}
+
+//******************************************************************************
+// Function : publishPortfolio
+// Process  : Check the portfolio's size
+//             Summarize every stock analyzer
+//             Update every symbol
+// Notes    : Throws an exception unless the portfolio has a stock analyzer
+//             per symbol
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void SharedRankingWriter::publishPortfolio(
+   const PortfolioAnalyzer& portfolioAnalyzer)
+{
+   vector<int>            symbolIndices(this->numSymbols); // Every symbol
+   vector<RankingSummary> portfolioSummaries(this->numSymbols); // Of each
+
+   // Check the portfolio's size
+   if (portfolioAnalyzer.getNumStockAnalyzers() != this->numSymbols)
+   {
+      throw exception("Portfolio doesn't match the shared ranking");
+   }
+
+   // Summarize every stock analyzer
+   for (int symbolIndex = 0; symbolIndex < this->numSymbols; ++symbolIndex)
+   {
+      symbolIndices[symbolIndex] = symbolIndex;
+      RankingPublisher::summarizeAnalyzer(
+         portfolioAnalyzer.getStockAnalyzerRefAtIndex(symbolIndex),
+         portfolioAnalyzer.getPeriodsSlope(),
+         portfolioSummaries[symbolIndex]);
+   }
+
+   // Update every symbol
+   this->update(symbolIndices, portfolioSummaries);
+}
+
+//******************************************************************************
+// Function : update
+// Process  : Check the lists
+//             Keep each summary, and note its symbol changed
+//             Publish
+// Notes    : Throws an exception if a symbol index is invalid or the lists
+//             differ in size, nothing is published
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Keeps no signal of its own
+//******************************************************************************
+void SharedRankingWriter::update(
+   const vector<int>& symbolIndices,
+   const vector<RankingSummary>& summaries)
+{
+   // Check the lists
+   if (symbolIndices.size() != summaries.size())
+   {
+      throw exception("Invalid shared ranking update");
+   }
+
+   for (size_t updateIndex = 0;
+        updateIndex < symbolIndices.size();
+        ++updateIndex)
+   {
+      if (symbolIndices[updateIndex] < 0 ||
+          symbolIndices[updateIndex] >= this->numSymbols)
+      {
+         throw exception("Invalid shared ranking update");
+      }
+   }
+
+   // Keep each summary, and note its symbol changed
+   for (size_t updateIndex = 0;
+        updateIndex < symbolIndices.size();
+        ++updateIndex)
+   {
+      const int SYMBOLINDEX = symbolIndices[updateIndex];
+
+      this->summaries[SYMBOLINDEX] = summaries[updateIndex];
+
+      if (!this->isChanged[SYMBOLINDEX])
+      {
+         this->isChanged[SYMBOLINDEX] = true;
+         this->changedIndices.push_back(SYMBOLINDEX);
+      }
+   }
+
+   // Publish
+   this->publish();
+}
+
+//******************************************************************************
+// Function : writeRecord
+// Process  : Open the record, its sequence goes odd
+//             Write the summary, signal, histogram, and rank
+//             Close the record, its sequence goes even
+// Notes    : As with any seqlock, a reader may copy a half written
+//             summary, which the sequence check throws away
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Writes the summary's signal
+//******************************************************************************
+void SharedRankingWriter::writeRecord(const int symbolIndex)
+{
+   SharedRankingRecord&     record    = this->records[symbolIndex];
+   const RankingSummary&    summary   = this->summaries[symbolIndex];
+   const unsigned long long SEQUENCE  =
+      record.sequence.load(memory_order_relaxed);
+   const bool               HASSIGNAL = summary.hasSignalMACD;
+
+   // Open the record
+   record.sequence.store(SEQUENCE + 1, memory_order_relaxed);
+   atomic_thread_fence(memory_order_release);
+
+   // Write the summary, signal, histogram, and rank
+   record.summary.currentMACD  = summary.currentMACD;
+   record.summary.slopeMACD    = summary.slopeMACD;
+   record.summary.signal       = HASSIGNAL ? summary.signalMACD : 0.0;
+   record.summary.histogram    = HASSIGNAL ?
+      summary.currentMACD - summary.signalMACD : 0.0;
+   record.summary.lastClose    = summary.lastClose;
+   record.summary.rankingSlope = summary.rankingSlope;
+   record.summary.rank         = this->ranks[symbolIndex];
+   record.summary.hasSignal    = HASSIGNAL ? 1 : 0;
+
+   // Close the record
+   record.sequence.store(SEQUENCE + 2, memory_order_release);
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Map the shared memory read only
+//             Check it is a whole shared ranking of this layout, and big
+//                enough for its sizes
+//             Find the records, top symbols, and names
+// Notes    : Throws an exception if it can't be mapped, or is not yet or
+//             not a shared ranking of this layout
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SharedRankingReader::SharedRankingReader(const string& segmentName)
+   : segment(NULL),
+     numBytes(0),
+     mapping(0),
+     header(NULL),
+     records(NULL),
+     topIndices(NULL),
+     symbolNames(NULL),
+     numRetries(0)
+{
+   // Map the shared memory read only
+   this->segment = Platform::openSharedMemory(
+      segmentName, this->numBytes, this->mapping);
+   this->header  = reinterpret_cast<const SharedRankingHeader*>(
+      this->segment);
+
+   // Check it is a whole shared ranking of this layout
+   if (this->numBytes < sizeof(SharedRankingHeader) ||
+       SharedRankingWriter::MAGIC !=
+          this->header->magic.load(memory_order_acquire) ||
+       SharedRankingWriter::LAYOUTVERSION != this->header->layoutVersion ||
+       this->header->numSymbols < 1 ||
+       this->header->numTopStocks < 1 ||
+       this->header->numTopStocks > this->header->numSymbols ||
+       this->numBytes < SharedRankingWriter::getSegmentBytes(
+          this->header->numSymbols, this->header->numTopStocks))
+   {
+      Platform::unmapFile(this->segment, this->numBytes, this->mapping);
+      throw exception("Not a shared ranking");
+   }
+
+   // Find the records, top symbols, and names
+   this->records     = reinterpret_cast<const SharedRankingRecord*>(
+      this->segment + sizeof(SharedRankingHeader));
+   this->topIndices  = reinterpret_cast<const int*>(
+      this->records + this->header->numSymbols);
+   this->symbolNames = reinterpret_cast<const char*>(
+      this->topIndices + this->header->numTopStocks);
+} // end SharedRankingReader::SharedRankingReader
+
+//******************************************************************************
+// Function : destructor
+// Process  : Unmap the shared memory
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SharedRankingReader::~SharedRankingReader()
+{
+   Platform::unmapFile(this->segment, this->numBytes, this->mapping);
+} // end SharedRankingReader::~SharedRankingReader
+
+//******************************************************************************
+// Function : getSymbolName
+// Process  : The name at the symbol index, written once before the magic
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* SharedRankingReader::getSymbolName(const int symbolIndex) const
+{
+   if (symbolIndex < 0 || symbolIndex >= this->header->numSymbols)
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   return this->symbolNames +
+          symbolIndex * SharedRankingWriter::SYMBOLNAMEBYTES;
+}
+
+//******************************************************************************
+// Function : readSummary
+// Process  : Until a read is whole, or MAXREADATTEMPTS attempts
+//                Read the record's sequence, try again while it is odd
+//                Copy the summary
+//                The read is whole if the sequence is unchanged
+//                Yield every YIELDATTEMPTS attempts, for a writer that
+//                   shares our processor
+// Notes    : Throws an out_of_range exception for invalid index
+//             The acquire load keeps the copy after the first read of the
+//             sequence, the acquire fence keeps it before the second
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool SharedRankingReader::readSummary(
+   const int symbolIndex,
+   SharedSymbolSummary& summary)
+{
+   if (symbolIndex < 0 || symbolIndex >= this->header->numSymbols)
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   const SharedRankingRecord& record = this->records[symbolIndex];
+
+   for (int attempt = 0;
+        attempt < SharedRankingReader::MAXREADATTEMPTS;
+        ++attempt)
+   {
+      if (attempt > 0)
+      {
+         ++this->numRetries;
+
+         if (0 == attempt % SharedRankingReader::YIELDATTEMPTS)
+         {
+            this_thread::yield();
+         }
+      }
+
+      // Read the record's sequence, try again while it is odd
+      const unsigned long long SEQUENCE =
+         record.sequence.load(memory_order_acquire);
+
+      if (0 != (SEQUENCE & 1))
+      {
+         continue;
+      }
+
+      // Copy the summary, whole if the sequence is unchanged
+      summary = record.summary;
+      atomic_thread_fence(memory_order_acquire);
+
+      if (record.sequence.load(memory_order_relaxed) == SEQUENCE)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
+
+//******************************************************************************
+// Function : readTopStocks
+// Process  : Until a read is whole, or MAXREADATTEMPTS attempts
+//                Read the header's sequence, try again while it is odd
+//                Copy the version, the publish's steady clock, and each top
+//                   symbol's index and summary
+//                The read is whole if the sequence is unchanged
+//                Yield every YIELDATTEMPTS attempts
+// Notes    : A torn index out of range is a torn read, never followed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool SharedRankingReader::readTopStocks(
+   vector<int>& topSymbolIndices,
+   vector<SharedSymbolSummary>& topSummaries,
+   long long& version,
+   long long& publishNanos)
+{
+   const int NUMSYMBOLS = this->header->numSymbols;
+   const int NUMTOP     = this->header->numTopStocks;
+
+   topSymbolIndices.resize(NUMTOP);
+   topSummaries.resize(NUMTOP);
+
+   for (int attempt = 0;
+        attempt < SharedRankingReader::MAXREADATTEMPTS;
+        ++attempt)
+   {
+      bool isWhole = true; // Every index in range?
+
+      if (attempt > 0)
+      {
+         ++this->numRetries;
+
+         if (0 == attempt % SharedRankingReader::YIELDATTEMPTS)
+         {
+            this_thread::yield();
+         }
+      }
+
+      // Read the header's sequence, try again while it is odd
+      const unsigned long long SEQUENCE =
+         this->header->sequence.load(memory_order_acquire);
+
+      if (0 != (SEQUENCE & 1))
+      {
+         continue;
+      }
+
+      // Copy the version, steady clock, and each top symbol
+      version      = this->header->version.load(memory_order_relaxed);
+      publishNanos = this->header->publishNanos.load(memory_order_relaxed);
+
+      for (int rank = 0; rank < NUMTOP && isWhole; ++rank)
+      {
+         const int SYMBOLINDEX = this->topIndices[rank];
+
+         isWhole = SYMBOLINDEX >= 0 && SYMBOLINDEX < NUMSYMBOLS;
+
+         if (isWhole)
+         {
+            topSymbolIndices[rank] = SYMBOLINDEX;
+            topSummaries[rank]     = this->records[SYMBOLINDEX].summary;
+         }
+      }
+
+      // The read is whole if the sequence is unchanged
+      atomic_thread_fence(memory_order_acquire);
+
+      if (isWhole &&
+          this->header->sequence.load(memory_order_relaxed) == SEQUENCE)
+      {
+         return true;
+      }
+   }
+
+   return false;
+}
@@ -0,0 +1,457 @@
+//******************************************************************************
+//
+// File Name:     SharedRanking.h
+//
+// File Overview: Represents a SharedRankingWriter and a SharedRankingReader
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added classes
+//******************************************************************************
+
+#ifndef SharedRanking_h
+#define SharedRanking_h
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "RankingPublisher.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    SharedSymbolSummary
+//
+// Overview: What another process reads of one symbol's analysis
+//             The signal is the StockAnalyzer's, see
+//                StockAnalyzer::getSignalMACD
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Publishes the analyzer's signal
+//
+//******************************************************************************
+struct SharedSymbolSummary
+{
+   double currentMACD;  // MACD of the latest price
+   double slopeMACD;    // Two day MACD slope
+   double signal;       // EMA of the MACDs, 0 until hasSignal
+   double histogram;    // currentMACD less signal, 0 until hasSignal
+   double lastClose;    // Latest price, 0 for none
+   double rankingSlope; // Slope the symbol is ranked by, see
+                        // PortfolioAnalyzer::getRankingSlopeAtIndex
+   int    rank;         // 1 for the highest ranking slope
+   int    hasSignal;    // 1 once the signal has its periods of MACDs
+}; // end struct SharedSymbolSummary
+
+//******************************************************************************
+//
+// Class:    SharedRankingRecord
+//
+// Overview: A symbol's summary in the shared memory, one cache line
+//             sequence is odd while the writer changes the summary, and
+//                moves on by two for each change
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct SharedRankingRecord
+{
+   atomic<unsigned long long> sequence; // Seqlock of the summary
+   SharedSymbolSummary        summary;  // Of the symbol
+}; // end struct SharedRankingRecord
+
+//******************************************************************************
+//
+// Class:    SharedRankingHeader
+//
+// Overview: The first cache line of the shared memory
+//             sequence is odd while the writer publishes, and moves on by
+//                two for each publish, so a reader sees every record and
+//                the top symbols of one publish by checking it alone
+//             magic is written last, once the layout is whole
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct SharedRankingHeader
+{
+   atomic<unsigned int>       magic;         // MAGIC once initialized
+   unsigned int               layoutVersion; // LAYOUTVERSION
+   int                        numSymbols;    // Records
+   int                        numTopStocks;  // Top symbol indices
+   atomic<unsigned long long> sequence;      // Seqlock of every publish
+   atomic<long long>          version;       // Publishes completed
+   atomic<long long>          publishNanos;  // Steady clock of the last one
+   atomic<int>                isClosed;      // 1 once the writer is gone
+   int                        padding[5];    // To a cache line
+}; // end struct SharedRankingHeader
+
+//******************************************************************************
+//
+// Class:    SharedRankingWriter
+//
+// Overview: Publishes the summary and rank of every symbol, and the top
+//             symbols, into named shared memory, so processes on the same
+//             machine read the latest ranking without asking for it
+//             The memory is laid out as:
+//                SharedRankingHeader
+//                a SharedRankingRecord per symbol
+//                the symbol indices of the top symbols, highest first
+//                the name of every symbol, SYMBOLNAMEBYTES each
+//             Each record and the whole publish have their own seqlock, so
+//                readers never block the writer and retry only a read the
+//                writer changed meanwhile, see SharedRankingReader
+//             Symbols are ranked by their ranking slope, equal slopes by
+//                symbol index, as PortfolioAnalyzer::getTopStocksByMACDSlope
+//             One writer thread, readers may be in any process
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class SharedRankingWriter
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Creates the shared memory of the segment name, for a
+   //                symbol of each name ranking the top numTopStocks, and
+   //                publishes zeroed summaries
+   // Constraints : Throws an exception unless there are symbols and every
+   //                size is positive, or if the memory can't be created
+   //***************************************************************************
+   SharedRankingWriter(
+      const string& segmentName,
+      const vector<string>& symbolNames,
+      const int numTopStocks);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Marks the memory closed for its readers, unmaps it, and
+   //                removes its name
+   // Constraints : None
+   //***************************************************************************
+   virtual ~SharedRankingWriter();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getNumPublished
+   // Description : Retrieve the publishes since the memory was created
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumPublished() const;
+
+   //***************************************************************************
+   // Function    : getSegmentBytes
+   // Description : Retrieve the size of the shared memory of numSymbols
+   //                symbols ranking the top numTopStocks
+   // Constraints : None
+   //***************************************************************************
+   static size_t getSegmentBytes(
+      const int numSymbols,
+      const int numTopStocks);
+
+   //***************************************************************************
+   // Function    : publishPortfolio
+   // Description : Publishes the summary of every stock of the portfolio,
+   //                by analyzer index
+   // Constraints : Throws an exception unless the portfolio has a stock
+   //                analyzer per symbol
+   //***************************************************************************
+   void publishPortfolio(const PortfolioAnalyzer& portfolioAnalyzer);
+
+   //***************************************************************************
+   // Function    : update
+   // Description : Publishes the summaries of the symbol indices, and the
+   //                new rank of every symbol
+   // Constraints : Throws an exception if a symbol index is invalid or the
+   //                lists differ in size
+   //***************************************************************************
+   void update(
+      const vector<int>& symbolIndices,
+      const vector<RankingSummary>& summaries);
+
+   static const unsigned int MAGIC           = 0x4B4E4152; // "RANK"
+   static const unsigned int LAYOUTVERSION   = 1;  // Of the memory
+   static const int          SYMBOLNAMEBYTES = 16; // Null terminated
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its shared memory
+   // Constraints : None
+   //***************************************************************************
+   SharedRankingWriter(const SharedRankingWriter&);
+   SharedRankingWriter& operator=(const SharedRankingWriter&);
+
+   //***************************************************************************
+   // Function    : publish
+   // Description : Ranks every symbol, and writes the changed records and
+   //                the top symbols under the header's seqlock
+   // Constraints : None
+   //***************************************************************************
+   void publish();
+
+   //***************************************************************************
+   // Function    : writeRecord
+   // Description : Writes the symbol's summary, signal, and rank to its
+   //                record under the record's seqlock
+   // Constraints : None
+   //***************************************************************************
+   void writeRecord(const int symbolIndex);
+
+   char*                  segment;        // First byte of the memory
+   size_t                 numBytes;       // Of the memory
+   long long              mapping;        // To pass to unmapFile
+   string                 segmentName;    // Of the memory
+   SharedRankingHeader*   header;         // At the start of the memory
+   SharedRankingRecord*   records;        // Of each symbol
+   int*                   topIndices;     // Highest ranking slope first
+   int                    numSymbols;     // Records
+   int                    numTopStocks;   // Top symbol indices
+   vector<RankingSummary> summaries;      // Latest of each symbol
+   vector<int>            rankedIndices;  // Every symbol, highest first
+   vector<int>            mergedIndices;  // Next rankedIndices
+   vector<int>            updatedIndices; // Sorted, of a publish
+   vector<int>            ranks;          // Published, of each symbol
+   vector<int>            changedIndices; // Records to write
+   vector<bool>           isChanged;      // In changedIndices?
+}; // end class SharedRankingWriter
+
+//******************************************************************************
+//
+// Class:    SharedRankingReader
+//
+// Overview: Reads the shared memory of a SharedRankingWriter, mapped read
+//             only, so a read is a copy out of the memory with no request
+//             to the writer and no system call
+//             A read copies what it was asked for, then checks the seqlock
+//                of what it read is even and unchanged, and retries if not,
+//                yielding every YIELDATTEMPTS attempts
+//             readSummary checks the symbol's record alone, readTopStocks
+//                the whole publish, so the ranks it reads agree
+//             One thread per reader
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class SharedRankingReader
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Maps the shared memory of the segment name
+   // Constraints : Throws an exception if it can't be mapped, or is not yet
+   //                or not a shared ranking of this layout
+   //***************************************************************************
+   explicit SharedRankingReader(const string& segmentName);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Unmaps the memory
+   // Constraints : None
+   //***************************************************************************
+   virtual ~SharedRankingReader();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : getNumRetries
+   // Description : Retrieve the reads retried since the reader was made
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumRetries() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols, getNumTopStocks
+   // Description : Retrieve the number of symbols, and of top symbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+   inline int getNumTopStocks() const;
+
+   //***************************************************************************
+   // Function    : getSymbolName
+   // Description : Retrieve the name of the symbol at the index, in the
+   //                shared memory
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   const char* getSymbolName(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getVersion
+   // Description : Retrieve the writer's publishes so far, a cheap check
+   //                for a new ranking
+   // Constraints : None
+   //***************************************************************************
+   inline long long getVersion() const;
+
+   //***************************************************************************
+   // Function    : isClosed
+   // Description : Is the writer gone? Its last publish stays readable
+   // Constraints : None
+   //***************************************************************************
+   inline bool isClosed() const;
+
+   //***************************************************************************
+   // Function    : readSummary
+   // Description : Copies the latest summary of the symbol at the index
+   //                Returns false if the writer was changing it for
+   //                MAXREADATTEMPTS attempts, as a writer that died
+   //                mid-publish leaves it
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   bool readSummary(
+      const int symbolIndex,
+      SharedSymbolSummary& summary);
+
+   //***************************************************************************
+   // Function    : readTopStocks
+   // Description : Copies the top symbols' indices and summaries, the
+   //                version, and the steady clock of the publish, all of
+   //                one publish
+   //                Returns false if the writer was publishing for
+   //                MAXREADATTEMPTS attempts
+   // Constraints : None
+   //***************************************************************************
+   bool readTopStocks(
+      vector<int>& topSymbolIndices,
+      vector<SharedSymbolSummary>& topSummaries,
+      long long& version,
+      long long& publishNanos);
+
+   static const int MAXREADATTEMPTS = 1 << 24; // Before a read gives up
+   static const int YIELDATTEMPTS   = 64;      // Spins before yielding
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its mapping
+   // Constraints : None
+   //***************************************************************************
+   SharedRankingReader(const SharedRankingReader&);
+   SharedRankingReader& operator=(const SharedRankingReader&);
+
+   const char*                segment;     // First byte of the memory
+   size_t                     numBytes;    // Of the memory
+   long long                  mapping;     // To pass to unmapFile
+   const SharedRankingHeader* header;      // At the start of the memory
+   const SharedRankingRecord* records;     // Of each symbol
+   const int*                 topIndices;  // Highest ranking slope first
+   const char*                symbolNames; // SYMBOLNAMEBYTES each
+   long long                  numRetries;  // Reads retried
+}; // end class SharedRankingReader
+
+//******************************************************************************
+// Function : getNumPublished
+// Process  : The header's version
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long SharedRankingWriter::getNumPublished() const
+{
+   return this->header->version.load(memory_order_relaxed);
+}
+
+//******************************************************************************
+// Function : getNumRetries
+// Process  : Accessor for numRetries
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long SharedRankingReader::getNumRetries() const
+{
+   return this->numRetries;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : The header's numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int SharedRankingReader::getNumSymbols() const
+{
+   return this->header->numSymbols;
+}
+
+//******************************************************************************
+// Function : getNumTopStocks
+// Process  : The header's numTopStocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int SharedRankingReader::getNumTopStocks() const
+{
+   return this->header->numTopStocks;
+}
+
+//******************************************************************************
+// Function : getVersion
+// Process  : The header's version
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long SharedRankingReader::getVersion() const
+{
+   return this->header->version.load(memory_order_acquire);
+}
+
+//******************************************************************************
+// Function : isClosed
+// Process  : The header's isClosed
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool SharedRankingReader::isClosed() const
+{
+   return 0 != this->header->isClosed.load(memory_order_acquire);
+}
+
+#endif // SharedRanking_h
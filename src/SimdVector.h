@@ -0,0 +1,240 @@
+//******************************************************************************
+//
+// File Name:     SimdVector.h
+//
+// File Overview: The widest SIMD vectors of doubles and floats the compiler
+//                targets
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added vector
+// 10.19.26       Donne Martin         Added the vector of floats
+//******************************************************************************
+
+#ifndef SimdVector_h
+#define SimdVector_h
+
+//******************************************************************************
+//
+// Overview: DoubleVector is the widest SIMD the compiler targets, one double
+//             per lane, VECTORDOUBLES lanes, and FloatVector one float per
+//             lane, VECTORFLOATS lanes:
+//                SIMDVECTOR_AVX      - __m256d, 4 lanes, __m256, 8 lanes
+//                SIMDVECTOR_SSE2     - __m128d, 2 lanes, __m128, 4 lanes
+//                neither             - double, 1 lane, float, 1 lane
+//           Kernels built on the functions below branch on the same macros
+//              for the operations they add
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added vector
+// 10.19.26       Donne Martin         Added the vector of floats
+//
+//******************************************************************************
+#if defined(__AVX__)
+#define SIMDVECTOR_AVX
+#include <immintrin.h>
+typedef __m256d DoubleVector;
+typedef __m256  FloatVector;
+#elif defined(__SSE2__) || defined(_M_X64) || \
+      (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMDVECTOR_SSE2
+#include <emmintrin.h>
+typedef __m128d DoubleVector;
+typedef __m128  FloatVector;
+#else
+typedef double DoubleVector;
+typedef float  FloatVector;
+#endif
+
+static const int VECTORDOUBLES = sizeof(DoubleVector) / sizeof(double); // Lanes
+static const int VECTORFLOATS  = sizeof(FloatVector) / sizeof(float);   // Lanes
+
+//******************************************************************************
+// Function : broadcastVector, greaterVectors, loadVector, storeVector
+// Process  : Every lane the value, a bit per lane set if first is greater
+//             than second, load and store VECTORDOUBLES doubles
+// Notes    : Loads and stores are unaligned
+//             Like the C++ operator, a comparison with NaN is false
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+#if defined(SIMDVECTOR_AVX)
+static inline DoubleVector broadcastVector(const double value)
+{
+   return _mm256_set1_pd(value);
+}
+
+static inline unsigned int greaterVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   return _mm256_movemask_pd(_mm256_cmp_pd(first, second, _CMP_GT_OQ));
+}
+
+static inline DoubleVector loadVector(const double* values)
+{
+   return _mm256_loadu_pd(values);
+}
+
+static inline void storeVector(
+   double* values,
+   const DoubleVector vector)
+{
+   _mm256_storeu_pd(values, vector);
+}
+#elif defined(SIMDVECTOR_SSE2)
+static inline DoubleVector broadcastVector(const double value)
+{
+   return _mm_set1_pd(value);
+}
+
+static inline unsigned int greaterVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   return _mm_movemask_pd(_mm_cmpgt_pd(first, second));
+}
+
+static inline DoubleVector loadVector(const double* values)
+{
+   return _mm_loadu_pd(values);
+}
+
+static inline void storeVector(
+   double* values,
+   const DoubleVector vector)
+{
+   _mm_storeu_pd(values, vector);
+}
+#else
+static inline DoubleVector broadcastVector(const double value)
+{
+   return value;
+}
+
+static inline unsigned int greaterVectors(
+   const DoubleVector first,
+   const DoubleVector second)
+{
+   return first > second;
+}
+
+static inline DoubleVector loadVector(const double* values)
+{
+   return *values;
+}
+
+static inline void storeVector(
+   double* values,
+   const DoubleVector vector)
+{
+   *values = vector;
+}
+#endif
+
+//******************************************************************************
+// Function : loadVector, multiplyAdd, sumVector, zeroVector
+// Process  : Load VECTORFLOATS floats, first * second + sum per lane,
+//             add the lanes, all lanes 0
+// Notes    : Loads are unaligned
+//             multiplyAdd fuses when the compiler targets FMA
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function, from CorrelationMatrix
+//******************************************************************************
+#if defined(SIMDVECTOR_AVX)
+static inline FloatVector loadVector(const float* values)
+{
+   return _mm256_loadu_ps(values);
+}
+
+static inline FloatVector multiplyAdd(
+   const FloatVector first,
+   const FloatVector second,
+   const FloatVector sum)
+{
+#if defined(__FMA__)
+   return _mm256_fmadd_ps(first, second, sum);
+#else
+   return _mm256_add_ps(_mm256_mul_ps(first, second), sum);
+#endif
+}
+
+static inline float sumVector(const FloatVector vector)
+{
+   __m128 sum = _mm_add_ps(_mm256_castps256_ps128(vector),
+                           _mm256_extractf128_ps(vector, 1));
+
+   sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+   sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+   return _mm_cvtss_f32(sum);
+}
+
+static inline FloatVector zeroVector()
+{
+   return _mm256_setzero_ps();
+}
+#elif defined(SIMDVECTOR_SSE2)
+static inline FloatVector loadVector(const float* values)
+{
+   return _mm_loadu_ps(values);
+}
+
+static inline FloatVector multiplyAdd(
+   const FloatVector first,
+   const FloatVector second,
+   const FloatVector sum)
+{
+   return _mm_add_ps(_mm_mul_ps(first, second), sum);
+}
+
+static inline float sumVector(const FloatVector vector)
+{
+   __m128 sum = _mm_add_ps(vector, _mm_movehl_ps(vector, vector));
+
+   sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+   return _mm_cvtss_f32(sum);
+}
+
+static inline FloatVector zeroVector()
+{
+   return _mm_setzero_ps();
+}
+#else
+static inline FloatVector loadVector(const float* values)
+{
+   return *values;
+}
+
+static inline FloatVector multiplyAdd(
+   const FloatVector first,
+   const FloatVector second,
+   const FloatVector sum)
+{
+   return first * second + sum;
+}
+
+static inline float sumVector(const FloatVector vector)
+{
+   return vector;
+}
+
+static inline FloatVector zeroVector()
+{
+   return 0.0f;
+}
+#endif
+
+#endif // SimdVector_h
@@ -13,6 +13,8 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Templated on a price policy
+// 10.19.26       Donne Martin         Added bars and range queries
 //******************************************************************************
 
 #include "stdafx.h"
@@ -34,9 +36,10 @@
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
 //******************************************************************************                    
-Stock::Stock() 
+template <class PricePolicy>
+BasicStock<PricePolicy>::BasicStock() 
 {
-} // end Stock::Stock
+} // end BasicStock::BasicStock
 
 //******************************************************************************
 // Function : destructor                                   
@@ -48,7 +51,207 @@ Stock::Stock()
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
 //******************************************************************************
-Stock::~Stock()
+template <class PricePolicy>
+BasicStock<PricePolicy>::~BasicStock()
 {
-} // end Stock::~Stock
+} // end BasicStock::~BasicStock
+
+//******************************************************************************
+// Function : getBarStorageBytes                                   
+// Process  : Add the bytes of the highs, lows, volumes, and range indexes
+// Notes    : Counts the reserved capacity, not just the used size
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+int BasicStock<PricePolicy>::getBarStorageBytes() const
+{
+   int bytes = 0; // Of the bars and indexes
+
+   bytes += (this->highs.capacity() + this->lows.capacity()) * 
+            sizeof(StorageType);
+   bytes += this->volumes.capacity() * sizeof(long long);
+
+   for (size_t column = 0; column < this->rangeIndexes.size(); ++column)
+   {
+      bytes += this->rangeIndexes[column].getStorageBytes();
+   }
+
+   return bytes;
+}
+
+//******************************************************************************
+// Function : getRangeIndex                                   
+// Process  : Make the range indexes, if not made
+//             Append to the column's index each value of the column added 
+//                since, converted with the price policy
+// Notes    : The index builds its prefix sums and sparse tables of the 
+//             values appended when it is queried
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+RangeIndex& BasicStock<PricePolicy>::getRangeIndex(const Column column) const
+{
+   // Make the range indexes, if not made
+   if (this->rangeIndexes.empty())
+   {
+      this->rangeIndexes.resize(NUMCOLUMNS);
+   }
+
+   RangeIndex& rangeIndex = this->rangeIndexes[column];
+   int         index      = rangeIndex.getNumValues(); // First value added
+
+   // Append each value of the column added since
+   switch (column)
+   {
+   case COLUMNCLOSE:
+      for (; index < this->getNumPrices(); ++index)
+      {
+         rangeIndex.append(PricePolicy::toAccum(this->prices[index]));
+      }
+      break;
+   case COLUMNHIGH:
+      for (; index < this->getNumBars(); ++index)
+      {
+         rangeIndex.append(PricePolicy::toAccum(this->highs[index]));
+      }
+      break;
+   case COLUMNLOW:
+      for (; index < this->getNumBars(); ++index)
+      {
+         rangeIndex.append(PricePolicy::toAccum(this->lows[index]));
+      }
+      break;
+   default:
+      for (; index < this->getNumBars(); ++index)
+      {
+         rangeIndex.append(double(this->volumes[index]));
+      }
+      break;
+   }
+
+   return rangeIndex;
+}
+
+//******************************************************************************
+// Function : getRangeMaximum                                   
+// Process  : Query the column's range index
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+double BasicStock<PricePolicy>::getRangeMaximum(
+   const Column column, 
+   const int first, 
+   const int last) const
+{
+   return this->getRangeIndex(column).getMaximum(first, last);
+}
+
+//******************************************************************************
+// Function : getRangeMean                                   
+// Process  : Query the column's range index
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+double BasicStock<PricePolicy>::getRangeMean(
+   const Column column, 
+   const int first, 
+   const int last) const
+{
+   return this->getRangeIndex(column).getMean(first, last);
+}
+
+//******************************************************************************
+// Function : getRangeMinimum                                   
+// Process  : Query the column's range index
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+double BasicStock<PricePolicy>::getRangeMinimum(
+   const Column column, 
+   const int first, 
+   const int last) const
+{
+   return this->getRangeIndex(column).getMinimum(first, last);
+}
+
+//******************************************************************************
+// Function : getRangeSum                                   
+// Process  : Query the column's range index
+// Notes    : Throws an exception for an invalid range
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+double BasicStock<PricePolicy>::getRangeSum(
+   const Column column, 
+   const int first, 
+   const int last) const
+{
+   return this->getRangeIndex(column).getSum(first, last);
+}
+
+//******************************************************************************
+// Function : setBars                                   
+// Process  : Convert each high and low with the price policy, copy the 
+//             volumes
+//             Forget the range indexes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+void BasicStock<PricePolicy>::setBars(
+   const double* highs, 
+   const double* lows, 
+   const long long* volumes, 
+   const int numBars)
+{
+   this->highs.resize(numBars);
+   this->lows.resize(numBars);
+   this->volumes.assign(volumes, volumes + numBars);
+
+   for (int barIndex = 0; barIndex < numBars; ++barIndex)
+   {
+      this->highs[barIndex] = PricePolicy::toStorage(highs[barIndex]);
+      this->lows[barIndex]  = PricePolicy::toStorage(lows[barIndex]);
+   }
+
+   this->clearRangeIndexes();
+}
+
+//******************************************************************************
+// Explicit instantiations, one per price policy in PricePolicy.h
+//******************************************************************************
+template class BasicStock<DoublePricePolicy>;
+template class BasicStock<FloatPricePolicy>;
+template class BasicStock<FixedCentsPricePolicy>;
 
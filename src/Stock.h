@@ -10,6 +10,10 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Templated on a price policy
+// 10.19.26       Donne Martin         Added dates
+// 10.19.26       Donne Martin         Added setHistory
+// 10.19.26       Donne Martin         Added bars and range queries
 //******************************************************************************
 
 #ifndef Stock_h
@@ -17,50 +21,150 @@
 
 #include <vector>
 #include <exception>
+#include <algorithm>
+
+#include "PricePolicy.h"
+#include "RangeIndex.h"
 
 using namespace std;
 
 //******************************************************************************
 //
-// Class:    Stock
+// Class:    BasicStock
 //
 // Overview: Represents a Stock, which contains a list of closing prices
+//             PricePolicy decides how each price is stored, see PricePolicy.h
+//             Stock is the BasicStock used by StockAnalyzer
+//             Optionally the date of each price, as a TradingCalendar day
+//                number, when its stock data file has parsable dates
+//             Optionally the high, low, and volume of each price, its bar
+//             Range queries answer the sum, mean, minimum, or maximum of a
+//                column over a range of prices in O(1), from a RangeIndex
+//                of the column built on its first query and extended by
+//                the next query after prices or bars are added
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
-//
-// Notes: Consider adding more data to stock, such as trading volume,
-//          high/low price, etc in addition to just closing price
+// 10.19.26       Donne Martin         Templated on a price policy
+// 10.19.26       Donne Martin         Added dates
+// 10.19.26       Donne Martin         Added setHistory
+// 10.19.26       Donne Martin         Added bars and range queries
 //
 //******************************************************************************
-class Stock
+template <class PricePolicy>
+class BasicStock
 {
 public:
+   typedef typename PricePolicy::StorageType StorageType; // Stored per price
+
+   enum Column
+   {
+      COLUMNCLOSE,  // Prices
+      COLUMNHIGH,   // High of each bar
+      COLUMNLOW,    // Low of each bar
+      COLUMNVOLUME, // Volume of each bar
+      NUMCOLUMNS
+   };
    
    //***************************************************************************
    // Function    : constructor                                   
    // Description : None
    // Constraints : None
    //***************************************************************************
-   Stock();
+   BasicStock();
 
    //***************************************************************************
    // Function    : destructor                                   
    // Description : Performs cleanup tasks              
    // Constraints : None
    //***************************************************************************
-   virtual ~Stock();   
+   virtual ~BasicStock();   
 
    // Member functions in alphabetical order   
 
+   //***************************************************************************
+   // Function    : addBar                                   
+   // Description : Adds the high, low, and volume of the price with the same 
+   //                index
+   // Constraints : None
+   //***************************************************************************
+   inline void addBar(
+      const double high, 
+      const double low, 
+      const long long volume);
+
+   //***************************************************************************
+   // Function    : addDate                                   
+   // Description : Adds to our list of dates, the date of the price with 
+   //                the same index
+   // Constraints : None
+   //***************************************************************************
+   inline void addDate(const int date);
+
    //***************************************************************************
    // Function    : addPrice                                   
    // Description : Adds to our list of prices            
    // Constraints : None
    //***************************************************************************
    inline void addPrice(const double price);
+
+   //***************************************************************************
+   // Function    : findDateIndex                                   
+   // Description : Retrieve the index of the first price on or after the 
+   //                date, getNumDates if none
+   //                Turns a range of dates into a range of prices
+   // Constraints : The dates must be oldest first
+   //***************************************************************************
+   inline int findDateIndex(const int date) const;
+
+   //***************************************************************************
+   // Function    : getBarStorageBytes                                   
+   // Description : Retrieve the number of bytes used to store the bars and 
+   //                the range indexes
+   // Constraints : None
+   //***************************************************************************
+   int getBarStorageBytes() const;
+   
+   //***************************************************************************
+   // Function    : getDateAt                                   
+   // Description : Retrieve the day number of the price at the specified
+   //                index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getDateAt(const int index) const;
+   
+   //***************************************************************************
+   // Function    : getDateData                                   
+   // Description : Retrieve a pointer to the dates            
+   // Constraints : Only valid while no dates are added
+   //***************************************************************************
+   inline const int* getDateData() const;
+
+   //***************************************************************************
+   // Function    : getHighAt, getLowAt, getVolumeAt                                   
+   // Description : Retrieve the high, low, or volume of the bar at the 
+   //                specified index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline double getHighAt(const int index) const;
+   inline double getLowAt(const int index) const;
+   inline long long getVolumeAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : getNumBars                                   
+   // Description : Retrieve the number of bars, 0 for a stock of closes only
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumBars() const;
+   
+   //***************************************************************************
+   // Function    : getNumDates                                   
+   // Description : Retrieve the number of dates, 0 for an undated stock
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumDates() const;
    
    //***************************************************************************
    // Function    : getNumPrices                                   
@@ -75,18 +179,154 @@ public:
    // Constraints : Throws an out_of_range exception for invalid index
    //***************************************************************************
    inline double getPriceAt(const int index) const;
+
+   //***************************************************************************
+   // Function    : getPriceData                                   
+   // Description : Retrieve a pointer to the stored prices            
+   //                Used by the kernels in MACDKernel.h
+   // Constraints : Only valid while no prices are added
+   //***************************************************************************
+   inline const StorageType* getPriceData() const;
+
+   //***************************************************************************
+   // Function    : getPriceStorageBytes                                   
+   // Description : Retrieve the number of bytes used to store the prices
+   // Constraints : None
+   //***************************************************************************
+   inline int getPriceStorageBytes() const;
+
+   //***************************************************************************
+   // Function    : getRangeMaximum, getRangeMean, getRangeMinimum, 
+   //                getRangeSum                                   
+   // Description : Retrieve the largest, mean, smallest, or sum of the 
+   //                column at indices first through last in O(1)
+   //                The first query of a column builds its index, the first 
+   //                after prices or bars are added extends it
+   // Constraints : Throws an exception unless 0 <= first <= last and last is 
+   //                a price, or a bar for the bar columns
+   //                A query may build an index, so concurrent queries of a 
+   //                stock must be serialized
+   //***************************************************************************
+   double getRangeMaximum(
+      const Column column, 
+      const int first, 
+      const int last) const;
+   double getRangeMean(
+      const Column column, 
+      const int first, 
+      const int last) const;
+   double getRangeMinimum(
+      const Column column, 
+      const int first, 
+      const int last) const;
+   double getRangeSum(
+      const Column column, 
+      const int first, 
+      const int last) const;
       
    //***************************************************************************
    // Function    : reversePriceOrder                                   
-   // Description : Reverse the order of prices
+   // Description : Reverse the order of prices, and of dates and bars
    // Constraints : [first, last) must be a valid range
    //***************************************************************************
    inline void reversePriceOrder();
+      
+   //***************************************************************************
+   // Function    : setHistory                                   
+   // Description : Replaces the prices, and the dates unless dates is NULL,
+   //                with numPrices of each, oldest first, and removes the 
+   //                bars
+   //                Loads a whole history without parsing, such as from
+   //                a UniversePack
+   // Constraints : None
+   //***************************************************************************
+   inline void setHistory(
+      const int* dates, 
+      const double* prices, 
+      const int numPrices);
+
+   //***************************************************************************
+   // Function    : setBars                                   
+   // Description : Replaces the bars with numBars highs, lows, and volumes, 
+   //                oldest first
+   //                Loads the bars of a whole history, such as from a 
+   //                UniversePack
+   // Constraints : None
+   //***************************************************************************
+   void setBars(
+      const double* highs, 
+      const double* lows, 
+      const long long* volumes, 
+      const int numBars);
 
 private:   
-   vector<double> prices;   // Stock prices for the past year
 
-}; // end class Stock
+   //***************************************************************************
+   // Function    : clearRangeIndexes                                   
+   // Description : Forgets the range indexes, when values are replaced 
+   //                rather than added
+   // Constraints : None
+   //***************************************************************************
+   inline void clearRangeIndexes();
+
+   //***************************************************************************
+   // Function    : getRangeIndex                                   
+   // Description : Retrieve the column's range index, holding every value 
+   //                of the column
+   // Constraints : None
+   //***************************************************************************
+   RangeIndex& getRangeIndex(const Column column) const;
+
+   vector<int>                dates;        // Day number of each price, if
+                                            // dated
+   vector<StorageType>        highs;        // High of each bar
+   vector<StorageType>        lows;         // Low of each bar
+   vector<StorageType>        prices;       // Stock prices for the past year
+   mutable vector<RangeIndex> rangeIndexes; // Of each column, empty until
+                                            // the first range query
+   vector<long long>          volumes;      // Volume of each bar
+
+}; // end class BasicStock
+
+// Stock used by StockAnalyzer and PortfolioAnalyzer
+typedef BasicStock<AnalyzerPricePolicy> Stock;
+
+//******************************************************************************
+// Function : addBar                                   
+// Process  : Add to our lists of highs, lows, and volumes           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::addBar(
+   const double high, 
+   const double low, 
+   const long long volume) 
+{ 
+   this->highs.push_back(PricePolicy::toStorage(high)); 
+   this->lows.push_back(PricePolicy::toStorage(low)); 
+   this->volumes.push_back(volume); 
+}
+
+//******************************************************************************
+// Function : addDate                                   
+// Process  : Add to our list of dates           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::addDate(const int date) 
+{ 
+   this->dates.push_back(date); 
+}
 
 //******************************************************************************
 // Function : addPrice                                   
@@ -97,10 +337,141 @@ private:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+//******************************************************************************
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::addPrice(const double price) 
+{ 
+   this->prices.push_back(PricePolicy::toStorage(price)); 
+}
+
+//******************************************************************************
+// Function : clearRangeIndexes                                   
+// Process  : Release the range indexes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::clearRangeIndexes() 
+{ 
+   vector<RangeIndex>().swap(this->rangeIndexes); 
+}
+
+//******************************************************************************
+// Function : findDateIndex                                   
+// Process  : Binary search the dates for the first on or after the date
+// Notes    : The dates must be oldest first
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::findDateIndex(const int date) const 
+{ 
+   return lower_bound(this->dates.begin(), this->dates.end(), date) - 
+          this->dates.begin(); 
+}
+
+//******************************************************************************
+// Function : getDateAt                                   
+// Process  : Retrieve the date at the specified index           
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::getDateAt(const int index) const 
+{ 
+   return this->dates.at(index); 
+}
+
+//******************************************************************************
+// Function : getDateData                                   
+// Process  : Retrieve the dates
+// Notes    : Returns NULL if there are no dates
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline const int* BasicStock<PricePolicy>::getDateData() const 
+{ 
+   return this->dates.empty() ? NULL : &this->dates[0]; 
+}
+
+//******************************************************************************
+// Function : getHighAt                                   
+// Process  : Retrieve the high at the specified index           
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline double BasicStock<PricePolicy>::getHighAt(const int index) const 
+{ 
+   return PricePolicy::toAccum(this->highs.at(index)); 
+}
+
+//******************************************************************************
+// Function : getLowAt                                   
+// Process  : Retrieve the low at the specified index           
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline double BasicStock<PricePolicy>::getLowAt(const int index) const 
+{ 
+   return PricePolicy::toAccum(this->lows.at(index)); 
+}
+
+//******************************************************************************
+// Function : getNumBars                                   
+// Process  : Retrieve the number of bars
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
 //******************************************************************************
-inline void Stock::addPrice(const double price) 
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::getNumBars() const 
 { 
-   this->prices.push_back(price); 
+   return this->volumes.size(); 
+}
+
+//******************************************************************************
+// Function : getNumDates                                   
+// Process  : Retrieve the number of dates
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::getNumDates() const 
+{ 
+   return this->dates.size(); 
 }
 
 //******************************************************************************
@@ -113,7 +484,8 @@ inline void Stock::addPrice(const double price)
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
 //******************************************************************************
-inline int Stock::getNumPrices() const 
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::getNumPrices() const 
 { 
    return this->prices.size(); 
 }
@@ -127,25 +499,126 @@ inline int Stock::getNumPrices() const
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+//******************************************************************************
+template <class PricePolicy>
+inline double BasicStock<PricePolicy>::getPriceAt(const int index) const 
+{ 
+   return PricePolicy::toAccum(this->prices.at(index)); 
+}
+
 //******************************************************************************
-inline double Stock::getPriceAt(const int index) const 
+// Function : getPriceData                                   
+// Process  : Retrieve the stored prices
+// Notes    : Returns NULL if there are no prices
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline const typename BasicStock<PricePolicy>::StorageType* 
+   BasicStock<PricePolicy>::getPriceData() const 
 { 
-   return this->prices.at(index); 
+   return this->prices.empty() ? NULL : &this->prices[0]; 
+}
+
+//******************************************************************************
+// Function : getPriceStorageBytes                                   
+// Process  : Retrieve the number of bytes used to store the prices
+// Notes    : Counts the reserved capacity, not just the used size
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline int BasicStock<PricePolicy>::getPriceStorageBytes() const 
+{ 
+   return this->prices.capacity() * sizeof(StorageType); 
+}
+
+//******************************************************************************
+// Function : getVolumeAt                                   
+// Process  : Retrieve the volume at the specified index           
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class PricePolicy>
+inline long long BasicStock<PricePolicy>::getVolumeAt(const int index) const 
+{ 
+   return this->volumes.at(index); 
 }
 
 //******************************************************************************
 // Function : reversePriceOrder                                   
-// Process  : Reverse the order of prices           
+// Process  : Reverse the order of prices, and of dates and bars
+//             Forget the range indexes
 // Notes    : [first, last) must be a valid range
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Reverses dates
+// 10.19.26       Donne Martin         Reverses bars, forgets range indexes
 //******************************************************************************
-inline void Stock::reversePriceOrder() 
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::reversePriceOrder() 
 { 
    std::reverse(prices.begin(), prices.end()); 
+   std::reverse(dates.begin(), dates.end()); 
+   std::reverse(highs.begin(), highs.end()); 
+   std::reverse(lows.begin(), lows.end()); 
+   std::reverse(volumes.begin(), volumes.end()); 
+   this->clearRangeIndexes();
+}
+
+//******************************************************************************
+// Function : setHistory                                   
+// Process  : Copy the dates, if any, and convert each price with the price
+//             policy
+//             Remove the bars and forget the range indexes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Removes bars, forgets range indexes
+//******************************************************************************
+template <class PricePolicy>
+inline void BasicStock<PricePolicy>::setHistory(
+   const int* dates, 
+   const double* prices, 
+   const int numPrices) 
+{ 
+   if (NULL == dates)
+   {
+      this->dates.clear();
+   }
+   else
+   {
+      this->dates.assign(dates, dates + numPrices);
+   }
+
+   this->prices.resize(numPrices);
+
+   for (int priceIndex = 0; priceIndex < numPrices; ++priceIndex)
+   {
+      this->prices[priceIndex] = PricePolicy::toStorage(prices[priceIndex]);
+   }
+
+   this->highs.clear();
+   this->lows.clear();
+   this->volumes.clear();
+   this->clearRangeIndexes();
 }
 
 #endif // Stock_h
\ No newline at end of file
@@ -13,14 +13,30 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Calculations moved to MACDKernel
+// 10.19.26       Donne Martin         Added updateWithPrice and verbose output
+// 10.19.26       Donne Martin         Added bounded history
+// 10.19.26       Donne Martin         Added metrics
+// 10.19.26       Donne Martin         Traces each stock
+// 10.19.26       Donne Martin         Parses dates
+// 10.19.26       Donne Martin         Added the regression slope of MACD
+// 10.19.26       Donne Martin         Added the last bar
+// 10.19.26       Donne Martin         Added getState and setState
+// 10.19.26       Donne Martin         Periods are fixed once bounded
+// 10.19.26       Donne Martin         Slope periods of 1 are rejected
+// 10.19.26       Donne Martin         Added the signal and the last date
 //******************************************************************************
 
 #include "stdafx.h"
+#include <algorithm>
 #include <exception>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 
+#include "Metrics.h"
 #include "StockAnalyzer.h"
+#include "TradingCalendar.h"
 
 //******************************************************************************
 // File scope (static) variable definitions
@@ -28,24 +44,72 @@
 
 // None
 
+//******************************************************************************
+// Function : copyOldestFirst                                   
+// Process  : Copy the values held by the series into values, oldest first
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+template <class T>
+static void copyOldestFirst(
+   const RingSeries<T>& series, 
+   vector<double>& values)
+{
+   const int SIZE = series.getSize(); // Values held
+
+   values.resize(SIZE);
+
+   for (int index = 0; index < SIZE; ++index)
+   {
+      values[index] = double(series.getFromNewest(SIZE - 1 - index));
+   }
+}
+
 //******************************************************************************
 // Function : constructor                                   
 // Process  : Call initPeriodsToDefaults
+//             Output the analysis by default
+//             Keep the whole history by default
+//             No stock data file name until one is set
+//             No last bar
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Initializes verbose and the file name
+// 10.19.26       Donne Martin         Initializes historyBounded
+// 10.19.26       Donne Martin         Clears the last bar
+// 10.19.26       Donne Martin         Unbounded before the periods are set
+// 10.19.26       Donne Martin         Zeroes the running EMAs
+// 10.19.26       Donne Martin         Sizes the signal
 //******************************************************************************                    
 StockAnalyzer::StockAnalyzer() 
+   : historyBounded(false),
+     runningEMAFast(0),
+     runningEMASlow(0),
+     signalMACD(
+        StockAnalyzer::DEFAULTSIGNALPERIODS,
+        ExponentialAverage::getEMASmoothing(
+           StockAnalyzer::DEFAULTSIGNALPERIODS))
 {
    this->initPeriodsToDefaults();
+   this->setVerbose(true);
+   this->setHistoryBounded(false);
+   this->setStockDataFileName(NULL);
+   this->clearLastBar();
 } // end StockAnalyzer::StockAnalyzer
 
 //******************************************************************************  
 // Function : constructor                                   
 // Process  : Call initPeriodsToDefaults
+//             Output the analysis by default
+//             Keep the whole history by default
 //             Set the stock data file name
 //             Set the stock
 // Notes    : None
@@ -54,12 +118,26 @@ StockAnalyzer::StockAnalyzer()
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Initializes verbose
+// 10.19.26       Donne Martin         Initializes historyBounded
+// 10.19.26       Donne Martin         Unbounded before the periods are set
+// 10.19.26       Donne Martin         Zeroes the running EMAs
+// 10.19.26       Donne Martin         Sizes the signal
 //******************************************************************************  
 StockAnalyzer::StockAnalyzer(
    char* stockDataFileName,
    const Stock& stock) 
+   : historyBounded(false),
+     runningEMAFast(0),
+     runningEMASlow(0),
+     signalMACD(
+        StockAnalyzer::DEFAULTSIGNALPERIODS,
+        ExponentialAverage::getEMASmoothing(
+           StockAnalyzer::DEFAULTSIGNALPERIODS))
 {  
    this->initPeriodsToDefaults();
+   this->setVerbose(true);
+   this->setHistoryBounded(false);
    this->setStockDataFileName(stockDataFileName);     
    this->setStock(stock);      
 }
@@ -78,9 +156,145 @@ StockAnalyzer::~StockAnalyzer()
 {
 } // end StockAnalyzer::~StockAnalyzer
 
+//******************************************************************************
+// Function : addBoundedEMA                                   
+// Process  : EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)
+//             Nothing to do until there are period prices
+//             With exactly period prices
+//                SMA: period sum / number of periods, summed oldest first
+//                   like MACDKernel
+//                Calculate the EMA multiplier with MACDKernel
+//                The first EMA is the SMA
+//             Otherwise calculate the EMA from the newest price
+//             Add the EMA to the bounded history
+// Notes    : Throws an exception if periodToCalc is invalid
+//             EMAs are kept in the accumulation type, like MACDKernel, so the 
+//                results match analyzeStock's over the whole list
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StockAnalyzer::addBoundedEMA(
+   const int period, 
+   StockAnalyzer::PeriodToCalc periodToCalc)
+{
+   typedef MACDKernel<AnalyzerPricePolicy> Kernel;
+
+   RingSeries<Kernel::AccumType>* recentEMA = NULL; // EMAs to add to
+   Kernel::AccumType              newEMA    = 0;    // EMA of the newest price
+   Kernel::AccumType              sumSMA    = 0;    // Sum of the first period
+                                                    // prices
+   
+   const long long NUMPRICES = this->recentPrices.getNumAppended(); 
+                                          // Prices ever added
+
+   if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
+   {
+      recentEMA = &this->recentEMAFast;
+   }
+   else if (StockAnalyzer::CALCSLOWPERIOD == periodToCalc)
+   {
+      recentEMA = &this->recentEMASlow;
+   }
+   else
+   {
+      throw exception("Unexpected StockAnalyzer::PeriodToCalc value"); 
+   }
+
+   // Nothing to do until there are period prices
+   if (NUMPRICES < period)
+   {
+      return;
+   }
+   else if (NUMPRICES == period)
+   {
+      // SMA: period sum / number of periods, summed oldest first
+      for (int age = period - 1; age >= 0; --age)
+      {
+         sumSMA += AnalyzerPricePolicy::toAccum(
+            this->recentPrices.getFromNewest(age));
+      }
+
+      newEMA = sumSMA / period;
+
+      if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
+      {
+         this->setFirstPeriodSMAFast(newEMA);
+         this->setMultEMAFast(Kernel::calculateMultEMA(period));
+      }
+      else
+      {
+         this->setFirstPeriodSMASlow(newEMA);
+         this->setMultEMASlow(Kernel::calculateMultEMA(period));
+      }
+   }
+   else
+   {
+      // EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)
+      const Kernel::AccumType PREVIOUSEMA = recentEMA->getFromNewest(0);
+      const Kernel::AccumType MULTEMA     = Kernel::AccumType(
+         (StockAnalyzer::CALCFASTPERIOD == periodToCalc) ? 
+         this->getMultEMAFast() : 
+         this->getMultEMASlow());
+
+      newEMA = (AnalyzerPricePolicy::toAccum(
+                  this->recentPrices.getFromNewest(0)) - PREVIOUSEMA) * 
+               MULTEMA + PREVIOUSEMA;
+   }
+
+   recentEMA->append(newEMA);
+}
+
+//******************************************************************************
+// Function : addBoundedPrice                                   
+// Process  : Add the price to the bounded history
+//             Add the fast and slow EMAs
+//             Add the MACD to the regression slope and the signal once there
+//                are EMAs of each period
+//             Recalculate the MACDs once there are two EMAs of each period
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Adds to the regression slope
+// 10.19.26       Donne Martin         Adds to the signal
+//******************************************************************************
+void StockAnalyzer::addBoundedPrice(const double stockPrice)
+{
+   this->recentPrices.append(AnalyzerPricePolicy::toStorage(stockPrice));
+
+   // Add the fast and slow EMAs
+   this->addBoundedEMA(this->getPeriodsFast(), StockAnalyzer::CALCFASTPERIOD);
+   this->addBoundedEMA(this->getPeriodsSlow(), StockAnalyzer::CALCSLOWPERIOD);
+
+   // Add the MACD to the regression slope and the signal once there are EMAs
+   // of each period
+   if (!this->recentEMAFast.isEmpty() && !this->recentEMASlow.isEmpty())
+   {
+      const double MACD = this->getCurrentEMAFast() - this->getCurrentEMASlow();
+
+      this->addRegressionMACD(MACD);
+      this->addSignalMACD(MACD);
+   }
+
+   // Recalculate the MACDs once there are two EMAs of each period
+   if (this->hasMACD())
+   {
+      this->calculateMACDs();
+   }
+}
+
 //******************************************************************************
 // Function : analyzeStock                                   
 // Process  : Call parsePricesFromDataFile to parse the data from the stock file
+//                unless the stock already has prices
+//             Keep the date of the newest price, if the stock has dates
+//             When bounded, stream the prices into the bounded history
+//                instead of calculating over the whole list
 //             Perform the stock analysis with the fast period
 //                Calculate first period SMA
 //                Calculate EMA multiplier
@@ -89,21 +303,70 @@ StockAnalyzer::~StockAnalyzer()
 //                Calculate first period SMA
 //                Calculate EMA multiplier
 //                Calculate EMA
+//             Calculate the regression slope and the signal of the MACDs
 //             Calculate the MACD
-// Notes    : None
+//             Count the stock for Metrics
+// Notes    : Output is only written when verbose
+//             Timed and traced with the stock data file name
+//             Throws an exception if there are too few prices for the MACD
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Skips parsing when prices are set
+// 10.19.26       Donne Martin         Streams when the history is bounded
+// 10.19.26       Donne Martin         Counts symbols processed
+// 10.19.26       Donne Martin         Timed and traced
+// 10.19.26       Donne Martin         Calculates the regression slope
+// 10.19.26       Donne Martin         Calculates the signal, keeps the date
 //******************************************************************************
 void StockAnalyzer::analyzeStock()
 {
-   // Parse the data from the stock file
-   this->parsePricesFromDataFile();
+   METRICS_TIMER_DETAIL(PHASEANALYZESTOCK, this->getStockDataFileName());
+   METRICS_COUNT(COUNTERSYMBOLS, 1);
+
+   // Parse the data from the stock file unless the stock already has prices
+   if (0 == this->stock.getNumPrices() && 0 == this->getNumStockPrices())
+   {
+      this->parsePricesFromDataFile();
+   }
+
+   // Keep the date of the newest price, if the stock has dates
+   if (this->stock.getNumDates() > 0)
+   {
+      this->setLastDate(
+         this->stock.getDateAt(this->stock.getNumDates() - 1));
+   }
+
+   if (this->isVerbose())
+   {
+      cout << "Performing stock analyzis..." << endl << endl;
+   }
 
-   cout << "Performing stock analyzis..." << endl << endl;
-   cout << "Period " << this->getPeriodsFast() << endl;
+   // When bounded, stream the prices into the bounded history
+   if (this->isHistoryBounded())
+   {
+      this->streamStockPrices();
+
+      if (!this->hasMACD())
+      {
+         throw exception("Not enough stock prices for the period");
+      }
+
+      if (this->isVerbose())
+      {
+         this->calculateMACDs();
+         cout << endl;
+      }
+
+      return;
+   }
+
+   if (this->isVerbose())
+   {
+      cout << "Period " << this->getPeriodsFast() << endl;
+   }
    
    // Perform the stock analysis with the fast period
    // Formatted to fit 80 chars
@@ -124,8 +387,11 @@ void StockAnalyzer::analyzeStock()
       this->getPeriodsFast(), 
       StockAnalyzer::CALCFASTPERIOD);
 
-   cout << endl;
-   cout << "Period " << this->getPeriodsSlow() << endl;
+   if (this->isVerbose())
+   {
+      cout << endl;
+      cout << "Period " << this->getPeriodsSlow() << endl;
+   }
    
    // Perform the stock analysis with the fast period
    // Formatted to fit 80 chars
@@ -146,33 +412,43 @@ void StockAnalyzer::analyzeStock()
       this->getPeriodsSlow(), 
       StockAnalyzer::CALCSLOWPERIOD);
 
-   cout << endl;
+   if (this->isVerbose())
+   {
+      cout << endl;
+   }
+
+   // Calculate the regression slope and the signal of the MACDs
+   this->calculateRegressionSlopeMACD();
+   this->calculateSignalMACD();
 
    // Calculate the MACD
    this->calculateMACDs();
 
-   cout << endl;
+   if (this->isVerbose())
+   {
+      cout << endl;
+   }
 }
 
 //******************************************************************************
 // Function : calculateEMA                                   
 // Process  : EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)    
-//             Loop through all prices
-//                If this is not our first rep
-//                   calculate the EMA for the current period using the 
-//                   EMA equation listed above
-//                   Increment our loop counter
-//                   Add the EMA to ouor list of EMAs
-//                Else
-//                   In the first pass, EMA is the input SMA
-//                   Add the EMA to ouor list of EMAs
+//             Size our list of EMAs, the first EMA is the input SMA followed
+//                by one EMA for each price after the first period
+//             Calculate the EMAs directly into the list with MACDKernel,
+//                keeping the newest EMA unrounded for updateWithPrice
 //             Output the current EMA (EMA for the last day calculated)
 // Notes    : Throws an exception if periodToCalc is invalid
+//             Throws an exception if there are fewer prices than the period
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Calculates with MACDKernel
+// 10.19.26       Donne Martin         Output only when verbose
+// 10.19.26       Donne Martin         Timed by Metrics
+// 10.19.26       Donne Martin         Keeps the running EMA
 //******************************************************************************
 void StockAnalyzer::calculateEMA(
    const double firstPeriodSMA, 
@@ -180,106 +456,109 @@ void StockAnalyzer::calculateEMA(
    const int period, 
    StockAnalyzer::PeriodToCalc periodToCalc)
 {
-   double    currentEMA    = 0.0;         // Today's EMA
-   int       currRep       = 0;           // currRep, used to process all prices
-   bool      isFirstPass   = true;        // First pass of while loop?
-   double    tempEMA       = 0.0;         // Holds temp EMA
-   double    yesterdadyEMA = 0.0;         // Yesterday's EMA
+   typedef MACDKernel<AnalyzerPricePolicy> Kernel;
 
-   const int NUMPRICES = this->getNumStockPrices(); // Number of prices
-   const int MAXREPS   = NUMPRICES - period - 1;    // First EMA for the period 
-                                                    // is input SMA so no need
-                                                    // to take first [period]
-                                                    // indices into account
-                                                    // when looping for 
-                                                    // successive EMAs
-   
-   // EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day). 
-   // Loop through all prices
-   while (currRep <= MAXREPS)
-   {
-      // If this is not our first rep, calculate the EMA for the current period
-      // using the EMA equation listed above
-      if (!isFirstPass)
-      {
-         tempEMA = (this->getStockPriceAtIndex(period + currRep) - currentEMA) * multEMA + currentEMA;
-         currentEMA = tempEMA;
+   METRICS_TIMER(PHASEEMA);
 
-         // Increment our loop counter
-         currRep++;
-      }
-      // If this is our first pass, EMA is the input SMA
-      else
-      {
-         currentEMA = firstPeriodSMA;
-         isFirstPass = false;
-      }
+   vector<AnalyzerPricePolicy::StorageType>* listEMA    = NULL; // EMAs to
+                                                                 // fill
+   Kernel::AccumType*                        runningEMA = NULL; // Newest EMA,
+                                                                 // unrounded
 
-      // Add the EMA to ouor list of EMAs
-      if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
-      {
-         this->addEMAFast(currentEMA);
-      }
-      else if (StockAnalyzer::CALCSLOWPERIOD == periodToCalc)
-      {
-         this->addEMASlow(currentEMA);
-      }
-      else
-      {
-         throw exception("Unexpected StockAnalyzer::PeriodToCalc value"); 
-      }
-   }
+   const int NUMPRICES = this->getNumStockPrices(); // Number of prices
+   const int NUMEMAS   = NUMPRICES - period + 1;    // First EMA for the period 
+                                                    // is input SMA, followed 
+                                                    // by one EMA per price
+                                                    // after the first period
 
-   // Output the current EMA (EMA for the last day calculated)
    if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
    {
-      cout << "   currentEMA:     " << this->getCurrentEMAFast() << endl;
+      listEMA    = &this->listEMAFast;
+      runningEMA = &this->runningEMAFast;
    }
    else if (StockAnalyzer::CALCSLOWPERIOD == periodToCalc)
    {
-      cout << "   currentEMA:     " << this->getCurrentEMASlow() << endl;
+      listEMA    = &this->listEMASlow;
+      runningEMA = &this->runningEMASlow;
    }
    else
    {
       throw exception("Unexpected StockAnalyzer::PeriodToCalc value"); 
-   }   
+   }
+
+   if (NUMEMAS < 1)
+   {
+      throw exception("Not enough stock prices for the period");
+   }
+
+   // Size our list of EMAs and calculate the EMAs directly into it
+   listEMA->resize(NUMEMAS);
+
+   Kernel::calculateEMA(
+      this->getStockPriceData(),
+      NUMPRICES,
+      period,
+      Kernel::AccumType(firstPeriodSMA),
+      Kernel::AccumType(multEMA),
+      &(*listEMA)[0],
+      runningEMA);
+
+   // Output the current EMA (EMA for the last day calculated)
+   if (!this->isVerbose())
+   {
+      return;
+   }
+   else if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
+   {
+      cout << "   currentEMA:     " << this->getCurrentEMAFast() << endl;
+   }
+   else
+   {
+      cout << "   currentEMA:     " << this->getCurrentEMASlow() << endl;
+   }
 }
 
 //******************************************************************************
 // Function : calculateFirstPeriodSMA                                   
 // Process  : SMA: period sum / number of periods
-//             Calculate the sum of prices based on the number of periods
-//             Take the average of the sum to determine the SMA
+//             Calculate the SMA of the first period prices with MACDKernel
 //             Update the SMA data member
 //             Output the SMA
 // Notes    : Throws an exception if periodToCalc is invalid
+//             Throws an exception if there are fewer prices than the period
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Calculates with MACDKernel
+// 10.19.26       Donne Martin         Output only when verbose
+// 10.19.26       Donne Martin         Timed by Metrics
 //******************************************************************************
 void StockAnalyzer::calculateFirstPeriodSMA(
    const int period, 
    StockAnalyzer::PeriodToCalc periodToCalc)
 {
+   METRICS_TIMER(PHASESMA);
+
    double    firstPeriodSMA = 0.0;                         // Avg of last period 
                                                            // number of prices
    const int NUMPRICES      = this->getNumStockPrices();   // Number of prices
-   double    sumSMA         = 0.0;                         // Sum of last period 
-                                                           // number of prices
    
-   // SMA: period sum / number of periods 
-   for (int priceIndex = 0; priceIndex < period; ++priceIndex)
+   if (NUMPRICES < period)
    {
-      // Calculate the sum of prices based on the number of periods
-      sumSMA += this->getStockPriceAtIndex(priceIndex);
+      throw exception("Not enough stock prices for the period");
    }
-      
-   // Take the average of the sum to determine the SMA
-   firstPeriodSMA = sumSMA / period;
 
-   cout << "   firstPeriodSMA: " << firstPeriodSMA << endl;
+   // SMA: period sum / number of periods 
+   firstPeriodSMA = MACDKernel<AnalyzerPricePolicy>::calculateFirstPeriodSMA(
+      this->getStockPriceData(), 
+      period);
+
+   if (this->isVerbose())
+   {
+      cout << "   firstPeriodSMA: " << firstPeriodSMA << endl;
+   }
 
    // Output the SMA
    if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
@@ -314,9 +593,13 @@ void StockAnalyzer::calculateFirstPeriodSMA(
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Output only when verbose
+// 10.19.26       Donne Martin         Timed by Metrics
 //******************************************************************************
 void StockAnalyzer::calculateMACDs()
 {
+   METRICS_TIMER(PHASEMACD);
+
    double currentMACD      = 0.0;  // Moving Avg Converge/Diverge for today
    double yesterdayMACD    = 0.0;  // Moving Avg Converge/Diverge for yesterday
    double slopeMACD        = 0.0;  // MACD slope of today and yesterday
@@ -329,7 +612,10 @@ void StockAnalyzer::calculateMACDs()
                                                             // for fast period
    double yesterdayEMASlow = this->getYesterdayEMASlow();   // Yesterday's EMA 
                                                             // for slow period
-   cout << "MACD" << endl;
+   if (this->isVerbose())
+   {
+      cout << "MACD" << endl;
+   }
 
    // MACD = EMA[fast]  EMA[slow]
    // Calculate current and yesterday's MACDs
@@ -355,15 +641,18 @@ void StockAnalyzer::calculateMACDs()
    this->setSlopeMACD(slopeMACD);
    
    // Output the MACDs
-   cout << "   yesterdayMACD:     " << yesterdayMACD << endl;
-   cout << "   currentMACD:       " << currentMACD << endl;
-   cout << "   slopeMACD (2 day): " << slopeMACD << endl;
+   if (this->isVerbose())
+   {
+      cout << "   yesterdayMACD:     " << yesterdayMACD << endl;
+      cout << "   currentMACD:       " << currentMACD << endl;
+      cout << "   slopeMACD (2 day): " << slopeMACD << endl;
+   }
 }
 
 //******************************************************************************
 // Function : calculateMultEMA                                   
 // Process  : Multiplier: (2 / (Time periods + 1))     
-//             Calculate the EMA multiplier
+//             Calculate the EMA multiplier with MACDKernel
 //             Update the EMA multiplier data member
 //             Output the EMA multiplier
 // Notes    : Throws an exception if periodToCalc is invalid
@@ -372,21 +661,23 @@ void StockAnalyzer::calculateMACDs()
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Calculates with MACDKernel
+// 10.19.26       Donne Martin         Output only when verbose
 //******************************************************************************
 void StockAnalyzer::calculateMultEMA(
    const int period, 
    StockAnalyzer::PeriodToCalc periodToCalc)
 {
-   double multEMA                              = 0.0; // EMA multiplier
-   static const double MULTNUMERATOR           = 2.0; // Numerator from equation
-   static const double MULTDENOMADDITIONFACTOR = 1.0; // Denominator add factor 
-                                                      // from equation
+   double multEMA = 0.0; // EMA multiplier
 
    // Multiplier: (2 / (Time periods + 1))  
    // Calculate the EMA multiplier
-   multEMA = (MULTNUMERATOR / (period + (double(MULTDENOMADDITIONFACTOR))));
+   multEMA = MACDKernel<AnalyzerPricePolicy>::calculateMultEMA(period);
 
-   cout << "   multEMA:        " << multEMA << endl;
+   if (this->isVerbose())
+   {
+      cout << "   multEMA:        " << multEMA << endl;
+   }
 
    // Output the EMA multiplier
    if (StockAnalyzer::CALCFASTPERIOD == periodToCalc)
@@ -403,47 +694,255 @@ void StockAnalyzer::calculateMultEMA(
    }
 }
    
+//******************************************************************************
+// Function : calculateRegressionSlopeMACD                                   
+// Process  : Restart the regression slope
+//             MACD = EMA[fast]  EMA[slow], of the same price
+//             The lists of EMAs end on the same, newest, price
+//             Add the last periodsSlope MACDs, oldest first
+// Notes    : Only the last periodsSlope MACDs are read, so this takes
+//             constant time per MACD in the slope, not per price
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StockAnalyzer::calculateRegressionSlopeMACD()
+{
+   const int NUMEMASFAST = this->listEMAFast.size(); // Fast EMAs
+   const int NUMEMASSLOW = this->listEMASlow.size(); // Slow EMAs
+   const int NUMMACDS    = min(                      // MACDs in the slope
+      min(NUMEMASFAST, NUMEMASSLOW), 
+      this->getPeriodsSlope());
+
+   // Restart the regression slope
+   this->regressionMACD.reset(this->getPeriodsSlope());
+
+   // Add the last periodsSlope MACDs, oldest first
+   for (int age = NUMMACDS; age > 0; --age)
+   {
+      this->addRegressionMACD(
+         AnalyzerPricePolicy::toAccum(this->listEMAFast[NUMEMASFAST - age]) - 
+         AnalyzerPricePolicy::toAccum(this->listEMASlow[NUMEMASSLOW - age]));
+   }
+}
+   
+//******************************************************************************
+// Function : calculateSignalMACD
+// Process  : Restart the signal
+//             MACD = EMA[fast]  EMA[slow], of the same price
+//             The lists of EMAs end on the same, newest, price
+//             Add every MACD, oldest first
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StockAnalyzer::calculateSignalMACD()
+{
+   const int NUMEMASFAST = this->listEMAFast.size();     // Fast EMAs
+   const int NUMEMASSLOW = this->listEMASlow.size();     // Slow EMAs
+   const int NUMMACDS    = min(NUMEMASFAST, NUMEMASSLOW); // MACDs
+
+   // Restart the signal
+   this->signalMACD.reset();
+
+   // Add every MACD, oldest first
+   for (int age = NUMMACDS; age > 0; --age)
+   {
+      this->addSignalMACD(
+         AnalyzerPricePolicy::toAccum(this->listEMAFast[NUMEMASFAST - age]) -
+         AnalyzerPricePolicy::toAccum(this->listEMASlow[NUMEMASSLOW - age]));
+   }
+}
+
+//******************************************************************************
+// Function : getState                                   
+// Process  : Copy the periods and prices ever added
+//             Copy the bounded prices and EMAs, oldest first
+//             Copy the seeds and multipliers of the EMAs
+//             Copy the regression slope, the signal, and the last bar and
+//                its date
+// Notes    : Throws an exception unless the history is bounded
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Copies the signal and the last date
+//******************************************************************************
+void StockAnalyzer::getState(StockAnalyzerState& state) const
+{
+   if (!this->isHistoryBounded())
+   {
+      throw exception("Only a bounded analyzer has a state to save");
+   }
+
+   // Copy the periods and prices ever added
+   state.periodsFast  = this->getPeriodsFast();
+   state.periodsSlow  = this->getPeriodsSlow();
+   state.periodsSlope = this->getPeriodsSlope();
+   state.numPrices    = this->recentPrices.getNumAppended();
+
+   // Copy the bounded prices and EMAs, oldest first
+   copyOldestFirst(this->recentPrices, state.recentPrices);
+   copyOldestFirst(this->recentEMAFast, state.recentEMAFast);
+   copyOldestFirst(this->recentEMASlow, state.recentEMASlow);
+
+   // Copy the seeds and multipliers of the EMAs
+   state.firstPeriodSMAFast = this->getFirstPeriodSMAFast();
+   state.firstPeriodSMASlow = this->getFirstPeriodSMASlow();
+   state.multEMAFast        = this->getMultEMAFast();
+   state.multEMASlow        = this->getMultEMASlow();
+
+   // Copy the regression slope, the signal, and the last bar and its date
+   this->regressionMACD.getState(state.regressionMACD);
+   this->signalMACD.getState(state.signalMACD);
+   state.lastBar  = this->lastBar;
+   state.lastDate = this->lastDate;
+}
+   
+//******************************************************************************
+// Function : getStockSymbol                                   
+// Process  : The symbol of our stock data file name
+// Notes    : Empty until a stock data file name is set
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+string StockAnalyzer::getStockSymbol() const
+{
+   return StockAnalyzer::getSymbolFromFileName(this->getStockDataFileName());
+}
+
+//******************************************************************************
+// Function : getSymbolFromFileName                                   
+// Process  : Strip the directory from the stock data file name
+//             Strip the "StockData" prefix and the extension
+// Notes    : StockDataAPL.csv and res/StockDataAPL.csv are both APL
+//             Empty for a NULL file name
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+string StockAnalyzer::getSymbolFromFileName(const char* stockDataFileName)
+{
+   static const string PREFIX = "StockData"; // Prefix of the data files
+   string              symbol;               // Symbol from the file name
+   size_t              position = 0;         // Position in symbol
+
+   if (NULL == stockDataFileName)
+   {
+      return symbol;
+   }
+
+   // Strip the directory
+   symbol   = stockDataFileName;
+   position = symbol.find_last_of("/\\");
+
+   if (string::npos != position)
+   {
+      symbol.erase(0, position + 1);
+   }
+
+   // Strip the "StockData" prefix and the extension
+   if (0 == symbol.compare(0, PREFIX.size(), PREFIX) && 
+       symbol.size() > PREFIX.size())
+   {
+      symbol.erase(0, PREFIX.size());
+   }
+
+   position = symbol.find_last_of('.');
+
+   if (string::npos != position)
+   {
+      symbol.erase(position);
+   }
+
+   return symbol;
+}
+
 //******************************************************************************
 // Function : initPeriodsToDefaults                                   
 // Process  : Initialize the periods to 12, 26             
+//             No regression slope
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Initializes periodsSlope
 //******************************************************************************
 void StockAnalyzer::initPeriodsToDefaults()
 {
    this->setPeriodsFast(StockAnalyzer::DEFAULTFASTPERIODS);
    this->setPeriodsSlow(StockAnalyzer::DEFAULTSLOWPERIODS);
+   this->setPeriodsSlope(StockAnalyzer::DEFAULTSLOPEPERIODS);
 }
 
 //******************************************************************************
 // Function : parsePricesFromDataFile                                       
 // Notes    : Throws an exception if atof fails
 //             Throws an exception if fstream operation fails
+//             Opening and parsing are timed, and bytes and rows counted, 
+//             by Metrics, parsing is traced with the file name
+//             The file has dates when TradingCalendar can parse the first
+//                row's, then the date of each price is kept, and throws an
+//                exception naming the file and line if one doesn't parse
+//             The first row is the newest, its open, high, low, close, and
+//             volume are kept as the last bar
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Output only when verbose
+// 10.19.26       Donne Martin         Added metrics
+// 10.19.26       Donne Martin         Traces the file name
+// 10.19.26       Donne Martin         Parses dates
+// 10.19.26       Donne Martin         Keeps the last bar
+// 10.19.26       Donne Martin         Keeps every bar
+// 10.19.26       Donne Martin         Reuses the tokens every line
+// 10.19.26       Donne Martin         Rejects a row with a bad date
 //******************************************************************************
 void StockAnalyzer::parsePricesFromDataFile()
 {
    static const int   MAX_CHARS_PER_LINE     = 512;   // Max chars per line
-   static const int   MAX_TOKENS_PER_LINE    = 5;     // Max "," per line
+   static const int   MAX_TOKENS_PER_LINE    = 6;     // Max "," per line
    static const char* DELIMITER              = ",";   // CSV files
+   static const int   OPENTOKENINDEX         = 1;     // Open price token index
+   static const int   HIGHTOKENINDEX         = 2;     // High price token index
+   static const int   LOWTOKENINDEX          = 3;     // Low price token index
    static const int   CLOSINGPRICETOKENINDEX = 4;     // Closing price token index
+   static const int   VOLUMETOKENINDEX       = 5;     // Volume token index
    double             closingPrice           = 0.0;   // Closing price
+   long long          volume                 = 0;     // Volume, if any
+   int                date                   = 0;     // Day number of price
+   bool               hasDates               = false; // First row's parsed
    bool               firstPass              = false; // Skip labels
+   int                lineNumber             = 0;     // Of buffer, from 1
    int                numTokens              = 0;     // Num tokens in line
    ifstream           fin;                            // File reader
    char               buffer[MAX_CHARS_PER_LINE];     // Holds line
+   vector<char*>      token(MAX_TOKENS_PER_LINE);     // Tokens in buffer,
+                                                      // reused every line
 
    // Read in the files and save the "Close" price
    // Create a file-reading object and open a file
-   fin.open(this->getStockDataFileName());
+   {
+      METRICS_TIMER(PHASEFILEOPEN);
+      fin.open(this->getStockDataFileName());
+   }
+
+   METRICS_TIMER_DETAIL(PHASEPARSE, this->getStockDataFileName());
 
    // Adapted from http://cs.dvc.edu/HowTo_Cparse.html
    // If there were no problems with the fstream operation
@@ -454,6 +953,8 @@ void StockAnalyzer::parsePricesFromDataFile()
       {
          // Read an entire line into memory
          fin.getline(buffer, MAX_CHARS_PER_LINE);
+         METRICS_COUNT(COUNTERBYTESPARSED, fin.gcount());
+         ++lineNumber;
 
          // Skip the labels
          if (!firstPass)
@@ -461,10 +962,7 @@ void StockAnalyzer::parsePricesFromDataFile()
             firstPass = true;
             continue;
          }
-        
-         // Array to store memory addresses of the tokens in buf
-         vector<char*> token(MAX_TOKENS_PER_LINE);
-    
+
          // Reset num tokens to prepare for the next iteration
          numTokens = 0;
 
@@ -516,7 +1014,49 @@ void StockAnalyzer::parsePricesFromDataFile()
             }
             else
             {
+               volume = (VOLUMETOKENINDEX < numTokens) ? 
+                  atoll(token[VOLUMETOKENINDEX]) : 0;
+
+               // The file has dates if the first row's parses, then every
+               // row's must
+               if (0 == this->stock.getNumPrices())
+               {
+                  hasDates = TradingCalendar::parseDate(token[0], date);
+               }
+               else if (hasDates &&
+                        !TradingCalendar::parseDate(token[0], date))
+               {
+                  ostringstream message; // Exception text
+
+                  message << "Unparsable date in "
+                          << this->getStockDataFileName() << " at line "
+                          << lineNumber;
+
+                  throw exception(message.str().c_str());
+               }
+
+               // The first row is the newest, keep it as the last bar
+               if (0 == this->stock.getNumPrices())
+               {
+                  this->lastBar.open     = atof(token[OPENTOKENINDEX]);
+                  this->lastBar.high     = atof(token[HIGHTOKENINDEX]);
+                  this->lastBar.low      = atof(token[LOWTOKENINDEX]);
+                  this->lastBar.close    = closingPrice;
+                  this->lastBar.volume   = volume;
+                  this->lastBar.numTicks = 1;
+               }
+
                this->addStockPrice(closingPrice);
+               this->addStockBar(atof(token[HIGHTOKENINDEX]), 
+                                 atof(token[LOWTOKENINDEX]), 
+                                 volume);
+               METRICS_COUNT(COUNTERROWSPARSED, 1);
+
+               // Keep the date of the price
+               if (hasDates)
+               {
+                  this->addStockDate(date);
+               }
             }
          }
       } // end while (!fin.eof())
@@ -525,10 +1065,371 @@ void StockAnalyzer::parsePricesFromDataFile()
       // to newest price (size - 1) instead of iterating through the price list backwards
       this->reversePriceOrder();
 
-      cout << "---Loaded stock data from: " << this->getStockDataFileName() << "---" << endl << endl;
+      if (this->isVerbose())
+      {
+         cout << "---Loaded stock data from: " << this->getStockDataFileName() << "---" << endl << endl;
+      }
    } // end if (fin.good()) 
    else 
    {
       throw exception("fstream operation failed");
    }
 }
+
+
+//******************************************************************************
+// Function : setHistoryBounded                                   
+// Process  : Mutator for historyBounded
+//             Size the bounded history, getMaxLookback prices and
+//                NUMRECENTEMAS EMAs of each period, or nothing when unbounded
+//             Restart the regression slope and the signal
+//             When bounded, stream any prices held into the bounded history
+// Notes    : Does nothing if historyBounded doesn't change
+//             Throws an exception if unbounding a history that holds prices,
+//                they were released when it was bounded
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Restarts the regression slope
+// 10.19.26       Donne Martin         Keeps an unchanged history
+// 10.19.26       Donne Martin         Restarts the signal
+//******************************************************************************
+void StockAnalyzer::setHistoryBounded(const bool historyBounded)
+{
+   const int PRICECAPACITY = historyBounded ? this->getMaxLookback() : 0;
+   const int EMACAPACITY   = historyBounded ? StockAnalyzer::NUMRECENTEMAS : 0;
+
+   if (historyBounded == this->historyBounded)
+   {
+      return;
+   }
+
+   if (!historyBounded && this->recentPrices.getNumAppended() > 0)
+   {
+      throw exception("Can't unbound a history that holds prices");
+   }
+
+   this->historyBounded = historyBounded;
+
+   // Size the bounded history
+   this->recentPrices.reset(PRICECAPACITY);
+   this->recentEMAFast.reset(EMACAPACITY);
+   this->recentEMASlow.reset(EMACAPACITY);
+
+   // Restart the regression slope and the signal
+   this->regressionMACD.reset(this->getPeriodsSlope());
+   this->signalMACD.reset();
+
+   // When bounded, stream any prices held into the bounded history
+   if (historyBounded)
+   {
+      this->streamStockPrices();
+   }
+}
+
+//******************************************************************************
+// Function : setPeriodsFast                                   
+// Process  : Check the period doesn't change a bounded history
+//             Mutator for periodsFast           
+// Notes    : Throws an exception if the history is bounded and periodsFast
+//             changes
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Fixed once the history is bounded
+//******************************************************************************
+void StockAnalyzer::setPeriodsFast(const int periodsFast) 
+{ 
+   if (this->isHistoryBounded() && periodsFast != this->getPeriodsFast())
+   {
+      throw exception("Periods can't change once the history is bounded");
+   }
+
+   this->periodsFast = periodsFast; 
+}
+
+//******************************************************************************
+// Function : setPeriodsSlope                                   
+// Process  : Mutator for periodsSlope
+//             Restart the regression slope with periodsSlope MACDs
+// Notes    : Throws an exception if periodsSlope is negative or 1, the slope
+//             of one MACD is always 0
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Rejects 1
+//******************************************************************************
+void StockAnalyzer::setPeriodsSlope(const int periodsSlope)
+{
+   if (periodsSlope < 0 ||
+       (periodsSlope > 0 && periodsSlope < StockAnalyzer::MINSLOPEPERIODS))
+   {
+      throw exception("Regression slope periods must be 0 or at least 2");
+   }
+
+   this->periodsSlope = periodsSlope;
+   this->regressionMACD.reset(periodsSlope);
+}
+
+//******************************************************************************
+// Function : setPeriodsSlow                                   
+// Process  : Check the period doesn't change a bounded history
+//             Mutator for periodsSlow           
+// Notes    : Throws an exception if the history is bounded and periodsSlow
+//             changes
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Fixed once the history is bounded
+//******************************************************************************
+void StockAnalyzer::setPeriodsSlow(const int periodsSlow) 
+{ 
+   if (this->isHistoryBounded() && periodsSlow != this->getPeriodsSlow())
+   {
+      throw exception("Periods can't change once the history is bounded");
+   }
+
+   this->periodsSlow = periodsSlow; 
+}
+
+//******************************************************************************
+// Function : setState                                   
+// Process  : Check the periods and that the history fits them
+//             Empty the history and the stock, and unbound the history, so
+//                the periods can change
+//             Set the periods
+//             Bound the history, sized by the periods, and restart the 
+//                regression slope
+//             Append the prices and EMAs, oldest first, and the prices
+//                ever added
+//             Set the seeds and multipliers of the EMAs
+//             Set the regression slope, the signal, and the last bar and its
+//                date
+//             Recalculate the MACDs from the EMAs, without output
+// Notes    : Throws an exception if the periods are invalid or the history
+//                doesn't fit them, or the signal is invalid
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Unbounds before setting the periods
+// 10.19.26       Donne Martin         Empties the history before unbounding
+// 10.19.26       Donne Martin         Sets the signal and the last date
+//******************************************************************************
+void StockAnalyzer::setState(const StockAnalyzerState& state)
+{
+   const bool VERBOSE = this->isVerbose(); // Restored afterwards
+
+   // Check the periods and that the history fits them
+   if (state.periodsFast <= 0 || state.periodsFast >= state.periodsSlow ||
+       state.periodsSlope < 0 || 
+       int(state.recentPrices.size()) > state.periodsSlow ||
+       state.numPrices < (long long)state.recentPrices.size() ||
+       int(state.recentEMAFast.size()) > StockAnalyzer::NUMRECENTEMAS ||
+       int(state.recentEMASlow.size()) > StockAnalyzer::NUMRECENTEMAS)
+   {
+      throw exception("Invalid stock analyzer state");
+   }
+
+   // Empty the history and the stock, and unbound the history, so the
+   // periods can change
+   this->recentPrices.reset(0);
+   this->stock = Stock();
+   this->setHistoryBounded(false);
+
+   // Set the periods
+   this->setPeriodsFast(state.periodsFast);
+   this->setPeriodsSlow(state.periodsSlow);
+   this->setPeriodsSlope(state.periodsSlope);
+
+   // Bound the history and restart the regression slope
+   this->setHistoryBounded(true);
+
+   // Append the prices and EMAs, and the prices ever added
+   for (size_t index = 0; index < state.recentPrices.size(); ++index)
+   {
+      this->recentPrices.append(
+         AnalyzerPricePolicy::StorageType(state.recentPrices[index]));
+   }
+
+   this->recentPrices.setNumAppended(state.numPrices);
+
+   for (size_t index = 0; index < state.recentEMAFast.size(); ++index)
+   {
+      this->recentEMAFast.append(
+         AnalyzerPricePolicy::AccumType(state.recentEMAFast[index]));
+   }
+
+   for (size_t index = 0; index < state.recentEMASlow.size(); ++index)
+   {
+      this->recentEMASlow.append(
+         AnalyzerPricePolicy::AccumType(state.recentEMASlow[index]));
+   }
+
+   // Set the seeds and multipliers of the EMAs
+   this->setFirstPeriodSMAFast(state.firstPeriodSMAFast);
+   this->setFirstPeriodSMASlow(state.firstPeriodSMASlow);
+   this->setMultEMAFast(state.multEMAFast);
+   this->setMultEMASlow(state.multEMASlow);
+
+   // Set the regression slope, the signal, and the last bar and its date
+   this->regressionMACD.setState(state.regressionMACD);
+   this->signalMACD.setState(state.signalMACD);
+   this->lastBar  = state.lastBar;
+   this->lastDate = state.lastDate;
+
+   // Recalculate the MACDs from the EMAs, without output
+   this->setCurrentMACD(0.0);
+   this->setYesterdayMACD(0.0);
+   this->setSlopeMACD(0.0);
+
+   if (this->hasMACD())
+   {
+      this->setVerbose(false);
+      this->calculateMACDs();
+      this->setVerbose(VERBOSE);
+   }
+}
+
+//******************************************************************************
+// Function : streamStockPrices                                   
+// Process  : Add every price held by the stock, oldest first, without output
+//             Release the stock's prices and the lists of EMAs
+// Notes    : Timed by Metrics
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Timed by Metrics
+//******************************************************************************
+void StockAnalyzer::streamStockPrices()
+{
+   METRICS_TIMER(PHASESTREAM);
+
+   const bool VERBOSE   = this->isVerbose();         // Restored afterwards
+   const int  NUMPRICES = this->stock.getNumPrices(); // Prices held
+
+   // Add every price held by the stock, oldest first, without output
+   this->setVerbose(false);
+
+   for (int priceIndex = 0; priceIndex < NUMPRICES; ++priceIndex)
+   {
+      this->addBoundedPrice(this->stock.getPriceAt(priceIndex));
+   }
+
+   this->setVerbose(VERBOSE);
+
+   // Release the stock's prices and the lists of EMAs
+   this->stock = Stock();
+   vector<AnalyzerPricePolicy::StorageType>().swap(this->listEMAFast);
+   vector<AnalyzerPricePolicy::StorageType>().swap(this->listEMASlow);
+}
+
+//******************************************************************************
+// Function : updateWithBar                                   
+// Process  : Update with the bar's close
+//             Add the bar to the stock's bars, if they were level with its
+//                prices before the close was added
+//             Keep the bar as the last bar
+// Notes    : Throws an exception if the stock was not analyzed yet, 
+//             unless bounded
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Adds to the stock's bars
+//******************************************************************************
+void StockAnalyzer::updateWithBar(const Bar& bar)
+{
+   const int NUMBARS = this->stock.getNumBars(); // Before the update
+
+   this->updateWithPrice(bar.close);
+
+   // Add the bar, if the bars were level with the prices
+   if (!this->isHistoryBounded() && NUMBARS > 0 &&
+       NUMBARS + 1 == this->stock.getNumPrices())
+   {
+      this->addStockBar(bar.high, bar.low, bar.volume);
+   }
+
+   this->lastBar = bar;
+}
+
+//******************************************************************************
+// Function : updateWithPrice                                   
+// Process  : Add the new closing price to the stock
+//             EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)
+//             Calculate the new fast and slow EMAs from the running ones,
+//                with the price as the stock stores it
+//             Add them to our lists of EMAs
+//             Recalculate the MACDs
+//             Add the new MACD to the regression slope and the signal
+//             When bounded, add the price to the bounded history instead
+//             The last bar and its date are no longer known
+// Notes    : Throws an exception if the stock was not analyzed yet, 
+//             unless bounded
+//             The running EMAs are kept in the accumulation type, as
+//                MACDKernel keeps them, so the storage rounding does not
+//                compound and the EMAs match a fresh analyzeStock
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Adds to the bounded history
+// 10.19.26       Donne Martin         Adds to the regression slope
+// 10.19.26       Donne Martin         Clears the last bar
+// 10.19.26       Donne Martin         Continues the unrounded EMAs
+// 10.19.26       Donne Martin         Adds to the signal
+//******************************************************************************
+void StockAnalyzer::updateWithPrice(const double closingPrice)
+{
+   typedef AnalyzerPricePolicy::AccumType AccumType;
+
+   AccumType price = 0; // Closing price as the stock stores it
+
+   this->clearLastBar();
+
+   if (this->isHistoryBounded())
+   {
+      this->addBoundedPrice(closingPrice);
+      return;
+   }
+
+   if (this->listEMAFast.empty() || this->listEMASlow.empty())
+   {
+      throw exception("Stock must be analyzed before it is updated");
+   }
+
+   this->addStockPrice(closingPrice);
+
+   // EMA: {Close - EMA(previous day)} x multiplier + EMA(previous day)
+   price = AnalyzerPricePolicy::toAccum(
+      AnalyzerPricePolicy::toStorage(AccumType(closingPrice)));
+
+   this->runningEMAFast =
+      (price - this->runningEMAFast) * AccumType(this->getMultEMAFast()) +
+      this->runningEMAFast;
+   this->runningEMASlow =
+      (price - this->runningEMASlow) * AccumType(this->getMultEMASlow()) +
+      this->runningEMASlow;
+
+   this->addEMAFast(this->runningEMAFast);
+   this->addEMASlow(this->runningEMASlow);
+
+   // Recalculate the MACDs
+   this->calculateMACDs();
+   this->addRegressionMACD(this->getCurrentMACD());
+   this->addSignalMACD(this->getCurrentMACD());
+}
\ No newline at end of file
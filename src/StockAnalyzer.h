@@ -10,13 +10,70 @@
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Calculations moved to MACDKernel
+// 10.19.26       Donne Martin         Added updateWithPrice and verbose output
+// 10.19.26       Donne Martin         Added bounded history
+// 10.19.26       Donne Martin         Added stock dates
+// 10.19.26       Donne Martin         Added the regression slope of MACD
+// 10.19.26       Donne Martin         Added the last bar
+// 10.19.26       Donne Martin         Added setLastBar
+// 10.19.26       Donne Martin         Keeps the stock's bars
+// 10.19.26       Donne Martin         Added getState and setState
+// 10.19.26       Donne Martin         Periods are fixed once bounded
+// 10.19.26       Donne Martin         Slope periods of 1 are rejected
 //******************************************************************************
 
 #ifndef StockAnalyzer_h
 #define StockAnalyzer_h
 
+#include <string>
+#include <vector>
+
+#include "IndicatorPrimitives.h"
+#include "MACDKernel.h"
+#include "MarketData.h"
+#include "RegressionSlope.h"
+#include "RingSeries.h"
 #include "Stock.h"
 
+//******************************************************************************
+//
+// Class:    StockAnalyzerState
+//
+// Overview: Everything a bounded StockAnalyzer needs to carry on updating
+//             exactly where it stopped, without its history
+//             Prices and EMAs are held as doubles whatever the price policy,
+//                which every policy's types convert to and back exactly
+//             The MACDs are recalculated from the EMAs
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added the signal and the last date
+//
+//******************************************************************************
+struct StockAnalyzerState
+{
+   int                    periodsFast;        // Of the fast EMA
+   int                    periodsSlow;        // Of the slow EMA
+   int                    periodsSlope;       // MACDs in the regression slope
+   long long              numPrices;          // Ever added
+   vector<double>         recentPrices;       // Kept, oldest first, in the
+                                              // policy's storage units
+   vector<double>         recentEMAFast;      // Kept, oldest first
+   vector<double>         recentEMASlow;      // Kept, oldest first
+   double                 firstPeriodSMAFast; // Seed of the fast EMA
+   double                 firstPeriodSMASlow; // Seed of the slow EMA
+   double                 multEMAFast;        // Fast EMA multiplier
+   double                 multEMASlow;        // Slow EMA multiplier
+   RegressionSlope::State regressionMACD;     // Window of MACDs
+   ExponentialAverage::State signalMACD;      // EMA of the MACDs
+   Bar                    lastBar;            // Newest bar, if known
+   int                    lastDate;           // Of the newest bar, 0 if not
+                                              // known
+}; // end struct StockAnalyzerState
+
 //******************************************************************************
 //
 // Class:    StockAnalyzer
@@ -26,11 +83,42 @@
 //             Calculates SMA, EMA, and MACD for a fast and slow period
 //             The default periods are 12 and 26
 //             Use setPeriodsFast and setPeriodsSlow to changes these values
+//             Prices and EMAs are stored as AnalyzerPricePolicy::StorageType
+//             Once analyzed, updateWithPrice advances the analysis one new
+//                closing price at a time
+//             With setHistoryBounded, only the last getMaxLookback prices and
+//                the last two EMAs are kept, in RingSeries, so a long running
+//                stream of updates uses constant memory
+//                A bounded analyzer can also start empty and warm up from
+//                updateWithPrice alone
+//             With setPeriodsSlope, the least squares slope of the last
+//                periodsSlope MACDs is kept alongside the two day slope, in
+//                constant time per price, see RegressionSlope
+//             The signal, the EMA of the last DEFAULTSIGNALPERIODS MACDs, is
+//                kept with each MACD, see ExponentialAverage
+//             The open, high, low, close, and volume of the newest bar, and
+//                its date, are kept when known, from the stock data file or
+//                updateWithBar
+//             The stock keeps the high, low, and volume of every bar from 
+//                the stock data file, and of each updateWithBar after, for
+//                its range queries
+//             A bounded analyzer's getState is enough for setState to carry
+//                on in another analyzer, or another process, bit for bit
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added class
+// 10.19.26       Donne Martin         Calculations moved to MACDKernel
+// 10.19.26       Donne Martin         Added updateWithPrice and verbose output
+// 10.19.26       Donne Martin         Added bounded history
+// 10.19.26       Donne Martin         Added stock dates
+// 10.19.26       Donne Martin         Added the regression slope of MACD
+// 10.19.26       Donne Martin         Added the last bar
+// 10.19.26       Donne Martin         Added setLastBar
+// 10.19.26       Donne Martin         Keeps the stock's bars
+// 10.19.26       Donne Martin         Added getState and setState
+// 10.19.26       Donne Martin         Added the signal and the last date
 //
 //******************************************************************************
 class StockAnalyzer
@@ -67,6 +155,8 @@ public:
    //***************************************************************************
    // Function    : analyzeStock                                   
    // Description : Analyzes the stock, calculates the SMA, EMA, and MACD
+   //                Parses the stock data file unless the stock set with 
+   //                setStock already has prices
    // Constraints : None
    //***************************************************************************
    void analyzeStock();
@@ -120,6 +210,43 @@ public:
    //***************************************************************************
    inline double getFirstPeriodSMASlow() const; 
       
+   //***************************************************************************
+   // Function    : getHistoryStorageBytes                                   
+   // Description : Retrieve the number of bytes used to store the prices, 
+   //                bars, and EMAs
+   // Constraints : None
+   //***************************************************************************
+   inline int getHistoryStorageBytes() const;
+      
+   //***************************************************************************
+   // Function    : getLastBar                                   
+   // Description : Accessor for lastBar, the newest bar's open, high, low,
+   //                close, and volume
+   //                Its numTicks is 0 when the bar is not known, after 
+   //                setStock or updateWithPrice, until setLastBar
+   // Constraints : None
+   //***************************************************************************
+   inline const Bar& getLastBar() const;
+      
+   //***************************************************************************
+   // Function    : getLastDate
+   // Description : Accessor for lastDate, the day number of the newest bar
+   //                0 when not known, after setStock or updateWithPrice,
+   //                until setLastDate, or when the stock data file has no
+   //                dates
+   // Constraints : None
+   //***************************************************************************
+   inline int getLastDate() const;
+
+   //***************************************************************************
+   // Function    : getMaxLookback                                   
+   // Description : Retrieve the number of prices the MACD needs, the longer
+   //                of the fast and slow periods
+   //                The price capacity of a bounded history
+   // Constraints : None
+   //***************************************************************************
+   inline int getMaxLookback() const;
+      
    //***************************************************************************
    // Function    : getMultEMAFast                                   
    // Description : Accessor for multEMAFast            
@@ -137,6 +264,7 @@ public:
    //***************************************************************************
    // Function    : getNumStockPrices                                   
    // Description : Utility for stock.getNumPrices()            
+   //                When bounded, the number of prices ever added
    // Constraints : None
    //***************************************************************************
    inline int getNumStockPrices() const;
@@ -148,6 +276,13 @@ public:
    //***************************************************************************
    inline int getPeriodsFast() const;
       
+   //***************************************************************************
+   // Function    : getPeriodsSlope                                   
+   // Description : Accessor for periodsSlope            
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriodsSlope() const;
+      
    //***************************************************************************
    // Function    : getPeriodsSlow                                   
    // Description : Accessor for periodsSlow            
@@ -155,6 +290,16 @@ public:
    //***************************************************************************
    inline int getPeriodsSlow() const;
       
+   //***************************************************************************
+   // Function    : getRegressionSlopeMACD                                   
+   // Description : Retrieves the least squares slope of the last 
+   //                periodsSlope MACDs, or of all of them while there are
+   //                fewer
+   //                0 until there are two MACDs or when periodsSlope is 0
+   // Constraints : None
+   //***************************************************************************
+   inline double getRegressionSlopeMACD() const;
+      
    //***************************************************************************
    // Function    : getSlopeMACD                                   
    // Description : Accessor for slopeMACD            
@@ -162,20 +307,63 @@ public:
    //***************************************************************************
    inline double getSlopeMACD() const;  
       
+   //***************************************************************************
+   // Function    : getSignalMACD
+   // Description : Retrieves the signal, the EMA of the last
+   //                DEFAULTSIGNALPERIODS MACDs
+   // Constraints : Only meaningful once hasSignalMACD
+   //***************************************************************************
+   inline double getSignalMACD() const;
+
+   //***************************************************************************
+   // Function    : getState                                   
+   // Description : Retrieves the bounded history, EMAs, regression slope, 
+   //                and last bar, for setState
+   // Constraints : Throws an exception unless the history is bounded
+   //***************************************************************************
+   void getState(StockAnalyzerState& state) const;
+      
    //***************************************************************************
    // Function    : getStockDataFileName                                   
    // Description : Accessor for stockDataFileName            
    // Constraints : None
    //***************************************************************************
    inline char* getStockDataFileName() const;
+
       
    //***************************************************************************
    // Function    : getStockPriceAtIndex                                   
    // Description : Utility for stock.getPriceAt(index)    
+   //                When bounded, only the last getMaxLookback are kept
    // Constraints : Throws an out_of_range exception for invalid index
+   //                or a price no longer kept
    //***************************************************************************
    inline double getStockPriceAtIndex(int index) const;
       
+   //***************************************************************************
+   // Function    : getStockRef                                   
+   // Description : Retrieve a reference to the stock, with its dates
+   //                When bounded, the prices have been streamed out of it
+   // Constraints : None
+   //***************************************************************************
+   inline const Stock& getStockRef() const;
+      
+   //***************************************************************************
+   // Function    : getStockSymbol                                   
+   // Description : Retrieve the symbol from the stock data file name
+   //                StockDataAPL.csv is APL
+   // Constraints : None
+   //***************************************************************************
+   string getStockSymbol() const;
+      
+   //***************************************************************************
+   // Function    : getSymbolFromFileName                                   
+   // Description : Retrieve the symbol from a stock data file name
+   //                StockDataAPL.csv is APL
+   // Constraints : None
+   //***************************************************************************
+   static string getSymbolFromFileName(const char* stockDataFileName);
+      
    //***************************************************************************
    // Function    : getYesterdayMACD                                   
    // Description : Accessor for yesterdayMACD            
@@ -183,6 +371,36 @@ public:
    //***************************************************************************
    inline double getYesterdayMACD() const;  
       
+   //***************************************************************************
+   // Function    : hasMACD                                   
+   // Description : Are there two EMAs of each period, so the MACDs are set?
+   //                A bounded analyzer started empty has none until it
+   //                has seen one more price than the slow period
+   // Constraints : None
+   //***************************************************************************
+   inline bool hasMACD() const;
+      
+   //***************************************************************************
+   // Function    : hasSignalMACD
+   // Description : Has the signal seen its DEFAULTSIGNALPERIODS MACDs?
+   // Constraints : None
+   //***************************************************************************
+   inline bool hasSignalMACD() const;
+
+   //***************************************************************************
+   // Function    : isHistoryBounded                                   
+   // Description : Accessor for historyBounded            
+   // Constraints : None
+   //***************************************************************************
+   inline bool isHistoryBounded() const;
+      
+   //***************************************************************************
+   // Function    : isVerbose                                   
+   // Description : Accessor for verbose            
+   // Constraints : None
+   //***************************************************************************
+   inline bool isVerbose() const;
+      
    //***************************************************************************
    // Function    : parsePricesFromDataFile                                   
    // Description : Parses the data file and            
@@ -190,19 +408,75 @@ public:
    //***************************************************************************
    void parsePricesFromDataFile();
       
+   //***************************************************************************
+   // Function    : setHistoryBounded                                   
+   // Description : Mutator for historyBounded
+   //                Bounding moves any prices held into the bounded history
+   //                and releases the rest
+   //                Unbounding starts over with an empty history
+   //                Setting the same value keeps the history
+   // Constraints : Set the periods first, they size the bounded history
+   //                Throws an exception if unbounding a history that holds
+   //                prices
+   //***************************************************************************
+   void setHistoryBounded(const bool historyBounded);
+      
+   //***************************************************************************
+   // Function    : setLastBar                                   
+   // Description : Mutator for lastBar, the newest bar of the stock's 
+   //                history, when it comes from somewhere other than the
+   //                stock data file, such as a UniversePack
+   // Constraints : Call after setStock, which clears it
+   //***************************************************************************
+   inline void setLastBar(const Bar& lastBar);
+      
+   //***************************************************************************
+   // Function    : setLastDate
+   // Description : Mutator for lastDate, the day number of the newest bar,
+   //                when it comes from somewhere other than the stock's
+   //                dates
+   // Constraints : Call after setStock or updateWithPrice, which clear it
+   //***************************************************************************
+   inline void setLastDate(const int lastDate);
+
    //***************************************************************************
    // Function    : setPeriodsFast                                   
    // Description : Mutator for periodsFast            
-   // Constraints : None
+   // Constraints : Throws an exception if the history is bounded and
+   //                periodsFast changes, the bounded history was sized by
+   //                the periods and the older prices are gone
+   //***************************************************************************
+   void setPeriodsFast(const int periodsFast);
+      
+   //***************************************************************************
+   // Function    : setPeriodsSlope                                   
+   // Description : Mutator for periodsSlope, the MACDs in the regression 
+   //                slope, 0 for none
+   //                Restarts the regression slope, so set it before the 
+   //                stock is analyzed or bounded
+   // Constraints : Throws an exception if periodsSlope is negative or 1,
+   //                a slope needs MINSLOPEPERIODS MACDs
    //***************************************************************************
-   inline void setPeriodsFast(const int periodsFast);
+   void setPeriodsSlope(const int periodsSlope);
       
    //***************************************************************************
    // Function    : setPeriodsSlow                                   
    // Description : Mutator for periodsSlow            
-   // Constraints : None
+   // Constraints : Throws an exception if the history is bounded and
+   //                periodsSlow changes, the bounded history was sized by
+   //                the periods and the older prices are gone
    //***************************************************************************
-   inline void setPeriodsSlow(const int periodsSlow);
+   void setPeriodsSlow(const int periodsSlow);
+      
+   //***************************************************************************
+   // Function    : setState                                   
+   // Description : Bounds the history and replaces the analysis with state,
+   //                from getState, so updates carry on from it
+   //                The stock is emptied, its dates and bars are not kept
+   // Constraints : Throws an exception if the periods are invalid or the
+   //                history doesn't fit them
+   //***************************************************************************
+   void setState(const StockAnalyzerState& state);
       
    //***************************************************************************
    // Function    : setStock                                   
@@ -217,9 +491,43 @@ public:
    // Constraints : None
    //***************************************************************************
    inline void setStockDataFileName(char* stockDataFileName);
+      
+   //***************************************************************************
+   // Function    : setVerbose                                   
+   // Description : Mutator for verbose
+   //                When false, the analysis writes nothing to cout
+   // Constraints : None
+   //***************************************************************************
+   inline void setVerbose(const bool verbose);
+      
+   //***************************************************************************
+   // Function    : updateWithBar                                   
+   // Description : Calls updateWithPrice with the bar's close and keeps the
+   //                bar as the last bar
+   //                Adds the bar to the stock's bars while they keep up with
+   //                its prices
+   // Constraints : See updateWithPrice
+   //***************************************************************************
+   void updateWithBar(const Bar& bar);
+      
+   //***************************************************************************
+   // Function    : updateWithPrice                                   
+   // Description : Adds a new closing price and updates the EMAs and MACD
+   //                in constant time, without recalculating the history
+   //                When bounded, the MACD is updated once there are enough
+   //                prices for the slow period
+   // Constraints : Throws an exception if analyzeStock was not called,
+   //                unless bounded
+   //***************************************************************************
+   void updateWithPrice(const double closingPrice);
    
    static const int DEFAULTFASTPERIODS = 12; // 12 periods default for fast
    static const int DEFAULTSLOWPERIODS = 26; // 26 periods default for slow
+   static const int DEFAULTSLOPEPERIODS = 0; // No regression slope default
+   static const int DEFAULTSIGNALPERIODS = 9; // MACDs in the signal
+   static const int MINSLOPEPERIODS     = 2; // Fewest MACDs of a slope
+   static const int NUMRECENTEMAS      = 2;  // EMAs kept when bounded, 
+                                             // today's and yesterday's
 
    // Determines whether to calculate fast or slow period
    enum PeriodToCalc
@@ -229,6 +537,28 @@ public:
    };
 
 private:      
+   //***************************************************************************
+   // Function    : addBoundedPrice                                   
+   // Description : Adds the price to the bounded history
+   //                Updates the EMAs, and the MACDs once both are ready
+   //                Private, for internal calculations, 
+   //                   call updateWithPrice instead
+   // Constraints : None
+   //***************************************************************************
+   void addBoundedPrice(const double stockPrice);
+      
+   //***************************************************************************
+   // Function    : addBoundedEMA                                   
+   // Description : Adds the EMA of the newest bounded price for either the
+   //                fast or slow period, once there are period prices
+   //                Private, for internal calculations, 
+   //                   call updateWithPrice instead
+   // Constraints : None
+   //***************************************************************************
+   void addBoundedEMA(
+      const int period, 
+      StockAnalyzer::PeriodToCalc periodToCalc);
+      
    //***************************************************************************
    // Function    : addEMAFast                                   
    // Description : Adds the EMA to our list of emas (fast period)            
@@ -247,6 +577,46 @@ private:
    //***************************************************************************
    inline void addEMASlow(double newEMA);
       
+   //***************************************************************************
+   // Function    : addRegressionMACD                                   
+   // Description : Adds the MACD to the regression slope, if there is one
+   //                Private, for internal calculations, 
+   //                   call analyzeStock instead
+   // Constraints : None
+   //***************************************************************************
+   inline void addRegressionMACD(const double macd);
+      
+   //***************************************************************************
+   // Function    : addSignalMACD
+   // Description : Adds the MACD to the signal
+   //                Private, for internal calculations,
+   //                   call analyzeStock instead
+   // Constraints : None
+   //***************************************************************************
+   inline void addSignalMACD(const double macd);
+
+   //***************************************************************************
+   // Function    : addStockBar                                   
+   // Description : Adds the high, low, and volume of the stock price just 
+   //                added
+   //                Private, for internal calculations, 
+   //                   call analyzeStock instead          
+   // Constraints : None
+   //***************************************************************************
+   inline void addStockBar(
+      const double high, 
+      const double low, 
+      const long long volume);
+      
+   //***************************************************************************
+   // Function    : addStockDate                                   
+   // Description : Adds the date of the stock price just added
+   //                Private, for internal calculations, 
+   //                   call analyzeStock instead          
+   // Constraints : None
+   //***************************************************************************
+   inline void addStockDate(const int date);
+      
    //***************************************************************************
    // Function    : addStockPrice                                   
    // Description : Adds the stock price to our list of prices       
@@ -301,6 +671,43 @@ private:
    //***************************************************************************
    void calculateMACDs();
       
+   //***************************************************************************
+   // Function    : calculateRegressionSlopeMACD                                   
+   // Description : Restarts the regression slope with the last periodsSlope
+   //                MACDs of the lists of EMAs
+   //                Private, for internal calculations, 
+   //                   call analyzeStock instead
+   // Constraints : None
+   //***************************************************************************
+   void calculateRegressionSlopeMACD();
+      
+   //***************************************************************************
+   // Function    : calculateSignalMACD
+   // Description : Restarts the signal and adds every MACD of the lists of
+   //                EMAs
+   //                Private, for internal calculations,
+   //                   call analyzeStock instead
+   // Constraints : None
+   //***************************************************************************
+   void calculateSignalMACD();
+
+   //***************************************************************************
+   // Function    : clearLastBar                                   
+   // Description : Forgets the last bar, its numTicks becomes 0
+   //                Private, for internal calculations
+   // Constraints : None
+   //***************************************************************************
+   inline void clearLastBar();
+      
+   //***************************************************************************
+   // Function    : getStockPriceData                                   
+   // Description : Utility for stock.getPriceData()
+   //                Private, for internal calculations, 
+   //                   call analyzeStock instead       
+   // Constraints : None
+   //***************************************************************************
+   inline const AnalyzerPricePolicy::StorageType* getStockPriceData() const;
+      
    //***************************************************************************
    // Function    : initPeriodsToDefaults                                   
    // Description : Initialize the periods to 12, 26   
@@ -381,25 +788,63 @@ private:
    // Constraints : None
    //***************************************************************************
    inline void setYesterdayMACD(const double yesterdayMACD);
+      
+   //***************************************************************************
+   // Function    : streamStockPrices                                   
+   // Description : Adds every price held by the stock to the bounded history
+   //                Releases the stock's prices and the lists of EMAs
+   //                Private, for internal calculations, 
+   //                   call analyzeStock or setHistoryBounded instead
+   // Constraints : None
+   //***************************************************************************
+   void streamStockPrices();
    
    double currentMACD;           // MACD calculated over one year from today
 
    double firstPeriodSMAFast;    // First fast SMA period for the SMA (average of price)
    double firstPeriodSMASlow;    // First slow SMA period for the SMA (average of price)
 
-   vector<double> listEMAFast;   // List of EMAs for the fast period
-   vector<double> listEMASlow;   // List of EMAs for the slow period
+   bool historyBounded;          // Keep only the recent prices and EMAs?
+
+   Bar lastBar;                  // Newest bar, numTicks 0 when not known
+   int lastDate;                 // Day number of lastBar, 0 when not known
+
+   vector<AnalyzerPricePolicy::StorageType> listEMAFast; // List of EMAs for 
+                                                         // the fast period
+   vector<AnalyzerPricePolicy::StorageType> listEMASlow; // List of EMAs for 
+                                                         // the slow period
 
    double multEMAFast;           // Multiplier to determine the EMA for the fast period
    double multEMASlow;           // Multiplier to determine the EMA for the slow period
 
    int periodsFast;              // Number of days for the fast period
+   int periodsSlope;             // Number of MACDs in the regression slope
    int periodsSlow;              // Number of days for the slow period
 
+   RingSeries<AnalyzerPricePolicy::StorageType> recentPrices; // Prices kept 
+                                                              // when bounded
+   RingSeries<AnalyzerPricePolicy::AccumType> recentEMAFast; // EMAs kept 
+                                                             // when bounded,
+                                                             // fast period
+   RingSeries<AnalyzerPricePolicy::AccumType> recentEMASlow; // EMAs kept 
+                                                             // when bounded,
+                                                             // slow period
+   RegressionSlope regressionMACD; // Slope of the last periodsSlope MACDs
+
+   AnalyzerPricePolicy::AccumType runningEMAFast; // Newest fast EMA before
+                                                  // storage rounding,
+                                                  // continued by
+                                                  // updateWithPrice
+   AnalyzerPricePolicy::AccumType runningEMASlow; // Newest slow EMA before
+                                                  // storage rounding
+
+   ExponentialAverage signalMACD; // EMA of the MACDs
+
    double slopeMACD;             // MACD slope is calculated with currentMACD and yesterdayMACD
    
    Stock stock;                  // Represents the stock
    char* stockDataFileName;      // Contains the stock data over one year
+   bool   verbose;               // Output the analysis to cout?
    double yesterdayMACD;         // MACD calculated over one year from yesterday
 }; // end class StockAnalyzer
 
@@ -412,10 +857,11 @@ private:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
 //******************************************************************************
 inline void StockAnalyzer::addEMAFast(double newEMA) 
 { 
-   listEMAFast.push_back(newEMA); 
+   listEMAFast.push_back(AnalyzerPricePolicy::toStorage(newEMA)); 
 }
 
 //******************************************************************************
@@ -427,10 +873,77 @@ inline void StockAnalyzer::addEMAFast(double newEMA)
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
 //******************************************************************************
 inline void StockAnalyzer::addEMASlow(double newEMA) 
 { 
-   listEMASlow.push_back(newEMA); 
+   listEMASlow.push_back(AnalyzerPricePolicy::toStorage(newEMA)); 
+}
+
+//******************************************************************************
+// Function : addRegressionMACD                                   
+// Process  : Adds the MACD to regressionMACD unless periodsSlope is 0
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StockAnalyzer::addRegressionMACD(const double macd) 
+{ 
+   if (this->getPeriodsSlope() > 0)
+   {
+      this->regressionMACD.add(macd); 
+   }
+}
+
+//******************************************************************************
+// Function : addSignalMACD
+// Process  : Adds the MACD to signalMACD
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StockAnalyzer::addSignalMACD(const double macd)
+{
+   this->signalMACD.add(macd);
+}
+
+//******************************************************************************
+// Function : addStockBar                                   
+// Process  : Adds the high, low, and volume to the stock's bars           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StockAnalyzer::addStockBar(
+   const double high, 
+   const double low, 
+   const long long volume) 
+{ 
+   this->stock.addBar(high, low, volume); 
+}
+
+//******************************************************************************
+// Function : addStockDate                                   
+// Process  : Adds the date to our list of dates           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StockAnalyzer::addStockDate(const int date) 
+{ 
+   this->stock.addDate(date); 
 }
 
 //******************************************************************************
@@ -448,68 +961,127 @@ inline void StockAnalyzer::addStockPrice(const double stockPrice)
    this->stock.addPrice(stockPrice); 
 }
 
+//******************************************************************************
+// Function : clearLastBar                                   
+// Process  : Zero the last bar, no ticks, and its date
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Clears the last date
+//******************************************************************************
+inline void StockAnalyzer::clearLastBar() 
+{ 
+   Bar noBar = { 0, 0.0, 0.0, 0.0, 0.0, 0, 0 }; // Bar with no ticks
+
+   this->lastBar  = noBar;
+   this->lastDate = 0;
+}
+
 //******************************************************************************
 // Function : getCurrentEMAFast                                   
 // Process  : Accessor for last index of listEMAFast           
 // Notes    : Throws an out_of_range exception for invalid index to at()
+//             When bounded, the newest of recentEMAFast
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline double StockAnalyzer::getCurrentEMAFast() const 
 { 
    static const int OFFSETLASTELEMENT = 1;
-   return listEMAFast.at(listEMAFast.size() - OFFSETLASTELEMENT); 
+
+   if (this->isHistoryBounded())
+   {
+      return this->recentEMAFast.getFromNewest(OFFSETLASTELEMENT - 1);
+   }
+
+   return AnalyzerPricePolicy::toAccum(
+      listEMAFast.at(listEMAFast.size() - OFFSETLASTELEMENT)); 
 }
 
 //******************************************************************************
 // Function : getYesterdayEMAFast                                   
 // Process  : Accessor for second last index of listEMAFast               
 // Notes    : Throws an out_of_range exception for invalid index to at()
+//             When bounded, the second newest of recentEMAFast
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline double StockAnalyzer::getYesterdayEMAFast() const 
 { 
    static const int OFFSETSECONDLASTELEMENT = 2;
-   return listEMAFast.at(listEMAFast.size() - OFFSETSECONDLASTELEMENT); 
+
+   if (this->isHistoryBounded())
+   {
+      return this->recentEMAFast.getFromNewest(OFFSETSECONDLASTELEMENT - 1);
+   }
+
+   return AnalyzerPricePolicy::toAccum(
+      listEMAFast.at(listEMAFast.size() - OFFSETSECONDLASTELEMENT)); 
 }  
 
 //******************************************************************************
 // Function : getCurrentEMASlow                                   
 // Process  : Accessor for last index of listEMASlow            
 // Notes    : Throws an out_of_range exception for invalid index to at()
+//             When bounded, the newest of recentEMASlow
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline double StockAnalyzer::getCurrentEMASlow() const 
 { 
    static const int OFFSETLASTELEMENT = 1;
-   return listEMASlow.at(listEMASlow.size() - OFFSETLASTELEMENT); 
+
+   if (this->isHistoryBounded())
+   {
+      return this->recentEMASlow.getFromNewest(OFFSETLASTELEMENT - 1);
+   }
+
+   return AnalyzerPricePolicy::toAccum(
+      listEMASlow.at(listEMASlow.size() - OFFSETLASTELEMENT)); 
 }
 
 //******************************************************************************
 // Function : getYesterdayEMASlow                                   
 // Process  : Accessor for second last index of listEMASlow       
 // Notes    : Throws an out_of_range exception for invalid index to at()
+//             When bounded, the second newest of recentEMASlow
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with the price policy
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline double StockAnalyzer::getYesterdayEMASlow() const 
 { 
    static const int OFFSETSECONDLASTELEMENT = 2;
-   return listEMASlow.at(listEMASlow.size() - OFFSETSECONDLASTELEMENT); 
+
+   if (this->isHistoryBounded())
+   {
+      return this->recentEMASlow.getFromNewest(OFFSETSECONDLASTELEMENT - 1);
+   }
+
+   return AnalyzerPricePolicy::toAccum(
+      listEMASlow.at(listEMASlow.size() - OFFSETSECONDLASTELEMENT)); 
 }
 
 //******************************************************************************
@@ -557,6 +1129,76 @@ inline double StockAnalyzer::getFirstPeriodSMASlow() const
    return this->firstPeriodSMASlow; 
 } 
    
+//******************************************************************************
+// Function : getHistoryStorageBytes                                   
+// Process  : Add the bytes of the stock's prices and bars, the lists of 
+//             EMAs, and the bounded history
+// Notes    : Counts reserved capacity, not just the used size
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Counts the stock's bars
+//******************************************************************************
+inline int StockAnalyzer::getHistoryStorageBytes() const 
+{ 
+   return this->stock.getPriceStorageBytes() + 
+          this->stock.getBarStorageBytes() + 
+          this->listEMAFast.capacity() * 
+             sizeof(AnalyzerPricePolicy::StorageType) + 
+          this->listEMASlow.capacity() * 
+             sizeof(AnalyzerPricePolicy::StorageType) + 
+          this->recentPrices.getStorageBytes() + 
+          this->recentEMAFast.getStorageBytes() + 
+          this->recentEMASlow.getStorageBytes(); 
+}
+
+//******************************************************************************
+// Function : getLastBar                                   
+// Process  : Accessor for lastBar           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const Bar& StockAnalyzer::getLastBar() const 
+{ 
+   return this->lastBar; 
+}
+
+//******************************************************************************
+// Function : getLastDate
+// Process  : Accessor for lastDate
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StockAnalyzer::getLastDate() const
+{
+   return this->lastDate;
+}
+
+//******************************************************************************
+// Function : getMaxLookback                                   
+// Process  : The longer of the fast and slow periods
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StockAnalyzer::getMaxLookback() const 
+{ 
+   return max(this->getPeriodsFast(), this->getPeriodsSlow()); 
+}
+
 //******************************************************************************
 // Function : getMultEMAFast                                   
 // Process  : Accessor for multEMAFast           
@@ -590,15 +1232,21 @@ inline double StockAnalyzer::getMultEMASlow() const
 //******************************************************************************
 // Function : getNumStockPrices                                   
 // Process  : Utility for stock.getNumPrices()           
-// Notes    : None
+// Notes    : When bounded, the number of prices ever added
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline int StockAnalyzer::getNumStockPrices() const 
 { 
+   if (this->isHistoryBounded())
+   {
+      return int(this->recentPrices.getNumAppended());
+   }
+
    return this->stock.getNumPrices(); 
 }
    
@@ -617,6 +1265,21 @@ inline int StockAnalyzer::getPeriodsFast() const
    return this->periodsFast; 
 }
 
+//******************************************************************************
+// Function : getPeriodsSlope                                   
+// Process  : Accessor for periodsSlope           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StockAnalyzer::getPeriodsSlope() const 
+{ 
+   return this->periodsSlope; 
+}
+
 //******************************************************************************
 // Function : getPeriodsSlow                                   
 // Process  : Accessor for periodsSlow           
@@ -631,7 +1294,37 @@ inline int StockAnalyzer::getPeriodsSlow() const
 { 
    return this->periodsSlow; 
 }
+
+//******************************************************************************
+// Function : getRegressionSlopeMACD                                   
+// Process  : Retrieve the slope of regressionMACD           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double StockAnalyzer::getRegressionSlopeMACD() const 
+{ 
+   return this->regressionMACD.getSlope(); 
+}
    
+//******************************************************************************
+// Function : getSignalMACD
+// Process  : The average of signalMACD
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double StockAnalyzer::getSignalMACD() const
+{
+   return this->signalMACD.getAverage();
+}
+
 //******************************************************************************
 // Function : getSlopeMACD                                   
 // Process  : Accessor for slopeMACD           
@@ -666,17 +1359,58 @@ inline char* StockAnalyzer::getStockDataFileName() const
 // Function : getStockPriceAtIndex                                   
 // Process  : Utility for stock.getPriceAt(index)           
 // Notes    : Throws an out_of_range exception for invalid index
+//             When bounded, index counts every price ever added, and only
+//                the last getMaxLookback are kept
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Reads the bounded history
 //******************************************************************************
 inline double StockAnalyzer::getStockPriceAtIndex(int index) const 
 { 
+   if (this->isHistoryBounded())
+   {
+      return AnalyzerPricePolicy::toAccum(
+         this->recentPrices.getFromNewest(
+            this->getNumStockPrices() - 1 - index));
+   }
+
    return this->stock.getPriceAt(index); 
 }
 
+//******************************************************************************
+// Function : getStockPriceData                                   
+// Process  : Utility for stock.getPriceData()           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const AnalyzerPricePolicy::StorageType* 
+   StockAnalyzer::getStockPriceData() const 
+{ 
+   return this->stock.getPriceData(); 
+}
+
+//******************************************************************************
+// Function : getStockRef                                   
+// Process  : Retrieve a reference to the stock           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const Stock& StockAnalyzer::getStockRef() const 
+{ 
+   return this->stock; 
+}
+
 //******************************************************************************
 // Function : getYesterdayMACD                                   
 // Process  : Accessor for yesterdayMACD           
@@ -692,6 +1426,74 @@ inline double StockAnalyzer::getYesterdayMACD() const
    return this->yesterdayMACD; 
 }  
 
+//******************************************************************************
+// Function : hasMACD                                   
+// Process  : Are there two EMAs of each period, in the bounded history or
+//             the lists of EMAs?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool StockAnalyzer::hasMACD() const 
+{ 
+   if (this->isHistoryBounded())
+   {
+      return this->recentEMAFast.getSize() >= StockAnalyzer::NUMRECENTEMAS && 
+             this->recentEMASlow.getSize() >= StockAnalyzer::NUMRECENTEMAS; 
+   }
+
+   return this->listEMAFast.size() >= StockAnalyzer::NUMRECENTEMAS && 
+          this->listEMASlow.size() >= StockAnalyzer::NUMRECENTEMAS; 
+}  
+
+//******************************************************************************
+// Function : hasSignalMACD
+// Process  : Is signalMACD ready?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool StockAnalyzer::hasSignalMACD() const
+{
+   return this->signalMACD.isReady();
+}
+
+//******************************************************************************
+// Function : isHistoryBounded                                   
+// Process  : Accessor for historyBounded           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool StockAnalyzer::isHistoryBounded() const 
+{ 
+   return this->historyBounded; 
+}  
+
+//******************************************************************************
+// Function : isVerbose                                   
+// Process  : Accessor for verbose           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool StockAnalyzer::isVerbose() const 
+{ 
+   return this->verbose; 
+}  
+
 //******************************************************************************
 // Function : reversePriceOrder                                   
 // Process  : Utility for stock.reversePriceOrder()           
@@ -783,33 +1585,33 @@ inline void StockAnalyzer::setMultEMASlow(const double multEMASlow)
 }
 
 //******************************************************************************
-// Function : setPeriodsFast                                   
-// Process  : Mutator for periodsFast           
+// Function : setLastBar                                   
+// Process  : Mutator for lastBar           
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
-// 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Added function
 //******************************************************************************
-inline void StockAnalyzer::setPeriodsFast(const int periodsFast) 
+inline void StockAnalyzer::setLastBar(const Bar& lastBar) 
 { 
-   this->periodsFast = periodsFast; 
+   this->lastBar = lastBar; 
 }
 
 //******************************************************************************
-// Function : setPeriodsSlow                                   
-// Process  : Mutator for periodsSlow           
+// Function : setLastDate
+// Process  : Mutator for lastDate
 // Notes    : None
 //
 // Revision History:
 //
-// Date           Author               Description 
-// 6.25.11        Donne Martin         Added function
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
 //******************************************************************************
-inline void StockAnalyzer::setPeriodsSlow(const int periodsSlow) 
-{ 
-   this->periodsSlow = periodsSlow; 
+inline void StockAnalyzer::setLastDate(const int lastDate)
+{
+   this->lastDate = lastDate;
 }
 
 //******************************************************************************
@@ -830,16 +1632,19 @@ inline void StockAnalyzer::setSlopeMACD(const double slopeMACD)
 //******************************************************************************
 // Function : setStock                                   
 // Process  : Mutator for stock           
+//             Its last bar is not known
 // Notes    : None
 //
 // Revision History:
 //
 // Date           Author               Description 
 // 6.25.11        Donne Martin         Added function
+// 10.19.26       Donne Martin         Clears the last bar
 //******************************************************************************
 inline void StockAnalyzer::setStock(const Stock& stock) 
 { 
    this->stock = stock; 
+   this->clearLastBar();
 }
 
 //******************************************************************************
@@ -857,6 +1662,21 @@ inline void StockAnalyzer::setStockDataFileName(char* stockDataFileName)
    this->stockDataFileName = stockDataFileName; 
 }
 
+//******************************************************************************
+// Function : setVerbose                                   
+// Process  : Mutator for verbose           
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description 
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StockAnalyzer::setVerbose(const bool verbose) 
+{ 
+   this->verbose = verbose; 
+}
+
 //******************************************************************************
 // Function : setYesterdayMACD                                   
 // Process  : Mutator for yesterdayMACD           
@@ -0,0 +1,468 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     StreamingAnalyzer.cpp
+//
+// File Overview: Represents a StreamingAnalyzer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Ranks with SummarySlopeGreater
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+#include "Platform.h"
+#include "StreamingAnalyzer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const double BATCHBUDGETSHARE = 0.8; // Of the memory left under the
+                                            // limit, the rest is slack for
+                                            // the allocator and the output
+
+//******************************************************************************
+// Function : constructor
+// Process  : No memory limit, full history, ranked by MACD slope
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+StreamingAnalyzer::StreamingAnalyzer()
+   : accountedBytes(0),
+     baseResidentBytes(0),
+     bytesPerWeight(0.0),
+     historyBounded(false),
+     maxBatchStocks(0),
+     memoryLimitBytes(0),
+     numBatches(0),
+     numPositiveSlopes(0),
+     numStocks(0),
+     numTopStocks(StreamingAnalyzer::DEFAULTNUMTOPSTOCKS),
+     peakResidentBytes(0),
+     periodsSlope(StockAnalyzer::DEFAULTSLOPEPERIODS),
+     sumCurrentMACD(0.0),
+     universePack(NULL)
+{
+   // Empty
+} // end StreamingAnalyzer::StreamingAnalyzer
+
+//******************************************************************************
+// Function : destructor
+// Process  : Performs cleanup tasks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+StreamingAnalyzer::~StreamingAnalyzer()
+{
+   // Empty
+} // end StreamingAnalyzer::~StreamingAnalyzer
+
+//******************************************************************************
+// Function : analyzeBatches
+// Process  : Reset the top stocks and summary
+//             Measure the memory already in use, the batches share the rest
+//             Load the first batch
+//             Loop through the batches
+//                Once there is an estimate of a batch's bytes, load the
+//                   next batch on a second thread
+//                Analyze the batch and reduce it
+//                Wait for the next batch, check the resident set with both
+//                   batches held, then free the batch
+//                Without an estimate, load the next batch now
+// Notes    : Throws an exception if a stock can't be analyzed or the
+//             memory limit is exceeded, waiting for the prefetch thread
+//             and freeing the batches first
+//             The pilot batch is analyzed alone, it is what estimates
+//                the bytes of the next
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::analyzeBatches(const int numSources)
+{
+   PortfolioAnalyzer* batch      = NULL; // Being analyzed
+   PortfolioAnalyzer* nextBatch  = NULL; // Being loaded
+   int                firstIndex = 0;    // Of the batch
+   int                endIndex   = 0;    // Past the batch
+   int                nextEnd    = 0;    // Past the next batch
+   thread             prefetch;          // Loads the next batch
+
+   // Reset the top stocks and summary
+   this->accountedBytes    = 0;
+   this->bytesPerWeight    = 0.0;
+   this->maxBatchStocks    = 0;
+   this->numBatches        = 0;
+   this->numPositiveSlopes = 0;
+   this->numStocks         = 0;
+   this->sumCurrentMACD    = 0.0;
+   this->loadError.clear();
+   this->topStocks.clear();
+
+   // Measure the memory already in use, the batches share the rest
+   this->baseResidentBytes = Platform::getResidentSetBytes();
+   this->peakResidentBytes = this->baseResidentBytes;
+
+   if (this->memoryLimitBytes > 0 &&
+       this->memoryLimitBytes <= this->baseResidentBytes)
+   {
+      throw exception("The memory limit is less than the memory in use");
+   }
+
+   try
+   {
+      // Load the first batch
+      endIndex = this->getBatchEnd(0, numSources);
+      batch    = new PortfolioAnalyzer();
+      this->loadBatch(batch, 0, endIndex);
+
+      // Loop through the batches
+      while (firstIndex < numSources)
+      {
+         if (!this->loadError.empty())
+         {
+            throw exception(this->loadError.c_str());
+         }
+
+         // Once there is an estimate of a batch's bytes, load the next
+         // batch on a second thread
+         nextEnd = endIndex;
+
+         if (endIndex < numSources &&
+             (this->memoryLimitBytes <= 0 || this->bytesPerWeight > 0.0))
+         {
+            nextEnd   = this->getBatchEnd(endIndex, numSources);
+            nextBatch = new PortfolioAnalyzer();
+            prefetch  = thread(
+               &StreamingAnalyzer::loadBatch,
+               this,
+               nextBatch,
+               endIndex,
+               nextEnd);
+         }
+
+         // Analyze the batch and reduce it
+         batch->analyzePortfolio();
+         this->reduceBatch(*batch, firstIndex, endIndex);
+
+         // Wait for the next batch, check the resident set with both
+         // batches held, then free the batch
+         if (prefetch.joinable())
+         {
+            prefetch.join();
+         }
+
+         this->checkResidentSet();
+         delete batch;
+         batch = NULL;
+
+         // Without an estimate, load the next batch now
+         if (NULL == nextBatch && endIndex < numSources)
+         {
+            nextEnd   = this->getBatchEnd(endIndex, numSources);
+            nextBatch = new PortfolioAnalyzer();
+            this->loadBatch(nextBatch, endIndex, nextEnd);
+         }
+
+         batch      = nextBatch;
+         nextBatch  = NULL;
+         firstIndex = endIndex;
+         endIndex   = nextEnd;
+      }
+   }
+   catch (...)
+   {
+      if (prefetch.joinable())
+      {
+         prefetch.join();
+      }
+
+      delete batch;
+      delete nextBatch;
+      throw;
+   }
+
+   delete batch;
+}
+
+//******************************************************************************
+// Function : analyzePack
+// Process  : Point at the pack
+//             Analyze its symbols in batches
+// Notes    : Throws an exception if a stock can't be analyzed or the
+//             memory limit is exceeded
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::analyzePack(const UniversePack& universePack)
+{
+   this->stockDataFileNames.clear();
+   this->universePack = &universePack;
+
+   try
+   {
+      this->analyzeBatches(universePack.getNumSymbols());
+   }
+   catch (...)
+   {
+      this->universePack = NULL;
+      throw;
+   }
+
+   this->universePack = NULL;
+}
+
+//******************************************************************************
+// Function : analyzeStockDataFiles
+// Process  : Keep the file names, batches point at them
+//             Analyze them in batches
+// Notes    : Throws an exception if a stock can't be analyzed or the
+//             memory limit is exceeded
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::analyzeStockDataFiles(
+   const vector<string>& stockDataFileNames)
+{
+   this->universePack       = NULL;
+   this->stockDataFileNames = stockDataFileNames;
+
+   this->analyzeBatches(this->stockDataFileNames.size());
+   this->stockDataFileNames.clear();
+}
+
+//******************************************************************************
+// Function : checkResidentSet
+// Process  : Record the resident set in the peak
+//             Throw if it is over the limit
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::checkResidentSet()
+{
+   long long residentBytes = Platform::getResidentSetBytes(); // Now
+
+   this->peakResidentBytes = max(this->peakResidentBytes, residentBytes);
+
+   if (this->memoryLimitBytes > 0 && residentBytes > this->memoryLimitBytes)
+   {
+      throw exception("Streaming analysis exceeded its memory limit");
+   }
+}
+
+//******************************************************************************
+// Function : getBatchEnd
+// Process  : Without a limit, DEFAULTBATCHSTOCKS stocks
+//             Without an estimate, the pilot batch
+//             Otherwise the batch budget is a share of the memory left
+//                under the limit, halved for the two batches held at once
+//             Add stocks while their weight fits the budget, at least one
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int StreamingAnalyzer::getBatchEnd(
+   const int firstIndex,
+   const int numSources) const
+{
+   if (this->memoryLimitBytes <= 0)
+   {
+      return min(firstIndex + StreamingAnalyzer::DEFAULTBATCHSTOCKS,
+                 numSources);
+   }
+
+   if (this->bytesPerWeight <= 0.0)
+   {
+      return min(firstIndex + StreamingAnalyzer::PILOTBATCHSTOCKS,
+                 numSources);
+   }
+
+   double batchBytes = (this->memoryLimitBytes - this->baseResidentBytes) *
+                       BATCHBUDGETSHARE / 2; // Budget of one batch
+   long long weight   = this->getSourceWeight(firstIndex); // Of the batch
+   int       endIndex = firstIndex + 1;                    // Past the batch
+
+   // Add stocks while their weight fits the budget
+   while (endIndex < numSources &&
+          (weight + this->getSourceWeight(endIndex)) * this->bytesPerWeight <=
+             batchBytes)
+   {
+      weight += this->getSourceWeight(endIndex);
+      ++endIndex;
+   }
+
+   return endIndex;
+}
+
+//******************************************************************************
+// Function : loadBatch
+// Process  : Set up the batch like the portfolio would be analyzed
+//             A pack copies the batch's symbols, then releases their pages
+//             Otherwise set the batch's data files and parse them
+//             Keep any exception for the analyzing thread
+// Notes    : Runs on the prefetch thread, except for the first batch and
+//             the one after the pilot
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::loadBatch(
+   PortfolioAnalyzer* batch,
+   const int          firstIndex,
+   const int          endIndex)
+{
+   vector<char*> stockDataFileNames; // Of a batch of stock data files
+
+   try
+   {
+      // Set up the batch like the portfolio would be analyzed
+      batch->setVerbose(false);
+      batch->setPeriodsSlope(this->periodsSlope);
+      batch->setHistoryBounded(this->historyBounded);
+
+      // A pack copies the batch's symbols, then releases their pages
+      if (NULL != this->universePack)
+      {
+         batch->addStocksFromPack(
+            *this->universePack, 0, 1, firstIndex, endIndex);
+         this->universePack->releaseSymbols(firstIndex, endIndex);
+         return;
+      }
+
+      // Otherwise set the batch's data files and parse them
+      for (int fileIndex = firstIndex; fileIndex < endIndex; ++fileIndex)
+      {
+         stockDataFileNames.push_back(
+            &this->stockDataFileNames[fileIndex][0]);
+      }
+
+      batch->setStockDataFiles(stockDataFileNames);
+      batch->loadStockData();
+   }
+   catch (exception& error)
+   {
+      // Keep any exception for the analyzing thread
+      this->loadError = error.what();
+   }
+}
+
+//******************************************************************************
+// Function : reduceBatch
+// Process  : Loop through the batch's stock analyzers
+//                Add the stock to the summary and its bytes to the batch's
+//             Keep the most bytes per weight of any batch, the estimate
+//             Merge the batch's top stocks into the top stocks
+// Notes    : A stock's manifest index is its position in the stock data
+//             files, or its directory index in a pack
+//             A stock's bytes are its analyzer, its history, and its dates
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void StreamingAnalyzer::reduceBatch(
+   const PortfolioAnalyzer& batch,
+   const int                firstIndex,
+   const int                endIndex)
+{
+   int         numAnalyzers = batch.getNumStockAnalyzers(); // In the batch
+   long long   batchBytes   = 0;                            // Held by them
+   long long   batchWeight  = 0;                            // Of the sources
+   vector<int> analyzerIndices;                             // Batch's top
+
+   // Loop through the batch's stock analyzers
+   for (int analyzerIndex = 0; analyzerIndex < numAnalyzers; ++analyzerIndex)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         batch.getStockAnalyzerRefAtIndex(analyzerIndex);
+
+      // Add the stock to the summary and its bytes to the batch's
+      this->sumCurrentMACD += stockAnalyzer.getCurrentMACD();
+
+      if (batch.getRankingSlopeAtIndex(analyzerIndex) > 0.0)
+      {
+         ++this->numPositiveSlopes;
+      }
+
+      batchBytes += sizeof(StockAnalyzer) +
+                    stockAnalyzer.getHistoryStorageBytes() +
+                    stockAnalyzer.getStockRef().getNumDates() * sizeof(int);
+   }
+
+   for (int sourceIndex = firstIndex; sourceIndex < endIndex; ++sourceIndex)
+   {
+      batchWeight += this->getSourceWeight(sourceIndex);
+   }
+
+   this->numStocks      += numAnalyzers;
+   this->accountedBytes += batchBytes;
+   this->maxBatchStocks  = max(this->maxBatchStocks, numAnalyzers);
+   ++this->numBatches;
+
+   // Keep the most bytes per weight of any batch, the estimate
+   this->bytesPerWeight = max(this->bytesPerWeight,
+                              (double)batchBytes / batchWeight);
+
+   // Merge the batch's top stocks into the top stocks
+   batch.getTopStocksByMACDSlope(this->numTopStocks, analyzerIndices);
+
+   for (size_t rank = 0; rank < analyzerIndices.size(); ++rank)
+   {
+      const StockAnalyzer& stockAnalyzer =
+         batch.getStockAnalyzerRefAtIndex(analyzerIndices[rank]);
+      ShardStockSummary    summary;       // Of the stock
+
+      summary.symbol        = stockAnalyzer.getStockSymbol();
+      summary.currentMACD   = stockAnalyzer.getCurrentMACD();
+      summary.slopeMACD     = batch.getRankingSlopeAtIndex(
+                                 analyzerIndices[rank]);
+      summary.manifestIndex = (NULL != this->universePack) ?
+         batch.getManifestIndexAtIndex(analyzerIndices[rank]) :
+         firstIndex + analyzerIndices[rank];
+
+      this->topStocks.push_back(summary);
+   }
+
+   sort(this->topStocks.begin(), this->topStocks.end(), SummarySlopeGreater());
+
+   if ((int)this->topStocks.size() > this->numTopStocks)
+   {
+      this->topStocks.resize(max(this->numTopStocks, 0));
+   }
+}
@@ -0,0 +1,481 @@
+//******************************************************************************
+//
+// File Name:     StreamingAnalyzer.h
+//
+// File Overview: Represents a StreamingAnalyzer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef StreamingAnalyzer_h
+#define StreamingAnalyzer_h
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "PortfolioAnalyzer.h"
+#include "ShardResult.h"
+#include "UniversePack.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    StreamingAnalyzer
+//
+// Overview: Analyzes a universe too large to hold in memory at once, a
+//             batch of stocks at a time
+//             Each batch is a PortfolioAnalyzer that is loaded, analyzed,
+//                reduced into the running top stocks and summary, then
+//                freed, while a second thread loads the next batch
+//             With a memory limit, batches are sized so the two resident
+//                at once fit under it, from the bytes per stock, or per
+//                pack row, the batches so far have held
+//                The first batch is a small pilot of PILOTBATCHSTOCKS
+//                   stocks, loaded without a batch behind it
+//                The resident set is checked at the end of every batch,
+//                   when both batches are held, and the analysis stops
+//                   with an exception if it is over the limit
+//                A pack's segments are released once a batch is copied
+//                   from them, see UniversePack::releaseSymbols
+//             Without a limit, batches are DEFAULTBATCHSTOCKS stocks
+//             The top stocks rank as PortfolioAnalyzer::
+//                getTopStocksByMACDSlope would over the whole universe
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class StreamingAnalyzer
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No memory limit, full history, ranked by MACD slope,
+   //                DEFAULTNUMTOPSTOCKS top stocks
+   // Constraints : None
+   //***************************************************************************
+   StreamingAnalyzer();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~StreamingAnalyzer();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : analyzePack
+   // Description : Analyzes the stocks of the pack in batches of its
+   //                directory order
+   //                Symbols with no rows are skipped
+   // Constraints : Throws an exception if a stock can't be analyzed or the
+   //                memory limit is exceeded
+   //                The pack must be open
+   //***************************************************************************
+   void analyzePack(const UniversePack& universePack);
+
+   //***************************************************************************
+   // Function    : analyzeStockDataFiles
+   // Description : Analyzes the stock data files in batches of their order
+   // Constraints : Throws an exception if a stock can't be analyzed or the
+   //                memory limit is exceeded
+   //***************************************************************************
+   void analyzeStockDataFiles(const vector<string>& stockDataFileNames);
+
+   //***************************************************************************
+   // Function    : getAccountedBytes
+   // Description : Retrieves the bytes every batch's stock analyzers held
+   //                once analyzed, about what analyzing the whole
+   //                universe at once would hold
+   // Constraints : None
+   //***************************************************************************
+   inline long long getAccountedBytes() const;
+
+   //***************************************************************************
+   // Function    : getMaxBatchStocks
+   // Description : Retrieves the stocks in the largest batch
+   // Constraints : None
+   //***************************************************************************
+   inline int getMaxBatchStocks() const;
+
+   //***************************************************************************
+   // Function    : getMeanMACD
+   // Description : Retrieves the mean current MACD of the stocks analyzed
+   // Constraints : Returns 0 if none were
+   //***************************************************************************
+   inline double getMeanMACD() const;
+
+   //***************************************************************************
+   // Function    : getNumBatches
+   // Description : Retrieves the batches analyzed
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumBatches() const;
+
+   //***************************************************************************
+   // Function    : getNumPositiveSlopes
+   // Description : Retrieves the stocks analyzed with a positive slope
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumPositiveSlopes() const;
+
+   //***************************************************************************
+   // Function    : getNumStocks
+   // Description : Retrieves the stocks analyzed
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumStocks() const;
+
+   //***************************************************************************
+   // Function    : getPeakResidentBytes
+   // Description : Retrieves the largest resident set seen at the end of a
+   //                batch, see Platform::getResidentSetBytes
+   // Constraints : None
+   //***************************************************************************
+   inline long long getPeakResidentBytes() const;
+
+   //***************************************************************************
+   // Function    : getTopStocks
+   // Description : Retrieves the top stocks by slope, highest first
+   //                Equal slopes keep their manifest order
+   // Constraints : None
+   //***************************************************************************
+   inline const vector<ShardStockSummary>& getTopStocks() const;
+
+   //***************************************************************************
+   // Function    : setHistoryBounded
+   // Description : Mutator for historyBounded, see
+   //                PortfolioAnalyzer::setHistoryBounded
+   // Constraints : None
+   //***************************************************************************
+   inline void setHistoryBounded(const bool historyBounded);
+
+   //***************************************************************************
+   // Function    : setMemoryLimitBytes
+   // Description : Mutator for memoryLimitBytes, the most the resident set
+   //                of the process may reach, 0 for no limit
+   // Constraints : None
+   //***************************************************************************
+   inline void setMemoryLimitBytes(const long long memoryLimitBytes);
+
+   //***************************************************************************
+   // Function    : setNumTopStocks
+   // Description : Mutator for numTopStocks
+   // Constraints : None
+   //***************************************************************************
+   inline void setNumTopStocks(const int numTopStocks);
+
+   //***************************************************************************
+   // Function    : setPeriodsSlope
+   // Description : Mutator for periodsSlope, see
+   //                PortfolioAnalyzer::setPeriodsSlope
+   // Constraints : None
+   //***************************************************************************
+   inline void setPeriodsSlope(const int periodsSlope);
+
+   static const int DEFAULTBATCHSTOCKS  = 1024; // Per batch without a limit
+   static const int DEFAULTNUMTOPSTOCKS = 10;   // Kept in the top stocks
+   static const int PILOTBATCHSTOCKS    = 16;   // In the first batch
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its batches while analyzing
+   // Constraints : None
+   //***************************************************************************
+   StreamingAnalyzer(const StreamingAnalyzer&);
+   StreamingAnalyzer& operator=(const StreamingAnalyzer&);
+
+   //***************************************************************************
+   // Function    : analyzeBatches
+   // Description : Loads, analyzes, and reduces the numSources stocks of
+   //                the pack or stock data files, a batch at a time
+   // Constraints : Throws an exception if a stock can't be analyzed or the
+   //                memory limit is exceeded
+   //***************************************************************************
+   void analyzeBatches(const int numSources);
+
+   //***************************************************************************
+   // Function    : checkResidentSet
+   // Description : Records the resident set in the peak
+   // Constraints : Throws an exception if it is over the memory limit
+   //***************************************************************************
+   void checkResidentSet();
+
+   //***************************************************************************
+   // Function    : getBatchEnd
+   // Description : Retrieves the end of the batch starting at firstIndex,
+   //                as many stocks as fit the batch budget
+   // Constraints : None
+   //***************************************************************************
+   int getBatchEnd(
+      const int firstIndex,
+      const int numSources) const;
+
+   //***************************************************************************
+   // Function    : getSourceWeight
+   // Description : Retrieves the share of a batch's bytes the stock at the
+   //                index needs, its rows in a pack, otherwise 1
+   // Constraints : None
+   //***************************************************************************
+   inline long long getSourceWeight(const int sourceIndex) const;
+
+   //***************************************************************************
+   // Function    : loadBatch
+   // Description : Loads the stocks from firstIndex up to endIndex into
+   //                the batch, without analyzing them
+   //                An exception is kept in loadError
+   // Constraints : Prefetch thread entry point
+   //***************************************************************************
+   void loadBatch(
+      PortfolioAnalyzer* batch,
+      const int firstIndex,
+      const int endIndex);
+
+   //***************************************************************************
+   // Function    : reduceBatch
+   // Description : Adds the analyzed batch starting at firstIndex to the
+   //                top stocks and summary, and its bytes to the estimate
+   // Constraints : None
+   //***************************************************************************
+   void reduceBatch(
+      const PortfolioAnalyzer& batch,
+      const int firstIndex,
+      const int endIndex);
+
+   long long                 accountedBytes;     // Held by every batch
+   long long                 baseResidentBytes;  // Before the first batch
+   double                    bytesPerWeight;     // Most any batch held
+   bool                      historyBounded;     // Of each batch
+   string                    loadError;          // From the prefetch thread
+   int                       maxBatchStocks;     // In the largest batch
+   long long                 memoryLimitBytes;   // 0 for no limit
+   int                       numBatches;         // Analyzed
+   int                       numPositiveSlopes;  // Stocks analyzed
+   int                       numStocks;          // Analyzed
+   int                       numTopStocks;       // Kept in topStocks
+   long long                 peakResidentBytes;  // At the end of a batch
+   int                       periodsSlope;       // Of each batch
+   vector<string>            stockDataFileNames; // Being analyzed, or none
+   double                    sumCurrentMACD;     // Of the stocks analyzed
+   vector<ShardStockSummary> topStocks;          // Highest slopes so far
+   const UniversePack*       universePack;       // Being analyzed, or NULL
+}; // end class StreamingAnalyzer
+
+//******************************************************************************
+// Function : getAccountedBytes
+// Process  : Accessor for accountedBytes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long StreamingAnalyzer::getAccountedBytes() const
+{
+   return this->accountedBytes;
+}
+
+//******************************************************************************
+// Function : getMaxBatchStocks
+// Process  : Accessor for maxBatchStocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StreamingAnalyzer::getMaxBatchStocks() const
+{
+   return this->maxBatchStocks;
+}
+
+//******************************************************************************
+// Function : getMeanMACD
+// Process  : The sum of the current MACDs over the stocks
+// Notes    : Returns 0 if no stocks were analyzed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double StreamingAnalyzer::getMeanMACD() const
+{
+   return (0 == this->numStocks) ? 0.0 :
+                                   this->sumCurrentMACD / this->numStocks;
+}
+
+//******************************************************************************
+// Function : getNumBatches
+// Process  : Accessor for numBatches
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StreamingAnalyzer::getNumBatches() const
+{
+   return this->numBatches;
+}
+
+//******************************************************************************
+// Function : getNumPositiveSlopes
+// Process  : Accessor for numPositiveSlopes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StreamingAnalyzer::getNumPositiveSlopes() const
+{
+   return this->numPositiveSlopes;
+}
+
+//******************************************************************************
+// Function : getNumStocks
+// Process  : Accessor for numStocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int StreamingAnalyzer::getNumStocks() const
+{
+   return this->numStocks;
+}
+
+//******************************************************************************
+// Function : getPeakResidentBytes
+// Process  : Accessor for peakResidentBytes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long StreamingAnalyzer::getPeakResidentBytes() const
+{
+   return this->peakResidentBytes;
+}
+
+//******************************************************************************
+// Function : getSourceWeight
+// Process  : A pack stock's rows, at least 1, otherwise 1
+// Notes    : Stock data files aren't opened to count their rows, their
+//             batches are sized by the stocks alone
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long StreamingAnalyzer::getSourceWeight(
+   const int sourceIndex) const
+{
+   if (NULL == this->universePack)
+   {
+      return 1;
+   }
+
+   return max(this->universePack->getNumRows(sourceIndex), 1);
+}
+
+//******************************************************************************
+// Function : getTopStocks
+// Process  : Accessor for topStocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const vector<ShardStockSummary>& StreamingAnalyzer::getTopStocks() const
+{
+   return this->topStocks;
+}
+
+//******************************************************************************
+// Function : setHistoryBounded
+// Process  : Mutator for historyBounded
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StreamingAnalyzer::setHistoryBounded(const bool historyBounded)
+{
+   this->historyBounded = historyBounded;
+}
+
+//******************************************************************************
+// Function : setMemoryLimitBytes
+// Process  : Mutator for memoryLimitBytes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StreamingAnalyzer::setMemoryLimitBytes(
+   const long long memoryLimitBytes)
+{
+   this->memoryLimitBytes = memoryLimitBytes;
+}
+
+//******************************************************************************
+// Function : setNumTopStocks
+// Process  : Mutator for numTopStocks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StreamingAnalyzer::setNumTopStocks(const int numTopStocks)
+{
+   this->numTopStocks = numTopStocks;
+}
+
+//******************************************************************************
+// Function : setPeriodsSlope
+// Process  : Mutator for periodsSlope
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void StreamingAnalyzer::setPeriodsSlope(const int periodsSlope)
+{
+   this->periodsSlope = periodsSlope;
+}
+
+#endif // StreamingAnalyzer_h
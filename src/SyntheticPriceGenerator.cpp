@@ -0,0 +1,108 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     SyntheticPriceGenerator.cpp
+//
+// File Overview: Represents a SyntheticPriceGenerator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include "SyntheticPriceGenerator.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// None
+
+//******************************************************************************
+// Function : constructor
+// Process  : Start the walk at STARTPRICECENTS
+//             Seed the random state, xorshift requires a non zero state
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SyntheticPriceGenerator::SyntheticPriceGenerator(const unsigned int seed)
+   : priceCents(SyntheticPriceGenerator::STARTPRICECENTS),
+     state(seed != 0 ? seed : 1)
+{
+} // end SyntheticPriceGenerator::SyntheticPriceGenerator
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+SyntheticPriceGenerator::~SyntheticPriceGenerator()
+{
+} // end SyntheticPriceGenerator::~SyntheticPriceGenerator
+
+//******************************************************************************
+// Function : generatePrices
+// Process  : Size the list of prices
+//             Fill it with the next prices of the walk
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void SyntheticPriceGenerator::generatePrices(
+   const int numPrices,
+   vector<double>& prices)
+{
+   prices.resize(numPrices);
+
+   for (int priceIndex = 0; priceIndex < numPrices; ++priceIndex)
+   {
+      prices[priceIndex] = this->nextPrice();
+   }
+}
+
+//******************************************************************************
+// Function : nextPrice
+// Process  : Move the walk by up to MAXSTEPCENTS in either direction
+//             Keep the price above MINPRICECENTS
+//             Return the price in dollars
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double SyntheticPriceGenerator::nextPrice()
+{
+   static const int NUMSTEPS = 2 * SyntheticPriceGenerator::MAXSTEPCENTS + 1;
+
+   int stepCents = int(this->nextRandom() % NUMSTEPS) -
+                   SyntheticPriceGenerator::MAXSTEPCENTS; // Daily move
+
+   this->priceCents += stepCents;
+
+   if (this->priceCents < SyntheticPriceGenerator::MINPRICECENTS)
+   {
+      this->priceCents = SyntheticPriceGenerator::MINPRICECENTS;
+   }
+
+   return this->priceCents / 100.0;
+}
\ No newline at end of file
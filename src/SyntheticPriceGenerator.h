@@ -0,0 +1,107 @@
+//******************************************************************************
+//
+// File Name:     SyntheticPriceGenerator.h
+//
+// File Overview: Represents a SyntheticPriceGenerator
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef SyntheticPriceGenerator_h
+#define SyntheticPriceGenerator_h
+
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    SyntheticPriceGenerator
+//
+// Overview: Generates reproducible closing prices for benchmarks
+//             Prices follow a random walk in whole cents, like the source
+//             data which has 2 decimal places
+//             The same seed always generates the same prices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class SyntheticPriceGenerator
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Seeds the generator
+   // Constraints : None
+   //***************************************************************************
+   explicit SyntheticPriceGenerator(const unsigned int seed);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~SyntheticPriceGenerator();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : generatePrices
+   // Description : Replaces prices with numPrices prices, oldest first
+   // Constraints : None
+   //***************************************************************************
+   void generatePrices(
+      const int numPrices,
+      vector<double>& prices);
+
+   //***************************************************************************
+   // Function    : nextPrice
+   // Description : Generates the next price of the walk
+   // Constraints : None
+   //***************************************************************************
+   double nextPrice();
+
+   //***************************************************************************
+   // Function    : nextRandom
+   // Description : Generates the next raw 32 bit random value
+   // Constraints : None
+   //***************************************************************************
+   inline unsigned int nextRandom();
+
+   static const int STARTPRICECENTS = 5000; // Walk starts at $50.00
+   static const int MINPRICECENTS   = 100;  // Walk never drops below $1.00
+   static const int MAXSTEPCENTS    = 50;   // Largest daily move, in cents
+
+private:
+   int          priceCents; // Current price of the walk, in cents
+   unsigned int state;      // Random state
+}; // end class SyntheticPriceGenerator
+
+//******************************************************************************
+// Function : nextRandom
+// Process  : xorshift32
+// Notes    : state is never 0, see the constructor
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline unsigned int SyntheticPriceGenerator::nextRandom()
+{
+   this->state ^= this->state << 13;
+   this->state ^= this->state >> 17;
+   this->state ^= this->state << 5;
+   return this->state;
+}
+
+#endif // SyntheticPriceGenerator_h
\ No newline at end of file
@@ -0,0 +1,367 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     TickIngestor.cpp
+//
+// File Overview: Represents a TickIngestor
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Names shard threads for Tracer
+// 10.19.26       Donne Martin         Added setAlertPublisher
+// 10.19.26       Donne Martin         Reads Platform::getSteadyNanos
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "Platform.h"
+#include "TickIngestor.h"
+#include "Tracer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const double NANOSPERMICRO = 1000.0; // For reporting latencies
+
+//******************************************************************************
+// Function : runShard
+// Process  : Name the thread in the trace after the shard
+//             Run the shard until the ingestor stops
+// Notes    : Worker thread entry point
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Names the thread for Tracer
+//******************************************************************************
+static void runShard(
+   TickShard* shard,
+   const int shardIndex,
+   const atomic<bool>* stopRequested)
+{
+   ostringstream threadName; // Shard in the trace
+
+   threadName << "shard " << shardIndex;
+   Tracer::setThreadName(threadName.str().c_str());
+
+   shard->run(*stopRequested);
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : Create the shards
+//             Not started, nothing published
+// Notes    : Throws an exception if numShards is not positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TickIngestor::TickIngestor(
+   const int numSymbols,
+   const int numShards,
+   const long long barMicros,
+   const int queueCapacity)
+   : numSymbols(numSymbols),
+     numPublished(0),
+     stopRequested(false)
+{
+   if (numShards < 1)
+   {
+      throw exception("TickIngestor needs at least one shard");
+   }
+
+   for (int shardIndex = 0; shardIndex < numShards; ++shardIndex)
+   {
+      this->shards.push_back(new TickShard(
+         shardIndex, 
+         numShards, 
+         numSymbols, 
+         barMicros, 
+         queueCapacity));
+   }
+} // end TickIngestor::TickIngestor
+
+//******************************************************************************
+// Function : destructor
+// Process  : Stop the workers
+//             Delete the shards
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TickIngestor::~TickIngestor()
+{
+   this->stop();
+
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      delete this->shards[shardIndex];
+   }
+} // end TickIngestor::~TickIngestor
+
+//******************************************************************************
+// Function : flushBars
+// Process  : Flush the bars of every shard
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickIngestor::flushBars()
+{
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      this->shards[shardIndex]->flushBars();
+   }
+}
+
+//******************************************************************************
+// Function : getNumBars
+// Process  : Add the bars of every shard
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+long long TickIngestor::getNumBars() const
+{
+   long long numBars = 0; // Bars of every shard
+
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      numBars += this->shards[shardIndex]->getNumBars();
+   }
+
+   return numBars;
+}
+
+//******************************************************************************
+// Function : getNumTicks
+// Process  : Add the ticks of every shard
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+long long TickIngestor::getNumTicks() const
+{
+   long long numTicks = 0; // Ticks of every shard
+
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      numTicks += this->shards[shardIndex]->getNumTicks();
+   }
+
+   return numTicks;
+}
+
+//******************************************************************************
+// Function : getStockAnalyzer
+// Process  : Ask the symbol's shard
+// Notes    : Throws an out_of_range exception for invalid symbolIndex
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const StockAnalyzer& TickIngestor::getStockAnalyzer(
+   const int symbolIndex) const
+{
+   if (symbolIndex < 0 || symbolIndex >= this->getNumSymbols())
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   return this->shards[symbolIndex % this->getNumShards()]->
+      getStockAnalyzer(symbolIndex);
+}
+
+//******************************************************************************
+// Function : outputStatistics
+// Process  : Output ticks, bars, and ticks per second
+//             Merge and sort the latency samples of every shard, and find
+//                the longest latency
+//             Output the p50, p99, and max latency in microseconds
+// Notes    : The percentiles are of each shard's reservoir of samples, the
+//             max is of every sampled tick
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Max from the shards, not the samples
+//******************************************************************************
+void TickIngestor::outputStatistics(const double seconds) const
+{
+   vector<double> latencyNanos;          // Samples of every shard
+   double         maxLatencyNanos = 0.0; // Of every shard
+
+   cout << "   shards:           " << this->getNumShards() << endl;
+   cout << "   ticks:            " << this->getNumTicks() << endl;
+   cout << "   bars:             " << this->getNumBars() << endl;
+   cout << "   ticks/sec:        " << fixed << setprecision(0) 
+        << this->getNumTicks() / seconds << endl;
+
+   // Merge and sort the latency samples of every shard
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      const vector<double>& samples = 
+         this->shards[shardIndex]->getLatencyNanos();
+      latencyNanos.insert(latencyNanos.end(), samples.begin(), samples.end());
+      maxLatencyNanos = max(maxLatencyNanos,
+                            this->shards[shardIndex]->getMaxLatencyNanos());
+   }
+
+   if (!latencyNanos.empty())
+   {
+      sort(latencyNanos.begin(), latencyNanos.end());
+
+      cout << setprecision(2);
+      cout << "   latency p50 us:   " 
+           << latencyNanos[latencyNanos.size() / 2] / NANOSPERMICRO << endl;
+      cout << "   latency p99 us:   " 
+           << latencyNanos[latencyNanos.size() * 99 / 100] / NANOSPERMICRO 
+           << endl;
+      cout << "   latency max us:   " 
+           << maxLatencyNanos / NANOSPERMICRO << endl;
+   }
+
+   cout.unsetf(ios::floatfield);
+   cout << setprecision(6);
+}
+
+//******************************************************************************
+// Function : publishTick
+// Process  : Stamp every LATENCYSAMPLEINTERVAL tick with the steady clock
+//             Push it to the shard of its symbol, yielding while the queue
+//                is full
+// Notes    : Throws an out_of_range exception for an invalid symbol, 
+//             before it can reach a worker
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickIngestor::publishTick(const Tick& tick)
+{
+   if (tick.symbolIndex < 0 || tick.symbolIndex >= this->getNumSymbols())
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   Tick             published = tick; // Tick as pushed
+   SPSCQueue<Tick>& queue     =       // Queue of the symbol's shard
+      this->shards[tick.symbolIndex % this->getNumShards()]->getQueue();
+
+   // Stamp every LATENCYSAMPLEINTERVAL tick with the steady clock
+   published.publishNanos = 0;
+
+   if (0 == this->numPublished++ % TickIngestor::LATENCYSAMPLEINTERVAL)
+   {
+      published.publishNanos = Platform::getSteadyNanos();
+   }
+
+   // Push it to the shard of its symbol, yielding while the queue is full
+   while (!queue.tryPush(published))
+   {
+      this_thread::yield();
+   }
+}
+
+//******************************************************************************
+// Function : setAlertPublisher
+// Process  : Hand the publisher to every shard
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickIngestor::setAlertPublisher(AlertPublisher* alertPublisher)
+{
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      this->shards[shardIndex]->setAlertPublisher(alertPublisher);
+   }
+}
+
+//******************************************************************************
+// Function : start
+// Process  : Start a worker thread per shard
+// Notes    : Does nothing if already started
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickIngestor::start()
+{
+   if (!this->workers.empty())
+   {
+      return;
+   }
+
+   this->stopRequested = false;
+
+   for (size_t shardIndex = 0; shardIndex < this->shards.size(); ++shardIndex)
+   {
+      this->workers.push_back(thread(
+         runShard, 
+         this->shards[shardIndex], 
+         int(shardIndex),
+         &this->stopRequested));
+   }
+}
+
+//******************************************************************************
+// Function : stop
+// Process  : Ask the workers to finish once their queues are drained
+//             Join them
+// Notes    : Does nothing if not started
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickIngestor::stop()
+{
+   this->stopRequested = true;
+
+   for (size_t workerIndex = 0; workerIndex < this->workers.size(); 
+        ++workerIndex)
+   {
+      this->workers[workerIndex].join();
+   }
+
+   this->workers.clear();
+}
@@ -0,0 +1,209 @@
+//******************************************************************************
+//
+// File Name:     TickIngestor.h
+//
+// File Overview: Represents a TickIngestor
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added setAlertPublisher
+//******************************************************************************
+
+#ifndef TickIngestor_h
+#define TickIngestor_h
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "AlertPublisher.h"
+#include "MarketData.h"
+#include "TickShard.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    TickIngestor
+//
+// Overview: Feeds StockAnalyzers from trade ticks
+//             One feed thread calls publishTick, which pushes the tick to the
+//                SPSCQueue of the symbol's TickShard
+//             Each shard has its own worker thread that aggregates the ticks
+//                into bars and updates the symbol's analyzer as each bar 
+//                completes
+//             A symbol is always on the same shard, so its ticks stay in 
+//                order and its analyzer needs no locking
+//             Every LATENCYSAMPLEINTERVAL ticks is stamped when published to
+//                measure the publish to bar update latency
+//             With an AlertPublisher, every shard publishes the MACD alerts
+//                of its bars to it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added setAlertPublisher
+//
+//******************************************************************************
+class TickIngestor
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Ingests numSymbols symbols over numShards workers, into
+   //                bars of barMicros
+   // Constraints : Throws an exception if numShards is not positive
+   //***************************************************************************
+   TickIngestor(
+      const int numSymbols,
+      const int numShards,
+      const long long barMicros,
+      const int queueCapacity = TickIngestor::DEFAULTQUEUECAPACITY);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Stops the workers
+   // Constraints : None
+   //***************************************************************************
+   virtual ~TickIngestor();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : flushBars
+   // Description : Completes every bar in progress and updates its analyzer
+   // Constraints : Call stop first
+   //***************************************************************************
+   void flushBars();
+
+   //***************************************************************************
+   // Function    : getNumBars
+   // Description : Retrieve the number of bars completed
+   // Constraints : Call stop first
+   //***************************************************************************
+   long long getNumBars() const;
+
+   //***************************************************************************
+   // Function    : getNumShards
+   // Description : Retrieve the number of shards
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumShards() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Accessor for numSymbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumTicks
+   // Description : Retrieve the number of ticks processed
+   // Constraints : Call stop first
+   //***************************************************************************
+   long long getNumTicks() const;
+
+   //***************************************************************************
+   // Function    : getStockAnalyzer
+   // Description : Retrieve the analyzer of the symbol
+   // Constraints : Call stop first
+   //                Throws an out_of_range exception for invalid symbolIndex
+   //***************************************************************************
+   const StockAnalyzer& getStockAnalyzer(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : outputStatistics
+   // Description : Outputs ticks, bars, ticks per second over seconds, and
+   //                the p50, p99, and max latency
+   // Constraints : Call stop first
+   //***************************************************************************
+   void outputStatistics(const double seconds) const;
+
+   //***************************************************************************
+   // Function    : publishTick
+   // Description : Pushes the tick to its symbol's shard, waiting while the
+   //                shard's queue is full
+   // Constraints : One feed thread only, between start and stop
+   //***************************************************************************
+   void publishTick(const Tick& tick);
+
+   //***************************************************************************
+   // Function    : setAlertPublisher
+   // Description : Publishes the MACD alerts of every shard's bars, NULL for
+   //                none
+   // Constraints : Call before start
+   //                alertPublisher must outlive stop and flushBars
+   //***************************************************************************
+   void setAlertPublisher(AlertPublisher* alertPublisher);
+
+   //***************************************************************************
+   // Function    : start
+   // Description : Starts a worker thread per shard
+   // Constraints : None
+   //***************************************************************************
+   void start();
+
+   //***************************************************************************
+   // Function    : stop
+   // Description : Lets the workers drain their queues and joins them
+   // Constraints : Call from the feed thread, after its last publishTick
+   //***************************************************************************
+   void stop();
+
+   static const int DEFAULTQUEUECAPACITY  = 65536; // Ticks per shard queue
+   static const int LATENCYSAMPLEINTERVAL = 64;    // Ticks per latency sample
+
+private:
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : Not copyable, owns its shards and threads
+   // Constraints : None
+   //***************************************************************************
+   TickIngestor(const TickIngestor&);
+   TickIngestor& operator=(const TickIngestor&);
+
+   int                numSymbols;    // Symbols ingested
+   long long          numPublished;  // Ticks published, for sampling
+   vector<TickShard*> shards;        // Shards, owned
+   vector<thread>     workers;       // Worker thread of each shard
+   atomic<bool>       stopRequested; // Asks the workers to finish
+}; // end class TickIngestor
+
+//******************************************************************************
+// Function : getNumShards
+// Process  : Retrieve the number of shards
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TickIngestor::getNumShards() const
+{
+   return this->shards.size();
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Accessor for numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TickIngestor::getNumSymbols() const
+{
+   return this->numSymbols;
+}
+
+#endif // TickIngestor_h
@@ -0,0 +1,468 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     TickReplayer.cpp
+//
+// File Overview: Represents a TickReplayer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "StockAnalyzer.h"
+#include "SyntheticPriceGenerator.h"
+#include "TickReplayer.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+typedef chrono::steady_clock ReplayClock; // Monotonic clock for pacing
+
+static const int       MAX_CHARS_PER_LINE     = 512;   // Max chars per line
+static const char*     DELIMITER           = ",";   // CSV files
+static const double    MICROSPERSECOND     = 1.0e6; // For pacing
+static const double    SLEEPSECONDS        = 0.002; // Sleep, rather than 
+                                                    // yield, above this wait
+static const long long OPENMICROS  = 34200000000LL; // 9:30, open tick
+static const long long HIGHMICROS  = 41400000000LL; // 11:30, high tick
+static const long long LOWMICROS   = 48600000000LL; // 13:30, low tick
+static const long long CLOSEMICROS = 57600000000LL; // 16:00, close tick
+
+//******************************************************************************
+// Function : compareTickTimes
+// Process  : Is the first tick's feed time earlier?
+// Notes    : Used with stable_sort
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static bool compareTickTimes(
+   const Tick& first,
+   const Tick& second)
+{
+   return first.timeMicros < second.timeMicros;
+}
+
+//******************************************************************************
+// Function : splitLine
+// Process  : Split the line at each DELIMITER into at most maxTokens tokens
+//             Returns the number of tokens
+// Notes    : Modifies line, the tokens point into it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static int splitLine(
+   char* line,
+   char** tokens,
+   const int maxTokens)
+{
+   char* context   = NULL; // Dummy context required by strtok_s
+   int   numTokens = 0;    // Tokens found
+
+   tokens[0] = strtok_s(line, DELIMITER, &context);
+
+   while (NULL != tokens[numTokens])
+   {
+      if (++numTokens == maxTokens)
+      {
+         break;
+      }
+
+      tokens[numTokens] = strtok_s(NULL, DELIMITER, &context);
+   }
+
+   return numTokens;
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TickReplayer::TickReplayer()
+{
+} // end TickReplayer::TickReplayer
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TickReplayer::~TickReplayer()
+{
+} // end TickReplayer::~TickReplayer
+
+//******************************************************************************
+// Function : addTick
+// Process  : Find the symbol's index, adding the symbol if new
+//             Add the tick, not sampled for latency
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::addTick(
+   const string& symbol,
+   const long long timeMicros,
+   const double price,
+   const int volume)
+{
+   Tick tick; // Tick added
+
+   unordered_map<string, int>::const_iterator found = 
+      this->symbolIndices.find(symbol);
+
+   // Find the symbol's index, adding the symbol if new
+   if (this->symbolIndices.end() == found)
+   {
+      tick.symbolIndex = this->symbols.size();
+      this->symbolIndices[symbol] = tick.symbolIndex;
+      this->symbols.push_back(symbol);
+   }
+   else
+   {
+      tick.symbolIndex = found->second;
+   }
+
+   tick.timeMicros   = timeMicros;
+   tick.price        = price;
+   tick.volume       = volume;
+   tick.publishNanos = 0;
+
+   this->ticks.push_back(tick);
+}
+
+//******************************************************************************
+// Function : addTicksFromStockDataFile
+// Process  : Skip the labels
+//             Read the open, high, low, close, and volume of each row
+//             Rows are newest first, so day 0 is the last row
+//             Add the open, high, low, and close ticks of each day, the
+//                volume on the close
+//             Put the ticks in feed time order
+// Notes    : Throws an exception if the file can't be read
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::addTicksFromStockDataFile(const char* stockDataFileName)
+{
+   static const int NUMTOKENS   = 6; // Date,Open,High,Low,Close,Volume
+   static const int OPENINDEX   = 1; // Token of each field
+   static const int HIGHINDEX   = 2;
+   static const int LOWINDEX    = 3;
+   static const int CLOSEINDEX  = 4;
+   static const int VOLUMEINDEX = 5;
+
+   ifstream       fin(stockDataFileName);        // File reader
+   char           buffer[MAX_CHARS_PER_LINE];       // Holds line
+   char*          tokens[NUMTOKENS + 1];         // Fields of the line
+   vector<Bar>    days;                          // Each row, newest first
+   const string   SYMBOL = 
+      StockAnalyzer::getSymbolFromFileName(stockDataFileName);
+
+   if (!fin.good())
+   {
+      throw exception("fstream operation failed");
+   }
+
+   // Skip the labels
+   fin.getline(buffer, MAX_CHARS_PER_LINE);
+
+   // Read the open, high, low, close, and volume of each row
+   while (fin.getline(buffer, MAX_CHARS_PER_LINE))
+   {
+      Bar day; // Row of the file
+
+      if (splitLine(buffer, tokens, NUMTOKENS) < NUMTOKENS)
+      {
+         continue;
+      }
+
+      day.open   = atof(tokens[OPENINDEX]);
+      day.high   = atof(tokens[HIGHINDEX]);
+      day.low    = atof(tokens[LOWINDEX]);
+      day.close  = atof(tokens[CLOSEINDEX]);
+      day.volume = atoi(tokens[VOLUMEINDEX]);
+
+      if (0.0 == day.close)
+      {
+         throw exception("atof operation failed");
+      }
+
+      days.push_back(day);
+   }
+
+   // Add the open, high, low, and close ticks of each day, oldest first
+   for (int dayIndex = 0; dayIndex < int(days.size()); ++dayIndex)
+   {
+      const Bar&      day       = days[days.size() - 1 - dayIndex];
+      const long long DAYMICROS = dayIndex * TickReplayer::DAYMICROS;
+
+      this->addTick(SYMBOL, DAYMICROS + OPENMICROS, day.open, 0);
+      this->addTick(SYMBOL, DAYMICROS + HIGHMICROS, day.high, 0);
+      this->addTick(SYMBOL, DAYMICROS + LOWMICROS, day.low, 0);
+      this->addTick(SYMBOL, DAYMICROS + CLOSEMICROS, day.close, 
+                    int(day.volume));
+   }
+
+   this->sortTicks();
+}
+
+//******************************************************************************
+// Function : generateTicks
+// Process  : Name the symbols SYN00000, SYN00001, ...
+//             Give each symbol its own SyntheticPriceGenerator
+//             Add the ticks round robin, tickMicros apart
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::generateTicks(
+   const int numSymbols,
+   const int numTicks,
+   const long long tickMicros)
+{
+   static const int TICKVOLUME = 100; // Shares per synthetic tick
+
+   vector<string>                  names;      // Synthetic symbols
+   vector<SyntheticPriceGenerator> generators; // Prices of each symbol
+   const long long                 FIRSTMICROS = 
+      this->ticks.empty() ? 0 : this->ticks.back().timeMicros + tickMicros;
+
+   // Name the symbols and give each its own generator
+   for (int symbolIndex = 0; symbolIndex < numSymbols; ++symbolIndex)
+   {
+      ostringstream name; // SYN00000, SYN00001, ...
+      name << "SYN" << setw(5) << setfill('0') << symbolIndex;
+      names.push_back(name.str());
+      generators.push_back(SyntheticPriceGenerator(symbolIndex + 1));
+   }
+
+   this->ticks.reserve(this->ticks.size() + numTicks);
+
+   // Add the ticks round robin, tickMicros apart
+   for (int tickIndex = 0; tickIndex < numTicks; ++tickIndex)
+   {
+      const int SYMBOLINDEX = tickIndex % numSymbols; // Symbol of the tick
+
+      this->addTick(
+         names[SYMBOLINDEX],
+         FIRSTMICROS + tickIndex * tickMicros,
+         generators[SYMBOLINDEX].nextPrice(),
+         TICKVOLUME);
+   }
+}
+
+//******************************************************************************
+// Function : loadTickFile
+// Process  : Skip the labels
+//             Add the tick of each Symbol,TimeMicros,Price,Volume line
+//             Put the ticks in feed time order
+// Notes    : Throws an exception if the file can't be read or a price is
+//             not positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::loadTickFile(const char* tickFileName)
+{
+   static const int NUMTOKENS   = 4; // Symbol,TimeMicros,Price,Volume
+   static const int SYMBOLINDEX = 0; // Token of each field
+   static const int TIMEINDEX   = 1;
+   static const int PRICEINDEX  = 2;
+   static const int VOLUMEINDEX = 3;
+
+   ifstream fin(tickFileName);        // File reader
+   char     buffer[MAX_CHARS_PER_LINE];  // Holds line
+   char*    tokens[NUMTOKENS + 1];    // Fields of the line
+   double   price = 0.0;              // Price of the line
+
+   if (!fin.good())
+   {
+      throw exception("fstream operation failed");
+   }
+
+   // Skip the labels
+   fin.getline(buffer, MAX_CHARS_PER_LINE);
+
+   // Add the tick of each Symbol,TimeMicros,Price,Volume line
+   while (fin.getline(buffer, MAX_CHARS_PER_LINE))
+   {
+      if (splitLine(buffer, tokens, NUMTOKENS) < NUMTOKENS)
+      {
+         continue;
+      }
+
+      price = atof(tokens[PRICEINDEX]);
+
+      if (price <= 0.0)
+      {
+         throw exception("Tick price must be positive");
+      }
+
+      this->addTick(
+         tokens[SYMBOLINDEX],
+         atoll(tokens[TIMEINDEX]),
+         price,
+         atoi(tokens[VOLUMEINDEX]));
+   }
+
+   this->sortTicks();
+}
+
+//******************************************************************************
+// Function : replay
+// Process  : Start the ingestor
+//             For each tick
+//                With a speed, wait until its feed time divided by speed
+//                   has passed since the first tick, sleeping on long waits
+//                Publish it
+//             Stop the ingestor, which drains every shard
+// Notes    : Returns the seconds from the first tick until every tick is
+//             processed
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double TickReplayer::replay(
+   TickIngestor& ingestor,
+   const double speed) const
+{
+   const long long FIRSTMICROS = 
+      this->ticks.empty() ? 0 : this->ticks.front().timeMicros;
+   double          waitSeconds = 0.0; // Until the tick is due
+
+   ingestor.start();
+
+   ReplayClock::time_point start = ReplayClock::now();
+
+   for (size_t tickIndex = 0; tickIndex < this->ticks.size(); ++tickIndex)
+   {
+      const Tick& tick = this->ticks[tickIndex];
+
+      // With a speed, wait until the tick is due
+      if (speed > 0.0)
+      {
+         const double DUESECONDS = 
+            (tick.timeMicros - FIRSTMICROS) / MICROSPERSECOND / speed;
+
+         while ((waitSeconds = DUESECONDS - chrono::duration<double>(
+                    ReplayClock::now() - start).count()) > 0.0)
+         {
+            if (waitSeconds > SLEEPSECONDS)
+            {
+               this_thread::sleep_for(chrono::microseconds(
+                  (long long)((waitSeconds - SLEEPSECONDS) * MICROSPERSECOND)));
+            }
+            else
+            {
+               this_thread::yield();
+            }
+         }
+      }
+
+      ingestor.publishTick(tick);
+   }
+
+   // Stop the ingestor, which drains every shard
+   ingestor.stop();
+
+   return chrono::duration<double>(ReplayClock::now() - start).count();
+}
+
+//******************************************************************************
+// Function : saveTickFile
+// Process  : Write the labels
+//             Write each tick as Symbol,TimeMicros,Price,Volume
+// Notes    : Throws an exception if the file can't be written
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::saveTickFile(const char* tickFileName) const
+{
+   ofstream fout(tickFileName); // File writer
+
+   if (!fout.good())
+   {
+      throw exception("fstream operation failed");
+   }
+
+   fout << "Symbol,TimeMicros,Price,Volume" << endl;
+   fout << setprecision(10);
+
+   for (size_t tickIndex = 0; tickIndex < this->ticks.size(); ++tickIndex)
+   {
+      const Tick& tick = this->ticks[tickIndex];
+
+      fout << this->symbols[tick.symbolIndex] << ','
+           << tick.timeMicros << ','
+           << tick.price << ','
+           << tick.volume << '\n';
+   }
+
+   if (!fout.good())
+   {
+      throw exception("fstream operation failed");
+   }
+}
+
+//******************************************************************************
+// Function : sortTicks
+// Process  : Stable sort by feed time
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickReplayer::sortTicks()
+{
+   stable_sort(this->ticks.begin(), this->ticks.end(), compareTickTimes);
+}
@@ -0,0 +1,208 @@
+//******************************************************************************
+//
+// File Name:     TickReplayer.h
+//
+// File Overview: Represents a TickReplayer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef TickReplayer_h
+#define TickReplayer_h
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "MarketData.h"
+#include "TickIngestor.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    TickReplayer
+//
+// Overview: A local feed that replays ticks into a TickIngestor, as the feed
+//             thread
+//             Ticks come from stock data files, from tick files, or from
+//                SyntheticPriceGenerator, and are kept in feed time order
+//             Each daily row of a stock data file becomes four ticks, the
+//                open, high, low, and close, so one day bars rebuild the 
+//                file's closing prices
+//             A tick file is text, one Symbol,TimeMicros,Price,Volume per 
+//                line after a header line
+//             replay paces the ticks by their feed time, sped up by the 
+//                speed factor, or sends them as fast as possible
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class TickReplayer
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No symbols or ticks
+   // Constraints : None
+   //***************************************************************************
+   TickReplayer();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~TickReplayer();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addTicksFromStockDataFile
+   // Description : Adds four ticks for each daily row of the stock data file
+   //                Days are counted from the file's oldest row
+   // Constraints : Throws an exception if the file can't be read
+   //***************************************************************************
+   void addTicksFromStockDataFile(const char* stockDataFileName);
+
+   //***************************************************************************
+   // Function    : generateTicks
+   // Description : Adds numTicks synthetic ticks over numSymbols symbols,
+   //                round robin, tickMicros apart
+   // Constraints : None
+   //***************************************************************************
+   void generateTicks(
+      const int numSymbols,
+      const int numTicks,
+      const long long tickMicros);
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the number of symbols
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumTicks
+   // Description : Retrieve the number of ticks
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumTicks() const;
+
+   //***************************************************************************
+   // Function    : getSymbol
+   // Description : Retrieve the symbol at the specified index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const string& getSymbol(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : loadTickFile
+   // Description : Adds the ticks of the tick file
+   // Constraints : Throws an exception if the file can't be read
+   //***************************************************************************
+   void loadTickFile(const char* tickFileName);
+
+   //***************************************************************************
+   // Function    : replay
+   // Description : Starts the ingestor, publishes every tick, and stops it
+   //                With a speed above 0, each tick is published when
+   //                its feed time, divided by speed, has passed
+   //                Returns the seconds from the first tick until every
+   //                tick is processed
+   // Constraints : The ingestor must have getNumSymbols symbols
+   //***************************************************************************
+   double replay(
+      TickIngestor& ingestor,
+      const double speed) const;
+
+   //***************************************************************************
+   // Function    : saveTickFile
+   // Description : Writes every tick to a tick file
+   // Constraints : Throws an exception if the file can't be written
+   //***************************************************************************
+   void saveTickFile(const char* tickFileName) const;
+
+   static const long long DAYMICROS = 86400000000LL; // One day bars
+
+private:
+   //***************************************************************************
+   // Function    : addTick
+   // Description : Adds a tick of the symbol
+   // Constraints : None
+   //***************************************************************************
+   void addTick(
+      const string& symbol,
+      const long long timeMicros,
+      const double price,
+      const int volume);
+
+   //***************************************************************************
+   // Function    : sortTicks
+   // Description : Puts the ticks in feed time order, keeping the order of
+   //                equal times
+   // Constraints : None
+   //***************************************************************************
+   void sortTicks();
+
+   vector<string>             symbols;       // Symbol of each index
+   unordered_map<string, int> symbolIndices; // Index of each symbol
+   vector<Tick>               ticks;         // Ticks in feed time order
+}; // end class TickReplayer
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Retrieve the number of symbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TickReplayer::getNumSymbols() const
+{
+   return this->symbols.size();
+}
+
+//******************************************************************************
+// Function : getNumTicks
+// Process  : Retrieve the number of ticks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TickReplayer::getNumTicks() const
+{
+   return this->ticks.size();
+}
+
+//******************************************************************************
+// Function : getSymbol
+// Process  : Retrieve the symbol at the specified index
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const string& TickReplayer::getSymbol(const int symbolIndex) const
+{
+   return this->symbols.at(symbolIndex);
+}
+
+#endif // TickReplayer_h
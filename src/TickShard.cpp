@@ -0,0 +1,315 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     TickShard.cpp
+//
+// File Overview: Represents a TickShard
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Updates analyzers with whole bars
+// 10.19.26       Donne Martin         Raises MACD alerts
+// 10.19.26       Donne Martin         Bounded the latency samples
+// 10.19.26       Donne Martin         Reads Platform::getSteadyNanos
+//******************************************************************************
+
+#include "stdafx.h"
+#include <thread>
+
+#include "Platform.h"
+#include "TickShard.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// Seeds the reservoir's xorshift64, which requires a non zero state
+static const unsigned long long RESERVOIRSEED = 88172645463325252ULL;
+
+//******************************************************************************
+// Function : constructor
+// Process  : Count the symbols of the shard, s % numShards == shardIndex
+//             Size the aggregator and the analyzers for them
+//             Bound every analyzer's history, without output
+//             No alerts, no latencies sampled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         No alerts
+// 10.19.26       Donne Martin         Bounded the latency samples
+//******************************************************************************
+TickShard::TickShard(
+   const int shardIndex,
+   const int numShards,
+   const int numSymbols,
+   const long long barMicros,
+   const int queueCapacity)
+   : shardIndex(shardIndex),
+     numShards(numShards),
+     queue(queueCapacity),
+     barAggregator(
+        (numSymbols - shardIndex + numShards - 1) / numShards, 
+        barMicros),
+     numLatencies(0),
+     maxLatencyNanos(0.0),
+     randomState(RESERVOIRSEED),
+     numBars(0),
+     numTicks(0),
+     alertPublisher(NULL)
+{
+   this->stockAnalyzers.resize(this->barAggregator.getNumSymbols());
+
+   for (size_t index = 0; index < this->stockAnalyzers.size(); ++index)
+   {
+      this->stockAnalyzers[index].setVerbose(false);
+      this->stockAnalyzers[index].setHistoryBounded(true);
+   }
+} // end TickShard::TickShard
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TickShard::~TickShard()
+{
+} // end TickShard::~TickShard
+
+//******************************************************************************
+// Function : completeBar
+// Process  : Without a publisher, update the analyzer with the bar
+//             Otherwise stamp the bar's arrival, and keep the MACD and
+//                slope before the update
+//             Update the analyzer with the bar
+//             If it had a MACD before and after, publish an alert for MACD
+//                crossing zero, and for the slope crossing the publisher's
+//                threshold, up or down
+// Notes    : A crossing is to above zero or the threshold from at or below
+//             it, and to at or below from above
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void TickShard::completeBar(
+   const int localIndex,
+   const Bar& bar)
+{
+   StockAnalyzer& stockAnalyzer = this->stockAnalyzers[localIndex];
+   bool           hadMACD       = false; // Before the update
+   double         lastMACD      = 0.0;   // Before the update
+   double         lastSlope     = 0.0;   // Before the update
+   double         threshold     = 0.0;   // Of a slope alert
+   Alert          alert;                 // Published
+
+   ++this->numBars;
+
+   // Without a publisher, update the analyzer with the bar
+   if (NULL == this->alertPublisher)
+   {
+      stockAnalyzer.updateWithBar(bar);
+      return;
+   }
+
+   // Stamp the bar's arrival, and keep the MACD and slope before
+   alert.arrivalNanos = Platform::getSteadyNanos();
+   hadMACD            = stockAnalyzer.hasMACD();
+
+   if (hadMACD)
+   {
+      lastMACD  = stockAnalyzer.getCurrentMACD();
+      lastSlope = stockAnalyzer.getSlopeMACD();
+   }
+
+   stockAnalyzer.updateWithBar(bar);
+
+   if (!hadMACD || !stockAnalyzer.hasMACD())
+   {
+      return;
+   }
+
+   // Publish an alert for each crossing
+   alert.symbolIndex = localIndex * this->numShards + this->shardIndex;
+   alert.barMicros   = bar.startMicros;
+   alert.macd        = stockAnalyzer.getCurrentMACD();
+   alert.slopeMACD   = stockAnalyzer.getSlopeMACD();
+   threshold         = this->alertPublisher->getSlopeThreshold();
+
+   if ((lastMACD > 0.0) != (alert.macd > 0.0))
+   {
+      alert.type = (alert.macd > 0.0) ? ALERTZEROUP : ALERTZERODOWN;
+      this->alertPublisher->publish(alert);
+   }
+
+   if (lastSlope <= threshold && alert.slopeMACD > threshold)
+   {
+      alert.type = ALERTSLOPEUP;
+      this->alertPublisher->publish(alert);
+   }
+   else if (lastSlope >= -threshold && alert.slopeMACD < -threshold)
+   {
+      alert.type = ALERTSLOPEDOWN;
+      this->alertPublisher->publish(alert);
+   }
+}
+
+//******************************************************************************
+// Function : flushBars
+// Process  : Complete every bar in progress
+//             Update its analyzer with the bar, and publish its alerts
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Updates with the whole bar
+// 10.19.26       Donne Martin         Completes the bar with completeBar
+// 10.19.26       Donne Martin         Records with recordLatency
+//******************************************************************************
+void TickShard::flushBars()
+{
+   Bar completedBar; // Bar flushed
+
+   for (size_t index = 0; index < this->stockAnalyzers.size(); ++index)
+   {
+      if (this->barAggregator.flushBar(index, completedBar))
+      {
+         this->completeBar(index, completedBar);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : processTick
+// Process  : Aggregate the tick at the symbol's local index
+//             A completed bar updates the analyzer, its close and its last
+//                bar, and publishes its alerts
+//             Record the latency of a sampled tick
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Updates with the whole bar
+// 10.19.26       Donne Martin         Completes the bar with completeBar
+//******************************************************************************
+inline void TickShard::processTick(const Tick& tick)
+{
+   const int LOCALINDEX = tick.symbolIndex / this->numShards; // In the shard
+   Bar       completedBar;                                    // Bar completed
+
+   if (this->barAggregator.addTick(LOCALINDEX, tick, completedBar))
+   {
+      this->completeBar(LOCALINDEX, completedBar);
+   }
+
+   ++this->numTicks;
+
+   // Record the latency of a sampled tick
+   if (0 != tick.publishNanos)
+   {
+      this->recordLatency(
+         double(Platform::getSteadyNanos() - tick.publishNanos));
+   }
+}
+
+//******************************************************************************
+// Function : recordLatency
+// Process  : Keep the longest latency
+//             Keep the first LATENCYRESERVOIRSIZE latencies
+//             Then replace a random sample with the nth latency with 
+//                probability LATENCYRESERVOIRSIZE / n
+// Notes    : Reservoir sampling, every latency ever sampled is equally 
+//             likely to be kept, so the percentiles stay unbiased
+//             xorshift64 picks the sample
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void TickShard::recordLatency(const double nanos)
+{
+   long long sampleIndex = 0; // Replaced, if in the reservoir
+
+   // Keep the longest latency
+   ++this->numLatencies;
+   this->maxLatencyNanos = max(this->maxLatencyNanos, nanos);
+
+   // Keep the first LATENCYRESERVOIRSIZE latencies
+   if (this->numLatencies <= TickShard::LATENCYRESERVOIRSIZE)
+   {
+      this->latencyNanos.push_back(nanos);
+      return;
+   }
+
+   // Then replace a random sample with probability LATENCYRESERVOIRSIZE / n
+   this->randomState ^= this->randomState << 13;
+   this->randomState ^= this->randomState >> 7;
+   this->randomState ^= this->randomState << 17;
+   sampleIndex = (long long)(this->randomState % this->numLatencies);
+
+   if (sampleIndex < TickShard::LATENCYRESERVOIRSIZE)
+   {
+      this->latencyNanos[sampleIndex] = nanos;
+   }
+}
+
+//******************************************************************************
+// Function : run
+// Process  : Process every tick popped from the queue
+//             When the queue is empty
+//                Once stopRequested is set, drain what is left and return
+//                Otherwise yield to the feed thread
+// Notes    : The feed thread pushes its last tick before setting 
+//             stopRequested, so the final drain sees every tick
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TickShard::run(const atomic<bool>& stopRequested)
+{
+   Tick tick; // Tick popped
+
+   while (true)
+   {
+      // Process every tick popped from the queue
+      if (this->queue.tryPop(tick))
+      {
+         this->processTick(tick);
+         continue;
+      }
+
+      // Once stopRequested is set, drain what is left and return
+      if (stopRequested.load(memory_order_acquire))
+      {
+         while (this->queue.tryPop(tick))
+         {
+            this->processTick(tick);
+         }
+
+         return;
+      }
+
+      this_thread::yield();
+   }
+}
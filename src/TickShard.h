@@ -0,0 +1,300 @@
+//******************************************************************************
+//
+// File Name:     TickShard.h
+//
+// File Overview: Represents a TickShard
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Raises MACD alerts
+// 10.19.26       Donne Martin         Bounded the latency samples
+//******************************************************************************
+
+#ifndef TickShard_h
+#define TickShard_h
+
+#include <atomic>
+#include <vector>
+
+#include "AlertPublisher.h"
+#include "BarAggregator.h"
+#include "MarketData.h"
+#include "SPSCQueue.h"
+#include "StockAnalyzer.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    TickShard
+//
+// Overview: The symbols pinned to one analysis worker of a TickIngestor
+//             Symbol s belongs to shard s % numShards, at local index 
+//                s / numShards
+//             The feed thread pushes ticks to the shard's SPSCQueue, the
+//                worker thread pops them in run, aggregates them into bars,
+//                and updates the symbol's bounded StockAnalyzer with the
+//                close of each completed bar
+//             Everything but the queue is only touched by the worker until
+//                run returns
+//             With an AlertPublisher, each bar that moves MACD across zero,
+//                or its slope across the publisher's slope threshold, is
+//                published as an Alert
+//             At most LATENCYRESERVOIRSIZE latency samples are kept, a
+//                uniform reservoir of every sampled tick, so a long running
+//                shard holds a fixed amount of memory
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Raises MACD alerts
+// 10.19.26       Donne Martin         Bounded the latency samples
+//
+//******************************************************************************
+class TickShard
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Shard shardIndex of numShards over numSymbols symbols
+   // Constraints : None
+   //***************************************************************************
+   TickShard(
+      const int shardIndex,
+      const int numShards,
+      const int numSymbols,
+      const long long barMicros,
+      const int queueCapacity);
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~TickShard();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : flushBars
+   // Description : Completes every bar in progress and updates its analyzer
+   // Constraints : Only once run has returned
+   //***************************************************************************
+   void flushBars();
+
+   //***************************************************************************
+   // Function    : getLatencyNanos
+   // Description : Retrieve the publish to bar update latency of up to
+   //                LATENCYRESERVOIRSIZE sampled ticks, chosen uniformly
+   // Constraints : Only once run has returned
+   //***************************************************************************
+   inline const vector<double>& getLatencyNanos() const;
+
+   //***************************************************************************
+   // Function    : getMaxLatencyNanos
+   // Description : Retrieve the longest latency of every sampled tick, 0 for
+   //                none
+   // Constraints : Only once run has returned
+   //***************************************************************************
+   inline double getMaxLatencyNanos() const;
+
+   //***************************************************************************
+   // Function    : getNumBars
+   // Description : Retrieve the number of bars completed
+   // Constraints : Only once run has returned
+   //***************************************************************************
+   inline long long getNumBars() const;
+
+   //***************************************************************************
+   // Function    : getNumTicks
+   // Description : Retrieve the number of ticks processed
+   // Constraints : Only once run has returned
+   //***************************************************************************
+   inline long long getNumTicks() const;
+
+   //***************************************************************************
+   // Function    : getQueue
+   // Description : Retrieve the queue the feed thread pushes to
+   // Constraints : None
+   //***************************************************************************
+   inline SPSCQueue<Tick>& getQueue();
+
+   //***************************************************************************
+   // Function    : getStockAnalyzer
+   // Description : Retrieve the analyzer of the symbol
+   // Constraints : symbolIndex must belong to the shard
+   //                Only once run has returned
+   //***************************************************************************
+   inline const StockAnalyzer& getStockAnalyzer(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : run
+   // Description : Processes ticks from the queue until stopRequested is set
+   //                and the queue is drained
+   // Constraints : Worker thread only
+   //***************************************************************************
+   void run(const atomic<bool>& stopRequested);
+
+   //***************************************************************************
+   // Function    : setAlertPublisher
+   // Description : Publishes the MACD alerts of completed bars, NULL for none
+   // Constraints : Not while run is running
+   //                alertPublisher must outlive run and flushBars
+   //***************************************************************************
+   inline void setAlertPublisher(AlertPublisher* alertPublisher);
+
+   static const int LATENCYRESERVOIRSIZE = 65536; // Latency samples kept
+
+private:
+   //***************************************************************************
+   // Function    : completeBar
+   // Description : Updates the analyzer at the local index with the bar,
+   //                and publishes its alerts
+   // Constraints : None
+   //***************************************************************************
+   inline void completeBar(
+      const int localIndex,
+      const Bar& bar);
+
+   //***************************************************************************
+   // Function    : processTick
+   // Description : Aggregates the tick, updating the analyzer on a new bar
+   // Constraints : None
+   //***************************************************************************
+   inline void processTick(const Tick& tick);
+
+   //***************************************************************************
+   // Function    : recordLatency
+   // Description : Adds the latency to the reservoir of samples
+   // Constraints : None
+   //***************************************************************************
+   inline void recordLatency(const double nanos);
+
+   int                   shardIndex;     // Of the ingestor
+   int                   numShards;      // Shards of the ingestor
+   SPSCQueue<Tick>       queue;          // Ticks from the feed thread
+   BarAggregator         barAggregator;  // Bars of the shard's symbols
+   vector<StockAnalyzer> stockAnalyzers; // Bounded analyzer per symbol
+   vector<double>        latencyNanos;   // Reservoir of sampled latencies
+   long long             numLatencies;   // Latencies ever sampled
+   double                maxLatencyNanos; // Longest latency ever sampled
+   unsigned long long    randomState;    // Picks reservoir replacements
+   long long             numBars;        // Bars completed
+   long long             numTicks;       // Ticks processed
+   AlertPublisher*       alertPublisher; // Of the alerts, NULL for none
+}; // end class TickShard
+
+//******************************************************************************
+// Function : getLatencyNanos
+// Process  : Accessor for latencyNanos
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const vector<double>& TickShard::getLatencyNanos() const
+{
+   return this->latencyNanos;
+}
+
+//******************************************************************************
+// Function : getMaxLatencyNanos
+// Process  : Accessor for maxLatencyNanos
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double TickShard::getMaxLatencyNanos() const
+{
+   return this->maxLatencyNanos;
+}
+
+//******************************************************************************
+// Function : getNumBars
+// Process  : Accessor for numBars
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long TickShard::getNumBars() const
+{
+   return this->numBars;
+}
+
+//******************************************************************************
+// Function : getNumTicks
+// Process  : Accessor for numTicks
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long TickShard::getNumTicks() const
+{
+   return this->numTicks;
+}
+
+//******************************************************************************
+// Function : getQueue
+// Process  : Accessor for queue
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline SPSCQueue<Tick>& TickShard::getQueue()
+{
+   return this->queue;
+}
+
+//******************************************************************************
+// Function : getStockAnalyzer
+// Process  : The analyzer at the symbol's local index
+// Notes    : Throws an out_of_range exception if the local index is past 
+//             the end
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const StockAnalyzer& TickShard::getStockAnalyzer(
+   const int symbolIndex) const
+{
+   return this->stockAnalyzers.at(symbolIndex / this->numShards);
+}
+
+//******************************************************************************
+// Function : setAlertPublisher
+// Process  : Mutator for alertPublisher
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline void TickShard::setAlertPublisher(AlertPublisher* alertPublisher)
+{
+   this->alertPublisher = alertPublisher;
+}
+
+#endif // TickShard_h
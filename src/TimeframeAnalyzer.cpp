@@ -0,0 +1,466 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     TimeframeAnalyzer.cpp
+//
+// File Overview: Represents a TimeframeAnalyzer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <climits>
+#include <exception>
+
+#include "IndicatorEngine.h"
+#include "Metrics.h"
+#include "StockAnalyzer.h"
+#include "TimeframeAnalyzer.h"
+#include "TradingCalendar.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const char* TIMEFRAMENAMES[TimeframeAnalyzer::NUMTIMEFRAMES] =
+{
+   "Daily",
+   "Weekly",
+   "Monthly"
+};
+
+//******************************************************************************
+// Function : constructor
+// Process  : The default periods of StockAnalyzer and IndicatorEngine
+//             A frame per timeframe, no days
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TimeframeAnalyzer::TimeframeAnalyzer()
+   : lastDate(INT_MIN),
+     periodsFast(StockAnalyzer::DEFAULTFASTPERIODS),
+     periodsSignal(IndicatorEngine::DEFAULTSIGNALPERIODS),
+     periodsSlow(StockAnalyzer::DEFAULTSLOWPERIODS)
+{
+   this->reset();
+} // end TimeframeAnalyzer::TimeframeAnalyzer
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TimeframeAnalyzer::~TimeframeAnalyzer()
+{
+} // end TimeframeAnalyzer::~TimeframeAnalyzer
+
+//******************************************************************************
+// Function : addDay
+// Process  : For each timeframe
+//                A day on or past the end of the bar's period completes it
+//                With no bar, the day starts one, ending at the period end
+//                Otherwise the day is merged into the bar
+// Notes    : Throws an exception unless date is after the last day
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TimeframeAnalyzer::addDay(
+   const int date,
+   const double close,
+   const double high,
+   const double low,
+   const long long volume)
+{
+   if (date <= this->lastDate)
+   {
+      throw exception("Timeframe days must be oldest first, one per date");
+   }
+
+   for (int timeframe = 0; timeframe < NUMTIMEFRAMES; ++timeframe)
+   {
+      Frame&        frame = this->frames[timeframe];
+      TimeframeBar& bar   = frame.bar;
+
+      if (bar.numDays > 0 && date >= bar.endDate)
+      {
+         this->completeBar(frame);
+      }
+
+      if (0 == bar.numDays)
+      {
+         bar.startDate = date;
+         bar.endDate   = TimeframeAnalyzer::getPeriodEnd(
+                            Timeframe(timeframe), date);
+         bar.open      = close;
+         bar.high      = high;
+         bar.low       = low;
+         bar.close     = close;
+         bar.volume    = volume;
+         bar.numDays   = 1;
+      }
+      else
+      {
+         bar.high    = max(bar.high, high);
+         bar.low     = min(bar.low, low);
+         bar.close   = close;
+         bar.volume += volume;
+         ++bar.numDays;
+      }
+   }
+
+   this->lastDate = date;
+}
+
+//******************************************************************************
+// Function : analyzeStock
+// Process  : Forget every day
+//             Add each day, with its high, low, and volume if the stock has
+//                a bar per price
+// Notes    : Timed by Metrics
+//             Throws an exception unless the stock has a date per price
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TimeframeAnalyzer::analyzeStock(const Stock& stock)
+{
+   METRICS_TIMER(PHASETIMEFRAMES);
+
+   const int  NUMPRICES = stock.getNumPrices();
+   const bool HASBARS   = stock.getNumBars() == NUMPRICES; // High, low, volume
+
+   if (stock.getNumDates() != NUMPRICES)
+   {
+      throw exception("Timeframes need a date per price");
+   }
+
+   this->reset();
+
+   for (int index = 0; index < NUMPRICES; ++index)
+   {
+      const double CLOSE = stock.getPriceAt(index);
+
+      if (HASBARS)
+      {
+         this->addDay(stock.getDateAt(index),
+                      CLOSE,
+                      stock.getHighAt(index),
+                      stock.getLowAt(index),
+                      stock.getVolumeAt(index));
+      }
+      else
+      {
+         this->addDay(stock.getDateAt(index), CLOSE, CLOSE, CLOSE, 0);
+      }
+   }
+}
+
+//******************************************************************************
+// Function : completeBar
+// Process  : Add the bar's close to the fast and slow EMAs
+//             Once both are ready, their difference is the bar's MACD, added
+//                to the signal EMA
+//             Count the bar and empty it
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TimeframeAnalyzer::completeBar(Frame& frame)
+{
+   frame.emaFast.add(frame.bar.close);
+   frame.emaSlow.add(frame.bar.close);
+
+   if (frame.emaFast.isReady() && frame.emaSlow.isReady())
+   {
+      frame.lastMACD = frame.emaFast.getAverage() -
+                       frame.emaSlow.getAverage();
+      frame.emaSignal.add(frame.lastMACD);
+      ++frame.numMACDs;
+   }
+
+   ++frame.numCompleted;
+   frame.bar.numDays = 0;
+}
+
+//******************************************************************************
+// Function : evaluate
+// Process  : Add the bar in progress to copies of the fast and slow EMAs
+//             Once the slow copy is ready, their difference is the MACD,
+//                added to a copy of the signal EMA
+// Notes    : The frame is unchanged, so the bar in progress can still grow
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool TimeframeAnalyzer::evaluate(
+   const Timeframe timeframe,
+   double& macd,
+   double& signal,
+   bool& signalReady) const
+{
+   const Frame&       frame     = this->frames[timeframe];
+   ExponentialAverage emaFast   = frame.emaFast;   // With the bar in progress
+   ExponentialAverage emaSlow   = frame.emaSlow;   // With the bar in progress
+   ExponentialAverage emaSignal = frame.emaSignal; // With the MACD
+
+   macd        = 0.0;
+   signal      = 0.0;
+   signalReady = false;
+
+   if (0 == frame.bar.numDays)
+   {
+      return false;
+   }
+
+   emaFast.add(frame.bar.close);
+   emaSlow.add(frame.bar.close);
+
+   if (!emaFast.isReady() || !emaSlow.isReady())
+   {
+      return false;
+   }
+
+   macd = emaFast.getAverage() - emaSlow.getAverage();
+   emaSignal.add(macd);
+   signalReady = emaSignal.isReady();
+   signal      = emaSignal.getAverage();
+
+   return true;
+}
+
+//******************************************************************************
+// Function : getMACD
+// Process  : The MACD with the bar in progress
+// Notes    : 0 without a MACD
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double TimeframeAnalyzer::getMACD(const Timeframe timeframe) const
+{
+   double macd        = 0.0;   // With the bar in progress
+   double signal      = 0.0;   // Unused
+   bool   signalReady = false; // Unused
+
+   this->evaluate(timeframe, macd, signal, signalReady);
+
+   return macd;
+}
+
+//******************************************************************************
+// Function : getPeriodEnd
+// Process  : Daily, the next day
+//             Weekly, the Monday after the week's Monday, day 0, 1.1.1970,
+//                being a Thursday
+//             Monthly, the 1st of the next month
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int TimeframeAnalyzer::getPeriodEnd(
+   const Timeframe timeframe,
+   const int date)
+{
+   const int DAYSPERWEEK     = 7;
+   const int MONDAYOFFSET    = 3; // Days from a Monday to a Thursday
+   const int MONTHSPERYEAR   = 12;
+   int       year            = 0; // Of date
+   int       month           = 0; // Of date
+   int       day             = 0; // Of date
+   int       daysSinceMonday = 0; // Of date's week
+
+   switch (timeframe)
+   {
+      case TIMEFRAMEWEEKLY:
+         daysSinceMonday = ((date + MONDAYOFFSET) % DAYSPERWEEK +
+                            DAYSPERWEEK) % DAYSPERWEEK;
+         return date - daysSinceMonday + DAYSPERWEEK;
+
+      case TIMEFRAMEMONTHLY:
+         TradingCalendar::splitDate(date, year, month, day);
+         return month == MONTHSPERYEAR ?
+                TradingCalendar::toDate(year + 1, 1, 1) :
+                TradingCalendar::toDate(year, month + 1, 1);
+
+      default:
+         return date + 1;
+   }
+}
+
+//******************************************************************************
+// Function : getSignal
+// Process  : The signal of the MACD with the bar in progress
+// Notes    : 0 without a signal
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double TimeframeAnalyzer::getSignal(const Timeframe timeframe) const
+{
+   double macd        = 0.0;   // Unused
+   double signal      = 0.0;   // Of the MACD with the bar in progress
+   bool   signalReady = false; // Has signal its periods of MACDs?
+
+   this->evaluate(timeframe, macd, signal, signalReady);
+
+   return signalReady ? signal : 0.0;
+}
+
+//******************************************************************************
+// Function : getSlopeMACD
+// Process  : The MACD with the bar in progress, less the newest completed
+//                bar's
+// Notes    : As StockAnalyzer's slope over the last two closes, the current
+//                MACD less yesterday's
+//             0 without hasMACD
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+double TimeframeAnalyzer::getSlopeMACD(const Timeframe timeframe) const
+{
+   if (!this->hasMACD(timeframe))
+   {
+      return 0.0;
+   }
+
+   return this->getMACD(timeframe) - this->frames[timeframe].lastMACD;
+}
+
+//******************************************************************************
+// Function : getTimeframeName
+// Process  : Look up the name of the timeframe
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+const char* TimeframeAnalyzer::getTimeframeName(const Timeframe timeframe)
+{
+   return TIMEFRAMENAMES[timeframe];
+}
+
+//******************************************************************************
+// Function : hasMACD
+// Process  : A MACD with the bar in progress, and one of the newest
+//                completed bar
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool TimeframeAnalyzer::hasMACD(const Timeframe timeframe) const
+{
+   double macd        = 0.0;   // Unused
+   double signal      = 0.0;   // Unused
+   bool   signalReady = false; // Unused
+
+   return this->frames[timeframe].numMACDs > 0 &&
+          this->evaluate(timeframe, macd, signal, signalReady);
+}
+
+//******************************************************************************
+// Function : hasSignal
+// Process  : A MACD with the bar in progress, with its periods of MACDs
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool TimeframeAnalyzer::hasSignal(const Timeframe timeframe) const
+{
+   double macd        = 0.0;   // Unused
+   double signal      = 0.0;   // Unused
+   bool   signalReady = false; // Has signal its periods of MACDs?
+
+   return this->evaluate(timeframe, macd, signal, signalReady) &&
+          signalReady;
+}
+
+//******************************************************************************
+// Function : reset
+// Process  : A new frame of the periods per timeframe, no last day
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TimeframeAnalyzer::reset()
+{
+   this->frames.assign(NUMTIMEFRAMES, Frame(this->periodsFast,
+                                            this->periodsSlow,
+                                            this->periodsSignal));
+   this->lastDate = INT_MIN;
+}
+
+//******************************************************************************
+// Function : setPeriods
+// Process  : Validate and set the periods, then forget every day
+// Notes    : Throws an exception unless every period is positive and
+//                periodsFast is less than periodsSlow
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TimeframeAnalyzer::setPeriods(
+   const int periodsFast,
+   const int periodsSlow,
+   const int periodsSignal)
+{
+   if (periodsFast <= 0 || periodsSignal <= 0 || periodsFast >= periodsSlow)
+   {
+      throw exception("Timeframe periods must be positive, fast < slow");
+   }
+
+   this->periodsFast   = periodsFast;
+   this->periodsSlow   = periodsSlow;
+   this->periodsSignal = periodsSignal;
+
+   this->reset();
+}
@@ -0,0 +1,345 @@
+//******************************************************************************
+//
+// File Name:     TimeframeAnalyzer.h
+//
+// File Overview: Represents a TimeframeAnalyzer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//******************************************************************************
+
+#ifndef TimeframeAnalyzer_h
+#define TimeframeAnalyzer_h
+
+#include <vector>
+
+#include "IndicatorPrimitives.h"
+#include "Stock.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    TimeframeAnalyzer
+//
+// Overview: The MACD and signal of a stock's daily, weekly, and monthly bars,
+//             from one pass over its daily bars
+//             Each timeframe merges the days of its period into a bar:
+//                weeks start on Monday, months on the 1st, by the days'
+//                TradingCalendar day numbers
+//             A day past the bar's period completes the bar, which is added
+//                to the timeframe's fast and slow EMAs, and its MACD to the
+//                signal EMA, each an ExponentialAverage
+//             The bar in progress, such as this week so far, is added to
+//                copies of the EMAs when a value is retrieved, so the
+//                values are those of analyzing the timeframe's closes up to
+//                the latest day, and the daily values are StockAnalyzer's
+//             Stock keeps no opens, so a bar opens at its first day's close
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+class TimeframeAnalyzer
+{
+public:
+
+   enum Timeframe
+   {
+      TIMEFRAMEDAILY,
+      TIMEFRAMEWEEKLY,
+      TIMEFRAMEMONTHLY,
+      NUMTIMEFRAMES
+   };
+
+   //***************************************************************************
+   //
+   // Class:    TimeframeBar
+   //
+   // Overview: Open, high, low, close, and volume of a timeframe's period
+   //
+   //***************************************************************************
+   struct TimeframeBar
+   {
+      int       startDate; // Day number of the first day
+      int       endDate;   // Day number the next period starts
+      double    open;      // First day's close, Stock keeps no opens
+      double    high;      // Highest high
+      double    low;       // Lowest low
+      double    close;     // Last day's close
+      long long volume;    // Shares traded
+      int       numDays;   // Days in the bar, 0 for no bar
+   }; // end struct TimeframeBar
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : The default periods, 12, 26, and 9, and no days
+   // Constraints : None
+   //***************************************************************************
+   TimeframeAnalyzer();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~TimeframeAnalyzer();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addDay
+   // Description : Adds the newest day to the bar of every timeframe,
+   //                completing any bar whose period it is past
+   // Constraints : Throws an exception unless date is after the last day
+   //***************************************************************************
+   void addDay(
+      const int date,
+      const double close,
+      const double high,
+      const double low,
+      const long long volume);
+
+   //***************************************************************************
+   // Function    : analyzeStock
+   // Description : Forgets every day, then adds each day of the stock,
+   //                oldest first, with its high, low, and volume if it has
+   //                a bar per price, otherwise its close
+   // Constraints : Throws an exception unless the stock has a date per price
+   //***************************************************************************
+   void analyzeStock(const Stock& stock);
+
+   //***************************************************************************
+   // Function    : getBar
+   // Description : Retrieve the newest bar of the timeframe, possibly still
+   //                in progress
+   // Constraints : None
+   //***************************************************************************
+   inline const TimeframeBar& getBar(const Timeframe timeframe) const;
+
+   //***************************************************************************
+   // Function    : getMACD, getSignal, getSlopeMACD
+   // Description : Retrieve the timeframe's MACD, its signal, and the MACD
+   //                less the previous bar's, up to the newest day
+   // Constraints : Only meaningful once hasMACD, or hasSignal for getSignal
+   //***************************************************************************
+   double getMACD(const Timeframe timeframe) const;
+   double getSignal(const Timeframe timeframe) const;
+   double getSlopeMACD(const Timeframe timeframe) const;
+
+   //***************************************************************************
+   // Function    : getNumBars
+   // Description : Retrieve the number of bars of the timeframe, the newest
+   //                one included
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumBars(const Timeframe timeframe) const;
+
+   //***************************************************************************
+   // Function    : getPeriodsFast, getPeriodsSignal, getPeriodsSlow
+   // Description : Retrieve the EMA periods of the fast and slow EMAs of
+   //                the MACD, and of its signal
+   // Constraints : None
+   //***************************************************************************
+   inline int getPeriodsFast() const;
+   inline int getPeriodsSignal() const;
+   inline int getPeriodsSlow() const;
+
+   //***************************************************************************
+   // Function    : getTimeframeName
+   // Description : Retrieve the name of the timeframe for output
+   // Constraints : None
+   //***************************************************************************
+   static const char* getTimeframeName(const Timeframe timeframe);
+
+   //***************************************************************************
+   // Function    : hasMACD, hasSignal
+   // Description : Has the timeframe a MACD and a previous bar's MACD, as
+   //                StockAnalyzer::hasMACD? Has the MACD a signal?
+   // Constraints : None
+   //***************************************************************************
+   bool hasMACD(const Timeframe timeframe) const;
+   bool hasSignal(const Timeframe timeframe) const;
+
+   //***************************************************************************
+   // Function    : reset
+   // Description : Forgets every day
+   // Constraints : None
+   //***************************************************************************
+   void reset();
+
+   //***************************************************************************
+   // Function    : setPeriods
+   // Description : Sets the EMA periods of the MACD and its signal, and
+   //                forgets every day
+   // Constraints : Throws an exception unless every period is positive and
+   //                periodsFast is less than periodsSlow
+   //***************************************************************************
+   void setPeriods(
+      const int periodsFast,
+      const int periodsSlow,
+      const int periodsSignal);
+
+private:
+   //***************************************************************************
+   //
+   // Class:    Frame
+   //
+   // Overview: A timeframe's bar in progress, and the EMAs and MACD of its
+   //             completed bars
+   //
+   //***************************************************************************
+   struct Frame
+   {
+      //************************************************************************
+      // Function    : constructor
+      // Description : No bars, EMAs of the periods
+      // Constraints : None
+      //************************************************************************
+      Frame(
+         const int periodsFast,
+         const int periodsSlow,
+         const int periodsSignal)
+         : bar(),
+           emaFast(periodsFast,
+                   ExponentialAverage::getEMASmoothing(periodsFast)),
+           emaSlow(periodsSlow,
+                   ExponentialAverage::getEMASmoothing(periodsSlow)),
+           emaSignal(periodsSignal,
+                     ExponentialAverage::getEMASmoothing(periodsSignal)),
+           lastMACD(0.0),
+           numCompleted(0),
+           numMACDs(0)
+      {
+      } // end Frame::Frame
+
+      TimeframeBar       bar;          // In progress
+      ExponentialAverage emaFast;      // Of completed closes
+      ExponentialAverage emaSlow;      // Of completed closes
+      ExponentialAverage emaSignal;    // Of completed MACDs
+      double             lastMACD;     // Of the newest completed bar
+      int                numCompleted; // Bars
+      int                numMACDs;     // Completed bars with a MACD
+   }; // end struct Frame
+
+   //***************************************************************************
+   // Function    : completeBar
+   // Description : Adds the frame's bar in progress to its EMAs
+   // Constraints : None
+   //***************************************************************************
+   void completeBar(Frame& frame);
+
+   //***************************************************************************
+   // Function    : evaluate
+   // Description : Retrieves the timeframe's MACD, and its signal, with the
+   //                bar in progress added to copies of the EMAs
+   //                Returns false if there is no MACD
+   // Constraints : None
+   //***************************************************************************
+   bool evaluate(
+      const Timeframe timeframe,
+      double& macd,
+      double& signal,
+      bool& signalReady) const;
+
+   //***************************************************************************
+   // Function    : getPeriodEnd
+   // Description : Retrieve the day number the timeframe's period after the
+   //                one of date starts
+   // Constraints : None
+   //***************************************************************************
+   static int getPeriodEnd(
+      const Timeframe timeframe,
+      const int date);
+
+   vector<Frame> frames;        // Of each timeframe
+   int           lastDate;      // Of the newest day
+   int           periodsFast;   // Of the fast EMA
+   int           periodsSignal; // Of the EMA of MACD
+   int           periodsSlow;   // Of the slow EMA
+}; // end class TimeframeAnalyzer
+
+//******************************************************************************
+// Function : getBar
+// Process  : The bar of the timeframe's frame
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const TimeframeAnalyzer::TimeframeBar& TimeframeAnalyzer::getBar(
+   const Timeframe timeframe) const
+{
+   return this->frames[timeframe].bar;
+}
+
+//******************************************************************************
+// Function : getNumBars
+// Process  : The completed bars, and the bar in progress if any
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TimeframeAnalyzer::getNumBars(const Timeframe timeframe) const
+{
+   return this->frames[timeframe].numCompleted +
+          (0 == this->frames[timeframe].bar.numDays ? 0 : 1);
+}
+
+//******************************************************************************
+// Function : getPeriodsFast
+// Process  : Accessor for periodsFast
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TimeframeAnalyzer::getPeriodsFast() const
+{
+   return this->periodsFast;
+}
+
+//******************************************************************************
+// Function : getPeriodsSignal
+// Process  : Accessor for periodsSignal
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TimeframeAnalyzer::getPeriodsSignal() const
+{
+   return this->periodsSignal;
+}
+
+//******************************************************************************
+// Function : getPeriodsSlow
+// Process  : Accessor for periodsSlow
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TimeframeAnalyzer::getPeriodsSlow() const
+{
+   return this->periodsSlow;
+}
+
+#endif // TimeframeAnalyzer_h
@@ -0,0 +1,426 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     Tracer.cpp
+//
+// File Overview: Represents a Tracer
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         stop frees the buffers
+//******************************************************************************
+
+#include "stdafx.h"
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <vector>
+
+#include "Tracer.h"
+
+//******************************************************************************
+//
+// Class:    TraceEvent
+//
+// Overview: One complete event, fixed size so a buffer is never resized
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct TraceEvent
+{
+   const char* name;                        // String literal
+   long long   beginNanos;                  // Since the trace started
+   long long   durationNanos;               // End minus begin
+   char        detail[Tracer::DETAILCHARS + 1]; // Copied, may be empty
+}; // end struct TraceEvent
+
+//******************************************************************************
+//
+// Class:    TraceBuffer
+//
+// Overview: The events of one thread
+//             Only its thread writes events, publishing each with a release
+//                store of numEvents, so stop reads every published event
+//                without a lock
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+//
+//******************************************************************************
+struct TraceBuffer
+{
+   int                threadId;                        // tid in the trace
+   char               threadName[Tracer::DETAILCHARS + 1]; // Empty if unnamed
+   vector<TraceEvent> events;                          // Sized once
+   atomic<int>        numEvents;                       // Published events
+   atomic<long long>  numDropped;                      // Events of a full
+                                                       // buffer
+}; // end struct TraceBuffer
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+atomic<bool> Tracer::enabled(false);
+
+static mutex                buffersMutex;         // Guards everything below
+static vector<TraceBuffer*> buffers;              // Of every traced thread
+static string               traceFileName;        // Written by stop
+static int                  eventsPerThread = 0;  // Size of each buffer
+static bool                 started         = false; // start called?
+static bool                 stopped         = false; // stop called?
+static Tracer::Clock::time_point epoch;           // Time 0 of the trace
+
+static thread_local TraceBuffer* threadBuffer = NULL; // This thread's
+
+static const double NANOSPERMICRO = 1000.0; // Trace times are microseconds
+static const int    PROCESSID     = 1;      // pid of every event
+
+//******************************************************************************
+// Function : copyTail
+// Process  : Copy the last DETAILCHARS characters of source, or all of a
+//             shorter one, NULL copies as empty
+// Notes    : destination holds DETAILCHARS + 1 chars
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void copyTail(
+   char* destination,
+   const char* source)
+{
+   size_t length = (NULL == source) ? 0 : strlen(source); // Of the source
+
+   if (length > size_t(Tracer::DETAILCHARS))
+   {
+      source += length - Tracer::DETAILCHARS;
+      length  = Tracer::DETAILCHARS;
+   }
+
+   if (length > 0)
+   {
+      memcpy(destination, source, length);
+   }
+
+   destination[length] = '\0';
+}
+
+//******************************************************************************
+// Function : freeBuffers
+// Process  : Free every thread's buffer and forget them
+//             Forget this thread's buffer
+// Notes    : Hold buffersMutex
+//             Other threads still hold their freed buffer, tracing is never
+//             enabled again, so they never record into it
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void freeBuffers()
+{
+   for (size_t bufferIndex = 0; bufferIndex < buffers.size(); ++bufferIndex)
+   {
+      delete buffers[bufferIndex];
+   }
+
+   buffers.clear();
+   buffers.shrink_to_fit();
+   threadBuffer = NULL;
+}
+
+//******************************************************************************
+// Function : getThreadBuffer
+// Process  : Allocate and register this thread's buffer on its first use
+// Notes    : The only allocation of a thread
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static TraceBuffer* getThreadBuffer()
+{
+   if (NULL == threadBuffer)
+   {
+      lock_guard<mutex> lock(buffersMutex);
+
+      threadBuffer = new TraceBuffer();
+      threadBuffer->threadId      = buffers.size() + 1;
+      threadBuffer->threadName[0] = '\0';
+      threadBuffer->events.resize(eventsPerThread);
+      threadBuffer->numEvents.store(0);
+      threadBuffer->numDropped.store(0);
+      buffers.push_back(threadBuffer);
+   }
+
+   return threadBuffer;
+}
+
+//******************************************************************************
+// Function : writeString
+// Process  : Write the text as a JSON string, escaping quotes, backslashes,
+//             and control characters
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static void writeString(
+   ostream& out,
+   const char* text)
+{
+   out << '"';
+
+   for (const char* character = text; '\0' != *character; ++character)
+   {
+      if ('"' == *character || '\\' == *character)
+      {
+         out << '\\' << *character;
+      }
+      else if ((unsigned char)*character < ' ')
+      {
+         out << ' ';
+      }
+      else
+      {
+         out << *character;
+      }
+   }
+
+   out << '"';
+}
+
+//******************************************************************************
+// Function : addEvent
+// Process  : Find this thread's buffer
+//             Count the event as dropped if the buffer is full
+//             Fill the next slot
+//             Publish it
+// Notes    : No lock and, after the thread's first event, no allocation
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Tracer::addEvent(
+   const char* name,
+   const char* detail,
+   const Clock::time_point& begin,
+   const Clock::time_point& end)
+{
+   TraceBuffer* buffer    = getThreadBuffer(); // This thread's
+   const int    NUMEVENTS = buffer->numEvents.load(memory_order_relaxed);
+
+   // Count the event as dropped if the buffer is full
+   if (NUMEVENTS >= int(buffer->events.size()))
+   {
+      buffer->numDropped.store(
+         buffer->numDropped.load(memory_order_relaxed) + 1, 
+         memory_order_relaxed);
+      return;
+   }
+
+   // Fill the next slot
+   TraceEvent& event = buffer->events[NUMEVENTS];
+
+   event.name          = name;
+   event.beginNanos    = 
+      chrono::duration_cast<chrono::nanoseconds>(begin - epoch).count();
+   event.durationNanos = 
+      chrono::duration_cast<chrono::nanoseconds>(end - begin).count();
+   copyTail(event.detail, detail);
+
+   // Publish it
+   buffer->numEvents.store(NUMEVENTS + 1, memory_order_release);
+}
+
+//******************************************************************************
+// Function : setThreadName
+// Process  : Copy the name into this thread's buffer when enabled
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void Tracer::setThreadName(const char* threadName)
+{
+   if (Tracer::isEnabled())
+   {
+      TraceBuffer* buffer = getThreadBuffer(); // This thread's
+
+      lock_guard<mutex> lock(buffersMutex);
+      copyTail(buffer->threadName, threadName);
+   }
+}
+
+//******************************************************************************
+// Function : start
+// Process  : Check the buffer size and that we haven't started
+//             Remember the file and buffer size
+//             Time 0 is now
+//             Enable
+// Notes    : Throws an exception if already started, or if eventsPerThread
+//             isn't positive
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Checks the buffer size on its own
+//******************************************************************************
+void Tracer::start(
+   const string& traceFileName,
+   const int eventsPerThread)
+{
+   lock_guard<mutex> lock(buffersMutex);
+
+   // Check the buffer size and that we haven't started
+   if (eventsPerThread < 1)
+   {
+      throw exception("eventsPerThread must be positive");
+   }
+
+   if (started)
+   {
+      throw exception("Tracer can only be started once");
+   }
+
+   // Remember the file and buffer size
+
+   ::traceFileName   = traceFileName;
+   ::eventsPerThread = eventsPerThread;
+   ::epoch           = Clock::now();
+   started           = true;
+
+   Tracer::enabled.store(true);
+}
+
+//******************************************************************************
+// Function : stop
+// Process  : Disable
+//             Write the process and thread names as metadata events
+//             Write each thread's published events as complete events
+//             Write the events dropped by full buffers
+//             Free every thread's buffer
+// Notes    : Does nothing if not started or already stopped
+//             Throws an exception if the file can't be written, after
+//                freeing the buffers
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Frees the buffers
+//******************************************************************************
+void Tracer::stop()
+{
+   lock_guard<mutex> lock(buffersMutex);
+   ofstream          fout;           // Trace writer
+   long long         numDropped = 0; // Events of full buffers
+
+   if (!started || stopped)
+   {
+      return;
+   }
+
+   // Disable
+   Tracer::enabled.store(false);
+   stopped = true;
+
+   fout.open(traceFileName.c_str());
+
+   if (!fout.good())
+   {
+      freeBuffers();
+      throw exception("Could not write the trace");
+   }
+
+   // Write the process and thread names as metadata events
+   fout << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << endl;
+   fout << "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": " 
+        << PROCESSID << ", \"tid\": 0, \"args\": {\"name\": "
+        << "\"stockanalyzer\"}}";
+
+   for (size_t bufferIndex = 0; bufferIndex < buffers.size(); ++bufferIndex)
+   {
+      const TraceBuffer& buffer = *buffers[bufferIndex];
+
+      if ('\0' != buffer.threadName[0])
+      {
+         fout << "," << endl 
+              << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": " 
+              << PROCESSID << ", \"tid\": " << buffer.threadId 
+              << ", \"args\": {\"name\": ";
+         writeString(fout, buffer.threadName);
+         fout << "}}";
+      }
+   }
+
+   // Write each thread's published events as complete events
+   fout << fixed << setprecision(3);
+
+   for (size_t bufferIndex = 0; bufferIndex < buffers.size(); ++bufferIndex)
+   {
+      const TraceBuffer& buffer    = *buffers[bufferIndex];
+      const int          NUMEVENTS = 
+         buffer.numEvents.load(memory_order_acquire);
+
+      for (int eventIndex = 0; eventIndex < NUMEVENTS; ++eventIndex)
+      {
+         const TraceEvent& event = buffer.events[eventIndex];
+
+         fout << "," << endl << "{\"name\": ";
+         writeString(fout, event.name);
+         fout << ", \"ph\": \"X\", \"pid\": " << PROCESSID 
+              << ", \"tid\": " << buffer.threadId
+              << ", \"ts\": " << event.beginNanos / NANOSPERMICRO
+              << ", \"dur\": " << event.durationNanos / NANOSPERMICRO;
+
+         if ('\0' != event.detail[0])
+         {
+            fout << ", \"args\": {\"detail\": ";
+            writeString(fout, event.detail);
+            fout << "}";
+         }
+
+         fout << "}";
+      }
+
+      numDropped += buffer.numDropped.load(memory_order_relaxed);
+   }
+
+   // Write the events dropped by full buffers
+   fout << endl << "], \"otherData\": {\"droppedEvents\": \"" 
+        << numDropped << "\"}}" << endl;
+
+   // Free every thread's buffer
+   freeBuffers();
+
+   if (!fout.good())
+   {
+      throw exception("Could not write the trace");
+   }
+}
@@ -0,0 +1,137 @@
+//******************************************************************************
+//
+// File Name:     Tracer.h
+//
+// File Overview: Represents a Tracer, Chrome trace events of a run
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         stop frees the buffers
+//******************************************************************************
+
+#ifndef Tracer_h
+#define Tracer_h
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    Tracer
+//
+// Overview: Records a complete event, a name with begin and end times, for
+//             each traced scope into a bounded buffer per thread
+//             A thread's buffer is allocated once, on its first event, so
+//                recording never allocates: it copies the event into the
+//                next slot and publishes the count, without a lock
+//             A full buffer drops further events of its thread and counts 
+//                them
+//             stop writes every buffer as a Chrome trace event JSON file,
+//                which Perfetto and chrome://tracing open
+//             Started at most once per process, stop frees the buffers, so
+//                it is called once every other traced thread has finished
+//             MetricsTimer records the events, see Metrics
+//             Everything is static, there is nothing to construct
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         stop frees the buffers
+//
+//******************************************************************************
+class Tracer
+{
+public:
+
+   typedef chrono::steady_clock Clock; // Monotonic clock of every event
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : addEvent
+   // Description : Records the event in this thread's buffer
+   //                name must be a string literal, detail is copied, its
+   //                last DETAILCHARS characters are kept
+   // Constraints : Only call when enabled, see MetricsTimer
+   //***************************************************************************
+   static void addEvent(
+      const char* name,
+      const char* detail,
+      const Clock::time_point& begin,
+      const Clock::time_point& end);
+
+   //***************************************************************************
+   // Function    : isEnabled
+   // Description : Accessor for enabled
+   // Constraints : None
+   //***************************************************************************
+   static inline bool isEnabled();
+
+   //***************************************************************************
+   // Function    : setThreadName
+   // Description : Names this thread in the trace
+   // Constraints : Only recorded when enabled
+   //***************************************************************************
+   static void setThreadName(const char* threadName);
+
+   //***************************************************************************
+   // Function    : start
+   // Description : Enables tracing to the file with room for eventsPerThread
+   //                events in each thread's buffer
+   // Constraints : Throws an exception if already started, or if
+   //                eventsPerThread isn't positive
+   //***************************************************************************
+   static void start(
+      const string& traceFileName,
+      const int eventsPerThread = DEFAULTEVENTSPERTHREAD);
+
+   //***************************************************************************
+   // Function    : stop
+   // Description : Disables tracing, writes the trace file, and frees every
+   //                thread's buffer
+   //                Does nothing if not started
+   // Constraints : Throws an exception if the file can't be written, the
+   //                buffers are freed either way
+   //                Call once no other thread is recording, a traced scope
+   //                still open records into its thread's buffer
+   //***************************************************************************
+   static void stop();
+
+   static const int DEFAULTEVENTSPERTHREAD = 65536; // Buffer of each thread
+   static const int DETAILCHARS            = 31;    // Kept of each detail
+
+private:
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Not constructed, everything is static
+   // Constraints : None
+   //***************************************************************************
+   Tracer();
+
+   static atomic<bool> enabled; // Record events?
+}; // end class Tracer
+
+//******************************************************************************
+// Function : isEnabled
+// Process  : Accessor for enabled
+// Notes    : Relaxed, an event begun just before a change is still recorded
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool Tracer::isEnabled()
+{
+   return Tracer::enabled.load(memory_order_relaxed);
+}
+
+#endif // Tracer_h
@@ -0,0 +1,386 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     TradingCalendar.cpp
+//
+// File Overview: Represents a TradingCalendar
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added splitDate
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <exception>
+
+#include "TradingCalendar.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+// Month abbreviations of the Date column, January first
+static const char* MONTHNAMES[12] = 
+{
+   "Jan", "Feb", "Mar", "Apr", "May", "Jun",
+   "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
+};
+
+static const int DAYSINMONTH[12] = // Of a leap year
+{
+   31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31
+};
+
+static const int TWODIGITPIVOT = 70; // Two digit years below are 20xx
+
+
+//******************************************************************************
+// Function : isDigit
+// Process  : Is the character 0 to 9?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+static inline bool isDigit(const char character)
+{
+   return character >= '0' && character <= '9';
+}
+
+//******************************************************************************
+// Function : constructor
+// Process  : No dates, no symbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TradingCalendar::TradingCalendar()
+   : numSymbols(0),
+     numValid(0)
+{
+} // end TradingCalendar::TradingCalendar
+
+//******************************************************************************
+// Function : destructor
+// Process  : None
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+TradingCalendar::~TradingCalendar()
+{
+} // end TradingCalendar::~TradingCalendar
+
+//******************************************************************************
+// Function : align
+// Process  : Check every stock has a date for each price, increasing, and
+//                find the oldest and newest date of any stock
+//             Mark each stock's dates in a table with a slot per day, the
+//                marked days oldest first are the calendar
+//             Fill the matrix a row at a time, advancing each stock's 
+//                position when its next date is the row's
+// Notes    : Throws an exception for a stock without dates, or with dates
+//             out of order or repeated, the calendar is then empty
+//             Day numbers span only the days between the oldest and newest
+//             date, so the merge is linear in the prices and the days, and
+//             the fill writes the matrix in order, reading each stock once
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void TradingCalendar::align(const vector<const Stock*>& stocks)
+{
+   const int             NUMSTOCKS  = stocks.size();
+   int                   oldestDate = INT_MAX;    // Of any stock
+   int                   newestDate = INT_MIN;    // Of any stock
+   long long             numPrices  = 0;          // Of every stock
+   vector<unsigned char> dayMarked;               // Per day, 1 if any stock's
+   vector<int>           positions(NUMSTOCKS, 0); // Each stock's next price
+
+   this->dates.clear();
+   this->numSymbols = 0;
+   this->numValid   = 0;
+
+   // Check every stock has a date for each price, increasing
+   for (int symbolIndex = 0; symbolIndex < NUMSTOCKS; ++symbolIndex)
+   {
+      const Stock& stock      = *stocks[symbolIndex];
+      const int    NUMDATES   = stock.getNumDates();
+      const int*   stockDates = stock.getDateData(); // Oldest first
+
+      if (NUMDATES != stock.getNumPrices())
+      {
+         throw exception("Stock has no date for each price");
+      }
+
+      for (int dateIndex = 1; dateIndex < NUMDATES; ++dateIndex)
+      {
+         if (stockDates[dateIndex] <= stockDates[dateIndex - 1])
+         {
+            throw exception("Stock dates are not increasing");
+         }
+      }
+
+      if (NUMDATES > 0)
+      {
+         oldestDate = min(oldestDate, stockDates[0]);
+         newestDate = max(newestDate, stockDates[NUMDATES - 1]);
+      }
+
+      numPrices += NUMDATES;
+   }
+
+   // Mark each stock's dates, the marked days are the calendar
+   if (numPrices > 0)
+   {
+      dayMarked.assign(newestDate - oldestDate + 1, 0);
+
+      for (int symbolIndex = 0; symbolIndex < NUMSTOCKS; ++symbolIndex)
+      {
+         const int  NUMDATES   = stocks[symbolIndex]->getNumDates();
+         const int* stockDates = stocks[symbolIndex]->getDateData();
+
+         for (int dateIndex = 0; dateIndex < NUMDATES; ++dateIndex)
+         {
+            dayMarked[stockDates[dateIndex] - oldestDate] = 1;
+         }
+      }
+
+      for (size_t day = 0; day < dayMarked.size(); ++day)
+      {
+         if (0 != dayMarked[day])
+         {
+            this->dates.push_back(oldestDate + int(day));
+         }
+      }
+   }
+
+   // Fill the matrix a row at a time
+   this->numSymbols = NUMSTOCKS;
+   this->numValid   = numPrices;
+   this->prices.resize(this->dates.size() * NUMSTOCKS);
+   this->valid.resize(this->dates.size() * NUMSTOCKS);
+
+   for (size_t dateIndex = 0; dateIndex < this->dates.size(); ++dateIndex)
+   {
+      const int      DATE      = this->dates[dateIndex];
+      double*        rowPrices = &this->prices[dateIndex * NUMSTOCKS];
+      unsigned char* rowValid  = &this->valid[dateIndex * NUMSTOCKS];
+
+      for (int symbolIndex = 0; symbolIndex < NUMSTOCKS; ++symbolIndex)
+      {
+         const Stock& stock    = *stocks[symbolIndex];
+         int&         position = positions[symbolIndex];
+
+         if (position < stock.getNumDates() && 
+             DATE == stock.getDateData()[position])
+         {
+            rowPrices[symbolIndex] = AnalyzerPricePolicy::toAccum(
+               stock.getPriceData()[position]);
+            rowValid[symbolIndex]  = 1;
+            ++position;
+         }
+         else
+         {
+            rowPrices[symbolIndex] = 0.0;
+            rowValid[symbolIndex]  = 0;
+         }
+      }
+   }
+}
+
+//******************************************************************************
+// Function : formatDate
+// Process  : Convert the day number to its civil date
+//             Format it as d-Mon-yy
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+// 10.19.26       Donne Martin         Converts with splitDate
+//******************************************************************************
+string TradingCalendar::formatDate(const int date)
+{
+   char text[16];  // Formatted date
+   int  year  = 0; // Of the date
+   int  month = 0; // 1 to 12
+   int  day   = 0; // 1 to 31
+
+   TradingCalendar::splitDate(date, year, month, day);
+
+   // Format it as d-Mon-yy
+   sprintf(text, "%d-%s-%02d", day, MONTHNAMES[month - 1], 
+           ((year % 100) + 100) % 100);
+
+   return string(text);
+}
+
+//******************************************************************************
+// Function : parseDate
+// Process  : 2011-06-24, four digit year, two digit month and day
+//             Otherwise 24-Jun-11, one or two digit day, month name, two 
+//                digit year
+//             Check the day exists in the month
+//             Convert to the day number
+// Notes    : Reads fixed positions, no locale, no allocation
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool TradingCalendar::parseDate(
+   const char* text,
+   int& date)
+{
+   int year  = 0; // Parsed
+   int month = 0; // 1 to 12
+   int day   = 0; // 1 to 31
+
+   if (NULL == text)
+   {
+      return false;
+   }
+
+   // 2011-06-24
+   if (isDigit(text[0]) && isDigit(text[1]) && isDigit(text[2]) && 
+       isDigit(text[3]) && '-' == text[4] && 
+       isDigit(text[5]) && isDigit(text[6]) && '-' == text[7] &&
+       isDigit(text[8]) && isDigit(text[9]))
+   {
+      year  = (text[0] - '0') * 1000 + (text[1] - '0') * 100 + 
+              (text[2] - '0') * 10 + (text[3] - '0');
+      month = (text[5] - '0') * 10 + (text[6] - '0');
+      day   = (text[8] - '0') * 10 + (text[9] - '0');
+   }
+   // 24-Jun-11
+   else
+   {
+      if (!isDigit(text[0]))
+      {
+         return false;
+      }
+
+      day = text[0] - '0';
+      ++text;
+
+      if (isDigit(text[0]))
+      {
+         day = day * 10 + (text[0] - '0');
+         ++text;
+      }
+
+      if ('-' != text[0] || '\0' == text[1] || '\0' == text[2] || 
+          '\0' == text[3] || '-' != text[4] || 
+          !isDigit(text[5]) || !isDigit(text[6]))
+      {
+         return false;
+      }
+
+      for (int monthIndex = 0; monthIndex < 12; ++monthIndex)
+      {
+         const char* NAME = MONTHNAMES[monthIndex]; // Three letters
+
+         if (NAME[0] == text[1] && NAME[1] == text[2] && NAME[2] == text[3])
+         {
+            month = monthIndex + 1;
+            break;
+         }
+      }
+
+      year = (text[5] - '0') * 10 + (text[6] - '0');
+      year += (year < TWODIGITPIVOT) ? 2000 : 1900;
+   }
+
+   // Check the day exists in the month
+   if (month < 1 || month > 12 || day < 1 || day > DAYSINMONTH[month - 1] ||
+       (2 == month && 29 == day && 
+        !(0 == year % 4 && (0 != year % 100 || 0 == year % 400))))
+   {
+      return false;
+   }
+
+   date = TradingCalendar::toDate(year, month, day);
+
+   return true;
+}
+
+//******************************************************************************
+// Function : splitDate
+// Process  : Count the days from 1-Mar-0000, in 400 year eras
+//             Find the year of the era, then the day of that year, with
+//                years starting in March so the leap day is last
+//             Find the month and day, then move January and February to the
+//                next year
+// Notes    : Civil date from days, after Howard Hinnant's civil_from_days
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function, from formatDate
+//******************************************************************************
+void TradingCalendar::splitDate(
+   const int date,
+   int& year,
+   int& month,
+   int& day)
+{
+   const int DAYS = date + 719468;    // Since 1-Mar-0000
+   const int ERA  = (DAYS >= 0 ? DAYS : DAYS - 146096) / 146097;
+   const int DOE  = DAYS - ERA * 146097;                     // Day of era
+   const int YOE  = (DOE - DOE / 1460 + DOE / 36524 - DOE / 146096) / 365;
+   const int DOY  = DOE - (365 * YOE + YOE / 4 - YOE / 100); // Day of year
+   const int MP   = (5 * DOY + 2) / 153;                     // March is 0
+
+   day   = DOY - (153 * MP + 2) / 5 + 1;
+   month = MP < 10 ? MP + 3 : MP - 9;
+   year  = YOE + ERA * 400 + (month <= 2 ? 1 : 0);
+}
+
+//******************************************************************************
+// Function : toDate
+// Process  : Count the days from 1-Mar-0000 with years starting in March,
+//                so the leap day is last
+//             Shift to 1-Jan-1970
+// Notes    : After Howard Hinnant's days_from_civil
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int TradingCalendar::toDate(
+   const int year,
+   const int month,
+   const int day)
+{
+   const int MARCHYEAR = year - (month <= 2 ? 1 : 0); // Year from March
+   const int ERA       = (MARCHYEAR >= 0 ? MARCHYEAR : MARCHYEAR - 399) / 400;
+   const int YOE       = MARCHYEAR - ERA * 400;                 // Year of era
+   const int DOY       = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + 
+                         day - 1;                               // Day of year
+   const int DOE       = YOE * 365 + YOE / 4 - YOE / 100 + DOY; // Day of era
+
+   return ERA * 146097 + DOE - 719468;
+}
@@ -0,0 +1,352 @@
+//******************************************************************************
+//
+// File Name:     TradingCalendar.h
+//
+// File Overview: Represents a TradingCalendar, stocks aligned by date
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added splitDate
+//******************************************************************************
+
+#ifndef TradingCalendar_h
+#define TradingCalendar_h
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "Stock.h"
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    TradingCalendar
+//
+// Overview: Aligns dated stocks on the union of their dates, so a row holds
+//             the same day for every symbol
+//             Dates are day numbers, days since 1-Jan-1970, parsed from the
+//                Date column of a stock data file by parseDate
+//             The calendar merges the stocks' dates through a table with a
+//                slot per day, then each stock is copied into a dense
+//                date x symbol matrix of prices, stored by date so a row is
+//                contiguous, with a validity mask of the same layout
+//             A symbol with no price on a date, not yet listed, halted, or
+//                on its holiday, has price 0.0 and is not valid there
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added splitDate
+//
+//******************************************************************************
+class TradingCalendar
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : Empty calendar of no symbols
+   // Constraints : None
+   //***************************************************************************
+   TradingCalendar();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Performs cleanup tasks
+   // Constraints : None
+   //***************************************************************************
+   virtual ~TradingCalendar();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : align
+   // Description : Builds the calendar of every date of the stocks and the
+   //                date x symbol matrix, symbol i being stocks[i]
+   //                Linear in the prices, the days spanned, and the matrix
+   // Constraints : Throws an exception if a stock has no date for each 
+   //                price, or dates not strictly increasing, oldest first
+   //***************************************************************************
+   void align(const vector<const Stock*>& stocks);
+
+   //***************************************************************************
+   // Function    : formatDate
+   // Description : Retrieve the day number as in a stock data file, 
+   //                24-Jun-11
+   // Constraints : None
+   //***************************************************************************
+   static string formatDate(const int date);
+
+   //***************************************************************************
+   // Function    : getDateAt
+   // Description : Retrieve the day number of the calendar row
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getDateAt(const int dateIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumDates
+   // Description : Retrieve the number of rows, dates of any symbol
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumDates() const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieve the number of columns, stocks aligned
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getNumValid
+   // Description : Retrieve the number of valid cells, the prices aligned
+   // Constraints : None
+   //***************************************************************************
+   inline long long getNumValid() const;
+
+   //***************************************************************************
+   // Function    : getPriceAt
+   // Description : Retrieve the symbol's price on the calendar row, 0.0 
+   //                when not valid
+   // Constraints : Throws an out_of_range exception for invalid indices
+   //***************************************************************************
+   inline double getPriceAt(
+      const int dateIndex,
+      const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getPriceRow
+   // Description : Retrieve the getNumSymbols prices of the calendar row
+   //                For the cross-sectional kernels
+   // Constraints : Throws an out_of_range exception for invalid index
+   //                Only valid until align is called again
+   //***************************************************************************
+   inline const double* getPriceRow(const int dateIndex) const;
+
+   //***************************************************************************
+   // Function    : getValidRow
+   // Description : Retrieve the getNumSymbols validity flags of the 
+   //                calendar row, 1 where the symbol has a price, else 0
+   // Constraints : Throws an out_of_range exception for invalid index
+   //                Only valid until align is called again
+   //***************************************************************************
+   inline const unsigned char* getValidRow(const int dateIndex) const;
+
+   //***************************************************************************
+   // Function    : isValidAt
+   // Description : Does the symbol have a price on the calendar row?
+   // Constraints : Throws an out_of_range exception for invalid indices
+   //***************************************************************************
+   inline bool isValidAt(
+      const int dateIndex,
+      const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : parseDate
+   // Description : Parses a date of a stock data file, 24-Jun-11 or 
+   //                2011-06-24, into its day number
+   //                Returns false, leaving date unchanged, if it is neither
+   //                Two digit years below 70 are 20xx, the rest 19xx
+   // Constraints : The date may be followed by anything, it is not read
+   //***************************************************************************
+   static bool parseDate(
+      const char* text,
+      int& date);
+
+   //***************************************************************************
+   // Function    : splitDate
+   // Description : Retrieve the civil year, month 1 to 12, and day 1 to 31 of
+   //                the day number
+   // Constraints : None
+   //***************************************************************************
+   static void splitDate(
+      const int date,
+      int& year,
+      int& month,
+      int& day);
+
+   //***************************************************************************
+   // Function    : toDate
+   // Description : Retrieve the day number of the civil date
+   // Constraints : month is 1 to 12 and day 1 to 31
+   //***************************************************************************
+   static int toDate(
+      const int year,
+      const int month,
+      const int day);
+
+private:
+   //***************************************************************************
+   // Function    : getCellIndex
+   // Description : Retrieve the matrix index of the calendar row and symbol
+   // Constraints : Throws an out_of_range exception for invalid indices
+   //***************************************************************************
+   inline size_t getCellIndex(
+      const int dateIndex,
+      const int symbolIndex) const;
+
+   vector<int>           dates;      // Day number of each row, increasing
+   int                   numSymbols; // Columns of the matrix
+   long long             numValid;   // Cells with a price
+   vector<double>        prices;     // Price of each cell, by date
+   vector<unsigned char> valid;      // 1 where the cell has a price
+}; // end class TradingCalendar
+
+//******************************************************************************
+// Function : getCellIndex
+// Process  : Check the indices
+//             Rows are dates, so a row's symbols are contiguous
+// Notes    : Throws an out_of_range exception for invalid indices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline size_t TradingCalendar::getCellIndex(
+   const int dateIndex,
+   const int symbolIndex) const
+{
+   if (dateIndex < 0 || dateIndex >= this->getNumDates() ||
+       symbolIndex < 0 || symbolIndex >= this->numSymbols)
+   {
+      throw out_of_range("TradingCalendar cell out of range");
+   }
+
+   return size_t(dateIndex) * this->numSymbols + symbolIndex;
+}
+
+//******************************************************************************
+// Function : getDateAt
+// Process  : Retrieve the day number of the calendar row
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TradingCalendar::getDateAt(const int dateIndex) const
+{
+   return this->dates.at(dateIndex);
+}
+
+//******************************************************************************
+// Function : getNumDates
+// Process  : Retrieve the number of rows
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TradingCalendar::getNumDates() const
+{
+   return this->dates.size();
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Accessor for numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int TradingCalendar::getNumSymbols() const
+{
+   return this->numSymbols;
+}
+
+//******************************************************************************
+// Function : getNumValid
+// Process  : Accessor for numValid
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long TradingCalendar::getNumValid() const
+{
+   return this->numValid;
+}
+
+//******************************************************************************
+// Function : getPriceAt
+// Process  : Retrieve the price of the cell
+// Notes    : Throws an out_of_range exception for invalid indices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline double TradingCalendar::getPriceAt(
+   const int dateIndex,
+   const int symbolIndex) const
+{
+   return this->prices[this->getCellIndex(dateIndex, symbolIndex)];
+}
+
+//******************************************************************************
+// Function : getPriceRow
+// Process  : Retrieve the first price of the row
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* TradingCalendar::getPriceRow(const int dateIndex) const
+{
+   return &this->prices[this->getCellIndex(dateIndex, 0)];
+}
+
+//******************************************************************************
+// Function : getValidRow
+// Process  : Retrieve the first validity flag of the row
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const unsigned char* TradingCalendar::getValidRow(
+   const int dateIndex) const
+{
+   return &this->valid[this->getCellIndex(dateIndex, 0)];
+}
+
+//******************************************************************************
+// Function : isValidAt
+// Process  : Retrieve the validity flag of the cell
+// Notes    : Throws an out_of_range exception for invalid indices
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool TradingCalendar::isValidAt(
+   const int dateIndex,
+   const int symbolIndex) const
+{
+   return 0 != this->valid[this->getCellIndex(dateIndex, symbolIndex)];
+}
+
+#endif // TradingCalendar_h
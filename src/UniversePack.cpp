@@ -0,0 +1,630 @@
+// COPYRIGHT  2011, Donne Martin
+// All Rights Reserved.
+//
+//******************************************************************************
+//
+// File Name:     UniversePack.cpp
+//
+// File Overview: Represents a UniversePack
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added releaseSymbols
+//******************************************************************************
+
+#include "stdafx.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <unordered_map>
+
+#include "Platform.h"
+#include "StockAnalyzer.h"
+#include "TradingCalendar.h"
+#include "UniversePack.h"
+
+//******************************************************************************
+// File scope (static) variable definitions
+//******************************************************************************
+
+static const char PACKMAGIC[8] = {'S', 'T', 'K', 'P', 'A', 'C', 'K', '1'};
+static const int  PACKVERSION  = 1; // Of the layout
+
+//******************************************************************************
+// Function : constructor
+// Process  : No mapping
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+UniversePack::UniversePack()
+   : data(NULL),
+     directory(NULL),
+     mapping(0),
+     numBytes(0),
+     numSymbols(0)
+{
+} // end UniversePack::UniversePack
+
+//******************************************************************************
+// Function : destructor
+// Process  : Close the pack
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+UniversePack::~UniversePack()
+{
+   this->close();
+} // end UniversePack::~UniversePack
+
+//******************************************************************************
+// Function : appendStocks
+// Process  : Read the header and the directory
+//             For each stock data file
+//                Read its rows, and find its symbol, adding new symbols
+//                Skip the rows the symbol already has
+//                If the new rows don't fit, move the symbol's segments to
+//                   the end of the data, with a quarter more room
+//                Write the new rows after the symbol's rows
+//             Sort the directory and write it after the data
+//             Write the header
+// Notes    : Throws an exception if the pack or a stock data file can't
+//             be read or written, or a row has no date
+//             A new symbol's segments have room for its rows, rounded up
+//                to ROWGRANULE, so a new pack is tightly packed
+//             The old directory is overwritten by the first segments
+//                written, the pack is only valid again once the header
+//                is written
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::appendStocks(
+   const string&         packFileName,
+   const vector<string>& stockDataFileNames)
+{
+   Header                     header;                 // Of the pack
+   vector<DirectoryEntry>     entries;                // Its directory
+   unordered_map<string, int> entryIndices;           // Entry of each symbol
+   StockRows                  stockRows;              // Of a stock data file
+   vector<char>               segment;                // Column being moved
+   const char*                columnData[NUMCOLUMNS]; // New rows, by column
+   fstream                    pack;                   // Being appended to
+   string                     symbol;                 // Of a stock data file
+   long long                  dataEnd    = 0;         // Where segments go
+   int                        firstRow   = 0;         // First row not in it
+   int                        numNewRows = 0;         // Rows not in it
+
+   pack.open(packFileName.c_str(), ios::in | ios::out | ios::binary);
+
+   if (!pack.good())
+   {
+      throw exception("Could not open the universe pack");
+   }
+
+   // Read the header and the directory
+   pack.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+   if (!pack.good() ||
+       0 != memcmp(header.magic, PACKMAGIC, sizeof(header.magic)) ||
+       PACKVERSION != header.version || header.numSymbols < 0)
+   {
+      throw exception("Not a universe pack");
+   }
+
+   entries.resize(header.numSymbols);
+   pack.seekg(header.directoryOffset);
+
+   if (!entries.empty())
+   {
+      pack.read(reinterpret_cast<char*>(&entries[0]),
+                entries.size() * sizeof(DirectoryEntry));
+   }
+
+   if (!pack.good())
+   {
+      throw exception("Universe pack is corrupt");
+   }
+
+   for (size_t entryIndex = 0; entryIndex < entries.size(); ++entryIndex)
+   {
+      entryIndices[entries[entryIndex].symbol] = entryIndex;
+   }
+
+   dataEnd = header.directoryOffset;
+
+   // For each stock data file
+   for (size_t fileIndex = 0;
+        fileIndex < stockDataFileNames.size();
+        ++fileIndex)
+   {
+      // Read its rows, and find its symbol, adding new symbols
+      symbol = StockAnalyzer::getSymbolFromFileName(
+         stockDataFileNames[fileIndex].c_str());
+
+      if (symbol.empty() || symbol.size() >= UniversePack::SYMBOLBYTES)
+      {
+         throw exception("Symbol can't be held by a universe pack");
+      }
+
+      UniversePack::readStockDataFile(stockDataFileNames[fileIndex], stockRows);
+
+      if (entryIndices.end() == entryIndices.find(symbol))
+      {
+         DirectoryEntry newEntry; // Of the new symbol
+
+         memset(&newEntry, 0, sizeof(newEntry));
+         memcpy(newEntry.symbol, symbol.c_str(), symbol.size());
+         newEntry.offset = dataEnd;
+         entryIndices[symbol] = entries.size();
+         entries.push_back(newEntry);
+      }
+
+      DirectoryEntry& entry = entries[entryIndices[symbol]]; // Of the symbol
+
+      // Skip the rows the symbol already has
+      firstRow = 0;
+
+      if (entry.numRows > 0)
+      {
+         firstRow = upper_bound(stockRows.dates.begin(),
+                                stockRows.dates.end(),
+                                entry.lastDate) - stockRows.dates.begin();
+      }
+
+      numNewRows = stockRows.dates.size() - firstRow;
+
+      if (0 == numNewRows)
+      {
+         continue;
+      }
+
+      // If the new rows don't fit, move the symbol's segments to the end of
+      // the data, with a quarter more room
+      if (entry.numRows + numNewRows > entry.capacity)
+      {
+         int capacity = entry.numRows + numNewRows; // Of the moved segments
+
+         if (entry.numRows > 0)
+         {
+            capacity += capacity / 4;
+         }
+
+         capacity = (capacity + UniversePack::ROWGRANULE - 1) /
+                    UniversePack::ROWGRANULE * UniversePack::ROWGRANULE;
+
+         for (int column = 0; column < NUMCOLUMNS && entry.numRows > 0;
+              ++column)
+         {
+            long long columnOffset = UniversePack::getColumnOffset(
+               PackColumn(column), 1); // Of the column, in one row segments
+
+            segment.resize(entry.numRows * (UniversePack::getColumnOffset(
+               PackColumn(column + 1), 1) - columnOffset));
+            pack.seekg(entry.offset + columnOffset * entry.capacity);
+            pack.read(&segment[0], segment.size());
+            pack.seekp(dataEnd + columnOffset * capacity);
+            pack.write(&segment[0], segment.size());
+         }
+
+         entry.offset   = dataEnd;
+         entry.capacity = capacity;
+         dataEnd       += UniversePack::getColumnOffset(NUMCOLUMNS, capacity);
+      }
+
+      // Write the new rows after the symbol's rows
+      columnData[COLUMNDATES]   =
+         reinterpret_cast<const char*>(&stockRows.dates[firstRow]);
+      columnData[COLUMNOPENS]   =
+         reinterpret_cast<const char*>(&stockRows.opens[firstRow]);
+      columnData[COLUMNHIGHS]   =
+         reinterpret_cast<const char*>(&stockRows.highs[firstRow]);
+      columnData[COLUMNLOWS]    =
+         reinterpret_cast<const char*>(&stockRows.lows[firstRow]);
+      columnData[COLUMNCLOSES]  =
+         reinterpret_cast<const char*>(&stockRows.closes[firstRow]);
+      columnData[COLUMNVOLUMES] =
+         reinterpret_cast<const char*>(&stockRows.volumes[firstRow]);
+
+      for (int column = 0; column < NUMCOLUMNS; ++column)
+      {
+         long long columnOffset = UniversePack::getColumnOffset(
+            PackColumn(column), 1); // Of the column, in one row segments
+         long long rowBytes     = UniversePack::getColumnOffset(
+            PackColumn(column + 1), 1) - columnOffset; // Of the column
+
+         pack.seekp(entry.offset + columnOffset * entry.capacity +
+                    rowBytes * entry.numRows);
+         pack.write(columnData[column], rowBytes * numNewRows);
+      }
+
+      if (0 == entry.numRows)
+      {
+         entry.firstDate = stockRows.dates[firstRow];
+      }
+
+      entry.numRows += numNewRows;
+      entry.lastDate = stockRows.dates.back();
+
+      if (!pack.good())
+      {
+         throw exception("Could not write the universe pack");
+      }
+   }
+
+   // Sort the directory and write it after the data
+   sort(entries.begin(), entries.end(), UniversePack::isSymbolLess);
+
+   if (!entries.empty())
+   {
+      pack.seekp(dataEnd);
+      pack.write(reinterpret_cast<const char*>(&entries[0]),
+                 entries.size() * sizeof(DirectoryEntry));
+   }
+
+   // Write the header
+   header.numSymbols      = entries.size();
+   header.directoryOffset = dataEnd;
+   pack.seekp(0);
+   pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+   pack.close();
+
+   if (pack.fail())
+   {
+      throw exception("Could not write the universe pack");
+   }
+}
+
+//******************************************************************************
+// Function : buildPack
+// Process  : Write the header of an empty pack, whose data ends at the
+//             header
+//             Append the stock data files to it
+// Notes    : See appendStocks
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::buildPack(
+   const string&         packFileName,
+   const vector<string>& stockDataFileNames)
+{
+   Header   header; // Of the empty pack
+   ofstream pack;   // Empty pack
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, PACKMAGIC, sizeof(header.magic));
+   header.version         = PACKVERSION;
+   header.numSymbols      = 0;
+   header.directoryOffset = sizeof(header);
+
+   // Write the header of an empty pack, whose data ends at the header
+   pack.open(packFileName.c_str(), ios::out | ios::binary | ios::trunc);
+   pack.write(reinterpret_cast<const char*>(&header), sizeof(header));
+   pack.close();
+
+   if (pack.fail())
+   {
+      throw exception("Could not write the universe pack");
+   }
+
+   // Append the stock data files to it
+   UniversePack::appendStocks(packFileName, stockDataFileNames);
+}
+
+//******************************************************************************
+// Function : close
+// Process  : Unmap the pack, and forget its directory
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::close()
+{
+   if (this->isOpen())
+   {
+      Platform::unmapFile(this->data, this->numBytes, this->mapping);
+   }
+
+   this->data       = NULL;
+   this->directory  = NULL;
+   this->mapping    = 0;
+   this->numBytes   = 0;
+   this->numSymbols = 0;
+}
+
+//******************************************************************************
+// Function : findSymbol
+// Process  : Binary search of the sorted directory
+// Notes    : Returns -1 if the pack doesn't have the symbol
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+int UniversePack::findSymbol(const string& symbol) const
+{
+   int first = 0;                // First entry that may be the symbol
+   int last  = this->numSymbols; // After the last that may be
+   int order = 0;                // Of the symbol and the middle entry
+
+   while (first < last)
+   {
+      int middle = first + (last - first) / 2; // Entry compared
+
+      order = strcmp(symbol.c_str(), this->directory[middle].symbol);
+
+      if (0 == order)
+      {
+         return middle;
+      }
+
+      if (order < 0)
+      {
+         last = middle;
+      }
+      else
+      {
+         first = middle + 1;
+      }
+   }
+
+   return -1;
+}
+
+//******************************************************************************
+// Function : isPackFile
+// Process  : Read the magic from the start of the file
+// Notes    : Returns false if it can't be read
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool UniversePack::isPackFile(const string& fileName)
+{
+   char     magic[sizeof(PACKMAGIC)]; // Start of the file
+   ifstream file(fileName.c_str(), ios::in | ios::binary);
+
+   file.read(magic, sizeof(magic));
+
+   return file.good() && 0 == memcmp(magic, PACKMAGIC, sizeof(magic));
+}
+
+//******************************************************************************
+// Function : isSymbolLess
+// Process  : Compare the null padded symbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+bool UniversePack::isSymbolLess(
+   const DirectoryEntry& leftEntry,
+   const DirectoryEntry& rightEntry)
+{
+   return strcmp(leftEntry.symbol, rightEntry.symbol) < 0;
+}
+
+//******************************************************************************
+// Function : open
+// Process  : Close any pack open and map the file
+//             Check the header, that the directory is inside the file, and
+//                that each entry's segments are inside the data
+//             Point at the directory
+// Notes    : Throws an exception if the file can't be mapped or isn't a
+//             valid pack
+//             Checking every entry reads the whole directory, but none of
+//                the segments
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::open(const string& packFileName)
+{
+   const Header*         header  = NULL; // Of the mapped pack
+   const DirectoryEntry* entries = NULL; // Its directory
+   bool                  valid   = false; // Is it a pack?
+
+   // Close any pack open and map the file
+   this->close();
+   this->data = Platform::mapFile(packFileName, this->numBytes, this->mapping);
+
+   // Check the header, that the directory is inside the file, and that each
+   // entry's segments are inside the data
+   header = reinterpret_cast<const Header*>(this->data);
+   valid  = this->numBytes >= sizeof(Header) &&
+            0 == memcmp(header->magic, PACKMAGIC, sizeof(header->magic)) &&
+            PACKVERSION == header->version && header->numSymbols >= 0 &&
+            header->directoryOffset >= (long long)sizeof(Header) &&
+            header->directoryOffset <= (long long)this->numBytes &&
+            (this->numBytes - header->directoryOffset) /
+               sizeof(DirectoryEntry) >= size_t(header->numSymbols);
+
+   if (valid)
+   {
+      entries = reinterpret_cast<const DirectoryEntry*>(
+         this->data + header->directoryOffset);
+   }
+
+   for (int entryIndex = 0;
+        valid && entryIndex < header->numSymbols;
+        ++entryIndex)
+   {
+      const DirectoryEntry& entry = entries[entryIndex]; // Being checked
+
+      valid = 0 == entry.symbol[UniversePack::SYMBOLBYTES - 1] &&
+              entry.numRows >= 0 && entry.capacity >= entry.numRows &&
+              entry.offset >= (long long)sizeof(Header) &&
+              entry.offset + UniversePack::getColumnOffset(
+                 NUMCOLUMNS, entry.capacity) <= header->directoryOffset;
+   }
+
+   if (!valid)
+   {
+      this->close();
+      throw exception("Not a valid universe pack");
+   }
+
+   // Point at the directory
+   this->directory  = entries;
+   this->numSymbols = header->numSymbols;
+}
+
+//******************************************************************************
+// Function : releaseSymbols
+// Process  : Release the pages of each symbol's segments, a symbol at a
+//                time, moved segments aren't next to their neighbours
+// Notes    : Throws an out_of_range exception for invalid index
+//             A page shared with a symbol outside the range is released
+//                too, it is simply read back
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::releaseSymbols(
+   const int firstSymbolIndex,
+   const int endSymbolIndex) const
+{
+   for (int symbolIndex = firstSymbolIndex; 
+        symbolIndex < endSymbolIndex; 
+        ++symbolIndex)
+   {
+      const DirectoryEntry& entry = this->getEntry(symbolIndex); // Released
+
+      Platform::releaseMappedPages(
+         this->data + entry.offset,
+         (size_t)UniversePack::getColumnOffset(NUMCOLUMNS, entry.capacity));
+   }
+}
+
+//******************************************************************************
+// Function : readStockDataFile
+// Process  : Skip the labels
+//             Split each line at commas, skipping lines without a close
+//             Keep the date, open, high, low, close, and volume
+//             Reverse the rows, the file is newest first
+// Notes    : Throws an exception if the file can't be read, a close
+//             doesn't parse, or a row has no date
+//             Parses as StockAnalyzer::parsePricesFromDataFile does, so a
+//                pack analyzes to the same MACDs as its stock data files
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+void UniversePack::readStockDataFile(
+   const string& stockDataFileName,
+   StockRows&    stockRows)
+{
+   static const int   MAXCHARSPERLINE        = 512; // Max chars per line
+   static const int   MAXTOKENSPERLINE       = 6;   // Max "," per line
+   static const char* DELIMITER              = ",";  // CSV files
+   static const int   OPENTOKENINDEX         = 1;   // Open price token index
+   static const int   HIGHTOKENINDEX         = 2;   // High price token index
+   static const int   LOWTOKENINDEX          = 3;   // Low price token index
+   static const int   CLOSINGPRICETOKENINDEX = 4;   // Closing price token
+   static const int   VOLUMETOKENINDEX       = 5;   // Volume token index
+   char*              tokens[MAXTOKENSPERLINE];     // Of the line
+   char               buffer[MAXCHARSPERLINE];      // Holds line
+   ifstream           fin;                          // File reader
+   double             closingPrice = 0.0;           // Of the row
+   int                date         = 0;             // Of the row
+   int                numTokens    = 0;             // In the line
+
+   stockRows.dates.clear();
+   stockRows.opens.clear();
+   stockRows.highs.clear();
+   stockRows.lows.clear();
+   stockRows.closes.clear();
+   stockRows.volumes.clear();
+
+   fin.open(stockDataFileName.c_str());
+
+   if (!fin.good())
+   {
+      throw exception("fstream operation failed");
+   }
+
+   // Skip the labels
+   fin.getline(buffer, MAXCHARSPERLINE);
+
+   while (fin.getline(buffer, MAXCHARSPERLINE))
+   {
+      // Split each line at commas, skipping lines without a close
+      char* context = NULL; // Required by strtok_s
+
+      numTokens = 0;
+
+      for (char* token = strtok_s(buffer, DELIMITER, &context);
+           NULL != token && numTokens < MAXTOKENSPERLINE;
+           token = strtok_s(NULL, DELIMITER, &context))
+      {
+         tokens[numTokens++] = token;
+      }
+
+      if (numTokens <= CLOSINGPRICETOKENINDEX)
+      {
+         continue;
+      }
+
+      // Keep the date, open, high, low, close, and volume
+      closingPrice = atof(tokens[CLOSINGPRICETOKENINDEX]);
+
+      if (abs(HUGE_VAL) == closingPrice || 0.0 == closingPrice)
+      {
+         throw exception("atof operation failed");
+      }
+
+      if (!TradingCalendar::parseDate(tokens[0], date))
+      {
+         throw exception("Stock data file row has no date");
+      }
+
+      stockRows.dates.push_back(date);
+      stockRows.opens.push_back(atof(tokens[OPENTOKENINDEX]));
+      stockRows.highs.push_back(atof(tokens[HIGHTOKENINDEX]));
+      stockRows.lows.push_back(atof(tokens[LOWTOKENINDEX]));
+      stockRows.closes.push_back(closingPrice);
+      stockRows.volumes.push_back(VOLUMETOKENINDEX < numTokens ?
+         atoll(tokens[VOLUMETOKENINDEX]) : 0);
+   }
+
+   // Reverse the rows, the file is newest first
+   reverse(stockRows.dates.begin(), stockRows.dates.end());
+   reverse(stockRows.opens.begin(), stockRows.opens.end());
+   reverse(stockRows.highs.begin(), stockRows.highs.end());
+   reverse(stockRows.lows.begin(), stockRows.lows.end());
+   reverse(stockRows.closes.begin(), stockRows.closes.end());
+   reverse(stockRows.volumes.begin(), stockRows.volumes.end());
+}
@@ -0,0 +1,587 @@
+//******************************************************************************
+//
+// File Name:     UniversePack.h
+//
+// File Overview: Represents a UniversePack
+//
+//******************************************************************************
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added releaseSymbols
+//******************************************************************************
+
+#ifndef UniversePack_h
+#define UniversePack_h
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+//******************************************************************************
+//
+// Class:    UniversePack
+//
+// Overview: A universe of stock histories in one file, mapped into memory
+//             so analysis starts without opening or parsing a stock data
+//             file per symbol
+//             The file is a header, the symbols' column segments, then a
+//                directory of the symbols sorted by name:
+//                header        magic, version, number of symbols, and the
+//                                 offset of the directory
+//                segments      per symbol, capacity rows of each column,
+//                                 oldest first: dates, TradingCalendar day
+//                                 numbers, then opens, highs, lows, closes,
+//                                 and volumes
+//                directory     per symbol, its name, the offset of its
+//                                 segments, its rows and capacity, and its
+//                                 first and last dates
+//             Capacity is a multiple of ROWGRANULE rows, so every segment
+//                starts on a 64 byte boundary, a cache line, and a whole
+//                column can be read by an aligned vector load
+//             buildPack writes a pack from stock data files, appendStocks
+//                adds the rows newer than a symbol's last date, in place
+//                while they fit its capacity, otherwise by moving its
+//                segments to the end of the data
+//                The space a moved symbol leaves is not reused, build a
+//                new pack to compact it
+//             Numbers are in the byte order of the machine, little endian
+//                on every platform we build for
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added class
+// 10.19.26       Donne Martin         Added releaseSymbols
+//
+//******************************************************************************
+class UniversePack
+{
+public:
+
+   //***************************************************************************
+   // Function    : constructor
+   // Description : No pack open
+   // Constraints : None
+   //***************************************************************************
+   UniversePack();
+
+   //***************************************************************************
+   // Function    : destructor
+   // Description : Closes the pack
+   // Constraints : None
+   //***************************************************************************
+   virtual ~UniversePack();
+
+   // Member functions in alphabetical order
+
+   //***************************************************************************
+   // Function    : appendStocks
+   // Description : Adds the rows of each stock data file newer than its
+   //                symbol's last date to the pack, and adds the symbols
+   //                the pack doesn't have
+   // Constraints : Throws an exception if the pack or a stock data file
+   //                can't be read or written, or a row has no date
+   //                Don't append to a pack while it is open
+   //***************************************************************************
+   static void appendStocks(
+      const string& packFileName,
+      const vector<string>& stockDataFileNames);
+
+   //***************************************************************************
+   // Function    : buildPack
+   // Description : Writes a new pack of the stock data files, replacing
+   //                any file of the name
+   // Constraints : See appendStocks
+   //***************************************************************************
+   static void buildPack(
+      const string& packFileName,
+      const vector<string>& stockDataFileNames);
+
+   //***************************************************************************
+   // Function    : close
+   // Description : Unmaps the pack, if one is open
+   //                Pointers retrieved from the pack are no longer valid
+   // Constraints : None
+   //***************************************************************************
+   void close();
+
+   //***************************************************************************
+   // Function    : findSymbol
+   // Description : Retrieves the index of the symbol in the directory
+   //                Returns -1 if the pack doesn't have it
+   // Constraints : None
+   //***************************************************************************
+   int findSymbol(const string& symbol) const;
+
+   //***************************************************************************
+   // Function    : getCloses, getDates, getHighs, getLows, getOpens,
+   //                getVolumes
+   // Description : Retrieves the column of the symbol at the index,
+   //                getNumRows values, oldest first, in the mapped pack
+   // Constraints : Throw an out_of_range exception for invalid index
+   //                Valid until the pack is closed
+   //***************************************************************************
+   inline const double* getCloses(const int symbolIndex) const;
+   inline const int* getDates(const int symbolIndex) const;
+   inline const double* getHighs(const int symbolIndex) const;
+   inline const double* getLows(const int symbolIndex) const;
+   inline const double* getOpens(const int symbolIndex) const;
+   inline const long long* getVolumes(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getFirstDate, getLastDate
+   // Description : Retrieves the oldest and newest date of the symbol at
+   //                the index, 0 if it has no rows
+   // Constraints : Throw an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getFirstDate(const int symbolIndex) const;
+   inline int getLastDate(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumBytes
+   // Description : Retrieves the size of the mapped pack
+   // Constraints : None
+   //***************************************************************************
+   inline size_t getNumBytes() const;
+
+   //***************************************************************************
+   // Function    : getNumRows
+   // Description : Retrieves the number of rows of the symbol at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline int getNumRows(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : getNumSymbols
+   // Description : Retrieves the number of symbols in the directory
+   // Constraints : None
+   //***************************************************************************
+   inline int getNumSymbols() const;
+
+   //***************************************************************************
+   // Function    : getSymbolAt
+   // Description : Retrieves the symbol at the index of the directory
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline string getSymbolAt(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : isOpen
+   // Description : Is a pack mapped?
+   // Constraints : None
+   //***************************************************************************
+   inline bool isOpen() const;
+
+   //***************************************************************************
+   // Function    : isPackFile
+   // Description : Does the file start with the magic of a pack?
+   //                Returns false if it can't be read
+   // Constraints : None
+   //***************************************************************************
+   static bool isPackFile(const string& fileName);
+
+   //***************************************************************************
+   // Function    : open
+   // Description : Maps the pack, closing any pack open, and checks its
+   //                header and directory
+   // Constraints : Throws an exception if the file can't be mapped or isn't
+   //                a valid pack
+   //***************************************************************************
+   void open(const string& packFileName);
+
+   //***************************************************************************
+   // Function    : releaseSymbols
+   // Description : Drops the segments of the symbols from firstSymbolIndex
+   //                up to endSymbolIndex from physical memory, so a pack
+   //                read once through stays out of the resident set
+   //                They are read back from the file if used again
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   void releaseSymbols(
+      const int firstSymbolIndex,
+      const int endSymbolIndex) const;
+
+   static const int ROWGRANULE  = 64; // Capacity is a multiple of these rows
+   static const int SYMBOLBYTES = 32; // Longest symbol, with its null
+
+private:
+   // Columns of a symbol's segments, in file order
+   enum PackColumn
+   {
+      COLUMNDATES,
+      COLUMNOPENS,
+      COLUMNHIGHS,
+      COLUMNLOWS,
+      COLUMNCLOSES,
+      COLUMNVOLUMES,
+      NUMCOLUMNS
+   };
+
+   // Start of the file, 64 bytes
+   struct Header
+   {
+      char      magic[8];        // PACKMAGIC
+      int       version;         // PACKVERSION
+      int       numSymbols;      // Entries in the directory
+      long long directoryOffset; // Of the directory, the end of the data
+      char      padding[40];     // Zero
+   };
+
+   // One symbol of the directory, 64 bytes
+   struct DirectoryEntry
+   {
+      char      symbol[SYMBOLBYTES]; // Null padded
+      long long offset;              // Of its segments
+      int       numRows;             // Rows held
+      int       capacity;            // Rows its segments have room for
+      int       firstDate;           // Oldest date, 0 with no rows
+      int       lastDate;            // Newest date, 0 with no rows
+      char      padding[8];          // Zero
+   };
+
+   // A stock data file's rows, oldest first
+   struct StockRows
+   {
+      vector<int>       dates;   // Day numbers
+      vector<double>    opens;   // Open prices
+      vector<double>    highs;   // High prices
+      vector<double>    lows;    // Low prices
+      vector<double>    closes;  // Closing prices
+      vector<long long> volumes; // Shares traded
+   };
+
+   //***************************************************************************
+   // Function    : copy constructor, assignment
+   // Description : A mapping has a single owner, not implemented
+   // Constraints : None
+   //***************************************************************************
+   UniversePack(const UniversePack&);
+   UniversePack& operator=(const UniversePack&);
+
+   //***************************************************************************
+   // Function    : getColumn
+   // Description : Retrieves the first byte of the column of the symbol at
+   //                the index in the mapped pack
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const char* getColumn(
+      const int symbolIndex,
+      const PackColumn column) const;
+
+   //***************************************************************************
+   // Function    : getColumnOffset
+   // Description : Retrieves the offset of the column from the start of
+   //                segments with room for capacity rows, or with
+   //                NUMCOLUMNS, the size of the segments
+   // Constraints : None
+   //***************************************************************************
+   static inline long long getColumnOffset(
+      const PackColumn column,
+      const int capacity);
+
+   //***************************************************************************
+   // Function    : getEntry
+   // Description : Retrieves the directory entry at the index
+   // Constraints : Throws an out_of_range exception for invalid index
+   //***************************************************************************
+   inline const DirectoryEntry& getEntry(const int symbolIndex) const;
+
+   //***************************************************************************
+   // Function    : isSymbolLess
+   // Description : Orders directory entries by symbol, the directory's order
+   // Constraints : None
+   //***************************************************************************
+   static bool isSymbolLess(
+      const DirectoryEntry& leftEntry,
+      const DirectoryEntry& rightEntry);
+
+   //***************************************************************************
+   // Function    : readStockDataFile
+   // Description : Reads the date, open, high, low, close, and volume of
+   //                each row of the stock data file, as
+   //                StockAnalyzer::parsePricesFromDataFile does
+   // Constraints : Throws an exception if the file can't be read, a price
+   //                doesn't parse, or a row has no date
+   //***************************************************************************
+   static void readStockDataFile(
+      const string& stockDataFileName,
+      StockRows& stockRows);
+
+   const char*           data;       // First byte of the mapped pack
+   const DirectoryEntry* directory;  // In the mapped pack
+   long long             mapping;    // From Platform::mapFile
+   size_t                numBytes;   // Mapped
+   int                   numSymbols; // In the directory
+}; // end class UniversePack
+
+//******************************************************************************
+// Function : getCloses
+// Process  : The closes column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* UniversePack::getCloses(const int symbolIndex) const
+{
+   return reinterpret_cast<const double*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNCLOSES));
+}
+
+//******************************************************************************
+// Function : getColumn
+// Process  : The symbol's segments, then the column's offset in them
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const char* UniversePack::getColumn(
+   const int        symbolIndex,
+   const PackColumn column) const
+{
+   const DirectoryEntry& entry = this->getEntry(symbolIndex); // Of symbol
+
+   return this->data + entry.offset +
+          UniversePack::getColumnOffset(column, entry.capacity);
+}
+
+//******************************************************************************
+// Function : getColumnOffset
+// Process  : The dates, 4 bytes a row, come first, then 8 byte columns
+// Notes    : A multiple of 64 bytes when capacity is of ROWGRANULE rows
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline long long UniversePack::getColumnOffset(
+   const PackColumn column,
+   const int        capacity)
+{
+   if (UniversePack::COLUMNDATES == column)
+   {
+      return 0;
+   }
+
+   return (long long)capacity * (long long)(
+      sizeof(int) + sizeof(double) * (column - UniversePack::COLUMNOPENS));
+}
+
+//******************************************************************************
+// Function : getDates
+// Process  : The dates column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const int* UniversePack::getDates(const int symbolIndex) const
+{
+   return reinterpret_cast<const int*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNDATES));
+}
+
+//******************************************************************************
+// Function : getEntry
+// Process  : Check the index, then the directory's entry
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const UniversePack::DirectoryEntry& UniversePack::getEntry(
+   const int symbolIndex) const
+{
+   if (symbolIndex < 0 || symbolIndex >= this->numSymbols)
+   {
+      throw out_of_range("Invalid symbol index");
+   }
+
+   return this->directory[symbolIndex];
+}
+
+//******************************************************************************
+// Function : getFirstDate
+// Process  : From the directory
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int UniversePack::getFirstDate(const int symbolIndex) const
+{
+   return this->getEntry(symbolIndex).firstDate;
+}
+
+//******************************************************************************
+// Function : getHighs
+// Process  : The highs column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* UniversePack::getHighs(const int symbolIndex) const
+{
+   return reinterpret_cast<const double*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNHIGHS));
+}
+
+//******************************************************************************
+// Function : getLastDate
+// Process  : From the directory
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int UniversePack::getLastDate(const int symbolIndex) const
+{
+   return this->getEntry(symbolIndex).lastDate;
+}
+
+//******************************************************************************
+// Function : getLows
+// Process  : The lows column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* UniversePack::getLows(const int symbolIndex) const
+{
+   return reinterpret_cast<const double*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNLOWS));
+}
+
+//******************************************************************************
+// Function : getNumBytes
+// Process  : Accessor for numBytes
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline size_t UniversePack::getNumBytes() const
+{
+   return this->numBytes;
+}
+
+//******************************************************************************
+// Function : getNumRows
+// Process  : From the directory
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int UniversePack::getNumRows(const int symbolIndex) const
+{
+   return this->getEntry(symbolIndex).numRows;
+}
+
+//******************************************************************************
+// Function : getNumSymbols
+// Process  : Accessor for numSymbols
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline int UniversePack::getNumSymbols() const
+{
+   return this->numSymbols;
+}
+
+//******************************************************************************
+// Function : getOpens
+// Process  : The opens column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const double* UniversePack::getOpens(const int symbolIndex) const
+{
+   return reinterpret_cast<const double*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNOPENS));
+}
+
+//******************************************************************************
+// Function : getSymbolAt
+// Process  : The directory's null padded name
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline string UniversePack::getSymbolAt(const int symbolIndex) const
+{
+   return string(this->getEntry(symbolIndex).symbol);
+}
+
+//******************************************************************************
+// Function : getVolumes
+// Process  : The volumes column
+// Notes    : Throws an out_of_range exception for invalid index
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline const long long* UniversePack::getVolumes(const int symbolIndex) const
+{
+   return reinterpret_cast<const long long*>(
+      this->getColumn(symbolIndex, UniversePack::COLUMNVOLUMES));
+}
+
+//******************************************************************************
+// Function : isOpen
+// Process  : Is there a mapping?
+// Notes    : None
+//
+// Revision History:
+//
+// Date           Author               Description
+// 10.19.26       Donne Martin         Added function
+//******************************************************************************
+inline bool UniversePack::isOpen() const
+{
+   return NULL != this->data;
+}
+
+#endif // UniversePack_h